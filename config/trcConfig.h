@@ -214,6 +214,72 @@ extern "C" {
  */
 #define TRC_CFG_CTRL_TASK_DELAY 10
 
+/**
+ * @def TRC_CFG_CTRL_ADAPTIVE
+ * @brief If 1, the TzCtrl delay is adapted to the rate at which the internal
+ * buffer fills, instead of always being TRC_CFG_CTRL_TASK_DELAY. Only used in
+ * streaming mode with a stream port that uses the internal buffer.
+ *
+ * Each time TzCtrl runs, it measures how much was stored in the internal buffer
+ * since the last time and sets the next delay to the time the buffer is
+ * expected to take to fill to TRC_CFG_CTRL_TARGET_OCCUPANCY, within
+ * TRC_CFG_CTRL_TASK_DELAY_MIN and TRC_CFG_CTRL_TASK_DELAY_MAX. A burst shortens
+ * the delay at once, while an idle system is woken only every
+ * TRC_CFG_CTRL_TASK_DELAY_MAX. In Chunk transfer mode, the number of chunks
+ * transferred per TzCtrl loop is also set to what is in the buffer, up to
+ * TRC_CFG_CTRL_CHUNK_BUDGET_MAX. The decisions are stored in the diagnostics,
+ * see TRC_DIAGNOSTICS_CTRL_TASK_DELAY and following in trcDiagnostics.h.
+ *
+ * Note that commands from Tracealyzer are only read as often as TzCtrl runs,
+ * so TRC_CFG_CTRL_TASK_DELAY_MAX also limits how quickly they are acted on.
+ *
+ * Default value is 0.
+ */
+#define TRC_CFG_CTRL_ADAPTIVE 0
+
+/**
+ * @def TRC_CFG_CTRL_TASK_DELAY_MIN
+ * @brief The shortest TzCtrl delay used by TRC_CFG_CTRL_ADAPTIVE, in the unit
+ * of TRC_CFG_CTRL_TASK_DELAY. At least 1.
+ *
+ * Default value is 1.
+ */
+#define TRC_CFG_CTRL_TASK_DELAY_MIN 1
+
+/**
+ * @def TRC_CFG_CTRL_TASK_DELAY_MAX
+ * @brief The longest TzCtrl delay used by TRC_CFG_CTRL_ADAPTIVE, in the unit
+ * of TRC_CFG_CTRL_TASK_DELAY. When a burst starts after an idle period, the
+ * internal buffer must hold what is stored during this delay, or events are
+ * dropped until TzCtrl has caught up. With the default, the adaptive delay is
+ * never longer than the fixed one, so a burst loses no more events than
+ * without TRC_CFG_CTRL_ADAPTIVE. A longer delay saves TzCtrl loops when idle,
+ * at the cost of a larger internal buffer.
+ *
+ * Default value is TRC_CFG_CTRL_TASK_DELAY.
+ */
+#define TRC_CFG_CTRL_TASK_DELAY_MAX (TRC_CFG_CTRL_TASK_DELAY)
+
+/**
+ * @def TRC_CFG_CTRL_TARGET_OCCUPANCY
+ * @brief The internal buffer occupancy, in percent, that TRC_CFG_CTRL_ADAPTIVE
+ * aims to have when TzCtrl runs. Lower leaves more room for bursts, at the cost
+ * of running TzCtrl more often.
+ *
+ * Default value is 50.
+ */
+#define TRC_CFG_CTRL_TARGET_OCCUPANCY 50
+
+/**
+ * @def TRC_CFG_CTRL_CHUNK_BUDGET_MAX
+ * @brief The largest number of chunks that TRC_CFG_CTRL_ADAPTIVE lets TzCtrl
+ * transfer per loop in Chunk transfer mode. Limits the time spent in each
+ * TzCtrl loop.
+ *
+ * Default value is 20.
+ */
+#define TRC_CFG_CTRL_CHUNK_BUDGET_MAX 20
+
 /**
  * @def TRC_CFG_CTRL_TASK_STACK_SIZE
  * @brief The stack size of the Tracealyzer Control (TzCtrl) task.
@@ -221,6 +287,185 @@ extern "C" {
  */
 #define TRC_CFG_CTRL_TASK_STACK_SIZE 256
 
+/**
+ * @def TRC_CFG_EVENT_LANES
+ * @brief If 1, events stored in the internal buffer are given one of three
+ * priority lanes, so that when the buffer is nearly full the least important
+ * events are dropped first. Only used in streaming mode with a stream port that
+ * uses the internal buffer.
+ *
+ * Scheduling events (task switches, ready tasks, ISRs) may use all of the
+ * buffer. Object events (creation, deletion, names) and the other kernel
+ * events are dropped when only TRC_CFG_EVENT_LANE_RESERVE_SCHEDULING remains.
+ * User events, counter changes, intervals and state machine changes are
+ * dropped first, when only the two reserves remain. All lanes share each
+ * core's buffer, so the events are still streamed in the order they were
+ * stored. The events dropped in each lane are counted in the diagnostics, see
+ * TRC_DIAGNOSTICS_LANE_SCHEDULING_DROPPED and following in trcDiagnostics.h.
+ *
+ * Default value is 0.
+ */
+#define TRC_CFG_EVENT_LANES 0
+
+/**
+ * @def TRC_CFG_EVENT_LANE_RESERVE_SCHEDULING
+ * @brief The part of each core's internal buffer, in percent, that only
+ * scheduling events may use when TRC_CFG_EVENT_LANES is 1.
+ *
+ * Default value is 10.
+ */
+#define TRC_CFG_EVENT_LANE_RESERVE_SCHEDULING 10
+
+/**
+ * @def TRC_CFG_EVENT_LANE_RESERVE_OBJECT
+ * @brief The part of each core's internal buffer, in percent, that user and
+ * diagnostic events may not use when TRC_CFG_EVENT_LANES is 1, on top of
+ * TRC_CFG_EVENT_LANE_RESERVE_SCHEDULING. The two reserves may not add up to
+ * more than 90.
+ *
+ * Default value is 10.
+ */
+#define TRC_CFG_EVENT_LANE_RESERVE_OBJECT 10
+
+/**
+ * @def TRC_CFG_FLIGHT_RECORDER
+ * @brief If 1, the internal buffer is used as a flight recorder in streaming
+ * mode: it keeps overwriting the oldest events, and nothing is transferred
+ * until a trigger. The capture is then the events before the trigger plus
+ * TRC_CFG_FLIGHT_RECORDER_POST_TRIGGER percent of the buffer stored after it.
+ * It is transferred by TzCtrl, after which the flight recorder is armed again.
+ * This gives full detail around incidents at a fraction of the bandwidth of
+ * continuous streaming. Only used with a stream port that uses the internal
+ * buffer, and can't be combined with TRC_CFG_CTRL_ADAPTIVE.
+ *
+ * Triggers are xTraceFlightRecorderTrigger() and those selected by
+ * TRC_CFG_FLIGHT_RECORDER_TRIGGERS. Events between captures are not streamed,
+ * which Tracealyzer shows as dropped events, and names of objects created
+ * after the trace was started may have been overwritten. Captures and
+ * ignored triggers are counted in the diagnostics, see
+ * TRC_DIAGNOSTICS_FLIGHT_RECORDER_CAPTURES in trcDiagnostics.h.
+ *
+ * Default value is 0.
+ */
+#define TRC_CFG_FLIGHT_RECORDER 0
+
+/**
+ * @def TRC_CFG_FLIGHT_RECORDER_POST_TRIGGER
+ * @brief The part of each core's internal buffer, in percent, that is filled
+ * with events stored after a trigger before the capture is frozen, when
+ * TRC_CFG_FLIGHT_RECORDER is 1. The rest holds the events before it. 0 to 90.
+ *
+ * Default value is 25.
+ */
+#define TRC_CFG_FLIGHT_RECORDER_POST_TRIGGER 25
+
+/**
+ * @def TRC_CFG_FLIGHT_RECORDER_TRIGGERS
+ * @brief What triggers a capture when TRC_CFG_FLIGHT_RECORDER is 1, besides
+ * xTraceFlightRecorderTrigger(). A combination of:
+ * TRC_FLIGHT_RECORDER_TRIGGER_ERROR - Recorder errors, see xTraceError()
+ * TRC_FLIGHT_RECORDER_TRIGGER_ASSERT - Failed recorder asserts
+ * TRC_FLIGHT_RECORDER_TRIGGER_COUNTER_LIMIT - Counters set outside their limits
+ *
+ * An error or assert freezes the capture at once, and the recorder is stopped
+ * after it has been transferred instead of at once.
+ *
+ * Default value is all three.
+ */
+#define TRC_CFG_FLIGHT_RECORDER_TRIGGERS (TRC_FLIGHT_RECORDER_TRIGGER_ERROR | TRC_FLIGHT_RECORDER_TRIGGER_ASSERT | TRC_FLIGHT_RECORDER_TRIGGER_COUNTER_LIMIT)
+
+/**
+ * @def TRC_CFG_FLIGHT_RECORDER_STOP_ATTEMPTS
+ * @brief When the recorder is to be stopped after a capture, by an error or
+ * by xTraceDisable(), the number of attempts in a row to transfer the capture
+ * that may write nothing before the rest of it is given up and the recorder
+ * is stopped. Used when TRC_CFG_FLIGHT_RECORDER is 1.
+ *
+ * Default value is 100.
+ */
+#define TRC_CFG_FLIGHT_RECORDER_STOP_ATTEMPTS 100
+
+/**
+ * @def TRC_CFG_TRIGGER_RULES
+ * @brief The number of trigger rules that can be used in streaming mode, 0 to
+ * 32. 0 excludes the trigger rules. Each event is checked against the rules
+ * in use before it is stored, and a rule that matches the event code, and
+ * optionally the object handle, the range of one of the first four
+ * parameters or a duration, fires its action: start or stop storing events,
+ * mark the trace or trigger a flight recorder capture. This can reduce the
+ * streamed data greatly while hunting for rare problems.
+ *
+ * The rules are set by xTraceTriggerSetRules() or uploaded from the host with
+ * the CMD_TRIGGER_RULE, CMD_TRIGGER_RULE_VALUE and CMD_TRIGGER_RULES_SET
+ * commands, see xTraceTriggerProcessCommand() in trcTrigger.h. Most events
+ * only cost a check of one bit, only events with the event code of a rule
+ * are checked against up to this many rules. Each rule takes
+ * 4 + 3 * sizeof(TraceUnsignedBaseType_t) bytes, twice, and the bits of the
+ * event codes take 512 bytes.
+ *
+ * Default value is 0.
+ */
+#define TRC_CFG_TRIGGER_RULES 0
+
+/**
+ * @def TRC_CFG_SELF_PROFILING
+ * @brief If 1, the recorder measures its own cost in streaming mode, in
+ * TRC_HWTC_COUNT ticks: xTraceEventCreateN() and the like from entering the
+ * critical section to the commit, the stream port allocate and commit in
+ * them, the transfer in xTraceTzCtrl() and xTraceEntryFind(). The count, min,
+ * max, sum and a log2 histogram are kept per core and can be read with
+ * xTraceProfilingGet(). Every TRC_CFG_SELF_PROFILING_REPORT_INTERVAL calls of
+ * xTraceTzCtrl(), the count, min, mean and max are stored as user events on
+ * "#Cost ..." channels, so the recorder's overhead can be seen in the trace.
+ *
+ * This adds a few timer reads and a short critical section to each event, so
+ * it is meant for evaluating the recorder, not for production builds.
+ *
+ * Default value is 0.
+ */
+#define TRC_CFG_SELF_PROFILING 0
+
+/**
+ * @def TRC_CFG_SELF_PROFILING_REPORT_INTERVAL
+ * @brief The number of xTraceTzCtrl() calls between the self-profiling
+ * reports when TRC_CFG_SELF_PROFILING is 1. Each report stores one user event
+ * per measured function and core.
+ *
+ * Default value is 100.
+ */
+#define TRC_CFG_SELF_PROFILING_REPORT_INTERVAL 100
+
+/**
+ * @def TRC_CFG_DIAGNOSTICS_EXTENDED
+ * @brief If 1, the diagnostics also keep, in streaming mode:
+ * - the most bytes in each core's internal buffer, sampled before each
+ *   transfer, when only a transfer empties it
+ * - the event bytes committed and the bytes transferred, per core
+ * - the transfers made by xTraceTzCtrl()
+ * - the transfer writes that failed or wrote less than asked
+ * - the longest critical section of an event, in TRC_HWTC_COUNT ticks
+ * They can be read with xTraceDiagnosticsGet() and xTraceDiagnosticsCoreGet(),
+ * and are stored as user events on the "#Diagnostics" channel every
+ * TRC_CFG_DIAGNOSTICS_REPORT_INTERVAL calls of xTraceTzCtrl(). Use them to
+ * size TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_SIZE (or the stream port's buffer
+ * size) and the chunk settings.
+ *
+ * This adds a timer read and a function call to each event.
+ *
+ * Default value is 0.
+ */
+#define TRC_CFG_DIAGNOSTICS_EXTENDED 0
+
+/**
+ * @def TRC_CFG_DIAGNOSTICS_REPORT_INTERVAL
+ * @brief The number of xTraceTzCtrl() calls between the extended diagnostics
+ * reports when TRC_CFG_DIAGNOSTICS_EXTENDED is 1. Each report stores one user
+ * event, plus one per core.
+ *
+ * Default value is 100.
+ */
+#define TRC_CFG_DIAGNOSTICS_REPORT_INTERVAL 100
+
 /**
  * @def TRC_CFG_RECORDER_BUFFER_ALLOCATION
  * @brief Specifies how the recorder buffer is allocated (also in case of streaming, in
@@ -85,6 +85,24 @@ extern "C" {
 #error "TRC_CFG_SYMBOL_TABLE_SIZE may not be zero!"
 #endif
 
+/**
+ * @def TRC_CFG_SYMBOL_TABLE_HASH_BITS
+ * @brief Macro which should be defined as an integer value, 6 or 10 to 12.
+ *
+ * This defines the width of the hash used to look up strings in the symbol
+ * table. Every lookup walks a linked list of all entries sharing the same
+ * hash, so with a large TRC_CFG_SYMBOL_TABLE_SIZE a wider hash keeps these
+ * lists short. The list heads use 2 bytes per hash value, i.e., 128 bytes
+ * for 6 bits and 8 KB for 12 bits.
+ *
+ * The value 6 gives the original symbol table layout. Other values set the
+ * minor version of the recorder data to 8, which tells Tracealyzer that the
+ * symbol table is followed by the hash width and a larger list head array.
+ *
+ * Default value is 6.
+ */
+#define TRC_CFG_SYMBOL_TABLE_HASH_BITS 6
+
 /******************************************************************************
  *** ADVANCED SETTINGS ********************************************************
  ******************************************************************************
@@ -238,6 +256,49 @@ extern "C" {
  */
 #define TRC_CFG_UB_CHANNELS 32
 
+/**
+ * @def TRC_CFG_INCLUDE_SNAPSHOT_EXPORT
+ * @brief Macro which should be defined as either zero (0) or one (1).
+ *
+ * If this is one (1), xTraceSnapshotExport is included. It lets a low
+ * priority task read out the recorder data piece by piece while tracing
+ * continues, e.g., over a slow serial link, instead of halting the target
+ * and dumping the whole structure. Each call only returns what has changed
+ * since the previous call: new events, new symbol table entries and the
+ * modified parts of the object property table.
+ *
+ * This adds a few instructions and a memory barrier to each stored event
+ * and object property update, and two bytes of RAM per 32 bytes of object
+ * property table, also in each export cursor.
+ *
+ * Default value is 0.
+ */
+#ifndef TRC_CFG_INCLUDE_SNAPSHOT_EXPORT
+#define TRC_CFG_INCLUDE_SNAPSHOT_EXPORT 0
+#endif
+
+/**
+ * @def TRC_CFG_SNAPSHOT_CORE_BUFFERS
+ * @brief Macro which should be defined as either zero (0) or one (1).
+ *
+ * If this is one (1) and TRC_CFG_CORE_COUNT is above 1, each core stores its
+ * events in its own event buffer, with its own timestamps, so that storing an
+ * event only needs the core critical section (see
+ * TRACE_ENTER_CORE_CRITICAL_SECTION in trcRecorder.h) instead of the global
+ * one. The buffers of core 1 and up are added as secondary blocks, which
+ * changes the recorder data to minor version 9. Only use this with a
+ * Tracealyzer version, or a tool, that reads that layout.
+ *
+ * If this is zero (0), all cores share one event buffer under the global
+ * critical section, and the recorder data keeps the layout of minor version 7
+ * (8 with a TRC_CFG_SYMBOL_TABLE_HASH_BITS other than 6).
+ *
+ * Default value is 0.
+ */
+#ifndef TRC_CFG_SNAPSHOT_CORE_BUFFERS
+#define TRC_CFG_SNAPSHOT_CORE_BUFFERS 0
+#endif
+
 #ifdef __cplusplus
 }
 #endif
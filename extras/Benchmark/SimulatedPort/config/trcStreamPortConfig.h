@@ -0,0 +1,51 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * The configuration for the simulated stream port used by
+ * trcBenchmarkWriteCombine. The build sets the write combine size.
+ */
+
+#ifndef TRC_STREAM_PORT_CONFIG_H
+#define TRC_STREAM_PORT_CONFIG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @def TRC_CFG_STREAM_PORT_WRITE_COMBINE_SIZE
+ *
+ * @brief The write combine buffer size per core, 0 writes each event as it is
+ * stored.
+ */
+#ifndef TRC_CFG_STREAM_PORT_WRITE_COMBINE_SIZE
+#define TRC_CFG_STREAM_PORT_WRITE_COMBINE_SIZE 0
+#endif
+
+/**
+ * @def TRC_CFG_STREAM_PORT_WRITE_COMBINE_FLUSH_PERIOD
+ *
+ * @brief The longest time, in microseconds, that an event is held in the write
+ * combine buffer while other events are being stored.
+ */
+#ifndef TRC_CFG_STREAM_PORT_WRITE_COMBINE_FLUSH_PERIOD
+#define TRC_CFG_STREAM_PORT_WRITE_COMBINE_FLUSH_PERIOD 1000
+#endif
+
+/**
+ * @def TRC_CFG_STREAM_PORT_SIMULATED_RTT_BUFFER_SIZE
+ *
+ * @brief The size of the simulated RTT up buffer. The host side is assumed to
+ * keep up, so it is never full.
+ */
+#define TRC_CFG_STREAM_PORT_SIMULATED_RTT_BUFFER_SIZE 4096
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRC_STREAM_PORT_CONFIG_H */
@@ -0,0 +1,131 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * The interface definitions for trace streaming ("stream ports").
+ * This "stream port" runs on the host and imitates the cost of writing to
+ * the interfaces of the Direct mode stream ports, for measuring what write
+ * combining saves. The interface is selected at runtime:
+ *	RTT:	the SEGGER_RTT_Write path, lock, copy into a ring buffer, unlock.
+ *	ITM:	one 32-bit stimulus port write per word, polling the FIFO first.
+ *	Socket:	a write() system call per call, to /dev/null.
+ *	Null:	nothing, for measuring the recorder without an interface.
+ * Nothing is sent anywhere, the data is only counted.
+ */
+
+#ifndef TRC_STREAM_PORT_H
+#define TRC_STREAM_PORT_H
+
+#if (TRC_USE_TRACEALYZER_RECORDER == 1)
+
+#if (TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)
+
+#include <stdint.h>
+#include <trcTypes.h>
+#include <trcStreamPortConfig.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TRC_USE_INTERNAL_BUFFER 0
+
+#define TRC_WRITE_COMBINE_SIZE (TRC_CFG_STREAM_PORT_WRITE_COMBINE_SIZE)
+
+#define TRC_WRITE_COMBINE_FLUSH_PERIOD (TRC_CFG_STREAM_PORT_WRITE_COMBINE_FLUSH_PERIOD)
+
+#define TRC_STREAM_PORT_SIMULATED_RTT 0u
+#define TRC_STREAM_PORT_SIMULATED_ITM 1u
+#define TRC_STREAM_PORT_SIMULATED_SOCKET 2u
+#define TRC_STREAM_PORT_SIMULATED_NULL 3u
+#define TRC_STREAM_PORT_SIMULATED_COUNT 4u
+
+typedef struct TraceStreamPortSimulatedStatistics
+{
+	uint64_t ulWrites;				/* xTraceStreamPortWriteData() calls */
+	uint64_t ulBytes;
+} TraceStreamPortSimulatedStatistics_t;
+
+typedef struct TraceStreamPortBuffer	/* Aligned */
+{
+	uint32_t uiInterface;
+	uint32_t uiRttWriteOffset;
+	int32_t iSocket;
+	uint32_t uiReserved;
+	TraceStreamPortSimulatedStatistics_t xStatistics;
+	uint8_t uiRttBuffer[TRC_CFG_STREAM_PORT_SIMULATED_RTT_BUFFER_SIZE];
+} TraceStreamPortBuffer_t;
+
+/**
+ * @internal Stream port initialize callback. Opens /dev/null for the
+ * socket interface and selects the RTT interface.
+ *
+ * @param[in] pxBuffer Buffer
+ *
+ * @retval TRC_FAIL Initialization failed
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortInitialize(TraceStreamPortBuffer_t* pxBuffer);
+
+/**
+ * @brief Selects the simulated interface and clears the statistics.
+ *
+ * @param[in] uiInterface TRC_STREAM_PORT_SIMULATED_RTT, _ITM, _SOCKET or _NULL
+ *
+ * @retval TRC_FAIL No such interface
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortSimulatedSetInterface(uint32_t uiInterface);
+
+/**
+ * @brief Gets the statistics since the interface was selected.
+ *
+ * @param[out] pxStatistics Statistics
+ *
+ * @retval TRC_FAIL Not initialized
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortSimulatedGetStatistics(TraceStreamPortSimulatedStatistics_t* pxStatistics);
+
+#if (TRC_WRITE_COMBINE_SIZE > 0)
+	#define xTraceStreamPortAllocate xTraceWriteCombineAlloc
+	#define xTraceStreamPortCommit xTraceWriteCombineCommit
+#else
+	#define xTraceStreamPortAllocate(uiSize, ppvData) ((void)(uiSize), xTraceStaticBufferGet(ppvData))
+	#define xTraceStreamPortCommit xTraceStreamPortWriteData
+#endif
+
+/**
+ * @brief Writes data through the simulated interface.
+ *
+ * @param[in] pvData Data to write
+ * @param[in] uiSize Data to write size
+ * @param[out] piBytesWritten Bytes written
+ *
+ * @retval TRC_FAIL Write failed
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortWriteData(void* pvData, uint32_t uiSize, int32_t* piBytesWritten);
+
+#define xTraceStreamPortReadData(pvData, uiSize, piBytesRead) ((void)(pvData), (void)(uiSize), *(piBytesRead) = 0, TRC_SUCCESS)
+
+#define xTraceStreamPortOnEnable(uiStartOption) ((void)(uiStartOption), TRC_SUCCESS)
+
+#define xTraceStreamPortOnDisable() (TRC_SUCCESS)
+
+#define xTraceStreamPortOnTraceBegin() (TRC_SUCCESS)
+
+#define xTraceStreamPortOnTraceEnd() (TRC_SUCCESS)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*(TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)*/
+
+#endif /*(TRC_USE_TRACEALYZER_RECORDER == 1)*/
+
+#endif /* TRC_STREAM_PORT_H */
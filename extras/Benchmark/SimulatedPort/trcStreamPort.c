@@ -0,0 +1,156 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Supporting functions for the simulated stream port used by
+ * trcBenchmarkWriteCombine and trcBenchmarkCore. Each interface does the work
+ * of its stream port's write function, against memory or /dev/null instead of
+ * the real interface.
+ */
+
+#include <trcRecorder.h>
+
+#if (TRC_USE_TRACEALYZER_RECORDER == 1)
+
+#if (TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)
+
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Stands in for the ITM registers, always enabled and never full */
+typedef struct TraceStreamPortSimulatedItm
+{
+	volatile uint32_t uiDemcr;
+	volatile uint32_t uiTcr;
+	volatile uint32_t uiTer;
+	volatile uint32_t uiPort;
+} TraceStreamPortSimulatedItm_t;
+
+static TraceStreamPortBuffer_t* pxStreamPortSimulated TRC_CFG_RECORDER_DATA_ATTRIBUTE;
+
+static TraceStreamPortSimulatedItm_t xItm = { 1u, 1u, 1u, 1u };
+
+/* Stands in for SEGGER_RTT_LOCK, which masks interrupts */
+static volatile uint32_t uiRttLock = 0u;
+
+static void prvTraceStreamPortSimulatedRttWrite(const uint8_t* puiData, uint32_t uiSize)
+{
+	uint32_t uiOffset;
+	uint32_t uiFirst;
+
+	while (__atomic_exchange_n(&uiRttLock, 1u, __ATOMIC_ACQUIRE) != 0u) {}
+
+	uiOffset = pxStreamPortSimulated->uiRttWriteOffset;
+	while (uiSize > 0u)
+	{
+		uiFirst = (uint32_t)(TRC_CFG_STREAM_PORT_SIMULATED_RTT_BUFFER_SIZE) - uiOffset;
+		if (uiFirst > uiSize)
+		{
+			uiFirst = uiSize;
+		}
+
+		(void)memcpy(&pxStreamPortSimulated->uiRttBuffer[uiOffset], puiData, uiFirst);
+		puiData += uiFirst;
+		uiSize -= uiFirst;
+		uiOffset = (uiOffset + uiFirst) % (uint32_t)(TRC_CFG_STREAM_PORT_SIMULATED_RTT_BUFFER_SIZE);
+	}
+
+	/* The host reads up to here */
+	__atomic_store_n(&pxStreamPortSimulated->uiRttWriteOffset, uiOffset, __ATOMIC_RELEASE);
+
+	__atomic_store_n(&uiRttLock, 0u, __ATOMIC_RELEASE);
+}
+
+static void prvTraceStreamPortSimulatedItmWrite(const uint8_t* puiData, uint32_t uiSize)
+{
+	uint32_t uiWord;
+	uint32_t i;
+
+	if ((xItm.uiDemcr != 0u) && (xItm.uiTcr != 0u) && (xItm.uiTer != 0u))
+	{
+		for (i = 0u; i < uiSize; i += 4u)
+		{
+			(void)memcpy(&uiWord, &puiData[i], sizeof(uiWord));
+
+			while (xItm.uiPort == 0u) {}
+			xItm.uiPort = uiWord | 1u;
+		}
+	}
+}
+
+traceResult xTraceStreamPortInitialize(TraceStreamPortBuffer_t* pxBuffer)
+{
+	if (pxBuffer == 0)
+	{
+		return TRC_FAIL;
+	}
+
+	pxStreamPortSimulated = pxBuffer;
+	pxStreamPortSimulated->uiRttWriteOffset = 0u;
+	pxStreamPortSimulated->iSocket = open("/dev/null", O_WRONLY);
+
+	return xTraceStreamPortSimulatedSetInterface(TRC_STREAM_PORT_SIMULATED_RTT);
+}
+
+traceResult xTraceStreamPortSimulatedSetInterface(uint32_t uiInterface)
+{
+	if ((pxStreamPortSimulated == 0) || (uiInterface >= TRC_STREAM_PORT_SIMULATED_COUNT))
+	{
+		return TRC_FAIL;
+	}
+
+	pxStreamPortSimulated->uiInterface = uiInterface;
+	pxStreamPortSimulated->xStatistics.ulWrites = 0u;
+	pxStreamPortSimulated->xStatistics.ulBytes = 0u;
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceStreamPortSimulatedGetStatistics(TraceStreamPortSimulatedStatistics_t* pxStatistics)
+{
+	if ((pxStreamPortSimulated == 0) || (pxStatistics == 0))
+	{
+		return TRC_FAIL;
+	}
+
+	*pxStatistics = pxStreamPortSimulated->xStatistics;
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceStreamPortWriteData(void* pvData, uint32_t uiSize, int32_t* piBytesWritten)
+{
+	*piBytesWritten = 0;
+
+	switch (pxStreamPortSimulated->uiInterface)
+	{
+	case TRC_STREAM_PORT_SIMULATED_RTT:
+		prvTraceStreamPortSimulatedRttWrite((const uint8_t*)pvData, uiSize);
+		break;
+	case TRC_STREAM_PORT_SIMULATED_ITM:
+		prvTraceStreamPortSimulatedItmWrite((const uint8_t*)pvData, uiSize);
+		break;
+	case TRC_STREAM_PORT_SIMULATED_NULL:
+		break;
+	default:
+		if (write(pxStreamPortSimulated->iSocket, pvData, uiSize) != (ssize_t)uiSize)
+		{
+			return TRC_FAIL;
+		}
+		break;
+	}
+
+	pxStreamPortSimulated->xStatistics.ulWrites++;
+	pxStreamPortSimulated->xStatistics.ulBytes += uiSize;
+	*piBytesWritten = (int32_t)uiSize;
+
+	return TRC_SUCCESS;
+}
+
+#endif /*(TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)*/
+
+#endif /*(TRC_USE_TRACEALYZER_RECORDER == 1)*/
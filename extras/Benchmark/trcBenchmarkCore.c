@@ -0,0 +1,682 @@
+/*
+* Percepio Trace Recorder for Tracealyzer v4.10.3
+* Copyright 2023 Percepio AB
+* www.percepio.com
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* Micro-benchmarks for the recorder core on the host. Measures nanoseconds and
+* cycles per call of the event, event buffer, entry table, object and print
+* APIs, and for those that can be called from several threads at once, the
+* throughput on N threads against one. Events are stored through the simulated
+* stream port (extras/Benchmark/SimulatedPort) with its null interface, so
+* only the recorder itself is measured. The results are written to stdout as
+* JSON, for comparing recorder versions.
+*
+* Built by the host CMake build, run as:
+*	trcBenchmarkCore [iterations per thread] [threads]
+*/
+
+#include <trcRecorder.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(BENCHMARK_CYCLES)
+/* Provided by the build, e.g., a target cycle counter */
+#define BENCHMARK_CYCLE_COUNTER "custom"
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCHMARK_CYCLES() ((uint64_t)__rdtsc())
+#define BENCHMARK_CYCLE_COUNTER "rdtsc"
+#elif defined(__aarch64__)
+static inline uint64_t prvReadCounter(void)
+{
+	uint64_t ullValue;
+	__asm__ volatile("isb; mrs %0, cntvct_el0" : "=r"(ullValue));
+	return ullValue;
+}
+#define BENCHMARK_CYCLES() prvReadCounter()
+#define BENCHMARK_CYCLE_COUNTER "cntvct_el0"
+#else
+static inline uint64_t prvReadCounter(void)
+{
+	struct timespec xTime;
+	(void)clock_gettime(CLOCK_MONOTONIC, &xTime);
+	return (uint64_t)xTime.tv_sec * 1000000000ULL + (uint64_t)xTime.tv_nsec;
+}
+#define BENCHMARK_CYCLES() prvReadCounter()
+#define BENCHMARK_CYCLE_COUNTER "ns"
+#endif
+
+#ifndef BENCHMARK_RECORDER_VERSION
+#define BENCHMARK_RECORDER_VERSION "4.10.3"
+#endif
+
+#define BENCHMARK_ITERATIONS 100000u
+#define BENCHMARK_THREADS 4u
+#define BENCHMARK_MAX_THREADS 16u
+
+/* The event buffer benchmarks store events of this size, a TraceEvent2_t on
+ * 32-bit targets */
+#define BENCHMARK_EVENT_SIZE 20u
+#define BENCHMARK_EVENT_BUFFER_SIZE 65536u
+
+/* The skip mode buffer is cleared when it is half full */
+#define BENCHMARK_SKIP_CLEAR_PERIOD ((BENCHMARK_EVENT_BUFFER_SIZE / 2u) / BENCHMARK_EVENT_SIZE)
+
+/* The transfer benchmarks move this much per call, from a smaller buffer so
+ * that the wrapping is measured too */
+#define BENCHMARK_TRANSFER_SIZE (BENCHMARK_EVENT_SIZE * 64u)
+#define BENCHMARK_TRANSFER_BUFFER_SIZE 4096u
+#define BENCHMARK_TRANSFER_CHUNK_SIZE 512u
+
+/* xTraceEventCreateDataN() payload */
+#define BENCHMARK_DATA_SIZE 32u
+
+typedef struct Benchmark Benchmark_t;
+
+typedef struct BenchmarkThread
+{
+	const Benchmark_t* pxBenchmark;
+	uint32_t uiIterations;
+	uint32_t uiFailed;
+	uint64_t ullCycles;
+	double dSeconds;
+	double dBegin;							/* prvNow() when the timed iterations began */
+	double dEnd;
+	TraceUnsignedBaseType_t uxObject;		/* Address for xTraceObjectRegister() */
+} BenchmarkThread_t;
+
+/* An operation returns TRC_FAIL when the call didn't do what was asked */
+typedef traceResult (*BenchmarkOperation_t)(const BenchmarkThread_t* pxThread, uint32_t uiIteration);
+
+typedef traceResult (*BenchmarkSetup_t)(const Benchmark_t* pxBenchmark);
+
+struct Benchmark
+{
+	const char* szName;
+	BenchmarkOperation_t xOperation;
+	BenchmarkOperation_t xPrepare;	/* Untimed, before each call. The calls are then timed one by one. May be 0. */
+	BenchmarkSetup_t xSetup;		/* Before the run. May be 0. */
+	BenchmarkSetup_t xTeardown;		/* After the run. May be 0. */
+	uint32_t uiParameter;
+	uint32_t uiThreadSafe;			/* Also run on N threads */
+};
+
+typedef struct BenchmarkResult
+{
+	double dNsPerOperation;
+	double dCyclesPerOperation;
+	double dOperationsPerSecond;
+	uint32_t uiFailed;
+} BenchmarkResult_t;
+
+static TraceEventBuffer_t xEventBuffer;
+static uint8_t auiEventBuffer[BENCHMARK_EVENT_BUFFER_SIZE] __attribute__((aligned(8)));
+static uint8_t auiEvent[BENCHMARK_EVENT_SIZE] __attribute__((aligned(8)));
+
+static const TraceUnsignedBaseType_t auxData[BENCHMARK_DATA_SIZE / sizeof(TraceUnsignedBaseType_t)] = { 0 };
+
+/* Addresses for the entry table benchmarks */
+static uint8_t auiEntries[TRC_ENTRY_TABLE_SLOTS];
+static uint32_t uiEntriesCreated = 0u;
+
+static TraceStringHandle_t xChannel = 0;
+
+static pthread_barrier_t xBarrier;
+
+/* What timing a single call adds, subtracted from the calls timed one by one */
+static double dTimerSeconds = 0.0;
+static uint64_t ullTimerCycles = 0u;
+
+static double prvNow(void)
+{
+	struct timespec xTime;
+
+	(void)clock_gettime(CLOCK_MONOTONIC, &xTime);
+
+	return (double)xTime.tv_sec + (double)xTime.tv_nsec * 1e-9;
+}
+
+static traceResult prvEventCreate(const BenchmarkThread_t* pxThread, uint32_t uiIteration)
+{
+	switch (pxThread->pxBenchmark->uiParameter)
+	{
+	case 0:
+		return xTraceEventCreate0(PSF_EVENT_USER_EVENT);
+	case 1:
+		return xTraceEventCreate1(PSF_EVENT_USER_EVENT, uiIteration);
+	case 2:
+		return xTraceEventCreate2(PSF_EVENT_USER_EVENT, uiIteration, 2u);
+	case 3:
+		return xTraceEventCreate3(PSF_EVENT_USER_EVENT, uiIteration, 2u, 3u);
+	case 4:
+		return xTraceEventCreate4(PSF_EVENT_USER_EVENT, uiIteration, 2u, 3u, 4u);
+	case 5:
+		return xTraceEventCreate5(PSF_EVENT_USER_EVENT, uiIteration, 2u, 3u, 4u, 5u);
+	default:
+		return xTraceEventCreate6(PSF_EVENT_USER_EVENT, uiIteration, 2u, 3u, 4u, 5u, 6u);
+	}
+}
+
+static traceResult prvEventCreateData(const BenchmarkThread_t* pxThread, uint32_t uiIteration)
+{
+	switch (pxThread->pxBenchmark->uiParameter)
+	{
+	case 0:
+		return xTraceEventCreateData0(PSF_EVENT_USER_EVENT, auxData, BENCHMARK_DATA_SIZE);
+	case 1:
+		return xTraceEventCreateData1(PSF_EVENT_USER_EVENT, uiIteration, auxData, BENCHMARK_DATA_SIZE);
+	case 2:
+		return xTraceEventCreateData2(PSF_EVENT_USER_EVENT, uiIteration, 2u, auxData, BENCHMARK_DATA_SIZE);
+	case 3:
+		return xTraceEventCreateData3(PSF_EVENT_USER_EVENT, uiIteration, 2u, 3u, auxData, BENCHMARK_DATA_SIZE);
+	case 4:
+		return xTraceEventCreateData4(PSF_EVENT_USER_EVENT, uiIteration, 2u, 3u, 4u, auxData, BENCHMARK_DATA_SIZE);
+	case 5:
+		return xTraceEventCreateData5(PSF_EVENT_USER_EVENT, uiIteration, 2u, 3u, 4u, 5u, auxData, BENCHMARK_DATA_SIZE);
+	default:
+		return xTraceEventCreateData6(PSF_EVENT_USER_EVENT, uiIteration, 2u, 3u, 4u, 5u, 6u, auxData, BENCHMARK_DATA_SIZE);
+	}
+}
+
+static traceResult prvPrintF(const BenchmarkThread_t* pxThread, uint32_t uiIteration)
+{
+	switch (pxThread->pxBenchmark->uiParameter)
+	{
+	case 0:
+		return xTracePrintF(xChannel, "none");
+	case 1:
+		return xTracePrintF(xChannel, "%d", (TraceUnsignedBaseType_t)uiIteration);
+	case 2:
+		return xTracePrintF(xChannel, "%d %d", (TraceUnsignedBaseType_t)uiIteration, (TraceUnsignedBaseType_t)2);
+	case 3:
+		return xTracePrintF(xChannel, "%d %d %d", (TraceUnsignedBaseType_t)uiIteration, (TraceUnsignedBaseType_t)2, (TraceUnsignedBaseType_t)3);
+	case 4:
+		return xTracePrintF(xChannel, "%d %d %d %d", (TraceUnsignedBaseType_t)uiIteration, (TraceUnsignedBaseType_t)2, (TraceUnsignedBaseType_t)3, (TraceUnsignedBaseType_t)4);
+	default:
+		return xTracePrintF(xChannel, "%d %d %d %d %d", (TraceUnsignedBaseType_t)uiIteration, (TraceUnsignedBaseType_t)2, (TraceUnsignedBaseType_t)3, (TraceUnsignedBaseType_t)4, (TraceUnsignedBaseType_t)5);
+	}
+}
+
+static traceResult prvEventBufferSetup(const Benchmark_t* pxBenchmark)
+{
+	(void)memset(auiEvent, 0xA5, sizeof(auiEvent));
+
+	return xTraceEventBufferInitialize(&xEventBuffer, pxBenchmark->uiParameter, auiEventBuffer, BENCHMARK_EVENT_BUFFER_SIZE);
+}
+
+static traceResult prvTransferSetup(const Benchmark_t* pxBenchmark)
+{
+	(void)pxBenchmark;
+
+	return xTraceEventBufferInitialize(&xEventBuffer, TRC_EVENT_BUFFER_OPTION_SKIP, auiEventBuffer, BENCHMARK_TRANSFER_BUFFER_SIZE);
+}
+
+static traceResult prvEventBufferPush(const BenchmarkThread_t* pxThread, uint32_t uiIteration)
+{
+	int32_t iBytesWritten = 0;
+
+	if ((pxThread->pxBenchmark->uiParameter == TRC_EVENT_BUFFER_OPTION_SKIP) && ((uiIteration % BENCHMARK_SKIP_CLEAR_PERIOD) == 0u))
+	{
+		(void)xTraceEventBufferClear(&xEventBuffer);
+	}
+
+	if (xTraceEventBufferPush(&xEventBuffer, auiEvent, BENCHMARK_EVENT_SIZE, &iBytesWritten) == TRC_FAIL)
+	{
+		return TRC_FAIL;
+	}
+
+	return ((uint32_t)iBytesWritten == BENCHMARK_EVENT_SIZE) ? TRC_SUCCESS : TRC_FAIL;
+}
+
+static traceResult prvEventBufferAlloc(const BenchmarkThread_t* pxThread, uint32_t uiIteration)
+{
+	void* pvData = (void*)0;
+	int32_t iBytesWritten = 0;
+
+	if ((pxThread->pxBenchmark->uiParameter == TRC_EVENT_BUFFER_OPTION_SKIP) && ((uiIteration % BENCHMARK_SKIP_CLEAR_PERIOD) == 0u))
+	{
+		(void)xTraceEventBufferClear(&xEventBuffer);
+	}
+
+	if ((xTraceEventBufferAlloc(&xEventBuffer, BENCHMARK_EVENT_SIZE, &pvData) == TRC_FAIL) || (pvData == (void*)0))
+	{
+		return TRC_FAIL;
+	}
+
+	(void)memcpy(pvData, auiEvent, BENCHMARK_EVENT_SIZE);
+
+	return xTraceEventBufferAllocCommit(&xEventBuffer, pvData, BENCHMARK_EVENT_SIZE, &iBytesWritten);
+}
+
+static traceResult prvTransferFill(const BenchmarkThread_t* pxThread, uint32_t uiIteration)
+{
+	int32_t iBytesWritten = 0;
+	uint32_t i;
+
+	(void)pxThread;
+	(void)uiIteration;
+
+	for (i = 0u; i < BENCHMARK_TRANSFER_SIZE; i += BENCHMARK_EVENT_SIZE)
+	{
+		if (xTraceEventBufferPush(&xEventBuffer, auiEvent, BENCHMARK_EVENT_SIZE, &iBytesWritten) == TRC_FAIL)
+		{
+			return TRC_FAIL;
+		}
+	}
+
+	return TRC_SUCCESS;
+}
+
+static traceResult prvTransferAll(const BenchmarkThread_t* pxThread, uint32_t uiIteration)
+{
+	int32_t iBytesWritten = 0;
+
+	(void)pxThread;
+	(void)uiIteration;
+
+	if (xTraceEventBufferTransferAll(&xEventBuffer, &iBytesWritten) == TRC_FAIL)
+	{
+		return TRC_FAIL;
+	}
+
+	return ((uint32_t)iBytesWritten == BENCHMARK_TRANSFER_SIZE) ? TRC_SUCCESS : TRC_FAIL;
+}
+
+/* Transfers what was filled in chunks, until the buffer is empty */
+static traceResult prvTransferChunk(const BenchmarkThread_t* pxThread, uint32_t uiIteration)
+{
+	int32_t iBytesWritten = 0;
+	uint32_t uiTotal = 0u;
+
+	(void)pxThread;
+	(void)uiIteration;
+
+	do
+	{
+		if (xTraceEventBufferTransferChunk(&xEventBuffer, BENCHMARK_TRANSFER_CHUNK_SIZE, &iBytesWritten) == TRC_FAIL)
+		{
+			return TRC_FAIL;
+		}
+		uiTotal += (uint32_t)iBytesWritten;
+	} while (iBytesWritten > 0);
+
+	return (uiTotal == BENCHMARK_TRANSFER_SIZE) ? TRC_SUCCESS : TRC_FAIL;
+}
+
+/* Fills the entry table to uiParameter percent of its slots */
+static traceResult prvEntryFill(const Benchmark_t* pxBenchmark)
+{
+	TraceEntryHandle_t xEntryHandle;
+	uint32_t uiUsed = 0u;
+	uint32_t uiTarget;
+
+	(void)xTraceEntryGetCount(&uiUsed);
+
+	uiTarget = ((uint32_t)(TRC_ENTRY_TABLE_SLOTS) * pxBenchmark->uiParameter) / 100u;
+
+	/* At least one entry to look up */
+	if (uiTarget <= uiUsed)
+	{
+		uiTarget = uiUsed + 1u;
+	}
+
+	uiEntriesCreated = 0u;
+	while ((uiUsed + uiEntriesCreated) < uiTarget)
+	{
+		if (xTraceEntryCreateWithAddress(&auiEntries[uiEntriesCreated], &xEntryHandle) == TRC_FAIL)
+		{
+			return TRC_FAIL;
+		}
+		uiEntriesCreated++;
+	}
+
+	return TRC_SUCCESS;
+}
+
+static traceResult prvEntryEmpty(const Benchmark_t* pxBenchmark)
+{
+	TraceEntryHandle_t xEntryHandle;
+
+	(void)pxBenchmark;
+
+	while (uiEntriesCreated > 0u)
+	{
+		uiEntriesCreated--;
+		if ((xTraceEntryFind(&auiEntries[uiEntriesCreated], &xEntryHandle) == TRC_FAIL) ||
+			(xTraceEntryDelete(xEntryHandle) == TRC_FAIL))
+		{
+			return TRC_FAIL;
+		}
+	}
+
+	return TRC_SUCCESS;
+}
+
+/* Looks up each of the created entries in turn */
+static traceResult prvEntryFind(const BenchmarkThread_t* pxThread, uint32_t uiIteration)
+{
+	TraceEntryHandle_t xEntryHandle;
+
+	(void)pxThread;
+
+	return xTraceEntryFind(&auiEntries[uiIteration % uiEntriesCreated], &xEntryHandle);
+}
+
+/* Looks up an address that isn't in the table, which searches all of it */
+static traceResult prvEntryFindMissing(const BenchmarkThread_t* pxThread, uint32_t uiIteration)
+{
+	TraceEntryHandle_t xEntryHandle;
+
+	(void)pxThread;
+	(void)uiIteration;
+
+	return (xTraceEntryFind(&auiEntries[TRC_ENTRY_TABLE_SLOTS - 1u], &xEntryHandle) == TRC_FAIL) ? TRC_SUCCESS : TRC_FAIL;
+}
+
+static traceResult prvObjectRegisterUnregister(const BenchmarkThread_t* pxThread, uint32_t uiIteration)
+{
+	TraceObjectHandle_t xObjectHandle;
+
+	if (xTraceObjectRegister(PSF_EVENT_TASK_CREATE, (void*)&pxThread->uxObject, "bench", uiIteration, &xObjectHandle) == TRC_FAIL)
+	{
+		return TRC_FAIL;
+	}
+
+	return xTraceObjectUnregister(xObjectHandle, PSF_EVENT_TASK_DELETE, uiIteration);
+}
+
+static const Benchmark_t axBenchmarks[] = {
+	{ "xTraceEventCreate0", prvEventCreate, 0, 0, 0, 0u, 1u },
+	{ "xTraceEventCreate1", prvEventCreate, 0, 0, 0, 1u, 1u },
+	{ "xTraceEventCreate2", prvEventCreate, 0, 0, 0, 2u, 1u },
+	{ "xTraceEventCreate3", prvEventCreate, 0, 0, 0, 3u, 1u },
+	{ "xTraceEventCreate4", prvEventCreate, 0, 0, 0, 4u, 1u },
+	{ "xTraceEventCreate5", prvEventCreate, 0, 0, 0, 5u, 1u },
+	{ "xTraceEventCreate6", prvEventCreate, 0, 0, 0, 6u, 1u },
+	{ "xTraceEventCreateData0 (32 bytes)", prvEventCreateData, 0, 0, 0, 0u, 1u },
+	{ "xTraceEventCreateData1 (32 bytes)", prvEventCreateData, 0, 0, 0, 1u, 1u },
+	{ "xTraceEventCreateData2 (32 bytes)", prvEventCreateData, 0, 0, 0, 2u, 1u },
+	{ "xTraceEventCreateData3 (32 bytes)", prvEventCreateData, 0, 0, 0, 3u, 1u },
+	{ "xTraceEventCreateData4 (32 bytes)", prvEventCreateData, 0, 0, 0, 4u, 1u },
+	{ "xTraceEventCreateData5 (32 bytes)", prvEventCreateData, 0, 0, 0, 5u, 1u },
+	{ "xTraceEventCreateData6 (32 bytes)", prvEventCreateData, 0, 0, 0, 6u, 1u },
+	{ "xTraceEventBufferPush (skip)", prvEventBufferPush, 0, prvEventBufferSetup, 0, TRC_EVENT_BUFFER_OPTION_SKIP, 0u },
+	{ "xTraceEventBufferPush (overwrite)", prvEventBufferPush, 0, prvEventBufferSetup, 0, TRC_EVENT_BUFFER_OPTION_OVERWRITE, 0u },
+	{ "xTraceEventBufferAlloc+AllocCommit (skip)", prvEventBufferAlloc, 0, prvEventBufferSetup, 0, TRC_EVENT_BUFFER_OPTION_SKIP, 0u },
+	{ "xTraceEventBufferAlloc+AllocCommit (overwrite)", prvEventBufferAlloc, 0, prvEventBufferSetup, 0, TRC_EVENT_BUFFER_OPTION_OVERWRITE, 0u },
+	{ "xTraceEventBufferTransferAll (1280 bytes)", prvTransferAll, prvTransferFill, prvTransferSetup, 0, 0u, 0u },
+	{ "xTraceEventBufferTransferChunk (1280 bytes, 512 byte chunks)", prvTransferChunk, prvTransferFill, prvTransferSetup, 0, 0u, 0u },
+	{ "xTraceEntryFind (25% full)", prvEntryFind, 0, prvEntryFill, prvEntryEmpty, 25u, 1u },
+	{ "xTraceEntryFind (50% full)", prvEntryFind, 0, prvEntryFill, prvEntryEmpty, 50u, 1u },
+	{ "xTraceEntryFind (75% full)", prvEntryFind, 0, prvEntryFill, prvEntryEmpty, 75u, 1u },
+	{ "xTraceEntryFind (100% full)", prvEntryFind, 0, prvEntryFill, prvEntryEmpty, 100u, 1u },
+	{ "xTraceEntryFind (missing)", prvEntryFindMissing, 0, 0, 0, 0u, 1u },
+	{ "xTraceObjectRegister+Unregister", prvObjectRegisterUnregister, 0, 0, 0, 0u, 1u },
+	{ "xTracePrintF (0 args)", prvPrintF, 0, 0, 0, 0u, 1u },
+	{ "xTracePrintF (1 arg)", prvPrintF, 0, 0, 0, 1u, 1u },
+	{ "xTracePrintF (2 args)", prvPrintF, 0, 0, 0, 2u, 1u },
+	{ "xTracePrintF (3 args)", prvPrintF, 0, 0, 0, 3u, 1u },
+	{ "xTracePrintF (4 args)", prvPrintF, 0, 0, 0, 4u, 1u },
+	{ "xTracePrintF (5 args)", prvPrintF, 0, 0, 0, 5u, 1u },
+};
+
+#define BENCHMARK_COUNT (sizeof(axBenchmarks) / sizeof(axBenchmarks[0]))
+
+static void prvRunIterations(BenchmarkThread_t* pxThread, uint32_t uiIterations)
+{
+	const Benchmark_t* pxBenchmark = pxThread->pxBenchmark;
+	uint64_t ullStart;
+	uint64_t ullCycles;
+	double dStart;
+	double dSeconds;
+	uint32_t i;
+
+	pxThread->uiFailed = 0u;
+
+	if (pxBenchmark->xPrepare == 0)
+	{
+		dStart = prvNow();
+		ullStart = BENCHMARK_CYCLES();
+
+		for (i = 0u; i < uiIterations; i++)
+		{
+			if (pxBenchmark->xOperation(pxThread, i) == TRC_FAIL)
+			{
+				pxThread->uiFailed++;
+			}
+		}
+
+		pxThread->ullCycles = BENCHMARK_CYCLES() - ullStart;
+		pxThread->dEnd = prvNow();
+		pxThread->dBegin = dStart;
+		pxThread->dSeconds = pxThread->dEnd - dStart;
+	}
+	else
+	{
+		pxThread->ullCycles = 0u;
+		pxThread->dSeconds = 0.0;
+
+		for (i = 0u; i < uiIterations; i++)
+		{
+			if (pxBenchmark->xPrepare(pxThread, i) == TRC_FAIL)
+			{
+				pxThread->uiFailed++;
+			}
+
+			dStart = prvNow();
+			ullStart = BENCHMARK_CYCLES();
+
+			if (pxBenchmark->xOperation(pxThread, i) == TRC_FAIL)
+			{
+				pxThread->uiFailed++;
+			}
+
+			ullCycles = BENCHMARK_CYCLES() - ullStart;
+			dSeconds = prvNow() - dStart;
+
+			pxThread->ullCycles += (ullCycles > ullTimerCycles) ? (ullCycles - ullTimerCycles) : 0u;
+			pxThread->dSeconds += (dSeconds > dTimerSeconds) ? (dSeconds - dTimerSeconds) : 0.0;
+		}
+
+		/* Only the calls count towards the throughput */
+		pxThread->dBegin = 0.0;
+		pxThread->dEnd = pxThread->dSeconds;
+	}
+}
+
+/* Measures what timing a single call adds, for prvRunIterations() */
+static void prvCalibrate(void)
+{
+	uint64_t ullStart;
+	uint64_t ullCycles = 0u;
+	double dStart;
+	double dSeconds = 0.0;
+	uint32_t i;
+
+	for (i = 0u; i < BENCHMARK_ITERATIONS; i++)
+	{
+		dStart = prvNow();
+		ullStart = BENCHMARK_CYCLES();
+		ullCycles += BENCHMARK_CYCLES() - ullStart;
+		dSeconds += prvNow() - dStart;
+	}
+
+	ullTimerCycles = ullCycles / BENCHMARK_ITERATIONS;
+	dTimerSeconds = dSeconds / (double)BENCHMARK_ITERATIONS;
+}
+
+static void* prvThread(void* pvParameter)
+{
+	BenchmarkThread_t* pxThread = (BenchmarkThread_t*)pvParameter;
+
+	/* Warm up caches and branch predictors */
+	prvRunIterations(pxThread, pxThread->uiIterations / 16u);
+
+	(void)pthread_barrier_wait(&xBarrier);
+
+	prvRunIterations(pxThread, pxThread->uiIterations);
+
+	return (void*)0;
+}
+
+static traceResult prvRun(const Benchmark_t* pxBenchmark, uint32_t uiThreads, uint32_t uiIterations, BenchmarkResult_t* pxResult)
+{
+	static BenchmarkThread_t axThreads[BENCHMARK_MAX_THREADS];
+	pthread_t axThreadIds[BENCHMARK_MAX_THREADS];
+	double dBegin, dEnd;
+	uint32_t i;
+
+	if ((pxBenchmark->xSetup != 0) && (pxBenchmark->xSetup(pxBenchmark) == TRC_FAIL))
+	{
+		return TRC_FAIL;
+	}
+
+	(void)pthread_barrier_init(&xBarrier, (const pthread_barrierattr_t*)0, uiThreads + 1u);
+
+	for (i = 0u; i < uiThreads; i++)
+	{
+		(void)memset(&axThreads[i], 0, sizeof(axThreads[i]));
+		axThreads[i].pxBenchmark = pxBenchmark;
+		axThreads[i].uiIterations = uiIterations;
+		(void)pthread_create(&axThreadIds[i], (const pthread_attr_t*)0, prvThread, &axThreads[i]);
+	}
+
+	(void)pthread_barrier_wait(&xBarrier);
+
+	for (i = 0u; i < uiThreads; i++)
+	{
+		(void)pthread_join(axThreadIds[i], (void**)0);
+	}
+
+	(void)pthread_barrier_destroy(&xBarrier);
+
+	(void)memset(pxResult, 0, sizeof(*pxResult));
+	dBegin = axThreads[0].dBegin;
+	dEnd = axThreads[0].dEnd;
+	for (i = 0u; i < uiThreads; i++)
+	{
+		/* From the first thread starting to the last one finishing */
+		if (axThreads[i].dBegin < dBegin)
+		{
+			dBegin = axThreads[i].dBegin;
+		}
+		if (axThreads[i].dEnd > dEnd)
+		{
+			dEnd = axThreads[i].dEnd;
+		}
+		pxResult->dNsPerOperation += axThreads[i].dSeconds * 1e9 / (double)uiIterations;
+		pxResult->dCyclesPerOperation += (double)axThreads[i].ullCycles / (double)uiIterations;
+		pxResult->uiFailed += axThreads[i].uiFailed;
+	}
+	pxResult->dNsPerOperation /= (double)uiThreads;
+	pxResult->dCyclesPerOperation /= (double)uiThreads;
+	pxResult->dOperationsPerSecond = (double)uiThreads * (double)uiIterations / (dEnd - dBegin);
+
+	if ((pxBenchmark->xTeardown != 0) && (pxBenchmark->xTeardown(pxBenchmark) == TRC_FAIL))
+	{
+		return TRC_FAIL;
+	}
+
+	return TRC_SUCCESS;
+}
+
+static void prvPrintResult(const Benchmark_t* pxBenchmark, uint32_t uiThreads, uint32_t uiIterations, const BenchmarkResult_t* pxResult, const BenchmarkResult_t* pxSingle, uint32_t uiFirst)
+{
+	printf("%s\n\t\t{ \"name\": \"%s\", \"threads\": %u, \"iterations\": %u, \"ns_per_op\": %.2f, \"cycles_per_op\": %.1f, \"ops_per_s\": %.0f, ",
+		(uiFirst != 0u) ? "" : ",",
+		pxBenchmark->szName,
+		(unsigned int)uiThreads,
+		(unsigned int)uiIterations,
+		pxResult->dNsPerOperation,
+		pxResult->dCyclesPerOperation,
+		pxResult->dOperationsPerSecond);
+
+	if (pxSingle != (void*)0)
+	{
+		printf("\"scaling\": %.3f, ", pxResult->dOperationsPerSecond / pxSingle->dOperationsPerSecond);
+	}
+
+	printf("\"failed\": %u }", (unsigned int)pxResult->uiFailed);
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkResult_t xSingle;
+	BenchmarkResult_t xMulti;
+	uint32_t uiIterations = BENCHMARK_ITERATIONS;
+	uint32_t uiThreads = BENCHMARK_THREADS;
+	uint32_t uiFailed = 0u;
+	uint32_t uiFirst = 1u;
+	uint32_t i;
+
+	if (argc > 1)
+	{
+		uiIterations = (uint32_t)strtoul(argv[1], (char**)0, 0);
+	}
+	if (argc > 2)
+	{
+		uiThreads = (uint32_t)strtoul(argv[2], (char**)0, 0);
+	}
+	if (uiIterations < 16u)
+	{
+		uiIterations = BENCHMARK_ITERATIONS;
+	}
+	if ((uiThreads < 2u) || (uiThreads > BENCHMARK_MAX_THREADS))
+	{
+		uiThreads = BENCHMARK_THREADS;
+	}
+
+	prvCalibrate();
+
+	(void)xTraceInitialize();
+	(void)xTraceEnable(TRC_START);
+	(void)xTraceStreamPortSimulatedSetInterface(TRC_STREAM_PORT_SIMULATED_NULL);
+	(void)xTraceStringRegister("bench", &xChannel);
+
+	printf("{\n");
+	printf("\t\"recorder\": \"%s\",\n", BENCHMARK_RECORDER_VERSION);
+	printf("\t\"cycle_counter\": \"%s\",\n", BENCHMARK_CYCLE_COUNTER);
+	printf("\t\"core_count\": %u,\n", (unsigned int)(TRC_CFG_CORE_COUNT));
+	printf("\t\"entry_slots\": %u,\n", (unsigned int)(TRC_ENTRY_TABLE_SLOTS));
+	printf("\t\"iterations\": %u,\n", (unsigned int)uiIterations);
+	printf("\t\"threads\": %u,\n", (unsigned int)uiThreads);
+	printf("\t\"benchmarks\": [");
+
+	for (i = 0u; i < BENCHMARK_COUNT; i++)
+	{
+		if (prvRun(&axBenchmarks[i], 1u, uiIterations, &xSingle) == TRC_FAIL)
+		{
+			fprintf(stderr, "%s: setup failed\n", axBenchmarks[i].szName);
+			uiFailed++;
+			continue;
+		}
+		prvPrintResult(&axBenchmarks[i], 1u, uiIterations, &xSingle, (void*)0, uiFirst);
+		uiFirst = 0u;
+		uiFailed += xSingle.uiFailed;
+
+		if (axBenchmarks[i].uiThreadSafe == 0u)
+		{
+			continue;
+		}
+
+		if (prvRun(&axBenchmarks[i], uiThreads, uiIterations, &xMulti) == TRC_FAIL)
+		{
+			fprintf(stderr, "%s: setup failed\n", axBenchmarks[i].szName);
+			uiFailed++;
+			continue;
+		}
+		prvPrintResult(&axBenchmarks[i], uiThreads, uiIterations, &xMulti, &xSingle, uiFirst);
+		uiFailed += xMulti.uiFailed;
+	}
+
+	printf("\n\t]\n}\n");
+
+	(void)xTraceDisable();
+
+	return (uiFailed > 0u) ? 1 : 0;
+}
@@ -0,0 +1,230 @@
+/*
+* Percepio Trace Recorder for Tracealyzer v4.10.3
+* Copyright 2023 Percepio AB
+* www.percepio.com
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* Cycle benchmark for the snapshot recorder's absolute time bookkeeping in
+* prvTraceGetDTS. Calls prvTraceAddAbsTime of the recorder, which splits a DTS
+* into seconds and remainder with TRC_DIVMOD_RECIPROCAL, and compares it with
+* the original division based code, verifying that absTimeLastEvent and
+* absTimeLastEventSecond stay bit-identical.
+*
+* Built by the host CMake build and linked with the snapshot recorder.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <trcRecorder.h>
+
+#if defined(BENCHMARK_CYCLES)
+/* Provided by the build, e.g., a target cycle counter */
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCHMARK_CYCLES() ((uint64_t)__rdtsc())
+#elif defined(__aarch64__)
+static inline uint64_t prvReadCounter(void)
+{
+	uint64_t ullValue;
+	__asm__ volatile("isb; mrs %0, cntvct_el0" : "=r"(ullValue));
+	return ullValue;
+}
+#define BENCHMARK_CYCLES() prvReadCounter()
+#else
+static inline uint64_t prvReadCounter(void)
+{
+	struct timespec xTime;
+	(void)clock_gettime(CLOCK_MONOTONIC, &xTime);
+	return (uint64_t)xTime.tv_sec * 1000000000ULL + (uint64_t)xTime.tv_nsec;
+}
+#define BENCHMARK_CYCLES() prvReadCounter()
+#endif
+
+#define BENCHMARK_SAMPLES 100000u
+#define BENCHMARK_ROUNDS 20u
+
+static uint32_t puiDTS[BENCHMARK_SAMPLES];
+
+/* The reference, the bookkeeping as it was done before with / and % */
+static void prvAbsTimeDivide(EventLogCounters* pxTime, const uint32_t* puiValues, uint32_t uiCount, uint32_t uiFrequency)
+{
+	uint32_t i;
+
+	for (i = 0u; i < uiCount; i++)
+	{
+		uint32_t dts = puiValues[i];
+
+		if (dts > uiFrequency)
+		{
+			pxTime->absTimeLastEventSecond += dts / uiFrequency;
+			pxTime->absTimeLastEvent += dts % uiFrequency;
+		}
+		else
+		{
+			pxTime->absTimeLastEvent += dts;
+		}
+
+		if (pxTime->absTimeLastEvent >= uiFrequency)
+		{
+			pxTime->absTimeLastEventSecond++;
+			pxTime->absTimeLastEvent -= uiFrequency;
+		}
+	}
+}
+
+/* The bookkeeping of prvTraceGetDTS, done by the recorder */
+static void prvAbsTimeRecorder(EventLogCounters* pxLog, const uint32_t* puiValues, uint32_t uiCount, uint32_t uiReciprocal)
+{
+	uint32_t i;
+
+	for (i = 0u; i < uiCount; i++)
+	{
+		prvTraceAddAbsTime(pxLog, uiReciprocal, puiValues[i]);
+	}
+}
+
+static uint32_t prvRandom(void)
+{
+	static uint64_t ullState = 0x9E3779B97F4A7C15ULL;
+
+	ullState ^= ullState << 13;
+	ullState ^= ullState >> 7;
+	ullState ^= ullState << 17;
+
+	return (uint32_t)(ullState >> 16);
+}
+
+static uint32_t prvRandomInRange(uint64_t ullLow, uint64_t ullHigh)
+{
+	uint64_t ullValue;
+
+	if (ullHigh > 0xFFFFFFFFULL)
+	{
+		ullHigh = 0xFFFFFFFFULL;
+	}
+
+	if (ullLow >= ullHigh)
+	{
+		return (uint32_t)ullHigh;
+	}
+
+	ullValue = ((uint64_t)prvRandom() << 32) | prvRandom();
+
+	return (uint32_t)(ullLow + ullValue % (ullHigh - ullLow));
+}
+
+/* Quotient and remainder must match / and % exactly, check around every multiple boundary */
+static int prvVerifyEdges(uint32_t uiFrequency, uint32_t uiReciprocal)
+{
+	uint64_t ullMultiple;
+	uint32_t uiQuotient, uiRemainder, uiValue;
+	int iDelta;
+
+	for (ullMultiple = uiFrequency; ullMultiple <= 0xFFFFFFFFULL; ullMultiple += ((ullMultiple / uiFrequency) < 4096u) ? uiFrequency : (ullMultiple / 7u))
+	{
+		for (iDelta = -1; iDelta <= 1; iDelta++)
+		{
+			if ((ullMultiple + (uint64_t)(int64_t)iDelta) > 0xFFFFFFFFULL)
+			{
+				continue;
+			}
+			uiValue = (uint32_t)(ullMultiple + (uint64_t)(int64_t)iDelta);
+			TRC_DIVMOD_RECIPROCAL(uiValue, uiFrequency, uiReciprocal, uiQuotient, uiRemainder);
+			if ((uiQuotient != uiValue / uiFrequency) || (uiRemainder != uiValue % uiFrequency))
+			{
+				printf("MISMATCH frequency %u value %u\n", uiFrequency, uiValue);
+				return 0;
+			}
+		}
+	}
+
+	uiValue = 0xFFFFFFFFu;
+	TRC_DIVMOD_RECIPROCAL(uiValue, uiFrequency, uiReciprocal, uiQuotient, uiRemainder);
+
+	return (uiQuotient == uiValue / uiFrequency) && (uiRemainder == uiValue % uiFrequency);
+}
+
+int main(void)
+{
+	static const uint32_t puiFrequencies[] = { 1000u, 32768u, 1000000u, 16000000u, 72000000u, 480000000u, 4000000000u };
+	static const struct { const char* szName; uint32_t uiLow; uint32_t uiHigh; } pxRanges[] = {
+		{ "dts < 1 s", 0u, 1u },
+		{ "1-10 s", 1u, 10u },
+		{ "10-1000 s", 10u, 1000u },
+		{ "full 32-bit", 0u, 0u }
+	};
+	volatile uint32_t uiVolatileFrequency;
+	uint32_t f, r, i;
+	int iResult = EXIT_SUCCESS;
+
+	printf("%-12s %-12s %14s %16s %8s\n", "frequency", "range", "div cyc/op", "recorder cyc/op", "match");
+
+	for (f = 0u; f < sizeof(puiFrequencies) / sizeof(puiFrequencies[0]); f++)
+	{
+		/* Read through a volatile so the compiler cannot use a constant divisor */
+		uint32_t uiFrequency;
+		uint32_t uiReciprocal;
+
+		uiVolatileFrequency = puiFrequencies[f];
+		uiFrequency = uiVolatileFrequency;
+		uiReciprocal = TRC_RECIPROCAL(uiFrequency);
+
+		if (prvVerifyEdges(uiFrequency, uiReciprocal) == 0)
+		{
+			iResult = EXIT_FAILURE;
+		}
+
+		for (r = 0u; r < sizeof(pxRanges) / sizeof(pxRanges[0]); r++)
+		{
+			EventLogCounters xDivide = { 0u };
+			EventLogCounters xReciprocal = { 0u };
+			uint64_t ullDivideCycles = 0u;
+			uint64_t ullReciprocalCycles = 0u;
+			uint64_t ullStart;
+			int iMatch;
+
+			for (i = 0u; i < BENCHMARK_SAMPLES; i++)
+			{
+				if (pxRanges[r].uiHigh == 0u)
+				{
+					puiDTS[i] = prvRandomInRange(0u, 0xFFFFFFFFULL);
+				}
+				else
+				{
+					puiDTS[i] = prvRandomInRange((uint64_t)pxRanges[r].uiLow * uiFrequency, (uint64_t)pxRanges[r].uiHigh * uiFrequency);
+				}
+			}
+
+			xReciprocal.frequency = uiFrequency;
+			for (i = 0u; i < BENCHMARK_ROUNDS; i++)
+			{
+				ullStart = BENCHMARK_CYCLES();
+				prvAbsTimeDivide(&xDivide, puiDTS, BENCHMARK_SAMPLES, uiFrequency);
+				ullDivideCycles += BENCHMARK_CYCLES() - ullStart;
+
+				ullStart = BENCHMARK_CYCLES();
+				prvAbsTimeRecorder(&xReciprocal, puiDTS, BENCHMARK_SAMPLES, uiReciprocal);
+				ullReciprocalCycles += BENCHMARK_CYCLES() - ullStart;
+			}
+
+			iMatch = (xDivide.absTimeLastEvent == xReciprocal.absTimeLastEvent) &&
+				(xDivide.absTimeLastEventSecond == xReciprocal.absTimeLastEventSecond);
+			if (!iMatch)
+			{
+				iResult = EXIT_FAILURE;
+			}
+
+			printf("%-12u %-12s %14.2f %16.2f %8s\n",
+				uiFrequency,
+				pxRanges[r].szName,
+				(double)ullDivideCycles / (BENCHMARK_SAMPLES * BENCHMARK_ROUNDS),
+				(double)ullReciprocalCycles / (BENCHMARK_SAMPLES * BENCHMARK_ROUNDS),
+				iMatch ? "yes" : "NO");
+		}
+	}
+
+	return iResult;
+}
@@ -0,0 +1,196 @@
+/*
+* Percepio Trace Recorder for Tracealyzer v4.10.3
+* Copyright 2023 Percepio AB
+* www.percepio.com
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* Benchmark and stream check for the Jlink_RTT stream port on the host, with
+* SEGGER's RTT code standing in for the target. Events are stored in batches
+* that fill half of the RTT up buffer, and only the stores are timed. After
+* each batch the buffer is drained as the J-Link probe does, by reading up to
+* WrOff and then advancing RdOff, and the data is checked for whole events
+* with consecutive event counters. The batches don't line up with the end of
+* the buffer, so events that would wrap are stored too.
+*
+* Built by the host CMake build twice, trcBenchmarkRTT with
+* TRC_CFG_STREAM_PORT_RTT_ZERO_COPY and trcBenchmarkRTTCopy without, run as:
+*	trcBenchmarkRTT [events] [parameters per event, 0 to 4]
+*/
+
+#include <trcRecorder.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* The largest event, a TraceEvent0_t with 15 parameters */
+#define BENCHMARK_MAX_EVENT_SIZE (8u + (15u * sizeof(TraceUnsignedBaseType_t)))
+
+typedef struct BenchmarkReader
+{
+	uint8_t uiEvent[BENCHMARK_MAX_EVENT_SIZE];
+	uint32_t uiLength;				/* Bytes of the current event so far */
+	uint32_t uiSize;				/* Size of the current event, 0 until its header is in */
+	uint32_t uiEvents;
+	uint32_t uiCounterErrors;
+	uint16_t uiLastCounter;
+	uint64_t ulBytes;
+} BenchmarkReader_t;
+
+static BenchmarkReader_t xReader = { { 0u }, 0u, 0u, 0u, 0u, 0u, 0u };
+
+static double prvNow(void)
+{
+	struct timespec xTime;
+
+	(void)clock_gettime(CLOCK_MONOTONIC, &xTime);
+
+	return (double)xTime.tv_sec + (double)xTime.tv_nsec * 1e-9;
+}
+
+static void prvParse(const uint8_t* puiData, uint32_t uiSize)
+{
+	uint16_t uiEventId;
+	uint16_t uiCounter;
+	uint32_t i;
+
+	for (i = 0u; i < uiSize; i++)
+	{
+		xReader.uiEvent[xReader.uiLength] = puiData[i];
+		xReader.uiLength++;
+
+		if ((xReader.uiSize == 0u) && (xReader.uiLength == 4u))
+		{
+			/* The parameter count is in the top 4 bits of the event ID */
+			uiEventId = (uint16_t)(xReader.uiEvent[0] | (xReader.uiEvent[1] << 8));
+			xReader.uiSize = 8u + ((uint32_t)(uiEventId >> 12) * (uint32_t)sizeof(TraceUnsignedBaseType_t));
+		}
+
+		if ((xReader.uiSize != 0u) && (xReader.uiLength == xReader.uiSize))
+		{
+			uiCounter = (uint16_t)(xReader.uiEvent[2] | (xReader.uiEvent[3] << 8));
+			if ((xReader.uiEvents > 0u) && (uiCounter != (uint16_t)(xReader.uiLastCounter + 1u)))
+			{
+				xReader.uiCounterErrors++;
+			}
+			xReader.uiLastCounter = uiCounter;
+			xReader.uiEvents++;
+			xReader.uiLength = 0u;
+			xReader.uiSize = 0u;
+		}
+	}
+}
+
+/* Reads the RTT up buffer the way the J-Link probe does */
+static uint32_t prvRead(uint32_t uiDiscard)
+{
+	volatile SEGGER_RTT_BUFFER_UP* pxUp = &_SEGGER_RTT.aUp[TRC_CFG_STREAM_PORT_RTT_UP_BUFFER_INDEX];
+	uint32_t uiWrOff = __atomic_load_n(&pxUp->WrOff, __ATOMIC_ACQUIRE);
+	uint32_t uiRdOff = pxUp->RdOff;
+	uint32_t uiSize;
+
+	if (uiWrOff == uiRdOff)
+	{
+		return 0u;
+	}
+
+	uiSize = (uiWrOff > uiRdOff) ? (uiWrOff - uiRdOff) : (pxUp->SizeOfBuffer - uiRdOff);
+	if (uiDiscard == 0u)
+	{
+		prvParse((const uint8_t*)&pxUp->pBuffer[uiRdOff], uiSize);
+		xReader.ulBytes += uiSize;
+	}
+
+	__atomic_store_n(&pxUp->RdOff, (uiRdOff + uiSize) % pxUp->SizeOfBuffer, __ATOMIC_RELEASE);
+
+	return uiSize;
+}
+
+int main(int argc, char** argv)
+{
+	TraceStringHandle_t xChannel;
+	uint32_t uiEvents = 1000000u;
+	uint32_t uiParameters = 2u;
+	uint32_t uiFailed = 0u;
+	uint32_t uiBatch;
+	uint32_t i;
+	double dStart;
+	double dTime = 0.0;
+
+	if (argc > 1)
+	{
+		uiEvents = (uint32_t)strtoul(argv[1], (char**)0, 0);
+	}
+	if (argc > 2)
+	{
+		uiParameters = (uint32_t)strtoul(argv[2], (char**)0, 0);
+	}
+	if (uiParameters > 4u)
+	{
+		uiParameters = 4u;
+	}
+
+	(void)xTraceInitialize();
+	(void)xTraceStringRegister("bench", &xChannel);
+
+	/* The preamble is written as the recorder is enabled, it isn't checked */
+	while (prvRead(1u) > 0u) {}
+	(void)xTraceEnable(TRC_START);
+	while (prvRead(1u) > 0u) {}
+
+	uiBatch = (uint32_t)(TRC_CFG_STREAM_PORT_RTT_UP_BUFFER_SIZE) / 2u / (8u + uiParameters * (uint32_t)sizeof(TraceUnsignedBaseType_t));
+
+	dStart = prvNow();
+
+	for (i = 0u; i < uiEvents; i++)
+	{
+		traceResult xResult;
+
+		if ((i % uiBatch) == 0u)
+		{
+			dTime += prvNow() - dStart;
+			while (prvRead(0u) > 0u) {}
+			dStart = prvNow();
+		}
+
+		switch (uiParameters)
+		{
+		case 0:
+			xResult = xTraceEventCreate0(PSF_EVENT_USER_EVENT);
+			break;
+		case 1:
+			xResult = xTraceEventCreate1(PSF_EVENT_USER_EVENT, (TraceUnsignedBaseType_t)i);
+			break;
+		case 2:
+			xResult = xTraceEventCreate2(PSF_EVENT_USER_EVENT, (TraceUnsignedBaseType_t)xChannel, (TraceUnsignedBaseType_t)i);
+			break;
+		case 3:
+			xResult = xTraceEventCreate3(PSF_EVENT_USER_EVENT, (TraceUnsignedBaseType_t)xChannel, (TraceUnsignedBaseType_t)i, 3u);
+			break;
+		default:
+			xResult = xTraceEventCreate4(PSF_EVENT_USER_EVENT, (TraceUnsignedBaseType_t)xChannel, (TraceUnsignedBaseType_t)i, 3u, 4u);
+			break;
+		}
+
+		if (xResult == TRC_FAIL)
+		{
+			uiFailed++;
+		}
+	}
+
+	dTime += prvNow() - dStart;
+	while (prvRead(0u) > 0u) {}
+
+	(void)xTraceDisable();
+
+	printf("zero copy %u, events %u, %u parameters, RTT buffer %u bytes\n",
+		(unsigned int)(TRC_STREAM_PORT_RTT_ZERO_COPY), (unsigned int)uiEvents,
+		(unsigned int)uiParameters, (unsigned int)(TRC_CFG_STREAM_PORT_RTT_UP_BUFFER_SIZE));
+	printf("%.1f ns/event, %.1f MB/s\n", dTime * 1e9 / (double)uiEvents,
+		(double)xReader.ulBytes / dTime / 1e6);
+	printf("received %u events, %llu bytes, counter errors %u, partial event %u bytes, not stored %u\n",
+		(unsigned int)xReader.uiEvents, (unsigned long long)xReader.ulBytes,
+		(unsigned int)xReader.uiCounterErrors, (unsigned int)xReader.uiLength, (unsigned int)uiFailed);
+
+	return ((xReader.uiEvents == uiEvents) && (xReader.uiCounterErrors == 0u) && (xReader.uiLength == 0u) && (uiFailed == 0u)) ? 0 : 1;
+}
@@ -0,0 +1,206 @@
+/*
+* Percepio Trace Recorder for Tracealyzer v4.10.3
+* Copyright 2023 Percepio AB
+* www.percepio.com
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* Throughput benchmark for the POSIX TCP/IP stream port
+* (streamports/TCPIP_POSIX). A sink thread connects over loopback, starts the
+* recording like Tracealyzer does and reads everything until the connection
+* closes. Worker threads generate user events while a TzCtrl thread transfers
+* the internal buffer.
+*
+* Built by the host CMake build (trcBenchmarkTCPIP), run as:
+*	trcBenchmarkTCPIP [threads] [events per thread] [TzCtrl period in us]
+*/
+
+#include <trcRecorder.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BENCHMARK_MAX_THREADS 64u
+
+static volatile uint32_t uiStopTzCtrl = 0u;
+static uint32_t uiEventsPerThread = 200000u;
+static uint32_t uiTzCtrlPeriod = 1000u;
+static uint64_t ulBytesReceived = 0u;
+static uint32_t uiBufferFull = 0u;
+
+static double prvNow(void)
+{
+	struct timespec xTime;
+
+	(void)clock_gettime(CLOCK_MONOTONIC, &xTime);
+
+	return (double)xTime.tv_sec + (double)xTime.tv_nsec * 1e-9;
+}
+
+/* Plays the part of Tracealyzer: connects, sends the start command and reads until the recorder closes the connection */
+static void* prvSink(void* pvArg)
+{
+	/* CMD_SET_ACTIVE, param1 = 1, checksum 0xFFFF - 2 */
+	static const uint8_t uiStartCommand[8] = { 1u, 1u, 0u, 0u, 0u, 0u, 0xFDu, 0xFFu };
+	struct sockaddr_in xAddress = { 0 };
+	uint8_t uiBuffer[65536];
+	ssize_t iRead;
+	int iSocket = -1;
+	uint32_t i;
+
+	xAddress.sin_family = AF_INET;
+	xAddress.sin_port = htons(TRC_CFG_STREAM_PORT_TCPIP_PORT);
+	xAddress.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	for (i = 0u; i < 500u; i++)
+	{
+		iSocket = socket(AF_INET, SOCK_STREAM, 0);
+		if (connect(iSocket, (struct sockaddr*)&xAddress, sizeof(xAddress)) == 0)
+		{
+			break;
+		}
+
+		/* The recorder hasn't created the listening socket yet */
+		(void)close(iSocket);
+		iSocket = -1;
+		(void)usleep(10000);
+	}
+
+	if (iSocket < 0)
+	{
+		printf("Could not connect to the recorder.\n");
+		exit(1);
+	}
+
+	(void)send(iSocket, uiStartCommand, sizeof(uiStartCommand), 0);
+
+	while ((iRead = recv(iSocket, uiBuffer, sizeof(uiBuffer), 0)) > 0)
+	{
+		ulBytesReceived += (uint64_t)iRead;
+	}
+
+	(void)close(iSocket);
+
+	return pvArg;
+}
+
+static void* prvTzCtrl(void* pvArg)
+{
+	while (uiStopTzCtrl == 0u)
+	{
+		(void)xTraceTzCtrl();
+		(void)usleep(uiTzCtrlPeriod);
+	}
+
+	return pvArg;
+}
+
+static void* prvWorker(void* pvArg)
+{
+	TraceStringHandle_t xChannel;
+	uint32_t uiFailed = 0u;
+	uint32_t i;
+
+	(void)xTraceStringRegister("bench", &xChannel);
+
+	for (i = 0u; i < uiEventsPerThread; i++)
+	{
+		if (xTracePrintF(xChannel, "%d %d", (int)i, (int)(i >> 8)) == TRC_FAIL)
+		{
+			/* The internal buffer is full, TzCtrl doesn't keep up */
+			uiFailed++;
+		}
+	}
+
+	(void)__atomic_fetch_add(&uiBufferFull, uiFailed, __ATOMIC_RELAXED);
+
+	return pvArg;
+}
+
+int main(int argc, char** argv)
+{
+	pthread_t xSink, xTzCtrl, xWorkers[BENCHMARK_MAX_THREADS];
+	TraceStreamPortTCPIPStatistics_t xStatistics;
+	uint64_t ulLastSent = 0u;
+	uint32_t uiThreads = 4u;
+	uint32_t uiIdle = 0u;
+	uint32_t i;
+	double dStart, dEnd;
+
+	if (argc > 1)
+	{
+		uiThreads = (uint32_t)strtoul(argv[1], (char**)0, 0);
+	}
+	if (argc > 2)
+	{
+		uiEventsPerThread = (uint32_t)strtoul(argv[2], (char**)0, 0);
+	}
+	if (argc > 3)
+	{
+		uiTzCtrlPeriod = (uint32_t)strtoul(argv[3], (char**)0, 0);
+	}
+	if ((uiThreads == 0u) || (uiThreads > BENCHMARK_MAX_THREADS))
+	{
+		uiThreads = 4u;
+	}
+
+	(void)xTraceInitialize();
+
+	(void)pthread_create(&xSink, (const pthread_attr_t*)0, prvSink, (void*)0);
+
+	/* Returns when the sink has sent the start command */
+	(void)xTraceEnable(TRC_START_AWAIT_HOST);
+
+	(void)pthread_create(&xTzCtrl, (const pthread_attr_t*)0, prvTzCtrl, (void*)0);
+
+	dStart = prvNow();
+
+	for (i = 0u; i < uiThreads; i++)
+	{
+		(void)pthread_create(&xWorkers[i], (const pthread_attr_t*)0, prvWorker, (void*)0);
+	}
+
+	for (i = 0u; i < uiThreads; i++)
+	{
+		(void)pthread_join(xWorkers[i], (void**)0);
+	}
+
+	/* Let TzCtrl drain the internal buffer */
+	while (uiIdle < 20u)
+	{
+		(void)usleep(1000);
+		(void)xTraceStreamPortGetStatistics(&xStatistics);
+		uiIdle = (xStatistics.ulBytesSent == ulLastSent) ? uiIdle + 1u : 0u;
+		ulLastSent = xStatistics.ulBytesSent;
+	}
+
+	uiStopTzCtrl = 1u;
+	(void)pthread_join(xTzCtrl, (void**)0);
+
+	(void)xTraceDisable();
+	(void)pthread_join(xSink, (void**)0);
+
+	dEnd = prvNow();
+
+	(void)xTraceStreamPortGetStatistics(&xStatistics);
+
+	printf("threads %u, events %u\n", (unsigned int)uiThreads, (unsigned int)(uiThreads * uiEventsPerThread));
+	printf("received %llu bytes in %.3f s, %.1f MB/s, %.2f Mevents/s\n",
+		(unsigned long long)ulBytesReceived, dEnd - dStart,
+		(double)ulBytesReceived / (dEnd - dStart) / 1e6,
+		(double)(uiThreads * uiEventsPerThread - uiBufferFull) / (dEnd - dStart) / 1e6);
+	printf("events not stored, internal buffer full: %u (stream port statistics %u)\n",
+		(unsigned int)uiBufferFull, (unsigned int)xStatistics.uiBufferFullEvents);
+	printf("send calls %u, %.0f bytes per call, backpressure %u, dropped without internal buffer %u\n",
+		(unsigned int)xStatistics.uiSendCalls,
+		(xStatistics.uiSendCalls > 0u) ? (double)xStatistics.ulBytesSent / (double)xStatistics.uiSendCalls : 0.0,
+		(unsigned int)xStatistics.uiBackpressure,
+		(unsigned int)xStatistics.uiDroppedEvents);
+
+	return ((ulBytesReceived == xStatistics.ulBytesSent) && (xStatistics.uiBufferFullEvents >= uiBufferFull)) ? 0 : 1;
+}
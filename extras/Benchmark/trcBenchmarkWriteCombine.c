@@ -0,0 +1,106 @@
+/*
+* Percepio Trace Recorder for Tracealyzer v4.10.3
+* Copyright 2023 Percepio AB
+* www.percepio.com
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* Benchmark for write combining in the Direct mode stream ports. User events
+* are stored through a simulated stream port (extras/Benchmark/SimulatedPort)
+* that does the work of the RTT, ITM and socket write functions on the host.
+* For each interface it reports the stream port writes per event, bytes per
+* write and the time per event.
+*
+* Built by the host CMake build twice, trcBenchmarkWriteCombine with a 256
+* byte write combine buffer and trcBenchmarkWriteCombineOff without one, run
+* as:
+*	trcBenchmarkWriteCombine [events per interface]
+*/
+
+#include <trcRecorder.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static double prvNow(void)
+{
+	struct timespec xTime;
+
+	(void)clock_gettime(CLOCK_MONOTONIC, &xTime);
+
+	return (double)xTime.tv_sec + (double)xTime.tv_nsec * 1e-9;
+}
+
+int main(int argc, char** argv)
+{
+	static const char* const szInterfaces[TRC_STREAM_PORT_SIMULATED_COUNT] = { "RTT", "ITM", "socket", "null" };
+	TraceStreamPortSimulatedStatistics_t xStatistics;
+	TraceStringHandle_t xChannel;
+	uint64_t ulBytes[TRC_STREAM_PORT_SIMULATED_COUNT];
+	uint32_t uiEvents = 1000000u;
+	uint32_t uiFailed = 0u;
+	uint32_t uiInterface;
+	uint32_t i;
+	double dStart, dEnd;
+	int iResult = 0;
+
+	if (argc > 1)
+	{
+		uiEvents = (uint32_t)strtoul(argv[1], (char**)0, 0);
+	}
+	if (uiEvents == 0u)
+	{
+		uiEvents = 1000000u;
+	}
+
+	(void)xTraceInitialize();
+	(void)xTraceEnable(TRC_START);
+	(void)xTraceStringRegister("bench", &xChannel);
+
+	printf("write combine size %u, events %u\n", (unsigned int)(TRC_WRITE_COMBINE_SIZE), (unsigned int)uiEvents);
+	printf("%-8s %14s %14s %10s\n", "", "writes/event", "bytes/write", "ns/event");
+
+	for (uiInterface = 0u; uiInterface < TRC_STREAM_PORT_SIMULATED_COUNT; uiInterface++)
+	{
+		/* Don't count what an earlier interface left buffered */
+		(void)xTraceWriteCombineFlush();
+		(void)xTraceStreamPortSimulatedSetInterface(uiInterface);
+
+		dStart = prvNow();
+
+		for (i = 0u; i < uiEvents; i++)
+		{
+			if (xTracePrint(xChannel, "event") == TRC_FAIL)
+			{
+				uiFailed++;
+			}
+		}
+		(void)xTraceWriteCombineFlush();
+
+		dEnd = prvNow();
+
+		(void)xTraceStreamPortSimulatedGetStatistics(&xStatistics);
+		ulBytes[uiInterface] = xStatistics.ulBytes;
+
+		printf("%-8s %14.4f %14.1f %10.1f\n", szInterfaces[uiInterface],
+			(double)xStatistics.ulWrites / (double)uiEvents,
+			(xStatistics.ulWrites > 0u) ? (double)xStatistics.ulBytes / (double)xStatistics.ulWrites : 0.0,
+			(dEnd - dStart) * 1e9 / (double)uiEvents);
+
+		/* The same events were stored each time, so the same bytes must have been written */
+		if ((ulBytes[uiInterface] == 0u) || (ulBytes[uiInterface] != ulBytes[0]))
+		{
+			iResult = 1;
+		}
+	}
+
+	(void)xTraceDisable();
+
+	if (uiFailed > 0u)
+	{
+		printf("events not stored: %u\n", (unsigned int)uiFailed);
+		iResult = 1;
+	}
+
+	return iResult;
+}
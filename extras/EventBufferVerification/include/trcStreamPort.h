@@ -0,0 +1,55 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * The interface definitions for trace streaming ("stream ports").
+ * This "stream port" is only for building trcEventBuffer.c into the event
+ * buffer stress harness and model-check harness, which implement
+ * xTraceStreamPortWriteData() themselves to check what the transfers write.
+ */
+
+#ifndef TRC_STREAM_PORT_H
+#define TRC_STREAM_PORT_H
+
+#if (TRC_USE_TRACEALYZER_RECORDER == 1)
+
+#if (TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)
+
+#include <stdint.h>
+#include <trcTypes.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TRC_USE_INTERNAL_BUFFER 0
+
+typedef struct TraceStreamPortBuffer	/* Aligned */
+{
+	TraceUnsignedBaseType_t buffer[1];
+} TraceStreamPortBuffer_t;
+
+/**
+ * @brief Called by the transfers. Implemented by the harness.
+ *
+ * @param[in] pvData Data to write
+ * @param[in] uiSize Data to write size
+ * @param[out] piBytesWritten Bytes written
+ *
+ * @retval TRC_FAIL Write failed
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortWriteData(void* pvData, uint32_t uiSize, int32_t* piBytesWritten);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*(TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)*/
+
+#endif /*(TRC_USE_TRACEALYZER_RECORDER == 1)*/
+
+#endif /* TRC_STREAM_PORT_H */
@@ -0,0 +1,425 @@
+/*
+* Percepio Trace Recorder for Tracealyzer v4.10.3
+* Copyright 2023 Percepio AB
+* www.percepio.com
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* Bounded model-check harness for TraceEventBuffer_t, for CBMC. A buffer of
+* PROOF_BUFFER_SIZE bytes gets PROOF_STEPS operations, each chosen
+* nondeterministically, in one of the four configurations: skip or overwrite
+* mode, filled with xTraceEventBufferAlloc/AllocCommit or with
+* xTraceEventBufferPush. Event sizes, transfers, chunk sizes and partial
+* stream port writes are nondeterministic too.
+*
+* In skip mode a consumer transfers the buffer, also between an allocation and
+* its commit, and what it writes must be exactly the events that were
+* accepted, in order, with nothing lost once drained. An empty buffer must
+* accept an event smaller than half of it. In overwrite mode, which has no
+* consumer, the buffer from tail to head must always hold whole events, the
+* newest ones, in order.
+*
+* The nondeterministic choices are random when it is built as a normal
+* program, as by the host CMake build, and it then checks random traces:
+*	trcEventBufferProof [traces] [seed]
+*/
+
+#include <trcRecorder.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef PROOF_BUFFER_SIZE
+#define PROOF_BUFFER_SIZE 64u
+#endif
+
+#ifndef PROOF_STEPS
+#define PROOF_STEPS 12u
+#endif
+
+/* Events have 0 to PROOF_MAX_PARAMETERS parameters */
+#define PROOF_MAX_PARAMETERS 2u
+#define PROOF_MAX_EVENT_SIZE (sizeof(TraceEvent0_t) + PROOF_MAX_PARAMETERS * sizeof(TraceUnsignedBaseType_t))
+
+/* Enough for every event of a trace, and for the drain at the end */
+#define PROOF_STREAM_SIZE ((PROOF_STEPS + 1u) * PROOF_MAX_EVENT_SIZE)
+
+#define PROOF_OPERATION_WRITE 0u
+#define PROOF_OPERATION_TRANSFER_ALL 1u
+#define PROOF_OPERATION_TRANSFER_CHUNK 2u
+#define PROOF_OPERATION_COUNT 3u
+
+#if (PROOF_BUFFER_SIZE % 4u) != 0u
+#error "PROOF_BUFFER_SIZE must be a multiple of 4"
+#endif
+
+/* Overwrite mode frees space event by event, and can't make room for an event
+ * larger than half the buffer. The recorder's buffers are far larger than its
+ * events. */
+typedef char ProofBufferHoldsTwoEvents_t[(PROOF_BUFFER_SIZE >= (2u * PROOF_MAX_EVENT_SIZE)) ? 1 : -1];
+
+#ifdef __CPROVER__
+
+uint32_t nondet_uint32(void);
+
+static uint32_t prvChoose(uint32_t uiMax)
+{
+	uint32_t uiValue = nondet_uint32();
+
+	__CPROVER_assume(uiValue <= uiMax);
+
+	return uiValue;
+}
+
+#define PROOF_ASSERT(__condition, __message) __CPROVER_assert(__condition, __message)
+
+#else
+
+static uint32_t uiRandom = 1u;
+static uint32_t uiFailures = 0u;
+
+static uint32_t prvChoose(uint32_t uiMax)
+{
+	/* xorshift32 */
+	uiRandom ^= uiRandom << 13;
+	uiRandom ^= uiRandom >> 17;
+	uiRandom ^= uiRandom << 5;
+
+	return uiRandom % (uiMax + 1u);
+}
+
+#define PROOF_ASSERT(__condition, __message) if (!(__condition)) { prvFail(__message); }
+
+#endif
+
+typedef struct ProofState
+{
+	uint32_t uiOption;					/* TRC_EVENT_BUFFER_OPTION_SKIP or _OVERWRITE */
+	uint32_t uiUseAlloc;				/* Alloc/AllocCommit, otherwise Push */
+	uint32_t uiPartialWrites;			/* The stream port may write less than asked */
+	uint32_t uiEvents;					/* Events accepted, also the next event's number */
+	uint32_t uiExpectedLength;			/* Bytes accepted, in skip mode */
+	uint32_t uiStreamLength;			/* Bytes transferred */
+	uint8_t auiExpected[PROOF_STREAM_SIZE];
+	uint8_t auiStream[PROOF_STREAM_SIZE];
+} ProofState_t;
+
+static TraceEventBuffer_t xEventBuffer;
+static uint8_t auiBuffer[PROOF_BUFFER_SIZE] __attribute__((aligned(8)));
+static ProofState_t xState;
+
+/* trcEventBuffer.c needs these from the rest of the recorder */
+uint32_t RecorderInitialized = 0u;
+static TraceTimestampData_t xTimestamp;
+TraceTimestampData_t* pxTraceTimestamp = &xTimestamp;
+
+#ifndef __CPROVER__
+static void prvFail(const char* szMessage)
+{
+	if (uiFailures < 10u)
+	{
+		printf("%s, %s: %s (head %u, tail %u, slack %u, events %u)\n",
+			(xState.uiOption == TRC_EVENT_BUFFER_OPTION_SKIP) ? "skip" : "overwrite",
+			(xState.uiUseAlloc != 0u) ? "alloc" : "push",
+			szMessage,
+			(unsigned int)xEventBuffer.uiHead, (unsigned int)xEventBuffer.uiTail,
+			(unsigned int)xEventBuffer.uiSlack, (unsigned int)xState.uiEvents);
+	}
+	uiFailures++;
+}
+#endif
+
+/* As TRC_EVENT_GET_SIZE() in trcEvent.c */
+traceResult xTraceEventGetSize(const void* const pvAddress, uint32_t* puiSize)
+{
+	*puiSize = (uint32_t)sizeof(TraceEvent0_t) + ((((const TraceEvent0_t*)pvAddress)->EventID >> 12u) & 0xFu) * (uint32_t)sizeof(TraceBaseType_t);
+
+	return TRC_SUCCESS;
+}
+
+static uint8_t prvEventByte(uint32_t uiEvent, uint32_t uiOffset)
+{
+	return (uint8_t)(uiEvent * 16u + uiOffset);
+}
+
+/* Event number uiEvent with uiParameters parameters, the payload is a pattern
+ * from the event number */
+static uint32_t prvBuildEvent(uint8_t* puiEvent, uint32_t uiEvent, uint32_t uiParameters)
+{
+	TraceEvent0_t xHeader;
+	uint32_t uiSize = (uint32_t)sizeof(TraceEvent0_t) + uiParameters * (uint32_t)sizeof(TraceUnsignedBaseType_t);
+	uint32_t i;
+
+	xHeader.EventID = (uint16_t)((uiParameters << 12) | (uiEvent & 0xFFFu));
+	xHeader.EventCount = (uint16_t)uiEvent;
+	xHeader.TS = uiEvent;
+	(void)memcpy(puiEvent, &xHeader, sizeof(xHeader));
+
+	for (i = (uint32_t)sizeof(TraceEvent0_t); i < uiSize; i++)
+	{
+		puiEvent[i] = prvEventByte(uiEvent, i);
+	}
+
+	return uiSize;
+}
+
+traceResult xTraceStreamPortWriteData(void* pvData, uint32_t uiSize, int32_t* piBytesWritten)
+{
+	const uint8_t* puiData = (const uint8_t*)pvData;
+	uint32_t uiWrite = uiSize;
+	uint32_t i;
+
+	PROOF_ASSERT((puiData >= auiBuffer) && ((puiData + uiSize) <= &auiBuffer[PROOF_BUFFER_SIZE]), "transfer outside the buffer");
+
+	if (xState.uiPartialWrites != 0u)
+	{
+		uiWrite = prvChoose(uiSize);
+	}
+
+	PROOF_ASSERT((xState.uiStreamLength + uiWrite) <= xState.uiExpectedLength, "transferred more than was accepted");
+
+	for (i = 0u; (i < uiWrite) && (xState.uiStreamLength < xState.uiExpectedLength); i++)
+	{
+		PROOF_ASSERT(puiData[i] == xState.auiExpected[xState.uiStreamLength], "transferred a byte that wasn't accepted there");
+		xState.auiStream[xState.uiStreamLength] = puiData[i];
+		xState.uiStreamLength++;
+	}
+
+	*piBytesWritten = (int32_t)uiWrite;
+
+	return TRC_SUCCESS;
+}
+
+static void prvTransfer(uint32_t uiOperation)
+{
+	int32_t iBytesWritten = 0;
+
+	if (uiOperation == PROOF_OPERATION_TRANSFER_ALL)
+	{
+		(void)xTraceEventBufferTransferAll(&xEventBuffer, &iBytesWritten);
+	}
+	else
+	{
+		(void)xTraceEventBufferTransferChunk(&xEventBuffer, 1u + prvChoose(PROOF_BUFFER_SIZE), &iBytesWritten);
+	}
+}
+
+static void prvWrite(void)
+{
+	uint8_t auiEvent[PROOF_MAX_EVENT_SIZE];
+	uint32_t uiUsed = 0u;
+	uint32_t uiSize;
+	uint32_t uiAccepted = 0u;
+	int32_t iBytesWritten = 0;
+	void* pvData = (void*)0;
+
+	uiSize = prvBuildEvent(auiEvent, xState.uiEvents, prvChoose(PROOF_MAX_PARAMETERS));
+
+	(void)xTraceEventBufferGetUsed(&xEventBuffer, &uiUsed);
+
+	if (xState.uiUseAlloc != 0u)
+	{
+		if ((xTraceEventBufferAlloc(&xEventBuffer, uiSize, &pvData) == TRC_SUCCESS) && (pvData != (void*)0))
+		{
+			PROOF_ASSERT(((uint8_t*)pvData >= auiBuffer) && (((uint8_t*)pvData + uiSize) <= &auiBuffer[PROOF_BUFFER_SIZE]), "allocated outside the buffer");
+
+			(void)memcpy(pvData, auiEvent, uiSize);
+
+			/* The consumer may run before the commit */
+			if ((xState.uiOption == TRC_EVENT_BUFFER_OPTION_SKIP) && (prvChoose(1u) != 0u))
+			{
+				prvTransfer(PROOF_OPERATION_TRANSFER_ALL + prvChoose(1u));
+			}
+
+			(void)xTraceEventBufferAllocCommit(&xEventBuffer, pvData, uiSize, &iBytesWritten);
+			uiAccepted = 1u;
+		}
+	}
+	else
+	{
+		(void)xTraceEventBufferPush(&xEventBuffer, auiEvent, uiSize, &iBytesWritten);
+		uiAccepted = ((uint32_t)iBytesWritten == uiSize) ? 1u : 0u;
+	}
+
+	if (xState.uiOption == TRC_EVENT_BUFFER_OPTION_SKIP)
+	{
+		PROOF_ASSERT((uiAccepted != 0u) || (uiUsed != 0u) || ((2u * uiSize) >= PROOF_BUFFER_SIZE), "an empty buffer refused a small event");
+	}
+	else
+	{
+		PROOF_ASSERT(uiAccepted != 0u, "overwrite mode refused an event");
+	}
+
+	if (uiAccepted != 0u)
+	{
+		if (xState.uiOption == TRC_EVENT_BUFFER_OPTION_SKIP)
+		{
+			(void)memcpy(&xState.auiExpected[xState.uiExpectedLength], auiEvent, uiSize);
+			xState.uiExpectedLength += uiSize;
+		}
+		xState.uiEvents++;
+	}
+}
+
+/* Overwrite mode: tail to head must be whole events, the newest ones, in order */
+static void prvCheckOverwrite(void)
+{
+	TraceEvent0_t xHeader;
+	uint8_t auiEvent[PROOF_MAX_EVENT_SIZE];
+	uint32_t uiPosition = xEventBuffer.uiTail;
+	uint32_t uiWrapped = (xEventBuffer.uiHead < xEventBuffer.uiTail) ? 0u : 1u;
+	uint32_t uiEvent = 0u;
+	uint32_t uiSize;
+	uint32_t uiCount = 0u;
+	uint32_t i;
+
+	PROOF_ASSERT((xEventBuffer.uiHead < PROOF_BUFFER_SIZE) && (xEventBuffer.uiTail < PROOF_BUFFER_SIZE), "head or tail outside the buffer");
+
+	while ((uiPosition != xEventBuffer.uiHead) && (uiCount <= PROOF_STEPS))
+	{
+		/* The allocations leave the slack at the end unused */
+		if ((xState.uiUseAlloc != 0u) && (uiWrapped == 0u) && (uiPosition >= (PROOF_BUFFER_SIZE - xEventBuffer.uiSlack)))
+		{
+			uiPosition = 0u;
+			uiWrapped = 1u;
+			continue;
+		}
+
+		/* The pushes wrap events around the end */
+		for (i = 0u; i < (uint32_t)sizeof(TraceEvent0_t); i++)
+		{
+			auiEvent[i] = auiBuffer[(uiPosition + i) % PROOF_BUFFER_SIZE];
+		}
+		(void)xTraceEventGetSize(auiEvent, &uiSize);
+		PROOF_ASSERT(uiSize <= PROOF_MAX_EVENT_SIZE, "not an event");
+		if (uiSize > PROOF_MAX_EVENT_SIZE)
+		{
+			return;
+		}
+		for (i = (uint32_t)sizeof(TraceEvent0_t); i < uiSize; i++)
+		{
+			auiEvent[i] = auiBuffer[(uiPosition + i) % PROOF_BUFFER_SIZE];
+		}
+		(void)memcpy(&xHeader, auiEvent, sizeof(xHeader));
+
+		if (uiCount == 0u)
+		{
+			uiEvent = xHeader.EventCount;
+		}
+		PROOF_ASSERT(xHeader.EventCount == (uint16_t)uiEvent, "events out of order");
+		for (i = (uint32_t)sizeof(TraceEvent0_t); i < uiSize; i++)
+		{
+			PROOF_ASSERT(auiEvent[i] == prvEventByte(uiEvent, i), "event payload overwritten");
+		}
+
+		if ((uiPosition + uiSize) >= PROOF_BUFFER_SIZE)
+		{
+			uiWrapped = 1u;
+		}
+		uiPosition = (uiPosition + uiSize) % PROOF_BUFFER_SIZE;
+		uiEvent++;
+		uiCount++;
+	}
+
+	PROOF_ASSERT(uiPosition == xEventBuffer.uiHead, "tail to head isn't whole events");
+	PROOF_ASSERT((xState.uiEvents == 0u) || ((uiCount > 0u) && (uiEvent == xState.uiEvents)), "the newest event is missing");
+}
+
+static void prvProof(uint32_t uiOption, uint32_t uiUseAlloc)
+{
+	uint32_t uiStep;
+	uint32_t uiOperation;
+
+	(void)memset(&xState, 0, sizeof(xState));
+	(void)memset(auiBuffer, 0, sizeof(auiBuffer));
+
+	xState.uiOption = uiOption;
+	xState.uiUseAlloc = uiUseAlloc;
+	xState.uiPartialWrites = 1u;
+
+	(void)xTraceEventBufferInitialize(&xEventBuffer, uiOption, auiBuffer, PROOF_BUFFER_SIZE);
+
+	for (uiStep = 0u; uiStep < PROOF_STEPS; uiStep++)
+	{
+		uiOperation = PROOF_OPERATION_WRITE;
+		if (uiOption == TRC_EVENT_BUFFER_OPTION_SKIP)
+		{
+			uiOperation = prvChoose(PROOF_OPERATION_COUNT - 1u);
+		}
+
+		if (uiOperation == PROOF_OPERATION_WRITE)
+		{
+			prvWrite();
+		}
+		else
+		{
+			prvTransfer(uiOperation);
+		}
+
+		if (uiOption == TRC_EVENT_BUFFER_OPTION_OVERWRITE)
+		{
+			prvCheckOverwrite();
+		}
+	}
+
+	if (uiOption == TRC_EVENT_BUFFER_OPTION_SKIP)
+	{
+		/* With whole writes, one transfer drains the buffer */
+		xState.uiPartialWrites = 0u;
+		prvTransfer(PROOF_OPERATION_TRANSFER_ALL);
+
+		PROOF_ASSERT(xEventBuffer.uiHead == xEventBuffer.uiTail, "not drained");
+		PROOF_ASSERT(xState.uiStreamLength == xState.uiExpectedLength, "accepted events were lost");
+	}
+}
+
+#ifdef __CPROVER__
+
+int main(void)
+{
+	prvProof(prvChoose(1u), prvChoose(1u));
+
+	return 0;
+}
+
+#else
+
+int main(int argc, char** argv)
+{
+	uint32_t uiTraces = 100000u;
+	uint32_t uiOption;
+	uint32_t uiUseAlloc;
+	uint32_t i;
+
+	if (argc > 1)
+	{
+		uiTraces = (uint32_t)strtoul(argv[1], (char**)0, 0);
+	}
+	if (argc > 2)
+	{
+		uiRandom = (uint32_t)strtoul(argv[2], (char**)0, 0);
+	}
+	if (uiRandom == 0u)
+	{
+		uiRandom = 1u;
+	}
+
+	printf("%u byte buffer, %u steps, %u traces per configuration\n", (unsigned int)PROOF_BUFFER_SIZE, (unsigned int)PROOF_STEPS, (unsigned int)uiTraces);
+
+	for (uiOption = TRC_EVENT_BUFFER_OPTION_SKIP; uiOption <= TRC_EVENT_BUFFER_OPTION_OVERWRITE; uiOption++)
+	{
+		for (uiUseAlloc = 0u; uiUseAlloc <= 1u; uiUseAlloc++)
+		{
+			for (i = 0u; i < uiTraces; i++)
+			{
+				prvProof(uiOption, uiUseAlloc);
+			}
+		}
+	}
+
+	printf("failures %u\n", (unsigned int)uiFailures);
+
+	return (uiFailures > 0u) ? 1 : 0;
+}
+
+#endif
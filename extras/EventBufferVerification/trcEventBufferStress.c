@@ -0,0 +1,464 @@
+/*
+* Percepio Trace Recorder for Tracealyzer v4.10.3
+* Copyright 2023 Percepio AB
+* www.percepio.com
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* Stress harness for TraceEventBuffer_t in skip mode, where a consumer
+* transfers the buffer while producers store events. As in the recorder, the
+* producers are serialized by a lock standing in for the critical section and
+* the consumer doesn't take it. Events have random sizes and carry their
+* producer, a per-producer sequence number and a checksum, and every byte the
+* consumer transfers is checked. sched_yield() is injected inside the
+* producers' allocations and inside the consumer's stream port writes, where
+* head and tail have been read but not yet moved, and the stream port writes
+* may be partial.
+*
+* Built by the host CMake build, run as:
+*	trcEventBufferStress [seconds] [producers] [alloc|push] [all|chunk] [buffer size] [seed]
+*/
+
+#include <trcRecorder.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define STRESS_MAX_PRODUCERS 16u
+
+/* Event layout: marker, producer, 16-bit size, sequence number, payload, checksum */
+#define STRESS_EVENT_MARKER 0xA5u
+#define STRESS_EVENT_MIN_SIZE 12u
+#define STRESS_EVENT_MAX_SIZE 64u
+
+/* Chance in percent of sched_yield() at each injection point */
+#define STRESS_YIELD_PERCENT 5u
+
+/* Chance in percent that a stream port write is partial */
+#define STRESS_PARTIAL_WRITE_PERCENT 10u
+
+#define STRESS_MAX_REPORTED_ERRORS 10u
+
+typedef struct StressProducer
+{
+	pthread_t xThread;
+	uint32_t uiId;
+	uint32_t uiRandom;
+	uint32_t uiSequence;		/* Events stored */
+	uint64_t ulBytes;
+	uint64_t ulDropped;
+} StressProducer_t;
+
+typedef struct StressConsumer
+{
+	uint32_t uiRandom;
+	uint32_t uiPending;			/* Bytes of an incomplete event in auiEvent */
+	uint8_t auiEvent[STRESS_EVENT_MAX_SIZE];
+	uint32_t auiExpected[STRESS_MAX_PRODUCERS];	/* Next sequence number per producer */
+	uint64_t ulBytes;
+	uint64_t ulEvents;
+	uint64_t ulTransfers;
+	uint64_t ulPartialWrites;
+	uint32_t uiErrors;
+} StressConsumer_t;
+
+static TraceEventBuffer_t xEventBuffer;
+static uint8_t* puiEventBufferData = (void*)0;
+
+static pthread_mutex_t xCriticalSection = PTHREAD_MUTEX_INITIALIZER;
+
+static StressProducer_t axProducers[STRESS_MAX_PRODUCERS];
+static StressConsumer_t xConsumer;
+
+static uint32_t uiProducers = 3u;
+static uint32_t uiUseAlloc = 1u;
+static uint32_t uiUseChunk = 0u;
+static volatile uint32_t uiStop = 0u;
+
+/* trcEventBuffer.c needs these from the rest of the recorder */
+uint32_t RecorderInitialized = 0u;
+static TraceTimestampData_t xTimestamp;
+TraceTimestampData_t* pxTraceTimestamp = &xTimestamp;
+
+/* Skip mode never pops, but the overwrite code refers to it */
+traceResult xTraceEventGetSize(const void* const pvAddress, uint32_t* puiSize)
+{
+	(void)pvAddress;
+
+	*puiSize = 0u;
+
+	return TRC_FAIL;
+}
+
+static uint32_t prvRandom(uint32_t* puiState)
+{
+	/* xorshift32 */
+	*puiState ^= *puiState << 13;
+	*puiState ^= *puiState >> 17;
+	*puiState ^= *puiState << 5;
+
+	return *puiState;
+}
+
+static void prvMaybeYield(uint32_t* puiState)
+{
+	if ((prvRandom(puiState) % 100u) < STRESS_YIELD_PERCENT)
+	{
+		(void)sched_yield();
+	}
+}
+
+static uint32_t prvChecksum(const uint8_t* puiData, uint32_t uiSize)
+{
+	uint32_t uiHash = 2166136261u;
+	uint32_t i;
+
+	/* FNV-1a */
+	for (i = 0u; i < uiSize; i++)
+	{
+		uiHash = (uiHash ^ puiData[i]) * 16777619u;
+	}
+
+	return uiHash;
+}
+
+static uint8_t prvPayloadByte(uint32_t uiProducer, uint32_t uiSequence, uint32_t uiOffset)
+{
+	return (uint8_t)(uiSequence * 31u + uiProducer * 7u + uiOffset);
+}
+
+static void prvBuildEvent(uint8_t* puiEvent, uint32_t uiSize, uint32_t uiProducer, uint32_t uiSequence)
+{
+	uint32_t uiChecksum;
+	uint32_t i;
+
+	puiEvent[0] = STRESS_EVENT_MARKER;
+	puiEvent[1] = (uint8_t)uiProducer;
+	puiEvent[2] = (uint8_t)uiSize;
+	puiEvent[3] = (uint8_t)(uiSize >> 8);
+	(void)memcpy(&puiEvent[4], &uiSequence, sizeof(uiSequence));
+	for (i = 8u; i < uiSize - 4u; i++)
+	{
+		puiEvent[i] = prvPayloadByte(uiProducer, uiSequence, i);
+	}
+	uiChecksum = prvChecksum(puiEvent, uiSize - 4u);
+	(void)memcpy(&puiEvent[uiSize - 4u], &uiChecksum, sizeof(uiChecksum));
+}
+
+static void prvError(const char* szMessage, uint32_t uiValue)
+{
+	if (xConsumer.uiErrors < STRESS_MAX_REPORTED_ERRORS)
+	{
+		printf("error at stream byte %llu: %s (%u)\n", (unsigned long long)xConsumer.ulBytes, szMessage, (unsigned int)uiValue);
+	}
+	xConsumer.uiErrors++;
+}
+
+static void prvCheckEvent(const uint8_t* puiEvent, uint32_t uiSize)
+{
+	uint32_t uiProducer = ((uint32_t)puiEvent[1]);
+	uint32_t uiSequence;
+	uint32_t uiChecksum;
+	uint32_t i;
+
+	(void)memcpy(&uiSequence, &puiEvent[4], sizeof(uiSequence));
+	(void)memcpy(&uiChecksum, &puiEvent[uiSize - 4u], sizeof(uiChecksum));
+
+	if (uiChecksum != prvChecksum(puiEvent, uiSize - 4u))
+	{
+		prvError("bad checksum", uiChecksum);
+	}
+
+	for (i = 8u; i < uiSize - 4u; i++)
+	{
+		if (puiEvent[i] != prvPayloadByte(uiProducer, uiSequence, i))
+		{
+			prvError("bad payload byte", i);
+			break;
+		}
+	}
+
+	if (uiSequence != xConsumer.auiExpected[uiProducer])
+	{
+		prvError("out of sequence", uiSequence);
+	}
+	xConsumer.auiExpected[uiProducer] = uiSequence + 1u;
+
+	xConsumer.ulEvents++;
+}
+
+/* Splits what the transfers write into events and checks each one */
+static void prvConsume(const uint8_t* puiData, uint32_t uiSize)
+{
+	uint32_t uiEventSize;
+	uint32_t uiCopy;
+
+	while (uiSize > 0u)
+	{
+		/* Header first, then the rest of the event */
+		uiEventSize = 4u;
+		if (xConsumer.uiPending >= 4u)
+		{
+			uiEventSize = ((uint32_t)xConsumer.auiEvent[2]) | ((uint32_t)xConsumer.auiEvent[3] << 8);
+		}
+
+		uiCopy = uiEventSize - xConsumer.uiPending;
+		if (uiCopy > uiSize)
+		{
+			uiCopy = uiSize;
+		}
+
+		(void)memcpy(&xConsumer.auiEvent[xConsumer.uiPending], puiData, uiCopy);
+		xConsumer.uiPending += uiCopy;
+		xConsumer.ulBytes += uiCopy;
+		puiData += uiCopy;
+		uiSize -= uiCopy;
+
+		if (xConsumer.uiPending == 4u)
+		{
+			uiEventSize = ((uint32_t)xConsumer.auiEvent[2]) | ((uint32_t)xConsumer.auiEvent[3] << 8);
+
+			if ((xConsumer.auiEvent[0] != STRESS_EVENT_MARKER) || ((uint32_t)xConsumer.auiEvent[1] >= uiProducers) ||
+				(uiEventSize < STRESS_EVENT_MIN_SIZE) || (uiEventSize > STRESS_EVENT_MAX_SIZE) || ((uiEventSize % 4u) != 0u))
+			{
+				/* Lost the event boundaries, resynchronize one byte later */
+				prvError("bad header", uiEventSize);
+				(void)memmove(xConsumer.auiEvent, &xConsumer.auiEvent[1], 3u);
+				xConsumer.uiPending = 3u;
+			}
+		}
+		else if ((xConsumer.uiPending > 4u) && (xConsumer.uiPending == uiEventSize))
+		{
+			prvCheckEvent(xConsumer.auiEvent, uiEventSize);
+			xConsumer.uiPending = 0u;
+		}
+	}
+}
+
+traceResult xTraceStreamPortWriteData(void* pvData, uint32_t uiSize, int32_t* piBytesWritten)
+{
+	uint32_t uiWrite = uiSize;
+
+	/* The transfer has read head and tail, but not yet moved the tail */
+	prvMaybeYield(&xConsumer.uiRandom);
+
+	if ((uiSize > 0u) && ((prvRandom(&xConsumer.uiRandom) % 100u) < STRESS_PARTIAL_WRITE_PERCENT))
+	{
+		uiWrite = prvRandom(&xConsumer.uiRandom) % uiSize;
+		xConsumer.ulPartialWrites++;
+	}
+
+	prvConsume((const uint8_t*)pvData, uiWrite);
+
+	prvMaybeYield(&xConsumer.uiRandom);
+
+	*piBytesWritten = (int32_t)uiWrite;
+
+	return TRC_SUCCESS;
+}
+
+static void* prvProducer(void* pvParameter)
+{
+	StressProducer_t* pxProducer = (StressProducer_t*)pvParameter;
+	uint8_t auiEvent[STRESS_EVENT_MAX_SIZE];
+	void* pvData;
+	int32_t iBytesWritten;
+	uint32_t uiSize;
+	uint32_t uiSplit;
+
+	while (uiStop == 0u)
+	{
+		uiSize = STRESS_EVENT_MIN_SIZE + 4u * (prvRandom(&pxProducer->uiRandom) % (((STRESS_EVENT_MAX_SIZE - STRESS_EVENT_MIN_SIZE) / 4u) + 1u));
+		prvBuildEvent(auiEvent, uiSize, pxProducer->uiId, pxProducer->uiSequence);
+		iBytesWritten = 0;
+
+		(void)pthread_mutex_lock(&xCriticalSection);
+
+		if (uiUseAlloc != 0u)
+		{
+			pvData = (void*)0;
+			if (xTraceEventBufferAlloc(&xEventBuffer, uiSize, &pvData) == TRC_SUCCESS)
+			{
+				/* Filled in two parts, to be preempted in between */
+				uiSplit = 4u * (prvRandom(&pxProducer->uiRandom) % ((uiSize / 4u) + 1u));
+				(void)memcpy(pvData, auiEvent, uiSplit);
+				prvMaybeYield(&pxProducer->uiRandom);
+				(void)memcpy(&((uint8_t*)pvData)[uiSplit], &auiEvent[uiSplit], uiSize - uiSplit);
+				prvMaybeYield(&pxProducer->uiRandom);
+
+				(void)xTraceEventBufferAllocCommit(&xEventBuffer, pvData, uiSize, &iBytesWritten);
+			}
+		}
+		else
+		{
+			(void)xTraceEventBufferPush(&xEventBuffer, auiEvent, uiSize, &iBytesWritten);
+		}
+
+		(void)pthread_mutex_unlock(&xCriticalSection);
+
+		if ((uint32_t)iBytesWritten == uiSize)
+		{
+			pxProducer->uiSequence++;
+			pxProducer->ulBytes += uiSize;
+		}
+		else
+		{
+			pxProducer->ulDropped++;
+		}
+
+		prvMaybeYield(&pxProducer->uiRandom);
+	}
+
+	return (void*)0;
+}
+
+static void* prvConsumer(void* pvParameter)
+{
+	int32_t iBytesWritten;
+	uint32_t uiUsed = 0u;
+
+	(void)pvParameter;
+
+	for (;;)
+	{
+		iBytesWritten = 0;
+
+		if (uiUseChunk != 0u)
+		{
+			(void)xTraceEventBufferTransferChunk(&xEventBuffer, 4u + (prvRandom(&xConsumer.uiRandom) % 512u), &iBytesWritten);
+		}
+		else
+		{
+			(void)xTraceEventBufferTransferAll(&xEventBuffer, &iBytesWritten);
+		}
+		xConsumer.ulTransfers++;
+
+		if (iBytesWritten == 0)
+		{
+			/* The producers have stopped, done once all is transferred */
+			(void)xTraceEventBufferGetUsed(&xEventBuffer, &uiUsed);
+			if ((uiStop == 2u) && (uiUsed == 0u))
+			{
+				break;
+			}
+
+			(void)sched_yield();
+		}
+	}
+
+	return (void*)0;
+}
+
+int main(int argc, char** argv)
+{
+	pthread_t xConsumerThread;
+	uint64_t ulProduced = 0u;
+	uint64_t ulDropped = 0u;
+	uint32_t uiSeconds = 5u;
+	uint32_t uiBufferSize = 1024u;
+	uint32_t uiSeed = (uint32_t)time((time_t*)0);
+	uint32_t i;
+
+	if (argc > 1)
+	{
+		uiSeconds = (uint32_t)strtoul(argv[1], (char**)0, 0);
+	}
+	if (argc > 2)
+	{
+		uiProducers = (uint32_t)strtoul(argv[2], (char**)0, 0);
+	}
+	if (argc > 3)
+	{
+		uiUseAlloc = (strcmp(argv[3], "push") != 0) ? 1u : 0u;
+	}
+	if (argc > 4)
+	{
+		uiUseChunk = (strcmp(argv[4], "chunk") == 0) ? 1u : 0u;
+	}
+	if (argc > 5)
+	{
+		uiBufferSize = (uint32_t)strtoul(argv[5], (char**)0, 0);
+	}
+	if (argc > 6)
+	{
+		uiSeed = (uint32_t)strtoul(argv[6], (char**)0, 0);
+	}
+	if ((uiProducers == 0u) || (uiProducers > STRESS_MAX_PRODUCERS))
+	{
+		uiProducers = 3u;
+	}
+	if ((uiBufferSize < (2u * STRESS_EVENT_MAX_SIZE)) || ((uiBufferSize % 4u) != 0u))
+	{
+		uiBufferSize = 1024u;
+	}
+	if (uiSeed == 0u)
+	{
+		uiSeed = 1u;
+	}
+
+	printf("%s, transfer %s, %u producers, %u byte buffer, %u s, seed %u\n",
+		(uiUseAlloc != 0u) ? "alloc" : "push", (uiUseChunk != 0u) ? "chunk" : "all",
+		(unsigned int)uiProducers, (unsigned int)uiBufferSize, (unsigned int)uiSeconds, (unsigned int)uiSeed);
+
+	puiEventBufferData = (uint8_t*)malloc(uiBufferSize);
+	if (puiEventBufferData == (void*)0)
+	{
+		return 1;
+	}
+
+	(void)xTraceEventBufferInitialize(&xEventBuffer, TRC_EVENT_BUFFER_OPTION_SKIP, puiEventBufferData, uiBufferSize);
+
+	xConsumer.uiRandom = uiSeed;
+	(void)pthread_create(&xConsumerThread, (const pthread_attr_t*)0, prvConsumer, (void*)0);
+
+	for (i = 0u; i < uiProducers; i++)
+	{
+		axProducers[i].uiId = i;
+		axProducers[i].uiRandom = uiSeed + 0x9E3779B9u * (i + 1u);
+		(void)pthread_create(&axProducers[i].xThread, (const pthread_attr_t*)0, prvProducer, &axProducers[i]);
+	}
+
+	(void)sleep(uiSeconds);
+
+	uiStop = 1u;
+	for (i = 0u; i < uiProducers; i++)
+	{
+		(void)pthread_join(axProducers[i].xThread, (void**)0);
+	}
+
+	/* Let the consumer drain the buffer */
+	uiStop = 2u;
+	(void)pthread_join(xConsumerThread, (void**)0);
+
+	for (i = 0u; i < uiProducers; i++)
+	{
+		ulProduced += axProducers[i].ulBytes;
+		ulDropped += axProducers[i].ulDropped;
+
+		if (xConsumer.auiExpected[i] != axProducers[i].uiSequence)
+		{
+			printf("producer %u: stored %u events, transferred %u\n", (unsigned int)i,
+				(unsigned int)axProducers[i].uiSequence, (unsigned int)xConsumer.auiExpected[i]);
+			xConsumer.uiErrors++;
+		}
+	}
+
+	if ((xConsumer.uiPending != 0u) || (xConsumer.ulBytes != ulProduced))
+	{
+		printf("stored %llu bytes, transferred %llu, %u left in an incomplete event\n",
+			(unsigned long long)ulProduced, (unsigned long long)xConsumer.ulBytes, (unsigned int)xConsumer.uiPending);
+		xConsumer.uiErrors++;
+	}
+
+	printf("events %llu, bytes %llu, dropped %llu, transfers %llu, partial writes %llu, errors %u\n",
+		(unsigned long long)xConsumer.ulEvents, (unsigned long long)xConsumer.ulBytes, (unsigned long long)ulDropped,
+		(unsigned long long)xConsumer.ulTransfers, (unsigned long long)xConsumer.ulPartialWrites, (unsigned int)xConsumer.uiErrors);
+
+	free(puiEventBufferData);
+
+	return (xConsumer.uiErrors > 0u) ? 1 : 0;
+}
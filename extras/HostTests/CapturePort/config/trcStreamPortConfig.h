@@ -0,0 +1,75 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * The configuration of the capture stream port used by the host tests. Every
+ * setting can be given on the command line, so that the host CMake build can
+ * make variants with and without the internal buffer.
+ */
+
+#ifndef TRC_STREAM_PORT_CONFIG_H
+#define TRC_STREAM_PORT_CONFIG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @def TRC_CFG_STREAM_PORT_CAPTURE_SIZE
+ *
+ * @brief The most bytes captured, anything after that is refused.
+ */
+#ifndef TRC_CFG_STREAM_PORT_CAPTURE_SIZE
+#define TRC_CFG_STREAM_PORT_CAPTURE_SIZE (16 * 1024 * 1024)
+#endif
+
+#ifndef TRC_CFG_STREAM_PORT_USE_INTERNAL_BUFFER
+#define TRC_CFG_STREAM_PORT_USE_INTERNAL_BUFFER 0
+#endif
+
+#ifndef TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_SIZE
+#define TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_SIZE 4096
+#endif
+
+#ifndef TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_WRITE_MODE
+#define TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_WRITE_MODE TRC_INTERNAL_EVENT_BUFFER_OPTION_WRITE_MODE_DIRECT
+#endif
+
+#ifndef TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_TRANSFER_MODE
+#define TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_TRANSFER_MODE TRC_INTERNAL_EVENT_BUFFER_OPTION_TRANSFER_MODE_ALL
+#endif
+
+#ifndef TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_SIZE
+#define TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_SIZE 256
+#endif
+
+#ifndef TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_SIZE_LIMIT
+#define TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_SIZE_LIMIT 128
+#endif
+
+#ifndef TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT
+#define TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT 2
+#endif
+
+/**
+ * @def TRC_CFG_STREAM_PORT_WRITE_COMBINE_SIZE
+ *
+ * @brief Only used when the internal buffer isn't. If larger than 0, the
+ * events are combined in a buffer of this size per core (trcWriteCombine.c).
+ */
+#ifndef TRC_CFG_STREAM_PORT_WRITE_COMBINE_SIZE
+#define TRC_CFG_STREAM_PORT_WRITE_COMBINE_SIZE 0
+#endif
+
+#ifndef TRC_CFG_STREAM_PORT_WRITE_COMBINE_FLUSH_PERIOD
+#define TRC_CFG_STREAM_PORT_WRITE_COMBINE_FLUSH_PERIOD 1000
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRC_STREAM_PORT_CONFIG_H */
@@ -0,0 +1,192 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * The interface definitions for trace streaming ("stream ports").
+ * This "stream port" is used by the host tests. It keeps everything written
+ * in memory, where the test decodes it, and it can be told to be busy, i.e.,
+ * to write nothing, and be given commands, as if they came from the host.
+ */
+
+#ifndef TRC_STREAM_PORT_H
+#define TRC_STREAM_PORT_H
+
+#if (TRC_USE_TRACEALYZER_RECORDER == 1)
+
+#if (TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)
+
+#include <stdint.h>
+#include <trcTypes.h>
+#include <trcStreamPortConfig.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TRC_ALIGNED_STREAM_PORT_BUFFER_SIZE ((((TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_SIZE) + sizeof(TraceUnsignedBaseType_t) - 1) / sizeof(TraceUnsignedBaseType_t)) * sizeof(TraceUnsignedBaseType_t))
+
+#define TRC_USE_INTERNAL_BUFFER (TRC_CFG_STREAM_PORT_USE_INTERNAL_BUFFER)
+
+#define TRC_INTERNAL_EVENT_BUFFER_WRITE_MODE (TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_WRITE_MODE)
+
+#define TRC_INTERNAL_EVENT_BUFFER_TRANSFER_MODE (TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_TRANSFER_MODE)
+
+#define TRC_INTERNAL_BUFFER_CHUNK_SIZE (TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_SIZE)
+
+#define TRC_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_SIZE_LIMIT (TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_SIZE_LIMIT)
+
+#define TRC_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT (TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT)
+
+#define TRC_WRITE_COMBINE_SIZE (TRC_CFG_STREAM_PORT_WRITE_COMBINE_SIZE)
+
+#define TRC_WRITE_COMBINE_FLUSH_PERIOD (TRC_CFG_STREAM_PORT_WRITE_COMBINE_FLUSH_PERIOD)
+
+#define TRC_STREAM_PORT_CAPTURE_COMMANDS 8u
+
+/* The most bytes written per write, see xTraceStreamPortCaptureSetWriteLimit() */
+#define TRC_STREAM_PORT_CAPTURE_UNLIMITED 0xFFFFFFFFu
+
+typedef struct TraceStreamPortBuffer	/* Aligned */
+{
+#if (TRC_USE_INTERNAL_BUFFER == 1)
+	uint8_t buffer[TRC_ALIGNED_STREAM_PORT_BUFFER_SIZE];
+#endif
+	TraceUnsignedBaseType_t uxReserved;
+} TraceStreamPortBuffer_t;
+
+/**
+ * @internal Stream port initialize callback. Clears the capture.
+ *
+ * @param[in] pxBuffer Buffer
+ *
+ * @retval TRC_FAIL Initialization failed
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortInitialize(TraceStreamPortBuffer_t* pxBuffer);
+
+/**
+ * @brief Gets what has been written so far.
+ *
+ * @param[out] ppuiData Data
+ * @param[out] puiSize Data size
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortCaptureGet(const uint8_t** ppuiData, uint32_t* puiSize);
+
+/**
+ * @brief Discards what has been written so far.
+ *
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortCaptureClear(void);
+
+/**
+ * @brief Sets the most bytes each write writes, TRC_STREAM_PORT_CAPTURE_UNLIMITED
+ * for all. 0 makes the stream port busy: writes succeed but write nothing.
+ *
+ * @param[in] uiLimit Limit
+ *
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortCaptureSetWriteLimit(uint32_t uiLimit);
+
+/**
+ * @brief Queues a command, read by the recorder as if it came from the host.
+ *
+ * @param[in] pvCommand Command, a TraceCommand_t
+ * @param[in] uiSize Command size
+ *
+ * @retval TRC_FAIL The queue is full
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortCaptureSendCommand(const void* pvCommand, uint32_t uiSize);
+
+/**
+ * @brief Allocates data from the stream port.
+ * 
+ * @param[in] uiSize Allocation size
+ * @param[out] ppvData Allocation data pointer
+ * 
+ * @retval TRC_FAIL Allocate failed
+ * @retval TRC_SUCCESS Success
+ */
+#if (TRC_USE_INTERNAL_BUFFER == 1)
+	#if (TRC_INTERNAL_EVENT_BUFFER_WRITE_MODE == TRC_INTERNAL_EVENT_BUFFER_OPTION_WRITE_MODE_COPY)
+		#define xTraceStreamPortAllocate(uiSize, ppvData) ((void)(uiSize), xTraceStaticBufferGet(ppvData))
+	#else
+		#define xTraceStreamPortAllocate(uiSize, ppvData) ((void)(uiSize), xTraceInternalEventBufferAlloc(uiSize, ppvData))
+	#endif
+#elif ((TRC_WRITE_COMBINE_SIZE) > 0)
+	#define xTraceStreamPortAllocate xTraceWriteCombineAlloc
+#else
+	#define xTraceStreamPortAllocate(uiSize, ppvData) ((void)(uiSize), xTraceStaticBufferGet(ppvData))
+#endif
+
+/**
+ * @brief Commits data to the stream port.
+ * 
+ * @param[in] pvData Data to commit
+ * @param[in] uiSize Data to commit size
+ * @param[out] piBytesCommitted Bytes committed
+ * 
+ * @retval TRC_FAIL Commit failed
+ * @retval TRC_SUCCESS Success
+ */
+#if (TRC_USE_INTERNAL_BUFFER == 1)
+	#if (TRC_INTERNAL_EVENT_BUFFER_WRITE_MODE == TRC_INTERNAL_EVENT_BUFFER_OPTION_WRITE_MODE_COPY)
+		#define xTraceStreamPortCommit xTraceInternalEventBufferPush
+	#else
+		#define xTraceStreamPortCommit xTraceInternalEventBufferAllocCommit
+	#endif
+#elif ((TRC_WRITE_COMBINE_SIZE) > 0)
+	#define xTraceStreamPortCommit xTraceWriteCombineCommit
+#else
+	#define xTraceStreamPortCommit xTraceStreamPortWriteData
+#endif
+
+/**
+ * @brief Writes data to the capture, up to the write limit.
+ *
+ * @param[in] pvData Data to write
+ * @param[in] uiSize Data to write size
+ * @param[out] piBytesWritten Bytes written
+ *
+ * @retval TRC_FAIL The capture is full
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortWriteData(void* pvData, uint32_t uiSize, int32_t* piBytesWritten);
+
+/**
+ * @brief Reads the next queued command.
+ *
+ * @param[in] pvData Destination data buffer
+ * @param[in] uiSize Destination data buffer size
+ * @param[out] piBytesRead Bytes read
+ *
+ * @retval TRC_FAIL Read failed
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortReadData(void* pvData, uint32_t uiSize, int32_t* piBytesRead);
+
+#define xTraceStreamPortOnEnable(uiStartOption) ((void)(uiStartOption), TRC_SUCCESS)
+
+#define xTraceStreamPortOnDisable() (TRC_SUCCESS)
+
+#define xTraceStreamPortOnTraceBegin() (TRC_SUCCESS)
+
+#define xTraceStreamPortOnTraceEnd() (TRC_SUCCESS)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*(TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)*/
+
+#endif /*(TRC_USE_TRACEALYZER_RECORDER == 1)*/
+
+#endif /* TRC_STREAM_PORT_H */
@@ -0,0 +1,154 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Supporting functions for the capture stream port used by the host tests.
+ * The capture and the command queue are shared with the test's own threads,
+ * so they are guarded by a mutex.
+ */
+
+#include <trcRecorder.h>
+
+#if (TRC_USE_TRACEALYZER_RECORDER == 1)
+
+#if (TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)
+
+#include <pthread.h>
+#include <string.h>
+
+#define TRC_STREAM_PORT_CAPTURE_COMMAND_SIZE 8u
+
+typedef struct TraceStreamPortCapture
+{
+	uint32_t uiSize;
+	uint32_t uiWriteLimit;
+	uint32_t uiCommandHead;
+	uint32_t uiCommandCount;
+	uint8_t auiCommands[TRC_STREAM_PORT_CAPTURE_COMMANDS][TRC_STREAM_PORT_CAPTURE_COMMAND_SIZE];
+	uint8_t auiData[TRC_CFG_STREAM_PORT_CAPTURE_SIZE];
+} TraceStreamPortCapture_t;
+
+static TraceStreamPortCapture_t xCapture = { 0u, TRC_STREAM_PORT_CAPTURE_UNLIMITED, 0u, 0u, { { 0u } }, { 0u } };
+
+static pthread_mutex_t xCaptureMutex = PTHREAD_MUTEX_INITIALIZER;
+
+traceResult xTraceStreamPortInitialize(TraceStreamPortBuffer_t* pxBuffer)
+{
+	if (pxBuffer == 0)
+	{
+		return TRC_FAIL;
+	}
+
+#if (TRC_USE_INTERNAL_BUFFER == 1)
+	if (xTraceInternalEventBufferInitialize(pxBuffer->buffer, sizeof(pxBuffer->buffer)) == TRC_FAIL)
+	{
+		return TRC_FAIL;
+	}
+#endif
+
+	return xTraceStreamPortCaptureClear();
+}
+
+traceResult xTraceStreamPortCaptureGet(const uint8_t** ppuiData, uint32_t* puiSize)
+{
+	if ((ppuiData == 0) || (puiSize == 0))
+	{
+		return TRC_FAIL;
+	}
+
+	(void)pthread_mutex_lock(&xCaptureMutex);
+	*ppuiData = xCapture.auiData;
+	*puiSize = xCapture.uiSize;
+	(void)pthread_mutex_unlock(&xCaptureMutex);
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceStreamPortCaptureClear(void)
+{
+	(void)pthread_mutex_lock(&xCaptureMutex);
+	xCapture.uiSize = 0u;
+	(void)pthread_mutex_unlock(&xCaptureMutex);
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceStreamPortCaptureSetWriteLimit(uint32_t uiLimit)
+{
+	(void)pthread_mutex_lock(&xCaptureMutex);
+	xCapture.uiWriteLimit = uiLimit;
+	(void)pthread_mutex_unlock(&xCaptureMutex);
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceStreamPortCaptureSendCommand(const void* pvCommand, uint32_t uiSize)
+{
+	traceResult xResult = TRC_FAIL;
+
+	if ((pvCommand == 0) || (uiSize != TRC_STREAM_PORT_CAPTURE_COMMAND_SIZE))
+	{
+		return TRC_FAIL;
+	}
+
+	(void)pthread_mutex_lock(&xCaptureMutex);
+	if (xCapture.uiCommandCount < TRC_STREAM_PORT_CAPTURE_COMMANDS)
+	{
+		(void)memcpy(xCapture.auiCommands[(xCapture.uiCommandHead + xCapture.uiCommandCount) % TRC_STREAM_PORT_CAPTURE_COMMANDS], pvCommand, uiSize);
+		xCapture.uiCommandCount++;
+		xResult = TRC_SUCCESS;
+	}
+	(void)pthread_mutex_unlock(&xCaptureMutex);
+
+	return xResult;
+}
+
+traceResult xTraceStreamPortWriteData(void* pvData, uint32_t uiSize, int32_t* piBytesWritten)
+{
+	traceResult xResult = TRC_SUCCESS;
+
+	(void)pthread_mutex_lock(&xCaptureMutex);
+
+	if (uiSize > xCapture.uiWriteLimit)
+	{
+		uiSize = xCapture.uiWriteLimit;
+	}
+
+	if (uiSize > (sizeof(xCapture.auiData) - xCapture.uiSize))
+	{
+		uiSize = 0u;
+		xResult = TRC_FAIL;
+	}
+
+	(void)memcpy(&xCapture.auiData[xCapture.uiSize], pvData, uiSize);
+	xCapture.uiSize += uiSize;
+	*piBytesWritten = (int32_t)uiSize;
+
+	(void)pthread_mutex_unlock(&xCaptureMutex);
+
+	return xResult;
+}
+
+traceResult xTraceStreamPortReadData(void* pvData, uint32_t uiSize, int32_t* piBytesRead)
+{
+	*piBytesRead = 0;
+
+	(void)pthread_mutex_lock(&xCaptureMutex);
+	if ((xCapture.uiCommandCount > 0u) && (uiSize >= TRC_STREAM_PORT_CAPTURE_COMMAND_SIZE))
+	{
+		(void)memcpy(pvData, xCapture.auiCommands[xCapture.uiCommandHead], TRC_STREAM_PORT_CAPTURE_COMMAND_SIZE);
+		xCapture.uiCommandHead = (xCapture.uiCommandHead + 1u) % TRC_STREAM_PORT_CAPTURE_COMMANDS;
+		xCapture.uiCommandCount--;
+		*piBytesRead = (int32_t)TRC_STREAM_PORT_CAPTURE_COMMAND_SIZE;
+	}
+	(void)pthread_mutex_unlock(&xCaptureMutex);
+
+	return TRC_SUCCESS;
+}
+
+#endif /*(TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)*/
+
+#endif /*(TRC_USE_TRACEALYZER_RECORDER == 1)*/
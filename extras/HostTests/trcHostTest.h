@@ -0,0 +1,78 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Helpers shared by the host tests. A failed check prints where it failed
+ * and the test goes on, vHostTestDone() gives the exit code. Tests built
+ * with the capture stream port decode what the recorder wrote with the PSF
+ * decoder in extras/PSFDecoder.
+ */
+
+#ifndef TRC_HOST_TEST_H
+#define TRC_HOST_TEST_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef TRC_STREAM_PORT_CAPTURE_UNLIMITED
+#include <trcPsfDecoder.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TRC_TEST_CHECK(xCondition) prvHostTestCheck(((xCondition) ? 1u : 0u), #xCondition, __FILE__, __LINE__)
+
+static uint32_t uiHostTestChecks = 0u;
+static uint32_t uiHostTestFailures = 0u;
+
+static inline uint32_t prvHostTestCheck(uint32_t uiPassed, const char* szCondition, const char* szFile, int iLine)
+{
+	uiHostTestChecks++;
+
+	if (uiPassed == 0u)
+	{
+		uiHostTestFailures++;
+		printf("%s:%d: check failed: %s\n", szFile, iLine, szCondition);
+	}
+
+	return uiPassed;
+}
+
+/* Prints the result, returns the exit code */
+static inline int iHostTestDone(const char* szTest)
+{
+	printf("%s: %u checks, %u failed\n", szTest, (unsigned int)uiHostTestChecks, (unsigned int)uiHostTestFailures);
+
+	return (uiHostTestFailures == 0u) ? 0 : 1;
+}
+
+#ifdef TRC_STREAM_PORT_CAPTURE_UNLIMITED
+
+/* Decodes everything the capture stream port holds, 0 if it is a valid stream */
+static inline int32_t xHostTestDecodeCapture(TracePsfDecoder_t* pxDecoder, TracePsfDecoderOnEvent_t xOnEvent, void* pvUser)
+{
+	const uint8_t* puiData;
+	uint32_t uiSize;
+
+	if ((xTraceStreamPortCaptureGet(&puiData, &uiSize) == TRC_FAIL) ||
+		(xTracePsfDecoderInitialize(pxDecoder, xOnEvent, pvUser) != 0) ||
+		(xTracePsfDecoderFeed(pxDecoder, puiData, uiSize) != 0))
+	{
+		return -1;
+	}
+
+	return xTracePsfDecoderFinish(pxDecoder);
+}
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRC_HOST_TEST_H */
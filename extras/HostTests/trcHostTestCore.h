@@ -0,0 +1,21 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Included first in every file of a multicore test recorder, see
+ * trc_add_host_test_snapshot_recorder(). The test sets the current core.
+ */
+
+#ifndef TRC_HOST_TEST_CORE_H
+#define TRC_HOST_TEST_CORE_H
+
+#include <stdint.h>
+
+extern uint32_t uiHostTestCore;
+
+#define TRC_CFG_GET_CURRENT_CORE() uiHostTestCore
+
+#endif /* TRC_HOST_TEST_CORE_H */
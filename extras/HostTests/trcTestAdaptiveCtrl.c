@@ -0,0 +1,132 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Tests the adaptive TzCtrl delay and chunk budget (TRC_CFG_CTRL_ADAPTIVE)
+ * with the internal buffer in Chunk transfer mode, calling xTraceTzCtrl() as
+ * the TzCtrl task would after each delay. Checks that an idle recorder gets
+ * the longest delay, which by default is the fixed TRC_CFG_CTRL_TASK_DELAY,
+ * that a burst gets the shortest delay and a larger chunk budget at once, that
+ * a steady load gets a delay in between, and that the delay grows back once
+ * the load is gone.
+ */
+
+#include <trcRecorder.h>
+#include <trcPsfDecoder.h>
+#include <trcHostTest.h>
+
+/* Bytes stored per delay unit under a steady load */
+#define TEST_LOAD 400u
+
+static TracePsfDecoder_t xDecoder;
+
+static uint32_t prvDelay(void)
+{
+	TraceUnsignedBaseType_t uxDelay = 0u;
+	TraceBaseType_t xDiagnostic = 0;
+
+	TRC_TEST_CHECK(xTraceAdaptiveCtrlGetDelay(&uxDelay) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceDiagnosticsGet(TRC_DIAGNOSTICS_CTRL_TASK_DELAY, &xDiagnostic) == TRC_SUCCESS);
+	TRC_TEST_CHECK((TraceUnsignedBaseType_t)xDiagnostic == uxDelay);
+
+	return (uint32_t)uxDelay;
+}
+
+/* Stores events until the internal buffer holds uiBytes more than now */
+static void prvStore(TraceStringHandle_t xChannel, uint32_t uiBytes)
+{
+	uint32_t uiUsedBefore = 0u;
+	uint32_t uiUsed = 0u;
+	uint32_t uiSize = 0u;
+	int32_t i = 0;
+
+	(void)xTraceInternalEventBufferGetUsed(&uiUsedBefore, &uiSize);
+
+	do
+	{
+		(void)xTracePrintF(xChannel, "%d", i);
+		i++;
+		(void)xTraceInternalEventBufferGetUsed(&uiUsed, &uiSize);
+	} while (((uiUsed - uiUsedBefore) < uiBytes) && (i < 100000));
+}
+
+int main(void)
+{
+	TraceStringHandle_t xChannel;
+	TraceUnsignedBaseType_t uxDelay = 0u;
+	uint32_t uiChunkBudget = 0u;
+	uint32_t uiUsed = 0u;
+	uint32_t uiSize = 0u;
+	uint32_t uiDelay;
+	uint32_t i;
+
+	TRC_TEST_CHECK(xTraceInitialize() == TRC_SUCCESS);
+
+	/* The fixed delay while the recorder isn't enabled */
+	TRC_TEST_CHECK(xTraceAdaptiveCtrlGetDelay(&uxDelay) == TRC_SUCCESS);
+	TRC_TEST_CHECK(uxDelay == (TRC_CFG_CTRL_TASK_DELAY));
+	TRC_TEST_CHECK(xTraceEnable(TRC_START) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceStringRegister("Adaptive", &xChannel) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceTzCtrl() == TRC_SUCCESS);
+
+	/* Idle, the longest delay, which is never longer than the fixed one */
+	for (i = 0u; i < 20u; i++)
+	{
+		TRC_TEST_CHECK(xTraceTzCtrl() == TRC_SUCCESS);
+	}
+	TRC_TEST_CHECK(prvDelay() == (TRC_CFG_CTRL_TASK_DELAY_MAX));
+	TRC_TEST_CHECK((TRC_CFG_CTRL_TASK_DELAY_MAX) == (TRC_CFG_CTRL_TASK_DELAY));
+	TRC_TEST_CHECK(xTraceAdaptiveCtrlGetChunkBudget(&uiChunkBudget) == TRC_SUCCESS);
+	TRC_TEST_CHECK(uiChunkBudget == 1u);
+
+	/* A burst that the stream port can't take yet, the shortest delay and a
+	 * chunk budget for what is in the buffer */
+	(void)xTraceStreamPortCaptureSetWriteLimit(0u);
+	prvStore(xChannel, 3000u);
+	TRC_TEST_CHECK(xTraceTzCtrl() == TRC_SUCCESS);
+	TRC_TEST_CHECK(prvDelay() == (TRC_CFG_CTRL_TASK_DELAY_MIN));
+	TRC_TEST_CHECK(xTraceAdaptiveCtrlGetChunkBudget(&uiChunkBudget) == TRC_SUCCESS);
+	TRC_TEST_CHECK(uiChunkBudget > 1u);
+	TRC_TEST_CHECK(uiChunkBudget <= (TRC_CFG_CTRL_CHUNK_BUDGET_MAX));
+
+	/* Taken in one TzCtrl call thanks to the chunk budget, the buffer was
+	 * behind so the delay stays short */
+	(void)xTraceStreamPortCaptureSetWriteLimit(TRC_STREAM_PORT_CAPTURE_UNLIMITED);
+	TRC_TEST_CHECK(xTraceTzCtrl() == TRC_SUCCESS);
+	TRC_TEST_CHECK(prvDelay() == (TRC_CFG_CTRL_TASK_DELAY_MIN));
+	TRC_TEST_CHECK(xTraceInternalEventBufferGetUsed(&uiUsed, &uiSize) == TRC_SUCCESS);
+	TRC_TEST_CHECK(uiUsed < uiSize / 10u);
+
+	/* A steady load of TEST_LOAD bytes per delay unit settles at the time it
+	 * takes to fill the buffer to the target occupancy */
+	for (i = 0u; i < 20u; i++)
+	{
+		prvStore(xChannel, prvDelay() * TEST_LOAD);
+		TRC_TEST_CHECK(xTraceTzCtrl() == TRC_SUCCESS);
+	}
+	uiDelay = prvDelay();
+	TRC_TEST_CHECK(uiDelay > (TRC_CFG_CTRL_TASK_DELAY_MIN));
+	TRC_TEST_CHECK(uiDelay < (TRC_CFG_CTRL_TASK_DELAY_MAX));
+	TRC_TEST_CHECK(uiDelay <= ((uiSize / 100u) * (TRC_CFG_CTRL_TARGET_OCCUPANCY)) / TEST_LOAD);
+
+	/* The delay grows back to the longest once the load is gone */
+	for (i = 0u; i < 40u; i++)
+	{
+		TRC_TEST_CHECK(xTraceTzCtrl() == TRC_SUCCESS);
+		TRC_TEST_CHECK(prvDelay() >= uiDelay);
+		uiDelay = prvDelay();
+	}
+	TRC_TEST_CHECK(uiDelay == (TRC_CFG_CTRL_TASK_DELAY_MAX));
+
+	/* Nothing was lost, only delayed */
+	TRC_TEST_CHECK(xHostTestDecodeCapture(&xDecoder, (TracePsfDecoderOnEvent_t)0, (void*)0) == 0);
+	TRC_TEST_CHECK(xDecoder.uiTruncatedBytes == 0u);
+	TRC_TEST_CHECK(xDecoder.xCores[0].ulGaps == 0u);
+
+	TRC_TEST_CHECK(xTraceDisable() == TRC_SUCCESS);
+
+	return iHostTestDone("trcTestAdaptiveCtrl");
+}
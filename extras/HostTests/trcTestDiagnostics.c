@@ -0,0 +1,165 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Tests the extended diagnostics (TRC_CFG_DIAGNOSTICS_EXTENDED) with the
+ * internal buffer and a short report interval. Checks that the committed
+ * bytes grow by what the events take in the buffer, that the most bytes in
+ * the buffer are sampled before each transfer, that the transferred bytes
+ * grow by as much as the committed bytes once the buffer is empty, that each
+ * xTraceTzCtrl() transfer is counted, that writes of less than asked are
+ * counted, and that the report is stored as one user event plus one per core
+ * every TRC_CFG_DIAGNOSTICS_REPORT_INTERVAL calls of xTraceTzCtrl().
+ */
+
+#include <trcRecorder.h>
+#include <trcPsfDecoder.h>
+#include <trcHostTest.h>
+
+#define TEST_EVENTS 50u
+
+static TracePsfDecoder_t xDecoder;
+static TraceStringHandle_t xChannel;
+
+/* User events on other channels than the test's */
+static uint32_t uiReports = 0u;
+
+static int32_t prvOnEvent(void* pvUser, const TracePsfDecoderEvent_t* pxEvent)
+{
+	const uint32_t uiCode = pxEvent->uiCode & 0xFFFu;
+
+	(void)pvUser;
+
+	if ((uiCode >= (uint32_t)(PSF_EVENT_USER_EVENT)) && (uiCode < (uint32_t)(PSF_EVENT_USER_EVENT_FIXED) + 8u) &&
+		(pxEvent->ulParameters[0] != (uint64_t)xChannel))
+	{
+		uiReports++;
+	}
+
+	return 0;
+}
+
+static uint32_t prvReports(void)
+{
+	uiReports = 0u;
+	TRC_TEST_CHECK(xHostTestDecodeCapture(&xDecoder, prvOnEvent, (void*)0) == 0);
+	TRC_TEST_CHECK(xDecoder.uiTruncatedBytes == 0u);
+	TRC_TEST_CHECK(xDecoder.xCores[0].ulGaps == 0u);
+
+	return uiReports;
+}
+
+static uint32_t prvUsed(void)
+{
+	uint32_t uiUsed = 0u;
+	uint32_t uiSize = 0u;
+
+	TRC_TEST_CHECK(xTraceInternalEventBufferGetUsed(&uiUsed, &uiSize) == TRC_SUCCESS);
+
+	return uiUsed;
+}
+
+static TraceBaseType_t prvGet(TraceDiagnosticsType_t xType)
+{
+	TraceBaseType_t xValue = 0;
+
+	TRC_TEST_CHECK(xTraceDiagnosticsGet(xType, &xValue) == TRC_SUCCESS);
+
+	return xValue;
+}
+
+static TraceBaseType_t prvCoreGet(TraceDiagnosticsCoreType_t xType)
+{
+	TraceBaseType_t xValue = 0;
+
+	TRC_TEST_CHECK(xTraceDiagnosticsCoreGet(0u, xType, &xValue) == TRC_SUCCESS);
+
+	return xValue;
+}
+
+/* The bytes transferred but not committed, which are those of the header
+ * and entry table, stored without events */
+static TraceBaseType_t prvNotCommitted(void)
+{
+	return prvCoreGet(TRC_DIAGNOSTICS_CORE_BYTES_TRANSFERRED) - prvCoreGet(TRC_DIAGNOSTICS_CORE_BYTES_COMMITTED);
+}
+
+int main(void)
+{
+	TraceBaseType_t xCommitted, xNotCommitted, xTransfers, xShortWrites;
+	uint32_t uiUsed;
+	uint32_t i;
+
+	TRC_TEST_CHECK(xTraceInitialize() == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceEnable(TRC_START) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceStringRegister("Diagnostics", &xChannel) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceTzCtrl() == TRC_SUCCESS);
+	TRC_TEST_CHECK(prvUsed() == 0u);
+	TRC_TEST_CHECK(prvGet(TRC_DIAGNOSTICS_TRANSFER_CALLS) == 1);
+	xNotCommitted = prvNotCommitted();
+	TRC_TEST_CHECK(xNotCommitted > 0);
+
+	/* The committed bytes grow by what the events take in the buffer */
+	xCommitted = prvCoreGet(TRC_DIAGNOSTICS_CORE_BYTES_COMMITTED);
+	for (i = 0u; i < TEST_EVENTS; i++)
+	{
+		TRC_TEST_CHECK(xTracePrintF(xChannel, "%d", (int32_t)i) == TRC_SUCCESS);
+	}
+	uiUsed = prvUsed();
+	TRC_TEST_CHECK(uiUsed > 0u);
+	TRC_TEST_CHECK(prvCoreGet(TRC_DIAGNOSTICS_CORE_BYTES_COMMITTED) == xCommitted + (TraceBaseType_t)uiUsed);
+
+	/* Sampled before the transfer, which takes it all */
+	TRC_TEST_CHECK(xTraceTzCtrl() == TRC_SUCCESS);
+	TRC_TEST_CHECK(prvUsed() == 0u);
+	TRC_TEST_CHECK(prvCoreGet(TRC_DIAGNOSTICS_CORE_BUFFER_USED_HIGHEST) >= (TraceBaseType_t)uiUsed);
+	TRC_TEST_CHECK(prvNotCommitted() == xNotCommitted);
+	TRC_TEST_CHECK(prvGet(TRC_DIAGNOSTICS_TRANSFER_CALLS) == 2);
+	TRC_TEST_CHECK(prvGet(TRC_DIAGNOSTICS_STREAM_PORT_SHORT_WRITES) == 0);
+
+	/* Writes of less than asked, also of nothing, are counted */
+	TRC_TEST_CHECK(xTracePrintF(xChannel, "%d", 0) == TRC_SUCCESS);
+	(void)xTraceStreamPortCaptureSetWriteLimit(4u);
+	TRC_TEST_CHECK(xTraceTzCtrl() == TRC_SUCCESS);
+	xShortWrites = prvGet(TRC_DIAGNOSTICS_STREAM_PORT_SHORT_WRITES);
+	TRC_TEST_CHECK(xShortWrites > 0);
+	(void)xTraceStreamPortCaptureSetWriteLimit(0u);
+	TRC_TEST_CHECK(xTraceTzCtrl() == TRC_SUCCESS);
+	TRC_TEST_CHECK(prvGet(TRC_DIAGNOSTICS_STREAM_PORT_SHORT_WRITES) > xShortWrites);
+	TRC_TEST_CHECK(prvNotCommitted() < xNotCommitted);
+	(void)xTraceStreamPortCaptureSetWriteLimit(TRC_STREAM_PORT_CAPTURE_UNLIMITED);
+	TRC_TEST_CHECK(xTraceTzCtrl() == TRC_SUCCESS);
+	TRC_TEST_CHECK(prvNotCommitted() == xNotCommitted);
+	TRC_TEST_CHECK(prvGet(TRC_DIAGNOSTICS_STREAM_PORT_WRITE_FAILURES) == 0);
+
+	/* One transfer per xTraceTzCtrl(), no report until the interval is reached */
+	xTransfers = prvGet(TRC_DIAGNOSTICS_TRANSFER_CALLS);
+	TRC_TEST_CHECK(xTransfers == 5);
+	for (i = (uint32_t)xTransfers + 1u; i < (uint32_t)(TRC_CFG_DIAGNOSTICS_REPORT_INTERVAL); i++)
+	{
+		TRC_TEST_CHECK(xTraceTzCtrl() == TRC_SUCCESS);
+	}
+	TRC_TEST_CHECK(prvGet(TRC_DIAGNOSTICS_TRANSFER_CALLS) == (TraceBaseType_t)(TRC_CFG_DIAGNOSTICS_REPORT_INTERVAL) - 1);
+	TRC_TEST_CHECK(prvReports() == 0u);
+
+	/* Then one user event plus one per core, transferred by the next call */
+	TRC_TEST_CHECK(xTraceTzCtrl() == TRC_SUCCESS);
+	TRC_TEST_CHECK(prvReports() == 0u);
+	TRC_TEST_CHECK(xTraceTzCtrl() == TRC_SUCCESS);
+	TRC_TEST_CHECK(prvReports() == 1u + (uint32_t)(TRC_CFG_CORE_COUNT));
+
+	/* The next report, transferred by the call after it */
+	for (i = 0u; i < (uint32_t)(TRC_CFG_DIAGNOSTICS_REPORT_INTERVAL); i++)
+	{
+		TRC_TEST_CHECK(xTraceTzCtrl() == TRC_SUCCESS);
+	}
+	TRC_TEST_CHECK(prvReports() == 2u * (1u + (uint32_t)(TRC_CFG_CORE_COUNT)));
+	TRC_TEST_CHECK(prvNotCommitted() == xNotCommitted);
+
+	TRC_TEST_CHECK(xTraceDisable() == TRC_SUCCESS);
+
+	return iHostTestDone("trcTestDiagnostics");
+}
@@ -0,0 +1,174 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Regression tests for the event buffer (trcEventBuffer.c), on a small
+ * buffer driven directly, with the capture stream port limiting how many
+ * bytes each transfer writes. Each test sets up the head, tail and slack
+ * that made an earlier version of the event buffer lose or overwrite data.
+ */
+
+#include <trcRecorder.h>
+#include <trcHostTest.h>
+#include <string.h>
+
+#define TEST_BUFFER_SIZE 64u
+
+static TraceEventBuffer_t xBuffer;
+static uint8_t auiData[TEST_BUFFER_SIZE];
+
+/* Allocates and commits an event of uiSize bytes, with a valid header */
+static traceResult prvAllocCommit(uint32_t uiSize)
+{
+	TraceEvent0_t* pxEvent = (TraceEvent0_t*)0;
+	int32_t iBytesWritten = 0;
+
+	if (xTraceEventBufferAlloc(&xBuffer, uiSize, (void**)&pxEvent) == TRC_FAIL)
+	{
+		return TRC_FAIL;
+	}
+
+	(void)memset(pxEvent, 0, uiSize);
+	pxEvent->EventID = (uint16_t)(((uiSize - sizeof(TraceEvent0_t)) / sizeof(TraceUnsignedBaseType_t)) << 12);
+
+	return xTraceEventBufferAllocCommit(&xBuffer, pxEvent, uiSize, &iBytesWritten);
+}
+
+/* Transfers at most uiLimit bytes */
+static void prvTransfer(uint32_t uiLimit)
+{
+	int32_t iBytesWritten = 0;
+
+	(void)xTraceStreamPortCaptureSetWriteLimit(uiLimit);
+	(void)xTraceEventBufferTransferAll(&xBuffer, &iBytesWritten);
+	(void)xTraceStreamPortCaptureSetWriteLimit(TRC_STREAM_PORT_CAPTURE_UNLIMITED);
+}
+
+/* Skip mode: an allocation that wraps must not fill up to the tail, since
+ * the head would then be equal to the tail, which reads as empty */
+static void prvTestSkipWrapToTail(void)
+{
+	uint32_t uiUsed = 0u;
+
+	TRC_TEST_CHECK(xTraceEventBufferInitialize(&xBuffer, TRC_EVENT_BUFFER_OPTION_SKIP, auiData, sizeof(auiData)) == TRC_SUCCESS);
+	TRC_TEST_CHECK(prvAllocCommit(16u) == TRC_SUCCESS);
+	TRC_TEST_CHECK(prvAllocCommit(16u) == TRC_SUCCESS);
+	TRC_TEST_CHECK(prvAllocCommit(16u) == TRC_SUCCESS);
+	prvTransfer(16u);
+	TRC_TEST_CHECK(xBuffer.uiHead == 48u);
+	TRC_TEST_CHECK(xBuffer.uiTail == 16u);
+
+	/* Doesn't fit before the end, and at the start only up to the tail */
+	TRC_TEST_CHECK(prvAllocCommit(16u) == TRC_FAIL);
+	TRC_TEST_CHECK(xTraceEventBufferGetUsed(&xBuffer, &uiUsed) == TRC_SUCCESS);
+	TRC_TEST_CHECK(uiUsed == 32u);
+}
+
+/* Skip mode: a partial transfer can leave the tail less than a word ahead of
+ * a wrapped head, which must read as no free space */
+static void prvTestSkipTailNearHead(void)
+{
+	uint8_t auiEvent[16] = { 0u };
+	int32_t iBytesWritten = -1;
+	uint32_t uiUsed = 0u;
+
+	TRC_TEST_CHECK(xTraceEventBufferInitialize(&xBuffer, TRC_EVENT_BUFFER_OPTION_SKIP, auiData, sizeof(auiData)) == TRC_SUCCESS);
+	TRC_TEST_CHECK(prvAllocCommit(16u) == TRC_SUCCESS);
+	TRC_TEST_CHECK(prvAllocCommit(16u) == TRC_SUCCESS);
+	TRC_TEST_CHECK(prvAllocCommit(16u) == TRC_SUCCESS);
+	prvTransfer(18u);
+	TRC_TEST_CHECK(prvAllocCommit(16u) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xBuffer.uiHead == 16u);
+	TRC_TEST_CHECK(xBuffer.uiTail == 18u);
+
+	/* Would overwrite the data from the tail on */
+	TRC_TEST_CHECK(prvAllocCommit(8u) == TRC_FAIL);
+	TRC_TEST_CHECK(xTraceEventBufferPush(&xBuffer, auiEvent, 8u, &iBytesWritten) == TRC_SUCCESS);
+	TRC_TEST_CHECK(iBytesWritten == 0);
+	TRC_TEST_CHECK(xBuffer.uiHead == 16u);
+	TRC_TEST_CHECK(xTraceEventBufferGetUsed(&xBuffer, &uiUsed) == TRC_SUCCESS);
+	TRC_TEST_CHECK(uiUsed == 46u);
+}
+
+/* Overwrite mode: an allocation that exactly fits before the end of the
+ * buffer, with the tail ahead of the head, must wrap the head */
+static void prvTestOverwriteExactFit(void)
+{
+	void* pvData = (void*)0;
+	uint32_t i;
+
+	TRC_TEST_CHECK(xTraceEventBufferInitialize(&xBuffer, TRC_EVENT_BUFFER_OPTION_OVERWRITE, auiData, sizeof(auiData)) == TRC_SUCCESS);
+	for (i = 0u; i < 7u; i++)
+	{
+		TRC_TEST_CHECK(prvAllocCommit(8u) == TRC_SUCCESS);
+	}
+
+	/* Wraps, with the last 8 bytes as slack */
+	TRC_TEST_CHECK(prvAllocCommit(16u) == TRC_SUCCESS);
+	for (i = 0u; i < 4u; i++)
+	{
+		TRC_TEST_CHECK(prvAllocCommit(8u) == TRC_SUCCESS);
+	}
+	TRC_TEST_CHECK(xBuffer.uiHead == 48u);
+	TRC_TEST_CHECK(xBuffer.uiTail == 56u);
+	TRC_TEST_CHECK(xBuffer.uiSlack == 8u);
+
+	TRC_TEST_CHECK(xTraceEventBufferAlloc(&xBuffer, 16u, &pvData) == TRC_SUCCESS);
+	TRC_TEST_CHECK(pvData == (void*)&auiData[0]);
+	TRC_TEST_CHECK(xBuffer.uiNextHead == 16u);
+	TRC_TEST_CHECK(xBuffer.uiSlack == 16u);
+	TRC_TEST_CHECK(xBuffer.uiTail > 16u);
+}
+
+/* Pushes events of 16 bytes until the buffer is full, returns the bytes used */
+static uint32_t prvPushUntilFull(void)
+{
+	uint8_t auiEvent[16] = { 0u };
+	int32_t iBytesWritten = 0;
+	uint32_t uiUsed = 0u;
+	uint32_t i;
+
+	/* Two parameters */
+	((TraceEvent0_t*)auiEvent)->EventID = (uint16_t)(((sizeof(auiEvent) - sizeof(TraceEvent0_t)) / sizeof(TraceUnsignedBaseType_t)) << 12);
+
+	for (i = 0u; i < TEST_BUFFER_SIZE / sizeof(auiEvent); i++)
+	{
+		TRC_TEST_CHECK(xTraceEventBufferPush(&xBuffer, auiEvent, sizeof(auiEvent), &iBytesWritten) == TRC_SUCCESS);
+		TRC_TEST_CHECK(iBytesWritten == (int32_t)sizeof(auiEvent));
+	}
+
+	TRC_TEST_CHECK(xTraceEventBufferGetUsed(&xBuffer, &uiUsed) == TRC_SUCCESS);
+
+	return uiUsed;
+}
+
+/* Overwrite mode: a word must be left unused also when set up by Initialize
+ * and Clear, or a full buffer gets the head equal to the tail */
+static void prvTestOverwriteFull(void)
+{
+	TRC_TEST_CHECK(xTraceEventBufferInitialize(&xBuffer, TRC_EVENT_BUFFER_OPTION_OVERWRITE, auiData, sizeof(auiData)) == TRC_SUCCESS);
+	TRC_TEST_CHECK(prvPushUntilFull() == TEST_BUFFER_SIZE - 16u);
+
+	TRC_TEST_CHECK(xTraceEventBufferClear(&xBuffer) == TRC_SUCCESS);
+	TRC_TEST_CHECK(prvPushUntilFull() == TEST_BUFFER_SIZE - 16u);
+
+	/* As set up by SetOptions */
+	TRC_TEST_CHECK(xTraceEventBufferInitialize(&xBuffer, TRC_EVENT_BUFFER_OPTION_SKIP, auiData, sizeof(auiData)) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceEventBufferSetOptions(&xBuffer, TRC_EVENT_BUFFER_OPTION_OVERWRITE) == TRC_SUCCESS);
+	TRC_TEST_CHECK(prvPushUntilFull() == TEST_BUFFER_SIZE - 16u);
+}
+
+int main(void)
+{
+	TRC_TEST_CHECK(xTraceInitialize() == TRC_SUCCESS);
+
+	prvTestSkipWrapToTail();
+	prvTestSkipTailNearHead();
+	prvTestOverwriteExactFit();
+	prvTestOverwriteFull();
+
+	return iHostTestDone("trcTestEventBuffer");
+}
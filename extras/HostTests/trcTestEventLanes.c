@@ -0,0 +1,156 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Tests the event lanes of the internal buffer (TRC_CFG_EVENT_LANES) while
+ * the stream port is busy. Built for both the Direct and the Copy write mode.
+ * Checks that user events are dropped once only the two reserves remain,
+ * object events once only the scheduling reserve remains and scheduling
+ * events only when the buffer is full, that each drop is counted in its
+ * lane's diagnostic, and that the stream stays valid with only the dropped
+ * events missing.
+ */
+
+#include <trcRecorder.h>
+#include <trcPsfDecoder.h>
+#include <trcHostTest.h>
+
+/* More events than fit in the internal buffer */
+#define TEST_MAX_EVENTS 10000u
+
+static TracePsfDecoder_t xDecoder;
+
+static uint32_t prvUsed(void)
+{
+	uint32_t uiUsed = 0u;
+	uint32_t uiSize = 0u;
+
+	TRC_TEST_CHECK(xTraceInternalEventBufferGetUsed(&uiUsed, &uiSize) == TRC_SUCCESS);
+
+	return uiUsed;
+}
+
+static uint32_t prvSize(void)
+{
+	uint32_t uiUsed = 0u;
+	uint32_t uiSize = 0u;
+
+	TRC_TEST_CHECK(xTraceInternalEventBufferGetUsed(&uiUsed, &uiSize) == TRC_SUCCESS);
+
+	return uiSize;
+}
+
+static TraceBaseType_t prvDropped(TraceDiagnosticsType_t xType)
+{
+	TraceBaseType_t xDropped = 0;
+
+	TRC_TEST_CHECK(xTraceDiagnosticsGet(xType, &xDropped) == TRC_SUCCESS);
+
+	return xDropped;
+}
+
+/* Stores user events until one is dropped */
+static void prvFillUser(TraceStringHandle_t xChannel)
+{
+	const TraceBaseType_t xBefore = prvDropped(TRC_DIAGNOSTICS_LANE_USER_DROPPED);
+	uint32_t i;
+
+	for (i = 0u; (i < TEST_MAX_EVENTS) && (prvDropped(TRC_DIAGNOSTICS_LANE_USER_DROPPED) == xBefore); i++)
+	{
+		(void)xTracePrintF(xChannel, "%d", (int32_t)i);
+	}
+	TRC_TEST_CHECK(prvDropped(TRC_DIAGNOSTICS_LANE_USER_DROPPED) == xBefore + 1);
+}
+
+/* Stores object lane events (instance finish) until one is dropped */
+static void prvFillObject(void)
+{
+	const TraceBaseType_t xBefore = prvDropped(TRC_DIAGNOSTICS_LANE_OBJECT_DROPPED);
+	uint32_t i;
+
+	for (i = 0u; (i < TEST_MAX_EVENTS) && (prvDropped(TRC_DIAGNOSTICS_LANE_OBJECT_DROPPED) == xBefore); i++)
+	{
+		(void)xTraceTaskInstanceFinishedNow();
+	}
+	TRC_TEST_CHECK(prvDropped(TRC_DIAGNOSTICS_LANE_OBJECT_DROPPED) == xBefore + 1);
+}
+
+/* Stores scheduling events (task ready) until one is dropped */
+static void prvFillScheduling(void)
+{
+	const TraceBaseType_t xBefore = prvDropped(TRC_DIAGNOSTICS_LANE_SCHEDULING_DROPPED);
+	uint32_t i;
+
+	for (i = 0u; (i < TEST_MAX_EVENTS) && (prvDropped(TRC_DIAGNOSTICS_LANE_SCHEDULING_DROPPED) == xBefore); i++)
+	{
+		(void)xTraceTaskReady((void*)0x1000);
+	}
+	TRC_TEST_CHECK(prvDropped(TRC_DIAGNOSTICS_LANE_SCHEDULING_DROPPED) == xBefore + 1);
+}
+
+int main(void)
+{
+	TraceStringHandle_t xChannel;
+	uint32_t uiSize, uiUserLimit, uiObjectLimit;
+	uint64_t ulMissing = 0u;
+	uint32_t i;
+
+	TRC_TEST_CHECK(xTraceInitialize() == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceEnable(TRC_START) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceStringRegister("Lanes", &xChannel) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceTzCtrl() == TRC_SUCCESS);
+	TRC_TEST_CHECK(prvUsed() == 0u);
+
+	/* The bytes each lane may fill the buffer up to */
+	uiSize = prvSize();
+	uiUserLimit = uiSize - (uiSize / 100u) * ((uint32_t)(TRC_CFG_EVENT_LANE_RESERVE_SCHEDULING) + (uint32_t)(TRC_CFG_EVENT_LANE_RESERVE_OBJECT));
+	uiObjectLimit = uiSize - (uiSize / 100u) * (uint32_t)(TRC_CFG_EVENT_LANE_RESERVE_SCHEDULING);
+
+	(void)xTraceStreamPortCaptureSetWriteLimit(0u);
+
+	/* User events stop short of both reserves */
+	prvFillUser(xChannel);
+	TRC_TEST_CHECK(prvUsed() <= uiUserLimit);
+	TRC_TEST_CHECK(prvUsed() > uiUserLimit - 64u);
+	TRC_TEST_CHECK(prvDropped(TRC_DIAGNOSTICS_LANE_OBJECT_DROPPED) == 0);
+	TRC_TEST_CHECK(prvDropped(TRC_DIAGNOSTICS_LANE_SCHEDULING_DROPPED) == 0);
+
+	/* Object events go on to the scheduling reserve, user events still can't */
+	prvFillObject();
+	TRC_TEST_CHECK(prvUsed() <= uiObjectLimit);
+	TRC_TEST_CHECK(prvUsed() > uiObjectLimit - 64u);
+	prvFillUser(xChannel);
+	TRC_TEST_CHECK(prvDropped(TRC_DIAGNOSTICS_LANE_SCHEDULING_DROPPED) == 0);
+
+	/* Scheduling events use the rest */
+	prvFillScheduling();
+	TRC_TEST_CHECK(prvUsed() > uiSize - 64u);
+	prvFillObject();
+
+	TRC_TEST_CHECK(prvDropped(TRC_DIAGNOSTICS_LANE_USER_DROPPED) == 2);
+	TRC_TEST_CHECK(prvDropped(TRC_DIAGNOSTICS_LANE_OBJECT_DROPPED) == 2);
+	TRC_TEST_CHECK(prvDropped(TRC_DIAGNOSTICS_LANE_SCHEDULING_DROPPED) == 1);
+
+	/* Once the port takes the data, the lanes store again */
+	(void)xTraceStreamPortCaptureSetWriteLimit(TRC_STREAM_PORT_CAPTURE_UNLIMITED);
+	TRC_TEST_CHECK(xTraceTzCtrl() == TRC_SUCCESS);
+	TRC_TEST_CHECK(prvUsed() == 0u);
+	TRC_TEST_CHECK(xTracePrintF(xChannel, "%d", 0) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceTaskInstanceFinishedNow() == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceTaskReady((void*)0x1000) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceTzCtrl() == TRC_SUCCESS);
+	TRC_TEST_CHECK(prvDropped(TRC_DIAGNOSTICS_LANE_USER_DROPPED) == 2);
+
+	TRC_TEST_CHECK(xHostTestDecodeCapture(&xDecoder, (TracePsfDecoderOnEvent_t)0, (void*)0) == 0);
+	TRC_TEST_CHECK(xDecoder.uiTruncatedBytes == 0u);
+	for (i = 0u; i < TRC_PSF_DECODER_MAX_CORES; i++)
+	{
+		ulMissing += xDecoder.xCores[i].ulMissingEvents;
+	}
+	TRC_TEST_CHECK(ulMissing == 5u);
+
+	return iHostTestDone("trcTestEventLanes");
+}
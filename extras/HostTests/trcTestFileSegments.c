@@ -0,0 +1,145 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Tests the segment files of the File stream port, with small segments, a
+ * duration of one second and four segments kept. Checks that storing events
+ * never changes the segment, that TzCtrl changes it once the size or the
+ * duration is reached, that only the kept segments remain and are listed in
+ * the index, and that each of them is a valid stream on its own.
+ */
+
+#include <trcRecorder.h>
+#include <trcPsfDecoder.h>
+#include <trcHostTest.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+static TracePsfDecoder_t xDecoder;
+
+static void prvSegmentName(uint32_t uiSegment, char* szFileName, size_t uxSize)
+{
+	(void)snprintf(szFileName, uxSize, "trcTestFileSegments.%04u.psf", (unsigned int)uiSegment);
+}
+
+static uint32_t prvExists(const char* szFileName)
+{
+	struct stat xStat;
+
+	return (stat(szFileName, &xStat) == 0) ? 1u : 0u;
+}
+
+/* Stores events until the current segment has reached its size */
+static void prvFillSegment(TraceStringHandle_t xChannel)
+{
+	int32_t i = 0;
+
+	while (pxStreamPortFile->xSegments.ulBytes < (uint64_t)(TRC_CFG_STREAM_PORT_SEGMENT_SIZE))
+	{
+		(void)xTracePrintF(xChannel, "%d", i);
+		i++;
+	}
+}
+
+/* Index lines that list a segment, and those of them without a last timestamp */
+static void prvReadIndex(uint32_t* puiSegments, uint32_t* puiOpen)
+{
+	char szLine[512];
+	FILE* pxIndex = fopen(TRC_CFG_STREAM_PORT_SEGMENT_INDEX_FILE, "r");
+
+	*puiSegments = 0u;
+	*puiOpen = 0u;
+
+	if (pxIndex == (FILE*)0)
+	{
+		return;
+	}
+
+	while (fgets(szLine, sizeof(szLine), pxIndex) != (char*)0)
+	{
+		if (szLine[0] != '#')
+		{
+			(*puiSegments)++;
+			if (strstr(szLine, " - ") != (char*)0)
+			{
+				(*puiOpen)++;
+			}
+		}
+	}
+
+	(void)fclose(pxIndex);
+}
+
+int main(void)
+{
+	struct timespec xDelay = { 1, 100000000L };
+	TraceStringHandle_t xChannel;
+	char szFileName[64];
+	uint32_t uiSegments, uiOpen;
+	uint32_t i;
+
+	TRC_TEST_CHECK(xTraceInitialize() == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceEnable(TRC_START) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceStringRegister("Segments", &xChannel) == TRC_SUCCESS);
+	TRC_TEST_CHECK(pxStreamPortFile->xSegments.uiSegment == 0u);
+
+	/* Storing events never changes the segment, TzCtrl does */
+	prvFillSegment(xChannel);
+	prvFillSegment(xChannel);
+	TRC_TEST_CHECK(pxStreamPortFile->xSegments.uiSegment == 0u);
+	TRC_TEST_CHECK(xTraceTzCtrl() == TRC_SUCCESS);
+	TRC_TEST_CHECK(pxStreamPortFile->xSegments.uiSegment == 1u);
+	TRC_TEST_CHECK(pxStreamPortFile->xSegments.ulBytes > 0u);
+	TRC_TEST_CHECK(pxStreamPortFile->xSegments.ulBytes < (uint64_t)(TRC_CFG_STREAM_PORT_SEGMENT_SIZE));
+
+	/* Once per TzCtrl run at most */
+	for (i = 0u; i < 5u; i++)
+	{
+		prvFillSegment(xChannel);
+		TRC_TEST_CHECK(xTraceTzCtrl() == TRC_SUCCESS);
+	}
+	TRC_TEST_CHECK(pxStreamPortFile->xSegments.uiSegment == 6u);
+
+	/* The duration alone */
+	(void)xTracePrintF(xChannel, "%d", 0);
+	(void)nanosleep(&xDelay, (struct timespec*)0);
+	TRC_TEST_CHECK(pxStreamPortFile->xSegments.ulBytes < (uint64_t)(TRC_CFG_STREAM_PORT_SEGMENT_SIZE));
+	TRC_TEST_CHECK(xTraceTzCtrl() == TRC_SUCCESS);
+	TRC_TEST_CHECK(pxStreamPortFile->xSegments.uiSegment == 7u);
+	(void)xTracePrintF(xChannel, "%d", 0);
+
+	prvReadIndex(&uiSegments, &uiOpen);
+	TRC_TEST_CHECK(uiSegments == (TRC_CFG_STREAM_PORT_SEGMENT_KEEP));
+	TRC_TEST_CHECK(uiOpen == 1u);
+
+	TRC_TEST_CHECK(xTraceDisable() == TRC_SUCCESS);
+
+	prvReadIndex(&uiSegments, &uiOpen);
+	TRC_TEST_CHECK(uiSegments == (TRC_CFG_STREAM_PORT_SEGMENT_KEEP));
+	TRC_TEST_CHECK(uiOpen == 0u);
+
+	for (i = 0u; i <= 7u; i++)
+	{
+		prvSegmentName(i, szFileName, sizeof(szFileName));
+
+		if (i <= 7u - (TRC_CFG_STREAM_PORT_SEGMENT_KEEP))
+		{
+			TRC_TEST_CHECK(prvExists(szFileName) == 0u);
+			continue;
+		}
+
+		/* Each kept segment begins with the session info */
+		TRC_TEST_CHECK(xTracePsfDecoderInitialize(&xDecoder, (TracePsfDecoderOnEvent_t)0, (void*)0) == 0);
+		TRC_TEST_CHECK(xTracePsfDecoderDecodeFile(&xDecoder, szFileName) == 0);
+		TRC_TEST_CHECK(xDecoder.uiStarts == 1u);
+		TRC_TEST_CHECK(xDecoder.xCores[0].ulEvents > 0u);
+		TRC_TEST_CHECK(xDecoder.xCores[0].ulGaps == 0u);
+	}
+
+	return iHostTestDone("trcTestFileSegments");
+}
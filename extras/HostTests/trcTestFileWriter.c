@@ -0,0 +1,100 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Tests the writer thread of the File stream port, with small blocks and a
+ * short flush time. Checks that the writer thread writes a partially filled
+ * block by itself once it has been idle, without another event being stored,
+ * and that after a burst that fills all blocks the file is a valid stream
+ * where the only missing events are the ones the port dropped.
+ */
+
+#include <trcRecorder.h>
+#include <trcPsfDecoder.h>
+#include <trcHostTest.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#define TEST_BURST_EVENTS 20000u
+
+static TracePsfDecoder_t xDecoder;
+
+static uint64_t prvFileSize(void)
+{
+	struct stat xStat;
+
+	if (stat(TRC_CFG_STREAM_PORT_TRACE_FILE, &xStat) != 0)
+	{
+		return 0u;
+	}
+
+	return (uint64_t)xStat.st_size;
+}
+
+/* Waits up to a second for the file to reach uiSize bytes */
+static uint64_t prvWaitForFileSize(uint64_t ulSize)
+{
+	struct timespec xDelay = { 0, 5000000L };
+	uint32_t i;
+
+	for (i = 0u; (i < 200u) && (prvFileSize() < ulSize); i++)
+	{
+		(void)nanosleep(&xDelay, (struct timespec*)0);
+	}
+
+	return prvFileSize();
+}
+
+int main(void)
+{
+	TraceStringHandle_t xChannel;
+	uint64_t ulMissing = 0u;
+	uint64_t ulSize;
+	uint32_t uiDropped;
+	uint32_t i;
+
+	TRC_TEST_CHECK(xTraceInitialize() == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceEnable(TRC_START) == TRC_SUCCESS);
+	TRC_TEST_CHECK(pxStreamPortFile->xWriter.puiBlocks != 0);
+	TRC_TEST_CHECK(xTraceStringRegister("Writer", &xChannel) == TRC_SUCCESS);
+
+	/* Far less than a block, written once the writer thread has been idle */
+	for (i = 0u; i < 10u; i++)
+	{
+		TRC_TEST_CHECK(xTracePrintF(xChannel, "%d", (int32_t)i) == TRC_SUCCESS);
+	}
+	TRC_TEST_CHECK(pxStreamPortFile->xWriter.uiFill < (TRC_CFG_STREAM_PORT_WRITER_BLOCK_SIZE));
+	ulSize = prvWaitForFileSize(1u);
+	TRC_TEST_CHECK(ulSize > 0u);
+	TRC_TEST_CHECK(ulSize < (TRC_CFG_STREAM_PORT_WRITER_BLOCK_SIZE));
+	TRC_TEST_CHECK(xTracePsfDecoderInitialize(&xDecoder, (TracePsfDecoderOnEvent_t)0, (void*)0) == 0);
+	TRC_TEST_CHECK(xTracePsfDecoderDecodeFile(&xDecoder, TRC_CFG_STREAM_PORT_TRACE_FILE) == 0);
+	TRC_TEST_CHECK(xDecoder.uiStarts == 1u);
+	TRC_TEST_CHECK(xDecoder.xCores[0].ulEvents >= 10u);
+	TRC_TEST_CHECK(xDecoder.xCores[0].ulGaps == 0u);
+
+	/* A burst faster than the file, whole events are dropped */
+	for (i = 0u; i < TEST_BURST_EVENTS; i++)
+	{
+		(void)xTracePrintF(xChannel, "%d", (int32_t)i);
+	}
+	uiDropped = pxStreamPortFile->xWriter.uiDroppedEvents;
+
+	TRC_TEST_CHECK(xTraceDisable() == TRC_SUCCESS);
+	TRC_TEST_CHECK(pxStreamPortFile->xWriter.puiBlocks == 0);
+
+	TRC_TEST_CHECK(xTracePsfDecoderInitialize(&xDecoder, (TracePsfDecoderOnEvent_t)0, (void*)0) == 0);
+	TRC_TEST_CHECK(xTracePsfDecoderDecodeFile(&xDecoder, TRC_CFG_STREAM_PORT_TRACE_FILE) == 0);
+	TRC_TEST_CHECK(xDecoder.uiStarts == 1u);
+	for (i = 0u; i < TRC_PSF_DECODER_MAX_CORES; i++)
+	{
+		ulMissing += xDecoder.xCores[i].ulMissingEvents;
+	}
+	TRC_TEST_CHECK(ulMissing <= uiDropped);
+	TRC_TEST_CHECK(xDecoder.xCores[0].ulEvents + uiDropped >= TEST_BURST_EVENTS);
+
+	return iHostTestDone("trcTestFileWriter");
+}
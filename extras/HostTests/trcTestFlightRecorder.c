@@ -0,0 +1,186 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Tests the flight recorder (TRC_CFG_FLIGHT_RECORDER), storing task ready
+ * events numbered in order. Checks that nothing is transferred while armed,
+ * that a capture holds the events before and after a trigger, that
+ * xTraceDisable() transfers the events stored since the last capture, that
+ * after an error the recorder is stopped only once the capture is out, also
+ * when the stream port is slow, and that a capture the stream port takes none
+ * of is given up after TRC_CFG_FLIGHT_RECORDER_STOP_ATTEMPTS attempts.
+ */
+
+#include <trcRecorder.h>
+#include <trcPsfDecoder.h>
+#include <trcHostTest.h>
+
+/* More events than fit in the internal buffer */
+#define TEST_MAX_EVENTS 10000u
+
+static TracePsfDecoder_t xDecoder;
+
+/* The numbers of the task ready events in the capture */
+static uint64_t ulFirstReady = 0u;
+static uint64_t ulLastReady = 0u;
+static uint32_t uiReadyEvents = 0u;
+
+static int32_t prvOnEvent(void* pvUser, const TracePsfDecoderEvent_t* pxEvent)
+{
+	(void)pvUser;
+
+	if (((pxEvent->uiCode & 0xFFFu) == (uint32_t)(PSF_EVENT_TASK_READY)) && (pxEvent->uiParameterCount == 1u))
+	{
+		if (uiReadyEvents == 0u)
+		{
+			ulFirstReady = pxEvent->ulParameters[0];
+		}
+		ulLastReady = pxEvent->ulParameters[0];
+		uiReadyEvents++;
+	}
+
+	return 0;
+}
+
+static void prvDecode(void)
+{
+	ulFirstReady = 0u;
+	ulLastReady = 0u;
+	uiReadyEvents = 0u;
+	TRC_TEST_CHECK(xHostTestDecodeCapture(&xDecoder, prvOnEvent, (void*)0) == 0);
+	TRC_TEST_CHECK(xDecoder.uiTruncatedBytes == 0u);
+}
+
+static uint32_t prvState(void)
+{
+	uint32_t uiState = 0xFFu;
+
+	TRC_TEST_CHECK(xTraceFlightRecorderGetState(&uiState) == TRC_SUCCESS);
+
+	return uiState;
+}
+
+static uint32_t prvCaptureSize(void)
+{
+	const uint8_t* puiData = (const uint8_t*)0;
+	uint32_t uiSize = 0u;
+
+	TRC_TEST_CHECK(xTraceStreamPortCaptureGet(&puiData, &uiSize) == TRC_SUCCESS);
+
+	return uiSize;
+}
+
+/* Stores task ready events uiFirst to uiLast */
+static void prvStore(uint32_t uiFirst, uint32_t uiLast)
+{
+	uint32_t i;
+
+	for (i = uiFirst; i <= uiLast; i++)
+	{
+		(void)xTraceTaskReady((void*)(uintptr_t)i);
+	}
+}
+
+/* Transfers the capture, which arms the flight recorder again */
+static void prvTransfer(void)
+{
+	uint32_t i;
+
+	TRC_TEST_CHECK(prvState() == TRC_FLIGHT_RECORDER_STATE_DRAINING);
+	for (i = 0u; (i < 100u) && (prvState() == TRC_FLIGHT_RECORDER_STATE_DRAINING); i++)
+	{
+		TRC_TEST_CHECK(xTraceTzCtrl() == TRC_SUCCESS);
+	}
+	TRC_TEST_CHECK(prvState() == TRC_FLIGHT_RECORDER_STATE_ARMED);
+}
+
+/* Enables the recorder and transfers the header */
+static void prvStart(void)
+{
+	(void)xTraceStreamPortCaptureSetWriteLimit(TRC_STREAM_PORT_CAPTURE_UNLIMITED);
+	TRC_TEST_CHECK(xTraceEnable(TRC_START) == TRC_SUCCESS);
+	prvTransfer();
+}
+
+int main(void)
+{
+	uint32_t uiSize;
+	uint32_t i;
+
+	TRC_TEST_CHECK(xTraceInitialize() == TRC_SUCCESS);
+	prvStart();
+
+	/* Nothing is transferred while armed */
+	uiSize = prvCaptureSize();
+	prvStore(1u, 2000u);
+	TRC_TEST_CHECK(xTraceTzCtrl() == TRC_SUCCESS);
+	TRC_TEST_CHECK(prvCaptureSize() == uiSize);
+
+	/* The capture holds the events before and after the trigger */
+	TRC_TEST_CHECK(xTraceFlightRecorderTrigger() == TRC_SUCCESS);
+	TRC_TEST_CHECK(prvState() == TRC_FLIGHT_RECORDER_STATE_TRIGGERED);
+	for (i = 2001u; (i < 2001u + TEST_MAX_EVENTS) && (prvState() == TRC_FLIGHT_RECORDER_STATE_TRIGGERED); i++)
+	{
+		prvStore(i, i);
+	}
+	prvTransfer();
+	prvDecode();
+	TRC_TEST_CHECK(ulFirstReady > 1u);
+	TRC_TEST_CHECK(ulFirstReady < 2001u);
+	/* Ends with the event that completed the post-trigger bytes */
+	TRC_TEST_CHECK(ulLastReady == (uint64_t)(i - 1u));
+	TRC_TEST_CHECK(ulLastReady - ulFirstReady + 1u == (uint64_t)uiReadyEvents);
+
+	/* Disabling while armed transfers the events since the capture */
+	prvStore(20001u, 20100u);
+	TRC_TEST_CHECK(xTraceDisable() == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceIsRecorderEnabled() == 0);
+	prvDecode();
+	TRC_TEST_CHECK(ulLastReady == 20100u);
+
+	/* After an error, a slow stream port gets the whole capture before the stop */
+	prvStart();
+	prvStore(30001u, 32000u);
+	(void)xTraceStreamPortCaptureSetWriteLimit(16u);
+	TRC_TEST_CHECK(xTraceError(TRC_ERROR_STREAM_PORT_WRITE) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceIsRecorderEnabled() == 1);
+	for (i = 0u; (i < TEST_MAX_EVENTS) && (xTraceIsRecorderEnabled() == 1); i++)
+	{
+		TRC_TEST_CHECK(xTraceTzCtrl() == TRC_SUCCESS);
+	}
+	TRC_TEST_CHECK(i > (uint32_t)(TRC_CFG_FLIGHT_RECORDER_STOP_ATTEMPTS));
+	TRC_TEST_CHECK(xTraceIsRecorderEnabled() == 0);
+	prvDecode();
+	TRC_TEST_CHECK(ulLastReady == 32000u);
+
+	/* A stream port that takes nothing, the capture is given up */
+	TRC_TEST_CHECK(xTraceErrorClear() == TRC_SUCCESS);
+	prvStart();
+	prvStore(40001u, 40100u);
+	(void)xTraceStreamPortCaptureSetWriteLimit(0u);
+	TRC_TEST_CHECK(xTraceError(TRC_ERROR_STREAM_PORT_WRITE) == TRC_SUCCESS);
+	for (i = 1u; i < (uint32_t)(TRC_CFG_FLIGHT_RECORDER_STOP_ATTEMPTS); i++)
+	{
+		TRC_TEST_CHECK(xTraceTzCtrl() == TRC_SUCCESS);
+	}
+	TRC_TEST_CHECK(xTraceIsRecorderEnabled() == 1);
+	TRC_TEST_CHECK(xTraceTzCtrl() == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceIsRecorderEnabled() == 0);
+
+	/* Also when disabled while armed */
+	TRC_TEST_CHECK(xTraceErrorClear() == TRC_SUCCESS);
+	prvStart();
+	prvStore(50001u, 50100u);
+	(void)xTraceStreamPortCaptureSetWriteLimit(0u);
+	TRC_TEST_CHECK(xTraceDisable() == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceIsRecorderEnabled() == 0);
+
+	(void)xTraceStreamPortCaptureSetWriteLimit(TRC_STREAM_PORT_CAPTURE_UNLIMITED);
+	prvDecode();
+	TRC_TEST_CHECK(ulLastReady == 32000u);
+
+	return iHostTestDone("trcTestFlightRecorder");
+}
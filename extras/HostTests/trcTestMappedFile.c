@@ -0,0 +1,131 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Tests the MappedFile stream port, with small extents and a file size limit
+ * to make extending the file fail. Checks that the trace is recovered with
+ * extras/MappedFileRecovery while it is written, that the port counts the
+ * dropped events and tries again until the file can be extended, and that
+ * the recovered trace is then a valid stream where only the dropped events
+ * are missing.
+ */
+
+#include <trcRecorder.h>
+#include <trcPsfDecoder.h>
+#include <trcMappedFileRecovery.h>
+#include <trcHostTest.h>
+#include <signal.h>
+#include <sys/resource.h>
+
+#define TEST_RECOVERED_FILE "trcTestMappedFileRecovered.psf"
+
+static TracePsfDecoder_t xDecoder;
+
+static void prvPrint(TraceStringHandle_t xChannel, uint32_t uiCount)
+{
+	uint32_t i;
+
+	for (i = 0u; i < uiCount; i++)
+	{
+		(void)xTracePrintF(xChannel, "%d", (int32_t)i);
+	}
+}
+
+static uint64_t prvMissingEvents(void)
+{
+	uint64_t ulMissing = 0u;
+	uint32_t i;
+
+	for (i = 0u; i < TRC_PSF_DECODER_MAX_CORES; i++)
+	{
+		ulMissing += xDecoder.xCores[i].ulMissingEvents;
+	}
+
+	return ulMissing;
+}
+
+int main(void)
+{
+	TraceMappedFileInfo_t xInfo;
+	TraceStringHandle_t xChannel;
+	struct rlimit xLimit;
+	rlim_t xSavedLimit;
+	uint32_t uiDropped;
+	uint32_t i;
+
+	/* Exceeding the file size limit fails with EFBIG instead */
+	(void)signal(SIGXFSZ, SIG_IGN);
+
+	TRC_TEST_CHECK(xTraceInitialize() == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceEnable(TRC_START) == TRC_SUCCESS);
+	TRC_TEST_CHECK(pxStreamPortMappedFile->puiWindow != 0);
+	TRC_TEST_CHECK(xTraceStringRegister("MappedFile", &xChannel) == TRC_SUCCESS);
+
+	/* Recovered while tracing, the header has the committed data */
+	prvPrint(xChannel, 100u);
+	TRC_TEST_CHECK(xTraceMappedFileRecover(TRC_CFG_STREAM_PORT_TRACE_FILE, TEST_RECOVERED_FILE, &xInfo) == TRC_MAPPED_FILE_RECOVERY_OK);
+	TRC_TEST_CHECK(xInfo.uiVersion == TRC_STREAM_PORT_MAPPED_FILE_VERSION);
+	TRC_TEST_CHECK(xInfo.uiClosed == 0u);
+	TRC_TEST_CHECK(xInfo.uiDroppedEvents == 0u);
+	TRC_TEST_CHECK(xInfo.ulCommitted == pxStreamPortMappedFile->ulCommitted);
+	TRC_TEST_CHECK(xInfo.ulFileSize >= (uint64_t)(TRC_CFG_STREAM_PORT_MAPPED_FILE_EXTENT_SIZE));
+	TRC_TEST_CHECK(xTracePsfDecoderInitialize(&xDecoder, (TracePsfDecoderOnEvent_t)0, (void*)0) == 0);
+	TRC_TEST_CHECK(xTracePsfDecoderDecodeFile(&xDecoder, TEST_RECOVERED_FILE) == 0);
+	TRC_TEST_CHECK(xDecoder.uiStarts == 1u);
+	TRC_TEST_CHECK(xDecoder.xCores[0].ulEvents >= 100u);
+	TRC_TEST_CHECK(xDecoder.xCores[0].ulGaps == 0u);
+
+	/* The file can't be extended past its current size */
+	TRC_TEST_CHECK(getrlimit(RLIMIT_FSIZE, &xLimit) == 0);
+	xSavedLimit = xLimit.rlim_cur;
+	xLimit.rlim_cur = (rlim_t)(TRC_STREAM_PORT_MAPPED_FILE_HEADER_SIZE + pxStreamPortMappedFile->ulAllocated);
+	TRC_TEST_CHECK(setrlimit(RLIMIT_FSIZE, &xLimit) == 0);
+
+	for (i = 0u; (i < 1000000u) && (pxStreamPortMappedFile->uiFailures == 0u); i++)
+	{
+		prvPrint(xChannel, 1u);
+	}
+	TRC_TEST_CHECK(pxStreamPortMappedFile->uiFailures == 1u);
+	TRC_TEST_CHECK(pxStreamPortMappedFile->puiWindow == 0);
+
+	/* Tried again every TRC_CFG_STREAM_PORT_MAPPED_FILE_RETRY_INTERVAL events, still failing */
+	prvPrint(xChannel, 3u * (TRC_CFG_STREAM_PORT_MAPPED_FILE_RETRY_INTERVAL) + 3u);
+	TRC_TEST_CHECK(pxStreamPortMappedFile->uiFailures == 4u);
+	TRC_TEST_CHECK(pxStreamPortMappedFile->uiFailing == 1u);
+	TRC_TEST_CHECK(pxStreamPortMappedFile->puiWindow == 0);
+	TRC_TEST_CHECK(pxStreamPortMappedFile->uiDroppedEvents >= 3u * (TRC_CFG_STREAM_PORT_MAPPED_FILE_RETRY_INTERVAL));
+	TRC_TEST_CHECK(xTraceMappedFileRead(TRC_CFG_STREAM_PORT_TRACE_FILE, &xInfo) == TRC_MAPPED_FILE_RECOVERY_OK);
+	TRC_TEST_CHECK(xInfo.uiDroppedEvents == pxStreamPortMappedFile->uiDroppedEvents);
+	TRC_TEST_CHECK(xInfo.ulCommitted == pxStreamPortMappedFile->ulCommitted);
+
+	/* Space again, the next retry succeeds */
+	xLimit.rlim_cur = xSavedLimit;
+	TRC_TEST_CHECK(setrlimit(RLIMIT_FSIZE, &xLimit) == 0);
+	prvPrint(xChannel, (TRC_CFG_STREAM_PORT_MAPPED_FILE_RETRY_INTERVAL) + 1u);
+	TRC_TEST_CHECK(pxStreamPortMappedFile->puiWindow != 0);
+	TRC_TEST_CHECK(pxStreamPortMappedFile->uiFailing == 0u);
+	uiDropped = pxStreamPortMappedFile->uiDroppedEvents;
+	prvPrint(xChannel, 100u);
+	TRC_TEST_CHECK(pxStreamPortMappedFile->uiDroppedEvents == uiDropped);
+
+	TRC_TEST_CHECK(xTraceDisable() == TRC_SUCCESS);
+
+	/* The header is kept, only the dropped events are missing */
+	TRC_TEST_CHECK(xTraceMappedFileRecover(TRC_CFG_STREAM_PORT_TRACE_FILE, TEST_RECOVERED_FILE, &xInfo) == TRC_MAPPED_FILE_RECOVERY_OK);
+	TRC_TEST_CHECK(xInfo.uiClosed == 1u);
+	TRC_TEST_CHECK(xInfo.uiDroppedEvents == uiDropped);
+	TRC_TEST_CHECK(xInfo.ulFileSize == (uint64_t)(TRC_STREAM_PORT_MAPPED_FILE_HEADER_SIZE) + xInfo.ulCommitted);
+	TRC_TEST_CHECK(xTracePsfDecoderInitialize(&xDecoder, (TracePsfDecoderOnEvent_t)0, (void*)0) == 0);
+	TRC_TEST_CHECK(xTracePsfDecoderDecodeFile(&xDecoder, TEST_RECOVERED_FILE) == 0);
+	TRC_TEST_CHECK(xDecoder.uiStarts == 1u);
+	TRC_TEST_CHECK(prvMissingEvents() > 0u);
+	TRC_TEST_CHECK(prvMissingEvents() <= uiDropped);
+
+	/* A plain .psf file has no recovery header */
+	TRC_TEST_CHECK(xTraceMappedFileRead(TEST_RECOVERED_FILE, &xInfo) == TRC_MAPPED_FILE_RECOVERY_NO_HEADER);
+
+	return iHostTestDone("trcTestMappedFile");
+}
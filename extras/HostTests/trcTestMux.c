@@ -0,0 +1,138 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Tests the Multiplexer stream port with a small ring buffer and two memory
+ * sinks: the primary, and a secondary that takes only a few bytes per call
+ * and is overrun. Checks that the secondary sink loses whole events, and that
+ * whenever it is in the middle of an event, its output without the
+ * uiPartialEventBytes at the end is a valid stream with no incomplete event.
+ */
+
+#include <trcRecorder.h>
+#include <trcPsfDecoder.h>
+#include <trcHostTest.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_SINK_SIZE (4u * 1024u * 1024u)
+#define TEST_SLOW_MAX_WRITE 301u
+
+typedef struct TestMemorySink
+{
+	uint8_t* puiData;
+	uint32_t uiSize;
+	uint32_t uiMaxWrite;			/* 0 for no limit */
+} TestMemorySink_t;
+
+static TestMemorySink_t xPrimary;
+static TestMemorySink_t xSlow;
+static TracePsfDecoder_t xDecoder;
+
+static traceResult prvWrite(void* pvContext, void* pvData, uint32_t uiSize, int32_t* piBytesWritten)
+{
+	TestMemorySink_t* pxSink = (TestMemorySink_t*)pvContext;
+
+	if ((pxSink->uiMaxWrite != 0u) && (uiSize > pxSink->uiMaxWrite))
+	{
+		uiSize = pxSink->uiMaxWrite;
+	}
+
+	if (uiSize > TEST_SINK_SIZE - pxSink->uiSize)
+	{
+		return TRC_FAIL;
+	}
+
+	memcpy(&pxSink->puiData[pxSink->uiSize], pvData, uiSize);
+	pxSink->uiSize += uiSize;
+	*piBytesWritten = (int32_t)uiSize;
+
+	return TRC_SUCCESS;
+}
+
+static void prvAddSink(TestMemorySink_t* pxSink, uint32_t uiMaxWrite)
+{
+	TraceStreamPortMuxSink_t xSink;
+
+	pxSink->puiData = (uint8_t*)malloc(TEST_SINK_SIZE);
+	pxSink->uiSize = 0u;
+	pxSink->uiMaxWrite = uiMaxWrite;
+	TRC_TEST_CHECK(pxSink->puiData != (uint8_t*)0);
+
+	xSink.xWrite = prvWrite;
+	xSink.xRead = 0;
+	xSink.pvContext = pxSink;
+	TRC_TEST_CHECK(xTraceStreamPortMuxAddSink(&xSink) == TRC_SUCCESS);
+}
+
+/* Decodes the first uiSize bytes of a sink's output, which can end before
+ * the first event */
+static void prvDecode(const TestMemorySink_t* pxSink, uint32_t uiSize)
+{
+	TRC_TEST_CHECK(xTracePsfDecoderInitialize(&xDecoder, (TracePsfDecoderOnEvent_t)0, (void*)0) == 0);
+	TRC_TEST_CHECK(xTracePsfDecoderFeed(&xDecoder, pxSink->puiData, uiSize) == 0);
+	(void)xTracePsfDecoderFinish(&xDecoder);
+}
+
+int main(void)
+{
+	TraceStreamPortMuxSinkStatistics_t xStatistics;
+	TraceStringHandle_t xChannel;
+	uint32_t uiPartial = 0u;
+	uint32_t i, j;
+
+	TRC_TEST_CHECK(xTraceInitialize() == TRC_SUCCESS);
+	prvAddSink(&xPrimary, 0u);
+	prvAddSink(&xSlow, TEST_SLOW_MAX_WRITE);
+	TRC_TEST_CHECK(xTraceEnable(TRC_START) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceStringRegister("Mux", &xChannel) == TRC_SUCCESS);
+
+	for (i = 0u; i < 200u; i++)
+	{
+		for (j = 0u; j < 100u; j++)
+		{
+			(void)xTracePrintF(xChannel, "%d %d", (int32_t)i, (int32_t)j);
+		}
+		TRC_TEST_CHECK(xTraceTzCtrl() == TRC_SUCCESS);
+
+		/* Without the partial event, the output ends with a whole event */
+		TRC_TEST_CHECK(xTraceStreamPortMuxGetSinkStatistics(1u, &xStatistics) == TRC_SUCCESS);
+		TRC_TEST_CHECK(xStatistics.uiBytesWritten == xSlow.uiSize);
+		TRC_TEST_CHECK(xStatistics.uiPartialEventBytes <= xSlow.uiSize);
+		prvDecode(&xSlow, xSlow.uiSize - xStatistics.uiPartialEventBytes);
+		TRC_TEST_CHECK(xDecoder.uiStarts == 1u);
+		TRC_TEST_CHECK(xDecoder.uiTruncatedBytes == 0u);
+
+		if (xStatistics.uiPartialEventBytes > 0u)
+		{
+			uiPartial++;
+
+			/* With it, that event is incomplete */
+			prvDecode(&xSlow, xSlow.uiSize);
+			TRC_TEST_CHECK(xDecoder.uiTruncatedBytes == xStatistics.uiPartialEventBytes);
+		}
+	}
+	TRC_TEST_CHECK(uiPartial > 0u);
+	TRC_TEST_CHECK(xStatistics.uiLostEvents > 0u);
+	TRC_TEST_CHECK(xStatistics.uiFailed == 0u);
+	TRC_TEST_CHECK(xDecoder.xCores[0].ulMissingEvents > 0u);
+
+	/* The primary sink keeps up and is never in the middle of an event */
+	TRC_TEST_CHECK(xTraceStreamPortMuxGetSinkStatistics(0u, &xStatistics) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xStatistics.uiLostEvents == 0u);
+	TRC_TEST_CHECK(xStatistics.uiPartialEventBytes == 0u);
+	prvDecode(&xPrimary, xPrimary.uiSize);
+	TRC_TEST_CHECK(xDecoder.uiTruncatedBytes == 0u);
+	TRC_TEST_CHECK(xDecoder.xCores[0].ulEvents >= 200u * 100u);
+	TRC_TEST_CHECK(xDecoder.xCores[0].ulGaps == 0u);
+
+	TRC_TEST_CHECK(xTraceDisable() == TRC_SUCCESS);
+
+	free(xPrimary.puiData);
+	free(xSlow.puiData);
+
+	return iHostTestDone("trcTestMux");
+}
@@ -0,0 +1,140 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Tests the self-profiling (TRC_CFG_SELF_PROFILING) with the internal buffer
+ * and a short report interval. Checks that each stored event is measured by
+ * the event create, allocate and commit probes, that each xTraceTzCtrl()
+ * transfer and entry lookup is measured, that the statistics agree with
+ * their histogram, that the report is stored as one user event per probe
+ * every TRC_CFG_SELF_PROFILING_REPORT_INTERVAL calls of xTraceTzCtrl(), and
+ * that a reset clears the statistics.
+ */
+
+#include <trcRecorder.h>
+#include <trcPsfDecoder.h>
+#include <trcHostTest.h>
+
+#define TEST_EVENTS 100u
+
+static TracePsfDecoder_t xDecoder;
+static TraceStringHandle_t xChannel;
+
+/* User events on other channels than the test's */
+static uint32_t uiReports = 0u;
+
+static int32_t prvOnEvent(void* pvUser, const TracePsfDecoderEvent_t* pxEvent)
+{
+	const uint32_t uiCode = pxEvent->uiCode & 0xFFFu;
+
+	(void)pvUser;
+
+	if ((uiCode >= (uint32_t)(PSF_EVENT_USER_EVENT)) && (uiCode < (uint32_t)(PSF_EVENT_USER_EVENT_FIXED) + 8u) &&
+		(pxEvent->ulParameters[0] != (uint64_t)xChannel))
+	{
+		uiReports++;
+	}
+
+	return 0;
+}
+
+static uint32_t prvReports(void)
+{
+	uiReports = 0u;
+	TRC_TEST_CHECK(xHostTestDecodeCapture(&xDecoder, prvOnEvent, (void*)0) == 0);
+	TRC_TEST_CHECK(xDecoder.uiTruncatedBytes == 0u);
+	TRC_TEST_CHECK(xDecoder.xCores[0].ulGaps == 0u);
+
+	return uiReports;
+}
+
+static void prvGet(TraceProfilingProbe_t xProbe, TraceProfilingStats_t* pxStats)
+{
+	uint32_t uiCount = 0u;
+	uint32_t i;
+
+	TRC_TEST_CHECK(xTraceProfilingGet(xProbe, 0u, pxStats) == TRC_SUCCESS);
+
+	/* The statistics agree with the histogram */
+	for (i = 0u; i < TRC_PROFILING_BUCKETS; i++)
+	{
+		uiCount += pxStats->auiHistogram[i];
+	}
+	TRC_TEST_CHECK(uiCount == pxStats->uiCount);
+	if (pxStats->uiCount > 0u)
+	{
+		TRC_TEST_CHECK(pxStats->uiMin <= pxStats->uiMax);
+		TRC_TEST_CHECK(pxStats->ullSum >= (uint64_t)pxStats->uiMin * pxStats->uiCount);
+		TRC_TEST_CHECK(pxStats->ullSum <= (uint64_t)pxStats->uiMax * pxStats->uiCount);
+	}
+}
+
+int main(void)
+{
+	TraceProfilingStats_t xCreate, xAllocate, xCommit, xStats;
+	uint32_t i;
+
+	TRC_TEST_CHECK(xTraceInitialize() == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceEnable(TRC_START) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceStringRegister("Profiling", &xChannel) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceProfilingReset() == TRC_SUCCESS);
+	prvGet(TRC_PROFILING_EVENT_CREATE, &xStats);
+	TRC_TEST_CHECK(xStats.uiCount == 0u);
+	TRC_TEST_CHECK(xStats.uiMin == 0xFFFFFFFFUL);
+
+	/* Each event is measured by the three event probes */
+	for (i = 0u; i < TEST_EVENTS; i++)
+	{
+		TRC_TEST_CHECK(xTracePrintF(xChannel, "%d", (int32_t)i) == TRC_SUCCESS);
+	}
+	prvGet(TRC_PROFILING_EVENT_CREATE, &xCreate);
+	prvGet(TRC_PROFILING_ALLOCATE, &xAllocate);
+	prvGet(TRC_PROFILING_COMMIT, &xCommit);
+	TRC_TEST_CHECK(xCreate.uiCount == TEST_EVENTS);
+	TRC_TEST_CHECK(xAllocate.uiCount == TEST_EVENTS);
+	TRC_TEST_CHECK(xCommit.uiCount == TEST_EVENTS);
+	TRC_TEST_CHECK(xAllocate.ullSum <= xCreate.ullSum);
+
+	/* Entry lookups */
+	TRC_TEST_CHECK(xTraceTaskRegisterWithoutHandle((void*)0x100, "Task", 1u) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceTaskSetPriorityWithoutHandle((void*)0x100, 2u) == TRC_SUCCESS);
+	prvGet(TRC_PROFILING_ENTRY_FIND, &xStats);
+	TRC_TEST_CHECK(xStats.uiCount > 0u);
+
+	/* One transfer per xTraceTzCtrl(), no report until the interval is reached */
+	for (i = 1u; i < (uint32_t)(TRC_CFG_SELF_PROFILING_REPORT_INTERVAL); i++)
+	{
+		TRC_TEST_CHECK(xTraceTzCtrl() == TRC_SUCCESS);
+	}
+	prvGet(TRC_PROFILING_TRANSFER, &xStats);
+	TRC_TEST_CHECK(xStats.uiCount == (uint32_t)(TRC_CFG_SELF_PROFILING_REPORT_INTERVAL) - 1u);
+	TRC_TEST_CHECK(prvReports() == 0u);
+
+	/* Then one user event per probe, transferred by the next call */
+	TRC_TEST_CHECK(xTraceTzCtrl() == TRC_SUCCESS);
+	TRC_TEST_CHECK(prvReports() == 0u);
+	TRC_TEST_CHECK(xTraceTzCtrl() == TRC_SUCCESS);
+	TRC_TEST_CHECK(prvReports() == (uint32_t)(TRC_PROFILING_PROBE_COUNT));
+
+	/* The next report, transferred by the call after it */
+	for (i = 0u; i < (uint32_t)(TRC_CFG_SELF_PROFILING_REPORT_INTERVAL); i++)
+	{
+		TRC_TEST_CHECK(xTraceTzCtrl() == TRC_SUCCESS);
+	}
+	TRC_TEST_CHECK(prvReports() == 2u * (uint32_t)(TRC_PROFILING_PROBE_COUNT));
+
+	TRC_TEST_CHECK(xTraceProfilingReset() == TRC_SUCCESS);
+	for (i = 0u; i < TRC_PROFILING_PROBE_COUNT; i++)
+	{
+		prvGet((TraceProfilingProbe_t)i, &xStats);
+		TRC_TEST_CHECK(xStats.uiCount == 0u);
+		TRC_TEST_CHECK(xStats.ullSum == 0u);
+	}
+
+	TRC_TEST_CHECK(xTraceDisable() == TRC_SUCCESS);
+
+	return iHostTestDone("trcTestProfiling");
+}
@@ -0,0 +1,96 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Tests the per-core event buffers of the snapshot recorder with two cores.
+ * The current core is uiHostTestCore, set by the test. Checks the minor
+ * version and the secondary block of core 1, that each core stores its
+ * events only in its own buffer, and that vTraceClear clears the buffer of
+ * the calling core at once and that of the other core when it stores its
+ * next event.
+ */
+
+#include <trcRecorder.h>
+#include <trcHostTest.h>
+
+/* TRC_CFG_GET_CURRENT_CORE() of the recorder under test */
+uint32_t uiHostTestCore = 0u;
+
+static EventLogCounters* prvCoreCounters(uint32_t uiCore)
+{
+	if (uiCore == 0u)
+	{
+		return (EventLogCounters*)&RecorderDataPtr->numEvents;
+	}
+
+	return &RecorderDataPtr->coreEventBuffers[uiCore - 1u].counters;
+}
+
+int main(void)
+{
+	TraceStringHandle_t xChannel;
+	traceHandle xTask;
+	uint32_t uiCore0Events;
+	uint32_t uiCore1Events;
+
+	TRC_TEST_CHECK(xTraceInitialize() == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceEnable(TRC_START) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceStringRegister("Cores", &xChannel) == TRC_SUCCESS);
+
+	TRC_TEST_CHECK(RecorderDataPtr->minor_version == 9u);
+	TRC_TEST_CHECK(RecorderDataPtr->SymbolTable.hashBits == (TRC_CFG_SYMBOL_TABLE_HASH_BITS));
+	TRC_TEST_CHECK(RecorderDataPtr->coreEventBuffers[0].bufferID == 2u);
+	TRC_TEST_CHECK(RecorderDataPtr->coreEventBuffers[0].coreID == 1u);
+	TRC_TEST_CHECK(prvCoreCounters(1u)->maxEvents == (TRC_CFG_EVENT_BUFFER_SIZE));
+	TRC_TEST_CHECK(RecorderDataPtr->endOfSecondaryBlocks == 0u);
+
+	/* Core 0 runs the "(startup)" task since xTraceEnable */
+	uiHostTestCore = 0u;
+	TRC_TEST_CHECK(xTracePrint(xChannel, "core 0") == TRC_SUCCESS);
+	uiCore0Events = prvCoreCounters(0u)->numEvents;
+	TRC_TEST_CHECK(uiCore0Events > 0u);
+	TRC_TEST_CHECK(prvCoreCounters(1u)->numEvents == 0u);
+
+	/* Core 1 stores nothing until a task runs on it */
+	uiHostTestCore = 1u;
+	xTask = prvTraceGetObjectHandle(TRACE_CLASS_TASK);
+	prvTraceStoreTaskswitch(xTask);
+	TRC_TEST_CHECK(xTracePrint(xChannel, "core 1") == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTracePrint(xChannel, "core 1") == TRC_SUCCESS);
+	uiCore1Events = prvCoreCounters(1u)->numEvents;
+	TRC_TEST_CHECK(uiCore1Events > 0u);
+	TRC_TEST_CHECK(prvCoreCounters(1u)->nextFreeIndex == uiCore1Events);
+	TRC_TEST_CHECK(prvCoreCounters(0u)->numEvents == uiCore0Events);
+	TRC_TEST_CHECK(RecorderDataPtr->coreEventBuffers[0].eventData[0] != 0u);
+
+	/* Each core keeps its own absolute time */
+	TRC_TEST_CHECK(prvCoreCounters(0u)->frequency == prvCoreCounters(1u)->frequency);
+
+	/* Core 0 clears its buffer at once, core 1 keeps its events until it stores the next one */
+	uiHostTestCore = 0u;
+	vTraceClear();
+	TRC_TEST_CHECK(prvCoreCounters(0u)->numEvents == 0u);
+	TRC_TEST_CHECK(prvCoreCounters(0u)->nextFreeIndex == 0u);
+	TRC_TEST_CHECK(prvCoreCounters(1u)->numEvents == uiCore1Events);
+
+	uiHostTestCore = 1u;
+	TRC_TEST_CHECK(xTracePrint(xChannel, "core 1") == TRC_SUCCESS);
+	TRC_TEST_CHECK(prvCoreCounters(1u)->numEvents > 0u);
+	TRC_TEST_CHECK(prvCoreCounters(1u)->numEvents < uiCore1Events);
+	TRC_TEST_CHECK(prvCoreCounters(1u)->nextFreeIndex == prvCoreCounters(1u)->numEvents);
+	TRC_TEST_CHECK(prvCoreCounters(1u)->absTimeLastEventSecond == 0u);
+	TRC_TEST_CHECK(prvCoreCounters(0u)->numEvents == 0u);
+
+	/* The core that called vTraceClear stores nothing until a task runs on it again */
+	uiHostTestCore = 0u;
+	TRC_TEST_CHECK(xTracePrint(xChannel, "core 0") == TRC_SUCCESS);
+	TRC_TEST_CHECK(prvCoreCounters(0u)->numEvents == 0u);
+	prvTraceStoreTaskswitch(xTask);
+	TRC_TEST_CHECK(xTracePrint(xChannel, "core 0") == TRC_SUCCESS);
+	TRC_TEST_CHECK(prvCoreCounters(0u)->numEvents > 0u);
+
+	return iHostTestDone("trcTestSnapshotCores");
+}
@@ -0,0 +1,174 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Tests xTraceSnapshotExport with two cores, applying the records with the
+ * assembler in extras/SnapshotAssembler. The recorder data is exported in
+ * small pieces while it changes: events on both cores, wrapping the ring
+ * buffer, an object property and vTraceClear, where core 1 clears its buffer
+ * only when it stores its next event. After each export the assembled copy
+ * must be the same as the recorder data. A second cursor that falls behind
+ * must count the overwritten events and still give a complete snapshot.
+ */
+
+#include <trcRecorder.h>
+#include <trcSnapshotAssembler.h>
+#include <trcHostTest.h>
+#include <string.h>
+
+#define EXPORT_BUFFER_SIZE 256u
+
+/* TRC_CFG_GET_CURRENT_CORE() of the recorder under test */
+uint32_t uiHostTestCore = 0u;
+
+static TraceSnapshotExportCursor_t xCursorA;
+static TraceSnapshotExportCursor_t xCursorB;
+static TraceSnapshotAssembler_t xAssemblerA;
+static TraceSnapshotAssembler_t xAssemblerB;
+
+/* Exports until there is nothing left, returns the number of calls */
+static uint32_t prvExport(TraceSnapshotExportCursor_t* pxCursor, TraceSnapshotAssembler_t* pxAssembler)
+{
+	uint32_t auiBuffer[EXPORT_BUFFER_SIZE / 4u];
+	uint32_t uiBytes;
+	uint32_t uiCalls = 0u;
+
+	do
+	{
+		TRC_TEST_CHECK(xTraceSnapshotExport(pxCursor, auiBuffer, sizeof(auiBuffer), &uiBytes) == TRC_SUCCESS);
+		TRC_TEST_CHECK(uiBytes <= sizeof(auiBuffer));
+		TRC_TEST_CHECK(xTraceSnapshotAssemblerFeed(pxAssembler, auiBuffer, uiBytes) == 0);
+		uiCalls++;
+	} while ((uiBytes != 0u) && (uiCalls < 100000u));
+
+	return uiCalls;
+}
+
+/* Compares the assembled copy with the recorder data, except for the symbol
+ * table list heads that are only exported the first time */
+static uint32_t prvSame(const TraceSnapshotAssembler_t* pxAssembler)
+{
+	const uint8_t* puiTarget = (const uint8_t*)RecorderDataPtr;
+	uint32_t uiSkip = (uint32_t)((const uint8_t*)RecorderDataPtr->SymbolTable.latestEntryOfChecksum - puiTarget);
+	uint32_t uiSkipEnd = uiSkip + sizeof(RecorderDataPtr->SymbolTable.latestEntryOfChecksum);
+	uint32_t i;
+
+	if (pxAssembler->uiSize != uiTraceGetTraceBufferSize())
+	{
+		return 0u;
+	}
+
+	for (i = 0u; i < pxAssembler->uiSize; i++)
+	{
+		if (((i < uiSkip) || (i >= uiSkipEnd)) && (pxAssembler->puiData[i] != puiTarget[i]))
+		{
+			printf("first difference at offset %u\n", (unsigned int)i);
+			return 0u;
+		}
+	}
+
+	return 1u;
+}
+
+static void prvPrint(TraceStringHandle_t xChannel, uint32_t uiCount)
+{
+	uint32_t i;
+
+	for (i = 0u; i < uiCount; i++)
+	{
+		(void)xTracePrintF(xChannel, "%d", (int32_t)i);
+	}
+}
+
+int main(void)
+{
+	TraceStringHandle_t xChannel;
+	traceHandle xTask;
+	uint32_t uiObjectOffset;
+	uint32_t i;
+
+	TRC_TEST_CHECK(xTraceInitialize() == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceEnable(TRC_START) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceStringRegister("Export", &xChannel) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceSnapshotAssemblerInitialize(&xAssemblerA) == 0);
+	TRC_TEST_CHECK(xTraceSnapshotAssemblerInitialize(&xAssemblerB) == 0);
+
+	/* A new cursor sends everything, in many small pieces */
+	TRC_TEST_CHECK(xTraceSnapshotExportInit(&xCursorA) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceSnapshotExportInit(&xCursorB) == TRC_SUCCESS);
+	TRC_TEST_CHECK(prvExport(&xCursorA, &xAssemblerA) > 2u);
+	TRC_TEST_CHECK(xTraceSnapshotAssemblerCheck(&xAssemblerA) == TRC_SNAPSHOT_ASSEMBLER_COMPLETE);
+	TRC_TEST_CHECK(xAssemblerA.uiBigEndian == 0u);
+	TRC_TEST_CHECK(prvSame(&xAssemblerA));
+	TRC_TEST_CHECK(prvExport(&xCursorB, &xAssemblerB) > 2u);
+	TRC_TEST_CHECK(prvSame(&xAssemblerB));
+
+	/* Nothing changed, nothing is sent */
+	TRC_TEST_CHECK(prvExport(&xCursorA, &xAssemblerA) == 1u);
+
+	/* Events on both cores */
+	uiHostTestCore = 0u;
+	prvPrint(xChannel, 20u);
+	uiHostTestCore = 1u;
+	xTask = prvTraceGetObjectHandle(TRACE_CLASS_TASK);
+	prvTraceStoreTaskswitch(xTask);
+	prvPrint(xChannel, 20u);
+	(void)prvExport(&xCursorA, &xAssemblerA);
+	TRC_TEST_CHECK(prvSame(&xAssemblerA));
+
+	/* Both ring buffers wrap, cursor A keeps up and cursor B falls behind */
+	for (i = 0u; i < 100u; i++)
+	{
+		uiHostTestCore = i % 2u;
+		prvPrint(xChannel, 10u);
+		(void)prvExport(&xCursorA, &xAssemblerA);
+	}
+	TRC_TEST_CHECK(RecorderDataPtr->bufferIsFull != 0u);
+	TRC_TEST_CHECK(RecorderDataPtr->coreEventBuffers[0].counters.bufferIsFull != 0u);
+	TRC_TEST_CHECK(xCursorA.uiDroppedEvents == 0u);
+	TRC_TEST_CHECK(prvSame(&xAssemblerA));
+
+	/* A changed object property reaches both cursors */
+	uiObjectOffset = (uint32_t)((uint8_t*)RecorderDataPtr->ObjectPropertyTable.objbytes - (uint8_t*)RecorderDataPtr);
+	prvTraceSetPriorityProperty(TRACE_CLASS_TASK, xTask, 7u);
+	(void)prvExport(&xCursorA, &xAssemblerA);
+	TRC_TEST_CHECK(prvSame(&xAssemblerA));
+
+	(void)prvExport(&xCursorB, &xAssemblerB);
+	TRC_TEST_CHECK(xCursorB.uiDroppedEvents > 0u);
+	TRC_TEST_CHECK(xTraceSnapshotAssemblerCheck(&xAssemblerB) == TRC_SNAPSHOT_ASSEMBLER_COMPLETE);
+	TRC_TEST_CHECK(memcmp(&xAssemblerB.puiData[uiObjectOffset], RecorderDataPtr->ObjectPropertyTable.objbytes, sizeof(RecorderDataPtr->ObjectPropertyTable.objbytes)) == 0);
+	TRC_TEST_CHECK(((EventLogCounters*)&xAssemblerB.puiData[(uint8_t*)&RecorderDataPtr->numEvents - (uint8_t*)RecorderDataPtr])->numEvents <= RecorderDataPtr->numEvents);
+
+	/* Core 0 clears its buffer at once, core 1 when it stores its next event */
+	uiHostTestCore = 0u;
+	vTraceClear();
+	(void)prvExport(&xCursorA, &xAssemblerA);
+	TRC_TEST_CHECK(RecorderDataPtr->numEvents == 0u);
+	TRC_TEST_CHECK(prvSame(&xAssemblerA));
+
+	uiHostTestCore = 1u;
+	prvPrint(xChannel, 5u);
+	(void)prvExport(&xCursorA, &xAssemblerA);
+	TRC_TEST_CHECK(RecorderDataPtr->coreEventBuffers[0].counters.bufferIsFull == 0u);
+	TRC_TEST_CHECK(prvSame(&xAssemblerA));
+
+	uiHostTestCore = 0u;
+	prvTraceStoreTaskswitch(xTask);
+	prvPrint(xChannel, 5u);
+	(void)prvExport(&xCursorA, &xAssemblerA);
+	TRC_TEST_CHECK(RecorderDataPtr->numEvents > 0u);
+	TRC_TEST_CHECK(prvSame(&xAssemblerA));
+
+	/* The lagging cursor catches up after the clear */
+	(void)prvExport(&xCursorB, &xAssemblerB);
+	TRC_TEST_CHECK(prvSame(&xAssemblerB));
+
+	vTraceSnapshotAssemblerFree(&xAssemblerA);
+	vTraceSnapshotAssemblerFree(&xAssemblerB);
+
+	return iHostTestDone("trcTestSnapshotExport");
+}
@@ -0,0 +1,50 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Tests the snapshot recorder with two cores and the default
+ * TRC_CFG_SNAPSHOT_CORE_BUFFERS of 0. The current core is uiHostTestCore, set
+ * by the test. Checks that the recorder data keeps minor version 7, and that
+ * both cores store their events in the one event buffer, one after the other.
+ */
+
+#include <trcRecorder.h>
+#include <trcHostTest.h>
+
+/* TRC_CFG_GET_CURRENT_CORE() of the recorder under test */
+uint32_t uiHostTestCore = 0u;
+
+int main(void)
+{
+	TraceStringHandle_t xChannel;
+	uint32_t uiEvents;
+
+	TRC_TEST_CHECK(TRC_SNAPSHOT_CORE_COUNT == 1);
+	TRC_TEST_CHECK(xTraceInitialize() == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceEnable(TRC_START) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceStringRegister("Shared", &xChannel) == TRC_SUCCESS);
+
+	TRC_TEST_CHECK(RecorderDataPtr->minor_version == 7u);
+	TRC_TEST_CHECK(RecorderDataPtr->endOfSecondaryBlocks == 0u);
+
+	/* Both cores store in the same buffer */
+	uiHostTestCore = 0u;
+	TRC_TEST_CHECK(xTracePrint(xChannel, "core 0") == TRC_SUCCESS);
+	uiEvents = RecorderDataPtr->numEvents;
+	TRC_TEST_CHECK(uiEvents > 0u);
+
+	uiHostTestCore = 1u;
+	TRC_TEST_CHECK(xTracePrint(xChannel, "core 1") == TRC_SUCCESS);
+	TRC_TEST_CHECK(RecorderDataPtr->numEvents > uiEvents);
+	TRC_TEST_CHECK(RecorderDataPtr->nextFreeIndex == RecorderDataPtr->numEvents);
+
+	/* vTraceClear clears it at once, whichever core calls it */
+	vTraceClear();
+	TRC_TEST_CHECK(RecorderDataPtr->numEvents == 0u);
+	TRC_TEST_CHECK(RecorderDataPtr->nextFreeIndex == 0u);
+
+	return iHostTestDone("trcTestSnapshotShared");
+}
@@ -0,0 +1,226 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Tests TracePrint::PrintF() (extras/TracePrintCpp). Stores user events with
+ * every kind of argument, decodes the stream and checks that each argument
+ * takes one slot, or two for 64-bit values on 32-bit ports, with its bits and
+ * type tag, that the format string is
+ * stored after them, truncated if too long, and that events without a
+ * channel use the recorder's "Default" channel.
+ */
+
+#include <trcRecorder.h>
+#include <TracePrint.hpp>
+#include <trcHostTest.h>
+#include <string.h>
+
+#define TEST_MAX_EVENTS 16u
+
+typedef struct TestEvent
+{
+	uint32_t uiCode;
+	uint32_t uiSize;
+	uint8_t auiData[TRC_MAX_BLOB_SIZE];
+} TestEvent_t;
+
+enum class TestColor : int16_t
+{
+	Red = -2,
+	Green = 3
+};
+
+static TestEvent_t axEvents[TEST_MAX_EVENTS];
+static uint32_t uiEventCount = 0u;
+
+static int32_t prvOnEvent(void* pvUser, const TracePsfDecoderEvent_t* pxEvent)
+{
+	(void)pvUser;
+
+	if ((pxEvent->uiCode >= PSF_EVENT_USER_EVENT) && (pxEvent->uiCode <= (PSF_EVENT_USER_EVENT + 6u)) && (uiEventCount < TEST_MAX_EVENTS))
+	{
+		axEvents[uiEventCount].uiCode = pxEvent->uiCode;
+		axEvents[uiEventCount].uiSize = pxEvent->uiSize;
+		memcpy(axEvents[uiEventCount].auiData, pxEvent->puiData, pxEvent->uiSize);
+		uiEventCount++;
+	}
+
+	return 0;
+}
+
+static TraceUnsignedBaseType_t prvSlot(const TestEvent_t* pxEvent, uint32_t uiSlot)
+{
+	TraceUnsignedBaseType_t uxValue;
+
+	memcpy(&uxValue, &pxEvent->auiData[sizeof(TraceEvent0_t) + uiSlot * sizeof(TraceUnsignedBaseType_t)], sizeof(uxValue));
+
+	return uxValue;
+}
+
+/* A 64-bit value, in one slot or two */
+static uint64_t prvSlotBits(const TestEvent_t* pxEvent, uint32_t uiSlot)
+{
+	uint64_t ullValue;
+
+	memcpy(&ullValue, &pxEvent->auiData[sizeof(TraceEvent0_t) + uiSlot * sizeof(TraceUnsignedBaseType_t)], sizeof(ullValue));
+
+	return ullValue;
+}
+
+/* The format string follows the channel and the arguments */
+static const char* prvFormat(const TestEvent_t* pxEvent)
+{
+	return (const char*)&pxEvent->auiData[sizeof(TraceEvent0_t) + (pxEvent->uiCode - PSF_EVENT_USER_EVENT) * sizeof(TraceUnsignedBaseType_t)];
+}
+
+/* The type tags follow the null termination of the format string */
+static const uint8_t* prvTags(const TestEvent_t* pxEvent)
+{
+	const char* szFormat = prvFormat(pxEvent);
+
+	return (const uint8_t*)&szFormat[strlen(szFormat) + 1u];
+}
+
+static uint32_t prvArgumentSlots(const TestEvent_t* pxEvent)
+{
+	return pxEvent->uiCode - PSF_EVENT_USER_EVENT - 1u;
+}
+
+static void prvCheckTags(const TestEvent_t* pxEvent, const TracePrintDetail::ArgumentTag* pxTags, uint32_t uiCount)
+{
+	const uint8_t* puiTags = prvTags(pxEvent);
+	uint32_t uiSlots = 0u;
+	uint32_t i;
+
+	/* 64-bit values take two slots on 32-bit ports */
+	for (i = 0u; i < uiCount; i++)
+	{
+		uiSlots += ((pxTags[i] == TracePrintDetail::ArgumentTag::Double) || (pxTags[i] == TracePrintDetail::ArgumentTag::Int64) || (pxTags[i] == TracePrintDetail::ArgumentTag::Uint64)) ?
+			(uint32_t)TracePrintDetail::SlotsFor(sizeof(uint64_t)) : 1u;
+	}
+	TRC_TEST_CHECK(prvArgumentSlots(pxEvent) == uiSlots);
+	TRC_TEST_CHECK(((const uint8_t*)&puiTags[uiCount] - pxEvent->auiData) <= (int32_t)pxEvent->uiSize);
+
+	for (i = 0u; i < uiCount; i++)
+	{
+		TRC_TEST_CHECK(puiTags[i] == (uint8_t)pxTags[i]);
+	}
+}
+
+int main(void)
+{
+	using TracePrintDetail::ArgumentTag;
+
+	static TracePsfDecoder_t xDecoder;
+	TraceStringHandle_t xChannel;
+	TraceStringHandle_t xDefaultChannel = 0;
+	const TestEvent_t* pxEvent;
+	const uint32_t uiWideSlots = (uint32_t)TracePrintDetail::SlotsFor(sizeof(uint64_t));
+	float fValue = 1.5f;
+	double dValue = -2.25;
+	uint32_t uiBits;
+	uint64_t ulBits;
+
+	static_assert(TracePrint::TagOf<int8_t>() == ArgumentTag::Signed, "int8_t");
+	static_assert(TracePrint::TagOf<unsigned int>() == ArgumentTag::Unsigned, "unsigned int");
+	static_assert(TracePrint::TagOf<TestColor>() == ArgumentTag::Signed, "enum");
+	static_assert(TracePrint::TagOf<float>() == ArgumentTag::Float, "float");
+	static_assert(TracePrint::TagOf<double>() == ArgumentTag::Double, "double");
+	static_assert(TracePrint::TagOf<int64_t>() == ArgumentTag::Int64, "int64_t");
+	static_assert(TracePrint::TagOf<uint64_t>() == ArgumentTag::Uint64, "uint64_t");
+	static_assert(TracePrint::TagOf<TraceStringHandle_t>() == ArgumentTag::Pointer, "handle");
+
+	TRC_TEST_CHECK(xTraceEnable(TRC_START) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceStringRegister("Motor", &xChannel) == TRC_SUCCESS);
+
+	TRC_TEST_CHECK(TracePrint::PrintF(xChannel, "i %d u %u", -5, 7u) == TRC_SUCCESS);
+	TRC_TEST_CHECK(TracePrint::PrintF(xChannel, "f %f d %f", fValue, dValue) == TRC_SUCCESS);
+	TRC_TEST_CHECK(TracePrint::PrintF(xChannel, "%d %u %x %s %d", (int8_t)-1, (uint16_t)65535u, 0xABCDu, xChannel, TestColor::Red) == TRC_SUCCESS);
+	TRC_TEST_CHECK(TracePrint::PrintF("no channel") == TRC_SUCCESS);
+	TRC_TEST_CHECK(TracePrint::PrintF(xChannel, "a format string that is far too long to fit in one event with its argument, even on a 64-bit port where an event holds 128 bytes %d", 1) == TRC_SUCCESS);
+	TRC_TEST_CHECK(TracePrint::PrintF(xChannel, "%lld %llu %d", (int64_t)-3, (uint64_t)0x123456789ABCDEF0ULL, 4) == TRC_SUCCESS);
+
+	TRC_TEST_CHECK(xTracePrintGetDefaultChannel(&xDefaultChannel) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xDefaultChannel != 0);
+
+	TRC_TEST_CHECK(xHostTestDecodeCapture(&xDecoder, prvOnEvent, (void*)0) == 0);
+	TRC_TEST_CHECK(xDecoder.xCores[0].ulGaps == 0u);
+
+	if (TRC_TEST_CHECK(uiEventCount == 6u) == 0u)
+	{
+		return iHostTestDone("TracePrint");
+	}
+
+	/* One slot per argument, sign or zero extended */
+	pxEvent = &axEvents[0];
+	TRC_TEST_CHECK(pxEvent->uiCode == PSF_EVENT_USER_EVENT + 3u);
+	TRC_TEST_CHECK(prvSlot(pxEvent, 0u) == (TraceUnsignedBaseType_t)(uintptr_t)xChannel);
+	TRC_TEST_CHECK((TraceBaseType_t)prvSlot(pxEvent, 1u) == -5);
+	TRC_TEST_CHECK(prvSlot(pxEvent, 2u) == 7u);
+	TRC_TEST_CHECK(strcmp(prvFormat(pxEvent), "i %d u %u") == 0);
+	{
+		const ArgumentTag axTags[] = { ArgumentTag::Signed, ArgumentTag::Unsigned };
+		prvCheckTags(pxEvent, axTags, 2u);
+	}
+
+	/* IEEE-754 bit patterns, a double in two slots on 32-bit ports */
+	pxEvent = &axEvents[1];
+	TRC_TEST_CHECK(pxEvent->uiCode == PSF_EVENT_USER_EVENT + 2u + uiWideSlots);
+	memcpy(&uiBits, &fValue, sizeof(uiBits));
+	TRC_TEST_CHECK(prvSlot(pxEvent, 1u) == uiBits);
+	memcpy(&ulBits, &dValue, sizeof(ulBits));
+	TRC_TEST_CHECK(prvSlotBits(pxEvent, 2u) == ulBits);
+	TRC_TEST_CHECK(strcmp(prvFormat(pxEvent), "f %f d %f") == 0);
+	{
+		const ArgumentTag axTags[] = { ArgumentTag::Float, ArgumentTag::Double };
+		prvCheckTags(pxEvent, axTags, 2u);
+	}
+
+	/* Five arguments, each in its own slot so they line up with the format specifiers */
+	pxEvent = &axEvents[2];
+	TRC_TEST_CHECK(pxEvent->uiCode == PSF_EVENT_USER_EVENT + 6u);
+	TRC_TEST_CHECK((TraceBaseType_t)prvSlot(pxEvent, 1u) == -1);
+	TRC_TEST_CHECK(prvSlot(pxEvent, 2u) == 65535u);
+	TRC_TEST_CHECK(prvSlot(pxEvent, 3u) == 0xABCDu);
+	TRC_TEST_CHECK(prvSlot(pxEvent, 4u) == (TraceUnsignedBaseType_t)(uintptr_t)xChannel);
+	TRC_TEST_CHECK((TraceBaseType_t)prvSlot(pxEvent, 5u) == -2);
+	TRC_TEST_CHECK(strcmp(prvFormat(pxEvent), "%d %u %x %s %d") == 0);
+	{
+		const ArgumentTag axTags[] = { ArgumentTag::Signed, ArgumentTag::Unsigned, ArgumentTag::Unsigned, ArgumentTag::Pointer, ArgumentTag::Signed };
+		prvCheckTags(pxEvent, axTags, 5u);
+	}
+
+	/* The recorder's own "Default" channel, not one of its own */
+	pxEvent = &axEvents[3];
+	TRC_TEST_CHECK(pxEvent->uiCode == PSF_EVENT_USER_EVENT + 1u);
+	TRC_TEST_CHECK(prvSlot(pxEvent, 0u) == (TraceUnsignedBaseType_t)(uintptr_t)xDefaultChannel);
+	TRC_TEST_CHECK(strcmp(prvFormat(pxEvent), "no channel") == 0);
+
+	/* Truncated to the largest event, still terminated and with the tag */
+	pxEvent = &axEvents[4];
+	TRC_TEST_CHECK(pxEvent->uiSize == TRC_MAX_BLOB_SIZE);
+	TRC_TEST_CHECK(strncmp(prvFormat(pxEvent), "a format string", 15u) == 0);
+	{
+		const ArgumentTag axTags[] = { ArgumentTag::Signed };
+		prvCheckTags(pxEvent, axTags, 1u);
+	}
+
+	/* 64-bit integers, sign extended, in two slots each on 32-bit ports */
+	pxEvent = &axEvents[5];
+	TRC_TEST_CHECK(pxEvent->uiCode == PSF_EVENT_USER_EVENT + 2u + 2u * uiWideSlots);
+	TRC_TEST_CHECK((int64_t)prvSlotBits(pxEvent, 1u) == -3);
+	TRC_TEST_CHECK(prvSlotBits(pxEvent, 1u + uiWideSlots) == 0x123456789ABCDEF0ULL);
+	TRC_TEST_CHECK((TraceBaseType_t)prvSlot(pxEvent, 1u + 2u * uiWideSlots) == 4);
+	TRC_TEST_CHECK(strcmp(prvFormat(pxEvent), "%lld %llu %d") == 0);
+	{
+		const ArgumentTag axTags[] = { ArgumentTag::Int64, ArgumentTag::Uint64, ArgumentTag::Signed };
+		prvCheckTags(pxEvent, axTags, 3u);
+	}
+
+	vTracePsfDecoderFree(&xDecoder);
+
+	return iHostTestDone("TracePrint");
+}
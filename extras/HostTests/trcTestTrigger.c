@@ -0,0 +1,172 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Tests the trigger rules (TRC_CFG_TRIGGER_RULES), with task ready events as
+ * the triggering events and user events as the events that are stored or
+ * not. Checks that a mark rule stores a mark right before the event that
+ * matches it, on a channel registered at initialization, that a mark rule
+ * that matches the marks themselves stores one mark per event, that start
+ * and stop rules select the events that are stored, that marks are stored
+ * also while stopped, unlike other user events, that a range on a parameter
+ * after TRC_TRIGGER_PARAMETERS is rejected, and that rules uploaded with the
+ * trigger rule commands are used, once if so flagged.
+ */
+
+#include <trcRecorder.h>
+#include <trcPsfDecoder.h>
+#include <trcHostTest.h>
+
+static TracePsfDecoder_t xDecoder;
+static TraceStringHandle_t xChannel;
+
+/* Marks in the capture, and those right before a task ready event */
+static uint32_t uiMarks = 0u;
+static uint32_t uiMarksBeforeReady = 0u;
+static uint32_t uiMarkCode = 0u;
+static uint32_t uiPreviousWasMark = 0u;
+
+static uint32_t prvIsUserEvent(uint32_t uiCode)
+{
+	return ((uiCode >= (uint32_t)(PSF_EVENT_USER_EVENT)) && (uiCode < (uint32_t)(PSF_EVENT_USER_EVENT_FIXED) + 8u)) ? 1u : 0u;
+}
+
+static int32_t prvOnEvent(void* pvUser, const TracePsfDecoderEvent_t* pxEvent)
+{
+	const uint32_t uiCode = pxEvent->uiCode & 0xFFFu;
+	uint32_t uiIsMark = 0u;
+
+	(void)pvUser;
+
+	if ((prvIsUserEvent(uiCode) != 0u) && (pxEvent->ulParameters[0] != (uint64_t)xChannel))
+	{
+		uiIsMark = 1u;
+		uiMarkCode = uiCode;
+		uiMarks++;
+	}
+	else if ((uiCode == (uint32_t)(PSF_EVENT_TASK_READY)) && (uiPreviousWasMark != 0u))
+	{
+		uiMarksBeforeReady++;
+	}
+	else
+	{
+		/* Not counted */
+	}
+	uiPreviousWasMark = uiIsMark;
+
+	return 0;
+}
+
+static void prvDecode(void)
+{
+	uiMarks = 0u;
+	uiMarksBeforeReady = 0u;
+	uiPreviousWasMark = 0u;
+	TRC_TEST_CHECK(xHostTestDecodeCapture(&xDecoder, prvOnEvent, (void*)0) == 0);
+	TRC_TEST_CHECK(xDecoder.uiTruncatedBytes == 0u);
+	TRC_TEST_CHECK(xDecoder.xCores[0].ulGaps == 0u);
+}
+
+static void prvSetRule(TraceTriggerRule_t* pxRule, uint32_t uiEventCode, uint8_t uiAction, uint8_t uiFlags, TraceUnsignedBaseType_t uxHandle)
+{
+	pxRule->uiEventCode = (uint16_t)uiEventCode;
+	pxRule->uiAction = uiAction;
+	pxRule->uiFlags = uiFlags;
+	pxRule->uxHandle = uxHandle;
+	pxRule->uxMin = 0u;
+	pxRule->uxMax = 0u;
+}
+
+/* Queues a command as the host would send it */
+static void prvSendCommand(uint8_t uiCode, uint8_t uiParam1, uint8_t uiParam2, uint8_t uiParam3, uint8_t uiParam4, uint8_t uiParam5)
+{
+	uint8_t uiCommand[8];
+	uint16_t uiChecksum;
+
+	uiCommand[0] = uiCode;
+	uiCommand[1] = uiParam1;
+	uiCommand[2] = uiParam2;
+	uiCommand[3] = uiParam3;
+	uiCommand[4] = uiParam4;
+	uiCommand[5] = uiParam5;
+	uiChecksum = (uint16_t)(0xFFFFu - (uint16_t)(uint8_t)(uiCode + uiParam1 + uiParam2 + uiParam3 + uiParam4 + uiParam5));
+	uiCommand[6] = (uint8_t)(uiChecksum & 0xFFu);
+	uiCommand[7] = (uint8_t)(uiChecksum >> 8);
+
+	TRC_TEST_CHECK(xTraceStreamPortCaptureSendCommand(uiCommand, sizeof(uiCommand)) == TRC_SUCCESS);
+}
+
+int main(void)
+{
+	TraceTriggerRule_t xRules[3];
+	uint64_t ulNames;
+
+	TRC_TEST_CHECK(xTraceInitialize() == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceEnable(TRC_START) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceStringRegister("Trigger", &xChannel) == TRC_SUCCESS);
+	prvDecode();
+	ulNames = xDecoder.ulCodeEvents[PSF_EVENT_OBJ_NAME];
+
+	/* A mark right before the matching event, "#Trigger" is in the entry table */
+	prvSetRule(&xRules[0], PSF_EVENT_TASK_READY, TRC_TRIGGER_ACTION_MARK, TRC_TRIGGER_FLAG_HANDLE, 0x10u);
+	TRC_TEST_CHECK(xTraceTriggerSetRules(xRules, 1u) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceTaskReady((void*)0x11) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceTaskReady((void*)0x10) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceTaskReady((void*)0x10) == TRC_SUCCESS);
+	prvDecode();
+	TRC_TEST_CHECK(uiMarks == 2u);
+	TRC_TEST_CHECK(uiMarksBeforeReady == 2u);
+	TRC_TEST_CHECK(xDecoder.ulCodeEvents[PSF_EVENT_OBJ_NAME] == ulNames);
+
+	/* A rule that matches the marks marks each event once */
+	prvSetRule(&xRules[0], uiMarkCode, TRC_TRIGGER_ACTION_MARK, 0u, 0u);
+	TRC_TEST_CHECK(xTraceTriggerSetRules(xRules, 1u) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTracePrintF(xChannel, "Rule %d", 9) == TRC_SUCCESS);
+	prvDecode();
+	TRC_TEST_CHECK(uiMarks == 3u);
+
+	/* Nothing but system events and marks is stored until the start rule
+	 * fires, and nothing after the stop rule */
+	prvSetRule(&xRules[0], PSF_EVENT_TASK_READY, TRC_TRIGGER_ACTION_START, TRC_TRIGGER_FLAG_HANDLE, 0x20u);
+	prvSetRule(&xRules[1], PSF_EVENT_TASK_READY, TRC_TRIGGER_ACTION_STOP, TRC_TRIGGER_FLAG_HANDLE, 0x21u);
+	prvSetRule(&xRules[2], PSF_EVENT_TASK_READY, TRC_TRIGGER_ACTION_MARK, TRC_TRIGGER_FLAG_HANDLE, 0x22u);
+	TRC_TEST_CHECK(xTraceTriggerSetRules(xRules, 3u) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTracePrint(xChannel, "Before") == TRC_FAIL);
+	TRC_TEST_CHECK(xTraceTaskReady((void*)0x21) == TRC_FAIL);
+	TRC_TEST_CHECK(xTraceTaskReady((void*)0x20) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTracePrint(xChannel, "Started") == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceTaskReady((void*)0x21) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTracePrint(xChannel, "Stopped") == TRC_FAIL);
+	TRC_TEST_CHECK(xTracePrintF(xChannel, "Rule %d", 9) == TRC_FAIL);
+	TRC_TEST_CHECK(xTraceTaskReady((void*)0x22) == TRC_FAIL);
+	TRC_TEST_CHECK(xTraceTaskInstanceFinishedNow() == TRC_SUCCESS);
+
+	/* A range on a parameter the rules don't see is rejected, also uploaded */
+	prvSetRule(&xRules[2], PSF_EVENT_TASK_READY, TRC_TRIGGER_ACTION_MARK, TRC_TRIGGER_FLAG_RANGE | TRC_TRIGGER_FLAG_PARAMETER(5u), 0u);
+	TRC_TEST_CHECK(xTraceTriggerSetRules(xRules, 3u) == TRC_FAIL);
+	prvSendCommand(CMD_TRIGGER_RULE, 0u, TRC_TRIGGER_ACTION_MARK, TRC_TRIGGER_FLAG_RANGE | TRC_TRIGGER_FLAG_PARAMETER(6u), (uint8_t)(PSF_EVENT_TASK_READY & 0xFFu), (uint8_t)((PSF_EVENT_TASK_READY >> 8) & 0xFFu));
+	prvSendCommand(CMD_TRIGGER_RULES_SET, 1u, 0u, 0u, 0u, 0u);
+	TRC_TEST_CHECK(xTraceTzCtrl() == TRC_SUCCESS);
+
+	/* The rules in use are kept, still stopped */
+	TRC_TEST_CHECK(xTraceTaskReady((void*)0x23) == TRC_FAIL);
+
+	/* Uploaded by the host, a mark that fires once */
+	prvSendCommand(CMD_TRIGGER_RULE, 0u, TRC_TRIGGER_ACTION_MARK, TRC_TRIGGER_FLAG_ONCE, (uint8_t)(PSF_EVENT_TASK_READY & 0xFFu), (uint8_t)((PSF_EVENT_TASK_READY >> 8) & 0xFFu));
+	prvSendCommand(CMD_TRIGGER_RULES_SET, 1u, 0u, 0u, 0u, 0u);
+	TRC_TEST_CHECK(xTraceTzCtrl() == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTracePrint(xChannel, "Uploaded") == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceTaskReady((void*)0x30) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceTaskReady((void*)0x30) == TRC_SUCCESS);
+	prvDecode();
+	TRC_TEST_CHECK(uiMarks == 5u);
+	TRC_TEST_CHECK(uiMarksBeforeReady == 3u);
+
+	TRC_TEST_CHECK(xTraceTriggerSetRules(xRules, 0u) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceDisable() == TRC_SUCCESS);
+
+	return iHostTestDone("trcTestTrigger");
+}
@@ -0,0 +1,90 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Tests write combining (trcWriteCombine.c) with two cores and a buffer
+ * smaller than the largest events, which are written directly. Checks that
+ * such an event is written after the rest of an event another core has only
+ * partly written, and that it is dropped and counted while that rest can't
+ * be written, and that the stream stays valid.
+ */
+
+#include <trcRecorder.h>
+#include <trcPsfDecoder.h>
+#include <trcHostTest.h>
+
+/* TRC_CFG_GET_CURRENT_CORE() of the recorder under test */
+uint32_t uiHostTestCore = 0u;
+
+static TracePsfDecoder_t xDecoder;
+
+/* Larger than the write combine buffer */
+static uint32_t uiLargeEvents = 0u;
+
+static int32_t prvOnEvent(void* pvUser, const TracePsfDecoderEvent_t* pxEvent)
+{
+	(void)pvUser;
+
+	if (pxEvent->uiSize > (uint32_t)(TRC_WRITE_COMBINE_BUFFER_SIZE))
+	{
+		TRC_TEST_CHECK(pxEvent->uiCore == 1u);
+		uiLargeEvents++;
+	}
+
+	return 0;
+}
+
+static traceResult prvPrintLarge(TraceStringHandle_t xChannel)
+{
+	return xTracePrintF(xChannel, "%d, with a format string long enough not to fit", 1);
+}
+
+int main(void)
+{
+	TraceStringHandle_t xChannel;
+	TraceBaseType_t xDropped = 0;
+
+	TRC_TEST_CHECK(xTraceInitialize() == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceEnable(TRC_START) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceStringRegister("WriteCombine", &xChannel) == TRC_SUCCESS);
+	uiHostTestCore = 1u;
+	TRC_TEST_CHECK(xTracePrintF(xChannel, "%d", 0) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceWriteCombineFlush() == TRC_SUCCESS);
+
+	/* Core 0's event is only partly written */
+	uiHostTestCore = 0u;
+	TRC_TEST_CHECK(xTracePrintF(xChannel, "%d", 0) == TRC_SUCCESS);
+	(void)xTraceStreamPortCaptureSetWriteLimit(8u);
+	(void)xTraceWriteCombineFlush();
+	TRC_TEST_CHECK(pxTraceWriteCombineData->uiPartialCore == 0u);
+
+	/* The rest of it can't be written, core 1's large event is dropped */
+	(void)xTraceStreamPortCaptureSetWriteLimit(0u);
+	uiHostTestCore = 1u;
+	(void)prvPrintLarge(xChannel);
+	TRC_TEST_CHECK(pxTraceWriteCombineData->uiPartialCore == 0u);
+	TRC_TEST_CHECK(xTraceDiagnosticsGet(TRC_DIAGNOSTICS_WRITE_COMBINE_DROPPED, &xDropped) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xDropped == 1);
+
+	/* Now it can, core 1's large event is written after it */
+	(void)xTraceStreamPortCaptureSetWriteLimit(TRC_STREAM_PORT_CAPTURE_UNLIMITED);
+	TRC_TEST_CHECK(prvPrintLarge(xChannel) == TRC_SUCCESS);
+	TRC_TEST_CHECK(pxTraceWriteCombineData->uiPartialCore == TRC_WRITE_COMBINE_NO_CORE);
+	TRC_TEST_CHECK(xTraceDiagnosticsGet(TRC_DIAGNOSTICS_WRITE_COMBINE_DROPPED, &xDropped) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xDropped == 1);
+
+	uiHostTestCore = 0u;
+	TRC_TEST_CHECK(xTracePrintF(xChannel, "%d", 1) == TRC_SUCCESS);
+	TRC_TEST_CHECK(xTraceWriteCombineFlush() == TRC_SUCCESS);
+
+	TRC_TEST_CHECK(xHostTestDecodeCapture(&xDecoder, prvOnEvent, (void*)0) == 0);
+	TRC_TEST_CHECK(xDecoder.uiTruncatedBytes == 0u);
+	TRC_TEST_CHECK(uiLargeEvents == 1u);
+	TRC_TEST_CHECK(xDecoder.xCores[0].ulGaps == 0u);
+	TRC_TEST_CHECK(xDecoder.xCores[1].ulMissingEvents == 1u);
+
+	return iHostTestDone("trcTestWriteCombine");
+}
@@ -0,0 +1,72 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Host side of the MappedFile stream port. Reads and checks the recovery
+ * header at the start of a trace file, and extracts the committed trace data
+ * as a plain .psf file, e.g. after the traced process crashed. The header is
+ * read in host byte order, i.e. on the host that wrote the file.
+ */
+
+#ifndef TRC_MAPPED_FILE_RECOVERY_H
+#define TRC_MAPPED_FILE_RECOVERY_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TRC_MAPPED_FILE_RECOVERY_MAGIC "TRCMMAP"
+#define TRC_MAPPED_FILE_RECOVERY_HEADER_SIZE 4096u
+#define TRC_MAPPED_FILE_RECOVERY_MAX_VERSION 2u
+
+/* Results of xTraceMappedFileRead and xTraceMappedFileRecover */
+#define TRC_MAPPED_FILE_RECOVERY_OK 0
+#define TRC_MAPPED_FILE_RECOVERY_CANT_READ 1		/* The file couldn't be opened or read */
+#define TRC_MAPPED_FILE_RECOVERY_NO_HEADER 2		/* No magic, e.g. the header was already removed */
+#define TRC_MAPPED_FILE_RECOVERY_BAD_HEADER 3		/* Unknown version or data offset */
+#define TRC_MAPPED_FILE_RECOVERY_TRUNCATED 4		/* The file is shorter than the committed data */
+#define TRC_MAPPED_FILE_RECOVERY_CANT_WRITE 5		/* The output couldn't be written */
+
+typedef struct TraceMappedFileInfo
+{
+	uint32_t uiVersion;
+	uint32_t uiDataOffset;
+	uint64_t ulCommitted;		/* Bytes of trace data after uiDataOffset */
+	uint64_t ulFileSize;
+	uint32_t uiClosed;			/* 1 if the trace ended normally */
+	uint32_t uiDroppedEvents;	/* 0 for version 1 */
+} TraceMappedFileInfo_t;
+
+/**
+ * @brief Reads and checks the recovery header of a trace file.
+ *
+ * @param[in] szFileName Trace file
+ * @param[out] pxInfo The header fields, valid if TRC_MAPPED_FILE_RECOVERY_OK
+ * or TRC_MAPPED_FILE_RECOVERY_TRUNCATED is returned
+ *
+ * @returns One of TRC_MAPPED_FILE_RECOVERY_*
+ */
+int32_t xTraceMappedFileRead(const char* szFileName, TraceMappedFileInfo_t* pxInfo);
+
+/**
+ * @brief Writes the committed trace data of a trace file to a plain .psf
+ * file. Nothing is written unless the header is valid.
+ *
+ * @param[in] szFileName Trace file
+ * @param[in] szOutput The .psf file to write
+ * @param[out] pxInfo The header fields
+ *
+ * @returns One of TRC_MAPPED_FILE_RECOVERY_*
+ */
+int32_t xTraceMappedFileRecover(const char* szFileName, const char* szOutput, TraceMappedFileInfo_t* pxInfo);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
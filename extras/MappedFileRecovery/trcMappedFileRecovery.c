@@ -0,0 +1,148 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Host side of the MappedFile stream port, see trcMappedFileRecovery.h.
+ */
+
+#include <trcMappedFileRecovery.h>
+#include <stdio.h>
+#include <string.h>
+
+#define MAPPED_FILE_RECOVERY_COPY_SIZE (64u * 1024u)
+
+/* The layout of TraceStreamPortMappedFileHeader_t */
+typedef struct TraceMappedFileHeader
+{
+	char cMagic[8];
+	uint32_t uiVersion;
+	uint32_t uiDataOffset;
+	uint64_t ulCommitted;
+	uint32_t uiClosed;
+	uint32_t uiDroppedEvents;
+} TraceMappedFileHeader_t;
+
+static int32_t prvReadHeader(FILE* pxFile, TraceMappedFileInfo_t* pxInfo)
+{
+	TraceMappedFileHeader_t xHeader;
+	long lSize;
+
+	if ((fseek(pxFile, 0L, SEEK_END) != 0) || ((lSize = ftell(pxFile)) < 0L) || (fseek(pxFile, 0L, SEEK_SET) != 0))
+	{
+		return TRC_MAPPED_FILE_RECOVERY_CANT_READ;
+	}
+
+	if (fread(&xHeader, sizeof(xHeader), 1u, pxFile) != 1u)
+	{
+		return TRC_MAPPED_FILE_RECOVERY_NO_HEADER;
+	}
+
+	if (memcmp(xHeader.cMagic, TRC_MAPPED_FILE_RECOVERY_MAGIC, sizeof(xHeader.cMagic)) != 0)
+	{
+		return TRC_MAPPED_FILE_RECOVERY_NO_HEADER;
+	}
+
+	pxInfo->uiVersion = xHeader.uiVersion;
+	pxInfo->uiDataOffset = xHeader.uiDataOffset;
+	pxInfo->ulCommitted = xHeader.ulCommitted;
+	pxInfo->ulFileSize = (uint64_t)lSize;
+	pxInfo->uiClosed = xHeader.uiClosed;
+	pxInfo->uiDroppedEvents = (xHeader.uiVersion >= 2u) ? xHeader.uiDroppedEvents : 0u;
+
+	if ((xHeader.uiVersion == 0u) || (xHeader.uiVersion > TRC_MAPPED_FILE_RECOVERY_MAX_VERSION) ||
+		(xHeader.uiDataOffset != TRC_MAPPED_FILE_RECOVERY_HEADER_SIZE) || (xHeader.uiClosed > 1u))
+	{
+		return TRC_MAPPED_FILE_RECOVERY_BAD_HEADER;
+	}
+
+	if ((uint64_t)lSize < (uint64_t)xHeader.uiDataOffset + xHeader.ulCommitted)
+	{
+		return TRC_MAPPED_FILE_RECOVERY_TRUNCATED;
+	}
+
+	return TRC_MAPPED_FILE_RECOVERY_OK;
+}
+
+int32_t xTraceMappedFileRead(const char* szFileName, TraceMappedFileInfo_t* pxInfo)
+{
+	FILE* pxFile;
+	int32_t iResult;
+
+	(void)memset(pxInfo, 0, sizeof(*pxInfo));
+
+	pxFile = fopen(szFileName, "rb");
+	if (pxFile == (FILE*)0)
+	{
+		return TRC_MAPPED_FILE_RECOVERY_CANT_READ;
+	}
+
+	iResult = prvReadHeader(pxFile, pxInfo);
+
+	(void)fclose(pxFile);
+
+	return iResult;
+}
+
+int32_t xTraceMappedFileRecover(const char* szFileName, const char* szOutput, TraceMappedFileInfo_t* pxInfo)
+{
+	static uint8_t auiBuffer[MAPPED_FILE_RECOVERY_COPY_SIZE];
+	FILE* pxFile;
+	FILE* pxOutput;
+	uint64_t ulLeft;
+	size_t uxSize;
+	int32_t iResult;
+
+	(void)memset(pxInfo, 0, sizeof(*pxInfo));
+
+	pxFile = fopen(szFileName, "rb");
+	if (pxFile == (FILE*)0)
+	{
+		return TRC_MAPPED_FILE_RECOVERY_CANT_READ;
+	}
+
+	iResult = prvReadHeader(pxFile, pxInfo);
+	if (iResult != TRC_MAPPED_FILE_RECOVERY_OK)
+	{
+		(void)fclose(pxFile);
+		return iResult;
+	}
+
+	if (fseek(pxFile, (long)pxInfo->uiDataOffset, SEEK_SET) != 0)
+	{
+		(void)fclose(pxFile);
+		return TRC_MAPPED_FILE_RECOVERY_CANT_READ;
+	}
+
+	pxOutput = fopen(szOutput, "wb");
+	if (pxOutput == (FILE*)0)
+	{
+		(void)fclose(pxFile);
+		return TRC_MAPPED_FILE_RECOVERY_CANT_WRITE;
+	}
+
+	for (ulLeft = pxInfo->ulCommitted; (ulLeft > 0u) && (iResult == TRC_MAPPED_FILE_RECOVERY_OK); ulLeft -= uxSize)
+	{
+		uxSize = (ulLeft < sizeof(auiBuffer)) ? (size_t)ulLeft : sizeof(auiBuffer);
+
+		if (fread(auiBuffer, 1u, uxSize, pxFile) != uxSize)
+		{
+			iResult = TRC_MAPPED_FILE_RECOVERY_CANT_READ;
+		}
+		else if (fwrite(auiBuffer, 1u, uxSize, pxOutput) != uxSize)
+		{
+			iResult = TRC_MAPPED_FILE_RECOVERY_CANT_WRITE;
+		}
+	}
+
+	(void)fclose(pxFile);
+
+	if ((fclose(pxOutput) != 0) && (iResult == TRC_MAPPED_FILE_RECOVERY_OK))
+	{
+		iResult = TRC_MAPPED_FILE_RECOVERY_CANT_WRITE;
+	}
+
+	return iResult;
+}
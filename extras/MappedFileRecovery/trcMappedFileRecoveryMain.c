@@ -0,0 +1,64 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Command line tool for the MappedFile stream port. Checks the recovery
+ * header of a trace file and prints it, and with an output file name also
+ * writes the committed trace data as a plain .psf file.
+ *
+ *	trcMappedFileRecover trace [recovered.psf]
+ */
+
+#include <trcMappedFileRecovery.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static void prvUsage(void)
+{
+	fprintf(stderr,
+		"trcMappedFileRecover trace [recovered.psf]\n"
+		"\n"
+		"trace          A file written by the MappedFile stream port\n"
+		"recovered.psf  The committed trace data to write, if given\n");
+	exit(1);
+}
+
+int main(int argc, char** argv)
+{
+	static const char* const aszResults[] = { "ok", "could not be read", "has no recovery header", "has an invalid recovery header", "is shorter than the committed data", "could not be written" };
+	TraceMappedFileInfo_t xInfo;
+	int32_t iResult;
+
+	if ((argc != 2) && (argc != 3))
+	{
+		prvUsage();
+	}
+
+	if (argc == 3)
+	{
+		iResult = xTraceMappedFileRecover(argv[1], argv[2], &xInfo);
+	}
+	else
+	{
+		iResult = xTraceMappedFileRead(argv[1], &xInfo);
+	}
+
+	if ((iResult == TRC_MAPPED_FILE_RECOVERY_OK) || (iResult == TRC_MAPPED_FILE_RECOVERY_TRUNCATED))
+	{
+		printf("version %u, data offset %u, %llu bytes committed, file size %llu, %s, %u events dropped\n",
+			(unsigned int)xInfo.uiVersion, (unsigned int)xInfo.uiDataOffset,
+			(unsigned long long)xInfo.ulCommitted, (unsigned long long)xInfo.ulFileSize,
+			(xInfo.uiClosed != 0u) ? "closed" : "not closed", (unsigned int)xInfo.uiDroppedEvents);
+	}
+
+	if (iResult != TRC_MAPPED_FILE_RECOVERY_OK)
+	{
+		fprintf(stderr, "%s %s.\n", (iResult == TRC_MAPPED_FILE_RECOVERY_CANT_WRITE) ? argv[2] : argv[1], aszResults[iResult]);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,33 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * The configuration of the Multiplexer stream port for the example target
+ * (trcMuxTarget), used instead of streamports/Multiplexer/config by the host
+ * CMake build. See streamports/Multiplexer/config/trcStreamPortConfig.h.
+ */
+
+#ifndef TRC_STREAM_PORT_CONFIG_H
+#define TRC_STREAM_PORT_CONFIG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Holds a few ms of events from busy threads on the host */
+#ifndef TRC_CFG_STREAM_PORT_MUX_BUFFER_SIZE
+#define TRC_CFG_STREAM_PORT_MUX_BUFFER_SIZE (1024 * 1024)
+#endif
+
+#ifndef TRC_CFG_STREAM_PORT_MUX_SINK_COUNT
+#define TRC_CFG_STREAM_PORT_MUX_SINK_COUNT 3
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRC_STREAM_PORT_CONFIG_H */
@@ -0,0 +1,203 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * A traced program using the Multiplexer stream port on the host, with three
+ * file sinks: the primary, a secondary that keeps up and a secondary that is
+ * slow, it takes at most a given number of bytes per call. Worker threads
+ * generate user events while a TzCtrl thread writes the sinks. The primary and
+ * fast files get every event that isn't dropped, the slow file gets the header
+ * and whole events, with gaps. The slow sink can be in the middle of an event
+ * when the program ends, that part of an event is cut off when it is closed.
+ *
+ *	trcMuxTarget [-t threads] [-e events per thread] [-s slow sink bytes per call] primary fast slow
+ */
+
+#include <trcRecorder.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define MUX_TARGET_MAX_THREADS 64u
+#define MUX_TARGET_SINKS 3u
+#define MUX_TARGET_TZCTRL_PERIOD_US 1000u
+
+typedef struct MuxTargetFileSink
+{
+	FILE* pxFile;
+	uint32_t uiMaxWrite;			/* 0 for no limit */
+} MuxTargetFileSink_t;
+
+static uint32_t uiEventsPerThread = 100000u;
+static volatile uint32_t uiStopTzCtrl = 0u;
+
+static traceResult prvWrite(void* pvContext, void* pvData, uint32_t uiSize, int32_t* piBytesWritten)
+{
+	MuxTargetFileSink_t* pxSink = (MuxTargetFileSink_t*)pvContext;
+
+	if ((pxSink->uiMaxWrite != 0u) && (uiSize > pxSink->uiMaxWrite))
+	{
+		uiSize = pxSink->uiMaxWrite;
+	}
+
+	if (fwrite(pvData, 1, uiSize, pxSink->pxFile) != uiSize)
+	{
+		return TRC_FAIL;
+	}
+
+	*piBytesWritten = (int32_t)uiSize;
+
+	return TRC_SUCCESS;
+}
+
+static void* prvWorker(void* pvArg)
+{
+	TraceStringHandle_t xChannel;
+	uint32_t uiThread = (uint32_t)(uintptr_t)pvArg;
+	uint32_t i;
+
+	(void)xTraceStringRegister("mux", &xChannel);
+
+	for (i = 0u; i < uiEventsPerThread; i++)
+	{
+		/* The thread is a parameter, so that each thread's sequence can be checked */
+		(void)xTracePrintF(xChannel, "%d %d", (int)i, (int)uiThread);
+	}
+
+	return (void*)0;
+}
+
+static void* prvTzCtrl(void* pvArg)
+{
+	(void)pvArg;
+
+	while (uiStopTzCtrl == 0u)
+	{
+		(void)xTraceTzCtrl();
+		(void)usleep(MUX_TARGET_TZCTRL_PERIOD_US);
+	}
+
+	return (void*)0;
+}
+
+static void prvUsage(void)
+{
+	fprintf(stderr, "trcMuxTarget [-t threads] [-e events per thread] [-s slow sink bytes per call] primary fast slow\n");
+	exit(1);
+}
+
+int main(int argc, char** argv)
+{
+	static const char* const szSinkNames[MUX_TARGET_SINKS] = { "primary", "fast", "slow" };
+	MuxTargetFileSink_t xFileSinks[MUX_TARGET_SINKS];
+	TraceStreamPortMuxSinkStatistics_t xStatistics;
+	TraceStreamPortMuxSink_t xSink;
+	pthread_t xTzCtrl, xWorkers[MUX_TARGET_MAX_THREADS];
+	uint32_t uiThreads = 2u;
+	uint32_t uiSlowMaxWrite = 256u;
+	uint32_t uiDroppedEvents = 0u;
+	int iOption;
+	uint32_t i;
+
+	while ((iOption = getopt(argc, argv, "t:e:s:h")) != -1)
+	{
+		switch (iOption)
+		{
+		case 't': uiThreads = (uint32_t)strtoul(optarg, (char**)0, 0); break;
+		case 'e': uiEventsPerThread = (uint32_t)strtoul(optarg, (char**)0, 0); break;
+		case 's': uiSlowMaxWrite = (uint32_t)strtoul(optarg, (char**)0, 0); break;
+		default: prvUsage(); break;
+		}
+	}
+
+	if ((optind != (argc - (int)MUX_TARGET_SINKS)) || (uiThreads == 0u) || (uiThreads > MUX_TARGET_MAX_THREADS) || (uiSlowMaxWrite == 0u))
+	{
+		prvUsage();
+	}
+
+	if (xTraceInitialize() == TRC_FAIL)
+	{
+		return 1;
+	}
+
+	for (i = 0u; i < MUX_TARGET_SINKS; i++)
+	{
+		xFileSinks[i].pxFile = fopen(argv[optind + (int)i], "wb");
+		xFileSinks[i].uiMaxWrite = (i == 2u) ? uiSlowMaxWrite : 0u;
+
+		if (xFileSinks[i].pxFile == (FILE*)0)
+		{
+			fprintf(stderr, "Could not open %s.\n", argv[optind + (int)i]);
+			return 1;
+		}
+
+		xSink.xWrite = prvWrite;
+		xSink.xRead = 0;
+		xSink.pvContext = &xFileSinks[i];
+
+		if (xTraceStreamPortMuxAddSink(&xSink) == TRC_FAIL)
+		{
+			return 1;
+		}
+	}
+
+	if (xTraceEnable(TRC_START) == TRC_FAIL)
+	{
+		return 1;
+	}
+
+	(void)pthread_create(&xTzCtrl, (const pthread_attr_t*)0, prvTzCtrl, (void*)0);
+
+	for (i = 0u; i < uiThreads; i++)
+	{
+		(void)pthread_create(&xWorkers[i], (const pthread_attr_t*)0, prvWorker, (void*)(uintptr_t)i);
+	}
+
+	for (i = 0u; i < uiThreads; i++)
+	{
+		(void)pthread_join(xWorkers[i], (void**)0);
+	}
+
+	(void)xTraceDisable();
+
+	/* Gives TzCtrl time to write what is left to the primary and fast sinks */
+	(void)usleep(100u * MUX_TARGET_TZCTRL_PERIOD_US);
+
+	uiStopTzCtrl = 1u;
+	(void)pthread_join(xTzCtrl, (void**)0);
+
+	(void)xTraceStreamPortMuxGetDroppedEvents(&uiDroppedEvents);
+	printf("%u events from %u threads, %u dropped\n",
+		(unsigned int)(uiThreads * uiEventsPerThread),
+		(unsigned int)uiThreads,
+		(unsigned int)uiDroppedEvents);
+
+	for (i = 0u; i < MUX_TARGET_SINKS; i++)
+	{
+		if (xTraceStreamPortMuxGetSinkStatistics(i, &xStatistics) == TRC_SUCCESS)
+		{
+			if (xStatistics.uiPartialEventBytes > 0u)
+			{
+				/* Only whole events, TzCtrl has stopped */
+				(void)fflush(xFileSinks[i].pxFile);
+				(void)ftruncate(fileno(xFileSinks[i].pxFile), (off_t)(ftell(xFileSinks[i].pxFile) - (long)xStatistics.uiPartialEventBytes));
+			}
+
+			printf("   %s: %u bytes written to %s, %u events lost, %u bytes of an event cut off%s\n",
+				szSinkNames[i],
+				(unsigned int)xStatistics.uiBytesWritten,
+				argv[optind + (int)i],
+				(unsigned int)xStatistics.uiLostEvents,
+				(unsigned int)xStatistics.uiPartialEventBytes,
+				(xStatistics.uiFailed != 0u) ? ", failed" : "");
+		}
+
+		(void)fclose(xFileSinks[i].pxFile);
+	}
+
+	return 0;
+}
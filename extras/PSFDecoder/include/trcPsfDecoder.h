@@ -0,0 +1,207 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Decoder for the streaming PSF format that the streaming recorder writes:
+ * the header, timestamp info and entry table, followed by events, each a
+ * TraceEvent0_t with its parameter count in the top four bits of EventID.
+ * The data is fed in pieces of any size, as read from a file or received, and
+ * is never held whole. It checks the EventCount sequence of every core,
+ * resolves entry symbols and object names, and counts events and bytes per
+ * event code and per core.
+ */
+
+#ifndef TRC_PSF_DECODER_H
+#define TRC_PSF_DECODER_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TRC_PSF_DECODER_MAX_CORES 16u
+#define TRC_PSF_DECODER_EVENT_CODES 4096u		/* Event codes are the low 12 bits of EventID */
+#define TRC_PSF_DECODER_MAX_PARAMETERS 15u
+#define TRC_PSF_DECODER_MAX_SYMBOL_SIZE 4096u
+
+/**
+ * @brief An event, as given to TracePsfDecoderEvent_t.
+ */
+typedef struct TracePsfDecoderEvent
+{
+	uint32_t uiCode;				/* Event code */
+	uint32_t uiCore;
+	uint32_t uiEventCount;			/* EventCount, without the core bits */
+	uint32_t uiTimestamp;
+	uint32_t uiParameterCount;
+	uint32_t uiSize;				/* Bytes, with the header */
+	uint64_t ulParameters[TRC_PSF_DECODER_MAX_PARAMETERS];
+	const uint8_t* puiData;			/* The event as stored, valid during the callback */
+} TracePsfDecoderEvent_t;
+
+/**
+ * @brief Called for every event, in stream order.
+ *
+ * @retval -1 Failed, the decoding is stopped
+ * @retval 0 Success
+ */
+typedef int32_t (*TracePsfDecoderOnEvent_t)(void* pvUser, const TracePsfDecoderEvent_t* pxEvent);
+
+/**
+ * @brief Per core statistics. Every event created increments its core's
+ * EventCount, also those that were dropped, so skips in the sequence are
+ * events missing from the stream.
+ */
+typedef struct TracePsfDecoderCore
+{
+	uint64_t ulEvents;
+	uint64_t ulBytes;
+	uint64_t ulGaps;				/* Skips in the EventCount sequence */
+	uint64_t ulMissingEvents;		/* Events the skips add up to */
+	uint64_t ulFirstTimestamp;
+	uint64_t ulLastTimestamp;		/* Timer wraparounds added */
+	uint32_t uiNextEventCount;
+	uint32_t uiStarted;
+} TracePsfDecoderCore_t;
+
+typedef struct TracePsfDecoderSymbol
+{
+	uint64_t ulAddress;				/* 0 in unused slots */
+	char* szSymbol;
+} TracePsfDecoderSymbol_t;
+
+typedef struct TracePsfDecoder
+{
+	/* Header */
+	uint32_t uiBigEndian;
+	uint32_t uiBaseSize;			/* sizeof(TraceUnsignedBaseType_t), and of pointers */
+	uint32_t uiVersion;				/* PSF format version */
+	uint32_t uiPlatform;			/* Kernel port */
+	uint32_t uiOptions;
+	uint32_t uiCoreCount;
+	char szPlatformCfg[9];
+
+	/* Timestamp info */
+	uint32_t uiTimerType;
+	uint32_t uiTimerPeriod;
+	uint64_t ulTimerFrequency;
+	uint32_t uiOsTickHz;
+
+	/* Entry table */
+	uint32_t uiEntries;
+	uint32_t uiEntrySymbolSize;
+
+	/* Statistics */
+	uint64_t ulBytes;				/* All data fed */
+	uint64_t ulTableBytes;			/* Header, timestamp info and entry tables */
+	uint64_t ulEvents;
+	uint64_t ulInvalidEvents;		/* With a core beyond the core count */
+	uint32_t uiStarts;				/* Headers, the recorder stores them again on each start */
+	uint32_t uiTruncatedBytes;		/* Incomplete event or table at the end */
+	uint64_t ulCodeEvents[TRC_PSF_DECODER_EVENT_CODES];
+	uint64_t ulCodeBytes[TRC_PSF_DECODER_EVENT_CODES];
+	TracePsfDecoderCore_t xCores[TRC_PSF_DECODER_MAX_CORES];
+
+	/* Symbols by address, open addressing */
+	TracePsfDecoderSymbol_t* pxSymbols;
+	uint32_t uiSymbolSlots;
+	uint32_t uiSymbolCount;
+
+	TracePsfDecoderOnEvent_t xOnEvent;
+	void* pvUser;
+
+	/* Where in the stream the decoder is, and what is left of a piece that
+	 * ended in the middle of an event or table */
+	uint32_t uiStage;
+	uint32_t uiRemainingEntries;
+	uint32_t uiPendingSize;
+	uint32_t uiPendingLength;
+	uint8_t auiPending[TRC_PSF_DECODER_MAX_SYMBOL_SIZE + 64u];
+	uint32_t uiFailed;
+} TracePsfDecoder_t;
+
+/**
+ * @brief Initializes a decoder.
+ *
+ * @param[out] pxDecoder Decoder
+ * @param[in] xOnEvent Called for every event, can be null
+ * @param[in] pvUser Passed to xOnEvent
+ *
+ * @retval -1 Failure
+ * @retval 0 Success
+ */
+int32_t xTracePsfDecoderInitialize(TracePsfDecoder_t* pxDecoder, TracePsfDecoderOnEvent_t xOnEvent, void* pvUser);
+
+/**
+ * @brief Decodes the next piece of the stream. Pieces can be of any size, and
+ * can end in the middle of an event.
+ *
+ * @param[in] pxDecoder Decoder
+ * @param[in] pvData Data
+ * @param[in] uiSize Data size
+ *
+ * @retval -1 The stream doesn't start with a PSF header, a table is invalid,
+ * or xOnEvent failed. Further data is ignored.
+ * @retval 0 Success
+ */
+int32_t xTracePsfDecoderFeed(TracePsfDecoder_t* pxDecoder, const void* pvData, uint32_t uiSize);
+
+/**
+ * @brief Ends the stream. Data left of an incomplete event or table is
+ * counted in uiTruncatedBytes.
+ *
+ * @param[in] pxDecoder Decoder
+ *
+ * @retval -1 The stream was invalid, or ended before the first event
+ * @retval 0 Success
+ */
+int32_t xTracePsfDecoderFinish(TracePsfDecoder_t* pxDecoder);
+
+/**
+ * @brief Decodes a PSF file, reading it in chunks, and finishes the stream.
+ *
+ * @param[in] pxDecoder Initialized decoder
+ * @param[in] szPath File
+ *
+ * @retval -1 The file can't be read, or the stream is invalid
+ * @retval 0 Success
+ */
+int32_t xTracePsfDecoderDecodeFile(TracePsfDecoder_t* pxDecoder, const char* szPath);
+
+/**
+ * @brief Gets the symbol of an object, task or string. From the entry table,
+ * or from the latest name event (PSF_EVENT_OBJ_NAME) for the address.
+ *
+ * @param[in] pxDecoder Decoder
+ * @param[in] ulAddress Address, as in event parameters
+ *
+ * @returns The symbol, or null if the address has none
+ */
+const char* szTracePsfDecoderGetSymbol(const TracePsfDecoder_t* pxDecoder, uint64_t ulAddress);
+
+/**
+ * @brief Gets the trace duration, from the earliest to the latest timestamp
+ * of any core.
+ *
+ * @param[in] pxDecoder Decoder
+ *
+ * @returns Seconds, 0 if the timer frequency isn't known
+ */
+double dTracePsfDecoderGetDuration(const TracePsfDecoder_t* pxDecoder);
+
+/**
+ * @brief Frees the symbols.
+ *
+ * @param[in] pxDecoder Decoder
+ */
+void vTracePsfDecoderFree(TracePsfDecoder_t* pxDecoder);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRC_PSF_DECODER_H */
@@ -0,0 +1,729 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Decoder for the streaming PSF format. Endianness and
+ * sizeof(TraceUnsignedBaseType_t) are taken from the header, so this builds
+ * once for all targets. Events are decoded in place from the data fed, only
+ * an event or table split between two pieces is copied.
+ */
+
+#include <trcPsfDecoder.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define PSF_DECODER_IDENTIFIER 0x50534600u		/* TRACE_PSF_ENDIANESS_IDENTIFIER */
+#define PSF_DECODER_HEADER_SIZE 32u				/* TraceHeader_t */
+#define PSF_DECODER_HEADER_OPTION_64BIT 0x8u
+#define PSF_DECODER_ENTRY_STATE_COUNT 3u		/* TRC_ENTRY_TABLE_STATE_COUNT */
+#define PSF_DECODER_MAX_ENTRIES (1024u * 1024u)
+#define PSF_DECODER_EVENT_HEADER_SIZE 8u		/* TraceEvent0_t */
+#define PSF_DECODER_EVENT_OBJ_NAME 0x03u		/* PSF_EVENT_OBJ_NAME, the same in all kernel ports */
+#define PSF_DECODER_READ_SIZE (4u * 1024u * 1024u)
+#define PSF_DECODER_MIN_SYMBOL_SLOTS 256u
+
+#define PSF_DECODER_STAGE_HEADER 0u
+#define PSF_DECODER_STAGE_TIMESTAMP 1u
+#define PSF_DECODER_STAGE_ENTRY_HEADER 2u
+#define PSF_DECODER_STAGE_ENTRIES 3u
+#define PSF_DECODER_STAGE_EVENTS 4u
+
+static uint32_t prvGet16(uint32_t uiBigEndian, const uint8_t* puiData)
+{
+	if (uiBigEndian != 0u)
+	{
+		return ((uint32_t)puiData[0] << 8) | (uint32_t)puiData[1];
+	}
+
+	return ((uint32_t)puiData[1] << 8) | (uint32_t)puiData[0];
+}
+
+static uint32_t prvGet32(uint32_t uiBigEndian, const uint8_t* puiData)
+{
+	if (uiBigEndian != 0u)
+	{
+		return (prvGet16(1u, puiData) << 16) | prvGet16(1u, &puiData[2]);
+	}
+
+	return (prvGet16(0u, &puiData[2]) << 16) | prvGet16(0u, puiData);
+}
+
+static uint64_t prvGet64(uint32_t uiBigEndian, const uint8_t* puiData)
+{
+	if (uiBigEndian != 0u)
+	{
+		return ((uint64_t)prvGet32(1u, puiData) << 32) | prvGet32(1u, &puiData[4]);
+	}
+
+	return ((uint64_t)prvGet32(0u, &puiData[4]) << 32) | prvGet32(0u, puiData);
+}
+
+/* TraceUnsignedBaseType_t, or a pointer */
+static uint64_t prvGetBase(const TracePsfDecoder_t* pxDecoder, const uint8_t* puiData)
+{
+	if (pxDecoder->uiBaseSize == 8u)
+	{
+		return prvGet64(pxDecoder->uiBigEndian, puiData);
+	}
+
+	return prvGet32(pxDecoder->uiBigEndian, puiData);
+}
+
+static uint32_t prvHash(uint64_t ulAddress, uint32_t uiSlots)
+{
+	return (uint32_t)((ulAddress * 0x9E3779B97F4A7C15ull) >> 32) & (uiSlots - 1u);
+}
+
+static TracePsfDecoderSymbol_t* prvFindSymbol(const TracePsfDecoder_t* pxDecoder, uint64_t ulAddress)
+{
+	uint32_t i;
+
+	if (pxDecoder->uiSymbolSlots == 0u)
+	{
+		return (TracePsfDecoderSymbol_t*)0;
+	}
+
+	/* There is always an unused slot, that ends the probe */
+	for (i = prvHash(ulAddress, pxDecoder->uiSymbolSlots); pxDecoder->pxSymbols[i].ulAddress != 0u; i = (i + 1u) & (pxDecoder->uiSymbolSlots - 1u))
+	{
+		if (pxDecoder->pxSymbols[i].ulAddress == ulAddress)
+		{
+			return &pxDecoder->pxSymbols[i];
+		}
+	}
+
+	return &pxDecoder->pxSymbols[i];
+}
+
+static int32_t prvGrowSymbols(TracePsfDecoder_t* pxDecoder)
+{
+	TracePsfDecoderSymbol_t* pxOld = pxDecoder->pxSymbols;
+	TracePsfDecoderSymbol_t* pxSymbol;
+	uint32_t uiOldSlots = pxDecoder->uiSymbolSlots;
+	uint32_t uiSlots = (uiOldSlots == 0u) ? PSF_DECODER_MIN_SYMBOL_SLOTS : (2u * uiOldSlots);
+	uint32_t i;
+
+	pxDecoder->pxSymbols = (TracePsfDecoderSymbol_t*)calloc(uiSlots, sizeof(TracePsfDecoderSymbol_t));
+	if (pxDecoder->pxSymbols == (TracePsfDecoderSymbol_t*)0)
+	{
+		pxDecoder->pxSymbols = pxOld;
+
+		return -1;
+	}
+
+	pxDecoder->uiSymbolSlots = uiSlots;
+
+	for (i = 0u; i < uiOldSlots; i++)
+	{
+		if (pxOld[i].ulAddress != 0u)
+		{
+			pxSymbol = prvFindSymbol(pxDecoder, pxOld[i].ulAddress);
+			*pxSymbol = pxOld[i];
+		}
+	}
+
+	free(pxOld);
+
+	return 0;
+}
+
+/* Sets the symbol of an address, from at most uiMaxLength characters */
+static int32_t prvSetSymbol(TracePsfDecoder_t* pxDecoder, uint64_t ulAddress, const uint8_t* puiSymbol, uint32_t uiMaxLength)
+{
+	TracePsfDecoderSymbol_t* pxSymbol;
+	char* szSymbol;
+	uint32_t uiLength;
+
+	if (ulAddress == 0u)
+	{
+		return 0;
+	}
+
+	/* Kept at most half full */
+	if ((2u * (pxDecoder->uiSymbolCount + 1u)) > pxDecoder->uiSymbolSlots)
+	{
+		if (prvGrowSymbols(pxDecoder) != 0)
+		{
+			return -1;
+		}
+	}
+
+	for (uiLength = 0u; (uiLength < uiMaxLength) && (puiSymbol[uiLength] != 0u); uiLength++) {}
+
+	szSymbol = (char*)malloc(uiLength + 1u);
+	if (szSymbol == (char*)0)
+	{
+		return -1;
+	}
+
+	memcpy(szSymbol, puiSymbol, uiLength);
+	szSymbol[uiLength] = (char)0;
+
+	pxSymbol = prvFindSymbol(pxDecoder, ulAddress);
+	if (pxSymbol->ulAddress == 0u)
+	{
+		pxSymbol->ulAddress = ulAddress;
+		pxDecoder->uiSymbolCount++;
+	}
+
+	free(pxSymbol->szSymbol);
+	pxSymbol->szSymbol = szSymbol;
+
+	return 0;
+}
+
+/* Size of the table at the current stage */
+static uint32_t prvTableSize(const TracePsfDecoder_t* pxDecoder)
+{
+	switch (pxDecoder->uiStage)
+	{
+	case PSF_DECODER_STAGE_HEADER:
+		return PSF_DECODER_HEADER_SIZE;
+	case PSF_DECODER_STAGE_TIMESTAMP:
+		/* TraceTimestampData_t */
+		return 24u + pxDecoder->uiBaseSize;
+	case PSF_DECODER_STAGE_ENTRY_HEADER:
+		/* Used entries, symbol size and state count */
+		return 3u * pxDecoder->uiBaseSize;
+	default:
+		/* TraceEntry_t: pvAddress, xStates, uiOptions and szSymbol */
+		return (4u * pxDecoder->uiBaseSize) + 4u + pxDecoder->uiEntrySymbolSize;
+	}
+}
+
+static int32_t prvDecodeHeader(TracePsfDecoder_t* pxDecoder, const uint8_t* puiData)
+{
+	uint32_t uiCores;
+	uint32_t i;
+
+	if (prvGet32(0u, puiData) == PSF_DECODER_IDENTIFIER)
+	{
+		pxDecoder->uiBigEndian = 0u;
+	}
+	else if (prvGet32(1u, puiData) == PSF_DECODER_IDENTIFIER)
+	{
+		pxDecoder->uiBigEndian = 1u;
+	}
+	else
+	{
+		return -1;
+	}
+
+	pxDecoder->uiVersion = prvGet16(pxDecoder->uiBigEndian, &puiData[4]);
+	pxDecoder->uiPlatform = prvGet16(pxDecoder->uiBigEndian, &puiData[6]);
+	pxDecoder->uiOptions = prvGet32(pxDecoder->uiBigEndian, &puiData[8]);
+	pxDecoder->uiBaseSize = ((pxDecoder->uiOptions & PSF_DECODER_HEADER_OPTION_64BIT) != 0u) ? 8u : 4u;
+
+	/* The core count is in the low byte, the stream count above it */
+	uiCores = prvGet32(pxDecoder->uiBigEndian, &puiData[12]) & 0xFFu;
+
+	if ((pxDecoder->uiVersion == 0u) || (uiCores == 0u) || (uiCores > TRC_PSF_DECODER_MAX_CORES))
+	{
+		return -1;
+	}
+
+	pxDecoder->uiCoreCount = uiCores;
+
+	memcpy(pxDecoder->szPlatformCfg, &puiData[24], 8u);
+	pxDecoder->szPlatformCfg[8] = (char)0;
+
+	/* The EventCount sequences restart with the recorder */
+	for (i = 0u; i < TRC_PSF_DECODER_MAX_CORES; i++)
+	{
+		pxDecoder->xCores[i].uiStarted = 0u;
+	}
+
+	pxDecoder->uiStarts++;
+
+	return 0;
+}
+
+static int32_t prvDecodeTable(TracePsfDecoder_t* pxDecoder, const uint8_t* puiData)
+{
+	uint64_t ulEntries, ulSymbolSize;
+
+	switch (pxDecoder->uiStage)
+	{
+	case PSF_DECODER_STAGE_HEADER:
+		if (prvDecodeHeader(pxDecoder, puiData) != 0)
+		{
+			return -1;
+		}
+
+		pxDecoder->uiStage = PSF_DECODER_STAGE_TIMESTAMP;
+		break;
+
+	case PSF_DECODER_STAGE_TIMESTAMP:
+		pxDecoder->uiTimerType = prvGet32(pxDecoder->uiBigEndian, &puiData[0]);
+		pxDecoder->uiTimerPeriod = prvGet32(pxDecoder->uiBigEndian, &puiData[4]);
+		pxDecoder->ulTimerFrequency = prvGetBase(pxDecoder, &puiData[8]);
+		pxDecoder->uiOsTickHz = prvGet32(pxDecoder->uiBigEndian, &puiData[12u + pxDecoder->uiBaseSize]);
+
+		pxDecoder->uiStage = PSF_DECODER_STAGE_ENTRY_HEADER;
+		break;
+
+	case PSF_DECODER_STAGE_ENTRY_HEADER:
+		ulEntries = prvGetBase(pxDecoder, &puiData[0]);
+		ulSymbolSize = prvGetBase(pxDecoder, &puiData[pxDecoder->uiBaseSize]);
+
+		if ((prvGetBase(pxDecoder, &puiData[2u * pxDecoder->uiBaseSize]) != PSF_DECODER_ENTRY_STATE_COUNT) ||
+			(ulEntries > PSF_DECODER_MAX_ENTRIES) ||
+			(ulSymbolSize < 4u) || (ulSymbolSize > TRC_PSF_DECODER_MAX_SYMBOL_SIZE) ||
+			((ulSymbolSize + 4u) % pxDecoder->uiBaseSize != 0u))
+		{
+			return -1;
+		}
+
+		pxDecoder->uiEntries = (uint32_t)ulEntries;
+		pxDecoder->uiEntrySymbolSize = (uint32_t)ulSymbolSize;
+		pxDecoder->uiRemainingEntries = pxDecoder->uiEntries;
+
+		pxDecoder->uiStage = (pxDecoder->uiRemainingEntries != 0u) ? PSF_DECODER_STAGE_ENTRIES : PSF_DECODER_STAGE_EVENTS;
+		break;
+
+	default:
+		if (prvSetSymbol(pxDecoder, prvGetBase(pxDecoder, puiData), &puiData[(4u * pxDecoder->uiBaseSize) + 4u], pxDecoder->uiEntrySymbolSize) != 0)
+		{
+			return -1;
+		}
+
+		pxDecoder->uiRemainingEntries--;
+		if (pxDecoder->uiRemainingEntries == 0u)
+		{
+			pxDecoder->uiStage = PSF_DECODER_STAGE_EVENTS;
+		}
+		break;
+	}
+
+	return 0;
+}
+
+/* The rare parts of an event: name events, the callback and events from cores
+ * beyond the core count */
+static int32_t prvDecodeEventSlow(TracePsfDecoder_t* pxDecoder, const uint8_t* puiEvent, uint32_t uiCode, uint32_t uiCore, uint32_t uiEventCount, uint32_t uiSize)
+{
+	TracePsfDecoderEvent_t xEvent;
+	uint32_t i;
+
+	if (uiCore >= pxDecoder->uiCoreCount)
+	{
+		pxDecoder->ulInvalidEvents++;
+	}
+
+	/* The address, then the name */
+	if ((uiCode == PSF_DECODER_EVENT_OBJ_NAME) && (uiSize > (PSF_DECODER_EVENT_HEADER_SIZE + pxDecoder->uiBaseSize)))
+	{
+		if (prvSetSymbol(pxDecoder, prvGetBase(pxDecoder, &puiEvent[PSF_DECODER_EVENT_HEADER_SIZE]),
+			&puiEvent[PSF_DECODER_EVENT_HEADER_SIZE + pxDecoder->uiBaseSize], uiSize - PSF_DECODER_EVENT_HEADER_SIZE - pxDecoder->uiBaseSize) != 0)
+		{
+			return -1;
+		}
+	}
+
+	if (pxDecoder->xOnEvent != (TracePsfDecoderOnEvent_t)0)
+	{
+		xEvent.uiCode = uiCode;
+		xEvent.uiCore = uiCore;
+		xEvent.uiEventCount = uiEventCount;
+		xEvent.uiTimestamp = prvGet32(pxDecoder->uiBigEndian, &puiEvent[4]);
+		xEvent.uiParameterCount = (uiSize - PSF_DECODER_EVENT_HEADER_SIZE) / pxDecoder->uiBaseSize;
+		xEvent.uiSize = uiSize;
+		xEvent.puiData = puiEvent;
+
+		for (i = 0u; i < xEvent.uiParameterCount; i++)
+		{
+			xEvent.ulParameters[i] = prvGetBase(pxDecoder, &puiEvent[PSF_DECODER_EVENT_HEADER_SIZE + (i * pxDecoder->uiBaseSize)]);
+		}
+
+		if (pxDecoder->xOnEvent(pxDecoder->pvUser, &xEvent) != 0)
+		{
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/* Decodes the whole events at puiData, up to a header or an event that isn't
+ * whole. Inlined with uiBigEndian constant, so that there is a copy of the
+ * loop for each endianness, without endianness tests in it. */
+static inline int32_t prvDecodeEvents(TracePsfDecoder_t* pxDecoder, const uint8_t* puiData, uint32_t uiSize, uint32_t uiBigEndian, uint32_t* puiDecoded)
+{
+	TracePsfDecoderCore_t* pxCore;
+	const uint8_t* puiEvent;
+	uint32_t uiBaseShift = (pxDecoder->uiBaseSize == 8u) ? 3u : 2u;
+	uint32_t uiMultiCore = (pxDecoder->uiCoreCount > 1u) ? 1u : 0u;
+	uint32_t uiCountMask = (uiMultiCore != 0u) ? 0xFFFu : 0xFFFFu;
+	uint32_t uiSlowPath = ((pxDecoder->xOnEvent != (TracePsfDecoderOnEvent_t)0) ? 1u : 0u);
+	uint32_t uiPosition = 0u;
+	uint32_t uiEventID, uiEventCount, uiCode, uiCore, uiEventSize, uiTimestamp, uiMissing;
+
+	while ((uiSize - uiPosition) >= PSF_DECODER_EVENT_HEADER_SIZE)
+	{
+		puiEvent = &puiData[uiPosition];
+
+		/* The recorder stores the header and tables again when restarted */
+		if (prvGet32(uiBigEndian, puiEvent) == PSF_DECODER_IDENTIFIER)
+		{
+			pxDecoder->uiStage = PSF_DECODER_STAGE_HEADER;
+			break;
+		}
+
+		uiEventID = prvGet16(uiBigEndian, puiEvent);
+		uiEventSize = PSF_DECODER_EVENT_HEADER_SIZE + ((uiEventID >> 12) << uiBaseShift);
+
+		if (uiEventSize > (uiSize - uiPosition))
+		{
+			break;
+		}
+
+		uiCode = uiEventID & 0xFFFu;
+		uiEventCount = prvGet16(uiBigEndian, &puiEvent[2]);
+		uiTimestamp = prvGet32(uiBigEndian, &puiEvent[4]);
+
+		/* With more than one core, the core is in the top four bits */
+		uiCore = (uiEventCount >> 12) & (0u - uiMultiCore);
+		uiEventCount &= uiCountMask;
+
+		pxDecoder->ulCodeEvents[uiCode]++;
+		pxDecoder->ulCodeBytes[uiCode] += uiEventSize;
+
+		pxCore = &pxDecoder->xCores[uiCore];
+
+		if (pxCore->uiStarted == 0u)
+		{
+			if (pxCore->ulEvents == 0u)
+			{
+				pxCore->ulFirstTimestamp = uiTimestamp;
+				pxCore->ulLastTimestamp = uiTimestamp;
+			}
+
+			pxCore->uiStarted = 1u;
+			pxCore->uiNextEventCount = uiEventCount;
+		}
+
+		uiMissing = (uiEventCount - pxCore->uiNextEventCount) & uiCountMask;
+		pxCore->ulGaps += (uiMissing != 0u) ? 1u : 0u;
+		pxCore->ulMissingEvents += uiMissing;
+		pxCore->uiNextEventCount = (uiEventCount + 1u) & uiCountMask;
+
+		/* Adds the time since the last event, across timer wraparounds */
+		pxCore->ulLastTimestamp += (uint32_t)(uiTimestamp - (uint32_t)pxCore->ulLastTimestamp);
+
+		pxCore->ulEvents++;
+		pxCore->ulBytes += uiEventSize;
+
+		if ((uiSlowPath | (uiCode == PSF_DECODER_EVENT_OBJ_NAME) | (uiCore >= pxDecoder->uiCoreCount)) != 0u)
+		{
+			if (prvDecodeEventSlow(pxDecoder, puiEvent, uiCode, uiCore, uiEventCount, uiEventSize) != 0)
+			{
+				return -1;
+			}
+		}
+
+		uiPosition += uiEventSize;
+	}
+
+	*puiDecoded = uiPosition;
+
+	return 0;
+}
+
+static int32_t prvDecodeEventsAny(TracePsfDecoder_t* pxDecoder, const uint8_t* puiData, uint32_t uiSize, uint32_t* puiDecoded)
+{
+	if (pxDecoder->uiBigEndian != 0u)
+	{
+		return prvDecodeEvents(pxDecoder, puiData, uiSize, 1u, puiDecoded);
+	}
+
+	return prvDecodeEvents(pxDecoder, puiData, uiSize, 0u, puiDecoded);
+}
+
+/* Size of what is pending: a table, or the event once its header is there */
+static uint32_t prvPendingSize(const TracePsfDecoder_t* pxDecoder)
+{
+	if (pxDecoder->uiStage != PSF_DECODER_STAGE_EVENTS)
+	{
+		return prvTableSize(pxDecoder);
+	}
+
+	if (pxDecoder->uiPendingLength < PSF_DECODER_EVENT_HEADER_SIZE)
+	{
+		return PSF_DECODER_EVENT_HEADER_SIZE;
+	}
+
+	if (prvGet32(pxDecoder->uiBigEndian, pxDecoder->auiPending) == PSF_DECODER_IDENTIFIER)
+	{
+		return PSF_DECODER_HEADER_SIZE;
+	}
+
+	return PSF_DECODER_EVENT_HEADER_SIZE + ((prvGet16(pxDecoder->uiBigEndian, pxDecoder->auiPending) >> 12) * pxDecoder->uiBaseSize);
+}
+
+int32_t xTracePsfDecoderInitialize(TracePsfDecoder_t* pxDecoder, TracePsfDecoderOnEvent_t xOnEvent, void* pvUser)
+{
+	if (pxDecoder == (TracePsfDecoder_t*)0)
+	{
+		return -1;
+	}
+
+	memset(pxDecoder, 0, sizeof(TracePsfDecoder_t));
+
+	pxDecoder->xOnEvent = xOnEvent;
+	pxDecoder->pvUser = pvUser;
+	pxDecoder->uiStage = PSF_DECODER_STAGE_HEADER;
+
+	return 0;
+}
+
+int32_t xTracePsfDecoderFeed(TracePsfDecoder_t* pxDecoder, const void* pvData, uint32_t uiSize)
+{
+	const uint8_t* puiData = (const uint8_t*)pvData;
+	uint32_t uiPendingSize;
+	uint32_t uiLength;
+	uint32_t uiDecoded;
+
+	if (pxDecoder->uiFailed != 0u)
+	{
+		return -1;
+	}
+
+	pxDecoder->ulBytes += uiSize;
+
+	while (uiSize > 0u)
+	{
+		if ((pxDecoder->uiStage == PSF_DECODER_STAGE_EVENTS) && (pxDecoder->uiPendingLength == 0u))
+		{
+			if (prvDecodeEventsAny(pxDecoder, puiData, uiSize, &uiDecoded) != 0)
+			{
+				pxDecoder->uiFailed = 1u;
+
+				return -1;
+			}
+
+			puiData = &puiData[uiDecoded];
+			uiSize -= uiDecoded;
+
+			if (pxDecoder->uiStage == PSF_DECODER_STAGE_EVENTS)
+			{
+				/* Less than an event is left, it is completed by the next piece */
+				memcpy(pxDecoder->auiPending, puiData, uiSize);
+				pxDecoder->uiPendingLength = uiSize;
+
+				return 0;
+			}
+
+			continue;
+		}
+
+		/* A table, or an event split between pieces. The event's header comes
+		 * first, it gives the size. */
+		uiPendingSize = prvPendingSize(pxDecoder);
+
+		uiLength = uiPendingSize - pxDecoder->uiPendingLength;
+		if (uiLength > uiSize)
+		{
+			uiLength = uiSize;
+		}
+
+		memcpy(&pxDecoder->auiPending[pxDecoder->uiPendingLength], puiData, uiLength);
+		pxDecoder->uiPendingLength += uiLength;
+		puiData = &puiData[uiLength];
+		uiSize -= uiLength;
+
+		if (pxDecoder->uiPendingLength < uiPendingSize)
+		{
+			return 0;
+		}
+
+		if (prvPendingSize(pxDecoder) != uiPendingSize)
+		{
+			/* The header is there, the event is larger */
+			continue;
+		}
+
+		if ((pxDecoder->uiStage == PSF_DECODER_STAGE_EVENTS) && (prvGet32(pxDecoder->uiBigEndian, pxDecoder->auiPending) == PSF_DECODER_IDENTIFIER))
+		{
+			pxDecoder->uiStage = PSF_DECODER_STAGE_HEADER;
+		}
+
+		if (pxDecoder->uiStage == PSF_DECODER_STAGE_EVENTS)
+		{
+			if ((prvDecodeEventsAny(pxDecoder, pxDecoder->auiPending, pxDecoder->uiPendingLength, &uiDecoded) != 0) || (uiDecoded != uiPendingSize))
+			{
+				pxDecoder->uiFailed = 1u;
+
+				return -1;
+			}
+		}
+		else
+		{
+			pxDecoder->ulTableBytes += uiPendingSize;
+
+			if (prvDecodeTable(pxDecoder, pxDecoder->auiPending) != 0)
+			{
+				pxDecoder->uiFailed = 1u;
+
+				return -1;
+			}
+		}
+
+		pxDecoder->uiPendingLength = 0u;
+	}
+
+	return 0;
+}
+
+int32_t xTracePsfDecoderFinish(TracePsfDecoder_t* pxDecoder)
+{
+	uint32_t i;
+
+	pxDecoder->uiTruncatedBytes = pxDecoder->uiPendingLength;
+	pxDecoder->uiPendingLength = 0u;
+
+	pxDecoder->ulEvents = 0u;
+	for (i = 0u; i < TRC_PSF_DECODER_MAX_CORES; i++)
+	{
+		pxDecoder->ulEvents += pxDecoder->xCores[i].ulEvents;
+	}
+
+	if ((pxDecoder->uiFailed != 0u) || (pxDecoder->uiStage != PSF_DECODER_STAGE_EVENTS))
+	{
+		return -1;
+	}
+
+	return 0;
+}
+
+int32_t xTracePsfDecoderDecodeFile(TracePsfDecoder_t* pxDecoder, const char* szPath)
+{
+	uint8_t* puiBuffer;
+	ssize_t iRead;
+	int32_t iResult = 0;
+	int iFile;
+
+	iFile = open(szPath, O_RDONLY);
+	if (iFile < 0)
+	{
+		return -1;
+	}
+
+	(void)posix_fadvise(iFile, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+	puiBuffer = (uint8_t*)malloc(PSF_DECODER_READ_SIZE);
+	if (puiBuffer == (uint8_t*)0)
+	{
+		(void)close(iFile);
+
+		return -1;
+	}
+
+	while (iResult == 0)
+	{
+		iRead = read(iFile, puiBuffer, PSF_DECODER_READ_SIZE);
+		if (iRead < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			iResult = -1;
+		}
+		else if (iRead == 0)
+		{
+			break;
+		}
+		else
+		{
+			iResult = xTracePsfDecoderFeed(pxDecoder, puiBuffer, (uint32_t)iRead);
+		}
+	}
+
+	free(puiBuffer);
+	(void)close(iFile);
+
+	if (xTracePsfDecoderFinish(pxDecoder) != 0)
+	{
+		iResult = -1;
+	}
+
+	return iResult;
+}
+
+const char* szTracePsfDecoderGetSymbol(const TracePsfDecoder_t* pxDecoder, uint64_t ulAddress)
+{
+	const TracePsfDecoderSymbol_t* pxSymbol;
+
+	if (ulAddress == 0u)
+	{
+		return (const char*)0;
+	}
+
+	pxSymbol = prvFindSymbol(pxDecoder, ulAddress);
+	if ((pxSymbol == (const TracePsfDecoderSymbol_t*)0) || (pxSymbol->ulAddress == 0u))
+	{
+		return (const char*)0;
+	}
+
+	return pxSymbol->szSymbol;
+}
+
+double dTracePsfDecoderGetDuration(const TracePsfDecoder_t* pxDecoder)
+{
+	uint64_t ulFirst = UINT64_MAX;
+	uint64_t ulLast = 0u;
+	uint32_t i;
+
+	if (pxDecoder->ulTimerFrequency == 0u)
+	{
+		return 0.0;
+	}
+
+	for (i = 0u; i < TRC_PSF_DECODER_MAX_CORES; i++)
+	{
+		if (pxDecoder->xCores[i].ulEvents == 0u)
+		{
+			continue;
+		}
+
+		if (pxDecoder->xCores[i].ulFirstTimestamp < ulFirst)
+		{
+			ulFirst = pxDecoder->xCores[i].ulFirstTimestamp;
+		}
+
+		if (pxDecoder->xCores[i].ulLastTimestamp > ulLast)
+		{
+			ulLast = pxDecoder->xCores[i].ulLastTimestamp;
+		}
+	}
+
+	if (ulLast <= ulFirst)
+	{
+		return 0.0;
+	}
+
+	return (double)(ulLast - ulFirst) / (double)pxDecoder->ulTimerFrequency;
+}
+
+void vTracePsfDecoderFree(TracePsfDecoder_t* pxDecoder)
+{
+	uint32_t i;
+
+	for (i = 0u; i < pxDecoder->uiSymbolSlots; i++)
+	{
+		free(pxDecoder->pxSymbols[i].szSymbol);
+	}
+
+	free(pxDecoder->pxSymbols);
+
+	pxDecoder->pxSymbols = (TracePsfDecoderSymbol_t*)0;
+	pxDecoder->uiSymbolSlots = 0u;
+	pxDecoder->uiSymbolCount = 0u;
+}
@@ -0,0 +1,247 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Command line tool for the PSF decoder. Decodes a streaming PSF file and
+ * prints the events and bytes per event code and per core, and the gaps in
+ * the EventCount sequences.
+ *
+ *	trcPsfDecode [-s] [-t] file
+ */
+
+#include <trcPsfDecoder.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#define PSF_DECODE_STDIN_READ_SIZE (1024u * 1024u)
+
+static TracePsfDecoder_t xDecoder;
+static uint32_t auiCodes[TRC_PSF_DECODER_EVENT_CODES];
+
+/* The event codes that are the same in all kernel ports */
+static const char* prvCodeName(uint32_t uiCode)
+{
+	switch (uiCode)
+	{
+	case 0x01u: return "TRACE_START";
+	case 0x02u: return "TS_CONFIG";
+	case 0x03u: return "OBJ_NAME";
+	default: return "";
+	}
+}
+
+/* By bytes, most first */
+static int prvCompareCodes(const void* pvA, const void* pvB)
+{
+	uint64_t ulA = xDecoder.ulCodeBytes[*(const uint32_t*)pvA];
+	uint64_t ulB = xDecoder.ulCodeBytes[*(const uint32_t*)pvB];
+
+	return (ulA < ulB) - (ulA > ulB);
+}
+
+static int32_t prvDecodeStdin(TracePsfDecoder_t* pxDecoder)
+{
+	uint8_t* puiBuffer;
+	ssize_t iRead;
+	int32_t iResult = 0;
+
+	puiBuffer = (uint8_t*)malloc(PSF_DECODE_STDIN_READ_SIZE);
+	if (puiBuffer == (uint8_t*)0)
+	{
+		return -1;
+	}
+
+	while ((iResult == 0) && ((iRead = read(0, puiBuffer, PSF_DECODE_STDIN_READ_SIZE)) > 0))
+	{
+		iResult = xTracePsfDecoderFeed(pxDecoder, puiBuffer, (uint32_t)iRead);
+	}
+
+	free(puiBuffer);
+
+	if (xTracePsfDecoderFinish(pxDecoder) != 0)
+	{
+		iResult = -1;
+	}
+
+	return iResult;
+}
+
+static void prvPrintSymbols(const TracePsfDecoder_t* pxDecoder)
+{
+	uint32_t i;
+
+	printf("\n%u symbols:\n", (unsigned int)pxDecoder->uiSymbolCount);
+
+	for (i = 0u; i < pxDecoder->uiSymbolSlots; i++)
+	{
+		if (pxDecoder->pxSymbols[i].ulAddress != 0u)
+		{
+			printf("   0x%0*llx  %s\n", (int)(2u * pxDecoder->uiBaseSize), (unsigned long long)pxDecoder->pxSymbols[i].ulAddress, pxDecoder->pxSymbols[i].szSymbol);
+		}
+	}
+}
+
+static void prvUsage(void)
+{
+	fprintf(stderr,
+		"trcPsfDecode [-s] [-t] file\n"
+		"\n"
+		"file  Streaming PSF file, - for stdin\n"
+		"-s    List the symbols, from the entry table and name events\n"
+		"-t    Report the decoding speed\n");
+	exit(1);
+}
+
+int main(int argc, char** argv)
+{
+	const TracePsfDecoderCore_t* pxCore;
+	struct timespec xStart, xStop;
+	uint32_t uiSymbols = 0u;
+	uint32_t uiTime = 0u;
+	uint32_t uiCodeCount = 0u;
+	uint64_t ulEventBytes = 0u;
+	uint64_t ulGaps = 0u;
+	double dSeconds, dDuration;
+	int32_t iResult;
+	int iOption;
+	uint32_t i;
+
+	while ((iOption = getopt(argc, argv, "sth")) != -1)
+	{
+		switch (iOption)
+		{
+		case 's': uiSymbols = 1u; break;
+		case 't': uiTime = 1u; break;
+		default: prvUsage(); break;
+		}
+	}
+
+	if (optind != (argc - 1))
+	{
+		prvUsage();
+	}
+
+	(void)xTracePsfDecoderInitialize(&xDecoder, (TracePsfDecoderOnEvent_t)0, (void*)0);
+
+	(void)clock_gettime(CLOCK_MONOTONIC, &xStart);
+
+	if ((argv[optind][0] == '-') && (argv[optind][1] == (char)0))
+	{
+		iResult = prvDecodeStdin(&xDecoder);
+	}
+	else
+	{
+		iResult = xTracePsfDecoderDecodeFile(&xDecoder, argv[optind]);
+	}
+
+	(void)clock_gettime(CLOCK_MONOTONIC, &xStop);
+
+	if ((iResult != 0) && (xDecoder.uiStarts == 0u))
+	{
+		fprintf(stderr, "Could not read %s, or it isn't a streaming PSF file.\n", argv[optind]);
+		return 1;
+	}
+
+	printf("%s endian, %u-bit, PSF version %u, platform 0x%x (%s), %u cores, timer %llu Hz, %u entries, %u starts\n",
+		(xDecoder.uiBigEndian != 0u) ? "big" : "little",
+		(unsigned int)(xDecoder.uiBaseSize * 8u),
+		(unsigned int)xDecoder.uiVersion,
+		(unsigned int)xDecoder.uiPlatform,
+		xDecoder.szPlatformCfg,
+		(unsigned int)xDecoder.uiCoreCount,
+		(unsigned long long)xDecoder.ulTimerFrequency,
+		(unsigned int)xDecoder.uiEntries,
+		(unsigned int)xDecoder.uiStarts);
+
+	for (i = 0u; i < TRC_PSF_DECODER_EVENT_CODES; i++)
+	{
+		if (xDecoder.ulCodeEvents[i] != 0u)
+		{
+			auiCodes[uiCodeCount] = i;
+			uiCodeCount++;
+			ulEventBytes += xDecoder.ulCodeBytes[i];
+		}
+	}
+
+	qsort(auiCodes, uiCodeCount, sizeof(uint32_t), prvCompareCodes);
+
+	printf("\n  code            events        bytes   share\n");
+	for (i = 0u; i < uiCodeCount; i++)
+	{
+		printf("  0x%03x %-11s %9llu %12llu %6.2f%%\n",
+			(unsigned int)auiCodes[i],
+			prvCodeName(auiCodes[i]),
+			(unsigned long long)xDecoder.ulCodeEvents[auiCodes[i]],
+			(unsigned long long)xDecoder.ulCodeBytes[auiCodes[i]],
+			(ulEventBytes != 0u) ? ((100.0 * (double)xDecoder.ulCodeBytes[auiCodes[i]]) / (double)ulEventBytes) : 0.0);
+	}
+
+	printf("\n  core      events        bytes     gaps  missing events\n");
+	for (i = 0u; i < TRC_PSF_DECODER_MAX_CORES; i++)
+	{
+		pxCore = &xDecoder.xCores[i];
+
+		if ((i < xDecoder.uiCoreCount) || (pxCore->ulEvents != 0u))
+		{
+			printf("  %4u %11llu %12llu %8llu %15llu\n",
+				(unsigned int)i,
+				(unsigned long long)pxCore->ulEvents,
+				(unsigned long long)pxCore->ulBytes,
+				(unsigned long long)pxCore->ulGaps,
+				(unsigned long long)pxCore->ulMissingEvents);
+
+			ulGaps += pxCore->ulGaps;
+		}
+	}
+
+	printf("\n%llu events, %llu bytes of events, %llu bytes of tables, %llu bytes in all\n",
+		(unsigned long long)xDecoder.ulEvents,
+		(unsigned long long)ulEventBytes,
+		(unsigned long long)xDecoder.ulTableBytes,
+		(unsigned long long)xDecoder.ulBytes);
+
+	dDuration = dTracePsfDecoderGetDuration(&xDecoder);
+	if (dDuration > 0.0)
+	{
+		printf("%.6f s traced, %.1f events/s, %.1f bytes/s\n", dDuration, (double)xDecoder.ulEvents / dDuration, (double)ulEventBytes / dDuration);
+	}
+
+	if (xDecoder.ulInvalidEvents != 0u)
+	{
+		printf("%llu events from cores beyond the core count\n", (unsigned long long)xDecoder.ulInvalidEvents);
+	}
+
+	if (xDecoder.uiTruncatedBytes != 0u)
+	{
+		printf("%u bytes at the end are an incomplete event or table\n", (unsigned int)xDecoder.uiTruncatedBytes);
+	}
+
+	if (uiSymbols != 0u)
+	{
+		prvPrintSymbols(&xDecoder);
+	}
+
+	if (uiTime != 0u)
+	{
+		dSeconds = (double)(xStop.tv_sec - xStart.tv_sec) + ((double)(xStop.tv_nsec - xStart.tv_nsec) / 1e9);
+		if (dSeconds > 0.0)
+		{
+			printf("\ndecoded in %.3f s, %.1f MB/s\n", dSeconds, ((double)xDecoder.ulBytes / dSeconds) / 1e6);
+		}
+	}
+
+	vTracePsfDecoderFree(&xDecoder);
+
+	if (iResult != 0)
+	{
+		fprintf(stderr, "The stream is invalid, or ends before the first event.\n");
+		return 1;
+	}
+
+	return (ulGaps != 0u) ? 2 : 0;
+}
@@ -0,0 +1,35 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * The configuration of the RingBuffer stream port for the dump target
+ * (trcRingBufferDumpTarget), used instead of streamports/RingBuffer/config by
+ * the host CMake build. See streamports/RingBuffer/config/trcStreamPortConfig.h.
+ */
+
+#ifndef TRC_STREAM_PORT_CONFIG_H
+#define TRC_STREAM_PORT_CONFIG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Type flags */
+#define TRC_STREAM_PORT_RINGBUFFER_MODE_STOP_WHEN_FULL		(0U)
+#define TRC_STREAM_PORT_RINGBUFFER_MODE_OVERWRITE_WHEN_FULL	(1U)
+
+/* Large enough to wrap many times per core, and still hold a lot of events */
+#define TRC_CFG_STREAM_PORT_BUFFER_SIZE (1024 * 1024)
+
+#ifndef TRC_CFG_STREAM_PORT_RINGBUFFER_MODE
+#define TRC_CFG_STREAM_PORT_RINGBUFFER_MODE TRC_STREAM_PORT_RINGBUFFER_MODE_OVERWRITE_WHEN_FULL
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRC_STREAM_PORT_CONFIG_H */
@@ -0,0 +1,155 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Post-mortem extractor for the RingBuffer stream port (streamports/RingBuffer).
+ * Finds TraceRingBuffer_t in a raw RAM dump or an ELF core file by its
+ * START_MARKERS/END_MARKERS, and writes what it holds as a streaming PSF file
+ * that Tracealyzer can open: the header, timestamp info and entry table that
+ * the stream port keeps outside of the event stream, followed by the events of
+ * all cores' event buffers, merged in timestamp order. The dump is read in
+ * chunks, it is never loaded whole.
+ */
+
+#ifndef TRC_RING_BUFFER_EXTRACTOR_H
+#define TRC_RING_BUFFER_EXTRACTOR_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TRC_RING_BUFFER_DUMP_MAX_CORES 16u
+
+/**
+ * @brief Called with the PSF data, in order.
+ *
+ * @retval -1 Failed, the extraction is stopped
+ * @retval 0 Success
+ */
+typedef int32_t (*TraceRingBufferDumpWrite_t)(void* pvUser, const void* pvData, uint32_t uiSize);
+
+/**
+ * @brief A range of target memory that the dump holds.
+ */
+typedef struct TraceRingBufferDumpSegment
+{
+	uint64_t ulAddress;				/* Target address */
+	uint64_t ulOffset;				/* File offset */
+	uint64_t ulSize;				/* Bytes in the file */
+} TraceRingBufferDumpSegment_t;
+
+typedef struct TraceRingBufferDump
+{
+	int iFile;
+	uint32_t uiIsCore;				/* ELF core file, otherwise a raw dump */
+	TraceRingBufferDumpSegment_t* pxSegments;	/* Sorted by address */
+	uint32_t uiSegmentCount;
+} TraceRingBufferDump_t;
+
+/**
+ * @brief One core's TraceEventBuffer_t, as found in the dump.
+ */
+typedef struct TraceRingBufferDumpCore
+{
+	uint64_t ulAddress;				/* The TraceEventBuffer_t */
+	uint64_t ulDataAddress;			/* Its buffer */
+	uint32_t uiHead;
+	uint32_t uiTail;
+	uint32_t uiSize;
+	uint32_t uiSlack;
+	uint32_t uiOptions;				/* TRC_EVENT_BUFFER_OPTION_SKIP or _OVERWRITE */
+	uint32_t uiDroppedEvents;
+} TraceRingBufferDumpCore_t;
+
+/**
+ * @brief A TraceRingBuffer_t found in the dump.
+ */
+typedef struct TraceRingBufferDumpRecorder
+{
+	uint64_t ulAddress;				/* START_MARKERS */
+	uint32_t uiBigEndian;
+	uint32_t uiBaseSize;			/* sizeof(TraceUnsignedBaseType_t), and of pointers */
+	uint32_t uiVersion;				/* PSF format version */
+	uint32_t uiCoreCount;
+	uint64_t ulEntryTableAddress;
+	uint32_t uiEntrySlots;
+	uint32_t uiEntrySymbolSize;
+	uint32_t uiEntrySize;			/* sizeof(TraceEntry_t) */
+	uint64_t ulEventBufferAddress;	/* xEventBuffer.uiBuffer */
+	uint32_t uiEventBufferSize;
+	TraceRingBufferDumpCore_t xCores[TRC_RING_BUFFER_DUMP_MAX_CORES];
+} TraceRingBufferDumpRecorder_t;
+
+typedef struct TraceRingBufferDumpStatistics
+{
+	uint64_t ulBytes;				/* PSF data written */
+	uint32_t uiEntries;				/* Entry table slots in use */
+	uint32_t uiEvents[TRC_RING_BUFFER_DUMP_MAX_CORES];	/* Events written, per core */
+	uint32_t uiCorruptBytes[TRC_RING_BUFFER_DUMP_MAX_CORES];	/* Buffered data that didn't hold valid events, per core */
+} TraceRingBufferDumpStatistics_t;
+
+/**
+ * @brief Opens a dump. An ELF core file is recognized by its header, its
+ * PT_LOAD segments are the memory it holds. Any other file is a raw dump of
+ * memory starting at ulRawAddress.
+ *
+ * @param[out] pxDump Dump
+ * @param[in] szPath File
+ * @param[in] ulRawAddress Target address of the first byte of a raw dump
+ *
+ * @retval -1 The file can't be read, or is an ELF file that isn't a core file
+ * @retval 0 Success
+ */
+int32_t xTraceRingBufferDumpOpen(TraceRingBufferDump_t* pxDump, const char* szPath, uint64_t ulRawAddress);
+
+/**
+ * @brief Scans the dump for START_MARKERS, from ulFromAddress, and returns
+ * the first TraceRingBuffer_t that is valid: the header identifies PSF, the
+ * entry table and event buffer sizes are sane, END_MARKERS are where the sizes
+ * put them and each core's TraceEventBuffer_t is consistent. Scan again from
+ * pxRecorder->ulAddress + 1 for the next one.
+ *
+ * @param[in] pxDump Dump
+ * @param[in] ulFromAddress Lowest address of START_MARKERS
+ * @param[out] pxRecorder Recorder found
+ *
+ * @retval -1 None found
+ * @retval 0 Success
+ */
+int32_t xTraceRingBufferDumpFind(const TraceRingBufferDump_t* pxDump, uint64_t ulFromAddress, TraceRingBufferDumpRecorder_t* pxRecorder);
+
+/**
+ * @brief Writes the trace held by a recorder that xTraceRingBufferDumpFind()
+ * returned, as a streaming PSF file. Each core's events are read from uiTail to
+ * uiHead, wrapping at uiSize - uiSlack when uiHead is below uiTail, and the
+ * cores are merged by timestamp. The rest of a span is skipped, and counted as
+ * corrupt, at the first event that doesn't fit in it.
+ *
+ * @param[in] pxDump Dump
+ * @param[in] pxRecorder Recorder
+ * @param[in] xWrite PSF data callback
+ * @param[in] pvUser Passed to xWrite
+ * @param[out] pxStatistics Statistics, can be null
+ *
+ * @retval -1 The dump couldn't be read, or xWrite failed
+ * @retval 0 Success
+ */
+int32_t xTraceRingBufferDumpExtract(const TraceRingBufferDump_t* pxDump, const TraceRingBufferDumpRecorder_t* pxRecorder, TraceRingBufferDumpWrite_t xWrite, void* pvUser, TraceRingBufferDumpStatistics_t* pxStatistics);
+
+/**
+ * @brief Closes the dump.
+ *
+ * @param[in] pxDump Dump
+ */
+void vTraceRingBufferDumpClose(TraceRingBufferDump_t* pxDump);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRC_RING_BUFFER_EXTRACTOR_H */
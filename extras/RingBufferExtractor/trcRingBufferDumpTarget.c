@@ -0,0 +1,204 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * A traced program using the RingBuffer stream port on the host, to test
+ * trcRingBufferExtract. It generates user events from a number of threads and
+ * then writes its stream port data to a file, as a raw RAM dump or as an ELF
+ * core file, with the recording still running as if the target had halted.
+ * The recorder is preceded by padding, which can be made gigabytes large, and
+ * by decoys that hold START_MARKERS but aren't recorders.
+ *
+ *	trcRingBufferDumpTarget [-t threads] [-e events per thread] [-p padding in MB] [-c] file
+ */
+
+#include <trcRecorder.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define RB_TARGET_MAX_THREADS 64u
+#define RB_TARGET_DECOY_SIZE 4096u
+#define RB_TARGET_ELF_HEADER_SIZE 64u
+#define RB_TARGET_ELF_PROGRAM_HEADER_SIZE 56u
+
+static uint32_t uiEventsPerThread = 100000u;
+
+static void* prvWorker(void* pvArg)
+{
+	TraceStringHandle_t xChannel;
+	uint32_t uiThread = (uint32_t)(uintptr_t)pvArg;
+	uint32_t i;
+
+	(void)xTraceStringRegister("rb", &xChannel);
+
+	for (i = 0u; i < uiEventsPerThread; i++)
+	{
+		/* The thread is a parameter, so that each thread's sequence can be checked */
+		(void)xTracePrintF(xChannel, "%d %d", (int)i, (int)uiThread);
+	}
+
+	return (void*)0;
+}
+
+static void prvPut(uint8_t* puiData, uint64_t ulValue, uint32_t uiSize)
+{
+	uint32_t i;
+
+	for (i = 0u; i < uiSize; i++)
+	{
+		puiData[i] = (uint8_t)(ulValue >> (8u * i));
+	}
+}
+
+/* Holds START_MARKERS, one with nothing valid after it and one with a copy of
+ * the recorder's header but no END_MARKERS where its sizes put them */
+static void prvMakeDecoy(uint8_t* puiDecoy)
+{
+	const uint8_t* puiRingBuffer = (const uint8_t*)&pxStreamPortData->xRingBuffer;
+	uint32_t i;
+
+	for (i = 0u; i < RB_TARGET_DECOY_SIZE; i++)
+	{
+		puiDecoy[i] = (uint8_t)((i * 2654435761u) >> 24);
+	}
+
+	memcpy(&puiDecoy[100], &puiRingBuffer[4], 12u);
+	memcpy(&puiDecoy[1000], &puiRingBuffer[4], 12u + 32u + 256u);
+}
+
+static int prvWrite(int iFile, const void* pvData, uint64_t ulSize)
+{
+	return (write(iFile, pvData, (size_t)ulSize) == (ssize_t)ulSize) ? 0 : -1;
+}
+
+static void prvUsage(void)
+{
+	fprintf(stderr,
+		"trcRingBufferDumpTarget [-t threads] [-e events per thread] [-p padding in MB] [-c] file\n"
+		"\n"
+		"-c  Write an ELF core file, otherwise a raw dump\n");
+	exit(1);
+}
+
+int main(int argc, char** argv)
+{
+	pthread_t xWorkers[RB_TARGET_MAX_THREADS];
+	uint8_t auiElf[RB_TARGET_ELF_HEADER_SIZE + (2u * RB_TARGET_ELF_PROGRAM_HEADER_SIZE)] = { 0 };
+	uint8_t auiDecoy[RB_TARGET_DECOY_SIZE];
+	uint64_t ulPadding = 0u;
+	uint64_t ulDataOffset;
+	uint32_t uiThreads = 2u;
+	uint32_t uiCore = 0u;
+	uint8_t* puiPhdr;
+	int iOption;
+	int iFile;
+	uint32_t i;
+
+	while ((iOption = getopt(argc, argv, "t:e:p:ch")) != -1)
+	{
+		switch (iOption)
+		{
+		case 't': uiThreads = (uint32_t)strtoul(optarg, (char**)0, 0); break;
+		case 'e': uiEventsPerThread = (uint32_t)strtoul(optarg, (char**)0, 0); break;
+		case 'p': ulPadding = (uint64_t)strtoull(optarg, (char**)0, 0) * 1024u * 1024u; break;
+		case 'c': uiCore = 1u; break;
+		default: prvUsage(); break;
+		}
+	}
+
+	if ((optind != (argc - 1)) || (uiThreads == 0u) || (uiThreads > RB_TARGET_MAX_THREADS))
+	{
+		prvUsage();
+	}
+
+	if ((xTraceInitialize() == TRC_FAIL) || (xTraceEnable(TRC_START) == TRC_FAIL))
+	{
+		return 1;
+	}
+
+	for (i = 0u; i < uiThreads; i++)
+	{
+		(void)pthread_create(&xWorkers[i], (const pthread_attr_t*)0, prvWorker, (void*)(uintptr_t)i);
+	}
+
+	for (i = 0u; i < uiThreads; i++)
+	{
+		(void)pthread_join(xWorkers[i], (void**)0);
+	}
+
+	prvMakeDecoy(auiDecoy);
+
+	iFile = open(argv[optind], O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (iFile < 0)
+	{
+		fprintf(stderr, "Could not open %s.\n", argv[optind]);
+		return 1;
+	}
+
+	ulDataOffset = RB_TARGET_DECOY_SIZE + ulPadding;
+
+	if (uiCore != 0u)
+	{
+		/* ELF64 core, little endian, a segment for the decoy at an address of its
+		 * own and one for the stream port data at the address it has here */
+		ulDataOffset += sizeof(auiElf);
+
+		memcpy(auiElf, "\177ELF\2\1\1", 7u);
+		prvPut(&auiElf[16], 4u, 2u);								/* e_type ET_CORE */
+		prvPut(&auiElf[18], 62u, 2u);								/* e_machine EM_X86_64 */
+		prvPut(&auiElf[20], 1u, 4u);								/* e_version */
+		prvPut(&auiElf[32], RB_TARGET_ELF_HEADER_SIZE, 8u);			/* e_phoff */
+		prvPut(&auiElf[52], RB_TARGET_ELF_HEADER_SIZE, 2u);			/* e_ehsize */
+		prvPut(&auiElf[54], RB_TARGET_ELF_PROGRAM_HEADER_SIZE, 2u);	/* e_phentsize */
+		prvPut(&auiElf[56], 2u, 2u);								/* e_phnum */
+
+		for (i = 0u; i < 2u; i++)
+		{
+			puiPhdr = &auiElf[RB_TARGET_ELF_HEADER_SIZE + (i * RB_TARGET_ELF_PROGRAM_HEADER_SIZE)];
+
+			prvPut(&puiPhdr[0], 1u, 4u);							/* p_type PT_LOAD */
+			prvPut(&puiPhdr[4], 6u, 4u);							/* p_flags RW */
+			prvPut(&puiPhdr[8], (i == 0u) ? sizeof(auiElf) : ulDataOffset, 8u);
+			prvPut(&puiPhdr[16], (i == 0u) ? 0x10000u : (uint64_t)(uintptr_t)pxStreamPortData, 8u);
+			prvPut(&puiPhdr[32], (i == 0u) ? RB_TARGET_DECOY_SIZE : sizeof(TraceStreamPortData_t), 8u);
+			prvPut(&puiPhdr[40], (i == 0u) ? RB_TARGET_DECOY_SIZE : sizeof(TraceStreamPortData_t), 8u);
+		}
+
+		if (prvWrite(iFile, auiElf, sizeof(auiElf)) != 0)
+		{
+			return 1;
+		}
+	}
+
+	/* The padding is left as a hole, it reads as zeros */
+	if ((prvWrite(iFile, auiDecoy, sizeof(auiDecoy)) != 0) ||
+		(lseek(iFile, (off_t)ulDataOffset, SEEK_SET) != (off_t)ulDataOffset) ||
+		(prvWrite(iFile, pxStreamPortData, sizeof(TraceStreamPortData_t)) != 0) ||
+		(close(iFile) != 0))
+	{
+		fprintf(stderr, "Could not write %s.\n", argv[optind]);
+		return 1;
+	}
+
+	printf("%u events from %u threads, recorder at 0x%llx, dumped to %s",
+		(unsigned int)(uiThreads * uiEventsPerThread),
+		(unsigned int)uiThreads,
+		(unsigned long long)(uintptr_t)&pxStreamPortData->xRingBuffer.START_MARKERS,
+		argv[optind]);
+
+	if (uiCore == 0u)
+	{
+		printf(", extract with -a 0x%llx", (unsigned long long)((uintptr_t)pxStreamPortData - ulDataOffset));
+	}
+
+	printf("\n");
+
+	return 0;
+}
@@ -0,0 +1,866 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Post-mortem extractor for the RingBuffer stream port. The target's layout
+ * (endianness, sizeof(TraceUnsignedBaseType_t), core count, entry table size)
+ * is taken from the dump itself, so this builds once for all targets.
+ */
+
+#include <trcRingBufferExtractor.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define RB_DUMP_MARKER_SIZE 12u
+#define RB_DUMP_SCAN_CHUNK_SIZE (1024u * 1024u)
+#define RB_DUMP_WINDOW_SIZE (64u * 1024u)
+
+#define RB_DUMP_PSF_IDENTIFIER 0x50534600u		/* TRACE_PSF_ENDIANESS_IDENTIFIER */
+#define RB_DUMP_HEADER_SIZE 32u					/* TraceHeader_t */
+#define RB_DUMP_HEADER_OPTION_64BIT 0x8u
+#define RB_DUMP_ENTRY_STATE_COUNT 3u			/* TRC_ENTRY_TABLE_STATE_COUNT */
+#define RB_DUMP_MAX_ENTRY_SLOTS (1024u * 1024u)
+#define RB_DUMP_MAX_ENTRY_SYMBOL_SIZE 4096u
+#define RB_DUMP_EVENT_HEADER_SIZE 8u			/* TraceEvent0_t */
+#define RB_DUMP_EVENT_BUFFER_FIELDS_SIZE 40u	/* TraceEventBuffer_t, up to puiBuffer */
+#define RB_DUMP_EVENT_BUFFER_OPTION_MAX 1u		/* TRC_EVENT_BUFFER_OPTION_OVERWRITE */
+
+#define RB_DUMP_ELF_HEADER_SIZE 64u
+#define RB_DUMP_ELF_PROGRAM_HEADER_SIZE 56u
+#define RB_DUMP_ELF_TYPE_CORE 4u
+#define RB_DUMP_ELF_PT_LOAD 1u
+#define RB_DUMP_ELF_PN_XNUM 0xFFFFu
+
+/* Reads one core's events, from uiTail up to uiSize - uiSlack and then from 0
+ * up to uiHead, through a window so that large buffers aren't read whole */
+typedef struct RingBufferDumpCursor
+{
+	uint64_t ulDataAddress;
+	uint32_t uiPosition;
+	uint32_t uiEnd;
+	uint32_t uiNextEnd;				/* End of the second span, from 0, if there is one */
+	uint32_t uiWindowPosition;
+	uint32_t uiWindowLength;
+	uint32_t uiEventSize;			/* Event at uiPosition, 0 when there are no more */
+	uint32_t uiTimestamp;
+	uint8_t* puiWindow;
+} RingBufferDumpCursor_t;
+
+static const uint8_t auiStartMarkers[RB_DUMP_MARKER_SIZE] = { 0x05u, 0x06u, 0x07u, 0x08u, 0x75u, 0x76u, 0x77u, 0x78u, 0xF5u, 0xF6u, 0xF7u, 0xF8u };
+static const uint8_t auiEndMarkers[RB_DUMP_MARKER_SIZE] = { 0x0Au, 0x0Bu, 0x0Cu, 0x0Du, 0x71u, 0x72u, 0x73u, 0x74u, 0xF1u, 0xF2u, 0xF3u, 0xF4u };
+
+static uint32_t prvGet16(uint32_t uiBigEndian, const uint8_t* puiData)
+{
+	if (uiBigEndian != 0u)
+	{
+		return ((uint32_t)puiData[0] << 8) | (uint32_t)puiData[1];
+	}
+
+	return ((uint32_t)puiData[1] << 8) | (uint32_t)puiData[0];
+}
+
+static uint32_t prvGet32(uint32_t uiBigEndian, const uint8_t* puiData)
+{
+	if (uiBigEndian != 0u)
+	{
+		return (prvGet16(1u, puiData) << 16) | prvGet16(1u, &puiData[2]);
+	}
+
+	return (prvGet16(0u, &puiData[2]) << 16) | prvGet16(0u, puiData);
+}
+
+static uint64_t prvGet64(uint32_t uiBigEndian, const uint8_t* puiData)
+{
+	if (uiBigEndian != 0u)
+	{
+		return ((uint64_t)prvGet32(1u, puiData) << 32) | prvGet32(1u, &puiData[4]);
+	}
+
+	return ((uint64_t)prvGet32(0u, &puiData[4]) << 32) | prvGet32(0u, puiData);
+}
+
+/* TraceUnsignedBaseType_t, or a pointer */
+static uint64_t prvGetBase(const TraceRingBufferDumpRecorder_t* pxRecorder, const uint8_t* puiData)
+{
+	if (pxRecorder->uiBaseSize == 8u)
+	{
+		return prvGet64(pxRecorder->uiBigEndian, puiData);
+	}
+
+	return prvGet32(pxRecorder->uiBigEndian, puiData);
+}
+
+static void prvSetBase(const TraceRingBufferDumpRecorder_t* pxRecorder, uint8_t* puiData, uint64_t ulValue)
+{
+	uint32_t i;
+
+	for (i = 0u; i < pxRecorder->uiBaseSize; i++)
+	{
+		if (pxRecorder->uiBigEndian != 0u)
+		{
+			puiData[pxRecorder->uiBaseSize - 1u - i] = (uint8_t)(ulValue >> (8u * i));
+		}
+		else
+		{
+			puiData[i] = (uint8_t)(ulValue >> (8u * i));
+		}
+	}
+}
+
+static int32_t prvReadFile(int iFile, void* pvData, uint64_t ulSize, uint64_t ulOffset)
+{
+	uint8_t* puiData = (uint8_t*)pvData;
+	ssize_t iRead;
+
+	while (ulSize > 0u)
+	{
+		iRead = pread(iFile, puiData, (size_t)ulSize, (off_t)ulOffset);
+		if (iRead < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			return -1;
+		}
+
+		if (iRead == 0)
+		{
+			/* The file is shorter than its headers say */
+			return -1;
+		}
+
+		puiData = &puiData[iRead];
+		ulSize -= (uint64_t)iRead;
+		ulOffset += (uint64_t)iRead;
+	}
+
+	return 0;
+}
+
+/* Reads target memory. A range can span segments that follow each other. */
+static int32_t prvRead(const TraceRingBufferDump_t* pxDump, uint64_t ulAddress, void* pvData, uint64_t ulSize)
+{
+	const TraceRingBufferDumpSegment_t* pxSegment;
+	uint8_t* puiData = (uint8_t*)pvData;
+	uint64_t ulLength;
+	uint32_t i;
+
+	while (ulSize > 0u)
+	{
+		pxSegment = (const TraceRingBufferDumpSegment_t*)0;
+
+		for (i = 0u; i < pxDump->uiSegmentCount; i++)
+		{
+			if ((ulAddress >= pxDump->pxSegments[i].ulAddress) && ((ulAddress - pxDump->pxSegments[i].ulAddress) < pxDump->pxSegments[i].ulSize))
+			{
+				pxSegment = &pxDump->pxSegments[i];
+				break;
+			}
+		}
+
+		if (pxSegment == (const TraceRingBufferDumpSegment_t*)0)
+		{
+			/* Not in the dump */
+			return -1;
+		}
+
+		ulLength = pxSegment->ulSize - (ulAddress - pxSegment->ulAddress);
+		if (ulLength > ulSize)
+		{
+			ulLength = ulSize;
+		}
+
+		if (prvReadFile(pxDump->iFile, puiData, ulLength, pxSegment->ulOffset + (ulAddress - pxSegment->ulAddress)) != 0)
+		{
+			return -1;
+		}
+
+		puiData = &puiData[ulLength];
+		ulAddress += ulLength;
+		ulSize -= ulLength;
+	}
+
+	return 0;
+}
+
+static int prvCompareSegments(const void* pvA, const void* pvB)
+{
+	const TraceRingBufferDumpSegment_t* pxA = (const TraceRingBufferDumpSegment_t*)pvA;
+	const TraceRingBufferDumpSegment_t* pxB = (const TraceRingBufferDumpSegment_t*)pvB;
+
+	return (pxA->ulAddress > pxB->ulAddress) - (pxA->ulAddress < pxB->ulAddress);
+}
+
+/* The PT_LOAD segments of an ELF32/ELF64 core file, of either endianness */
+static int32_t prvOpenCore(TraceRingBufferDump_t* pxDump, const uint8_t* puiHeader, uint64_t ulFileSize)
+{
+	uint8_t auiProgramHeader[RB_DUMP_ELF_PROGRAM_HEADER_SIZE];
+	uint8_t auiSectionHeader[RB_DUMP_ELF_HEADER_SIZE];
+	uint32_t uiIs64 = (puiHeader[4] == 2u);
+	uint32_t uiBigEndian = (puiHeader[5] == 2u);
+	uint64_t ulProgramHeaders, ulSectionHeaders;
+	uint64_t ulOffset, ulAddress, ulSize;
+	uint32_t uiEntrySize, uiCount;
+	uint32_t i;
+
+	if (((puiHeader[4] != 1u) && (puiHeader[4] != 2u)) || ((puiHeader[5] != 1u) && (puiHeader[5] != 2u)))
+	{
+		return -1;
+	}
+
+	if (prvGet16(uiBigEndian, &puiHeader[16]) != RB_DUMP_ELF_TYPE_CORE)
+	{
+		return -1;
+	}
+
+	if (uiIs64 != 0u)
+	{
+		ulProgramHeaders = prvGet64(uiBigEndian, &puiHeader[32]);
+		ulSectionHeaders = prvGet64(uiBigEndian, &puiHeader[40]);
+		uiEntrySize = prvGet16(uiBigEndian, &puiHeader[54]);
+		uiCount = prvGet16(uiBigEndian, &puiHeader[56]);
+	}
+	else
+	{
+		ulProgramHeaders = prvGet32(uiBigEndian, &puiHeader[28]);
+		ulSectionHeaders = prvGet32(uiBigEndian, &puiHeader[32]);
+		uiEntrySize = prvGet16(uiBigEndian, &puiHeader[42]);
+		uiCount = prvGet16(uiBigEndian, &puiHeader[44]);
+	}
+
+	if (uiCount == RB_DUMP_ELF_PN_XNUM)
+	{
+		/* Too many segments for e_phnum, the count is in sh_info of section 0 */
+		if (prvReadFile(pxDump->iFile, auiSectionHeader, (uiIs64 != 0u) ? 64u : 40u, ulSectionHeaders) != 0)
+		{
+			return -1;
+		}
+
+		uiCount = prvGet32(uiBigEndian, &auiSectionHeader[(uiIs64 != 0u) ? 44u : 28u]);
+	}
+
+	if ((uiEntrySize < ((uiIs64 != 0u) ? 56u : 32u)) || (uiCount == 0u))
+	{
+		return -1;
+	}
+
+	pxDump->pxSegments = (TraceRingBufferDumpSegment_t*)calloc(uiCount, sizeof(TraceRingBufferDumpSegment_t));
+	if (pxDump->pxSegments == (TraceRingBufferDumpSegment_t*)0)
+	{
+		return -1;
+	}
+
+	for (i = 0u; i < uiCount; i++)
+	{
+		if (prvReadFile(pxDump->iFile, auiProgramHeader, (uiIs64 != 0u) ? 56u : 32u, ulProgramHeaders + ((uint64_t)i * uiEntrySize)) != 0)
+		{
+			return -1;
+		}
+
+		if (prvGet32(uiBigEndian, auiProgramHeader) != RB_DUMP_ELF_PT_LOAD)
+		{
+			continue;
+		}
+
+		if (uiIs64 != 0u)
+		{
+			ulOffset = prvGet64(uiBigEndian, &auiProgramHeader[8]);
+			ulAddress = prvGet64(uiBigEndian, &auiProgramHeader[16]);
+			ulSize = prvGet64(uiBigEndian, &auiProgramHeader[32]);
+		}
+		else
+		{
+			ulOffset = prvGet32(uiBigEndian, &auiProgramHeader[4]);
+			ulAddress = prvGet32(uiBigEndian, &auiProgramHeader[8]);
+			ulSize = prvGet32(uiBigEndian, &auiProgramHeader[16]);
+		}
+
+		/* Segments that weren't dumped have no file size, and a truncated
+		 * core holds less than its headers say */
+		if (ulOffset >= ulFileSize)
+		{
+			continue;
+		}
+		if (ulSize > (ulFileSize - ulOffset))
+		{
+			ulSize = ulFileSize - ulOffset;
+		}
+		if (ulSize == 0u)
+		{
+			continue;
+		}
+
+		pxDump->pxSegments[pxDump->uiSegmentCount].ulAddress = ulAddress;
+		pxDump->pxSegments[pxDump->uiSegmentCount].ulOffset = ulOffset;
+		pxDump->pxSegments[pxDump->uiSegmentCount].ulSize = ulSize;
+		pxDump->uiSegmentCount++;
+	}
+
+	qsort(pxDump->pxSegments, pxDump->uiSegmentCount, sizeof(TraceRingBufferDumpSegment_t), prvCompareSegments);
+
+	pxDump->uiIsCore = 1u;
+
+	return 0;
+}
+
+int32_t xTraceRingBufferDumpOpen(TraceRingBufferDump_t* pxDump, const char* szPath, uint64_t ulRawAddress)
+{
+	uint8_t auiHeader[RB_DUMP_ELF_HEADER_SIZE];
+	struct stat xStat;
+
+	memset(pxDump, 0, sizeof(TraceRingBufferDump_t));
+
+	pxDump->iFile = open(szPath, O_RDONLY);
+	if (pxDump->iFile < 0)
+	{
+		return -1;
+	}
+
+	if (fstat(pxDump->iFile, &xStat) != 0)
+	{
+		vTraceRingBufferDumpClose(pxDump);
+
+		return -1;
+	}
+
+	(void)posix_fadvise(pxDump->iFile, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+	if (((uint64_t)xStat.st_size >= RB_DUMP_ELF_HEADER_SIZE) &&
+		(prvReadFile(pxDump->iFile, auiHeader, RB_DUMP_ELF_HEADER_SIZE, 0u) == 0) &&
+		(memcmp(auiHeader, "\177ELF", 4u) == 0))
+	{
+		if (prvOpenCore(pxDump, auiHeader, (uint64_t)xStat.st_size) != 0)
+		{
+			vTraceRingBufferDumpClose(pxDump);
+
+			return -1;
+		}
+
+		return 0;
+	}
+
+	pxDump->pxSegments = (TraceRingBufferDumpSegment_t*)calloc(1u, sizeof(TraceRingBufferDumpSegment_t));
+	if (pxDump->pxSegments == (TraceRingBufferDumpSegment_t*)0)
+	{
+		vTraceRingBufferDumpClose(pxDump);
+
+		return -1;
+	}
+
+	pxDump->pxSegments[0].ulAddress = ulRawAddress;
+	pxDump->pxSegments[0].ulOffset = 0u;
+	pxDump->pxSegments[0].ulSize = (uint64_t)xStat.st_size;
+	pxDump->uiSegmentCount = 1u;
+
+	return 0;
+}
+
+static int32_t prvValidateCores(const TraceRingBufferDump_t* pxDump, TraceRingBufferDumpRecorder_t* pxRecorder)
+{
+	uint8_t auiEventBuffer[RB_DUMP_EVENT_BUFFER_FIELDS_SIZE + 8u];
+	TraceRingBufferDumpCore_t* pxCore;
+	uint32_t uiStructSize = RB_DUMP_EVENT_BUFFER_FIELDS_SIZE + pxRecorder->uiBaseSize;
+	uint32_t uiRegionSize;
+	uint64_t ulBuffer, ulFirstBuffer = 0u;
+	uint32_t i;
+
+	/* As xTraceMultiCoreEventBufferInitialize() splits it, each core's region
+	 * begins with its TraceEventBuffer_t */
+	uiRegionSize = ((pxRecorder->uiEventBufferSize / pxRecorder->uiCoreCount) / pxRecorder->uiBaseSize) * pxRecorder->uiBaseSize;
+
+	for (i = 0u; i < pxRecorder->uiCoreCount; i++)
+	{
+		pxCore = &pxRecorder->xCores[i];
+		pxCore->ulAddress = pxRecorder->ulEventBufferAddress + ((uint64_t)i * uiRegionSize);
+		pxCore->ulDataAddress = pxCore->ulAddress + uiStructSize;
+
+		if (prvRead(pxDump, pxCore->ulAddress, auiEventBuffer, uiStructSize) != 0)
+		{
+			return -1;
+		}
+
+		pxCore->uiHead = prvGet32(pxRecorder->uiBigEndian, &auiEventBuffer[0]);
+		pxCore->uiTail = prvGet32(pxRecorder->uiBigEndian, &auiEventBuffer[4]);
+		pxCore->uiSize = prvGet32(pxRecorder->uiBigEndian, &auiEventBuffer[8]);
+		pxCore->uiOptions = prvGet32(pxRecorder->uiBigEndian, &auiEventBuffer[12]);
+		pxCore->uiDroppedEvents = prvGet32(pxRecorder->uiBigEndian, &auiEventBuffer[16]);
+		pxCore->uiSlack = prvGet32(pxRecorder->uiBigEndian, &auiEventBuffer[24]);
+		ulBuffer = prvGetBase(pxRecorder, &auiEventBuffer[RB_DUMP_EVENT_BUFFER_FIELDS_SIZE]);
+
+		if ((pxCore->uiSize != (uiRegionSize - uiStructSize)) ||
+			(pxCore->uiHead >= pxCore->uiSize) ||
+			(pxCore->uiTail >= pxCore->uiSize) ||
+			(pxCore->uiSlack > pxCore->uiSize) ||
+			(pxCore->uiOptions > RB_DUMP_EVENT_BUFFER_OPTION_MAX))
+		{
+			return -1;
+		}
+
+		/* puiBuffer holds target addresses. Only a core file says where the
+		 * dump is in the target's address space, otherwise check that the
+		 * cores' buffers are as far apart as their regions. */
+		if (i == 0u)
+		{
+			ulFirstBuffer = ulBuffer;
+
+			if ((pxDump->uiIsCore != 0u) && (ulBuffer != pxCore->ulDataAddress))
+			{
+				return -1;
+			}
+		}
+		else if ((ulBuffer - ulFirstBuffer) != ((uint64_t)i * uiRegionSize))
+		{
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/* Checks a TraceRingBuffer_t whose START_MARKERS are at ulAddress */
+static int32_t prvValidate(const TraceRingBufferDump_t* pxDump, uint64_t ulAddress, TraceRingBufferDumpRecorder_t* pxRecorder)
+{
+	uint8_t auiHeader[RB_DUMP_HEADER_SIZE];
+	uint8_t auiData[3u * 8u];
+	uint8_t auiMarkers[RB_DUMP_MARKER_SIZE];
+	uint64_t ulSlots, ulSymbolSize, ulEventBufferSize;
+	uint32_t uiNumCores;
+
+	memset(pxRecorder, 0, sizeof(TraceRingBufferDumpRecorder_t));
+	pxRecorder->ulAddress = ulAddress;
+
+	/* xHeaderBuffer follows START_MARKERS */
+	if (prvRead(pxDump, ulAddress + RB_DUMP_MARKER_SIZE, auiHeader, sizeof(auiHeader)) != 0)
+	{
+		return -1;
+	}
+
+	if (prvGet32(0u, auiHeader) == RB_DUMP_PSF_IDENTIFIER)
+	{
+		pxRecorder->uiBigEndian = 0u;
+	}
+	else if (prvGet32(1u, auiHeader) == RB_DUMP_PSF_IDENTIFIER)
+	{
+		pxRecorder->uiBigEndian = 1u;
+	}
+	else
+	{
+		return -1;
+	}
+
+	pxRecorder->uiVersion = prvGet16(pxRecorder->uiBigEndian, &auiHeader[4]);
+	pxRecorder->uiBaseSize = ((prvGet32(pxRecorder->uiBigEndian, &auiHeader[8]) & RB_DUMP_HEADER_OPTION_64BIT) != 0u) ? 8u : 4u;
+
+	/* The core count is in the low byte, the stream count above it */
+	uiNumCores = prvGet32(pxRecorder->uiBigEndian, &auiHeader[12]);
+	pxRecorder->uiCoreCount = uiNumCores & 0xFFu;
+
+	if ((pxRecorder->uiVersion == 0u) || (pxRecorder->uiCoreCount == 0u) || (pxRecorder->uiCoreCount > TRC_RING_BUFFER_DUMP_MAX_CORES))
+	{
+		return -1;
+	}
+
+	/* xEntryTable follows xHeaderBuffer and xTimestampInfo (TraceTimestampData_t) */
+	pxRecorder->ulEntryTableAddress = ulAddress + RB_DUMP_MARKER_SIZE + RB_DUMP_HEADER_SIZE + 24u + pxRecorder->uiBaseSize;
+
+	if (prvRead(pxDump, pxRecorder->ulEntryTableAddress, auiData, 3u * pxRecorder->uiBaseSize) != 0)
+	{
+		return -1;
+	}
+
+	ulSlots = prvGetBase(pxRecorder, &auiData[0]);
+	ulSymbolSize = prvGetBase(pxRecorder, &auiData[pxRecorder->uiBaseSize]);
+
+	if ((prvGetBase(pxRecorder, &auiData[2u * pxRecorder->uiBaseSize]) != RB_DUMP_ENTRY_STATE_COUNT) ||
+		(ulSlots == 0u) || (ulSlots > RB_DUMP_MAX_ENTRY_SLOTS) ||
+		(ulSymbolSize < 4u) || (ulSymbolSize > RB_DUMP_MAX_ENTRY_SYMBOL_SIZE))
+	{
+		return -1;
+	}
+
+	pxRecorder->uiEntrySlots = (uint32_t)ulSlots;
+	pxRecorder->uiEntrySymbolSize = (uint32_t)ulSymbolSize;
+
+	/* pvAddress, xStates, uiOptions and szSymbol, which is sized to keep TraceEntry_t aligned */
+	pxRecorder->uiEntrySize = pxRecorder->uiBaseSize + (RB_DUMP_ENTRY_STATE_COUNT * pxRecorder->uiBaseSize) + 4u + pxRecorder->uiEntrySymbolSize;
+	if ((pxRecorder->uiEntrySize % pxRecorder->uiBaseSize) != 0u)
+	{
+		return -1;
+	}
+
+	/* xEventBuffer follows the entry table, uxSize and then the buffer */
+	pxRecorder->ulEventBufferAddress = pxRecorder->ulEntryTableAddress + (3u * pxRecorder->uiBaseSize) + ((uint64_t)pxRecorder->uiEntrySlots * pxRecorder->uiEntrySize);
+
+	if (prvRead(pxDump, pxRecorder->ulEventBufferAddress, auiData, pxRecorder->uiBaseSize) != 0)
+	{
+		return -1;
+	}
+
+	ulEventBufferSize = prvGetBase(pxRecorder, auiData);
+	pxRecorder->ulEventBufferAddress += pxRecorder->uiBaseSize;
+
+	if ((ulEventBufferSize > 0xFFFFFFFFu) ||
+		(ulEventBufferSize < ((uint64_t)pxRecorder->uiCoreCount * (RB_DUMP_EVENT_BUFFER_FIELDS_SIZE + (2u * pxRecorder->uiBaseSize)))))
+	{
+		return -1;
+	}
+
+	pxRecorder->uiEventBufferSize = (uint32_t)ulEventBufferSize;
+
+	if ((prvRead(pxDump, pxRecorder->ulEventBufferAddress + pxRecorder->uiEventBufferSize, auiMarkers, sizeof(auiMarkers)) != 0) ||
+		(memcmp(auiMarkers, auiEndMarkers, sizeof(auiMarkers)) != 0))
+	{
+		return -1;
+	}
+
+	return prvValidateCores(pxDump, pxRecorder);
+}
+
+int32_t xTraceRingBufferDumpFind(const TraceRingBufferDump_t* pxDump, uint64_t ulFromAddress, TraceRingBufferDumpRecorder_t* pxRecorder)
+{
+	const TraceRingBufferDumpSegment_t* pxSegment;
+	const uint8_t* puiMatch;
+	uint8_t* puiChunk;
+	uint64_t ulPosition;
+	uint32_t uiLength, uiIndex;
+	uint32_t i;
+
+	puiChunk = (uint8_t*)malloc(RB_DUMP_SCAN_CHUNK_SIZE);
+	if (puiChunk == (uint8_t*)0)
+	{
+		return -1;
+	}
+
+	for (i = 0u; i < pxDump->uiSegmentCount; i++)
+	{
+		pxSegment = &pxDump->pxSegments[i];
+
+		if ((pxSegment->ulAddress + pxSegment->ulSize) <= ulFromAddress)
+		{
+			continue;
+		}
+
+		ulPosition = (ulFromAddress > pxSegment->ulAddress) ? (ulFromAddress - pxSegment->ulAddress) : 0u;
+
+		while ((ulPosition + RB_DUMP_MARKER_SIZE) <= pxSegment->ulSize)
+		{
+			uiLength = ((pxSegment->ulSize - ulPosition) < RB_DUMP_SCAN_CHUNK_SIZE) ? (uint32_t)(pxSegment->ulSize - ulPosition) : RB_DUMP_SCAN_CHUNK_SIZE;
+
+			if (prvReadFile(pxDump->iFile, puiChunk, uiLength, pxSegment->ulOffset + ulPosition) != 0)
+			{
+				free(puiChunk);
+
+				return -1;
+			}
+
+			uiIndex = 0u;
+			while ((uiIndex + RB_DUMP_MARKER_SIZE) <= uiLength)
+			{
+				puiMatch = (const uint8_t*)memchr(&puiChunk[uiIndex], auiStartMarkers[0], uiLength - RB_DUMP_MARKER_SIZE + 1u - uiIndex);
+				if (puiMatch == (const uint8_t*)0)
+				{
+					break;
+				}
+
+				uiIndex = (uint32_t)(puiMatch - puiChunk);
+
+				if ((memcmp(puiMatch, auiStartMarkers, RB_DUMP_MARKER_SIZE) == 0) &&
+					(prvValidate(pxDump, pxSegment->ulAddress + ulPosition + uiIndex, pxRecorder) == 0))
+				{
+					free(puiChunk);
+
+					return 0;
+				}
+
+				uiIndex++;
+			}
+
+			/* The next chunk overlaps this one by a marker, less a byte, so that
+			 * markers across chunks are found */
+			ulPosition += uiLength - (RB_DUMP_MARKER_SIZE - 1u);
+		}
+	}
+
+	free(puiChunk);
+
+	return -1;
+}
+
+/* Makes [uiPosition, uiPosition + uiSize) available in the window */
+static int32_t prvCursorFill(const TraceRingBufferDump_t* pxDump, RingBufferDumpCursor_t* pxCursor, uint32_t uiSize)
+{
+	if ((pxCursor->uiPosition >= pxCursor->uiWindowPosition) &&
+		((pxCursor->uiPosition + uiSize) <= (pxCursor->uiWindowPosition + pxCursor->uiWindowLength)))
+	{
+		return 0;
+	}
+
+	pxCursor->uiWindowPosition = pxCursor->uiPosition;
+	pxCursor->uiWindowLength = pxCursor->uiEnd - pxCursor->uiPosition;
+	if (pxCursor->uiWindowLength > RB_DUMP_WINDOW_SIZE)
+	{
+		pxCursor->uiWindowLength = RB_DUMP_WINDOW_SIZE;
+	}
+
+	return prvRead(pxDump, pxCursor->ulDataAddress + pxCursor->uiWindowPosition, pxCursor->puiWindow, pxCursor->uiWindowLength);
+}
+
+/* Finds the event at the cursor, or the end of the core's data */
+static int32_t prvCursorLoad(const TraceRingBufferDump_t* pxDump, const TraceRingBufferDumpRecorder_t* pxRecorder, RingBufferDumpCursor_t* pxCursor, uint32_t* puiCorruptBytes)
+{
+	const uint8_t* puiEvent;
+	uint32_t uiRemaining;
+
+	for (;;)
+	{
+		if (pxCursor->uiPosition == pxCursor->uiEnd)
+		{
+			if (pxCursor->uiNextEnd == 0u)
+			{
+				pxCursor->uiEventSize = 0u;
+
+				return 0;
+			}
+
+			pxCursor->uiPosition = 0u;
+			pxCursor->uiEnd = pxCursor->uiNextEnd;
+			pxCursor->uiNextEnd = 0u;
+			pxCursor->uiWindowLength = 0u;
+
+			continue;
+		}
+
+		uiRemaining = pxCursor->uiEnd - pxCursor->uiPosition;
+
+		if (uiRemaining >= RB_DUMP_EVENT_HEADER_SIZE)
+		{
+			if (prvCursorFill(pxDump, pxCursor, RB_DUMP_EVENT_HEADER_SIZE) != 0)
+			{
+				return -1;
+			}
+
+			puiEvent = &pxCursor->puiWindow[pxCursor->uiPosition - pxCursor->uiWindowPosition];
+
+			/* The parameter count is in the top bits of the event ID */
+			pxCursor->uiEventSize = RB_DUMP_EVENT_HEADER_SIZE + (((prvGet16(pxRecorder->uiBigEndian, puiEvent) >> 12) & 0xFu) * pxRecorder->uiBaseSize);
+			pxCursor->uiTimestamp = prvGet32(pxRecorder->uiBigEndian, &puiEvent[4]);
+
+			if (pxCursor->uiEventSize <= uiRemaining)
+			{
+				return prvCursorFill(pxDump, pxCursor, pxCursor->uiEventSize);
+			}
+		}
+
+		/* Events never straddle the end of a span, this isn't an event */
+		*puiCorruptBytes += uiRemaining;
+		pxCursor->uiPosition = pxCursor->uiEnd;
+	}
+}
+
+static int32_t prvWrite(TraceRingBufferDumpWrite_t xWrite, void* pvUser, const void* pvData, uint32_t uiSize, TraceRingBufferDumpStatistics_t* pxStatistics)
+{
+	if (xWrite(pvUser, pvData, uiSize) != 0)
+	{
+		return -1;
+	}
+
+	pxStatistics->ulBytes += uiSize;
+
+	return 0;
+}
+
+/* The header, timestamp info and entry table, as prvSetRecorderEnabled() stores them when not using TRC_EXTERNAL_BUFFERS */
+static int32_t prvExtractTables(const TraceRingBufferDump_t* pxDump, const TraceRingBufferDumpRecorder_t* pxRecorder, TraceRingBufferDumpWrite_t xWrite, void* pvUser, TraceRingBufferDumpStatistics_t* pxStatistics, uint8_t* puiBuffer)
+{
+	uint64_t ulEntries = pxRecorder->ulEntryTableAddress + (3u * pxRecorder->uiBaseSize);
+	uint32_t uiTablesSize = RB_DUMP_HEADER_SIZE + 24u + pxRecorder->uiBaseSize;
+	uint32_t uiChunkSlots = RB_DUMP_WINDOW_SIZE / pxRecorder->uiEntrySize;
+	uint32_t uiSlots, uiPass;
+	uint32_t i, j;
+
+	if ((prvRead(pxDump, pxRecorder->ulAddress + RB_DUMP_MARKER_SIZE, puiBuffer, uiTablesSize) != 0) ||
+		(prvWrite(xWrite, pvUser, puiBuffer, uiTablesSize, pxStatistics) != 0))
+	{
+		return -1;
+	}
+
+	/* Only used slots are stored, after their count. The first pass counts them. */
+	for (uiPass = 0u; uiPass < 2u; uiPass++)
+	{
+		if (uiPass == 1u)
+		{
+			prvSetBase(pxRecorder, &puiBuffer[0], pxStatistics->uiEntries);
+			prvSetBase(pxRecorder, &puiBuffer[pxRecorder->uiBaseSize], pxRecorder->uiEntrySymbolSize);
+			prvSetBase(pxRecorder, &puiBuffer[2u * pxRecorder->uiBaseSize], RB_DUMP_ENTRY_STATE_COUNT);
+
+			if (prvWrite(xWrite, pvUser, puiBuffer, 3u * pxRecorder->uiBaseSize, pxStatistics) != 0)
+			{
+				return -1;
+			}
+		}
+
+		for (i = 0u; i < pxRecorder->uiEntrySlots; i += uiSlots)
+		{
+			uiSlots = ((pxRecorder->uiEntrySlots - i) < uiChunkSlots) ? (pxRecorder->uiEntrySlots - i) : uiChunkSlots;
+
+			if (prvRead(pxDump, ulEntries + ((uint64_t)i * pxRecorder->uiEntrySize), puiBuffer, (uint64_t)uiSlots * pxRecorder->uiEntrySize) != 0)
+			{
+				return -1;
+			}
+
+			for (j = 0u; j < uiSlots; j++)
+			{
+				/* pvAddress is null in unused slots */
+				if (prvGetBase(pxRecorder, &puiBuffer[j * pxRecorder->uiEntrySize]) == 0u)
+				{
+					continue;
+				}
+
+				if (uiPass == 0u)
+				{
+					pxStatistics->uiEntries++;
+				}
+				else if (prvWrite(xWrite, pvUser, &puiBuffer[j * pxRecorder->uiEntrySize], pxRecorder->uiEntrySize, pxStatistics) != 0)
+				{
+					return -1;
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+
+/* Each core's events are in order, merges them by their 32-bit timestamps,
+ * which can wrap around */
+static int32_t prvExtractEvents(const TraceRingBufferDump_t* pxDump, const TraceRingBufferDumpRecorder_t* pxRecorder, TraceRingBufferDumpWrite_t xWrite, void* pvUser, TraceRingBufferDumpStatistics_t* pxStatistics, uint8_t* puiWindows)
+{
+	RingBufferDumpCursor_t xCursors[TRC_RING_BUFFER_DUMP_MAX_CORES];
+	const TraceRingBufferDumpCore_t* pxCore;
+	RingBufferDumpCursor_t* pxCursor;
+	uint32_t uiNext;
+	uint32_t i;
+
+	memset(xCursors, 0, sizeof(xCursors));
+
+	for (i = 0u; i < pxRecorder->uiCoreCount; i++)
+	{
+		pxCore = &pxRecorder->xCores[i];
+		pxCursor = &xCursors[i];
+
+		pxCursor->ulDataAddress = pxCore->ulDataAddress;
+		pxCursor->puiWindow = &puiWindows[(size_t)i * RB_DUMP_WINDOW_SIZE];
+		pxCursor->uiPosition = pxCore->uiTail;
+
+		if (pxCore->uiHead >= pxCore->uiTail)
+		{
+			pxCursor->uiEnd = pxCore->uiHead;
+		}
+		else
+		{
+			/* Wrapped, the end of the buffer is slack that was too small for the
+			 * event that wrapped. A tail in the slack hasn't been wrapped yet. */
+			pxCursor->uiEnd = pxCore->uiSize - pxCore->uiSlack;
+			if (pxCursor->uiPosition > pxCursor->uiEnd)
+			{
+				pxCursor->uiPosition = pxCursor->uiEnd;
+			}
+
+			pxCursor->uiNextEnd = pxCore->uiHead;
+		}
+
+		if (prvCursorLoad(pxDump, pxRecorder, pxCursor, &pxStatistics->uiCorruptBytes[i]) != 0)
+		{
+			return -1;
+		}
+	}
+
+	for (;;)
+	{
+		uiNext = TRC_RING_BUFFER_DUMP_MAX_CORES;
+
+		for (i = 0u; i < pxRecorder->uiCoreCount; i++)
+		{
+			if ((xCursors[i].uiEventSize != 0u) &&
+				((uiNext == TRC_RING_BUFFER_DUMP_MAX_CORES) || ((int32_t)(xCursors[i].uiTimestamp - xCursors[uiNext].uiTimestamp) < 0)))
+			{
+				uiNext = i;
+			}
+		}
+
+		if (uiNext == TRC_RING_BUFFER_DUMP_MAX_CORES)
+		{
+			return 0;
+		}
+
+		pxCursor = &xCursors[uiNext];
+
+		if (prvWrite(xWrite, pvUser, &pxCursor->puiWindow[pxCursor->uiPosition - pxCursor->uiWindowPosition], pxCursor->uiEventSize, pxStatistics) != 0)
+		{
+			return -1;
+		}
+
+		pxStatistics->uiEvents[uiNext]++;
+		pxCursor->uiPosition += pxCursor->uiEventSize;
+
+		if (prvCursorLoad(pxDump, pxRecorder, pxCursor, &pxStatistics->uiCorruptBytes[uiNext]) != 0)
+		{
+			return -1;
+		}
+	}
+}
+
+int32_t xTraceRingBufferDumpExtract(const TraceRingBufferDump_t* pxDump, const TraceRingBufferDumpRecorder_t* pxRecorder, TraceRingBufferDumpWrite_t xWrite, void* pvUser, TraceRingBufferDumpStatistics_t* pxStatistics)
+{
+	TraceRingBufferDumpStatistics_t xStatistics;
+	uint8_t* puiWindows;
+	int32_t iResult;
+
+	if (pxStatistics == (TraceRingBufferDumpStatistics_t*)0)
+	{
+		pxStatistics = &xStatistics;
+	}
+
+	memset(pxStatistics, 0, sizeof(TraceRingBufferDumpStatistics_t));
+
+	/* One window per core, and one for the tables */
+	puiWindows = (uint8_t*)malloc((size_t)(pxRecorder->uiCoreCount + 1u) * RB_DUMP_WINDOW_SIZE);
+	if (puiWindows == (uint8_t*)0)
+	{
+		return -1;
+	}
+
+	iResult = prvExtractTables(pxDump, pxRecorder, xWrite, pvUser, pxStatistics, &puiWindows[(size_t)pxRecorder->uiCoreCount * RB_DUMP_WINDOW_SIZE]);
+
+	if (iResult == 0)
+	{
+		iResult = prvExtractEvents(pxDump, pxRecorder, xWrite, pvUser, pxStatistics, puiWindows);
+	}
+
+	free(puiWindows);
+
+	return iResult;
+}
+
+void vTraceRingBufferDumpClose(TraceRingBufferDump_t* pxDump)
+{
+	if (pxDump->iFile >= 0)
+	{
+		(void)close(pxDump->iFile);
+	}
+
+	free(pxDump->pxSegments);
+
+	pxDump->iFile = -1;
+	pxDump->pxSegments = (TraceRingBufferDumpSegment_t*)0;
+	pxDump->uiSegmentCount = 0u;
+}
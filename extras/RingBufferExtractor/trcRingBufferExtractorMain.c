@@ -0,0 +1,178 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Command line tool for the RingBuffer stream port. Finds the recorder in a
+ * RAM dump or core file and writes its trace to a file that Tracealyzer can
+ * open.
+ *
+ *	trcRingBufferExtract [-o file] [-a address] [-i index] [-l] dump
+ */
+
+#include <trcRingBufferExtractor.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define RB_EXTRACT_OUTPUT_BUFFER_SIZE (1024u * 1024u)
+
+static int32_t prvWrite(void* pvUser, const void* pvData, uint32_t uiSize)
+{
+	return (fwrite(pvData, 1, uiSize, (FILE*)pvUser) == uiSize) ? 0 : -1;
+}
+
+static void prvPrintRecorder(uint32_t uiIndex, const TraceRingBufferDumpRecorder_t* pxRecorder)
+{
+	const TraceRingBufferDumpCore_t* pxCore;
+	uint32_t i;
+
+	fprintf(stderr, "%u: recorder at 0x%llx, %s endian, %u-bit, PSF version %u, %u cores, %u entry slots, %u bytes of event buffer\n",
+		(unsigned int)uiIndex,
+		(unsigned long long)pxRecorder->ulAddress,
+		(pxRecorder->uiBigEndian != 0u) ? "big" : "little",
+		(unsigned int)(pxRecorder->uiBaseSize * 8u),
+		(unsigned int)pxRecorder->uiVersion,
+		(unsigned int)pxRecorder->uiCoreCount,
+		(unsigned int)pxRecorder->uiEntrySlots,
+		(unsigned int)pxRecorder->uiEventBufferSize);
+
+	for (i = 0u; i < pxRecorder->uiCoreCount; i++)
+	{
+		pxCore = &pxRecorder->xCores[i];
+
+		fprintf(stderr, "   core %u: %s, head %u, tail %u, slack %u, size %u\n",
+			(unsigned int)i,
+			(pxCore->uiOptions != 0u) ? "overwrite when full" : "stop when full",
+			(unsigned int)pxCore->uiHead,
+			(unsigned int)pxCore->uiTail,
+			(unsigned int)pxCore->uiSlack,
+			(unsigned int)pxCore->uiSize);
+	}
+}
+
+static void prvUsage(void)
+{
+	fprintf(stderr,
+		"trcRingBufferExtract [-o file] [-a address] [-i index] [-l] dump\n"
+		"\n"
+		"dump  Raw RAM dump, or ELF core file\n"
+		"-o    Output file, default trace.psf\n"
+		"-a    Target address of the first byte of a raw dump, default 0\n"
+		"-i    Extract the recorder with this index, if the dump holds more than one, default 0\n"
+		"-l    List the recorders found, don't extract\n");
+	exit(1);
+}
+
+int main(int argc, char** argv)
+{
+	TraceRingBufferDumpStatistics_t xStatistics;
+	TraceRingBufferDumpRecorder_t xRecorder;
+	TraceRingBufferDump_t xDump;
+	const char* szOutput = "trace.psf";
+	uint64_t ulRawAddress = 0u;
+	uint64_t ulFrom = 0u;
+	uint32_t uiIndex = 0u;
+	uint32_t uiList = 0u;
+	uint32_t uiFound = 0u;
+	uint32_t uiEvents = 0u;
+	FILE* pxFile;
+	int32_t iResult;
+	int iOption;
+	uint32_t i;
+
+	while ((iOption = getopt(argc, argv, "o:a:i:lh")) != -1)
+	{
+		switch (iOption)
+		{
+		case 'o': szOutput = optarg; break;
+		case 'a': ulRawAddress = (uint64_t)strtoull(optarg, (char**)0, 0); break;
+		case 'i': uiIndex = (uint32_t)strtoul(optarg, (char**)0, 0); break;
+		case 'l': uiList = 1u; break;
+		default: prvUsage(); break;
+		}
+	}
+
+	if (optind != (argc - 1))
+	{
+		prvUsage();
+	}
+
+	if (xTraceRingBufferDumpOpen(&xDump, argv[optind], ulRawAddress) != 0)
+	{
+		fprintf(stderr, "Could not open %s, or it is an ELF file that isn't a core file.\n", argv[optind]);
+		return 1;
+	}
+
+	/* Recorders are numbered in address order */
+	while (xTraceRingBufferDumpFind(&xDump, ulFrom, &xRecorder) == 0)
+	{
+		if ((uiList != 0u) || (uiFound == uiIndex))
+		{
+			prvPrintRecorder(uiFound, &xRecorder);
+		}
+
+		if ((uiList == 0u) && (uiFound == uiIndex))
+		{
+			break;
+		}
+
+		uiFound++;
+		ulFrom = xRecorder.ulAddress + 1u;
+	}
+
+	if (uiList != 0u)
+	{
+		fprintf(stderr, "%u recorders found.\n", (unsigned int)uiFound);
+		vTraceRingBufferDumpClose(&xDump);
+		return (uiFound != 0u) ? 0 : 1;
+	}
+
+	if (uiFound != uiIndex)
+	{
+		fprintf(stderr, "No %s recorder found in %s.\n", (uiIndex == 0u) ? "valid" : "such", argv[optind]);
+		vTraceRingBufferDumpClose(&xDump);
+		return 1;
+	}
+
+	pxFile = fopen(szOutput, "wb");
+	if (pxFile == (FILE*)0)
+	{
+		fprintf(stderr, "Could not open %s.\n", szOutput);
+		vTraceRingBufferDumpClose(&xDump);
+		return 1;
+	}
+
+	(void)setvbuf(pxFile, (char*)0, _IOFBF, RB_EXTRACT_OUTPUT_BUFFER_SIZE);
+
+	iResult = xTraceRingBufferDumpExtract(&xDump, &xRecorder, prvWrite, pxFile, &xStatistics);
+
+	if ((fclose(pxFile) != 0) || (iResult != 0))
+	{
+		fprintf(stderr, "Extraction failed, %s is incomplete.\n", szOutput);
+		vTraceRingBufferDumpClose(&xDump);
+		return 1;
+	}
+
+	for (i = 0u; i < xRecorder.uiCoreCount; i++)
+	{
+		uiEvents += xStatistics.uiEvents[i];
+
+		if (xStatistics.uiCorruptBytes[i] != 0u)
+		{
+			fprintf(stderr, "   core %u: %u bytes skipped, not valid events\n", (unsigned int)i, (unsigned int)xStatistics.uiCorruptBytes[i]);
+		}
+	}
+
+	fprintf(stderr, "%u events and %u entries, %llu bytes, written to %s\n",
+		(unsigned int)uiEvents,
+		(unsigned int)xStatistics.uiEntries,
+		(unsigned long long)xStatistics.ulBytes,
+		szOutput);
+
+	vTraceRingBufferDumpClose(&xDump);
+
+	return 0;
+}
@@ -0,0 +1,123 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Reader for the SharedMemory stream port (streamports/SharedMemory), for use
+ * in a capture process next to the traced process. Follows head and tail of
+ * each core's event buffer in the shared memory segment and hands the trace
+ * data to a callback, straight from the segment. Blocks on a futex while
+ * there is little data, the recorder wakes it at the watermark.
+ */
+
+#ifndef TRC_SHM_READER_H
+#define TRC_SHM_READER_H
+
+#include <stdint.h>
+#include <trcStreamPortShmLayout.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Called with trace data. The data of each session is a complete PSF
+ * stream, starting with the header written when the session began.
+ */
+typedef void (*TraceShmReaderWrite_t)(void* pvUser, const void* pvData, uint32_t uiSize);
+
+/**
+ * @brief Called when a session begins (uiBegin 1), before its data, and when
+ * all of its data has been written (uiBegin 0).
+ */
+typedef void (*TraceShmReaderSession_t)(void* pvUser, uint32_t uiSession, uint32_t uiBegin);
+
+typedef struct TraceShmReaderStatistics
+{
+	uint64_t ulBytes;				/* Trace data written */
+	uint32_t uiWakeups;				/* Woken by the recorder */
+	uint32_t uiTimeouts;			/* Waits that timed out */
+	uint32_t uiSessions;			/* Sessions begun */
+	uint32_t uiDroppedEvents;		/* Events the recorder dropped, all sessions */
+} TraceShmReaderStatistics_t;
+
+typedef struct TraceShmReader
+{
+	uint8_t* puiSegment;
+	TraceStreamPortShmDescriptor_t* pxDescriptor;
+	uint32_t uiSegmentSize;
+	int32_t iWriterPid;
+	uint32_t uiSession;				/* Session being read */
+	uint32_t uiInSession;			/* uiSession has begun and not ended */
+	TraceShmReaderWrite_t xWrite;
+	TraceShmReaderSession_t xSession;
+	void* pvUser;
+	TraceShmReaderStatistics_t xStatistics;
+} TraceShmReader_t;
+
+/**
+ * @brief Maps the segment, checks the layout descriptor and attaches as its
+ * reader.
+ *
+ * @param[out] pxReader Reader
+ * @param[in] szName Segment name, as TRC_CFG_STREAM_PORT_SHM_NAME
+ * @param[in] xWrite Trace data callback
+ * @param[in] xSession Session callback, can be null
+ * @param[in] pvUser Passed to the callbacks
+ *
+ * @retval -1 The segment doesn't exist (yet) or isn't valid
+ * @retval 0 Success
+ */
+int32_t xTraceShmReaderOpen(TraceShmReader_t* pxReader, const char* szName, TraceShmReaderWrite_t xWrite, TraceShmReaderSession_t xSession, void* pvUser);
+
+/**
+ * @brief Writes the data committed in all cores' buffers. If there was none,
+ * waits for the recorder to reach the watermark, or for the timeout, and
+ * writes what is there then.
+ *
+ * @param[in] pxReader Reader
+ * @param[in] uiTimeoutMs Longest time to wait
+ *
+ * @retval -1 The recorder has created the segment again (restarted), close
+ * and open again
+ * @retval >=0 Bytes written
+ */
+int32_t xTraceShmReaderPoll(TraceShmReader_t* pxReader, uint32_t uiTimeoutMs);
+
+/**
+ * @brief Starts or stops the recording, like Tracealyzer does. The recorder
+ * reads the command in xTraceTzCtrl(), or in xTraceEnable(TRC_START_AWAIT_HOST).
+ *
+ * @param[in] pxReader Reader
+ * @param[in] uiEnable 1 to start, 0 to stop
+ *
+ * @retval -1 The previous command hasn't been read yet
+ * @retval 0 Success
+ */
+int32_t xTraceShmReaderSetRecording(TraceShmReader_t* pxReader, uint32_t uiEnable);
+
+/**
+ * @brief Checks if the traced process is running.
+ *
+ * @param[in] pxReader Reader
+ *
+ * @retval 1 Running
+ * @retval 0 Exited
+ */
+uint32_t xTraceShmReaderIsWriterAlive(const TraceShmReader_t* pxReader);
+
+/**
+ * @brief Detaches and unmaps the segment. A session that hasn't ended is
+ * ended, without the data that hasn't been read.
+ *
+ * @param[in] pxReader Reader
+ */
+void vTraceShmReaderClose(TraceShmReader_t* pxReader);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRC_SHM_READER_H */
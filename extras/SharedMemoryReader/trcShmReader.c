@@ -0,0 +1,387 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Reader for the SharedMemory stream port, see trcShmReader.h.
+ */
+
+#include <trcShmReader.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+static uint32_t* prvField(const TraceShmReader_t* pxReader, uint32_t uiCore, uint32_t uiOffset)
+{
+	return (uint32_t*)&pxReader->puiSegment[pxReader->pxDescriptor->xCores[uiCore].uiBufferOffset + uiOffset];
+}
+
+/* Bytes from uiFrom to uiTo in the ring, the recorder skipped uiSlack bytes at the end if it has wrapped */
+static uint32_t prvDistance(uint32_t uiFrom, uint32_t uiTo, uint32_t uiSize, uint32_t uiSlack)
+{
+	return (uiTo >= uiFrom) ? (uiTo - uiFrom) : (uiSize - uiSlack - uiFrom + uiTo);
+}
+
+/* Writes the data from the tail up to uiTo and frees it */
+static uint32_t prvDrain(TraceShmReader_t* pxReader, uint32_t uiCore, uint32_t uiTo)
+{
+	const TraceStreamPortShmCore_t* pxCore = &pxReader->pxDescriptor->xCores[uiCore];
+	const uint8_t* puiData = &pxReader->puiSegment[pxCore->uiDataOffset];
+	uint32_t* puiTail = prvField(pxReader, uiCore, pxReader->pxDescriptor->uiTailOffset);
+	uint32_t uiTail = __atomic_load_n(puiTail, __ATOMIC_RELAXED);
+	uint32_t uiSlack;
+	uint32_t uiEnd;
+	uint32_t uiBytes = 0u;
+
+	if (uiTo == uiTail)
+	{
+		return 0u;
+	}
+
+	if (uiTo > uiTail)
+	{
+		pxReader->xWrite(pxReader->pvUser, &puiData[uiTail], uiTo - uiTail);
+		uiBytes = uiTo - uiTail;
+	}
+	else
+	{
+		/* The recorder has wrapped, uiSlack was stored before the head that we have read */
+		uiSlack = __atomic_load_n(prvField(pxReader, uiCore, pxReader->pxDescriptor->uiSlackOffset), __ATOMIC_RELAXED);
+		uiEnd = pxCore->uiDataSize - uiSlack;
+
+		if (uiEnd > uiTail)
+		{
+			pxReader->xWrite(pxReader->pvUser, &puiData[uiTail], uiEnd - uiTail);
+			uiBytes = uiEnd - uiTail;
+		}
+
+		if (uiTo > 0u)
+		{
+			pxReader->xWrite(pxReader->pvUser, puiData, uiTo);
+			uiBytes += uiTo;
+		}
+	}
+
+	/* The data has been written before the recorder can reuse the space */
+	__atomic_store_n(puiTail, uiTo, __ATOMIC_RELEASE);
+
+	pxReader->xStatistics.ulBytes += uiBytes;
+
+	return uiBytes;
+}
+
+/* Ends the session being read with the data before the new one, and begins the new one */
+static uint32_t prvChangeSession(TraceShmReader_t* pxReader, uint32_t uiSession)
+{
+	TraceStreamPortShmDescriptor_t* pxDescriptor = pxReader->pxDescriptor;
+	uint32_t uiSessionHead, uiHead, uiTail, uiSlack;
+	uint32_t uiBytes = 0u;
+	uint32_t i;
+
+	for (i = 0u; i < pxDescriptor->uiCoreCount; i++)
+	{
+		uiSessionHead = pxDescriptor->xCores[i].uiSessionHead;
+
+		if (pxReader->uiInSession != 0u)
+		{
+			uiBytes += prvDrain(pxReader, i, uiSessionHead);
+		}
+		else
+		{
+			/* Just attached, skip anything left of earlier sessions */
+			uiHead = __atomic_load_n(prvField(pxReader, i, pxDescriptor->uiHeadOffset), __ATOMIC_ACQUIRE);
+			uiTail = __atomic_load_n(prvField(pxReader, i, pxDescriptor->uiTailOffset), __ATOMIC_RELAXED);
+			uiSlack = __atomic_load_n(prvField(pxReader, i, pxDescriptor->uiSlackOffset), __ATOMIC_RELAXED);
+
+			if (prvDistance(uiTail, uiHead, pxDescriptor->xCores[i].uiDataSize, uiSlack) > prvDistance(uiSessionHead, uiHead, pxDescriptor->xCores[i].uiDataSize, uiSlack))
+			{
+				__atomic_store_n(prvField(pxReader, i, pxDescriptor->uiTailOffset), uiSessionHead, __ATOMIC_RELEASE);
+			}
+		}
+	}
+
+	if ((pxReader->uiInSession != 0u) && (pxReader->xSession != 0))
+	{
+		pxReader->xSession(pxReader->pvUser, pxReader->uiSession, 0u);
+	}
+
+	pxReader->uiSession = uiSession;
+	pxReader->uiInSession = 1u;
+	pxReader->xStatistics.uiSessions++;
+
+	if (pxReader->xSession != 0)
+	{
+		pxReader->xSession(pxReader->pvUser, uiSession, 1u);
+	}
+
+	return uiBytes;
+}
+
+static void prvWait(TraceShmReader_t* pxReader, uint32_t uiTimeoutMs)
+{
+	TraceStreamPortShmDescriptor_t* pxDescriptor = pxReader->pxDescriptor;
+	struct timespec xTimeout;
+	uint32_t uiWakeCounter;
+	uint32_t uiHead, uiTail, uiSlack;
+	uint32_t i;
+
+	xTimeout.tv_sec = (time_t)(uiTimeoutMs / 1000u);
+	xTimeout.tv_nsec = (long)(uiTimeoutMs % 1000u) * 1000000L;
+
+	uiWakeCounter = __atomic_load_n(&pxDescriptor->uiWakeCounter, __ATOMIC_ACQUIRE);
+	__atomic_store_n(&pxDescriptor->uiReaderWaiting, 1u, __ATOMIC_SEQ_CST);
+
+	/* Don't wait if the watermark was reached before the recorder could see uiReaderWaiting */
+	for (i = 0u; i < pxDescriptor->uiCoreCount; i++)
+	{
+		uiHead = __atomic_load_n(prvField(pxReader, i, pxDescriptor->uiHeadOffset), __ATOMIC_ACQUIRE);
+		uiTail = __atomic_load_n(prvField(pxReader, i, pxDescriptor->uiTailOffset), __ATOMIC_RELAXED);
+		uiSlack = __atomic_load_n(prvField(pxReader, i, pxDescriptor->uiSlackOffset), __ATOMIC_RELAXED);
+
+		if (prvDistance(uiTail, uiHead, pxDescriptor->xCores[i].uiDataSize, uiSlack) >= pxDescriptor->uiWatermark)
+		{
+			__atomic_store_n(&pxDescriptor->uiReaderWaiting, 0u, __ATOMIC_RELAXED);
+
+			return;
+		}
+	}
+
+	if ((__atomic_load_n(&pxDescriptor->uiSession, __ATOMIC_ACQUIRE) == pxReader->uiSession) &&
+		(__atomic_load_n(&pxDescriptor->uiEnabled, __ATOMIC_ACQUIRE) == pxReader->uiInSession))
+	{
+#if defined(__linux__)
+		/* Returns at once if the counter has changed since it was read */
+		(void)syscall(SYS_futex, &pxDescriptor->uiWakeCounter, FUTEX_WAIT, uiWakeCounter, &xTimeout, (void*)0, 0);
+#else
+		(void)nanosleep(&xTimeout, (struct timespec*)0);
+#endif
+	}
+
+	if (__atomic_exchange_n(&pxDescriptor->uiReaderWaiting, 0u, __ATOMIC_ACQ_REL) == 0u)
+	{
+		pxReader->xStatistics.uiWakeups++;
+	}
+	else
+	{
+		pxReader->xStatistics.uiTimeouts++;
+	}
+}
+
+int32_t xTraceShmReaderOpen(TraceShmReader_t* pxReader, const char* szName, TraceShmReaderWrite_t xWrite, TraceShmReaderSession_t xSession, void* pvUser)
+{
+	TraceStreamPortShmDescriptor_t* pxDescriptor;
+	struct stat xStat;
+	void* pvMapping;
+	uint32_t uiSession;
+	uint32_t i;
+	int iFile;
+
+	(void)memset(pxReader, 0, sizeof(TraceShmReader_t));
+
+	iFile = shm_open(szName, O_RDWR, 0);
+	if (iFile < 0)
+	{
+		return -1;
+	}
+
+	if ((fstat(iFile, &xStat) != 0) || (xStat.st_size < (off_t)(TRC_STREAM_PORT_SHM_DESCRIPTOR_SIZE)) || (xStat.st_size > (off_t)UINT32_MAX))
+	{
+		(void)close(iFile);
+
+		return -1;
+	}
+
+	pvMapping = mmap((void*)0, (size_t)xStat.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, iFile, 0);
+	(void)close(iFile);
+
+	if (pvMapping == MAP_FAILED)
+	{
+		return -1;
+	}
+
+	pxDescriptor = (TraceStreamPortShmDescriptor_t*)pvMapping;
+	pxReader->puiSegment = (uint8_t*)pvMapping;
+	pxReader->pxDescriptor = pxDescriptor;
+	pxReader->uiSegmentSize = (uint32_t)xStat.st_size;
+
+	/* The recorder writes the magic last */
+	if ((memcmp(pxDescriptor->cMagic, TRC_STREAM_PORT_SHM_MAGIC, sizeof(TRC_STREAM_PORT_SHM_MAGIC)) != 0) ||
+		(pxDescriptor->uiVersion != TRC_STREAM_PORT_SHM_VERSION) ||
+		(pxDescriptor->uiSegmentSize != pxReader->uiSegmentSize) ||
+		(pxDescriptor->uiCoreCount == 0u) || (pxDescriptor->uiCoreCount > TRC_STREAM_PORT_SHM_MAX_CORES))
+	{
+		vTraceShmReaderClose(pxReader);
+
+		return -1;
+	}
+
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+	for (i = 0u; i < pxDescriptor->uiCoreCount; i++)
+	{
+		const TraceStreamPortShmCore_t* pxCore = &pxDescriptor->xCores[i];
+
+		if (((uint64_t)pxCore->uiDataOffset + pxCore->uiDataSize > pxReader->uiSegmentSize) ||
+			((uint64_t)pxCore->uiBufferOffset + pxDescriptor->uiSlackOffset + sizeof(uint32_t) > pxReader->uiSegmentSize))
+		{
+			vTraceShmReaderClose(pxReader);
+
+			return -1;
+		}
+	}
+
+	pxReader->iWriterPid = pxDescriptor->iWriterPid;
+
+	/* A session that has already ended isn't read, one that is running is read from where the tail is */
+	uiSession = __atomic_load_n(&pxDescriptor->uiSession, __ATOMIC_ACQUIRE);
+	if (__atomic_load_n(&pxDescriptor->uiEnabled, __ATOMIC_ACQUIRE) == 0u)
+	{
+		pxReader->uiSession = uiSession;
+	}
+	pxReader->xWrite = xWrite;
+	pxReader->xSession = xSession;
+	pxReader->pvUser = pvUser;
+
+	__atomic_store_n(&pxDescriptor->iReaderPid, (int32_t)getpid(), __ATOMIC_RELEASE);
+
+	return 0;
+}
+
+int32_t xTraceShmReaderPoll(TraceShmReader_t* pxReader, uint32_t uiTimeoutMs)
+{
+	TraceStreamPortShmDescriptor_t* pxDescriptor = pxReader->pxDescriptor;
+	uint32_t uiHeads[TRC_STREAM_PORT_SHM_MAX_CORES];
+	uint32_t uiEnabled;
+	uint32_t uiSession;
+	uint32_t uiBytes = 0u;
+	uint32_t uiWaited = 0u;
+	uint32_t i;
+
+	while (1)
+	{
+		if ((pxDescriptor->iWriterPid != pxReader->iWriterPid) || (memcmp(pxDescriptor->cMagic, TRC_STREAM_PORT_SHM_MAGIC, sizeof(TRC_STREAM_PORT_SHM_MAGIC)) != 0))
+		{
+			return -1;
+		}
+
+		/* The order matters: a session that ended before uiEnabled was read has
+		 * all of its data before the heads, and a session that began after the
+		 * heads were read is seen in uiSession. */
+		uiEnabled = __atomic_load_n(&pxDescriptor->uiEnabled, __ATOMIC_ACQUIRE);
+
+		for (i = 0u; i < pxDescriptor->uiCoreCount; i++)
+		{
+			uiHeads[i] = __atomic_load_n(prvField(pxReader, i, pxDescriptor->uiHeadOffset), __ATOMIC_ACQUIRE);
+		}
+
+		uiSession = __atomic_load_n(&pxDescriptor->uiSession, __ATOMIC_ACQUIRE);
+
+		if (uiSession != pxReader->uiSession)
+		{
+			uiBytes += prvChangeSession(pxReader, uiSession);
+
+			/* The heads may be from before the session began */
+			continue;
+		}
+
+		for (i = 0u; i < pxDescriptor->uiCoreCount; i++)
+		{
+			uiBytes += prvDrain(pxReader, i, uiHeads[i]);
+		}
+
+		if ((uiEnabled == 0u) && (pxReader->uiInSession != 0u))
+		{
+			pxReader->uiInSession = 0u;
+
+			if (pxReader->xSession != 0)
+			{
+				pxReader->xSession(pxReader->pvUser, pxReader->uiSession, 0u);
+			}
+		}
+
+		if ((uiBytes > 0u) || (uiWaited != 0u) || (uiTimeoutMs == 0u))
+		{
+			break;
+		}
+
+		prvWait(pxReader, uiTimeoutMs);
+		uiWaited = 1u;
+	}
+
+	pxReader->xStatistics.uiDroppedEvents = __atomic_load_n(&pxDescriptor->uiDroppedEvents, __ATOMIC_RELAXED);
+
+	return (int32_t)uiBytes;
+}
+
+int32_t xTraceShmReaderSetRecording(TraceShmReader_t* pxReader, uint32_t uiEnable)
+{
+	TraceStreamPortShmDescriptor_t* pxDescriptor = pxReader->pxDescriptor;
+	uint32_t uiCommandWrite = pxDescriptor->uiCommandWrite;
+	uint32_t uiChecksum;
+
+	if (__atomic_load_n(&pxDescriptor->uiCommandRead, __ATOMIC_ACQUIRE) != uiCommandWrite)
+	{
+		return -1;
+	}
+
+	/* CMD_SET_ACTIVE, the checksum is 0xFFFF minus the sum of the other bytes */
+	uiChecksum = 0xFFFFu - (1u + (uiEnable != 0u ? 1u : 0u));
+
+	pxDescriptor->uiCommand[0] = 1u;
+	pxDescriptor->uiCommand[1] = (uiEnable != 0u) ? 1u : 0u;
+	pxDescriptor->uiCommand[2] = 0u;
+	pxDescriptor->uiCommand[3] = 0u;
+	pxDescriptor->uiCommand[4] = 0u;
+	pxDescriptor->uiCommand[5] = 0u;
+	pxDescriptor->uiCommand[6] = (uint8_t)(uiChecksum & 0xFFu);
+	pxDescriptor->uiCommand[7] = (uint8_t)(uiChecksum >> 8);
+
+	__atomic_store_n(&pxDescriptor->uiCommandWrite, uiCommandWrite + 1u, __ATOMIC_RELEASE);
+
+	return 0;
+}
+
+uint32_t xTraceShmReaderIsWriterAlive(const TraceShmReader_t* pxReader)
+{
+	if ((kill((pid_t)pxReader->iWriterPid, 0) != 0) && (errno == ESRCH))
+	{
+		return 0u;
+	}
+
+	return 1u;
+}
+
+void vTraceShmReaderClose(TraceShmReader_t* pxReader)
+{
+	int32_t iReaderPid = (int32_t)getpid();
+
+	if (pxReader->puiSegment == 0)
+	{
+		return;
+	}
+
+	if ((pxReader->uiInSession != 0u) && (pxReader->xSession != 0))
+	{
+		pxReader->xSession(pxReader->pvUser, pxReader->uiSession, 0u);
+	}
+
+	pxReader->uiInSession = 0u;
+
+	/* Only if this process is still the attached reader */
+	(void)__atomic_compare_exchange_n(&pxReader->pxDescriptor->iReaderPid, &iReaderPid, 0, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+
+	(void)munmap((void*)pxReader->puiSegment, pxReader->uiSegmentSize);
+	pxReader->puiSegment = 0;
+	pxReader->pxDescriptor = 0;
+}
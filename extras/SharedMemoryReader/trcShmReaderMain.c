@@ -0,0 +1,200 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Command line capture process for the SharedMemory stream port. Attaches to
+ * the segment, optionally starts the recording, and writes each session to a
+ * file that Tracealyzer can open.
+ *
+ *	trcShmReader [-n name] [-o file] [-s] [-c sessions] [-t timeout in ms]
+ */
+
+#include <trcShmReader.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define SHM_READER_MAX_PATH 4096u
+
+typedef struct ShmReaderOutput
+{
+	const char* szPattern;
+	FILE* pxFile;
+	uint32_t uiSessionsEnded;
+} ShmReaderOutput_t;
+
+static volatile sig_atomic_t iStop = 0;
+
+static void prvOnSignal(int iSignal)
+{
+	(void)iSignal;
+
+	iStop = 1;
+}
+
+static void prvWrite(void* pvUser, const void* pvData, uint32_t uiSize)
+{
+	ShmReaderOutput_t* pxOutput = (ShmReaderOutput_t*)pvUser;
+
+	if ((pxOutput->pxFile != (void*)0) && (fwrite(pvData, 1, uiSize, pxOutput->pxFile) != uiSize))
+	{
+		fprintf(stderr, "Write failed.\n");
+		exit(1);
+	}
+}
+
+static void prvSession(void* pvUser, uint32_t uiSession, uint32_t uiBegin)
+{
+	ShmReaderOutput_t* pxOutput = (ShmReaderOutput_t*)pvUser;
+	char cPath[SHM_READER_MAX_PATH];
+
+	if (uiBegin == 0u)
+	{
+		if (pxOutput->pxFile != (void*)0)
+		{
+			(void)fclose(pxOutput->pxFile);
+			pxOutput->pxFile = (void*)0;
+		}
+
+		pxOutput->uiSessionsEnded++;
+		fprintf(stderr, "session %u ended\n", (unsigned int)uiSession);
+
+		return;
+	}
+
+	/* The pattern has been checked to hold at most one %u */
+	(void)snprintf(cPath, sizeof(cPath), pxOutput->szPattern, (unsigned int)uiSession);
+
+	pxOutput->pxFile = fopen(cPath, "wb");
+	if (pxOutput->pxFile == (void*)0)
+	{
+		fprintf(stderr, "Could not open %s.\n", cPath);
+		exit(1);
+	}
+
+	fprintf(stderr, "session %u begins, writing %s\n", (unsigned int)uiSession, cPath);
+}
+
+static uint32_t prvIsValidPattern(const char* szPattern)
+{
+	const char* pcPercent = strchr(szPattern, '%');
+
+	if (pcPercent == (void*)0)
+	{
+		return 1u;
+	}
+
+	return (pcPercent[1] == 'u') && (strchr(&pcPercent[2], '%') == (void*)0);
+}
+
+static void prvUsage(void)
+{
+	fprintf(stderr,
+		"trcShmReader [-n name] [-o file] [-s] [-c sessions] [-t timeout in ms]\n"
+		"\n"
+		"-n  Segment name, default /trc-trace (TRC_CFG_STREAM_PORT_SHM_NAME)\n"
+		"-o  Output file, %%u is replaced by the session number, default trace.psf\n"
+		"-s  Start the recording, for xTraceEnable(TRC_START_AWAIT_HOST), and stop it when interrupted\n"
+		"-c  Exit after this many sessions, 0 to run until interrupted, default 1\n"
+		"-t  Longest wait for the watermark, default 100\n");
+	exit(1);
+}
+
+int main(int argc, char** argv)
+{
+	struct sigaction xAction = { 0 };
+	ShmReaderOutput_t xOutput = { "trace.psf", (void*)0, 0u };
+	TraceShmReader_t xReader;
+	const char* szName = "/trc-trace";
+	uint32_t uiStart = 0u;
+	uint32_t uiSessions = 1u;
+	uint32_t uiTimeout = 100u;
+	uint32_t uiAttached = 0u;
+	int32_t iBytes;
+	int iOption;
+
+	while ((iOption = getopt(argc, argv, "n:o:sc:t:h")) != -1)
+	{
+		switch (iOption)
+		{
+		case 'n': szName = optarg; break;
+		case 'o': xOutput.szPattern = optarg; break;
+		case 's': uiStart = 1u; break;
+		case 'c': uiSessions = (uint32_t)strtoul(optarg, (char**)0, 0); break;
+		case 't': uiTimeout = (uint32_t)strtoul(optarg, (char**)0, 0); break;
+		default: prvUsage(); break;
+		}
+	}
+
+	if (prvIsValidPattern(xOutput.szPattern) == 0u)
+	{
+		prvUsage();
+	}
+
+	xAction.sa_handler = prvOnSignal;
+	(void)sigaction(SIGINT, &xAction, (struct sigaction*)0);
+	(void)sigaction(SIGTERM, &xAction, (struct sigaction*)0);
+
+	while ((iStop == 0) && ((uiSessions == 0u) || (xOutput.uiSessionsEnded < uiSessions)))
+	{
+		if (uiAttached == 0u)
+		{
+			if (xTraceShmReaderOpen(&xReader, szName, prvWrite, prvSession, &xOutput) != 0)
+			{
+				/* The traced process hasn't created the segment yet */
+				(void)usleep(100000);
+				continue;
+			}
+
+			if (xTraceShmReaderIsWriterAlive(&xReader) == 0u)
+			{
+				/* Left by a process that has exited, wait for the next one to create it again */
+				vTraceShmReaderClose(&xReader);
+				(void)usleep(100000);
+				continue;
+			}
+
+			uiAttached = 1u;
+			fprintf(stderr, "attached to %s, writer pid %d\n", szName, (int)xReader.iWriterPid);
+
+			if (uiStart != 0u)
+			{
+				(void)xTraceShmReaderSetRecording(&xReader, 1u);
+			}
+		}
+
+		iBytes = xTraceShmReaderPoll(&xReader, uiTimeout);
+
+		if ((iBytes < 0) || ((iBytes == 0) && (xTraceShmReaderIsWriterAlive(&xReader) == 0u)))
+		{
+			/* Restarted or exited, the data that was committed has been written */
+			fprintf(stderr, "the traced process %s\n", (iBytes < 0) ? "restarted" : "exited");
+			vTraceShmReaderClose(&xReader);
+			uiAttached = 0u;
+		}
+	}
+
+	if (uiAttached != 0u)
+	{
+		if ((iStop != 0) && (uiStart != 0u))
+		{
+			(void)xTraceShmReaderSetRecording(&xReader, 0u);
+		}
+
+		fprintf(stderr, "%llu bytes of trace data in %u sessions, %u wakeups, %u timeouts, %u events dropped by the recorder\n",
+			(unsigned long long)xReader.xStatistics.ulBytes,
+			(unsigned int)xReader.xStatistics.uiSessions,
+			(unsigned int)xReader.xStatistics.uiWakeups,
+			(unsigned int)xReader.xStatistics.uiTimeouts,
+			(unsigned int)xReader.xStatistics.uiDroppedEvents);
+
+		vTraceShmReaderClose(&xReader);
+	}
+
+	return 0;
+}
@@ -0,0 +1,122 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * A traced program using the SharedMemory stream port on the host, to test
+ * trcShmReader. It waits for the start command from the reader, generates
+ * user events from a number of threads and stops, which ends the session.
+ * Only the TzCtrl thread reads commands, the event path doesn't make syscalls.
+ *
+ *	trcShmTarget [threads] [events per thread] [sessions]
+ */
+
+#include <trcRecorder.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define SHM_TARGET_MAX_THREADS 64u
+
+static volatile uint32_t uiStopTzCtrl = 0u;
+static uint32_t uiEventsPerThread = 100000u;
+static uint32_t uiFailed = 0u;
+
+static void* prvTzCtrl(void* pvArg)
+{
+	while (uiStopTzCtrl == 0u)
+	{
+		(void)xTraceTzCtrl();
+		(void)usleep(10000);
+	}
+
+	return pvArg;
+}
+
+static void* prvWorker(void* pvArg)
+{
+	TraceStringHandle_t xChannel;
+	uint32_t uiWorkerFailed = 0u;
+	uint32_t i;
+
+	(void)xTraceStringRegister("shm", &xChannel);
+
+	for (i = 0u; i < uiEventsPerThread; i++)
+	{
+		if (xTracePrintF(xChannel, "%d %d", (int)i, (int)(i >> 8)) == TRC_FAIL)
+		{
+			/* The reader hasn't kept up */
+			uiWorkerFailed++;
+		}
+	}
+
+	(void)__atomic_fetch_add(&uiFailed, uiWorkerFailed, __ATOMIC_RELAXED);
+
+	return pvArg;
+}
+
+int main(int argc, char** argv)
+{
+	pthread_t xTzCtrl, xWorkers[SHM_TARGET_MAX_THREADS];
+	uint32_t uiThreads = 2u;
+	uint32_t uiSessions = 1u;
+	uint32_t i, j;
+
+	if (argc > 1)
+	{
+		uiThreads = (uint32_t)strtoul(argv[1], (char**)0, 0);
+	}
+	if (argc > 2)
+	{
+		uiEventsPerThread = (uint32_t)strtoul(argv[2], (char**)0, 0);
+	}
+	if (argc > 3)
+	{
+		uiSessions = (uint32_t)strtoul(argv[3], (char**)0, 0);
+	}
+	if ((uiThreads == 0u) || (uiThreads > SHM_TARGET_MAX_THREADS))
+	{
+		uiThreads = 2u;
+	}
+
+	if (xTraceInitialize() == TRC_FAIL)
+	{
+		return 1;
+	}
+
+	printf("Waiting for trcShmReader -s on %s.\n", TRC_CFG_STREAM_PORT_SHM_NAME);
+	(void)xTraceEnable(TRC_START_AWAIT_HOST);
+
+	(void)pthread_create(&xTzCtrl, (const pthread_attr_t*)0, prvTzCtrl, (void*)0);
+
+	for (j = 0u; j < uiSessions; j++)
+	{
+		if (j > 0u)
+		{
+			/* The following sessions are started from here */
+			(void)xTraceEnable(TRC_START);
+		}
+
+		for (i = 0u; i < uiThreads; i++)
+		{
+			(void)pthread_create(&xWorkers[i], (const pthread_attr_t*)0, prvWorker, (void*)0);
+		}
+
+		for (i = 0u; i < uiThreads; i++)
+		{
+			(void)pthread_join(xWorkers[i], (void**)0);
+		}
+
+		(void)xTraceDisable();
+	}
+
+	uiStopTzCtrl = 1u;
+	(void)pthread_join(xTzCtrl, (void**)0);
+
+	printf("Done, %u events in %u sessions, %u not stored.\n", (unsigned int)(uiSessions * uiThreads * uiEventsPerThread), (unsigned int)uiSessions, (unsigned int)uiFailed);
+
+	return 0;
+}
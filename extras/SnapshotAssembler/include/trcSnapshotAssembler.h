@@ -0,0 +1,99 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Host side of xTraceSnapshotExport. Applies the exported records to a copy
+ * of the recorder data, which is then a snapshot that can be saved and
+ * opened in Tracealyzer like a RAM dump. Each record is an offset and a
+ * length, with TRC_SNAPSHOT_ASSEMBLER_ZERO_FILL for zero filled bytes, in the
+ * byte order of the target, followed by the data padded to 4 bytes. The
+ * records are fed in pieces of any size.
+ */
+
+#ifndef TRC_SNAPSHOT_ASSEMBLER_H
+#define TRC_SNAPSHOT_ASSEMBLER_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TRC_SNAPSHOT_ASSEMBLER_ZERO_FILL 0x80000000UL
+#define TRC_SNAPSHOT_ASSEMBLER_MAX_SIZE (256UL * 1024UL * 1024UL)
+
+/* Checks made by xTraceSnapshotAssemblerCheck */
+#define TRC_SNAPSHOT_ASSEMBLER_COMPLETE 0
+#define TRC_SNAPSHOT_ASSEMBLER_NO_START_MARKERS 1
+#define TRC_SNAPSHOT_ASSEMBLER_WRONG_SIZE 2
+#define TRC_SNAPSHOT_ASSEMBLER_NO_END_MARKERS 3
+
+typedef struct TraceSnapshotAssembler
+{
+	uint8_t* puiData;				/* The recorder data */
+	uint32_t uiSize;				/* The end of the last byte written by any record */
+	uint32_t uiCapacity;
+	uint32_t uiBigEndian;			/* Byte order of the record headers, from the first record */
+	uint32_t uiRecords;
+	uint64_t ulBytes;				/* All data fed */
+
+	/* Where in the record stream the assembler is, for pieces that end in the
+	 * middle of a record */
+	uint8_t auiHeader[8];
+	uint32_t uiHeaderLength;
+	uint32_t uiOffset;				/* Of the next data byte of the current record */
+	uint32_t uiRemaining;			/* Data bytes left of the current record */
+	uint32_t uiPadding;				/* Padding bytes left of the current record */
+	uint32_t uiFailed;
+} TraceSnapshotAssembler_t;
+
+/**
+ * @brief Initializes an assembler with empty recorder data.
+ *
+ * @param[out] pxAssembler Assembler
+ *
+ * @retval -1 Failure
+ * @retval 0 Success
+ */
+int32_t xTraceSnapshotAssemblerInitialize(TraceSnapshotAssembler_t* pxAssembler);
+
+/**
+ * @brief Applies the next piece of the record stream, e.g., the output of
+ * one or more xTraceSnapshotExport calls. Pieces can be of any size, and can
+ * end in the middle of a record.
+ *
+ * @param[in] pxAssembler Assembler
+ * @param[in] pvData Records
+ * @param[in] uiSize Bytes
+ *
+ * @retval -1 A record is beyond TRC_SNAPSHOT_ASSEMBLER_MAX_SIZE or memory ran
+ * out. Further data is ignored.
+ * @retval 0 Success
+ */
+int32_t xTraceSnapshotAssemblerFeed(TraceSnapshotAssembler_t* pxAssembler, const void* pvData, uint32_t uiSize);
+
+/**
+ * @brief Checks that the recorder data is complete: it begins with the start
+ * markers, its size is the filesize field, and it ends with the end markers.
+ *
+ * @param[in] pxAssembler Assembler
+ *
+ * @returns TRC_SNAPSHOT_ASSEMBLER_COMPLETE, or the first check that failed
+ */
+int32_t xTraceSnapshotAssemblerCheck(const TraceSnapshotAssembler_t* pxAssembler);
+
+/**
+ * @brief Frees the recorder data.
+ *
+ * @param[in] pxAssembler Assembler
+ */
+void vTraceSnapshotAssemblerFree(TraceSnapshotAssembler_t* pxAssembler);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRC_SNAPSHOT_ASSEMBLER_H */
@@ -0,0 +1,207 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Applies the records of xTraceSnapshotExport to a copy of the recorder data.
+ */
+
+#include <trcSnapshotAssembler.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* The first fields of RecorderDataType */
+#define SNAPSHOT_MARKER_SIZE 12u
+#define SNAPSHOT_FILESIZE_OFFSET 16u
+
+static const uint8_t auiStartMarkers[SNAPSHOT_MARKER_SIZE] = { 0x01u, 0x02u, 0x03u, 0x04u, 0x71u, 0x72u, 0x73u, 0x74u, 0xF1u, 0xF2u, 0xF3u, 0xF4u };
+static const uint8_t auiEndMarkers[SNAPSHOT_MARKER_SIZE] = { 0x0Au, 0x0Bu, 0x0Cu, 0x0Du, 0x71u, 0x72u, 0x73u, 0x74u, 0xF1u, 0xF2u, 0xF3u, 0xF4u };
+
+static uint32_t prvRead32(const TraceSnapshotAssembler_t* pxAssembler, const uint8_t* puiData)
+{
+	if (pxAssembler->uiBigEndian != 0u)
+	{
+		return ((uint32_t)puiData[0] << 24) | ((uint32_t)puiData[1] << 16) | ((uint32_t)puiData[2] << 8) | (uint32_t)puiData[3];
+	}
+
+	return ((uint32_t)puiData[3] << 24) | ((uint32_t)puiData[2] << 16) | ((uint32_t)puiData[1] << 8) | (uint32_t)puiData[0];
+}
+
+/* Makes room for the recorder data up to uiEnd, new bytes are zero */
+static int32_t prvReserve(TraceSnapshotAssembler_t* pxAssembler, uint32_t uiEnd)
+{
+	uint32_t uiCapacity;
+	uint8_t* puiData;
+
+	if (uiEnd > TRC_SNAPSHOT_ASSEMBLER_MAX_SIZE)
+	{
+		return -1;
+	}
+
+	if (uiEnd > pxAssembler->uiCapacity)
+	{
+		uiCapacity = (pxAssembler->uiCapacity == 0u) ? 4096u : pxAssembler->uiCapacity;
+		while (uiCapacity < uiEnd)
+		{
+			uiCapacity *= 2u;
+		}
+
+		puiData = (uint8_t*)realloc(pxAssembler->puiData, uiCapacity);
+		if (puiData == (uint8_t*)0)
+		{
+			return -1;
+		}
+
+		memset(&puiData[pxAssembler->uiCapacity], 0, uiCapacity - pxAssembler->uiCapacity);
+		pxAssembler->puiData = puiData;
+		pxAssembler->uiCapacity = uiCapacity;
+	}
+
+	if (uiEnd > pxAssembler->uiSize)
+	{
+		pxAssembler->uiSize = uiEnd;
+	}
+
+	return 0;
+}
+
+/* Starts the record in auiHeader */
+static int32_t prvStartRecord(TraceSnapshotAssembler_t* pxAssembler)
+{
+	uint32_t uiOffset, uiLength;
+
+	if (pxAssembler->uiRecords == 0u)
+	{
+		/* The first record is at offset 0, and its length only makes sense in
+		 * the byte order of the target */
+		pxAssembler->uiBigEndian = 0u;
+		if (prvRead32(pxAssembler, &pxAssembler->auiHeader[4]) > TRC_SNAPSHOT_ASSEMBLER_MAX_SIZE)
+		{
+			pxAssembler->uiBigEndian = 1u;
+		}
+	}
+
+	uiOffset = prvRead32(pxAssembler, &pxAssembler->auiHeader[0]);
+	uiLength = prvRead32(pxAssembler, &pxAssembler->auiHeader[4]);
+	pxAssembler->uiRecords++;
+
+	if ((uiLength & TRC_SNAPSHOT_ASSEMBLER_ZERO_FILL) != 0u)
+	{
+		uiLength &= ~TRC_SNAPSHOT_ASSEMBLER_ZERO_FILL;
+		if ((uiLength > TRC_SNAPSHOT_ASSEMBLER_MAX_SIZE - uiOffset) || (prvReserve(pxAssembler, uiOffset + uiLength) != 0))
+		{
+			return -1;
+		}
+
+		memset(&pxAssembler->puiData[uiOffset], 0, uiLength);
+		return 0;
+	}
+
+	if ((uiOffset > TRC_SNAPSHOT_ASSEMBLER_MAX_SIZE) || (uiLength > TRC_SNAPSHOT_ASSEMBLER_MAX_SIZE - uiOffset) || (prvReserve(pxAssembler, uiOffset + uiLength) != 0))
+	{
+		return -1;
+	}
+
+	pxAssembler->uiOffset = uiOffset;
+	pxAssembler->uiRemaining = uiLength;
+	pxAssembler->uiPadding = ((uiLength + 3u) & ~3u) - uiLength;
+
+	return 0;
+}
+
+int32_t xTraceSnapshotAssemblerInitialize(TraceSnapshotAssembler_t* pxAssembler)
+{
+	if (pxAssembler == (TraceSnapshotAssembler_t*)0)
+	{
+		return -1;
+	}
+
+	memset(pxAssembler, 0, sizeof(TraceSnapshotAssembler_t));
+
+	return 0;
+}
+
+int32_t xTraceSnapshotAssemblerFeed(TraceSnapshotAssembler_t* pxAssembler, const void* pvData, uint32_t uiSize)
+{
+	const uint8_t* puiData = (const uint8_t*)pvData;
+	uint32_t uiChunk;
+
+	if (pxAssembler->uiFailed != 0u)
+	{
+		return -1;
+	}
+
+	pxAssembler->ulBytes += uiSize;
+
+	while (uiSize > 0u)
+	{
+		if (pxAssembler->uiRemaining > 0u)
+		{
+			uiChunk = (uiSize < pxAssembler->uiRemaining) ? uiSize : pxAssembler->uiRemaining;
+			memcpy(&pxAssembler->puiData[pxAssembler->uiOffset], puiData, uiChunk);
+			pxAssembler->uiOffset += uiChunk;
+			pxAssembler->uiRemaining -= uiChunk;
+		}
+		else if (pxAssembler->uiPadding > 0u)
+		{
+			uiChunk = (uiSize < pxAssembler->uiPadding) ? uiSize : pxAssembler->uiPadding;
+			pxAssembler->uiPadding -= uiChunk;
+		}
+		else
+		{
+			uiChunk = sizeof(pxAssembler->auiHeader) - pxAssembler->uiHeaderLength;
+			if (uiChunk > uiSize)
+			{
+				uiChunk = uiSize;
+			}
+
+			memcpy(&pxAssembler->auiHeader[pxAssembler->uiHeaderLength], puiData, uiChunk);
+			pxAssembler->uiHeaderLength += uiChunk;
+
+			if (pxAssembler->uiHeaderLength == sizeof(pxAssembler->auiHeader))
+			{
+				pxAssembler->uiHeaderLength = 0u;
+				if (prvStartRecord(pxAssembler) != 0)
+				{
+					pxAssembler->uiFailed = 1u;
+					return -1;
+				}
+			}
+		}
+
+		puiData += uiChunk;
+		uiSize -= uiChunk;
+	}
+
+	return 0;
+}
+
+int32_t xTraceSnapshotAssemblerCheck(const TraceSnapshotAssembler_t* pxAssembler)
+{
+	if ((pxAssembler->uiSize < SNAPSHOT_FILESIZE_OFFSET + 4u) || (memcmp(pxAssembler->puiData, auiStartMarkers, SNAPSHOT_MARKER_SIZE) != 0))
+	{
+		return TRC_SNAPSHOT_ASSEMBLER_NO_START_MARKERS;
+	}
+
+	if (prvRead32(pxAssembler, &pxAssembler->puiData[SNAPSHOT_FILESIZE_OFFSET]) != pxAssembler->uiSize)
+	{
+		return TRC_SNAPSHOT_ASSEMBLER_WRONG_SIZE;
+	}
+
+	if (memcmp(&pxAssembler->puiData[pxAssembler->uiSize - SNAPSHOT_MARKER_SIZE], auiEndMarkers, SNAPSHOT_MARKER_SIZE) != 0)
+	{
+		return TRC_SNAPSHOT_ASSEMBLER_NO_END_MARKERS;
+	}
+
+	return TRC_SNAPSHOT_ASSEMBLER_COMPLETE;
+}
+
+void vTraceSnapshotAssemblerFree(TraceSnapshotAssembler_t* pxAssembler)
+{
+	free(pxAssembler->puiData);
+	pxAssembler->puiData = (uint8_t*)0;
+	pxAssembler->uiCapacity = 0u;
+	pxAssembler->uiSize = 0u;
+}
@@ -0,0 +1,116 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Command line tool for the snapshot assembler. Applies the records of
+ * xTraceSnapshotExport, as received from the target, and saves the recorder
+ * data as a snapshot that Tracealyzer opens like a RAM dump.
+ *
+ *	trcSnapshotAssemble records snapshot
+ */
+
+#include <trcSnapshotAssembler.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SNAPSHOT_ASSEMBLE_READ_SIZE (64u * 1024u)
+
+static TraceSnapshotAssembler_t xAssembler;
+
+static void prvUsage(void)
+{
+	fprintf(stderr,
+		"trcSnapshotAssemble records snapshot\n"
+		"\n"
+		"records   The output of xTraceSnapshotExport, - for stdin\n"
+		"snapshot  The snapshot to write\n");
+	exit(1);
+}
+
+int main(int argc, char** argv)
+{
+	static uint8_t auiBuffer[SNAPSHOT_ASSEMBLE_READ_SIZE];
+	static const char* const aszChecks[] = { "complete", "no start markers", "size is not the filesize field", "no end markers" };
+	FILE* pxIn;
+	FILE* pxOut;
+	size_t uxRead;
+	int32_t iResult = 0;
+	int32_t iCheck;
+
+	if (argc != 3)
+	{
+		prvUsage();
+	}
+
+	if (strcmp(argv[1], "-") == 0)
+	{
+		pxIn = stdin;
+	}
+	else
+	{
+		pxIn = fopen(argv[1], "rb");
+		if (pxIn == (FILE*)0)
+		{
+			fprintf(stderr, "Could not open %s.\n", argv[1]);
+			return 1;
+		}
+	}
+
+	(void)xTraceSnapshotAssemblerInitialize(&xAssembler);
+
+	while ((iResult == 0) && ((uxRead = fread(auiBuffer, 1u, sizeof(auiBuffer), pxIn)) > 0u))
+	{
+		iResult = xTraceSnapshotAssemblerFeed(&xAssembler, auiBuffer, (uint32_t)uxRead);
+	}
+
+	if (pxIn != stdin)
+	{
+		(void)fclose(pxIn);
+	}
+
+	if (iResult != 0)
+	{
+		fprintf(stderr, "Record %u of %s is malformed.\n", (unsigned int)xAssembler.uiRecords, argv[1]);
+		vTraceSnapshotAssemblerFree(&xAssembler);
+		return 1;
+	}
+
+	iCheck = xTraceSnapshotAssemblerCheck(&xAssembler);
+
+	printf("%s endian, %u records, %llu bytes of records, %u bytes of recorder data, %s\n",
+		(xAssembler.uiBigEndian != 0u) ? "big" : "little",
+		(unsigned int)xAssembler.uiRecords,
+		(unsigned long long)xAssembler.ulBytes,
+		(unsigned int)xAssembler.uiSize,
+		aszChecks[iCheck]);
+
+	if ((xAssembler.uiRemaining != 0u) || (xAssembler.uiHeaderLength != 0u))
+	{
+		printf("The last record is incomplete.\n");
+	}
+
+	pxOut = fopen(argv[2], "wb");
+	if ((pxOut == (FILE*)0) || (fwrite(xAssembler.puiData, 1u, xAssembler.uiSize, pxOut) != xAssembler.uiSize))
+	{
+		fprintf(stderr, "Could not write %s.\n", argv[2]);
+		iResult = -1;
+	}
+
+	if ((pxOut != (FILE*)0) && (fclose(pxOut) != 0))
+	{
+		iResult = -1;
+	}
+
+	vTraceSnapshotAssemblerFree(&xAssembler);
+
+	if (iResult != 0)
+	{
+		return 1;
+	}
+
+	return (iCheck == TRC_SNAPSHOT_ASSEMBLER_COMPLETE) ? 0 : 2;
+}
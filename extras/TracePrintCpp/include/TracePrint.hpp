@@ -0,0 +1,300 @@
+/*
+ * Percepio Trace Recorder C++ User Events v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Header-only, type-safe alternative to xTracePrintF() for C++ code.
+ *
+ * xTracePrintF() scans the format string at runtime and reads every argument
+ * with va_arg() as TraceUnsignedBaseType_t. That mangles float, double and
+ * 64-bit integers on 32-bit ports. TracePrint::PrintF() instead deduces the
+ * argument types at compile time, packs each argument according to its type
+ * and computes the event code and payload size as constant expressions.
+ * The finished payload is handed to xTraceEventCreateData0() in one call.
+ *
+ * The event layout is the one xTracePrintF() produces, with the type tags
+ * added after the format string:
+ *	[channel][argument slots...][format string][type tags...]
+ * Each argument takes one TraceUnsignedBaseType_t slot, except 64-bit values
+ * (double, int64_t and uint64_t) on 32-bit ports, which take two consecutive
+ * slots holding the value's bytes in the port's byte order. Floating point
+ * values are stored as their IEEE-754 bit pattern, never converted to an
+ * integer or narrowed. The type tags, one byte per argument (see
+ * TracePrintDetail::ArgumentTag), follow the null termination of the format
+ * string, where they are ignored by Tracealyzer but let other tools tell the
+ * types apart and join the two slots of a Double, Int64 or Uint64 argument.
+ *
+ * Usage:
+ *	TraceStringHandle_t xChannel;
+ *	xTraceStringRegister("Motor", &xChannel);
+ *	TracePrint::PrintF(xChannel, "speed %f, ticks %u", 1.5f, 42u);
+ *
+ * Only streaming mode is supported. The C API is unaffected.
+ */
+
+#pragma once
+
+#include <trcRecorder.h>
+
+#if (TRC_USE_TRACEALYZER_RECORDER == 1) && (TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING) && (TRC_CFG_INCLUDE_USER_EVENTS == 1)
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+namespace TracePrintDetail
+{
+	/* Maximum number of argument slots, same as xTracePrintF() */
+	constexpr size_t MaxArgumentSlots = 5u;
+
+	constexpr size_t SlotSize = sizeof(TraceUnsignedBaseType_t);
+
+	/* Type tags describing how an argument is packed, stored after the format string */
+	enum class ArgumentTag : uint8_t
+	{
+		Signed = 1u,
+		Unsigned = 2u,
+		Float = 3u,		/* 32-bit IEEE-754 bit pattern */
+		Double = 4u,	/* 64-bit IEEE-754 bit pattern, two slots on 32-bit ports */
+		Pointer = 5u,
+		Int64 = 6u,		/* Two slots on 32-bit ports */
+		Uint64 = 7u		/* Two slots on 32-bit ports */
+	};
+
+	constexpr size_t SlotsFor(size_t uiSize)
+	{
+		return (uiSize + SlotSize - 1u) / SlotSize;
+	}
+
+	/* Stores the bytes of a value wider than a slot in consecutive slots */
+	inline void PackBits(TraceUnsignedBaseType_t* puxSlots, uint64_t ullBits)
+	{
+		memcpy(puxSlots, &ullBits, sizeof(ullBits));
+	}
+
+	template <typename T, typename Enable = void>
+	struct Argument
+	{
+		static_assert(sizeof(T) == 0u, "TracePrint: unsupported argument type");
+	};
+
+	template <typename T>
+	struct Argument<T, typename std::enable_if<std::is_integral<T>::value>::type>
+	{
+		static_assert(sizeof(T) <= sizeof(uint64_t), "TracePrint: integer wider than 64 bits, cast it");
+
+		static constexpr size_t Slots = SlotsFor(sizeof(T));
+
+		static constexpr ArgumentTag Tag = (sizeof(T) == sizeof(uint64_t)) ?
+			(std::is_signed<T>::value ? ArgumentTag::Int64 : ArgumentTag::Uint64) :
+			(std::is_signed<T>::value ? ArgumentTag::Signed : ArgumentTag::Unsigned);
+
+		static void Pack(T xValue, TraceUnsignedBaseType_t* puxSlots)
+		{
+			if (Slots > 1u)
+			{
+				/* Sign or zero extended to 64 bits, then split over the slots */
+				PackBits(puxSlots, std::is_signed<T>::value ? (uint64_t)(int64_t)xValue : (uint64_t)xValue);
+				return;
+			}
+
+			/* Sign extend signed values to the full slot width */
+			puxSlots[0] = std::is_signed<T>::value ? (TraceUnsignedBaseType_t)(TraceBaseType_t)xValue : (TraceUnsignedBaseType_t)xValue;
+		}
+	};
+
+	template <typename T>
+	struct Argument<T, typename std::enable_if<std::is_enum<T>::value>::type>
+	{
+		typedef typename std::underlying_type<T>::type Underlying;
+
+		static constexpr size_t Slots = Argument<Underlying>::Slots;
+
+		static constexpr ArgumentTag Tag = Argument<Underlying>::Tag;
+
+		static void Pack(T xValue, TraceUnsignedBaseType_t* puxSlots)
+		{
+			Argument<Underlying>::Pack((Underlying)xValue, puxSlots);
+		}
+	};
+
+	template <>
+	struct Argument<float>
+	{
+		static_assert(sizeof(float) == sizeof(uint32_t), "TracePrint: float must be 32 bits");
+
+		static constexpr size_t Slots = 1u;
+
+		static constexpr ArgumentTag Tag = ArgumentTag::Float;
+
+		static void Pack(float fValue, TraceUnsignedBaseType_t* puxSlots)
+		{
+			uint32_t uiBits;
+
+			memcpy(&uiBits, &fValue, sizeof(uiBits));
+
+			puxSlots[0] = (TraceUnsignedBaseType_t)uiBits;
+		}
+	};
+
+	template <>
+	struct Argument<double>
+	{
+		static_assert(sizeof(double) == sizeof(uint64_t), "TracePrint: double must be 64 bits");
+
+		static constexpr size_t Slots = SlotsFor(sizeof(double));
+
+		static constexpr ArgumentTag Tag = ArgumentTag::Double;
+
+		static void Pack(double dValue, TraceUnsignedBaseType_t* puxSlots)
+		{
+			uint64_t ullBits;
+
+			memcpy(&ullBits, &dValue, sizeof(ullBits));
+
+			PackBits(puxSlots, ullBits);
+		}
+	};
+
+	template <typename T>
+	struct Argument<T*, void>
+	{
+		/* %s expects a string handle from xTraceStringRegister(), not a RAM string */
+		static_assert(!std::is_same<typename std::remove_cv<T>::type, char>::value,
+			"TracePrint: pass a TraceStringHandle_t for %s, not a char pointer");
+
+		static constexpr size_t Slots = 1u;
+
+		static constexpr ArgumentTag Tag = ArgumentTag::Pointer;
+
+		static void Pack(T* pxValue, TraceUnsignedBaseType_t* puxSlots)
+		{
+			puxSlots[0] = (TraceUnsignedBaseType_t)(uintptr_t)pxValue;
+		}
+	};
+
+	/* Slots taken by the arguments */
+	constexpr size_t SlotsOf()
+	{
+		return 0u;
+	}
+
+	template <typename First, typename... Rest>
+	constexpr size_t SlotsOf(const First*, const Rest*... pxRest)
+	{
+		return Argument<typename std::decay<First>::type>::Slots + SlotsOf(pxRest...);
+	}
+
+	inline void PackArguments(TraceUnsignedBaseType_t* puxSlots, uint8_t* puiTags)
+	{
+		(void)puxSlots;
+		(void)puiTags;
+	}
+
+	template <typename First, typename... Rest>
+	inline void PackArguments(TraceUnsignedBaseType_t* puxSlots, uint8_t* puiTags, First xFirst, Rest... xRest)
+	{
+		typedef Argument<typename std::decay<First>::type> FirstArgument;
+
+		FirstArgument::Pack(xFirst, puxSlots);
+		puiTags[0] = (uint8_t)FirstArgument::Tag;
+		PackArguments(&puxSlots[FirstArgument::Slots], &puiTags[1], xRest...);
+	}
+
+	/* Payload words available after the event header */
+	constexpr size_t MaxPayloadSlots = (TRC_MAX_BLOB_SIZE - sizeof(TraceEvent0_t)) / SlotSize;
+}
+
+class TracePrint
+{
+public:
+	/**
+	 * @brief Stores a user event with type-checked arguments.
+	 *
+	 * The format string must be a string literal so that its length, and
+	 * with it the payload size, is known at compile time. Like xTracePrintF(),
+	 * the format string is truncated if the event would exceed TRC_MAX_BLOB_SIZE.
+	 *
+	 * @param[in] xChannel Channel, registered with xTraceStringRegister(), or
+	 * 0 for the "Default" channel.
+	 * @param[in] szFormat Format string literal.
+	 * @param[in] xArgs Arguments, integers, enums, float, double or handles.
+	 * At most 5 slots, where 64-bit values take two on 32-bit ports.
+	 *
+	 * @retval TRC_FAIL Failure
+	 * @retval TRC_SUCCESS Success
+	 */
+	template <size_t FormatSize, typename... Args>
+	static traceResult PrintF(TraceStringHandle_t xChannel, const char (&szFormat)[FormatSize], Args... xArgs)
+	{
+		using namespace TracePrintDetail;
+
+		constexpr size_t ArgumentCount = sizeof...(Args);
+		constexpr size_t ArgumentSlots = SlotsOf((const typename std::decay<Args>::type*)0 ...);
+		static_assert(ArgumentSlots <= MaxArgumentSlots, "TracePrint: too many arguments, max 5 slots");
+
+		constexpr size_t HeaderSlots = 1u + ArgumentSlots; /* Channel (1) */
+		constexpr size_t TrailerBytes = FormatSize + ArgumentCount; /* Format string and type tags */
+		constexpr size_t PayloadSlots = (HeaderSlots + SlotsFor(TrailerBytes)) < MaxPayloadSlots ? (HeaderSlots + SlotsFor(TrailerBytes)) : MaxPayloadSlots;
+		constexpr size_t FormatBytes = ((PayloadSlots - HeaderSlots) * SlotSize - ArgumentCount) < FormatSize ? ((PayloadSlots - HeaderSlots) * SlotSize - ArgumentCount) : FormatSize;
+		static_assert(FormatBytes > 0u, "TracePrint: no room for the format string");
+		constexpr uint32_t EventCode = (uint32_t)(PSF_EVENT_USER_EVENT + HeaderSlots);
+
+		TraceUnsignedBaseType_t uxPayload[PayloadSlots];
+		char* szPayloadFormat = (char*)&uxPayload[HeaderSlots];
+
+		/* We need to check this */
+		if (xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_PRINT) == 0U)
+		{
+			return TRC_FAIL;
+		}
+
+		if (xChannel == 0)
+		{
+			if (xTracePrintGetDefaultChannel(&xChannel) == TRC_FAIL)
+			{
+				return TRC_FAIL;
+			}
+		}
+
+		/* Zero the tail so that no stack contents are stored as padding */
+		uxPayload[PayloadSlots - 1u] = 0u;
+
+		uxPayload[0] = (TraceUnsignedBaseType_t)(uintptr_t)xChannel;
+		memcpy(szPayloadFormat, szFormat, FormatBytes);
+		szPayloadFormat[FormatBytes - 1u] = (char)0;
+		PackArguments(&uxPayload[1], (uint8_t*)&szPayloadFormat[FormatBytes], xArgs...);
+
+		return xTraceEventCreateData0(EventCode, uxPayload, PayloadSlots * SlotSize);
+	}
+
+	/**
+	 * @brief Stores a user event on the recorder's "Default" channel, as
+	 * xTracePrintF() does when no channel is given.
+	 *
+	 * @param[in] szFormat Format string literal.
+	 * @param[in] xArgs Arguments.
+	 *
+	 * @retval TRC_FAIL Failure
+	 * @retval TRC_SUCCESS Success
+	 */
+	template <size_t FormatSize, typename... Args>
+	static traceResult PrintF(const char (&szFormat)[FormatSize], Args... xArgs)
+	{
+		return PrintF((TraceStringHandle_t)0, szFormat, xArgs...);
+	}
+
+	/**
+	 * @brief Returns the compile-time type tag of an argument type.
+	 */
+	template <typename T>
+	static constexpr TracePrintDetail::ArgumentTag TagOf()
+	{
+		return TracePrintDetail::Argument<typename std::decay<T>::type>::Tag;
+	}
+};
+
+#endif
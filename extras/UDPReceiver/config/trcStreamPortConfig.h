@@ -0,0 +1,35 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * The configuration of the UDP stream port for the loopback target
+ * (trcUDPLoopbackTarget), used instead of streamports/UDP/config by the host
+ * CMake build. See streamports/UDP/config/trcStreamPortConfig.h.
+ */
+
+#ifndef TRC_STREAM_PORT_CONFIG_H
+#define TRC_STREAM_PORT_CONFIG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TRC_CFG_STREAM_PORT_UDP_ADDRESS "127.0.0.1"
+
+#define TRC_CFG_STREAM_PORT_UDP_PORT 8888
+
+#define TRC_CFG_STREAM_PORT_UDP_PACKET_SIZE 1472
+
+/* A host traces a lot more between two xTraceTzCtrl() calls */
+#define TRC_CFG_STREAM_PORT_UDP_PACKET_COUNT 512
+
+#define TRC_CFG_STREAM_PORT_UDP_FRAMING 1
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRC_STREAM_PORT_CONFIG_H */
@@ -0,0 +1,150 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Host side receiver for the framed UDP stream port (streamports/UDP with
+ * TRC_CFG_STREAM_PORT_UDP_FRAMING set to 1). Puts the datagrams back in
+ * order within a window, reports the lost ones and writes a trace that
+ * continues at the next whole event after each gap.
+ */
+
+#ifndef TRC_UDP_RECEIVER_H
+#define TRC_UDP_RECEIVER_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Wire format, see TraceStreamPortUDPFrame_t in streamports/UDP/include/trcStreamPort.h */
+#define TRC_UDP_RECEIVER_FRAME_SIZE 16u
+#define TRC_UDP_RECEIVER_FRAME_MAGIC 0x5446u
+#define TRC_UDP_RECEIVER_FRAME_VERSION 1u
+#define TRC_UDP_RECEIVER_FRAME_FLAG_SESSION_START 0x01u
+#define TRC_UDP_RECEIVER_FRAME_FLAG_SESSION_END 0x02u
+#define TRC_UDP_RECEIVER_FRAME_NO_EVENT 0xFFFFu
+
+#define TRC_UDP_RECEIVER_MAX_DATAGRAM 65507u
+
+/**
+ * @brief Called with trace data in order, starting and ending at event
+ * boundaries.
+ */
+typedef void (*TraceUDPReceiverWrite_t)(void* pvUser, const void* pvData, uint32_t uiSize);
+
+/**
+ * @brief Called for each range of lost datagrams, when it is certain they
+ * are lost.
+ */
+typedef void (*TraceUDPReceiverGap_t)(void* pvUser, uint32_t uiFirstSequence, uint32_t uiCount);
+
+typedef struct TraceUDPReceiverStatistics
+{
+	uint64_t ulBytes;				/* Trace data written */
+	uint32_t uiDatagrams;			/* Valid datagrams received */
+	uint32_t uiLost;				/* Datagrams never received */
+	uint32_t uiGaps;				/* Ranges of lost datagrams */
+	uint32_t uiReordered;			/* Received after a later datagram, put back in order */
+	uint32_t uiDiscarded;			/* Duplicates, or received after being counted as lost */
+	uint32_t uiInvalid;				/* Not a frame */
+	uint32_t uiSkippedBytes;		/* Bytes of partial events dropped around gaps */
+	uint32_t uiDroppedEvents;		/* Events dropped by the target, all sessions */
+	uint32_t uiSessions;
+} TraceUDPReceiverStatistics_t;
+
+typedef struct TraceUDPReceiver
+{
+	uint8_t* puiWindow;				/* uiWindowSize datagrams, by sequence number modulo uiWindowSize */
+	uint32_t* puiLength;			/* Length of each datagram in the window, 0 if empty */
+	uint32_t uiWindowSize;
+	uint32_t uiNext;				/* Next sequence number to deliver */
+	uint32_t uiHighest;				/* Highest sequence number received in this session */
+	uint32_t uiStarted;				/* A datagram of the session has been received */
+	uint32_t uiSynced;				/* The output is at an event boundary */
+	uint32_t uiEnded;				/* The session end has been delivered */
+	uint32_t uiGapFirst;
+	uint32_t uiGapCount;
+	uint32_t uiSessionDropped;		/* Events dropped by the target in this session */
+	uint8_t* puiPending;			/* Partial event waiting for the next datagram */
+	uint32_t uiPendingSize;
+	uint32_t uiPendingCapacity;
+	TraceUDPReceiverWrite_t xWrite;
+	TraceUDPReceiverGap_t xGap;
+	void* pvUser;
+	TraceUDPReceiverStatistics_t xStatistics;
+} TraceUDPReceiver_t;
+
+/**
+ * @brief Initializes a receiver.
+ *
+ * @param[out] pxReceiver Receiver
+ * @param[in] uiWindowSize Datagrams that can be held back waiting for an
+ * earlier one. A datagram is counted as lost when one this far ahead of it
+ * has arrived.
+ * @param[in] xWrite Trace data callback
+ * @param[in] xGap Gap callback, can be null
+ * @param[in] pvUser Passed to the callbacks
+ *
+ * @retval -1 Failure
+ * @retval 0 Success
+ */
+int32_t xTraceUDPReceiverInitialize(TraceUDPReceiver_t* pxReceiver, uint32_t uiWindowSize, TraceUDPReceiverWrite_t xWrite, TraceUDPReceiverGap_t xGap, void* pvUser);
+
+/**
+ * @brief Handles a received datagram.
+ *
+ * @param[in] pxReceiver Receiver
+ * @param[in] pvData Datagram
+ * @param[in] uiSize Datagram size
+ *
+ * @retval -1 Not a valid frame, ignored
+ * @retval 0 Success
+ */
+int32_t xTraceUDPReceiverPush(TraceUDPReceiver_t* pxReceiver, const void* pvData, uint32_t uiSize);
+
+/**
+ * @brief Delivers everything held back and counts the missing datagrams
+ * before them as lost. Call when no more datagrams are expected.
+ *
+ * @param[in] pxReceiver Receiver
+ */
+void vTraceUDPReceiverFlush(TraceUDPReceiver_t* pxReceiver);
+
+/**
+ * @brief Checks if the end of the session has been delivered.
+ *
+ * @param[in] pxReceiver Receiver
+ *
+ * @retval 1 Ended
+ * @retval 0 Not ended
+ */
+uint32_t xTraceUDPReceiverIsEnded(const TraceUDPReceiver_t* pxReceiver);
+
+/**
+ * @brief Gets the sequence number of a datagram.
+ *
+ * @param[in] pvData Datagram
+ * @param[in] uiSize Datagram size
+ * @param[out] puiSequence Sequence number
+ *
+ * @retval -1 Not a valid frame
+ * @retval 0 Success
+ */
+int32_t xTraceUDPReceiverGetSequence(const void* pvData, uint32_t uiSize, uint32_t* puiSequence);
+
+/**
+ * @brief Frees the memory of a receiver.
+ *
+ * @param[in] pxReceiver Receiver
+ */
+void vTraceUDPReceiverDeinitialize(TraceUDPReceiver_t* pxReceiver);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRC_UDP_RECEIVER_H */
@@ -0,0 +1,115 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * A traced program using the framed UDP stream port on the host, to test
+ * trcUDPReceiver over loopback. It waits for the start command, generates
+ * user events from a number of threads and stops, which sends the session
+ * end to the receiver.
+ *
+ *	trcUDPLoopbackTarget [threads] [events per thread] [TzCtrl period in us]
+ */
+
+#include <trcRecorder.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define LOOPBACK_MAX_THREADS 64u
+
+static volatile uint32_t uiStopTzCtrl = 0u;
+static uint32_t uiEventsPerThread = 100000u;
+static uint32_t uiTzCtrlPeriod = 1000u;
+
+static void* prvTzCtrl(void* pvArg)
+{
+	while (uiStopTzCtrl == 0u)
+	{
+		(void)xTraceTzCtrl();
+		(void)usleep(uiTzCtrlPeriod);
+	}
+
+	return pvArg;
+}
+
+static void* prvWorker(void* pvArg)
+{
+	TraceStringHandle_t xChannel;
+	uint32_t i;
+
+	(void)xTraceStringRegister("loopback", &xChannel);
+
+	for (i = 0u; i < uiEventsPerThread; i++)
+	{
+		(void)xTracePrintF(xChannel, "%d %d", (int)i, (int)(i >> 8));
+
+		if ((i & 0xFFu) == 0u)
+		{
+			/* Roughly what a real system produces, rather than a flood */
+			(void)usleep(100);
+		}
+	}
+
+	return pvArg;
+}
+
+int main(int argc, char** argv)
+{
+	pthread_t xTzCtrl, xWorkers[LOOPBACK_MAX_THREADS];
+	uint32_t uiThreads = 2u;
+	uint32_t i;
+
+	if (argc > 1)
+	{
+		uiThreads = (uint32_t)strtoul(argv[1], (char**)0, 0);
+	}
+	if (argc > 2)
+	{
+		uiEventsPerThread = (uint32_t)strtoul(argv[2], (char**)0, 0);
+	}
+	if (argc > 3)
+	{
+		uiTzCtrlPeriod = (uint32_t)strtoul(argv[3], (char**)0, 0);
+	}
+	if ((uiThreads == 0u) || (uiThreads > LOOPBACK_MAX_THREADS))
+	{
+		uiThreads = 2u;
+	}
+
+	(void)xTraceInitialize();
+
+	printf("Waiting for trcUDPReceiver on port %u.\n", (unsigned int)(TRC_CFG_STREAM_PORT_UDP_PORT));
+	(void)xTraceEnable(TRC_START_AWAIT_HOST);
+
+	(void)pthread_create(&xTzCtrl, (const pthread_attr_t*)0, prvTzCtrl, (void*)0);
+
+	for (i = 0u; i < uiThreads; i++)
+	{
+		(void)pthread_create(&xWorkers[i], (const pthread_attr_t*)0, prvWorker, (void*)0);
+	}
+
+	for (i = 0u; i < uiThreads; i++)
+	{
+		(void)pthread_join(xWorkers[i], (void**)0);
+	}
+
+	uiStopTzCtrl = 1u;
+	(void)pthread_join(xTzCtrl, (void**)0);
+
+	(void)xTraceDisable();
+
+	/* Sends what is left, including the session end */
+	for (i = 0u; i < 10u; i++)
+	{
+		(void)xTraceTzCtrl();
+		(void)usleep(1000);
+	}
+
+	printf("Done, %u events.\n", (unsigned int)(uiThreads * uiEventsPerThread));
+
+	return 0;
+}
@@ -0,0 +1,409 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Host side receiver for the framed UDP stream port.
+ */
+
+#include <trcUDPReceiver.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct TraceUDPReceiverFrame
+{
+	uint32_t uiFlags;
+	uint32_t uiSequence;
+	uint32_t uiFirstEvent;
+	uint32_t uiEventsEnd;
+	uint32_t uiDroppedEvents;
+	uint32_t uiPayloadSize;
+	const uint8_t* puiPayload;
+} TraceUDPReceiverFrame_t;
+
+static uint16_t prvRead16(const uint8_t* puiData, uint32_t uiSwap)
+{
+	uint16_t uiValue;
+
+	(void)memcpy(&uiValue, puiData, sizeof(uiValue));
+
+	return (uiSwap != 0u) ? (uint16_t)((uiValue >> 8) | (uiValue << 8)) : uiValue;
+}
+
+static uint32_t prvRead32(const uint8_t* puiData, uint32_t uiSwap)
+{
+	uint32_t uiValue;
+
+	(void)memcpy(&uiValue, puiData, sizeof(uiValue));
+
+	if (uiSwap != 0u)
+	{
+		uiValue = ((uiValue >> 24) & 0xFFu) | ((uiValue >> 8) & 0xFF00u) | ((uiValue << 8) & 0xFF0000u) | (uiValue << 24);
+	}
+
+	return uiValue;
+}
+
+/* Parses and checks the frame header, in either byte order */
+static int32_t prvParse(const uint8_t* puiData, uint32_t uiSize, TraceUDPReceiverFrame_t* pxFrame)
+{
+	uint32_t uiSwap;
+
+	if (uiSize < TRC_UDP_RECEIVER_FRAME_SIZE)
+	{
+		return -1;
+	}
+
+	if (prvRead16(puiData, 0u) == TRC_UDP_RECEIVER_FRAME_MAGIC)
+	{
+		uiSwap = 0u;
+	}
+	else if (prvRead16(puiData, 1u) == TRC_UDP_RECEIVER_FRAME_MAGIC)
+	{
+		uiSwap = 1u;
+	}
+	else
+	{
+		return -1;
+	}
+
+	if (puiData[2] != TRC_UDP_RECEIVER_FRAME_VERSION)
+	{
+		return -1;
+	}
+
+	pxFrame->uiFlags = puiData[3];
+	pxFrame->uiSequence = prvRead32(&puiData[4], uiSwap);
+	pxFrame->uiFirstEvent = prvRead16(&puiData[8], uiSwap);
+	pxFrame->uiEventsEnd = prvRead16(&puiData[10], uiSwap);
+	pxFrame->uiDroppedEvents = prvRead32(&puiData[12], uiSwap);
+	pxFrame->uiPayloadSize = uiSize - TRC_UDP_RECEIVER_FRAME_SIZE;
+	pxFrame->puiPayload = &puiData[TRC_UDP_RECEIVER_FRAME_SIZE];
+
+	if (pxFrame->uiEventsEnd > pxFrame->uiPayloadSize)
+	{
+		return -1;
+	}
+
+	if ((pxFrame->uiFirstEvent != TRC_UDP_RECEIVER_FRAME_NO_EVENT) && (pxFrame->uiFirstEvent > pxFrame->uiEventsEnd))
+	{
+		return -1;
+	}
+
+	return 0;
+}
+
+static void prvWrite(TraceUDPReceiver_t* pxReceiver, const uint8_t* puiData, uint32_t uiSize)
+{
+	if (uiSize > 0u)
+	{
+		pxReceiver->xWrite(pxReceiver->pvUser, puiData, uiSize);
+		pxReceiver->xStatistics.ulBytes += uiSize;
+	}
+}
+
+static void prvPendingAppend(TraceUDPReceiver_t* pxReceiver, const uint8_t* puiData, uint32_t uiSize)
+{
+	uint8_t* puiPending;
+	uint32_t uiCapacity;
+
+	if (pxReceiver->uiPendingSize + uiSize > pxReceiver->uiPendingCapacity)
+	{
+		uiCapacity = (pxReceiver->uiPendingSize + uiSize) * 2u;
+		puiPending = (uint8_t*)realloc(pxReceiver->puiPending, uiCapacity);
+		if (puiPending == (void*)0)
+		{
+			/* The event is lost, continue at the next one */
+			pxReceiver->xStatistics.uiSkippedBytes += pxReceiver->uiPendingSize + uiSize;
+			pxReceiver->uiPendingSize = 0u;
+			pxReceiver->uiSynced = 0u;
+
+			return;
+		}
+
+		pxReceiver->puiPending = puiPending;
+		pxReceiver->uiPendingCapacity = uiCapacity;
+	}
+
+	(void)memcpy(&pxReceiver->puiPending[pxReceiver->uiPendingSize], puiData, uiSize);
+	pxReceiver->uiPendingSize += uiSize;
+}
+
+static void prvPendingDiscard(TraceUDPReceiver_t* pxReceiver)
+{
+	pxReceiver->xStatistics.uiSkippedBytes += pxReceiver->uiPendingSize;
+	pxReceiver->uiPendingSize = 0u;
+}
+
+static void prvLose(TraceUDPReceiver_t* pxReceiver, uint32_t uiSequence, uint32_t uiCount)
+{
+	if (pxReceiver->uiGapCount == 0u)
+	{
+		pxReceiver->uiGapFirst = uiSequence;
+	}
+
+	pxReceiver->uiGapCount += uiCount;
+	pxReceiver->xStatistics.uiLost += uiCount;
+}
+
+static void prvDeliver(TraceUDPReceiver_t* pxReceiver, const TraceUDPReceiverFrame_t* pxFrame)
+{
+	if (pxReceiver->uiGapCount > 0u)
+	{
+		/* The events on both sides of the gap are incomplete */
+		if (pxReceiver->xGap != (void*)0)
+		{
+			pxReceiver->xGap(pxReceiver->pvUser, pxReceiver->uiGapFirst, pxReceiver->uiGapCount);
+		}
+
+		pxReceiver->xStatistics.uiGaps++;
+		pxReceiver->uiGapCount = 0u;
+		prvPendingDiscard(pxReceiver);
+		pxReceiver->uiSynced = 0u;
+	}
+
+	if (pxFrame->uiDroppedEvents > pxReceiver->uiSessionDropped)
+	{
+		pxReceiver->xStatistics.uiDroppedEvents += pxFrame->uiDroppedEvents - pxReceiver->uiSessionDropped;
+		pxReceiver->uiSessionDropped = pxFrame->uiDroppedEvents;
+	}
+
+	if (pxReceiver->uiSynced != 0u)
+	{
+		if (pxFrame->uiEventsEnd > 0u)
+		{
+			/* Completes the pending event */
+			prvWrite(pxReceiver, pxReceiver->puiPending, pxReceiver->uiPendingSize);
+			pxReceiver->uiPendingSize = 0u;
+			prvWrite(pxReceiver, pxFrame->puiPayload, pxFrame->uiEventsEnd);
+		}
+	}
+	else if (pxFrame->uiFirstEvent != TRC_UDP_RECEIVER_FRAME_NO_EVENT)
+	{
+		pxReceiver->xStatistics.uiSkippedBytes += pxFrame->uiFirstEvent;
+		prvWrite(pxReceiver, &pxFrame->puiPayload[pxFrame->uiFirstEvent], pxFrame->uiEventsEnd - pxFrame->uiFirstEvent);
+		pxReceiver->uiSynced = 1u;
+	}
+	else
+	{
+		/* Still inside an event that started before the gap */
+		pxReceiver->xStatistics.uiSkippedBytes += pxFrame->uiPayloadSize;
+
+		return;
+	}
+
+	prvPendingAppend(pxReceiver, &pxFrame->puiPayload[pxFrame->uiEventsEnd], pxFrame->uiPayloadSize - pxFrame->uiEventsEnd);
+
+	if ((pxFrame->uiFlags & TRC_UDP_RECEIVER_FRAME_FLAG_SESSION_END) != 0u)
+	{
+		prvPendingDiscard(pxReceiver);
+		pxReceiver->uiEnded = 1u;
+	}
+}
+
+/* Delivers the next datagram if it is in the window, otherwise counts it as lost */
+static void prvAdvance(TraceUDPReceiver_t* pxReceiver)
+{
+	uint32_t uiSlot = pxReceiver->uiNext & (pxReceiver->uiWindowSize - 1u);
+	TraceUDPReceiverFrame_t xFrame;
+
+	if (pxReceiver->puiLength[uiSlot] != 0u)
+	{
+		(void)prvParse(&pxReceiver->puiWindow[uiSlot * TRC_UDP_RECEIVER_MAX_DATAGRAM], pxReceiver->puiLength[uiSlot], &xFrame);
+		prvDeliver(pxReceiver, &xFrame);
+		pxReceiver->puiLength[uiSlot] = 0u;
+	}
+	else
+	{
+		prvLose(pxReceiver, pxReceiver->uiNext, 1u);
+	}
+
+	pxReceiver->uiNext++;
+}
+
+static uint32_t prvHeld(const TraceUDPReceiver_t* pxReceiver)
+{
+	uint32_t uiHeld = 0u;
+	uint32_t i;
+
+	for (i = 0u; i < pxReceiver->uiWindowSize; i++)
+	{
+		if (pxReceiver->puiLength[i] != 0u)
+		{
+			uiHeld++;
+		}
+	}
+
+	return uiHeld;
+}
+
+int32_t xTraceUDPReceiverInitialize(TraceUDPReceiver_t* pxReceiver, uint32_t uiWindowSize, TraceUDPReceiverWrite_t xWrite, TraceUDPReceiverGap_t xGap, void* pvUser)
+{
+	uint32_t uiSize = 1u;
+
+	if ((pxReceiver == (void*)0) || (xWrite == (void*)0))
+	{
+		return -1;
+	}
+
+	/* A power of two, so the slots stay in order when the sequence number wraps */
+	while ((uiSize < uiWindowSize) && (uiSize < 0x10000u))
+	{
+		uiSize <<= 1;
+	}
+
+	(void)memset(pxReceiver, 0, sizeof(TraceUDPReceiver_t));
+	pxReceiver->uiWindowSize = uiSize;
+	pxReceiver->puiWindow = (uint8_t*)malloc((size_t)uiSize * TRC_UDP_RECEIVER_MAX_DATAGRAM);
+	pxReceiver->puiLength = (uint32_t*)calloc(uiSize, sizeof(uint32_t));
+	pxReceiver->xWrite = xWrite;
+	pxReceiver->xGap = xGap;
+	pxReceiver->pvUser = pvUser;
+
+	if ((pxReceiver->puiWindow == (void*)0) || (pxReceiver->puiLength == (void*)0))
+	{
+		vTraceUDPReceiverDeinitialize(pxReceiver);
+
+		return -1;
+	}
+
+	return 0;
+}
+
+int32_t xTraceUDPReceiverPush(TraceUDPReceiver_t* pxReceiver, const void* pvData, uint32_t uiSize)
+{
+	TraceUDPReceiverFrame_t xFrame;
+	uint32_t uiSlot;
+	int32_t iAhead;
+
+	if ((uiSize > TRC_UDP_RECEIVER_MAX_DATAGRAM) || (prvParse((const uint8_t*)pvData, uiSize, &xFrame) != 0))
+	{
+		pxReceiver->xStatistics.uiInvalid++;
+
+		return -1;
+	}
+
+	pxReceiver->xStatistics.uiDatagrams++;
+
+	if ((xFrame.uiFlags & TRC_UDP_RECEIVER_FRAME_FLAG_SESSION_START) != 0u)
+	{
+		/* A new session, a duplicate of the first datagram would also end up here */
+		vTraceUDPReceiverFlush(pxReceiver);
+		pxReceiver->uiNext = xFrame.uiSequence;
+		pxReceiver->uiHighest = xFrame.uiSequence;
+		pxReceiver->uiStarted = 1u;
+		pxReceiver->uiSynced = 1u;
+		pxReceiver->uiEnded = 0u;
+		pxReceiver->uiSessionDropped = 0u;
+		pxReceiver->xStatistics.uiSessions++;
+	}
+	else if (pxReceiver->uiStarted == 0u)
+	{
+		/* Joined in the middle of a session, continue at the first whole event */
+		pxReceiver->uiNext = xFrame.uiSequence;
+		pxReceiver->uiHighest = xFrame.uiSequence;
+		pxReceiver->uiStarted = 1u;
+		pxReceiver->uiSynced = 0u;
+		pxReceiver->xStatistics.uiSessions++;
+	}
+	else if (pxReceiver->uiEnded != 0u)
+	{
+		/* Left over from a session that has ended */
+		pxReceiver->xStatistics.uiDiscarded++;
+
+		return 0;
+	}
+
+	iAhead = (int32_t)(xFrame.uiSequence - pxReceiver->uiNext);
+	if (iAhead < 0)
+	{
+		pxReceiver->xStatistics.uiDiscarded++;
+
+		return 0;
+	}
+
+	/* Make room in the window, what hasn't arrived by now is lost */
+	while ((uint32_t)iAhead >= pxReceiver->uiWindowSize)
+	{
+		if (prvHeld(pxReceiver) == 0u)
+		{
+			prvLose(pxReceiver, pxReceiver->uiNext, (uint32_t)iAhead - pxReceiver->uiWindowSize + 1u);
+			pxReceiver->uiNext += (uint32_t)iAhead - pxReceiver->uiWindowSize + 1u;
+			iAhead = (int32_t)pxReceiver->uiWindowSize - 1;
+		}
+		else
+		{
+			prvAdvance(pxReceiver);
+			iAhead--;
+		}
+	}
+
+	uiSlot = xFrame.uiSequence & (pxReceiver->uiWindowSize - 1u);
+	if (pxReceiver->puiLength[uiSlot] != 0u)
+	{
+		pxReceiver->xStatistics.uiDiscarded++;
+
+		return 0;
+	}
+
+	(void)memcpy(&pxReceiver->puiWindow[uiSlot * TRC_UDP_RECEIVER_MAX_DATAGRAM], pvData, uiSize);
+	pxReceiver->puiLength[uiSlot] = uiSize;
+
+	if ((int32_t)(xFrame.uiSequence - pxReceiver->uiHighest) < 0)
+	{
+		pxReceiver->xStatistics.uiReordered++;
+	}
+	else
+	{
+		pxReceiver->uiHighest = xFrame.uiSequence;
+	}
+
+	while (pxReceiver->puiLength[pxReceiver->uiNext & (pxReceiver->uiWindowSize - 1u)] != 0u)
+	{
+		prvAdvance(pxReceiver);
+	}
+
+	return 0;
+}
+
+void vTraceUDPReceiverFlush(TraceUDPReceiver_t* pxReceiver)
+{
+	while (prvHeld(pxReceiver) > 0u)
+	{
+		prvAdvance(pxReceiver);
+	}
+
+	/* Nothing arrives to complete it */
+	prvPendingDiscard(pxReceiver);
+}
+
+uint32_t xTraceUDPReceiverIsEnded(const TraceUDPReceiver_t* pxReceiver)
+{
+	return pxReceiver->uiEnded;
+}
+
+int32_t xTraceUDPReceiverGetSequence(const void* pvData, uint32_t uiSize, uint32_t* puiSequence)
+{
+	TraceUDPReceiverFrame_t xFrame;
+
+	if (prvParse((const uint8_t*)pvData, uiSize, &xFrame) != 0)
+	{
+		return -1;
+	}
+
+	*puiSequence = xFrame.uiSequence;
+
+	return 0;
+}
+
+void vTraceUDPReceiverDeinitialize(TraceUDPReceiver_t* pxReceiver)
+{
+	free(pxReceiver->puiWindow);
+	free(pxReceiver->puiLength);
+	free(pxReceiver->puiPending);
+	pxReceiver->puiWindow = (void*)0;
+	pxReceiver->puiLength = (void*)0;
+	pxReceiver->puiPending = (void*)0;
+}
@@ -0,0 +1,300 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Command line receiver for the framed UDP stream port. Sends the start
+ * command to the target, receives the trace and writes it to a file that
+ * Tracealyzer can open. Datagrams can be dropped or reordered on purpose, to
+ * test the loss handling over loopback.
+ *
+ *	trcUDPReceiver [-t address] [-p port] [-b local port] [-n] [-o file]
+ *		[-w window] [-l loss percent] [-r reorder percent] [-s seed]
+ *		[-i idle timeout in s]
+ */
+
+#include <trcUDPReceiver.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/* CMD_SET_ACTIVE with param1 = 1 or 0, the checksum is 0xFFFF minus the sum of the other bytes */
+static const uint8_t uiStartCommand[8] = { 1u, 1u, 0u, 0u, 0u, 0u, 0xFDu, 0xFFu };
+static const uint8_t uiStopCommand[8] = { 1u, 0u, 0u, 0u, 0u, 0u, 0xFEu, 0xFFu };
+
+static volatile sig_atomic_t iStop = 0;
+
+static uint32_t* puiInjectedLoss = (void*)0;
+static uint32_t uiInjectedLoss = 0u;
+static uint32_t uiInjectedReorder = 0u;
+
+static void prvOnSignal(int iSignal)
+{
+	(void)iSignal;
+
+	iStop = 1;
+}
+
+static void prvWrite(void* pvUser, const void* pvData, uint32_t uiSize)
+{
+	if (fwrite(pvData, 1, uiSize, (FILE*)pvUser) != uiSize)
+	{
+		fprintf(stderr, "Write failed.\n");
+		exit(1);
+	}
+}
+
+static void prvGap(void* pvUser, uint32_t uiFirstSequence, uint32_t uiCount)
+{
+	(void)pvUser;
+
+	fprintf(stderr, "lost datagrams %u-%u\n", (unsigned int)uiFirstSequence, (unsigned int)(uiFirstSequence + uiCount - 1u));
+}
+
+static uint32_t prvChance(uint32_t uiPercent)
+{
+	return ((uint32_t)rand() % 100u) < uiPercent;
+}
+
+static void prvUsage(void)
+{
+	fprintf(stderr,
+		"trcUDPReceiver [-t address] [-p port] [-b local port] [-n] [-o file]\n"
+		"\t[-w window] [-l loss percent] [-r reorder percent] [-s seed] [-i idle timeout in s]\n"
+		"\n"
+		"-t, -p  The target, default 127.0.0.1 8888\n"
+		"-b      Local port, default any\n"
+		"-n      Don't send the start command, the target is already sending here\n"
+		"-o      Output file, default trace.psf, - for stdout\n"
+		"-w      Datagrams held back waiting for an earlier one, default 64\n"
+		"-l, -r  Drop or reorder this percentage of the datagrams, for testing\n"
+		"-i      Stop after this many seconds without data, default 5\n");
+	exit(1);
+}
+
+int main(int argc, char** argv)
+{
+	static uint8_t uiDatagram[2][TRC_UDP_RECEIVER_MAX_DATAGRAM];
+	struct sockaddr_in xTarget = { 0 };
+	struct sockaddr_in xLocal = { 0 };
+	struct sigaction xAction = { 0 };
+	struct pollfd xPoll;
+	TraceUDPReceiver_t xReceiver;
+	const char* szTarget = "127.0.0.1";
+	const char* szOutput = "trace.psf";
+	uint32_t uiPort = 8888u;
+	uint32_t uiLocalPort = 0u;
+	uint32_t uiSendStart = 1u;
+	uint32_t uiWindow = 64u;
+	uint32_t uiLoss = 0u;
+	uint32_t uiReorder = 0u;
+	uint32_t uiIdleTimeout = 5u;
+	uint32_t uiIdle = 0u;
+	uint32_t uiHeld = 0u;
+	uint32_t uiHeldSize = 0u;
+	uint32_t uiSequence;
+	uint32_t uiFirstSequence = 0xFFFFFFFFu;
+	uint32_t uiExpectedLoss = 0u;
+	uint32_t i;
+	ssize_t iSize;
+	FILE* pxOutput;
+	int iSocket;
+	int iOption;
+	int iReceiveBuffer = 8 * 1024 * 1024;
+	int iResult = 0;
+
+	while ((iOption = getopt(argc, argv, "t:p:b:no:w:l:r:s:i:h")) != -1)
+	{
+		switch (iOption)
+		{
+		case 't': szTarget = optarg; break;
+		case 'p': uiPort = (uint32_t)strtoul(optarg, (char**)0, 0); break;
+		case 'b': uiLocalPort = (uint32_t)strtoul(optarg, (char**)0, 0); break;
+		case 'n': uiSendStart = 0u; break;
+		case 'o': szOutput = optarg; break;
+		case 'w': uiWindow = (uint32_t)strtoul(optarg, (char**)0, 0); break;
+		case 'l': uiLoss = (uint32_t)strtoul(optarg, (char**)0, 0); break;
+		case 'r': uiReorder = (uint32_t)strtoul(optarg, (char**)0, 0); break;
+		case 's': srand((unsigned int)strtoul(optarg, (char**)0, 0)); break;
+		case 'i': uiIdleTimeout = (uint32_t)strtoul(optarg, (char**)0, 0); break;
+		default: prvUsage(); break;
+		}
+	}
+
+	pxOutput = (strcmp(szOutput, "-") == 0) ? stdout : fopen(szOutput, "wb");
+	if (pxOutput == (void*)0)
+	{
+		fprintf(stderr, "Could not open %s.\n", szOutput);
+		return 1;
+	}
+
+	if (xTraceUDPReceiverInitialize(&xReceiver, uiWindow, prvWrite, prvGap, pxOutput) != 0)
+	{
+		fprintf(stderr, "Out of memory.\n");
+		return 1;
+	}
+
+	iSocket = socket(AF_INET, SOCK_DGRAM, 0);
+	xLocal.sin_family = AF_INET;
+	xLocal.sin_port = htons((uint16_t)uiLocalPort);
+	xLocal.sin_addr.s_addr = htonl(INADDR_ANY);
+	if ((iSocket < 0) || (bind(iSocket, (struct sockaddr*)&xLocal, sizeof(xLocal)) != 0))
+	{
+		fprintf(stderr, "Could not bind port %u.\n", (unsigned int)uiLocalPort);
+		return 1;
+	}
+
+	/* The target sends bursts, every xTraceTzCtrl() period */
+	(void)setsockopt(iSocket, SOL_SOCKET, SO_RCVBUF, &iReceiveBuffer, sizeof(iReceiveBuffer));
+
+	xTarget.sin_family = AF_INET;
+	xTarget.sin_port = htons((uint16_t)uiPort);
+	xTarget.sin_addr.s_addr = inet_addr(szTarget);
+
+	/* Not SA_RESTART, so poll() returns */
+	xAction.sa_handler = prvOnSignal;
+	(void)sigaction(SIGINT, &xAction, (struct sigaction*)0);
+	(void)sigaction(SIGTERM, &xAction, (struct sigaction*)0);
+
+	if (uiSendStart != 0u)
+	{
+		(void)sendto(iSocket, uiStartCommand, sizeof(uiStartCommand), 0, (struct sockaddr*)&xTarget, sizeof(xTarget));
+	}
+
+	xPoll.fd = iSocket;
+	xPoll.events = POLLIN;
+
+	while ((iStop == 0) && (xTraceUDPReceiverIsEnded(&xReceiver) == 0u) && (uiIdle < uiIdleTimeout * 10u))
+	{
+		if (poll(&xPoll, 1, 100) <= 0)
+		{
+			uiIdle++;
+
+			if ((uiSendStart != 0u) && (xReceiver.xStatistics.uiDatagrams == 0u))
+			{
+				/* The command may have been lost, or the target wasn't ready */
+				(void)sendto(iSocket, uiStartCommand, sizeof(uiStartCommand), 0, (struct sockaddr*)&xTarget, sizeof(xTarget));
+			}
+
+			continue;
+		}
+
+		uiIdle = 0u;
+
+		iSize = recv(iSocket, uiDatagram[0], sizeof(uiDatagram[0]), 0);
+		if (iSize <= 0)
+		{
+			continue;
+		}
+
+		if ((uiFirstSequence == 0xFFFFFFFFu) && (xTraceUDPReceiverGetSequence(uiDatagram[0], (uint32_t)iSize, &uiSequence) == 0))
+		{
+			uiFirstSequence = uiSequence;
+		}
+
+		if ((uiLoss > 0u) && prvChance(uiLoss))
+		{
+			if (xTraceUDPReceiverGetSequence(uiDatagram[0], (uint32_t)iSize, &uiSequence) == 0)
+			{
+				puiInjectedLoss = (uint32_t*)realloc(puiInjectedLoss, (uiInjectedLoss + 1u) * sizeof(uint32_t));
+				if (puiInjectedLoss == (void*)0)
+				{
+					fprintf(stderr, "Out of memory.\n");
+					return 1;
+				}
+				puiInjectedLoss[uiInjectedLoss] = uiSequence;
+				uiInjectedLoss++;
+			}
+
+			continue;
+		}
+
+		if (uiHeld != 0u)
+		{
+			/* Deliver the held back datagram after this one */
+			(void)xTraceUDPReceiverPush(&xReceiver, uiDatagram[0], (uint32_t)iSize);
+			(void)xTraceUDPReceiverPush(&xReceiver, uiDatagram[1], uiHeldSize);
+			uiHeld = 0u;
+		}
+		else if ((uiReorder > 0u) && prvChance(uiReorder))
+		{
+			(void)memcpy(uiDatagram[1], uiDatagram[0], (size_t)iSize);
+			uiHeldSize = (uint32_t)iSize;
+			uiHeld = 1u;
+			uiInjectedReorder++;
+		}
+		else
+		{
+			(void)xTraceUDPReceiverPush(&xReceiver, uiDatagram[0], (uint32_t)iSize);
+		}
+	}
+
+	if (uiHeld != 0u)
+	{
+		(void)xTraceUDPReceiverPush(&xReceiver, uiDatagram[1], uiHeldSize);
+	}
+
+	if ((uiSendStart != 0u) && (xTraceUDPReceiverIsEnded(&xReceiver) == 0u))
+	{
+		(void)sendto(iSocket, uiStopCommand, sizeof(uiStopCommand), 0, (struct sockaddr*)&xTarget, sizeof(xTarget));
+	}
+
+	vTraceUDPReceiverFlush(&xReceiver);
+
+	fprintf(stderr, "%s, %u sessions, %llu bytes of trace data\n",
+		(xTraceUDPReceiverIsEnded(&xReceiver) != 0u) ? "session ended" : "stopped",
+		(unsigned int)xReceiver.xStatistics.uiSessions,
+		(unsigned long long)xReceiver.xStatistics.ulBytes);
+	fprintf(stderr, "datagrams %u, lost %u in %u gaps, reordered %u, discarded %u, invalid %u\n",
+		(unsigned int)xReceiver.xStatistics.uiDatagrams,
+		(unsigned int)xReceiver.xStatistics.uiLost,
+		(unsigned int)xReceiver.xStatistics.uiGaps,
+		(unsigned int)xReceiver.xStatistics.uiReordered,
+		(unsigned int)xReceiver.xStatistics.uiDiscarded,
+		(unsigned int)xReceiver.xStatistics.uiInvalid);
+	fprintf(stderr, "partial event bytes skipped %u, events dropped by the target %u\n",
+		(unsigned int)xReceiver.xStatistics.uiSkippedBytes,
+		(unsigned int)xReceiver.xStatistics.uiDroppedEvents);
+
+	if ((uiLoss > 0u) || (uiReorder > 0u))
+	{
+		/* Drops before the first or after the last received datagram can't be seen. This assumes a single session. */
+		for (i = 0u; i < uiInjectedLoss; i++)
+		{
+			if ((puiInjectedLoss[i] > uiFirstSequence) && (puiInjectedLoss[i] < xReceiver.uiHighest))
+			{
+				uiExpectedLoss++;
+			}
+		}
+
+		fprintf(stderr, "injected: dropped %u (%u between received datagrams), reordered %u\n",
+			(unsigned int)uiInjectedLoss, (unsigned int)uiExpectedLoss, (unsigned int)uiInjectedReorder);
+
+		if (xReceiver.xStatistics.uiLost != uiExpectedLoss)
+		{
+			fprintf(stderr, "MISMATCH: lost %u, expected %u\n", (unsigned int)xReceiver.xStatistics.uiLost, (unsigned int)uiExpectedLoss);
+			iResult = 2;
+		}
+
+		free(puiInjectedLoss);
+	}
+
+	vTraceUDPReceiverDeinitialize(&xReceiver);
+	(void)close(iSocket);
+
+	if (pxOutput != stdout)
+	{
+		(void)fclose(pxOutput);
+	}
+
+	return iResult;
+}
@@ -0,0 +1,163 @@
+/*
+* Percepio Trace Recorder for Tracealyzer v4.10.3
+* Copyright 2023 Percepio AB
+* www.percepio.com
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+/**
+ * @file
+ *
+ * @brief Public trace adaptive TzCtrl control APIs.
+ */
+
+#ifndef TRC_ADAPTIVE_CTRL_H
+#define TRC_ADAPTIVE_CTRL_H
+
+#if (TRC_USE_TRACEALYZER_RECORDER == 1)
+
+#include <trcTypes.h>
+
+#ifndef TRC_CFG_CTRL_ADAPTIVE
+#define TRC_CFG_CTRL_ADAPTIVE 0
+#endif
+
+#ifndef TRC_CFG_CTRL_TASK_DELAY_MIN
+#define TRC_CFG_CTRL_TASK_DELAY_MIN 1
+#endif
+
+#ifndef TRC_CFG_CTRL_TASK_DELAY_MAX
+#define TRC_CFG_CTRL_TASK_DELAY_MAX (TRC_CFG_CTRL_TASK_DELAY)
+#endif
+
+#ifndef TRC_CFG_CTRL_TARGET_OCCUPANCY
+#define TRC_CFG_CTRL_TARGET_OCCUPANCY 50
+#endif
+
+#ifndef TRC_CFG_CTRL_CHUNK_BUDGET_MAX
+#define TRC_CFG_CTRL_CHUNK_BUDGET_MAX 20
+#endif
+
+#if (TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING) && ((TRC_USE_INTERNAL_BUFFER) == 1) && ((TRC_CFG_CTRL_ADAPTIVE) == 1)
+
+#if ((TRC_CFG_CTRL_TASK_DELAY_MIN) < 1) || ((TRC_CFG_CTRL_TASK_DELAY_MAX) < (TRC_CFG_CTRL_TASK_DELAY_MIN))
+#error "TRC_CFG_CTRL_TASK_DELAY_MIN must be at least 1 and not larger than TRC_CFG_CTRL_TASK_DELAY_MAX"
+#endif
+
+#if ((TRC_CFG_CTRL_TARGET_OCCUPANCY) < 1) || ((TRC_CFG_CTRL_TARGET_OCCUPANCY) > 100)
+#error "TRC_CFG_CTRL_TARGET_OCCUPANCY must be 1 to 100"
+#endif
+
+#if ((TRC_CFG_CTRL_CHUNK_BUDGET_MAX) < 1)
+#error "TRC_CFG_CTRL_CHUNK_BUDGET_MAX must be at least 1"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup trace_adaptive_ctrl_apis Trace Adaptive Control APIs
+ * @ingroup trace_recorder_apis
+ * @{
+ */
+
+/* The fill rate is kept in 1/16 bytes per delay unit */
+#define TRC_ADAPTIVE_CTRL_RATE_SHIFT 4UL
+
+/**
+ * @internal Trace Adaptive Control Data Structure
+ */
+typedef struct TraceAdaptiveCtrlData	/* Aligned */
+{
+	uint32_t uiDelay;				/**< The delay before the next xTraceTzCtrl(), in TRC_CFG_CTRL_TASK_DELAY units */
+	uint32_t uiChunkBudget;			/**< Chunks per transfer in Chunk mode */
+	uint32_t uiFillRate;			/**< Bytes stored per delay unit, in 1/16 bytes */
+	uint32_t uiUsedBefore;			/**< Bytes in the internal buffer before the transfer */
+	uint32_t uiUsedAfter;			/**< Bytes left in the internal buffer by the previous transfer */
+	uint32_t uiReserved;			/**< Alignment */
+} TraceAdaptiveCtrlData_t;
+
+/**
+ * @internal Initializes the adaptive control.
+ *
+ * @param[in] pxBuffer Pointer to memory that will be used by the adaptive control.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceAdaptiveCtrlInitialize(TraceAdaptiveCtrlData_t* pxBuffer);
+
+/**
+ * @internal Called by xTraceTzCtrl() before the transfer. Measures what was
+ * stored in the internal buffer during the last delay, updates the fill rate
+ * and sets the chunk budget for the transfer.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceAdaptiveCtrlMeasure(void);
+
+/**
+ * @internal Called by xTraceTzCtrl() after the transfer. Sets the delay to the
+ * time the internal buffer is expected to take to fill to
+ * TRC_CFG_CTRL_TARGET_OCCUPANCY at the measured fill rate, within
+ * TRC_CFG_CTRL_TASK_DELAY_MIN and TRC_CFG_CTRL_TASK_DELAY_MAX.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceAdaptiveCtrlSchedule(void);
+
+/**
+ * @brief Gets the delay before the next xTraceTzCtrl() call. Used by the
+ * TzCtrl task of the kernel port. TRC_CFG_CTRL_TASK_DELAY while the recorder
+ * isn't enabled.
+ *
+ * @param[out] puxDelay Delay, in the unit of TRC_CFG_CTRL_TASK_DELAY
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceAdaptiveCtrlGetDelay(TraceUnsignedBaseType_t* puxDelay);
+
+/**
+ * @brief Gets the number of chunks to transfer per xTraceTzCtrl() call in
+ * Chunk mode, 1 to TRC_CFG_CTRL_CHUNK_BUDGET_MAX.
+ *
+ * @param[out] puiChunkBudget Chunk budget
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceAdaptiveCtrlGetChunkBudget(uint32_t* puiChunkBudget);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#else
+
+typedef struct TraceAdaptiveCtrlData
+{
+	TraceUnsignedBaseType_t buffer[1];
+} TraceAdaptiveCtrlData_t;
+
+#define xTraceAdaptiveCtrlInitialize(__pxBuffer) ((void)(__pxBuffer), TRC_SUCCESS)
+
+#define xTraceAdaptiveCtrlMeasure() TRC_COMMA_EXPR_TO_STATEMENT_EXPR_1(TRC_SUCCESS)
+
+#define xTraceAdaptiveCtrlSchedule() TRC_COMMA_EXPR_TO_STATEMENT_EXPR_1(TRC_SUCCESS)
+
+#define xTraceAdaptiveCtrlGetDelay(__puxDelay) TRC_COMMA_EXPR_TO_STATEMENT_EXPR_2(*(__puxDelay) = (TraceUnsignedBaseType_t)(TRC_CFG_CTRL_TASK_DELAY), TRC_SUCCESS)
+
+#define xTraceAdaptiveCtrlGetChunkBudget(__puiChunkBudget) TRC_COMMA_EXPR_TO_STATEMENT_EXPR_2(*(__puiChunkBudget) = (uint32_t)(TRC_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT), TRC_SUCCESS)
+
+#endif
+
+#endif
+
+#endif
@@ -34,9 +34,12 @@
 
 /* Command codes for TzCtrl task */
 #define CMD_SET_ACTIVE      1 /* Start (param1 = 1) or Stop (param1 = 0) */
+#define CMD_TRIGGER_RULE       2 /* Upload a trigger rule, see xTraceTriggerProcessCommand() */
+#define CMD_TRIGGER_RULE_VALUE 3 /* Upload a trigger rule value */
+#define CMD_TRIGGER_RULES_SET  4 /* Use the uploaded trigger rules */
 
 /* The final command code, used to validate commands. */
-#define CMD_LAST_COMMAND 1
+#define CMD_LAST_COMMAND 4
 
 #define TRC_RECORDER_MODE_SNAPSHOT		0
 #define TRC_RECORDER_MODE_STREAMING		1
@@ -73,6 +76,14 @@
 #define TRC_WARNING_STREAM_PORT_INITIAL_BLOCKING	0x0DUL
 #define TRC_WARNING_STACKMON_NO_SLOTS				0x0EUL
 
+/******************************************************************************/
+/*** FLIGHT RECORDER TRIGGERS (for TRC_CFG_FLIGHT_RECORDER_TRIGGERS) **********/
+/******************************************************************************/
+
+#define TRC_FLIGHT_RECORDER_TRIGGER_ERROR			0x01UL
+#define TRC_FLIGHT_RECORDER_TRIGGER_ASSERT			0x02UL
+#define TRC_FLIGHT_RECORDER_TRIGGER_COUNTER_LIMIT	0x04UL
+
 /* Entry Option definitions */
 #define TRC_ENTRY_OPTION_EXCLUDED				0x00000001UL
 #define TRC_ENTRY_OPTION_HEAP					0x80000000UL
@@ -111,6 +122,11 @@
 #define TRC_RECORDER_COMPONENT_TASK						0x00100000UL
 #define TRC_RECORDER_COMPONENT_TIMESTAMP				0x00200000UL
 #define TRC_RECORDER_COMPONENT_COUNTER					0x00400000UL
+#define TRC_RECORDER_COMPONENT_WRITE_COMBINE			0x00800000UL
+#define TRC_RECORDER_COMPONENT_ADAPTIVE_CTRL			0x01000000UL
+#define TRC_RECORDER_COMPONENT_FLIGHT_RECORDER			0x02000000UL
+#define TRC_RECORDER_COMPONENT_TRIGGER					0x04000000UL
+#define TRC_RECORDER_COMPONENT_PROFILING				0x08000000UL
 
 /* Filter Groups */
 #define FilterGroup0 (uint16_t)0x0001
@@ -199,5 +215,6 @@
 #define TRC_HARDWARE_PORT_ARM_Cortex_M_NRF_SD                   26      /*      Yes                     FreeRTOS                                */
 #define TRC_HARDWARE_PORT_ARMv8AR_A32				27	/*	Yes			Any					*/
 #define TRC_HARDWARE_PORT_ADSP_SC5XX_SHARC			28	/*	No			FreeRTOS                                */
+#define TRC_HARDWARE_PORT_POSIX					29	/*	Yes			Any (Linux/POSIX host)			*/
 
 #endif /* TRC_PORTDEFINES_H */
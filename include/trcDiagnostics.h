@@ -19,11 +19,23 @@
 
 #include <trcTypes.h>
 
+#ifndef TRC_CFG_DIAGNOSTICS_EXTENDED
+#define TRC_CFG_DIAGNOSTICS_EXTENDED 0
+#endif
+
+#ifndef TRC_CFG_DIAGNOSTICS_REPORT_INTERVAL
+#define TRC_CFG_DIAGNOSTICS_REPORT_INTERVAL 100
+#endif
+
+#if ((TRC_CFG_DIAGNOSTICS_EXTENDED) == 1) && ((TRC_CFG_DIAGNOSTICS_REPORT_INTERVAL) < 1)
+#error "TRC_CFG_DIAGNOSTICS_REPORT_INTERVAL must be at least 1"
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-#define TRC_DIAGNOSTICS_COUNT 5UL
+#define TRC_DIAGNOSTICS_COUNT 19UL
 
 typedef enum TraceDiagnosticsType
 {
@@ -32,11 +44,37 @@ typedef enum TraceDiagnosticsType
 	TRC_DIAGNOSTICS_BLOB_MAX_BYTES_TRUNCATED = 0x02UL,
 	TRC_DIAGNOSTICS_STACK_MONITOR_NO_SLOTS = 0x03UL,
 	TRC_DIAGNOSTICS_ASSERTS_TRIGGERED = 0x04UL,
+	TRC_DIAGNOSTICS_CTRL_TASK_DELAY = 0x05UL,			/* Adaptive TzCtrl: the latest delay chosen */
+	TRC_DIAGNOSTICS_CTRL_CHUNK_BUDGET = 0x06UL,			/* Adaptive TzCtrl: the latest chunk budget chosen */
+	TRC_DIAGNOSTICS_CTRL_FILL_RATE = 0x07UL,			/* Adaptive TzCtrl: bytes stored per delay unit */
+	TRC_DIAGNOSTICS_CTRL_OCCUPANCY_HIGHEST = 0x08UL,	/* Adaptive TzCtrl: highest internal buffer occupancy seen, in percent */
+	TRC_DIAGNOSTICS_LANE_SCHEDULING_DROPPED = 0x09UL,	/* Event lanes: scheduling events not stored */
+	TRC_DIAGNOSTICS_LANE_OBJECT_DROPPED = 0x0AUL,		/* Event lanes: object and other kernel events not stored */
+	TRC_DIAGNOSTICS_LANE_USER_DROPPED = 0x0BUL,			/* Event lanes: user and diagnostic events not stored */
+	TRC_DIAGNOSTICS_FLIGHT_RECORDER_CAPTURES = 0x0CUL,	/* Flight recorder: captures triggered */
+	TRC_DIAGNOSTICS_FLIGHT_RECORDER_TRIGGERS_IGNORED = 0x0DUL,	/* Flight recorder: triggers while not armed */
+	TRC_DIAGNOSTICS_TRANSFER_CALLS = 0x0EUL,			/* Extended: transfers made by xTraceTzCtrl() */
+	TRC_DIAGNOSTICS_STREAM_PORT_WRITE_FAILURES = 0x0FUL,	/* Extended: transfer writes that returned TRC_FAIL */
+	TRC_DIAGNOSTICS_STREAM_PORT_SHORT_WRITES = 0x10UL,	/* Extended: transfer writes that wrote less than asked */
+	TRC_DIAGNOSTICS_CRITICAL_SECTION_LONGEST = 0x11UL,	/* Extended: longest critical section of an event, in TRC_HWTC_COUNT ticks */
+	TRC_DIAGNOSTICS_WRITE_COMBINE_DROPPED = 0x12UL,		/* Write combining: large events dropped while another core's event was only partly written */
 } TraceDiagnosticsType_t;
 
+#define TRC_DIAGNOSTICS_CORE_COUNT 3UL
+
+typedef enum TraceDiagnosticsCoreType
+{
+	TRC_DIAGNOSTICS_CORE_BUFFER_USED_HIGHEST = 0x00UL,	/* Extended: most bytes in the core's internal buffer */
+	TRC_DIAGNOSTICS_CORE_BYTES_COMMITTED = 0x01UL,		/* Extended: event bytes committed on the core */
+	TRC_DIAGNOSTICS_CORE_BYTES_TRANSFERRED = 0x02UL,	/* Extended: bytes transferred from the core's internal buffer */
+} TraceDiagnosticsCoreType_t;
+
 typedef struct TraceDiagnostics /* Aligned */
 {
 	TraceBaseType_t metrics[TRC_DIAGNOSTICS_COUNT];
+	TraceBaseType_t coreMetrics[TRC_CFG_CORE_COUNT][TRC_DIAGNOSTICS_CORE_COUNT];
+	TraceUnsignedBaseType_t uxReportCountdown;	/* xTraceDiagnosticsCheckStatus() calls until the next report */
+	TraceStringHandle_t xReportChannel;			/* "#Diagnostics", registered at the first report */
 } TraceDiagnosticsData_t;
 
 /**
@@ -125,13 +163,138 @@ traceResult xTraceDiagnosticsSetIfHigher(TraceDiagnosticsType_t xType, TraceBase
 traceResult xTraceDiagnosticsSetIfLower(TraceDiagnosticsType_t xType, TraceBaseType_t xValue);
 
 /**
- * @brief Check the diagnostics status
+ * @brief Retrieve per-core diagnostics value
+ *
+ * @param[in] uiCoreId Core
+ * @param[in] xType Per-core diagnostics type
+ * @param[out] pxValue Pointer to value
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceDiagnosticsCoreGet(uint32_t uiCoreId, TraceDiagnosticsCoreType_t xType, TraceBaseType_t* pxValue);
+
+/**
+ * @brief Add to per-core diagnostics value
+ *
+ * @param[in] uiCoreId Core
+ * @param[in] xType Per-core diagnostics type
+ * @param[in] xValue Value
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceDiagnosticsCoreAdd(uint32_t uiCoreId, TraceDiagnosticsCoreType_t xType, TraceBaseType_t xValue);
+
+/**
+ * @brief Set a new per-core diagnostics value if higher than previous value
+ *
+ * @param[in] uiCoreId Core
+ * @param[in] xType Per-core diagnostics type
+ * @param[in] xValue Value
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceDiagnosticsCoreSetIfHigher(uint32_t uiCoreId, TraceDiagnosticsCoreType_t xType, TraceBaseType_t xValue);
+
+/**
+ * @brief Check the diagnostics status. With TRC_CFG_DIAGNOSTICS_EXTENDED,
+ * also stores the extended diagnostics every
+ * TRC_CFG_DIAGNOSTICS_REPORT_INTERVAL calls, as user events on the
+ * "#Diagnostics" channel: one with the transfers, write failures, short
+ * writes and longest critical section, and one per core with the most bytes
+ * in its internal buffer, the buffer size and the bytes committed and
+ * transferred.
  *
  * @retval TRC_FAIL Failure
  * @retval TRC_SUCCESS Success
  */
 traceResult xTraceDiagnosticsCheckStatus(void);
 
+#if ((TRC_CFG_DIAGNOSTICS_EXTENDED) == 1)
+
+/**
+ * @internal Called by xTraceTzCtrl() before each transfer. Counts it and
+ * samples the internal buffer of each core. Only a transfer empties the
+ * buffer, so its highest use is reached just before one.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceDiagnosticsOnTransfer(void);
+
+/**
+ * @internal Called after each write of a transfer.
+ *
+ * @param[in] xResult What xTraceStreamPortWriteData() returned
+ * @param[in] uiSize Bytes to write
+ * @param[in] piBytesWritten Bytes written
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceDiagnosticsOnWrite(traceResult xResult, uint32_t uiSize, const int32_t* piBytesWritten);
+
+/**
+ * @internal Called by the event functions before they leave the critical
+ * section.
+ *
+ * @param[in] uiStart TRC_HWTC_COUNT when the critical section was entered
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceDiagnosticsOnCriticalSectionExit(uint32_t uiStart);
+
+/**
+ * @internal Declares a tick count for the extended diagnostics macros.
+ */
+#define TRC_DIAGNOSTICS_ALLOC(__name) uint32_t __name = 0u;
+
+/**
+ * @internal Reads TRC_HWTC_COUNT into a tick count declared by TRC_DIAGNOSTICS_ALLOC().
+ */
+#define TRC_DIAGNOSTICS_TIMESTAMP(__name) __name = (uint32_t)(TRC_HWTC_COUNT);
+
+/**
+ * @internal Updates the longest critical section, entered at __start.
+ */
+#define TRC_DIAGNOSTICS_CRITICAL_SECTION_EXIT(__start) (void)xTraceDiagnosticsOnCriticalSectionExit(__start);
+
+/**
+ * @internal Adds committed event bytes on the current core.
+ */
+#define TRC_DIAGNOSTICS_COMMITTED(__iBytes) (void)xTraceDiagnosticsCoreAdd(TRC_CFG_GET_CURRENT_CORE(), TRC_DIAGNOSTICS_CORE_BYTES_COMMITTED, (TraceBaseType_t)(__iBytes));
+
+/**
+ * @internal Adds bytes transferred from a core's internal buffer.
+ */
+#define TRC_DIAGNOSTICS_TRANSFERRED(__uiCoreId, __iBytes) (void)xTraceDiagnosticsCoreAdd(__uiCoreId, TRC_DIAGNOSTICS_CORE_BYTES_TRANSFERRED, (TraceBaseType_t)(__iBytes));
+
+/**
+ * @internal Evaluates a transfer write, and counts it if it failed or was short.
+ */
+#define TRC_DIAGNOSTICS_WRITE(__xResult, __uiSize, __piBytesWritten) (void)xTraceDiagnosticsOnWrite(__xResult, __uiSize, __piBytesWritten);
+
+#else
+
+#define xTraceDiagnosticsOnTransfer() TRC_COMMA_EXPR_TO_STATEMENT_EXPR_1(TRC_SUCCESS)
+
+#define TRC_DIAGNOSTICS_ALLOC(__name)
+
+#define TRC_DIAGNOSTICS_TIMESTAMP(__name)
+
+#define TRC_DIAGNOSTICS_CRITICAL_SECTION_EXIT(__start)
+
+#define TRC_DIAGNOSTICS_COMMITTED(__iBytes)
+
+#define TRC_DIAGNOSTICS_TRANSFERRED(__uiCoreId, __iBytes)
+
+#define TRC_DIAGNOSTICS_WRITE(__xResult, __uiSize, __piBytesWritten) (void)(__xResult);
+
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -165,6 +165,34 @@ traceResult xTraceEventBufferTransferChunk(TraceEventBuffer_t* pxTraceEventBuffe
  */
 traceResult xTraceEventBufferClear(TraceEventBuffer_t* pxTraceEventBuffer);
 
+/**
+ * @brief Gets the number of bytes in the event buffer that have not been
+ * transferred yet.
+ *
+ * @param[in] pxTraceEventBuffer Pointer to initialized trace event buffer.
+ * @param[out] puiUsed Bytes in the buffer.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceEventBufferGetUsed(const TraceEventBuffer_t* pxTraceEventBuffer, uint32_t* puiUsed);
+
+/**
+ * @brief Changes the behavior of the event buffer when it is full, keeping
+ * the events in it. Must not be called while data is allocated, pushed or
+ * transferred.
+ *
+ * The tail must be at the start of an event when switching to
+ * TRC_EVENT_BUFFER_OPTION_OVERWRITE, since old events are then freed from it.
+ *
+ * @param[in] pxTraceEventBuffer Pointer to initialized trace event buffer.
+ * @param[in] uiOptions TRC_EVENT_BUFFER_OPTION_SKIP or TRC_EVENT_BUFFER_OPTION_OVERWRITE.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceEventBufferSetOptions(TraceEventBuffer_t* pxTraceEventBuffer, uint32_t uiOptions);
+
 /** @} */
 
 #ifdef __cplusplus
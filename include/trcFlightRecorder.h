@@ -0,0 +1,213 @@
+/*
+* Percepio Trace Recorder for Tracealyzer v4.10.3
+* Copyright 2023 Percepio AB
+* www.percepio.com
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+/**
+ * @file
+ *
+ * @brief Public trace flight recorder APIs.
+ */
+
+#ifndef TRC_FLIGHT_RECORDER_H
+#define TRC_FLIGHT_RECORDER_H
+
+#if (TRC_USE_TRACEALYZER_RECORDER == 1)
+
+#include <trcTypes.h>
+
+#ifndef TRC_CFG_FLIGHT_RECORDER
+#define TRC_CFG_FLIGHT_RECORDER 0
+#endif
+
+#ifndef TRC_CFG_FLIGHT_RECORDER_POST_TRIGGER
+#define TRC_CFG_FLIGHT_RECORDER_POST_TRIGGER 25
+#endif
+
+#ifndef TRC_CFG_FLIGHT_RECORDER_STOP_ATTEMPTS
+#define TRC_CFG_FLIGHT_RECORDER_STOP_ATTEMPTS 100
+#endif
+
+#ifndef TRC_CFG_FLIGHT_RECORDER_TRIGGERS
+#define TRC_CFG_FLIGHT_RECORDER_TRIGGERS (TRC_FLIGHT_RECORDER_TRIGGER_ERROR | TRC_FLIGHT_RECORDER_TRIGGER_ASSERT | TRC_FLIGHT_RECORDER_TRIGGER_COUNTER_LIMIT)
+#endif
+
+#if (TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING) && ((TRC_USE_INTERNAL_BUFFER) == 1) && ((TRC_CFG_FLIGHT_RECORDER) == 1)
+
+#if ((TRC_CFG_FLIGHT_RECORDER_POST_TRIGGER) < 0) || ((TRC_CFG_FLIGHT_RECORDER_POST_TRIGGER) > 90)
+#error "TRC_CFG_FLIGHT_RECORDER_POST_TRIGGER must be 0 to 90"
+#endif
+
+#if defined(TRC_CFG_CTRL_ADAPTIVE) && ((TRC_CFG_CTRL_ADAPTIVE) == 1)
+#error "TRC_CFG_FLIGHT_RECORDER can't be combined with TRC_CFG_CTRL_ADAPTIVE"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup trace_flight_recorder_apis Trace Flight Recorder APIs
+ * @ingroup trace_recorder_apis
+ * @{
+ */
+
+#define TRC_FLIGHT_RECORDER_STATE_ARMED 0UL		/**< Overwriting, waiting for a trigger */
+#define TRC_FLIGHT_RECORDER_STATE_TRIGGERED 1UL	/**< Overwriting, storing the post-trigger events */
+#define TRC_FLIGHT_RECORDER_STATE_DRAINING 2UL	/**< Skipping, transferring the capture */
+
+/**
+ * @internal Trace Flight Recorder Data Structure
+ */
+typedef struct TraceFlightRecorderData
+{
+	uint32_t uiState;						/**< TRC_FLIGHT_RECORDER_STATE_ARMED, _TRIGGERED or _DRAINING */
+	uint32_t uiPostSize;					/**< Bytes to store after a trigger before the capture is frozen */
+	uint32_t uiPostRemaining;				/**< Bytes still to store after the trigger */
+	uint32_t uiStopPending;					/**< Disable the recorder once the capture is transferred */
+	uint32_t uiStalledTransfers;			/**< Transfers in a row that wrote nothing of the capture */
+	uint32_t uiFrozen[TRC_CFG_CORE_COUNT];	/**< Bytes of the capture still to transfer, per core */
+} TraceFlightRecorderData_t;
+
+/**
+ * @internal Initializes the flight recorder.
+ *
+ * @param[in] pxBuffer Pointer to memory that will be used by the flight recorder.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceFlightRecorderInitialize(TraceFlightRecorderData_t* pxBuffer);
+
+/**
+ * @brief Triggers a capture. The internal buffer keeps what was stored
+ * before the trigger, and TRC_CFG_FLIGHT_RECORDER_POST_TRIGGER percent of it
+ * is filled with what is stored after it. Then the capture is frozen and
+ * transferred by xTraceTzCtrl(), after which the flight recorder is armed
+ * again. May be called from ISRs.
+ *
+ * @retval TRC_FAIL Not armed, a capture is already in progress
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceFlightRecorderTrigger(void);
+
+/**
+ * @brief Gets the state of the flight recorder.
+ *
+ * @param[out] puiState TRC_FLIGHT_RECORDER_STATE_ARMED, _TRIGGERED or _DRAINING
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceFlightRecorderGetState(uint32_t* puiState);
+
+/**
+ * @internal Triggers a capture if uiTrigger is in TRC_CFG_FLIGHT_RECORDER_TRIGGERS.
+ *
+ * @param[in] uiTrigger TRC_FLIGHT_RECORDER_TRIGGER_COUNTER_LIMIT
+ *
+ * @retval TRC_FAIL Not triggered
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceFlightRecorderOnTrigger(uint32_t uiTrigger);
+
+/**
+ * @internal Called by xTraceError(). If errors, or asserts for
+ * TRC_ERROR_ASSERT, are in TRC_CFG_FLIGHT_RECORDER_TRIGGERS, the capture is
+ * frozen at once and the recorder is disabled by xTraceTzCtrl() after it has
+ * been transferred.
+ *
+ * @param[in] uiErrorCode Error code
+ *
+ * @retval TRC_FAIL Not handled, the caller disables the recorder
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceFlightRecorderOnError(uint32_t uiErrorCode);
+
+/**
+ * @internal Called by the internal buffer, with the recorder's critical
+ * section held, once an event has been committed or pushed. Events that are
+ * skipped or dropped are not counted. Counts the post-trigger bytes and
+ * freezes the capture when they are stored.
+ *
+ * @param[in] uiSize Bytes stored
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceFlightRecorderOnStore(uint32_t uiSize);
+
+/**
+ * @internal Called by prvSetRecorderEnabled() after the trace header has been
+ * stored. Freezes the header, so that it is transferred before the flight
+ * recorder is armed.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceFlightRecorderOnTraceBegin(void);
+
+/**
+ * @internal Called by prvSetRecorderDisabled() before the trace ends. Freezes
+ * the internal buffer as a capture, unless one is already being transferred,
+ * and transfers it, so that the events before a trigger aren't lost when the
+ * recorder is disabled. Gives up after TRC_CFG_FLIGHT_RECORDER_STOP_ATTEMPTS
+ * attempts in a row that write nothing.
+ *
+ * @retval TRC_FAIL The capture could not be transferred
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceFlightRecorderOnTraceEnd(void);
+
+/**
+ * @internal Called by xTraceTzCtrl() in place of
+ * xTraceInternalEventBufferTransfer(). Transfers the frozen capture, if any,
+ * and arms the flight recorder when it is done. After xTraceError(), the
+ * recorder is disabled once the capture is transferred, or once
+ * TRC_CFG_FLIGHT_RECORDER_STOP_ATTEMPTS calls in a row have written nothing.
+ *
+ * @retval TRC_FAIL Flight recorder not used, transfer the internal buffer
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceFlightRecorderTransfer(void);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#else
+
+typedef struct TraceFlightRecorderData
+{
+	TraceUnsignedBaseType_t buffer[1];
+} TraceFlightRecorderData_t;
+
+#define xTraceFlightRecorderInitialize(__pxBuffer) ((void)(__pxBuffer), TRC_SUCCESS)
+
+#define xTraceFlightRecorderTrigger() TRC_COMMA_EXPR_TO_STATEMENT_EXPR_1(TRC_FAIL)
+
+#define xTraceFlightRecorderGetState(__puiState) ((void)(__puiState), TRC_FAIL)
+
+#define xTraceFlightRecorderOnTrigger(__uiTrigger) ((void)(__uiTrigger), TRC_FAIL)
+
+#define xTraceFlightRecorderOnError(__uiErrorCode) ((void)(__uiErrorCode), TRC_FAIL)
+
+#define xTraceFlightRecorderOnStore(__uiSize) ((void)(__uiSize), TRC_SUCCESS)
+
+#define xTraceFlightRecorderOnTraceBegin() TRC_COMMA_EXPR_TO_STATEMENT_EXPR_1(TRC_SUCCESS)
+
+#define xTraceFlightRecorderOnTraceEnd() TRC_COMMA_EXPR_TO_STATEMENT_EXPR_1(TRC_SUCCESS)
+
+/* Not handled, the caller transfers the internal buffer as usual */
+#define xTraceFlightRecorderTransfer() TRC_COMMA_EXPR_TO_STATEMENT_EXPR_1(TRC_FAIL)
+
+#endif
+
+#endif
+
+#endif
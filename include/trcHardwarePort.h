@@ -711,6 +711,49 @@ uint32_t uiTraceTimerGetValue(void);
 	/* Set the meaning of IRQ priorities in ISR tracing - see above */
 	#define TRC_IRQ_PRIORITY_ORDER 1
 
+#elif (TRC_CFG_HARDWARE_PORT == TRC_HARDWARE_PORT_POSIX)
+	/* For building and testing the recorder on a Linux/POSIX host, see kernelports/POSIX.
+	 * The timestamp source is selected by TRC_CFG_POSIX_USE_CYCLE_COUNTER:
+	 * 0 (default): clock_gettime(CLOCK_MONOTONIC_RAW) in nanoseconds.
+	 * 1: the CPU cycle counter (rdtsc on x86-64, cntvct_el0 on AArch64), which is
+	 *    cheaper to read but must be constant rate. Falls back to 0 on other CPUs. */
+	void vTraceTimerReset(void);
+	uint32_t uiTraceTimerGetFrequency(void);
+	uint32_t uiTraceTimerGetValue(void);
+
+	#if (defined(__LP64__) || defined(_LP64))
+		#define TRC_BASE_TYPE int64_t
+		#define TRC_UNSIGNED_BASE_TYPE uint64_t
+	#endif
+
+	#define TRC_HWTC_TYPE TRC_FREE_RUNNING_32BIT_INCR
+	#define TRC_HWTC_COUNT ((TraceUnsignedBaseType_t)uiTraceTimerGetValue())
+	#define TRC_HWTC_PERIOD 0
+	#define TRC_HWTC_DIVISOR 1
+	#define TRC_HWTC_FREQ_HZ ((TraceUnsignedBaseType_t)uiTraceTimerGetFrequency())
+
+	#define TRC_IRQ_PRIORITY_ORDER 1
+
+	#define TRC_PORT_SPECIFIC_INIT() vTraceTimerReset()
+
+	/* A recursive pthread mutex shared by all threads. The returned value is only
+	 * used to check the nesting. */
+	uint32_t uiTracePosixEnterCritical(void);
+	void vTracePosixExitCritical(uint32_t uiNesting);
+
+	#define TRACE_ALLOC_CRITICAL_SECTION() TraceUnsignedBaseType_t TRACE_ALLOC_CRITICAL_SECTION_NAME;
+	#define TRACE_ENTER_CRITICAL_SECTION() {TRACE_ALLOC_CRITICAL_SECTION_NAME = (TraceUnsignedBaseType_t)uiTracePosixEnterCritical();}
+	#define TRACE_EXIT_CRITICAL_SECTION() {vTracePosixExitCritical((uint32_t)TRACE_ALLOC_CRITICAL_SECTION_NAME);}
+
+	#if (defined(TRC_CFG_CORE_COUNT) && (TRC_CFG_CORE_COUNT > 1) && !defined(TRC_CFG_GET_CURRENT_CORE))
+		/* sched_getcpu() modulo TRC_CFG_CORE_COUNT, sampled when the calling thread
+		 * enters the outermost critical section so that it can't change while the
+		 * recorder is using the per-core data even if the thread migrates. */
+		uint32_t uiTracePosixGetCurrentCore(void);
+
+		#define TRC_CFG_GET_CURRENT_CORE() uiTracePosixGetCurrentCore()
+	#endif
+
 #elif (TRC_CFG_HARDWARE_PORT == TRC_HARDWARE_PORT_APPLICATION_DEFINED)
 
 	#if !( defined (TRC_HWTC_TYPE) && defined (TRC_HWTC_COUNT) && defined (TRC_HWTC_PERIOD) && defined (TRC_HWTC_FREQ_HZ) && defined (TRC_IRQ_PRIORITY_ORDER) )
@@ -49,10 +49,28 @@
 #define TRC_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT (5UL)
 #endif
 
+#ifndef TRC_CFG_EVENT_LANES
+#define TRC_CFG_EVENT_LANES 0
+#endif
+
+#ifndef TRC_CFG_EVENT_LANE_RESERVE_SCHEDULING
+#define TRC_CFG_EVENT_LANE_RESERVE_SCHEDULING 10
+#endif
+
+#ifndef TRC_CFG_EVENT_LANE_RESERVE_OBJECT
+#define TRC_CFG_EVENT_LANE_RESERVE_OBJECT 10
+#endif
+
 #if (TRC_USE_INTERNAL_BUFFER == 1)
 
 #include <trcTypes.h>
 
+#if ((TRC_CFG_EVENT_LANES) == 1)
+#if ((TRC_CFG_EVENT_LANE_RESERVE_SCHEDULING) < 0) || ((TRC_CFG_EVENT_LANE_RESERVE_OBJECT) < 0) || (((TRC_CFG_EVENT_LANE_RESERVE_SCHEDULING) + (TRC_CFG_EVENT_LANE_RESERVE_OBJECT)) > 90)
+#error "TRC_CFG_EVENT_LANE_RESERVE_SCHEDULING and TRC_CFG_EVENT_LANE_RESERVE_OBJECT must not reserve more than 90% of the internal buffer"
+#endif
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -63,6 +81,30 @@ extern "C" {
  * @{
  */
 
+/**
+ * @def TRC_EVENT_LANE_SCHEDULING
+ * @brief Lane of the events Tracealyzer needs to show the timeline: task
+ * switches, ready tasks, ISRs and the trace start. May use all of the buffer.
+ */
+#define TRC_EVENT_LANE_SCHEDULING	(0UL)
+
+/**
+ * @def TRC_EVENT_LANE_OBJECT
+ * @brief Lane of object creation, deletion and names, and of the other kernel
+ * and recorder events. Shed when only TRC_CFG_EVENT_LANE_RESERVE_SCHEDULING
+ * remains.
+ */
+#define TRC_EVENT_LANE_OBJECT		(1UL)
+
+/**
+ * @def TRC_EVENT_LANE_USER
+ * @brief Lane of user events, counter changes, intervals and state changes.
+ * Shed first, when only the reserves of the other lanes remain.
+ */
+#define TRC_EVENT_LANE_USER			(2UL)
+
+#define TRC_EVENT_LANE_COUNT		(3UL)
+
 /**
  * @internal Initializes the internal trace event buffer used by certain stream ports.
  * 
@@ -143,6 +185,10 @@ traceResult xTraceInternalEventBufferTransferAll(void);
  * event buffer through the streamport. New data pushed to the trace event buffer
  * during the execution of this routine will not be transfered.
  *
+ * Up to TRC_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT chunks are
+ * transferred per call, or the chunk budget set by the adaptive TzCtrl
+ * control (TRC_CFG_CTRL_ADAPTIVE).
+ *
  * When transferring a chunk which wraps the buffer, a singular transfer
  * is made to avoid issuing dual writes. This configuration means that
  * during wrapping, the chunk might be reduced in size even if there is
@@ -162,6 +208,80 @@ traceResult xTraceInternalEventBufferTransferChunk(void);
  */
 traceResult xTraceInternalEventBufferClear(void);
 
+/**
+ * @brief Gets the occupancy of the internal trace event buffer. With several
+ * cores, it is that of the fullest core's buffer.
+ *
+ * @param[out] puiUsed Bytes not yet transferred
+ * @param[out] puiSize Buffer size
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceInternalEventBufferGetUsed(uint32_t* puiUsed, uint32_t* puiSize);
+
+/**
+ * @internal Gets the number of bytes not yet transferred from one core's part
+ * of the internal trace event buffer.
+ *
+ * @param[in] uiCoreId Core
+ * @param[out] puiUsed Bytes not yet transferred
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceInternalEventBufferGetCoreUsed(uint32_t uiCoreId, uint32_t* puiUsed);
+
+/**
+ * @internal Transfers up to uiChunkSize bytes from one core's part of the
+ * internal trace event buffer through the streamport. Less is transferred
+ * when the data wraps the buffer or the streamport takes less.
+ *
+ * @param[in] uiCoreId Core
+ * @param[in] uiChunkSize Maximum number of bytes to transfer
+ * @param[out] piBytesWritten Bytes transferred
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceInternalEventBufferTransferCoreChunk(uint32_t uiCoreId, uint32_t uiChunkSize, int32_t* piBytesWritten);
+
+/**
+ * @internal Sets whether the internal trace event buffer skips new events
+ * (TRC_EVENT_BUFFER_OPTION_SKIP) or overwrites old ones
+ * (TRC_EVENT_BUFFER_OPTION_OVERWRITE) when full. Used by the flight recorder,
+ * with the recorder's critical section held. xTraceInternalEventBufferClear()
+ * sets it back to TRC_EVENT_BUFFER_OPTION_SKIP.
+ *
+ * @param[in] uiOptions TRC_EVENT_BUFFER_OPTION_SKIP or TRC_EVENT_BUFFER_OPTION_OVERWRITE
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceInternalEventBufferSetOptions(uint32_t uiOptions);
+
+#if ((TRC_CFG_EVENT_LANES) == 1)
+
+/**
+ * @internal Selects the lane of the next event stored on this core, from its
+ * event code. Called with the recorder's critical section held. The lane only
+ * applies to the next allocation or push, after which it is back to
+ * TRC_EVENT_LANE_SCHEDULING, so data stored without selecting a lane is never
+ * shed.
+ *
+ * @param[in] uiEventCode Event code
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceInternalEventBufferSelectLane(uint32_t uiEventCode);
+
+#else
+
+#define xTraceInternalEventBufferSelectLane(uiEventCode) ((void)(uiEventCode), TRC_SUCCESS)
+
+#endif
+
 /** @} */
 
 #ifdef __cplusplus
@@ -177,6 +297,8 @@ traceResult xTraceInternalEventBufferClear(void);
 #define xTraceInternalEventBufferTransfer() (void)(TRC_SUCCESS)
 #define xTraceInternalEventBufferTransferChunk(piBytesWritten, uiChunkSize) ((void)(piBytesWritten), (void)(uiChunkSize), TRC_SUCCESS)
 #define xTraceInternalEventBufferClear() (void)(TRC_SUCCESS)
+#define xTraceInternalEventBufferGetUsed(puiUsed, puiSize) (*(puiUsed) = 0u, *(puiSize) = 0u, TRC_SUCCESS)
+#define xTraceInternalEventBufferSelectLane(uiEventCode) ((void)(uiEventCode), TRC_SUCCESS)
 
 #endif /* (TRC_USE_INTERNAL_BUFFER == 1)*/
 
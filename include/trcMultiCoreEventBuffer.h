@@ -188,6 +188,57 @@ traceResult xTraceMultiCoreEventBufferTransferChunk(const TraceMultiCoreEventBuf
  */
 traceResult xTraceMultiCoreEventBufferClear(const TraceMultiCoreEventBuffer_t* const pxTraceMultiCoreEventBuffer);
 
+/**
+ * @brief Gets the occupancy of the fullest core event buffer.
+ *
+ * @param[in] pxTraceMultiCoreEventBuffer Pointer to initialized multi-core trace event buffer.
+ * @param[out] puiUsed Bytes not yet transferred in the fullest core event buffer.
+ * @param[out] puiSize Size of that core event buffer.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceMultiCoreEventBufferGetUsed(const TraceMultiCoreEventBuffer_t* const pxTraceMultiCoreEventBuffer, uint32_t* puiUsed, uint32_t* puiSize);
+
+/**
+ * @brief Gets the number of bytes not yet transferred from one core's event
+ * buffer.
+ *
+ * @param[in] pxTraceMultiCoreEventBuffer Pointer to initialized multi-core trace event buffer.
+ * @param[in] uiCoreId Core
+ * @param[out] puiUsed Bytes in the core event buffer.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceMultiCoreEventBufferGetCoreUsed(const TraceMultiCoreEventBuffer_t* const pxTraceMultiCoreEventBuffer, uint32_t uiCoreId, uint32_t* puiUsed);
+
+/**
+ * @brief Transfers up to uiChunkSize bytes from one core's event buffer
+ * through the streamport. See xTraceEventBufferTransferChunk(...).
+ *
+ * @param[in] pxTraceMultiCoreEventBuffer Pointer to initialized multi-core trace event buffer.
+ * @param[in] uiCoreId Core
+ * @param[in] uiChunkSize Maximum number of bytes to transfer.
+ * @param[out] piBytesWritten Bytes transferred.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceMultiCoreEventBufferTransferCoreChunk(const TraceMultiCoreEventBuffer_t* const pxTraceMultiCoreEventBuffer, uint32_t uiCoreId, uint32_t uiChunkSize, int32_t* piBytesWritten);
+
+/**
+ * @brief Changes the behavior of all core event buffers when they are full.
+ * See xTraceEventBufferSetOptions(...).
+ *
+ * @param[in] pxTraceMultiCoreEventBuffer Pointer to initialized multi-core trace event buffer.
+ * @param[in] uiOptions TRC_EVENT_BUFFER_OPTION_SKIP or TRC_EVENT_BUFFER_OPTION_OVERWRITE.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceMultiCoreEventBufferSetOptions(const TraceMultiCoreEventBuffer_t* const pxTraceMultiCoreEventBuffer, uint32_t uiOptions);
+
 /** @} */
 
 #ifdef __cplusplus
@@ -411,6 +411,17 @@ traceResult xTracePrintF(TraceStringHandle_t xChannel, const char* szFormat, ...
  */
 traceResult xTraceVPrintF(TraceStringHandle_t xChannel, const char* szFormat, va_list* pxVariableList);
 
+/**
+ * @brief Gets the "Default" channel, that user events without a channel are
+ * stored on. It is registered the first time.
+ * 
+ * @param[out] pxChannel Channel.
+ * 
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTracePrintGetDefaultChannel(TraceStringHandle_t* pxChannel);
+
 /** @} */
 
 #ifdef __cplusplus
@@ -434,6 +445,8 @@ typedef struct TracePrintData
 
 #define xTraceVPrintF(_c, _s, _v) TRC_COMMA_EXPR_TO_STATEMENT_EXPR_4((void)(_c), (void)(_s), (void)(_v), TRC_SUCCESS)
 
+#define xTracePrintGetDefaultChannel(_p) TRC_COMMA_EXPR_TO_STATEMENT_EXPR_2((void)(_p), TRC_SUCCESS)
+
 #define xTracePrintF0(_c, _f) TRC_COMMA_EXPR_TO_STATEMENT_EXPR_3((void)(_c), (void)(_f), TRC_SUCCESS)
 #define xTracePrintF1(_c, _f, _p1) TRC_COMMA_EXPR_TO_STATEMENT_EXPR_4((void)(_c), (void)(_f), (void)(_p1), TRC_SUCCESS)
 #define xTracePrintF2(_c, _f, _p1, _p2) TRC_COMMA_EXPR_TO_STATEMENT_EXPR_5((void)(_c), (void)(_f), (void)(_p1), (void)(_p2), TRC_SUCCESS)
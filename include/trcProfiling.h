@@ -0,0 +1,193 @@
+/*
+* Percepio Trace Recorder for Tracealyzer v4.10.3
+* Copyright 2023 Percepio AB
+* www.percepio.com
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+/**
+ * @file
+ *
+ * @brief Public trace self-profiling APIs.
+ */
+
+#ifndef TRC_PROFILING_H
+#define TRC_PROFILING_H
+
+#if (TRC_USE_TRACEALYZER_RECORDER == 1)
+
+#include <trcTypes.h>
+
+#ifndef TRC_CFG_SELF_PROFILING
+#define TRC_CFG_SELF_PROFILING 0
+#endif
+
+#ifndef TRC_CFG_SELF_PROFILING_REPORT_INTERVAL
+#define TRC_CFG_SELF_PROFILING_REPORT_INTERVAL 100
+#endif
+
+/* The log2 histogram buckets. Bucket n counts calls that took 2^n to 2^(n+1)-1
+ * TRC_HWTC_COUNT ticks, bucket 0 also those that took 0 ticks and the last
+ * bucket also all longer ones. */
+#define TRC_PROFILING_BUCKETS 16UL
+
+/**
+ * @brief Trace Profiling Probes
+ */
+typedef enum TraceProfilingProbe
+{
+	TRC_PROFILING_EVENT_CREATE = 0x00UL,	/* xTraceEventCreateN() and friends, from the critical section to the commit */
+	TRC_PROFILING_ALLOCATE = 0x01UL,		/* xTraceStreamPortAllocate() in xTraceEventCreateN(), when it succeeds */
+	TRC_PROFILING_COMMIT = 0x02UL,			/* xTraceStreamPortCommit() in xTraceEventCreateN() */
+	TRC_PROFILING_TRANSFER = 0x03UL,		/* The transfer in xTraceTzCtrl(), preemption included */
+	TRC_PROFILING_ENTRY_FIND = 0x04UL,		/* xTraceEntryFind() */
+} TraceProfilingProbe_t;
+
+#define TRC_PROFILING_PROBE_COUNT 5UL
+
+/**
+ * @brief Trace Profiling Statistics Structure
+ */
+typedef struct TraceProfilingStats
+{
+	uint32_t uiCount;							/**< Calls measured */
+	uint32_t uiMin;								/**< Fewest ticks, 0xFFFFFFFF if no calls */
+	uint32_t uiMax;								/**< Most ticks */
+	uint32_t uiReserved;						/**< Alignment */
+	uint64_t ullSum;							/**< Ticks of all calls, the mean is ullSum / uiCount */
+	uint32_t auiHistogram[TRC_PROFILING_BUCKETS];	/**< Calls per log2 bucket */
+} TraceProfilingStats_t;
+
+#if (TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING) && ((TRC_CFG_SELF_PROFILING) == 1)
+
+#if ((TRC_CFG_SELF_PROFILING_REPORT_INTERVAL) < 1)
+#error "TRC_CFG_SELF_PROFILING_REPORT_INTERVAL must be at least 1"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup trace_profiling_apis Trace Profiling APIs
+ * @ingroup trace_recorder_apis
+ * @{
+ */
+
+/**
+ * @internal Trace Profiling Data Structure
+ */
+typedef struct TraceProfilingData
+{
+	TraceProfilingStats_t xStats[TRC_CFG_CORE_COUNT][TRC_PROFILING_PROBE_COUNT];	/**< Per core and probe */
+	uint32_t uiReportCountdown;				/**< xTraceTzCtrl() calls until the next report */
+	uint32_t uiReserved;					/**< Alignment */
+	TraceStringHandle_t xChannels[TRC_PROFILING_PROBE_COUNT];	/**< "#Cost <probe>", registered at the first report */
+} TraceProfilingData_t;
+
+/**
+ * @internal Declares a tick count for the profiling macros.
+ */
+#define TRC_PROFILING_ALLOC(__name) uint32_t __name = 0u;
+
+/**
+ * @internal Reads TRC_HWTC_COUNT into a tick count declared by TRC_PROFILING_ALLOC().
+ */
+#define TRC_PROFILING_TIMESTAMP(__name) __name = (uint32_t)(TRC_HWTC_COUNT);
+
+/**
+ * @internal Records the ticks from __start to __stop for a probe.
+ */
+#define TRC_PROFILING_RECORD(__probe, __start, __stop) (void)xTraceProfilingRecord(__probe, __start, __stop);
+
+/**
+ * @internal Initializes the self-profiling.
+ *
+ * @param[in] pxBuffer Pointer to memory that will be used by the self-profiling.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceProfilingInitialize(TraceProfilingData_t* pxBuffer);
+
+/**
+ * @internal Adds a measured call to the statistics of the current core. May
+ * be called from ISRs.
+ *
+ * @param[in] xProbe Probe
+ * @param[in] uiStart TRC_HWTC_COUNT at the start of the call
+ * @param[in] uiStop TRC_HWTC_COUNT at the end of the call
+ *
+ * @retval TRC_FAIL Not initialized
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceProfilingRecord(TraceProfilingProbe_t xProbe, uint32_t uiStart, uint32_t uiStop);
+
+/**
+ * @brief Retrieves the statistics of a probe, in TRC_HWTC_COUNT ticks. These
+ * are kept from xTraceInitialize() or the latest xTraceProfilingReset().
+ *
+ * @param[in] xProbe Probe
+ * @param[in] uiCoreId Core
+ * @param[out] pxStats Copy of the statistics
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceProfilingGet(TraceProfilingProbe_t xProbe, uint32_t uiCoreId, TraceProfilingStats_t* pxStats);
+
+/**
+ * @brief Clears the statistics of all probes on all cores.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceProfilingReset(void);
+
+/**
+ * @internal Called by xTraceTzCtrl(). Every
+ * TRC_CFG_SELF_PROFILING_REPORT_INTERVAL calls, stores one user event per
+ * probe and core that has been called, with the core, calls, min, mean and
+ * max, on the channels "#Cost EventCreate", "#Cost Allocate", "#Cost Commit",
+ * "#Cost Transfer" and "#Cost EntryFind".
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceProfilingReport(void);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#else
+
+typedef struct TraceProfilingData
+{
+	TraceUnsignedBaseType_t buffer[1];
+} TraceProfilingData_t;
+
+#define TRC_PROFILING_ALLOC(__name)
+
+#define TRC_PROFILING_TIMESTAMP(__name)
+
+#define TRC_PROFILING_RECORD(__probe, __start, __stop)
+
+#define xTraceProfilingInitialize(__pxBuffer) ((void)(__pxBuffer), TRC_SUCCESS)
+
+#define xTraceProfilingRecord(__xProbe, __uiStart, __uiStop) TRC_COMMA_EXPR_TO_STATEMENT_EXPR_4((void)(__xProbe), (void)(__uiStart), (void)(__uiStop), TRC_FAIL)
+
+#define xTraceProfilingGet(__xProbe, __uiCoreId, __pxStats) TRC_COMMA_EXPR_TO_STATEMENT_EXPR_4((void)(__xProbe), (void)(__uiCoreId), (void)(__pxStats), TRC_FAIL)
+
+#define xTraceProfilingReset() TRC_COMMA_EXPR_TO_STATEMENT_EXPR_1(TRC_FAIL)
+
+#define xTraceProfilingReport() TRC_COMMA_EXPR_TO_STATEMENT_EXPR_1(TRC_SUCCESS)
+
+#endif
+
+#endif
+
+#endif
@@ -74,6 +74,59 @@ typedef uint8_t traceHandle;
 
 #include <trcHardwarePort.h>
 #include <trcKernelPort.h>
+#include <trcUtility.h>
+
+/* Unless specified in trcConfig.h or the kernel port we assume this is a single core target */
+#ifndef TRC_CFG_CORE_COUNT
+#define TRC_CFG_CORE_COUNT 1
+#endif
+
+/* Unless specified in trcConfig.h or the kernel port we assume this is a single core target */
+#ifndef TRC_CFG_GET_CURRENT_CORE
+#define TRC_CFG_GET_CURRENT_CORE() 0
+#endif
+
+#ifndef TRC_CFG_SNAPSHOT_CORE_BUFFERS
+#define TRC_CFG_SNAPSHOT_CORE_BUFFERS 0
+#endif
+
+/* The number of snapshot event buffers. Without TRC_CFG_SNAPSHOT_CORE_BUFFERS
+all cores share the one in RecorderDataType, as in minor version 7 and 8. */
+#if ((TRC_CFG_SNAPSHOT_CORE_BUFFERS) == 1)
+#define TRC_SNAPSHOT_CORE_COUNT (TRC_CFG_CORE_COUNT)
+#define TRC_SNAPSHOT_GET_CURRENT_CORE() TRC_CFG_GET_CURRENT_CORE()
+#else
+#define TRC_SNAPSHOT_CORE_COUNT 1
+#define TRC_SNAPSHOT_GET_CURRENT_CORE() 0
+#endif
+
+/* Critical section around code that only touches the event buffer of the
+current core, used with TRC_CFG_SNAPSHOT_CORE_BUFFERS. No other core writes to
+that buffer, so a multicore port may define this as masking interrupts on the
+local core, using the variable from TRACE_ALLOC_CRITICAL_SECTION. It must then
+also define TRACE_ENTER_SHARED_SECTION and TRACE_EXIT_SHARED_SECTION as a lock
+shared by all cores that can be taken within it, and again within itself, such
+as a recursive spinlock. That lock protects the recorder data that all cores
+write. Defaults to the global critical section, which already does. */
+#ifndef TRACE_ENTER_CORE_CRITICAL_SECTION
+#define TRACE_ENTER_CORE_CRITICAL_SECTION() TRACE_ENTER_CRITICAL_SECTION()
+#define TRACE_EXIT_CORE_CRITICAL_SECTION() TRACE_EXIT_CRITICAL_SECTION()
+#define TRACE_ENTER_SHARED_SECTION()
+#define TRACE_EXIT_SHARED_SECTION()
+#elif !defined(TRACE_ENTER_SHARED_SECTION)
+#error "TRACE_ENTER_CORE_CRITICAL_SECTION is defined, but not TRACE_ENTER_SHARED_SECTION"
+#endif
+
+/* A full memory barrier, used by xTraceSnapshotExport to read an event buffer
+while its core writes to it. A port for a compiler other than GCC or Clang
+should define it if the target has more than one core. */
+#ifndef TRACE_MEMORY_BARRIER
+#if defined(__GNUC__)
+#define TRACE_MEMORY_BARRIER() __sync_synchronize()
+#else
+#define TRACE_MEMORY_BARRIER()
+#endif
+#endif
 
 /* Not yet available in snapshot mode */
 #define xTracePrintFormat0(_c, _f) 
@@ -151,6 +204,11 @@ typedef struct TraceHeaderBuffer	/* Aligned */
 #include <trcUtility.h>
 #include <trcStackMonitor.h>
 #include <trcInternalEventBuffer.h>
+#include <trcWriteCombine.h>
+#include <trcAdaptiveCtrl.h>
+#include <trcFlightRecorder.h>
+#include <trcTrigger.h>
+#include <trcProfiling.h>
 #include <trcDiagnostics.h>
 #include <trcAssert.h>
 #include <trcRunnable.h>
@@ -703,11 +761,103 @@ void vTraceSetStopHook(TRACE_STOP_HOOK stopHookFunction);
  * 
  * Only necessary if a restart is desired - this is not
  * needed in the startup initialization.
+ *
+ * With TRC_CFG_SNAPSHOT_CORE_BUFFERS, each core clears its own event buffer.
+ * The other cores do so before they store their next event, so their old
+ * events remain in the recorder data until then.
  * 
  * @note Snapshot mode only!
  */
 void vTraceClear(void);
 
+#ifndef TRC_CFG_INCLUDE_SNAPSHOT_EXPORT
+#define TRC_CFG_INCLUDE_SNAPSHOT_EXPORT 0
+#endif
+
+#if (TRC_CFG_INCLUDE_SNAPSHOT_EXPORT == 1)
+
+/**
+ * @brief Header of each record written by xTraceSnapshotExport.
+ *
+ * The header is followed by uiLength bytes that go at byte offset uiOffset
+ * of the recorder data structure, and then by zero padding up to the next
+ * 4-byte boundary. If TRC_SNAPSHOT_EXPORT_ZERO_FILL is set in uiLength, no
+ * data follows and the bytes are set to zero instead. Applying all records
+ * in order to a zero-initialized buffer of uiTraceGetTraceBufferSize() bytes
+ * reproduces the recorder data, which can then be opened in Tracealyzer like
+ * a normal snapshot.
+ */
+typedef struct TraceSnapshotExportRecord
+{
+	uint32_t uiOffset;
+	uint32_t uiLength;
+} TraceSnapshotExportRecord_t;
+
+#define TRC_SNAPSHOT_EXPORT_ZERO_FILL 0x80000000UL
+
+/* The object property table is exported in blocks of this many bytes */
+#define TRC_SNAPSHOT_EXPORT_OBJECT_BLOCK_SIZE 32
+#define TRC_SNAPSHOT_EXPORT_OBJECT_BLOCKS ((4*((TRACE_OBJECT_TABLE_SIZE+3)/4) + TRC_SNAPSHOT_EXPORT_OBJECT_BLOCK_SIZE - 1) / TRC_SNAPSHOT_EXPORT_OBJECT_BLOCK_SIZE)
+
+/**
+ * @brief Export progress, owned by the caller of xTraceSnapshotExport.
+ */
+typedef struct TraceSnapshotExportCursor
+{
+	uint32_t uiStaticOffset;								/* Progress through the parts only sent once */
+	uint32_t uiSymbolIndex;									/* Symbol table bytes exported */
+	uint32_t uiEventPosition[TRC_SNAPSHOT_CORE_COUNT];			/* Event slots exported, per core */
+	uint32_t uiClearCount[TRC_SNAPSHOT_CORE_COUNT];				/* Event buffer clears exported, per core */
+	uint32_t uiDroppedEvents;								/* Event slots overwritten before they were exported */
+	uint32_t uiInternalErrorOccured;						/* Error state last exported */
+	uint32_t uiUserEventBufferOffset;						/* Progress through the separate user event buffer */
+	uint32_t uiUserEventBufferState;						/* User event buffer state last exported */
+	uint16_t uiObjectBlockVersion[TRC_SNAPSHOT_EXPORT_OBJECT_BLOCKS];	/* Object property table block versions exported */
+} TraceSnapshotExportCursor_t;
+
+/**
+ * @brief Prepares a cursor for a new export.
+ *
+ * The first calls to xTraceSnapshotExport with a new cursor send the whole
+ * recorder data structure, except for events already overwritten. Each
+ * reader has its own cursor, any number of them may be in use at a time.
+ *
+ * @note Snapshot mode only!
+ *
+ * @param[out] pxCursor Cursor
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceSnapshotExportInit(TraceSnapshotExportCursor_t* pxCursor);
+
+/**
+ * @brief Exports recorder data changed since the previous call.
+ *
+ * Fills the buffer with as many records (see TraceSnapshotExportRecord_t) as
+ * fit and advances the cursor past them. Zero bytes written means everything
+ * has been exported. Recording continues meanwhile. Events overwritten in the
+ * ring buffer before they could be exported are skipped and counted in
+ * pxCursor->uiDroppedEvents. The separate user event buffer, if used, is
+ * sent as a whole each time it has changed. After a core has cleared its
+ * event buffer (see vTraceClear), its events are sent from the start again.
+ *
+ * The records are applied on the host by extras/SnapshotAssembler.
+ *
+ * @note Snapshot mode only!
+ *
+ * @param[in,out] pxCursor Cursor
+ * @param[out] pvBuffer Buffer
+ * @param[in] uiBufferSize Buffer size, at least 128 bytes
+ * @param[out] puiBytesWritten Bytes written to the buffer
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceSnapshotExport(TraceSnapshotExportCursor_t* pxCursor, void* pvBuffer, uint32_t uiBufferSize, uint32_t* puiBytesWritten);
+
+#endif /* (TRC_CFG_INCLUDE_SNAPSHOT_EXPORT == 1) */
+
 /*****************************************************************************/
 /*** INTERNAL SNAPSHOT FUNCTIONS *********************************************/
 /*****************************************************************************/
@@ -726,6 +876,17 @@ void vTraceClear(void);
 #define TRC_CFG_INCLUDE_OSTICK_EVENTS 0
 #endif
 
+#ifndef TRC_CFG_SYMBOL_TABLE_HASH_BITS
+#define TRC_CFG_SYMBOL_TABLE_HASH_BITS 6
+#endif
+
+#if ((TRC_CFG_SYMBOL_TABLE_HASH_BITS) != 6) && (((TRC_CFG_SYMBOL_TABLE_HASH_BITS) < 10) || ((TRC_CFG_SYMBOL_TABLE_HASH_BITS) > 12))
+#error "TRC_CFG_SYMBOL_TABLE_HASH_BITS must be 6 or 10 to 12!"
+#endif
+
+/* The number of symbol table list heads */
+#define TRC_SYMBOL_TABLE_HASH_SIZE (1UL << (TRC_CFG_SYMBOL_TABLE_HASH_BITS))
+
 /* This macro will create a task in the object table */
 #undef trcKERNEL_HOOKS_TASK_CREATE
 #define trcKERNEL_HOOKS_TASK_CREATE(SERVICE, CLASS, pxTCB) \
@@ -1149,18 +1310,37 @@ void vTraceUBEvent(traceUBChannel channel);
 
 #define NEventCodes 0x100
 
-/* Our local critical sections for the recorder */
-#define trcCRITICAL_SECTION_BEGIN() {TRACE_ENTER_CRITICAL_SECTION(); recorder_busy++;}
-#define trcCRITICAL_SECTION_END() {recorder_busy--; TRACE_EXIT_CRITICAL_SECTION();}
+/* Our local critical sections for the recorder. With
+TRC_CFG_SNAPSHOT_CORE_BUFFERS, recorder_busy has one entry per core, since
+another core being inside the recorder is not an error. */
+#define trcCRITICAL_SECTION_BEGIN() {TRACE_ENTER_CRITICAL_SECTION(); recorder_busy[TRC_SNAPSHOT_GET_CURRENT_CORE()]++;}
+#define trcCRITICAL_SECTION_END() {recorder_busy[TRC_SNAPSHOT_GET_CURRENT_CORE()]--; TRACE_EXIT_CRITICAL_SECTION();}
+
+#if ((TRC_CFG_SNAPSHOT_CORE_BUFFERS) == 1)
+/* For code that only writes to the event buffer of the current core */
+#define trcCORE_CRITICAL_SECTION_BEGIN() {TRACE_ENTER_CORE_CRITICAL_SECTION(); recorder_busy[TRC_SNAPSHOT_GET_CURRENT_CORE()]++;}
+#define trcCORE_CRITICAL_SECTION_END() {recorder_busy[TRC_SNAPSHOT_GET_CURRENT_CORE()]--; TRACE_EXIT_CORE_CRITICAL_SECTION();}
+
+/* For writes to the recorder data shared by all cores, also from within
+trcCORE_CRITICAL_SECTION_BEGIN */
+#define trcSHARED_SECTION_BEGIN() TRACE_ENTER_SHARED_SECTION();
+#define trcSHARED_SECTION_END() TRACE_EXIT_SHARED_SECTION();
+#else
+/* All cores share one event buffer, under the global critical section */
+#define trcCORE_CRITICAL_SECTION_BEGIN() trcCRITICAL_SECTION_BEGIN()
+#define trcCORE_CRITICAL_SECTION_END() trcCRITICAL_SECTION_END()
+#define trcSHARED_SECTION_BEGIN()
+#define trcSHARED_SECTION_END()
+#endif
 
 #if (TRC_CFG_HARDWARE_PORT == TRC_HARDWARE_PORT_ARM_Cortex_M)
 	#define trcSR_ALLOC_CRITICAL_SECTION_ON_CORTEX_M_ONLY TRACE_ALLOC_CRITICAL_SECTION
-	#define trcCRITICAL_SECTION_BEGIN_ON_CORTEX_M_ONLY trcCRITICAL_SECTION_BEGIN
-	#define trcCRITICAL_SECTION_END_ON_CORTEX_M_ONLY trcCRITICAL_SECTION_END
+	#define trcCRITICAL_SECTION_BEGIN_ON_CORTEX_M_ONLY trcCORE_CRITICAL_SECTION_BEGIN
+	#define trcCRITICAL_SECTION_END_ON_CORTEX_M_ONLY trcCORE_CRITICAL_SECTION_END
 #else
 	#define trcSR_ALLOC_CRITICAL_SECTION_ON_CORTEX_M_ONLY() {}
-	#define trcCRITICAL_SECTION_BEGIN_ON_CORTEX_M_ONLY() recorder_busy++;
-	#define trcCRITICAL_SECTION_END_ON_CORTEX_M_ONLY() recorder_busy--;
+	#define trcCRITICAL_SECTION_BEGIN_ON_CORTEX_M_ONLY() recorder_busy[TRC_SNAPSHOT_GET_CURRENT_CORE()]++;
+	#define trcCRITICAL_SECTION_END_ON_CORTEX_M_ONLY() recorder_busy[TRC_SNAPSHOT_GET_CURRENT_CORE()]--;
 #endif
 
 /**
@@ -1255,10 +1435,15 @@ typedef struct
 	/* Size rounded up to closest multiple of 4, to avoid alignment issues*/
 	uint8_t symbytes[4*(((TRC_CFG_SYMBOL_TABLE_SIZE)+3)/4)]; /**< */
 
-	/* Used for lookups - Up to 64 linked lists within the symbol table
-	connecting all entries with the same 6 bit checksum.
+#if ((TRC_CFG_SYMBOL_TABLE_HASH_BITS) != 6) || ((TRC_SNAPSHOT_CORE_COUNT) > 1)
+	/* = TRC_CFG_SYMBOL_TABLE_HASH_BITS. Only present with minor version 8 and 9 */
+	uint32_t hashBits; /**< */
+#endif
+
+	/* Used for lookups - Up to TRC_SYMBOL_TABLE_HASH_SIZE linked lists within
+	the symbol table connecting all entries with the same hash.
 	This field holds the current list heads. Should be initiated to zeros */
-	uint16_t latestEntryOfChecksum[64]; /**< */
+	uint16_t latestEntryOfChecksum[TRC_SYMBOL_TABLE_HASH_SIZE]; /**< */
 } symbolTableType;
 
 
@@ -1393,6 +1578,42 @@ typedef struct
 } UserEventBuffer;
 #endif /* (TRC_CFG_USE_SEPARATE_USER_EVENT_BUFFER == 1) */
 
+/*******************************************************************************
+ * The counters of one event buffer. Core 0 uses the fields from numEvents to
+ * absTimeLastEventSecond in RecorderDataType, which must keep this exact order.
+ ******************************************************************************/
+
+typedef struct
+{
+	uint32_t numEvents;
+	uint32_t maxEvents;
+	uint32_t nextFreeIndex;
+	uint32_t bufferIsFull;
+	uint32_t frequency;
+	uint32_t absTimeLastEvent;
+	uint32_t absTimeLastEventSecond;
+} EventLogCounters;
+
+/*******************************************************************************
+ * The event buffer of an additional core, stored as a secondary block. Each
+ * core timestamps its own events, so the absolute times (absTimeLastEvent and
+ * absTimeLastEventSecond) are used to merge the cores into one timeline. This
+ * requires that all cores read the same time source. Present with
+ * TRC_CFG_SNAPSHOT_CORE_BUFFERS and more than one core only, which is minor
+ * version 9.
+ ******************************************************************************/
+
+#if (TRC_SNAPSHOT_CORE_COUNT > 1)
+typedef struct
+{
+	uint16_t bufferID;
+	uint16_t version;
+	uint32_t coreID;
+	EventLogCounters counters;
+	uint8_t eventData[(TRC_CFG_EVENT_BUFFER_SIZE) * 4];
+} CoreEventBuffer;
+#endif /* (TRC_SNAPSHOT_CORE_COUNT > 1) */
+
 /*******************************************************************************
  * The main data structure, read by Tracealyzer from the RAM dump
  ******************************************************************************/
@@ -1415,7 +1636,8 @@ typedef struct
 	/* Used to determine Kernel and Endianess */
 	uint16_t version;
 
-	/* Currently 7 */
+	/* Currently 7, 8 if the symbol table uses a wide hash, or 9 if there
+	are event buffers of more than one core */
 	uint8_t minor_version;
 
 	/* This should be 0 if lower IRQ priority values implies higher priority
@@ -1514,6 +1736,11 @@ typedef struct
 	UserEventBuffer userEventBuffer;
 #endif
 
+#if (TRC_SNAPSHOT_CORE_COUNT > 1)
+	/* The event buffers of core 1 and up. The event buffer above is core 0. */
+	CoreEventBuffer coreEventBuffers[(TRC_SNAPSHOT_CORE_COUNT) - 1];
+#endif
+
 	/* This should always be 0 */
 	uint32_t endOfSecondaryBlocks;
 
@@ -1556,6 +1783,18 @@ void prvTraceError(const char* msg);
  */
 void prvTracePortGetTimeStamp(uint32_t *puiTimestamp);
 
+/**
+ * @brief Adds a differential timestamp to the absolute time of an event buffer
+ *
+ * Used by prvTraceGetDTS, splits dts into seconds and the rest with
+ * TRC_DIVMOD_RECIPROCAL.
+ *
+ * @param[in,out] pxLog Event buffer counters, with a non-zero frequency
+ * @param[in] reciprocal TRC_RECIPROCAL of pxLog->frequency
+ * @param[in] dts Time since the previous event, in timer ticks
+ */
+void prvTraceAddAbsTime(EventLogCounters* pxLog, uint32_t reciprocal, uint32_t dts);
+
 /**
  * @brief Reserve an object handle
  * 
@@ -1639,6 +1878,7 @@ typedef struct TraceRecorderData	/* Aligned */
 #endif
 	TraceStreamPortBuffer_t xStreamPortBuffer;		/* verify alignment in xTraceInitialize() */
 	TraceStaticBufferTable_t xStaticBufferBuffer;	/* aligned */
+	TraceWriteCombineData_t xWriteCombineBuffer;	/* aligned */
 	TraceEventDataTable_t xEventDataBuffer;			/* verify alignment in xTraceInitialize() */
 	TracePrintData_t xPrintBuffer;					/* aligned */
 	TraceErrorData_t xErrorBuffer;					/* aligned */
@@ -1647,6 +1887,10 @@ typedef struct TraceRecorderData	/* Aligned */
 	TraceTaskData_t xTaskInfoBuffer;				/* aligned */
 	TraceStackMonitorData_t xStackMonitorBuffer;	/* aligned */
 	TraceDiagnosticsData_t xDiagnosticsBuffer;		/* aligned */
+	TraceAdaptiveCtrlData_t xAdaptiveCtrlBuffer;	/* aligned */
+	TraceFlightRecorderData_t xFlightRecorderBuffer;
+	TraceTriggerData_t xTriggerBuffer;
+	TraceProfilingData_t xProfilingBuffer;
 	TraceExtensionData_t xExtensionBuffer;			/* aligned */
 	TraceCounterData_t xCounterBuffer;				/* aligned */
 } TraceRecorderData_t;
@@ -1728,6 +1972,22 @@ traceResult xTraceHeaderInitialize(TraceHeaderBuffer_t* pxBuffer);
  */
 traceResult xTraceTzCtrl(void);
 
+/**
+ * @brief Stores the header, timestamp info, entry table and start event again,
+ * as when tracing is started. For stream ports that split the trace into
+ * several files, so that each file can be decoded on its own.
+ * 
+ * Call it from xTraceTzCtrl, e.g. via xTraceStreamPortReadData, with no event
+ * commit in progress, as xTraceStreamPortSegmentCheck in the File stream port
+ * does. It enters the recorder's critical section, which may already be held.
+ * It must not be called from the stream port commit or write, since the events
+ * it stores are themselves committed and written there.
+ * 
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStoreSessionInfo(void);
+
 /******************************************************************************/
 /*** INTERNAL STREAMING FUNCTIONS *********************************************/
 /******************************************************************************/
@@ -45,6 +45,17 @@ typedef struct TraceTimestampData	/* Aligned */
 
 extern TraceTimestampData_t* pxTraceTimestamp;
 
+/**
+ * @internal Macro helper for the number of TRC_HWTC_COUNT ticks from __start
+ * to __stop, both read from TRC_HWTC_COUNT. TRC_HWTC_PERIOD is 0 for free
+ * running timers, that wrap at 2^32.
+ */
+#if ((TRC_HWTC_TYPE == TRC_FREE_RUNNING_32BIT_DECR) || (TRC_HWTC_TYPE == TRC_CUSTOM_TIMER_DECR) || (TRC_HWTC_TYPE == TRC_OS_TIMER_DECR))
+#define TRC_HWTC_TICKS_BETWEEN(__start, __stop) (((uint32_t)(__start) >= (uint32_t)(__stop)) ? ((uint32_t)(__start) - (uint32_t)(__stop)) : ((uint32_t)(__start) - (uint32_t)(__stop) + (uint32_t)(TRC_HWTC_PERIOD)))
+#else
+#define TRC_HWTC_TICKS_BETWEEN(__start, __stop) (((uint32_t)(__stop) >= (uint32_t)(__start)) ? ((uint32_t)(__stop) - (uint32_t)(__start)) : ((uint32_t)(__stop) - (uint32_t)(__start) + (uint32_t)(TRC_HWTC_PERIOD)))
+#endif
+
 /**
  * @internal Initialize trace timestamp system.
  * 
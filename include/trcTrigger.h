@@ -0,0 +1,216 @@
+/*
+* Percepio Trace Recorder for Tracealyzer v4.10.3
+* Copyright 2023 Percepio AB
+* www.percepio.com
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+/**
+ * @file
+ *
+ * @brief Public trace trigger rule APIs.
+ */
+
+#ifndef TRC_TRIGGER_H
+#define TRC_TRIGGER_H
+
+#if (TRC_USE_TRACEALYZER_RECORDER == 1)
+
+#include <trcTypes.h>
+
+#ifndef TRC_CFG_TRIGGER_RULES
+#define TRC_CFG_TRIGGER_RULES 0
+#endif
+
+/* Rule actions */
+#define TRC_TRIGGER_ACTION_NONE 0U		/**< Unused rule */
+#define TRC_TRIGGER_ACTION_START 1U		/**< Start storing events */
+#define TRC_TRIGGER_ACTION_STOP 2U		/**< Stop storing events, after this one */
+#define TRC_TRIGGER_ACTION_MARK 3U		/**< Store a "Rule <n>" user event on the "#Trigger" channel */
+#define TRC_TRIGGER_ACTION_FREEZE 4U	/**< xTraceFlightRecorderTrigger() */
+
+/* Rule flags */
+#define TRC_TRIGGER_FLAG_HANDLE 0x01U	/**< The first parameter must be uxHandle */
+#define TRC_TRIGGER_FLAG_RANGE 0x02U	/**< The parameter selected by TRC_TRIGGER_FLAG_PARAMETER() must be uxMin to uxMax */
+#define TRC_TRIGGER_FLAG_DURATION 0x04U	/**< The time until the core switches to another ISR or task must be uxMin to uxMax timestamp ticks */
+#define TRC_TRIGGER_FLAG_ONCE 0x08U		/**< The rule is removed when it has fired */
+
+/* Selects parameter 1 to TRC_TRIGGER_PARAMETERS for TRC_TRIGGER_FLAG_RANGE */
+#define TRC_TRIGGER_FLAG_PARAMETER(n) ((uint8_t)((((uint32_t)(n) - 1U) & 0x7U) << 4))
+
+/* The parameters the rules see. Events have up to six, but only the first
+ * four are checked, a range rule on another one is rejected. */
+#define TRC_TRIGGER_PARAMETERS 4U
+
+/* Words of one bit per event code, 0 to 0xFFF */
+#define TRC_TRIGGER_CODE_WORDS (0x1000U / 32U)
+
+/* Events below this code (trace start, timestamp configuration, names and ISR definitions) are stored also while stopped */
+#define TRC_TRIGGER_SYSTEM_EVENT_CODES 0x10U
+
+/**
+ * @brief Trace Trigger Rule Structure
+ */
+typedef struct TraceTriggerRule
+{
+	uint16_t uiEventCode;			/**< The event code to match */
+	uint8_t uiAction;				/**< TRC_TRIGGER_ACTION_START, _STOP, _MARK or _FREEZE */
+	uint8_t uiFlags;				/**< TRC_TRIGGER_FLAG_HANDLE, _RANGE, _DURATION, _ONCE and TRC_TRIGGER_FLAG_PARAMETER() */
+	TraceUnsignedBaseType_t uxHandle;	/**< The first parameter, for TRC_TRIGGER_FLAG_HANDLE */
+	TraceUnsignedBaseType_t uxMin;		/**< The lowest parameter value or duration */
+	TraceUnsignedBaseType_t uxMax;		/**< The highest parameter value or duration */
+} TraceTriggerRule_t;
+
+#if (TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING) && ((TRC_CFG_TRIGGER_RULES) > 0)
+
+#if ((TRC_CFG_TRIGGER_RULES) > 32)
+#error "TRC_CFG_TRIGGER_RULES must be 0 to 32"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup trace_trigger_apis Trace Trigger APIs
+ * @ingroup trace_recorder_apis
+ * @{
+ */
+
+/**
+ * @internal Trace Trigger Core Data Structure
+ */
+typedef struct TraceTriggerCoreData
+{
+	uint32_t uiDurationRule;		/**< The duration rule being timed, plus one. 0 if none. */
+	uint32_t uiDurationStart;		/**< The timestamp of the event that started it */
+} TraceTriggerCoreData_t;
+
+/**
+ * @internal Trace Trigger Data Structure
+ */
+typedef struct TraceTriggerData
+{
+	TraceTriggerRule_t xRules[TRC_CFG_TRIGGER_RULES];		/**< The rules in use */
+	TraceTriggerRule_t xUploaded[TRC_CFG_TRIGGER_RULES];	/**< Rules being uploaded by the host */
+	TraceTriggerCoreData_t xCores[TRC_CFG_CORE_COUNT];
+	uint32_t uiCodeBits[TRC_TRIGGER_CODE_WORDS];	/**< The bit of each rule's event code set, so that most events skip the rules */
+	uint32_t uiRuleCount;				/**< Rules in use, 0 if none */
+	uint32_t uiStarted;					/**< 0 while stopped by the rules */
+	uint32_t uiHasStartRule;			/**< Stopped until a start rule fires */
+	uint32_t uiUploadIndex;				/**< The rule that CMD_TRIGGER_RULE_VALUE sets */
+	TraceStringHandle_t xMarkChannel;	/**< "#Trigger", registered at initialization */
+} TraceTriggerData_t;
+
+/**
+ * @internal Initializes the trigger rules.
+ *
+ * @param[in] pxBuffer Pointer to memory that will be used by the trigger rules.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceTriggerInitialize(TraceTriggerData_t* pxBuffer);
+
+/**
+ * @brief Sets the trigger rules, replacing the ones in use. Each event is
+ * checked against at most TRC_CFG_TRIGGER_RULES rules, in order, and every
+ * rule that matches fires its action.
+ *
+ * If any rule starts, events are not stored until one of them fires. Events
+ * are not stored after a stop rule fires until a start rule fires again.
+ * Events below TRC_TRIGGER_SYSTEM_EVENT_CODES are always stored, so that
+ * objects can still be named. Marks are always stored and are not checked
+ * against the rules. The recorder itself stays enabled and streams the trace
+ * header as usual.
+ *
+ * A duration rule (TRC_TRIGGER_FLAG_DURATION) is timed from a matching event
+ * to the next ISR begin, ISR resume or task activation on the same core, in
+ * timestamp ticks. For example, "ISR X runs longer than 50 us" is the event
+ * code PSF_EVENT_ISR_BEGIN with TRC_TRIGGER_FLAG_HANDLE and uxHandle X, and
+ * uxMin the number of ticks in 50 us. Durations are only timed while the
+ * recorder is enabled, and an ISR that is preempted ends its duration.
+ *
+ * A range rule (TRC_TRIGGER_FLAG_RANGE) can only check one of the first
+ * TRC_TRIGGER_PARAMETERS parameters of an event. A rule on a later one is
+ * rejected, as are rules uploaded by the host.
+ *
+ * @param[in] pxRules Rules
+ * @param[in] uiCount Number of rules, 0 to TRC_CFG_TRIGGER_RULES. 0 removes all rules.
+ *
+ * @retval TRC_FAIL Too many rules, or a range on a parameter after TRC_TRIGGER_PARAMETERS. The rules in use are kept.
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceTriggerSetRules(const TraceTriggerRule_t* pxRules, uint32_t uiCount);
+
+/**
+ * @internal Called for each event before it is stored. Fires the actions of
+ * the rules that match.
+ *
+ * @param[in] uiEventCode Event code
+ * @param[in] uxParam1 First parameter, or 0
+ * @param[in] uxParam2 Second parameter, or 0
+ * @param[in] uxParam3 Third parameter, or 0
+ * @param[in] uxParam4 Fourth parameter, or 0. Later ones are not checked, see TRC_TRIGGER_PARAMETERS.
+ *
+ * @retval TRC_FAIL Stopped by the rules, don't store the event
+ * @retval TRC_SUCCESS Store the event
+ */
+traceResult xTraceTriggerCheck(uint32_t uiEventCode, TraceUnsignedBaseType_t uxParam1, TraceUnsignedBaseType_t uxParam2, TraceUnsignedBaseType_t uxParam3, TraceUnsignedBaseType_t uxParam4);
+
+/**
+ * @internal Called by prvSetRecorderEnabled(). Stops storing events until a
+ * start rule fires, if there is one, and forgets the durations being timed.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceTriggerOnTraceBegin(void);
+
+/**
+ * @internal Processes the trigger rule commands from the host:
+ * CMD_TRIGGER_RULE: param1 rule index, param2 action, param3 flags, param4
+ * and param5 event code, LSB first. Sets the rule's values to 0.
+ * CMD_TRIGGER_RULE_VALUE: param1 value (0 uxHandle, 1 uxMin, 2 uxMax) in bits
+ * 0-3 and 32-bit word in bits 4-7, param2 to param5 the word, LSB first. Sets
+ * a value of the rule selected by the latest CMD_TRIGGER_RULE.
+ * CMD_TRIGGER_RULES_SET: param1 number of rules. Replaces the rules in use by
+ * the uploaded ones, see xTraceTriggerSetRules().
+ *
+ * @param[in] uiCommand Command code
+ * @param[in] puiParams Command parameters, param1 to param5
+ *
+ * @retval TRC_FAIL Invalid command
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceTriggerProcessCommand(uint32_t uiCommand, const uint8_t* puiParams);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#else
+
+typedef struct TraceTriggerData
+{
+	TraceUnsignedBaseType_t buffer[1];
+} TraceTriggerData_t;
+
+#define xTraceTriggerInitialize(__pxBuffer) ((void)(__pxBuffer), TRC_SUCCESS)
+
+#define xTraceTriggerSetRules(__pxRules, __uiCount) TRC_COMMA_EXPR_TO_STATEMENT_EXPR_3((void)(__pxRules), (void)(__uiCount), TRC_FAIL)
+
+#define xTraceTriggerCheck(__uiEventCode, __uxParam1, __uxParam2, __uxParam3, __uxParam4) TRC_COMMA_EXPR_TO_STATEMENT_EXPR_6((void)(__uiEventCode), (void)(__uxParam1), (void)(__uxParam2), (void)(__uxParam3), (void)(__uxParam4), TRC_SUCCESS)
+
+#define xTraceTriggerOnTraceBegin() TRC_COMMA_EXPR_TO_STATEMENT_EXPR_1(TRC_SUCCESS)
+
+#define xTraceTriggerProcessCommand(__uiCommand, __puiParams) ((void)(__uiCommand), (void)(__puiParams), TRC_FAIL)
+
+#endif
+
+#endif
+
+#endif
@@ -37,6 +37,24 @@
 			uxTRC_STRCAT_INDEX++; \
 		} \
 	}
+
+/* Reciprocal of a 32-bit divisor for TRC_DIVMOD_RECIPROCAL, computed once when the divisor is set */
+#define TRC_RECIPROCAL(divisor) ((uint32_t)(0xFFFFFFFFUL / (uint32_t)(divisor)))
+
+/* Division-free quotient and remainder of a 32-bit dividend. The estimate from
+ * the reciprocal is never too high and at most 3 too low, which the loop corrects,
+ * so the result is identical to using / and %. */
+#define TRC_DIVMOD_RECIPROCAL(dividend, divisor, reciprocal, quotient, remainder) \
+	{ \
+		(quotient) = (uint32_t)(((uint64_t)(dividend) * (uint64_t)(reciprocal)) >> 32); \
+		(remainder) = (uint32_t)(dividend) - (quotient) * (uint32_t)(divisor); \
+		while ((remainder) >= (uint32_t)(divisor)) \
+		{ \
+			(remainder) -= (uint32_t)(divisor); \
+			(quotient)++; \
+		} \
+	}
+
 #if (defined(TRC_CFG_USE_GCC_STATEMENT_EXPR) && TRC_CFG_USE_GCC_STATEMENT_EXPR == 1) || \
 	(!defined(TRC_CFG_USE_GCC_STATEMENT_EXPR) && (__GNUC__ || __IAR_SYSTEMS_ICC__ || __TI_ARM__))
 	#define TRC_COMMA_EXPR_TO_STATEMENT_EXPR_1(e1)								__extension__({e1;})
@@ -0,0 +1,151 @@
+/*
+* Percepio Trace Recorder for Tracealyzer v4.10.3
+* Copyright 2023 Percepio AB
+* www.percepio.com
+*
+* SPDX-License-Identifier: Apache-2.0
+*/
+
+/**
+ * @file
+ *
+ * @brief Public trace write combine APIs.
+ */
+
+#ifndef TRC_WRITE_COMBINE_H
+#define TRC_WRITE_COMBINE_H
+
+#if (TRC_USE_TRACEALYZER_RECORDER == 1) && (TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)
+
+#include <trcTypes.h>
+
+#ifndef TRC_WRITE_COMBINE_SIZE
+#define TRC_WRITE_COMBINE_SIZE 0UL
+#endif
+
+#ifndef TRC_WRITE_COMBINE_FLUSH_PERIOD
+#define TRC_WRITE_COMBINE_FLUSH_PERIOD 1000UL
+#endif
+
+#if ((TRC_USE_INTERNAL_BUFFER) == 0) && ((TRC_WRITE_COMBINE_SIZE) > 0)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup trace_write_combine_apis Trace Write Combine APIs
+ * @ingroup trace_recorder_apis
+ * @{
+ */
+
+#define TRC_WRITE_COMBINE_NO_CORE 0xFFFFFFFFUL
+
+/* Aligned */
+#define TRC_WRITE_COMBINE_BUFFER_SIZE ((((TRC_WRITE_COMBINE_SIZE) + sizeof(TraceUnsignedBaseType_t) - 1) / sizeof(TraceUnsignedBaseType_t)) * sizeof(TraceUnsignedBaseType_t))
+
+/**
+ * @internal Trace Write Combine Core Structure
+ */
+typedef struct TraceWriteCombineCore	/* Aligned */
+{
+	uint32_t uiUsed;				/**< Bytes committed and not yet written */
+	uint32_t uiOldest;				/**< When the oldest of them was committed */
+	uint8_t uiBuffer[TRC_WRITE_COMBINE_BUFFER_SIZE];	/**< */
+} TraceWriteCombineCore_t;
+
+/**
+ * @internal Trace Write Combine Data Structure
+ */
+typedef struct TraceWriteCombineData	/* Aligned */
+{
+	TraceWriteCombineCore_t cores[TRC_CFG_CORE_COUNT];	/**< */
+	uint32_t uiFlushPeriod;			/**< TRC_WRITE_COMBINE_FLUSH_PERIOD in timer counts */
+	uint32_t uiPartialCore;			/**< The core whose data was only partly written, or TRC_WRITE_COMBINE_NO_CORE */
+} TraceWriteCombineData_t;
+
+extern TraceWriteCombineData_t* pxTraceWriteCombineData;
+
+/**
+ * @internal Initializes the write combine buffers.
+ *
+ * @param[in] pxBuffer Pointer to memory that will be used by the write combine buffers.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceWriteCombineInitialize(TraceWriteCombineData_t* pxBuffer);
+
+/**
+ * @internal Called as the trace begins, before the header is stored.
+ * Converts the flush period to timer counts and clears the buffers.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceWriteCombineOnTraceBegin(void);
+
+/**
+ * @brief Allocates space for an event in the current core's write combine
+ * buffer. If it doesn't fit, the buffer is flushed first. Called with the
+ * recorder's critical section held, the matching commit follows before it
+ * is released.
+ *
+ * @param[in] uiSize Allocation size
+ * @param[out] ppvData Allocation data pointer
+ *
+ * @retval TRC_FAIL The stream port hasn't taken the buffered data, the event is dropped
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceWriteCombineAlloc(uint32_t uiSize, void** ppvData);
+
+/**
+ * @brief Commits an allocated event. The buffer is flushed if its oldest data
+ * was committed TRC_WRITE_COMBINE_FLUSH_PERIOD microseconds ago or more.
+ * An event larger than the buffer, allocated from the static buffer, is
+ * written directly after the rest of any event another core has only partly
+ * written. If that can't be written yet, the event is dropped and counted in
+ * TRC_DIAGNOSTICS_WRITE_COMBINE_DROPPED.
+ *
+ * @param[in] pvData Data to commit
+ * @param[in] uiSize Data to commit size
+ * @param[out] piBytesCommitted Bytes committed
+ *
+ * @retval TRC_FAIL The event was dropped
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceWriteCombineCommit(void* pvData, uint32_t uiSize, int32_t* piBytesCommitted);
+
+/**
+ * @brief Writes all cores' buffered data through the stream port. Called by
+ * TzCtrl and when the recorder is disabled.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceWriteCombineFlush(void);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#else
+
+typedef struct TraceWriteCombineData
+{
+	TraceUnsignedBaseType_t buffer[1];
+} TraceWriteCombineData_t;
+
+#define xTraceWriteCombineInitialize(__pxBuffer) ((void)(__pxBuffer), TRC_SUCCESS)
+
+#define xTraceWriteCombineOnTraceBegin() TRC_COMMA_EXPR_TO_STATEMENT_EXPR_1(TRC_SUCCESS)
+
+#define xTraceWriteCombineFlush() TRC_COMMA_EXPR_TO_STATEMENT_EXPR_1(TRC_SUCCESS)
+
+#endif
+
+#endif
+
+#endif
@@ -79,6 +79,14 @@ extern portMUX_TYPE xTraceMutex;
 #define TRC_KERNEL_PORT_ALLOC_CRITICAL_SECTION() TraceUnsignedBaseType_t TRACE_ALLOC_CRITICAL_SECTION_NAME;
 #define TRC_KERNEL_PORT_ENTER_CRITICAL_SECTION() TRACE_ALLOC_CRITICAL_SECTION_NAME = 0UL; portENTER_CRITICAL_SAFE(&xTraceMutex);
 #define TRC_KERNEL_PORT_EXIT_CRITICAL_SECTION() (void)TRACE_ALLOC_CRITICAL_SECTION_NAME; portEXIT_CRITICAL_SAFE(&xTraceMutex);
+
+/* With TRC_CFG_SNAPSHOT_CORE_BUFFERS the snapshot recorder has one event buffer per core, so storing an event only needs interrupts masked on this core */
+#define TRACE_ENTER_CORE_CRITICAL_SECTION() { TRACE_ALLOC_CRITICAL_SECTION_NAME = (TraceUnsignedBaseType_t)portSET_INTERRUPT_MASK_FROM_ISR(); }
+#define TRACE_EXIT_CORE_CRITICAL_SECTION() { portCLEAR_INTERRUPT_MASK_FROM_ISR((UBaseType_t)TRACE_ALLOC_CRITICAL_SECTION_NAME); }
+
+/* The data shared by all cores is written under the spinlock of the global critical section, which may be taken again by the same core */
+#define TRACE_ENTER_SHARED_SECTION() portENTER_CRITICAL_SAFE(&xTraceMutex)
+#define TRACE_EXIT_SHARED_SECTION() portEXIT_CRITICAL_SAFE(&xTraceMutex)
 #else
 /* These are never used since trcHardwarePort.h will define the critical sections if CONFIG_FREERTOS_UNICORE */
 #define TRC_KERNEL_PORT_ALLOC_CRITICAL_SECTION() 
@@ -242,13 +242,18 @@ traceResult xTraceKernelPortEnable(void)
 
 static portTASK_FUNCTION(TzCtrl, pvParameters)
 {
+	TraceUnsignedBaseType_t uxDelay = 0;
+
 	(void)pvParameters;
 
 	while (1)
 	{
 		xTraceTzCtrl();
 
-		vTaskDelay(TRC_CFG_CTRL_TASK_DELAY);
+		/* TRC_CFG_CTRL_TASK_DELAY, unless TRC_CFG_CTRL_ADAPTIVE is enabled */
+		(void)xTraceAdaptiveCtrlGetDelay(&uxDelay);
+
+		vTaskDelay((TickType_t)uxDelay);
 	}
 }
 
@@ -0,0 +1,40 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Kernel port configuration parameters for snapshot mode.
+ */
+
+#ifndef TRC_KERNEL_PORT_SNAPSHOT_CONFIG_H
+#define TRC_KERNEL_PORT_SNAPSHOT_CONFIG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @def TRC_CFG_NTASK, TRC_CFG_NISR
+ * @brief The capacity of the Object Property Table for tasks and ISRs, i.e.,
+ * the maximum number of tasks and ISRs active at any given point. There are
+ * no kernel objects on a POSIX host, so the other classes have no entries.
+ */
+#define TRC_CFG_NTASK			15
+#define TRC_CFG_NISR			5
+
+/**
+ * @def TRC_CFG_NAME_LEN_TASK, TRC_CFG_NAME_LEN_ISR
+ * @brief The maximum lengths (number of characters) for names of tasks and
+ * ISRs. If longer names are used, they will be truncated when stored in the
+ * recorder.
+ */
+#define TRC_CFG_NAME_LEN_TASK			15
+#define TRC_CFG_NAME_LEN_ISR			15
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRC_KERNEL_PORT_SNAPSHOT_CONFIG_H */
@@ -0,0 +1,482 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * For use of Tracealyzer on a Linux/POSIX host (no RTOS), e.g. to build,
+ * benchmark and test the recorder core. Use with TRC_HARDWARE_PORT_POSIX.
+ */
+
+#ifndef TRC_KERNEL_PORT_H
+#define TRC_KERNEL_PORT_H
+
+#include <trcDefines.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TRC_USE_TRACEALYZER_RECORDER (TRC_CFG_USE_TRACEALYZER_RECORDER) /* Allows for disabling the recorder */
+
+#if (TRC_USE_TRACEALYZER_RECORDER == 1)
+
+#undef TRC_CFG_ENABLE_STACK_MONITOR
+#define TRC_CFG_ENABLE_STACK_MONITOR 0
+
+/*** Don't change the below definitions, unless you know what you are doing! ***/
+
+#if (TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_SNAPSHOT)
+/* Snapshots use the FreeRTOS object classes and event codes, with only tasks and ISRs */
+#define TRACE_KERNEL_VERSION 0x1AA1
+#else
+#define TRACE_KERNEL_VERSION 0x1FF1
+#endif
+
+/* Used by xTraceKernelPortDelay, there is no OS tick */
+#define TRC_TICK_RATE_HZ 1000 /* Must not be 0. */
+
+/**
+ * @def TRACE_CPU_CLOCK_HZ
+ * @brief Trace CPU clock speed in Hz. The timestamp frequency is used since
+ * the CPU clock isn't known.
+ */
+#define TRACE_CPU_CLOCK_HZ TRC_HWTC_FREQ_HZ
+
+#if (TRC_CFG_RECORDER_BUFFER_ALLOCATION == TRC_RECORDER_BUFFER_ALLOCATION_DYNAMIC)
+#include <stdlib.h> /* Include malloc() */
+
+/**
+ * @internal Kernel port specific heap initialization
+ */
+#define TRC_KERNEL_PORT_HEAP_INIT(size)
+
+/**
+ * @internal Kernel port specific heap malloc definition
+ */
+#define TRC_KERNEL_PORT_HEAP_MALLOC(size) malloc(size)
+#endif
+
+/**
+ * @internal Kernel port specific platform configuration. Maximum name length is 8!
+ */
+#define TRC_PLATFORM_CFG "generic"
+#define TRC_PLATFORM_CFG_MAJOR 1
+#define TRC_PLATFORM_CFG_MINOR 0
+#define TRC_PLATFORM_CFG_PATCH 0
+
+#ifndef TRACE_ENTER_CRITICAL_SECTION
+	#error "This hardware port has no definition for critical sections! See http://percepio.com/2014/10/27/how-to-define-critical-sections-for-the-recorder/"
+#endif
+
+#if (TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)
+#define TRC_KERNEL_PORT_BUFFER_SIZE (sizeof(TraceTaskHandle_t) * (TRC_CFG_CORE_COUNT))
+#else
+#define TRC_KERNEL_PORT_BUFFER_SIZE (sizeof(TraceUnsignedBaseType_t) * (TRC_CFG_CORE_COUNT))
+#endif
+
+/**
+ * @internal The kernel port data buffer
+ */
+typedef struct TraceKernelPortDataBuffer	/* Aligned */
+{
+	uint8_t buffer[TRC_KERNEL_PORT_BUFFER_SIZE];
+} TraceKernelPortDataBuffer_t;
+
+/**
+ * @internal Initializes the kernel port
+ * 
+ * @param[in] pxBuffer Kernel port data buffer
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceKernelPortInitialize(TraceKernelPortDataBuffer_t* const pxBuffer);
+
+/**
+ * @internal Enables the kernel port
+ * 
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceKernelPortEnable(void);
+
+/**
+ * @internal Sleeps the calling thread for a number of milliseconds (see TRC_TICK_RATE_HZ)
+ *
+ * @param[in] uiTicks Tick count to delay
+ * 
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceKernelPortDelay(uint32_t uiTicks);
+
+/**
+ * @internal Query if scheduler is suspended. There is no scheduler to suspend on a
+ * POSIX host, so this will always be false.
+ *
+ * @retval 1 Scheduler suspended
+ * @retval 0 Scheduler not suspended
+ */
+#define xTraceKernelPortIsSchedulerSuspended() (0U)
+
+/******************************************************************************/
+/*** Definitions for Snapshot mode ********************************************/
+/******************************************************************************/
+#if (TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_SNAPSHOT)
+
+/**
+ * @internal Kernel specific way to get current task handle. Threads aren't
+ * traced as tasks, so this is always the "(startup)" task.
+ */
+#define TRACE_GET_CURRENT_TASK() prvTraceGetCurrentTaskHandle()
+
+/**
+ * @internal Get task number
+ */
+#define TRACE_GET_TASK_NUMBER(pxTCB) ((void)(pxTCB), (traceHandle)0)
+
+extern uint16_t CurrentFilterMask;
+extern uint16_t CurrentFilterGroup;
+
+/**
+ * @brief No filtering of objects
+ */
+#define TRACE_GET_TASK_FILTER(pxTask) ((void)(pxTask), 0xFFFF)
+
+/**
+ * @internal No filtering of objects
+ */
+#define TRACE_GET_OBJECT_FILTER(CLASS, pxObject) ((void)(pxObject), 0xFFFF)
+
+/**
+ * @internal No filtering of objects
+ */
+#define TRACE_SET_OBJECT_FILTER(CLASS, pxObject, group) ((void)(pxObject), (void)(group))
+
+/* The object classes, as in the FreeRTOS port */
+#define TRACE_NCLASSES 9
+#define TRACE_CLASS_QUEUE ((traceObjectClass)0)
+#define TRACE_CLASS_SEMAPHORE ((traceObjectClass)1)
+#define TRACE_CLASS_MUTEX ((traceObjectClass)2)
+#define TRACE_CLASS_TASK ((traceObjectClass)3)
+#define TRACE_CLASS_ISR ((traceObjectClass)4)
+#define TRACE_CLASS_TIMER ((traceObjectClass)5)
+#define TRACE_CLASS_EVENTGROUP ((traceObjectClass)6)
+#define TRACE_CLASS_STREAMBUFFER ((traceObjectClass)7)
+#define TRACE_CLASS_MESSAGEBUFFER ((traceObjectClass)8)
+
+/* Definitions for Object Table */
+#define TRACE_KERNEL_OBJECT_COUNT ((TRC_CFG_NTASK) + (TRC_CFG_NISR))
+
+/* Task properties (except name):	Byte 0: Current priority
+									Byte 1: state (if already active)
+									Byte 2: legacy, not used
+									Byte 3: legacy, not used */
+#define PropertyTableSizeTask		((TRC_CFG_NAME_LEN_TASK) + 4)
+
+/* ISR properties:					Byte 0: priority
+									Byte 1: state (if already active) */
+#define PropertyTableSizeISR		((TRC_CFG_NAME_LEN_ISR) + 2)
+
+/* The layout of the byte array representing the Object Property Table */
+#define StartIndexTask			(0)
+#define StartIndexISR			(StartIndexTask			+ (TRC_CFG_NTASK)			* PropertyTableSizeTask)
+
+/* Number of bytes used by the object table */
+#define TRACE_OBJECT_TABLE_SIZE	(StartIndexISR + (TRC_CFG_NISR) * PropertyTableSizeISR)
+
+/**
+ * @internal Initialized the object property table
+ */
+traceResult xTraceKernelPortInitObjectPropertyTable(void);
+
+/**
+ * @internal Initialized the object handle stack
+ */
+traceResult xTraceKernelPortInitObjectHandleStack(void);
+
+/**
+ * @internal Retrieve error string
+ */
+const char* pszTraceGetErrorNotEnoughHandles(traceObjectClass objectclass);
+
+/**
+ * @internal Retrieve current task handle
+ */
+void* prvTraceGetCurrentTaskHandle(void);
+
+/*** Event codes for snapshot mode - must match Tracealyzer config files ******/
+
+#define NULL_EVENT					(0x00UL)
+
+/*******************************************************************************
+ * EVENTGROUP_DIV
+ *
+ * Miscellaneous events.
+ ******************************************************************************/
+#define EVENTGROUP_DIV				(NULL_EVENT + 1UL)					/*0x01*/
+#define DIV_XPS						(EVENTGROUP_DIV + 0UL)				/*0x01*/
+#define DIV_TASK_READY				(EVENTGROUP_DIV + 1UL)				/*0x02*/
+#define DIV_NEW_TIME				(EVENTGROUP_DIV + 2UL)				/*0x03*/
+
+/*******************************************************************************
+ * EVENTGROUP_TS
+ *
+ * Events for storing task-switches and interrupts. The RESUME events are
+ * generated if the task/interrupt is already marked active.
+ ******************************************************************************/
+#define EVENTGROUP_TS				(EVENTGROUP_DIV + 3UL)				/*0x04*/
+#define TS_ISR_BEGIN				(EVENTGROUP_TS + 0UL)				/*0x04*/
+#define TS_ISR_RESUME				(EVENTGROUP_TS + 1UL)				/*0x05*/
+#define TS_TASK_BEGIN				(EVENTGROUP_TS + 2UL)				/*0x06*/
+#define TS_TASK_RESUME				(EVENTGROUP_TS + 3UL)				/*0x07*/
+
+/*******************************************************************************
+ * EVENTGROUP_OBJCLOSE_NAME
+ *
+ * About Close Events
+ * When an object is evicted from the object property table (object close), two
+ * internal events are stored (EVENTGROUP_OBJCLOSE_NAME and
+ * EVENTGROUP_OBJCLOSE_PROP), containing the handle-name mapping and object
+ * properties valid up to this point.
+ ******************************************************************************/
+#define EVENTGROUP_OBJCLOSE_NAME_TRCSUCCESS	(EVENTGROUP_TS + 4UL)		/*0x08*/
+
+/*******************************************************************************
+ * EVENTGROUP_OBJCLOSE_PROP
+ *
+ * The internal event carrying properties of deleted objects
+ * The handle and object class of the closed object is not stored in this event,
+ * but is assumed to be the same as in the preceding CLOSE event. Thus, these
+ * two events must be generated from within a critical section.
+ * When queues are closed, arg1 is the "state" property (i.e., number of
+ * buffered messages/signals).
+ * When actors are closed, arg1 is priority, arg2 is handle of the "instance
+ * finish" event, and arg3 is event code of the "instance finish" event.
+ * In this case, the lower three bits is the object class of the instance finish
+ * handle. The lower three bits are not used (always zero) when queues are
+ * closed since the queue type is given in the previous OBJCLOSE_NAME event.
+ ******************************************************************************/
+#define EVENTGROUP_OBJCLOSE_PROP_TRCSUCCESS	(EVENTGROUP_OBJCLOSE_NAME_TRCSUCCESS + 8UL)	/*0x10*/
+
+/*******************************************************************************
+ * EVENTGROUP_CREATE
+ *
+ * The events in this group are used to log Kernel object creations.
+ * The lower three bits in the event code gives the object class, i.e., type of
+ * create operation (task, queue, semaphore, etc).
+ ******************************************************************************/
+#define EVENTGROUP_CREATE_OBJ_TRCSUCCESS	(EVENTGROUP_OBJCLOSE_PROP_TRCSUCCESS + 8UL)	/*0x18*/
+
+/*******************************************************************************
+ * EVENTGROUP_SEND
+ *
+ * The events in this group are used to log Send/Give events on queues,
+ * semaphores and mutexes The lower three bits in the event code gives the
+ * object class, i.e., what type of object that is operated on (queue, semaphore
+ * or mutex).
+ ******************************************************************************/
+#define EVENTGROUP_SEND_TRCSUCCESS	(EVENTGROUP_CREATE_OBJ_TRCSUCCESS + 8UL)	/*0x20*/
+
+/*******************************************************************************
+ * EVENTGROUP_RECEIVE
+ *
+ * The events in this group are used to log Receive/Take events on queues,
+ * semaphores and mutexes. The lower three bits in the event code gives the
+ * object class, i.e., what type of object that is operated on (queue, semaphore
+ * or mutex).
+ ******************************************************************************/
+#define EVENTGROUP_RECEIVE_TRCSUCCESS	(EVENTGROUP_SEND_TRCSUCCESS + 8UL)		/*0x28*/
+
+/* Send/Give operations, from ISR */
+#define EVENTGROUP_SEND_FROM_ISR_TRCSUCCESS \
+									(EVENTGROUP_RECEIVE_TRCSUCCESS + 8UL)		/*0x30*/
+
+/* Receive/Take operations, from ISR */
+#define EVENTGROUP_RECEIVE_FROM_ISR_TRCSUCCESS \
+							(EVENTGROUP_SEND_FROM_ISR_TRCSUCCESS + 8UL)			/*0x38*/
+
+/* "Failed" event type versions of above (timeout, failed allocation, etc) */
+#define EVENTGROUP_KSE_TRCFAILED \
+							(EVENTGROUP_RECEIVE_FROM_ISR_TRCSUCCESS + 8UL)		/*0x40*/
+
+/* Failed create calls - memory allocation failed */
+#define EVENTGROUP_CREATE_OBJ_TRCFAILED	(EVENTGROUP_KSE_TRCFAILED)				/*0x40*/
+
+/* Failed send/give - timeout! */
+#define EVENTGROUP_SEND_TRCFAILED		(EVENTGROUP_CREATE_OBJ_TRCFAILED + 8UL)	/*0x48*/
+
+/* Failed receive/take - timeout! */
+#define EVENTGROUP_RECEIVE_TRCFAILED	 (EVENTGROUP_SEND_TRCFAILED + 8UL)		/*0x50*/
+
+/* Failed non-blocking send/give - queue full */
+#define EVENTGROUP_SEND_FROM_ISR_TRCFAILED (EVENTGROUP_RECEIVE_TRCFAILED + 8UL) /*0x58*/
+
+/* Failed non-blocking receive/take - queue empty */
+#define EVENTGROUP_RECEIVE_FROM_ISR_TRCFAILED \
+								 (EVENTGROUP_SEND_FROM_ISR_TRCFAILED + 8UL)		/*0x60*/
+
+/* Events when blocking on receive/take */
+#define EVENTGROUP_RECEIVE_TRCBLOCK \
+							(EVENTGROUP_RECEIVE_FROM_ISR_TRCFAILED + 8UL)		/*0x68*/
+
+/* Events when blocking on send/give */
+#define EVENTGROUP_SEND_TRCBLOCK	(EVENTGROUP_RECEIVE_TRCBLOCK + 8UL)			/*0x70*/
+
+/* Events on queue peek (receive) */
+#define EVENTGROUP_PEEK_TRCSUCCESS	(EVENTGROUP_SEND_TRCBLOCK + 8UL)			/*0x78*/
+
+/* Events on object delete (vTaskDelete or vQueueDelete) */
+#define EVENTGROUP_DELETE_OBJ_TRCSUCCESS	(EVENTGROUP_PEEK_TRCSUCCESS + 8UL)	/*0x80*/
+
+/* Other events - object class is implied: TASK */
+#define EVENTGROUP_OTHERS	(EVENTGROUP_DELETE_OBJ_TRCSUCCESS + 8UL)			/*0x88*/
+#define TASK_DELAY_UNTIL	(EVENTGROUP_OTHERS + 0UL)						/*0x88*/
+#define TASK_DELAY			(EVENTGROUP_OTHERS + 1UL)						/*0x89*/
+#define TASK_SUSPEND		(EVENTGROUP_OTHERS + 2UL)						/*0x8A*/
+#define TASK_RESUME			(EVENTGROUP_OTHERS + 3UL)						/*0x8B*/
+#define TASK_RESUME_FROM_ISR	(EVENTGROUP_OTHERS + 4UL)					/*0x8C*/
+#define TASK_PRIORITY_SET		(EVENTGROUP_OTHERS + 5UL)					/*0x8D*/
+#define TASK_PRIORITY_INHERIT	(EVENTGROUP_OTHERS + 6UL)					/*0x8E*/
+#define TASK_PRIORITY_DISINHERIT	(EVENTGROUP_OTHERS + 7UL)				/*0x8F*/
+
+#define EVENTGROUP_MISC_PLACEHOLDER	(EVENTGROUP_OTHERS + 8UL)				/*0x90*/
+#define PEND_FUNC_CALL		(EVENTGROUP_MISC_PLACEHOLDER+0UL)				/*0x90*/
+#define PEND_FUNC_CALL_FROM_ISR (EVENTGROUP_MISC_PLACEHOLDER+1UL)			/*0x91*/
+#define PEND_FUNC_CALL_TRCFAILED (EVENTGROUP_MISC_PLACEHOLDER+2UL)			/*0x92*/
+#define PEND_FUNC_CALL_FROM_ISR_TRCFAILED (EVENTGROUP_MISC_PLACEHOLDER+3UL)	/*0x93*/
+#define MEM_MALLOC_SIZE (EVENTGROUP_MISC_PLACEHOLDER+4UL)					/*0x94*/
+#define MEM_MALLOC_ADDR (EVENTGROUP_MISC_PLACEHOLDER+5UL)					/*0x95*/
+#define MEM_FREE_SIZE (EVENTGROUP_MISC_PLACEHOLDER+6UL)						/*0x96*/
+#define MEM_FREE_ADDR (EVENTGROUP_MISC_PLACEHOLDER+7UL)						/*0x97*/
+
+/* User events */
+#define EVENTGROUP_USEREVENT (EVENTGROUP_MISC_PLACEHOLDER + 8UL)			/*0x98*/
+#define USER_EVENT (EVENTGROUP_USEREVENT + 0UL)
+
+/* Allow for 0-15 arguments (the number of args is added to event code) */
+#define USER_EVENT_LAST (EVENTGROUP_USEREVENT + 15UL)						/*0xA7*/
+
+/*******************************************************************************
+ * XTS Event - eXtended TimeStamp events
+ * The timestamps used in the recorder are "differential timestamps" (DTS), i.e.
+ * the time since the last stored event. The DTS fields are either 1 or 2 bytes
+ * in the other events, depending on the bytes available in the event struct.
+ * If the time since the last event (the DTS) is larger than allowed for by
+ * the DTS field of the current event, an XTS event is inserted immediately
+ * before the original event. The XTS event contains up to 3 additional bytes
+ * of the DTS value - the higher bytes of the true DTS value. The lower 1-2
+ * bytes are stored in the normal DTS field.
+ * There are two types of XTS events, XTS8 and XTS16. An XTS8 event is stored
+ * when there is only room for 1 byte (8 bit) DTS data in the original event,
+ * which means a limit of 0xFF (255UL). The XTS16 is used when the original event
+ * has a 16 bit DTS field and thereby can handle values up to 0xFFFF (65535UL).
+ *
+ * Using a very high frequency time base can result in many XTS events.
+ * Preferably, the time between two OS ticks should fit in 16 bits, i.e.,
+ * at most 65535. If your time base has a higher frequency, you can define
+ * the TRACE
+ ******************************************************************************/
+
+#define EVENTGROUP_SYS (EVENTGROUP_USEREVENT + 16UL)						/*0xA8*/
+#define XTS8 (EVENTGROUP_SYS + 0UL)											/*0xA8*/
+#define XTS16 (EVENTGROUP_SYS + 1UL)										/*0xA9*/
+#define EVENT_BEING_WRITTEN (EVENTGROUP_SYS + 2UL)							/*0xAA*/
+#define RESERVED_DUMMY_CODE (EVENTGROUP_SYS + 3UL)							/*0xAB*/
+#define LOW_POWER_BEGIN (EVENTGROUP_SYS + 4UL)								/*0xAC*/
+#define LOW_POWER_END (EVENTGROUP_SYS + 5UL)								/*0xAD*/
+#define XID (EVENTGROUP_SYS + 6UL)											/*0xAE*/
+#define XTS16L (EVENTGROUP_SYS + 7UL)										/*0xAF*/
+
+#define TASK_INSTANCE_FINISHED_NEXT_KSE (EVENTGROUP_SYS + 40UL)				/*0xD0*/
+#define TASK_INSTANCE_FINISHED_DIRECT (EVENTGROUP_SYS + 41UL)				/*0xD1*/
+
+#endif
+
+/******************************************************************************/
+/*** Definitions for Streaming mode *******************************************/
+/******************************************************************************/
+#if (TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)
+
+/*************************************************************************/
+/* KERNEL SPECIFIC OBJECT CONFIGURATION									 */
+/*************************************************************************/
+
+/*******************************************************************************
+ * The event codes - should match the offline config file.
+ ******************************************************************************/
+
+/*** Event codes for streaming - should match the Tracealyzer config file *****/
+#define PSF_EVENT_NULL_EVENT								0x00UL
+
+#define PSF_EVENT_TRACE_START								0x01UL
+#define PSF_EVENT_TS_CONFIG									0x02UL
+#define PSF_EVENT_OBJ_NAME									0x03UL
+#define PSF_EVENT_TASK_PRIORITY								0x04UL
+#define PSF_EVENT_DEFINE_ISR								0x05UL
+
+#define PSF_EVENT_IFE_NEXT									0x08UL
+#define PSF_EVENT_IFE_DIRECT								0x09UL
+
+#define PSF_EVENT_TASK_CREATE								0x10UL
+#define PSF_EVENT_TASK_DELETE								0x11UL
+#define PSF_EVENT_PROCESS_CREATE							0x12UL
+#define PSF_EVENT_PROCESS_DELETE							0x13UL
+#define PSF_EVENT_THREAD_CREATE								0x14UL
+#define PSF_EVENT_THREAD_DELETE								0x15UL
+
+#define PSF_EVENT_TASK_READY								0x20UL
+#define PSF_EVENT_ISR_BEGIN									0x21UL
+#define PSF_EVENT_ISR_RESUME								0x22UL
+#define PSF_EVENT_TS_BEGIN									0x23UL
+#define PSF_EVENT_TS_RESUME									0x24UL
+#define PSF_EVENT_TASK_ACTIVATE								0x25UL
+
+#define PSF_EVENT_MALLOC									0x30UL
+#define PSF_EVENT_FREE										0x31UL
+#define PSF_EVENT_MALLOC_FAILED								0x32UL
+#define PSF_EVENT_FREE_FAILED								0x33UL
+
+#define PSF_EVENT_LOWPOWER_BEGIN							0x38UL
+#define PSF_EVENT_LOWPOWER_END								0x39UL
+
+#define PSF_EVENT_STATEMACHINE_STATE_CREATE					0x40UL
+#define PSF_EVENT_STATEMACHINE_CREATE						0x41UL
+#define PSF_EVENT_STATEMACHINE_STATECHANGE					0x42UL
+
+#define PSF_EVENT_INTERVAL_CHANNEL_CREATE					0x43UL
+#define PSF_EVENT_INTERVAL_START							0x44UL
+#define PSF_EVENT_INTERVAL_STOP								0x45UL
+#define PSF_EVENT_INTERVAL_CHANNEL_SET_CREATE				0x46UL
+
+#define PSF_EVENT_EXTENSION_CREATE							0x47UL
+
+#define PSF_EVENT_HEAP_CREATE								0x48UL
+
+#define PSF_EVENT_COUNTER_CREATE							0x49UL
+#define PSF_EVENT_COUNTER_CHANGE							0x4AUL
+#define PSF_EVENT_COUNTER_LIMIT_EXCEEDED					0x4BUL
+
+#define PSF_EVENT_DEPENDENCY_REGISTER						0x4CUL
+
+#define PSF_EVENT_RUNNABLE_REGISTER							0x4DUL
+#define PSF_EVENT_RUNNABLE_START							0x4EUL
+#define PSF_EVENT_RUNNABLE_STOP								0x4FUL
+
+#define PSF_EVENT_USER_EVENT								0x50UL
+
+#define PSF_EVENT_USER_EVENT_FIXED							0x58UL
+
+#define TRC_EVENT_LAST_ID									(PSF_EVENT_DEPENDENCY_REGISTER)
+
+#endif
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRC_KERNEL_PORT_H */
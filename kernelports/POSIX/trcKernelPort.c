@@ -0,0 +1,158 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * For use of Tracealyzer on a Linux/POSIX host (no RTOS)
+ */
+
+#include <stdint.h>
+#include <time.h>
+#include <trcRecorder.h>
+
+#if (TRC_USE_TRACEALYZER_RECORDER == 1)
+
+#if (TRC_CFG_HARDWARE_PORT != TRC_HARDWARE_PORT_POSIX)
+#error "The POSIX kernel port requires TRC_CFG_HARDWARE_PORT to be TRC_HARDWARE_PORT_POSIX."
+#endif
+
+traceResult xTraceKernelPortDelay(uint32_t uiTicks)
+{
+	struct timespec xDelay;
+
+	xDelay.tv_sec = (time_t)(uiTicks / (TRC_TICK_RATE_HZ));
+	xDelay.tv_nsec = (long)((uiTicks % (TRC_TICK_RATE_HZ)) * (1000000000UL / (TRC_TICK_RATE_HZ)));
+
+	while (nanosleep(&xDelay, &xDelay) != 0)
+	{
+		/* Interrupted by a signal, sleep the remaining time */
+	}
+
+	return TRC_SUCCESS;
+}
+
+#if (TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)
+
+typedef struct TraceKernelPortData
+{
+	TraceTaskHandle_t xTaskHandles[TRC_CFG_CORE_COUNT];
+} TraceKernelPortData_t;
+
+static TraceKernelPortData_t* pxKernelPortData TRC_CFG_RECORDER_DATA_ATTRIBUTE;
+
+traceResult xTraceKernelPortInitialize(TraceKernelPortDataBuffer_t* const pxBuffer)
+{
+	TRC_ASSERT_EQUAL_SIZE(TraceKernelPortData_t, TraceKernelPortDataBuffer_t);
+
+	pxKernelPortData = (TraceKernelPortData_t*)pxBuffer; /*cstat !MISRAC2004-11.4 !MISRAC2012-Rule-11.3 Suppress conversion between pointer types checks*/
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceKernelPortEnable(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < (TRC_CFG_CORE_COUNT); i++)
+	{
+		(void)xTraceObjectRegister(PSF_EVENT_TASK_CREATE, (void*)0, "main", 1u, (TraceObjectHandle_t*)&pxKernelPortData->xTaskHandles[i]);
+		(void)xTraceTaskSetCurrentOnCore(i, pxKernelPortData->xTaskHandles[i]);
+	}
+
+	return TRC_SUCCESS;
+}
+
+#endif /* Streaming mode */
+
+#if (TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_SNAPSHOT)
+
+void* prvTraceGetCurrentTaskHandle(void)
+{
+	/* The recorder logs everything in the "(startup)" task */
+	return (void*)0;
+}
+
+traceResult xTraceKernelPortInitialize(TraceKernelPortDataBuffer_t* const pxBuffer)
+{
+	(void)pxBuffer;
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceKernelPortEnable(void)
+{
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceKernelPortInitObjectPropertyTable(void)
+{
+	uint32_t i;
+
+	RecorderDataPtr->ObjectPropertyTable.NumberOfObjectClasses = TRACE_NCLASSES;
+
+	/* Classes without objects are placed before or after tasks and ISRs, as in the FreeRTOS layout */
+	for (i = 0; i < TRACE_NCLASSES; i++)
+	{
+		RecorderDataPtr->ObjectPropertyTable.NumberOfObjectsPerClass[i] = 0;
+		RecorderDataPtr->ObjectPropertyTable.NameLengthPerClass[i] = 0;
+		RecorderDataPtr->ObjectPropertyTable.TotalPropertyBytesPerClass[i] = 0;
+		RecorderDataPtr->ObjectPropertyTable.StartIndexOfClass[i] = (i < TRACE_CLASS_TASK) ? 0 : TRACE_OBJECT_TABLE_SIZE;
+	}
+
+	RecorderDataPtr->ObjectPropertyTable.NumberOfObjectsPerClass[TRACE_CLASS_TASK] = TRC_CFG_NTASK;
+	RecorderDataPtr->ObjectPropertyTable.NumberOfObjectsPerClass[TRACE_CLASS_ISR] = TRC_CFG_NISR;
+	RecorderDataPtr->ObjectPropertyTable.NameLengthPerClass[TRACE_CLASS_TASK] = TRC_CFG_NAME_LEN_TASK;
+	RecorderDataPtr->ObjectPropertyTable.NameLengthPerClass[TRACE_CLASS_ISR] = TRC_CFG_NAME_LEN_ISR;
+	RecorderDataPtr->ObjectPropertyTable.TotalPropertyBytesPerClass[TRACE_CLASS_TASK] = PropertyTableSizeTask;
+	RecorderDataPtr->ObjectPropertyTable.TotalPropertyBytesPerClass[TRACE_CLASS_ISR] = PropertyTableSizeISR;
+	RecorderDataPtr->ObjectPropertyTable.StartIndexOfClass[TRACE_CLASS_TASK] = StartIndexTask;
+	RecorderDataPtr->ObjectPropertyTable.StartIndexOfClass[TRACE_CLASS_ISR] = StartIndexISR;
+	RecorderDataPtr->ObjectPropertyTable.ObjectPropertyTableSizeInBytes = TRACE_OBJECT_TABLE_SIZE;
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceKernelPortInitObjectHandleStack(void)
+{
+	uint32_t i = 0;
+
+	for (i = 0; i < TRACE_NCLASSES; i++)
+	{
+		/* Empty classes, lowest index above the highest */
+		objectHandleStacks.indexOfNextAvailableHandle[i] = objectHandleStacks.lowestIndexOfClass[i] = (i < TRACE_CLASS_TASK) ? 0 : TRACE_KERNEL_OBJECT_COUNT;
+		objectHandleStacks.highestIndexOfClass[i] = objectHandleStacks.lowestIndexOfClass[i] - 1;
+		objectHandleStacks.handleCountWaterMarksOfClass[i] = 0;
+	}
+
+	objectHandleStacks.indexOfNextAvailableHandle[TRACE_CLASS_TASK] = objectHandleStacks.lowestIndexOfClass[TRACE_CLASS_TASK] = 0;
+	objectHandleStacks.indexOfNextAvailableHandle[TRACE_CLASS_ISR] = objectHandleStacks.lowestIndexOfClass[TRACE_CLASS_ISR] = (TRC_CFG_NTASK);
+
+	objectHandleStacks.highestIndexOfClass[TRACE_CLASS_TASK] = (TRC_CFG_NTASK) - 1;
+	objectHandleStacks.highestIndexOfClass[TRACE_CLASS_ISR] = (TRC_CFG_NTASK) + (TRC_CFG_NISR) - 1;
+
+	for (i = 0; i < TRACE_KERNEL_OBJECT_COUNT; i++)
+	{
+		objectHandleStacks.objectHandles[i] = 0;
+	}
+
+	return TRC_SUCCESS;
+}
+
+const char* pszTraceGetErrorNotEnoughHandles(traceObjectClass objectclass)
+{
+	switch(objectclass)
+	{
+	case TRACE_CLASS_TASK:
+		return "Not enough TASK handles - increase TRC_CFG_NTASK in trcKernelPortSnapshotConfig.h";
+	case TRACE_CLASS_ISR:
+		return "Not enough ISR handles - increase TRC_CFG_NISR in trcKernelPortSnapshotConfig.h";
+	default:
+		return "pszTraceGetErrorHandles: Invalid objectclass!";
+	}
+}
+
+#endif /* Snapshot mode */
+
+#endif
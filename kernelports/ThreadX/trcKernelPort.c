@@ -46,13 +46,18 @@ TraceHeapHandle_t xSystemHeapHandle;
  */
 void TzCtrlThreadEntry(ULONG _arg)
 {
+	TraceUnsignedBaseType_t uxDelay = 0;
+
 	(void)_arg;
 
 	while (1)
 	{
 		(void)xTraceTzCtrl();
 
-		tx_thread_sleep((TRC_CFG_CTRL_TASK_DELAY));
+		/* TRC_CFG_CTRL_TASK_DELAY, unless TRC_CFG_CTRL_ADAPTIVE is enabled */
+		(void)xTraceAdaptiveCtrlGetDelay(&uxDelay);
+
+		tx_thread_sleep((ULONG)uxDelay);
 	}
 }
 
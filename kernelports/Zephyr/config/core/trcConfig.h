@@ -251,6 +251,41 @@ extern "C" {
 #define TRC_CFG_CTRL_TASK_DELAY 10
 #endif
 
+/**
+ * @def TRC_CFG_CTRL_ADAPTIVE
+ * @brief Adapts the TzCtrl delay to the rate at which the internal buffer
+ * fills. See config/trcConfig.h for this and the settings that follow.
+ */
+#ifdef CONFIG_PERCEPIO_TRC_CFG_CTRL_ADAPTIVE
+#define TRC_CFG_CTRL_ADAPTIVE 1
+#else
+#define TRC_CFG_CTRL_ADAPTIVE 0
+#endif
+
+#ifdef CONFIG_PERCEPIO_TRC_CFG_CTRL_TASK_DELAY_MIN
+#define TRC_CFG_CTRL_TASK_DELAY_MIN CONFIG_PERCEPIO_TRC_CFG_CTRL_TASK_DELAY_MIN
+#else
+#define TRC_CFG_CTRL_TASK_DELAY_MIN 1
+#endif
+
+#ifdef CONFIG_PERCEPIO_TRC_CFG_CTRL_TASK_DELAY_MAX
+#define TRC_CFG_CTRL_TASK_DELAY_MAX CONFIG_PERCEPIO_TRC_CFG_CTRL_TASK_DELAY_MAX
+#else
+#define TRC_CFG_CTRL_TASK_DELAY_MAX (TRC_CFG_CTRL_TASK_DELAY)
+#endif
+
+#ifdef CONFIG_PERCEPIO_TRC_CFG_CTRL_TARGET_OCCUPANCY
+#define TRC_CFG_CTRL_TARGET_OCCUPANCY CONFIG_PERCEPIO_TRC_CFG_CTRL_TARGET_OCCUPANCY
+#else
+#define TRC_CFG_CTRL_TARGET_OCCUPANCY 50
+#endif
+
+#ifdef CONFIG_PERCEPIO_TRC_CFG_CTRL_CHUNK_BUDGET_MAX
+#define TRC_CFG_CTRL_CHUNK_BUDGET_MAX CONFIG_PERCEPIO_TRC_CFG_CTRL_CHUNK_BUDGET_MAX
+#else
+#define TRC_CFG_CTRL_CHUNK_BUDGET_MAX 20
+#endif
+
 /**
  * @def TRC_CFG_CTRL_TASK_STACK_SIZE
  * @brief The stack size of the Tracealyzer Control (TzCtrl) task.
@@ -262,6 +297,106 @@ extern "C" {
 #define TRC_CFG_CTRL_TASK_STACK_SIZE (256)
 #endif
 
+/**
+ * @brief Gives the events in the internal buffer priority lanes, so that the
+ * least important are dropped first. See config/trcConfig.h for this and the
+ * settings that follow.
+ */
+#ifdef CONFIG_PERCEPIO_TRC_CFG_EVENT_LANES
+#define TRC_CFG_EVENT_LANES 1
+#else
+#define TRC_CFG_EVENT_LANES 0
+#endif
+
+#ifdef CONFIG_PERCEPIO_TRC_CFG_EVENT_LANE_RESERVE_SCHEDULING
+#define TRC_CFG_EVENT_LANE_RESERVE_SCHEDULING CONFIG_PERCEPIO_TRC_CFG_EVENT_LANE_RESERVE_SCHEDULING
+#else
+#define TRC_CFG_EVENT_LANE_RESERVE_SCHEDULING 10
+#endif
+
+#ifdef CONFIG_PERCEPIO_TRC_CFG_EVENT_LANE_RESERVE_OBJECT
+#define TRC_CFG_EVENT_LANE_RESERVE_OBJECT CONFIG_PERCEPIO_TRC_CFG_EVENT_LANE_RESERVE_OBJECT
+#else
+#define TRC_CFG_EVENT_LANE_RESERVE_OBJECT 10
+#endif
+
+/**
+ * @brief Uses the internal buffer as a flight recorder that is transferred
+ * only after a trigger. See config/trcConfig.h for this and the settings that
+ * follow.
+ */
+#ifdef CONFIG_PERCEPIO_TRC_CFG_FLIGHT_RECORDER
+#define TRC_CFG_FLIGHT_RECORDER 1
+#else
+#define TRC_CFG_FLIGHT_RECORDER 0
+#endif
+
+#ifdef CONFIG_PERCEPIO_TRC_CFG_FLIGHT_RECORDER_POST_TRIGGER
+#define TRC_CFG_FLIGHT_RECORDER_POST_TRIGGER CONFIG_PERCEPIO_TRC_CFG_FLIGHT_RECORDER_POST_TRIGGER
+#else
+#define TRC_CFG_FLIGHT_RECORDER_POST_TRIGGER 25
+#endif
+
+#ifdef CONFIG_PERCEPIO_TRC_CFG_FLIGHT_RECORDER_TRIGGER_ERROR
+#define TRC_CFG_FLIGHT_RECORDER_TRIGGER_ON_ERROR TRC_FLIGHT_RECORDER_TRIGGER_ERROR
+#else
+#define TRC_CFG_FLIGHT_RECORDER_TRIGGER_ON_ERROR 0
+#endif
+#ifdef CONFIG_PERCEPIO_TRC_CFG_FLIGHT_RECORDER_TRIGGER_ASSERT
+#define TRC_CFG_FLIGHT_RECORDER_TRIGGER_ON_ASSERT TRC_FLIGHT_RECORDER_TRIGGER_ASSERT
+#else
+#define TRC_CFG_FLIGHT_RECORDER_TRIGGER_ON_ASSERT 0
+#endif
+#ifdef CONFIG_PERCEPIO_TRC_CFG_FLIGHT_RECORDER_TRIGGER_COUNTER_LIMIT
+#define TRC_CFG_FLIGHT_RECORDER_TRIGGER_ON_COUNTER_LIMIT TRC_FLIGHT_RECORDER_TRIGGER_COUNTER_LIMIT
+#else
+#define TRC_CFG_FLIGHT_RECORDER_TRIGGER_ON_COUNTER_LIMIT 0
+#endif
+#define TRC_CFG_FLIGHT_RECORDER_TRIGGERS (TRC_CFG_FLIGHT_RECORDER_TRIGGER_ON_ERROR | TRC_CFG_FLIGHT_RECORDER_TRIGGER_ON_ASSERT | TRC_CFG_FLIGHT_RECORDER_TRIGGER_ON_COUNTER_LIMIT)
+
+/**
+ * @brief The number of trigger rules that can be used, 0 to exclude them.
+ * See config/trcConfig.h.
+ */
+#ifdef CONFIG_PERCEPIO_TRC_CFG_TRIGGER_RULES
+#define TRC_CFG_TRIGGER_RULES CONFIG_PERCEPIO_TRC_CFG_TRIGGER_RULES
+#else
+#define TRC_CFG_TRIGGER_RULES 0
+#endif
+
+/**
+ * @brief Measures the recorder's own cost. See config/trcConfig.h for this
+ * and the setting that follows.
+ */
+#ifdef CONFIG_PERCEPIO_TRC_CFG_SELF_PROFILING
+#define TRC_CFG_SELF_PROFILING 1
+#else
+#define TRC_CFG_SELF_PROFILING 0
+#endif
+
+#ifdef CONFIG_PERCEPIO_TRC_CFG_SELF_PROFILING_REPORT_INTERVAL
+#define TRC_CFG_SELF_PROFILING_REPORT_INTERVAL CONFIG_PERCEPIO_TRC_CFG_SELF_PROFILING_REPORT_INTERVAL
+#else
+#define TRC_CFG_SELF_PROFILING_REPORT_INTERVAL 100
+#endif
+
+/**
+ * @def TRC_CFG_DIAGNOSTICS_EXTENDED
+ * @brief Keeps more diagnostics, to size the buffers and chunk settings with.
+ * See config/trcConfig.h for this and the setting that follows.
+ */
+#ifdef CONFIG_PERCEPIO_TRC_CFG_DIAGNOSTICS_EXTENDED
+#define TRC_CFG_DIAGNOSTICS_EXTENDED 1
+#else
+#define TRC_CFG_DIAGNOSTICS_EXTENDED 0
+#endif
+
+#ifdef CONFIG_PERCEPIO_TRC_CFG_DIAGNOSTICS_REPORT_INTERVAL
+#define TRC_CFG_DIAGNOSTICS_REPORT_INTERVAL CONFIG_PERCEPIO_TRC_CFG_DIAGNOSTICS_REPORT_INTERVAL
+#else
+#define TRC_CFG_DIAGNOSTICS_REPORT_INTERVAL 100
+#endif
+
 /**
  * @def TRC_CFG_RECORDER_BUFFER_ALLOCATION
  * @brief Specifies how the recorder buffer is allocated (also in case of streaming, in
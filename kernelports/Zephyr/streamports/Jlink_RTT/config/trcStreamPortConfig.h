@@ -185,6 +185,44 @@ extern "C" {
  */
 #define TRC_CFG_STREAM_PORT_RTT_NO_LOCK_WRITE CONFIG_PERCEPIO_TRC_CFG_STREAM_PORT_RTT_NO_LOCK_WRITE
 
+/**
+ * @def TRC_CFG_STREAM_PORT_RTT_ZERO_COPY
+ *
+ * @brief Only used when the internal buffer isn't. If 1, the events are
+ * stored directly in the RTT up buffer instead of being copied there by
+ * SEGGER_RTT_Write(), except those that would wrap or don't fit.
+ */
+#ifdef CONFIG_PERCEPIO_TRC_CFG_STREAM_PORT_RTT_ZERO_COPY
+#define TRC_CFG_STREAM_PORT_RTT_ZERO_COPY CONFIG_PERCEPIO_TRC_CFG_STREAM_PORT_RTT_ZERO_COPY
+#else
+#define TRC_CFG_STREAM_PORT_RTT_ZERO_COPY 0
+#endif
+
+/**
+ * @def TRC_CFG_STREAM_PORT_WRITE_COMBINE_SIZE
+ *
+ * @brief Only used when the internal buffer isn't. If larger than 0, the
+ * events are combined in a buffer of this size per core and written to RTT a few
+ * hundred bytes at a time. Set to 0 to write each event as it is stored.
+ */
+#ifdef CONFIG_PERCEPIO_TRC_CFG_STREAM_PORT_WRITE_COMBINE_SIZE
+#define TRC_CFG_STREAM_PORT_WRITE_COMBINE_SIZE CONFIG_PERCEPIO_TRC_CFG_STREAM_PORT_WRITE_COMBINE_SIZE
+#else
+#define TRC_CFG_STREAM_PORT_WRITE_COMBINE_SIZE 0
+#endif
+
+/**
+ * @def TRC_CFG_STREAM_PORT_WRITE_COMBINE_FLUSH_PERIOD
+ *
+ * @brief The longest time, in microseconds, that an event is held in the write
+ * combine buffer while other events are being stored.
+ */
+#ifdef CONFIG_PERCEPIO_TRC_CFG_STREAM_PORT_WRITE_COMBINE_FLUSH_PERIOD
+#define TRC_CFG_STREAM_PORT_WRITE_COMBINE_FLUSH_PERIOD CONFIG_PERCEPIO_TRC_CFG_STREAM_PORT_WRITE_COMBINE_FLUSH_PERIOD
+#else
+#define TRC_CFG_STREAM_PORT_WRITE_COMBINE_FLUSH_PERIOD 1000
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -48,11 +48,16 @@ static K_THREAD_STACK_DEFINE(TzCtrl_thread_stack, (TRC_CFG_CTRL_TASK_STACK_SIZE)
  */
 void TzCtrl_thread_entry(void *_args)
 {
+	TraceUnsignedBaseType_t uxDelay = 0;
+
 	while (1)
 	{
 		(void)xTraceTzCtrl();
 
-		k_msleep((TRC_CFG_CTRL_TASK_DELAY));
+		/* TRC_CFG_CTRL_TASK_DELAY, unless TRC_CFG_CTRL_ADAPTIVE is enabled */
+		(void)xTraceAdaptiveCtrlGetDelay(&uxDelay);
+
+		k_msleep((int32_t)uxDelay);
 	}
 }
 
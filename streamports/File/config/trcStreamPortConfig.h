@@ -20,7 +20,9 @@ extern "C" {
  *
  * @brief Defines the trace file name
  */
+#ifndef TRC_CFG_STREAM_PORT_TRACE_FILE
 #define TRC_CFG_STREAM_PORT_TRACE_FILE "trace.psf"
+#endif
 
 
 /**
@@ -81,6 +83,111 @@ extern "C" {
  */
 #define TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT 5
 
+/**
+ * @def TRC_CFG_STREAM_PORT_USE_WRITER_THREAD
+ *
+ * @brief Set to 1 to write the trace file from a dedicated writer thread
+ * (POSIX hosts and simulators only). Events are copied into large blocks that
+ * are handed to the writer thread through a lock-free queue, so the recording
+ * threads never wait for disk I/O. Events are dropped if all blocks are queued.
+ */
+#ifndef TRC_CFG_STREAM_PORT_USE_WRITER_THREAD
+#define TRC_CFG_STREAM_PORT_USE_WRITER_THREAD 0
+#endif
+
+/**
+ * @def TRC_CFG_STREAM_PORT_WRITER_BLOCK_SIZE
+ *
+ * @brief The size of each block written by the writer thread. Must be a
+ * multiple of 4096 if TRC_CFG_STREAM_PORT_WRITER_USE_O_DIRECT is 1.
+ */
+#ifndef TRC_CFG_STREAM_PORT_WRITER_BLOCK_SIZE
+#define TRC_CFG_STREAM_PORT_WRITER_BLOCK_SIZE 65536
+#endif
+
+/**
+ * @def TRC_CFG_STREAM_PORT_WRITER_BLOCK_COUNT
+ *
+ * @brief The number of blocks, i.e., how much data can be queued for the
+ * writer thread before events are dropped.
+ */
+#ifndef TRC_CFG_STREAM_PORT_WRITER_BLOCK_COUNT
+#define TRC_CFG_STREAM_PORT_WRITER_BLOCK_COUNT 16
+#endif
+
+/**
+ * @def TRC_CFG_STREAM_PORT_WRITER_USE_O_DIRECT
+ *
+ * @brief Set to 1 to open the trace file with O_DIRECT, bypassing the page
+ * cache. Only full blocks are written until the trace ends, so partially
+ * filled blocks are not flushed periodically in this mode. Falls back to
+ * buffered I/O if the file system doesn't support O_DIRECT.
+ */
+#define TRC_CFG_STREAM_PORT_WRITER_USE_O_DIRECT 0
+
+/**
+ * @def TRC_CFG_STREAM_PORT_WRITER_SYNC_INTERVAL
+ *
+ * @brief The writer thread calls fdatasync() after this many blocks. Set to 0
+ * to only sync when the trace ends.
+ */
+#define TRC_CFG_STREAM_PORT_WRITER_SYNC_INTERVAL 0
+
+/**
+ * @def TRC_CFG_STREAM_PORT_WRITER_FLUSH_MS
+ *
+ * @brief If the writer thread has been idle for this many milliseconds, it
+ * writes the partially filled block, so that the file is never more than
+ * about this old. Not done with TRC_CFG_STREAM_PORT_WRITER_USE_O_DIRECT.
+ */
+#ifndef TRC_CFG_STREAM_PORT_WRITER_FLUSH_MS
+#define TRC_CFG_STREAM_PORT_WRITER_FLUSH_MS 100
+#endif
+
+/**
+ * @def TRC_CFG_STREAM_PORT_SEGMENT_SIZE
+ *
+ * @brief Set to split the trace into segment files of about this many bytes,
+ * e.g. trace.0000.psf, trace.0001.psf and so on. Every segment starts with
+ * the header, timestamp info and entry table, so each can be opened on its
+ * own. Set to 0 to not split on size. Can't be combined with the internal
+ * buffer or the writer thread. The size and duration are checked each time
+ * TzCtrl runs, so xTraceTzCtrl() must be called periodically.
+ */
+#ifndef TRC_CFG_STREAM_PORT_SEGMENT_SIZE
+#define TRC_CFG_STREAM_PORT_SEGMENT_SIZE 0
+#endif
+
+/**
+ * @def TRC_CFG_STREAM_PORT_SEGMENT_DURATION
+ *
+ * @brief Set to start a new segment file after this many seconds (wall clock
+ * time). Set to 0 to not split on time.
+ */
+#ifndef TRC_CFG_STREAM_PORT_SEGMENT_DURATION
+#define TRC_CFG_STREAM_PORT_SEGMENT_DURATION 0
+#endif
+
+/**
+ * @def TRC_CFG_STREAM_PORT_SEGMENT_KEEP
+ *
+ * @brief The number of segment files to keep, older segments are removed.
+ */
+#ifndef TRC_CFG_STREAM_PORT_SEGMENT_KEEP
+#define TRC_CFG_STREAM_PORT_SEGMENT_KEEP 8
+#endif
+
+/**
+ * @def TRC_CFG_STREAM_PORT_SEGMENT_INDEX_FILE
+ *
+ * @brief The index file, rewritten on every new segment. Lists the kept
+ * segments and the timestamp range of each, for finding the right segment
+ * without opening them all.
+ */
+#ifndef TRC_CFG_STREAM_PORT_SEGMENT_INDEX_FILE
+#define TRC_CFG_STREAM_PORT_SEGMENT_INDEX_FILE "trace.idx"
+#endif
+
 #ifdef __cplusplus
 }
 #endif
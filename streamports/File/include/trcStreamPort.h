@@ -21,6 +21,30 @@
 #include <trcStreamPortConfig.h>
 #include <stdio.h>
 
+#ifndef TRC_CFG_STREAM_PORT_USE_WRITER_THREAD
+#define TRC_CFG_STREAM_PORT_USE_WRITER_THREAD 0
+#endif
+
+#ifndef TRC_CFG_STREAM_PORT_SEGMENT_SIZE
+#define TRC_CFG_STREAM_PORT_SEGMENT_SIZE 0
+#endif
+
+#ifndef TRC_CFG_STREAM_PORT_SEGMENT_DURATION
+#define TRC_CFG_STREAM_PORT_SEGMENT_DURATION 0
+#endif
+
+#if (TRC_CFG_STREAM_PORT_USE_WRITER_THREAD == 1)
+#include <pthread.h>
+#include <semaphore.h>
+#ifdef __cplusplus
+/* Only trcStreamPort.c accesses the writer, the 32-bit fields keep their layout */
+#define TRC_STREAM_PORT_ATOMIC
+#else
+#include <stdatomic.h>
+#define TRC_STREAM_PORT_ATOMIC _Atomic
+#endif
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -39,17 +63,72 @@ extern "C" {
 
 #define TRC_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT (TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT)
 
+#define TRC_STREAM_PORT_USE_WRITER_THREAD (TRC_CFG_STREAM_PORT_USE_WRITER_THREAD)
+
+#if ((TRC_CFG_STREAM_PORT_SEGMENT_SIZE) > 0) || ((TRC_CFG_STREAM_PORT_SEGMENT_DURATION) > 0)
+#define TRC_STREAM_PORT_USE_SEGMENTS 1
+#else
+#define TRC_STREAM_PORT_USE_SEGMENTS 0
+#endif
+
 /* Default file name */
 #ifndef TRC_CFG_STREAM_PORT_TRACE_FILE
 #define TRC_CFG_STREAM_PORT_TRACE_FILE "trace.psf"
 #endif
 
+#if (TRC_STREAM_PORT_USE_WRITER_THREAD == 1)
+/**
+ * @internal State shared by the recorder (producer) and the writer thread.
+ * Blocks are filled in order. uiProduced and uiConsumed count handed over and
+ * written blocks, the block at uiProduced is being filled with uiFill bytes.
+ * The atomic fields are the only ones both sides access, and each is written
+ * by one side only.
+ */
+typedef struct TraceStreamPortFileWriter
+{
+	uint8_t* puiBlocks;
+	uint32_t uiBlockLength[TRC_CFG_STREAM_PORT_WRITER_BLOCK_COUNT];
+	TRC_STREAM_PORT_ATOMIC uint32_t uiProduced;		/* Written by the recorder */
+	TRC_STREAM_PORT_ATOMIC uint32_t uiFill;			/* Written by the recorder */
+	TRC_STREAM_PORT_ATOMIC uint32_t uiConsumed;		/* Written by the writer thread */
+	TRC_STREAM_PORT_ATOMIC uint32_t uiWaiting;		/* Set by the writer thread while it waits, cleared by whoever wakes it */
+	TRC_STREAM_PORT_ATOMIC uint32_t uiStop;			/* Written by the recorder */
+	uint32_t uiDirect;
+	uint32_t uiDroppedEvents;
+	int iFile;
+	sem_t xWakeup;
+	pthread_t xThread;
+} TraceStreamPortFileWriter_t;
+#endif
+
+#if (TRC_STREAM_PORT_USE_SEGMENTS == 1)
+/**
+ * @internal Bookkeeping for the segment files. The timestamp ranges of the
+ * kept segments are stored for the index, indexed by segment number modulo
+ * TRC_CFG_STREAM_PORT_SEGMENT_KEEP.
+ */
+typedef struct TraceStreamPortFileSegments
+{
+	uint64_t ulFirstTimestamp[TRC_CFG_STREAM_PORT_SEGMENT_KEEP];
+	uint64_t ulLastTimestamp[TRC_CFG_STREAM_PORT_SEGMENT_KEEP];
+	uint64_t ulBytes;		/* Bytes written to the current segment */
+	int64_t lStartTime;		/* When the current segment was created, in seconds */
+	uint32_t uiSegment;		/* Current segment number */
+} TraceStreamPortFileSegments_t;
+#endif
+
 typedef struct TraceStreamPortFile	/* Aligned */
 {
 	FILE* pxFile;
 #if (TRC_USE_INTERNAL_BUFFER)
 	uint8_t buffer[TRC_ALIGNED_STREAM_PORT_BUFFER_SIZE];
 #endif
+#if (TRC_STREAM_PORT_USE_WRITER_THREAD == 1)
+	TraceStreamPortFileWriter_t xWriter;
+#endif
+#if (TRC_STREAM_PORT_USE_SEGMENTS == 1)
+	TraceStreamPortFileSegments_t xSegments;
+#endif
 } TraceStreamPortFile_t;
 
 extern TraceStreamPortFile_t* pxStreamPortFile;
@@ -110,10 +189,70 @@ traceResult xTraceStreamPortInitialize(TraceStreamPortBuffer_t* pxBuffer);
 	#else
 		#define xTraceStreamPortCommit xTraceInternalEventBufferAllocCommit
 	#endif
+#elif (TRC_STREAM_PORT_USE_WRITER_THREAD == 1)
+	#define xTraceStreamPortCommit xTraceStreamPortWriterCommit
+#elif (TRC_STREAM_PORT_USE_SEGMENTS == 1)
+	#define xTraceStreamPortCommit xTraceStreamPortSegmentCommit
 #else
 	#define xTraceStreamPortCommit xTraceStreamPortWriteData
 #endif
 
+#if (TRC_STREAM_PORT_USE_SEGMENTS == 1)
+/**
+ * @internal Writes an event to the current segment file.
+ *
+ * @param[in] pvData Event data
+ * @param[in] uiSize Event size
+ * @param[out] piBytesWritten Bytes written
+ *
+ * @retval TRC_FAIL Write failed
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortSegmentCommit(void* pvData, uint32_t uiSize, int32_t* piBytesWritten);
+
+/**
+ * @internal Moves on to the next segment file when the current one is full or
+ * old enough. Called from TzCtrl through xTraceStreamPortReadData, so that
+ * storing an event never waits for a new file. A segment can therefore grow
+ * past TRC_CFG_STREAM_PORT_SEGMENT_SIZE by what is stored between two TzCtrl
+ * runs.
+ *
+ * @retval TRC_FAIL The next segment file couldn't be created
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortSegmentCheck(void);
+#endif
+
+#if (TRC_STREAM_PORT_USE_WRITER_THREAD == 1)
+
+/**
+ * @internal Hands an event over to the writer thread. The event is either
+ * queued as a whole or dropped, the recorder never waits for the file.
+ *
+ * @param[in] pvData Event data
+ * @param[in] uiSize Event size
+ * @param[out] piBytesWritten Bytes queued, 0 if dropped
+ *
+ * @retval TRC_FAIL No room, the event was dropped
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortWriterCommit(void* pvData, uint32_t uiSize, int32_t* piBytesWritten);
+
+/**
+ * @brief Writes data through the stream port interface. Hands the data over
+ * to the writer thread, as much as there is room for.
+ *
+ * @param[in] pvData Data to write
+ * @param[in] uiSize Data to write size
+ * @param[out] piBytesWritten Bytes written
+ *
+ * @retval TRC_FAIL Write failed
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortWriteData(void* pvData, uint32_t uiSize, int32_t* piBytesWritten);
+
+#else
+
 /**
  * @brief Writes data through the stream port interface.
  *
@@ -126,8 +265,12 @@ traceResult xTraceStreamPortInitialize(TraceStreamPortBuffer_t* pxBuffer);
  */
 #define xTraceStreamPortWriteData(pvData, uiSize, piBytesWritten) (*(piBytesWritten) = (int32_t)fwrite(pvData, 1, uiSize, pxStreamPortFile->pxFile), TRC_SUCCESS)
 
+#endif
+
 /**
- * @brief Reads data through the stream port interface.
+ * @brief Reads data through the stream port interface. Nothing is read from a
+ * file. TzCtrl calls this periodically, which is when a segment file is
+ * changed, see xTraceStreamPortSegmentCheck.
  *
  * @param[in] pvData Destination data buffer
  * @param[in] uiSize Destination data buffer size
@@ -136,7 +279,11 @@ traceResult xTraceStreamPortInitialize(TraceStreamPortBuffer_t* pxBuffer);
  * @retval TRC_FAIL Read failed
  * @retval TRC_SUCCESS Success
  */
+#if (TRC_STREAM_PORT_USE_SEGMENTS == 1)
+#define xTraceStreamPortReadData(pvData, uiSize, piBytesRead) ((void)(pvData), (void)(uiSize), (*(piBytesRead) = 0), xTraceStreamPortSegmentCheck())
+#else
 #define xTraceStreamPortReadData(pvData, uiSize, piBytesRead) ((void)(pvData), (void)(uiSize), (void)(piBytesRead), TRC_SUCCESS)
+#endif
 
 #define xTraceStreamPortOnEnable(uiStartOption) ((void)(uiStartOption), TRC_SUCCESS)
 
@@ -13,11 +13,77 @@
 
 #include <trcRecorder.h>
 #include <stdio.h>
+#include <errno.h>
 
 #if (TRC_USE_TRACEALYZER_RECORDER == 1)
 
 #if (TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)
 
+#if (TRC_STREAM_PORT_USE_WRITER_THREAD == 1)
+
+#if defined(_WIN32)
+#error "TRC_CFG_STREAM_PORT_USE_WRITER_THREAD requires a POSIX host."
+#endif
+
+#if (TRC_CFG_STREAM_PORT_WRITER_BLOCK_COUNT < 2)
+#error "TRC_CFG_STREAM_PORT_WRITER_BLOCK_COUNT must be at least 2."
+#endif
+
+#if (TRC_CFG_STREAM_PORT_WRITER_USE_O_DIRECT == 1) && ((TRC_CFG_STREAM_PORT_WRITER_BLOCK_SIZE % 4096) != 0)
+#error "TRC_CFG_STREAM_PORT_WRITER_BLOCK_SIZE must be a multiple of 4096 when using O_DIRECT."
+#endif
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifndef O_DIRECT
+#define O_DIRECT 0
+#endif
+
+#define TRC_STREAM_PORT_WRITER_ALIGNMENT 4096u
+
+static traceResult prvTraceStreamPortWriterOpen(void);
+static void prvTraceStreamPortWriterClose(void);
+static void prvTraceStreamPortWriterPublish(TraceStreamPortFileWriter_t* pxWriter, uint32_t uiLength);
+static uint32_t prvTraceStreamPortWriterCopy(TraceStreamPortFileWriter_t* pxWriter, const uint8_t* puiData, uint32_t uiSize);
+static traceResult prvTraceStreamPortWriterWriteBlock(TraceStreamPortFileWriter_t* pxWriter, const uint8_t* puiBlock, uint32_t uiLength);
+static uint32_t prvTraceStreamPortWriterGetFill(TraceStreamPortFileWriter_t* pxWriter, uint32_t uiConsumed);
+static traceResult prvTraceStreamPortWriterWait(TraceStreamPortFileWriter_t* pxWriter, uint32_t uiConsumed);
+static void* prvTraceStreamPortWriterThread(void* pvArg);
+
+#endif
+
+#if (TRC_STREAM_PORT_USE_WRITER_THREAD == 0)
+static traceResult prvTraceStreamPortOpenFile(const char* szFileName);
+#endif
+
+#if (TRC_STREAM_PORT_USE_SEGMENTS == 1)
+
+#if (TRC_USE_INTERNAL_BUFFER == 1) || (TRC_STREAM_PORT_USE_WRITER_THREAD == 1)
+#error "Segment files can't be combined with the internal buffer or the writer thread, since a new segment must begin at an event."
+#endif
+
+#if ((TRC_CFG_STREAM_PORT_SEGMENT_KEEP) < 1)
+#error "TRC_CFG_STREAM_PORT_SEGMENT_KEEP must be at least 1."
+#endif
+
+#include <time.h>
+
+#define TRC_STREAM_PORT_SEGMENT_NAME_LENGTH 256
+
+static traceResult prvTraceStreamPortSegmentBegin(void);
+static void prvTraceStreamPortSegmentEnd(void);
+static traceResult prvTraceStreamPortSegmentNext(void);
+static traceResult prvTraceStreamPortSegmentOpen(void);
+static void prvTraceStreamPortSegmentName(uint32_t uiSegment, char* szFileName);
+static uint64_t prvTraceStreamPortSegmentTimestamp(void);
+static void prvTraceStreamPortSegmentWriteIndex(void);
+
+#endif
+
 TraceStreamPortFile_t* pxStreamPortFile TRC_CFG_RECORDER_DATA_ATTRIBUTE;
 
 traceResult xTraceStreamPortInitialize(TraceStreamPortBuffer_t* pxBuffer)
@@ -28,6 +94,10 @@ traceResult xTraceStreamPortInitialize(TraceStreamPortBuffer_t* pxBuffer)
 
 	pxStreamPortFile = (TraceStreamPortFile_t*)pxBuffer;
 	pxStreamPortFile->pxFile = 0;
+#if (TRC_STREAM_PORT_USE_WRITER_THREAD == 1)
+	pxStreamPortFile->xWriter.puiBlocks = 0;
+	pxStreamPortFile->xWriter.iFile = -1;
+#endif
 
 #if (TRC_USE_INTERNAL_BUFFER == 1)
 	return xTraceInternalEventBufferInitialize(pxStreamPortFile->buffer, sizeof(pxStreamPortFile->buffer));
@@ -42,57 +112,699 @@ traceResult xTraceStreamPortOnTraceBegin(void)
 	{
 		return TRC_FAIL;
 	}
-	
+
+#if (TRC_STREAM_PORT_USE_WRITER_THREAD == 1)
+	if (pxStreamPortFile->xWriter.puiBlocks == 0)
+	{
+		return prvTraceStreamPortWriterOpen();
+	}
+#else
 	if (pxStreamPortFile->pxFile == 0)
 	{
+#if (TRC_STREAM_PORT_USE_SEGMENTS == 1)
+		return prvTraceStreamPortSegmentBegin();
+#else
+		return prvTraceStreamPortOpenFile(TRC_CFG_STREAM_PORT_TRACE_FILE);
+#endif
+	}
+#endif
+	
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceStreamPortOnTraceEnd(void)
+{
+	if (pxStreamPortFile == 0)
+	{
+		return TRC_FAIL;
+	}
+	
+#if (TRC_STREAM_PORT_USE_WRITER_THREAD == 1)
+	if (pxStreamPortFile->xWriter.puiBlocks != 0)
+	{
+		prvTraceStreamPortWriterClose();
+	}
+#else
+	if (pxStreamPortFile->pxFile != 0)
+	{
+#if (TRC_STREAM_PORT_USE_SEGMENTS == 1)
+		prvTraceStreamPortSegmentEnd();
+#else
+		fclose(pxStreamPortFile->pxFile);
+		pxStreamPortFile->pxFile = 0;
+		printf("Trace file closed.\n");
+#endif
+	}
+#endif
+	
+	return TRC_SUCCESS;
+}
+
+#if (TRC_STREAM_PORT_USE_WRITER_THREAD == 0)
+
+static traceResult prvTraceStreamPortOpenFile(const char* szFileName)
+{
 #if defined(__STDC_WANT_LIB_EXT1__) && __STDC_WANT_LIB_EXT1__ == 1
-		errno_t err = fopen_s(&pxStreamPortFile->pxFile, TRC_CFG_STREAM_PORT_TRACE_FILE, "wb");
-		if (err != 0)
+	errno_t err = fopen_s(&pxStreamPortFile->pxFile, szFileName, "wb");
+	if (err != 0)
+	{
+		printf("Could not open trace file, error code %d.\n", err);
+
+		return TRC_FAIL;
+	}
+	else
+	{
+		printf("Trace file created.\n");
+	}
+#else
+	FILE * file = fopen(szFileName, "wb");
+	if (file == NULL)
+	{
+		printf("Could not open trace file, error code %d.\n", errno);
+
+		return TRC_FAIL;
+	}
+	else
+	{
+		pxStreamPortFile->pxFile = file;
+		printf("Trace file created.\n");
+	}
+#endif
+
+	return TRC_SUCCESS;
+}
+
+#endif /* (TRC_STREAM_PORT_USE_WRITER_THREAD == 0) */
+
+#if (TRC_STREAM_PORT_USE_SEGMENTS == 1)
+
+traceResult xTraceStreamPortSegmentCommit(void* pvData, uint32_t uiSize, int32_t* piBytesWritten)
+{
+	if (pxStreamPortFile->pxFile == 0)
+	{
+		*piBytesWritten = 0;
+
+		return TRC_SUCCESS;
+	}
+
+	*piBytesWritten = (int32_t)fwrite(pvData, 1, uiSize, pxStreamPortFile->pxFile);
+	pxStreamPortFile->xSegments.ulBytes += (uint64_t)uiSize;
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceStreamPortSegmentCheck(void)
+{
+	TraceStreamPortFileSegments_t* pxSegments = &pxStreamPortFile->xSegments;
+	char szFileName[TRC_STREAM_PORT_SEGMENT_NAME_LENGTH];
+	uint32_t uiNext = 0u;
+	traceResult xResult;
+
+	TRACE_ALLOC_CRITICAL_SECTION();
+
+	if (pxStreamPortFile->pxFile == 0)
+	{
+		return TRC_SUCCESS;
+	}
+
+#if ((TRC_CFG_STREAM_PORT_SEGMENT_SIZE) > 0)
+	if (pxSegments->ulBytes >= (uint64_t)(TRC_CFG_STREAM_PORT_SEGMENT_SIZE))
+	{
+		uiNext = 1u;
+	}
+#endif
+
+#if ((TRC_CFG_STREAM_PORT_SEGMENT_DURATION) > 0)
+	if ((int64_t)time((time_t*)0) - pxSegments->lStartTime >= (int64_t)(TRC_CFG_STREAM_PORT_SEGMENT_DURATION))
+	{
+		uiNext = 1u;
+	}
+#endif
+
+	if (uiNext == 0u)
+	{
+		return TRC_SUCCESS;
+	}
+
+	/* No event is committed while the segment changes, so the new one begins at an event */
+	TRACE_ENTER_CRITICAL_SECTION();
+	xResult = (pxStreamPortFile->pxFile != 0) ? prvTraceStreamPortSegmentNext() : TRC_SUCCESS;
+	TRACE_EXIT_CRITICAL_SECTION();
+
+	if (pxSegments->uiSegment >= (TRC_CFG_STREAM_PORT_SEGMENT_KEEP))
+	{
+		prvTraceStreamPortSegmentName(pxSegments->uiSegment - (TRC_CFG_STREAM_PORT_SEGMENT_KEEP), szFileName);
+		(void)remove(szFileName);
+	}
+
+	prvTraceStreamPortSegmentWriteIndex();
+
+	return xResult;
+}
+
+static traceResult prvTraceStreamPortSegmentBegin(void)
+{
+	pxStreamPortFile->xSegments.uiSegment = 0u;
+
+	/* The recorder stores the session info itself when tracing begins */
+	if (prvTraceStreamPortSegmentOpen() == TRC_FAIL)
+	{
+		return TRC_FAIL;
+	}
+
+	prvTraceStreamPortSegmentWriteIndex();
+
+	return TRC_SUCCESS;
+}
+
+static void prvTraceStreamPortSegmentEnd(void)
+{
+	TraceStreamPortFileSegments_t* pxSegments = &pxStreamPortFile->xSegments;
+
+	pxSegments->ulLastTimestamp[pxSegments->uiSegment % (TRC_CFG_STREAM_PORT_SEGMENT_KEEP)] = prvTraceStreamPortSegmentTimestamp();
+
+	fclose(pxStreamPortFile->pxFile);
+	pxStreamPortFile->pxFile = 0;
+
+	prvTraceStreamPortSegmentWriteIndex();
+
+	printf("Trace file closed.\n");
+}
+
+/* Called in the recorder's critical section */
+static traceResult prvTraceStreamPortSegmentNext(void)
+{
+	TraceStreamPortFileSegments_t* pxSegments = &pxStreamPortFile->xSegments;
+
+	pxSegments->ulLastTimestamp[pxSegments->uiSegment % (TRC_CFG_STREAM_PORT_SEGMENT_KEEP)] = prvTraceStreamPortSegmentTimestamp();
+
+	fclose(pxStreamPortFile->pxFile);
+	pxStreamPortFile->pxFile = 0;
+
+	pxSegments->uiSegment++;
+
+	if (prvTraceStreamPortSegmentOpen() == TRC_FAIL)
+	{
+		return TRC_FAIL;
+	}
+
+	/* Make the new segment decodable on its own */
+	return xTraceStoreSessionInfo();
+}
+
+static traceResult prvTraceStreamPortSegmentOpen(void)
+{
+	TraceStreamPortFileSegments_t* pxSegments = &pxStreamPortFile->xSegments;
+	char szFileName[TRC_STREAM_PORT_SEGMENT_NAME_LENGTH];
+
+	prvTraceStreamPortSegmentName(pxSegments->uiSegment, szFileName);
+
+	if (prvTraceStreamPortOpenFile(szFileName) == TRC_FAIL)
+	{
+		return TRC_FAIL;
+	}
+
+	pxSegments->ulBytes = 0u;
+	pxSegments->lStartTime = (int64_t)time((time_t*)0);
+	pxSegments->ulFirstTimestamp[pxSegments->uiSegment % (TRC_CFG_STREAM_PORT_SEGMENT_KEEP)] = prvTraceStreamPortSegmentTimestamp();
+
+	return TRC_SUCCESS;
+}
+
+/* Inserts the segment number before the extension, "trace.psf" becomes "trace.0001.psf" */
+static void prvTraceStreamPortSegmentName(uint32_t uiSegment, char* szFileName)
+{
+	const char* szTraceFile = TRC_CFG_STREAM_PORT_TRACE_FILE;
+	const char* szExtension = (const char*)0;
+	uint32_t i;
+
+	for (i = 0u; szTraceFile[i] != (char)0; i++)
+	{
+		if (szTraceFile[i] == '.')
+		{
+			szExtension = &szTraceFile[i];
+		}
+		else if ((szTraceFile[i] == '/') || (szTraceFile[i] == '\\'))
 		{
-			printf("Could not open trace file, error code %d.\n", err);
+			/* A dot in a directory name is not an extension */
+			szExtension = (const char*)0;
+		}
+	}
 
-			return TRC_FAIL;
+	if (szExtension == (const char*)0)
+	{
+		szExtension = &szTraceFile[i];
+	}
+
+	(void)snprintf(szFileName, TRC_STREAM_PORT_SEGMENT_NAME_LENGTH, "%.*s.%04u%s", (int)(szExtension - szTraceFile), szTraceFile, (unsigned int)uiSegment, szExtension);
+}
+
+/* Timestamps in the index are 64 bits, so they don't wrap during long runs */
+static uint64_t prvTraceStreamPortSegmentTimestamp(void)
+{
+	uint32_t uiTimestamp = 0u;
+	uint32_t uiWraparounds = 0u;
+
+	(void)xTraceTimestampGet(&uiTimestamp);
+	(void)xTraceTimestampGetWraparounds(&uiWraparounds);
+
+	return ((uint64_t)uiWraparounds << 32) | (uint64_t)uiTimestamp;
+}
+
+/* Rewrites the index, listing the kept segments. The current segment has no last timestamp yet. */
+static void prvTraceStreamPortSegmentWriteIndex(void)
+{
+	TraceStreamPortFileSegments_t* pxSegments = &pxStreamPortFile->xSegments;
+	TraceUnsignedBaseType_t uxFrequency = 0u;
+	char szFileName[TRC_STREAM_PORT_SEGMENT_NAME_LENGTH];
+	FILE* pxIndex;
+	uint32_t uiSegment;
+	uint32_t uiLast = pxSegments->uiSegment;
+
+	pxIndex = fopen(TRC_CFG_STREAM_PORT_SEGMENT_INDEX_FILE, "w");
+	if (pxIndex == NULL)
+	{
+		return;
+	}
+
+	(void)xTraceTimestampGetFrequency(&uxFrequency);
+
+	fprintf(pxIndex, "# Tracealyzer trace segments\n");
+	fprintf(pxIndex, "# Timestamp frequency: %lu Hz\n", (unsigned long)uxFrequency);
+	fprintf(pxIndex, "# segment first_timestamp last_timestamp file\n");
+
+	uiSegment = (uiLast + 1u > (TRC_CFG_STREAM_PORT_SEGMENT_KEEP)) ? uiLast + 1u - (TRC_CFG_STREAM_PORT_SEGMENT_KEEP) : 0u;
+	for (; uiSegment <= uiLast; uiSegment++)
+	{
+		prvTraceStreamPortSegmentName(uiSegment, szFileName);
+
+		if ((uiSegment == uiLast) && (pxStreamPortFile->pxFile != 0))
+		{
+			fprintf(pxIndex, "%u %llu - %s\n", (unsigned int)uiSegment,
+				(unsigned long long)pxSegments->ulFirstTimestamp[uiSegment % (TRC_CFG_STREAM_PORT_SEGMENT_KEEP)], szFileName);
 		}
 		else
 		{
-			printf("Trace file created.\n");
+			fprintf(pxIndex, "%u %llu %llu %s\n", (unsigned int)uiSegment,
+				(unsigned long long)pxSegments->ulFirstTimestamp[uiSegment % (TRC_CFG_STREAM_PORT_SEGMENT_KEEP)],
+				(unsigned long long)pxSegments->ulLastTimestamp[uiSegment % (TRC_CFG_STREAM_PORT_SEGMENT_KEEP)], szFileName);
 		}
-#else
-		FILE * file = fopen(TRC_CFG_STREAM_PORT_TRACE_FILE, "wb");
-		if (file == NULL)
+	}
+
+	fclose(pxIndex);
+}
+
+#endif /* (TRC_STREAM_PORT_USE_SEGMENTS == 1) */
+
+#if (TRC_STREAM_PORT_USE_WRITER_THREAD == 1)
+
+/*
+ * The recorder fills the blocks, from commits and from internal buffer
+ * transfers, and the writer thread writes them. Nothing is locked: the
+ * recorder is the only one to write uiProduced and uiFill, the writer thread
+ * the only one to write uiConsumed, and blocks are handed over with
+ * release/acquire ordering. The recorder only appends to the block being
+ * filled, so when the writer thread has been idle for
+ * TRC_CFG_STREAM_PORT_WRITER_FLUSH_MS it writes what has been filled so far
+ * without taking the block, and the rest when the block is handed over. The
+ * writer thread is only woken when a block is handed over while it waits. It
+ * never takes the recorder's critical section, which is held while the trace
+ * file is closed.
+ */
+
+traceResult xTraceStreamPortWriterCommit(void* pvData, uint32_t uiSize, int32_t* piBytesWritten)
+{
+	TraceStreamPortFileWriter_t* pxWriter = &pxStreamPortFile->xWriter;
+	uint32_t uiQueued;
+
+	*piBytesWritten = 0;
+
+	if (pxWriter->puiBlocks == 0)
+	{
+		/* Not started, nowhere to write */
+		return TRC_SUCCESS;
+	}
+
+	uiQueued = atomic_load_explicit(&pxWriter->uiProduced, memory_order_relaxed) - atomic_load_explicit(&pxWriter->uiConsumed, memory_order_acquire);
+
+	/* Events are never split between a queued block and a dropped event */
+	if (((TRC_CFG_STREAM_PORT_WRITER_BLOCK_COUNT) - uiQueued) * (TRC_CFG_STREAM_PORT_WRITER_BLOCK_SIZE) - atomic_load_explicit(&pxWriter->uiFill, memory_order_relaxed) < uiSize)
+	{
+		pxWriter->uiDroppedEvents++;
+
+		return TRC_FAIL;
+	}
+
+	*piBytesWritten = (int32_t)prvTraceStreamPortWriterCopy(pxWriter, (const uint8_t*)pvData, uiSize);
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceStreamPortWriteData(void* pvData, uint32_t uiSize, int32_t* piBytesWritten)
+{
+	TraceStreamPortFileWriter_t* pxWriter = &pxStreamPortFile->xWriter;
+
+	*piBytesWritten = 0;
+
+	if (pxWriter->puiBlocks == 0)
+	{
+		return TRC_SUCCESS;
+	}
+
+	/* The internal buffer keeps whatever doesn't fit and tries again later */
+	*piBytesWritten = (int32_t)prvTraceStreamPortWriterCopy(pxWriter, (const uint8_t*)pvData, uiSize);
+
+	return TRC_SUCCESS;
+}
+
+/* Called by the recorder only, with its critical section held */
+static uint32_t prvTraceStreamPortWriterCopy(TraceStreamPortFileWriter_t* pxWriter, const uint8_t* puiData, uint32_t uiSize)
+{
+	uint32_t uiProduced = atomic_load_explicit(&pxWriter->uiProduced, memory_order_relaxed);
+	uint32_t uiFill = atomic_load_explicit(&pxWriter->uiFill, memory_order_relaxed);
+	uint32_t uiCopied = 0;
+	uint32_t uiChunk;
+
+	while (uiCopied < uiSize)
+	{
+		if (uiProduced - atomic_load_explicit(&pxWriter->uiConsumed, memory_order_acquire) >= (TRC_CFG_STREAM_PORT_WRITER_BLOCK_COUNT))
+		{
+			/* All blocks are queued */
+			break;
+		}
+
+		uiChunk = (TRC_CFG_STREAM_PORT_WRITER_BLOCK_SIZE) - uiFill;
+		if (uiChunk > uiSize - uiCopied)
 		{
-			printf("Could not open trace file, error code %d.\n", errno);
+			uiChunk = uiSize - uiCopied;
+		}
+
+		memcpy(&pxWriter->puiBlocks[(uiProduced % (TRC_CFG_STREAM_PORT_WRITER_BLOCK_COUNT)) * (TRC_CFG_STREAM_PORT_WRITER_BLOCK_SIZE) + uiFill], &puiData[uiCopied], uiChunk);
+		uiFill += uiChunk;
+		uiCopied += uiChunk;
+
+		if (uiFill == (TRC_CFG_STREAM_PORT_WRITER_BLOCK_SIZE))
+		{
+			prvTraceStreamPortWriterPublish(pxWriter, uiFill);
+			uiProduced++;
+			uiFill = 0u;
+		}
+	}
+
+	if (uiFill > 0u)
+	{
+		/* What the writer thread may write when idle */
+		atomic_store_explicit(&pxWriter->uiFill, uiFill, memory_order_release);
+	}
+
+	return uiCopied;
+}
+
+/* Called by the recorder only. Hands over the block being filled. */
+static void prvTraceStreamPortWriterPublish(TraceStreamPortFileWriter_t* pxWriter, uint32_t uiLength)
+{
+	const uint32_t uiProduced = atomic_load_explicit(&pxWriter->uiProduced, memory_order_relaxed);
+
+	pxWriter->uiBlockLength[uiProduced % (TRC_CFG_STREAM_PORT_WRITER_BLOCK_COUNT)] = uiLength;
+
+	/* Handed over before the fill is reset, see prvTraceStreamPortWriterGetFill() */
+	atomic_store_explicit(&pxWriter->uiProduced, uiProduced + 1u, memory_order_release);
+	atomic_store_explicit(&pxWriter->uiFill, 0u, memory_order_release);
+
+	/* Only woken if it waits, a busy writer thread finds the block by itself */
+	atomic_thread_fence(memory_order_seq_cst);
+	if ((atomic_load_explicit(&pxWriter->uiWaiting, memory_order_relaxed) != 0u) &&
+		(atomic_exchange_explicit(&pxWriter->uiWaiting, 0u, memory_order_relaxed) != 0u))
+	{
+		(void)sem_post(&pxWriter->xWakeup);
+	}
+}
+
+static traceResult prvTraceStreamPortWriterWriteBlock(TraceStreamPortFileWriter_t* pxWriter, const uint8_t* puiBlock, uint32_t uiLength)
+{
+	ssize_t iWritten;
+	int iFlags;
+
+	if ((pxWriter->uiDirect != 0u) && ((uiLength % TRC_STREAM_PORT_WRITER_ALIGNMENT) != 0u))
+	{
+		/* The last block of the trace, O_DIRECT only accepts aligned sizes */
+		iFlags = fcntl(pxWriter->iFile, F_GETFL);
+		if (iFlags != -1)
+		{
+			(void)fcntl(pxWriter->iFile, F_SETFL, iFlags & ~O_DIRECT);
+		}
+		pxWriter->uiDirect = 0u;
+	}
+
+	while (uiLength > 0u)
+	{
+		iWritten = write(pxWriter->iFile, puiBlock, uiLength);
+		if (iWritten < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
 
 			return TRC_FAIL;
 		}
-		else
+
+		puiBlock += iWritten;
+		uiLength -= (uint32_t)iWritten;
+	}
+
+	return TRC_SUCCESS;
+}
+
+/* Called by the writer thread only. The bytes filled so far in the block at
+ * uiConsumed, or 0 if it has been handed over, and is written as a whole. */
+static uint32_t prvTraceStreamPortWriterGetFill(TraceStreamPortFileWriter_t* pxWriter, uint32_t uiConsumed)
+{
+	uint32_t uiFill;
+
+	if (atomic_load_explicit(&pxWriter->uiProduced, memory_order_acquire) != uiConsumed)
+	{
+		return 0u;
+	}
+
+	uiFill = atomic_load_explicit(&pxWriter->uiFill, memory_order_acquire);
+
+	/* Handed over meanwhile, the fill may be that of the next block */
+	if (atomic_load_explicit(&pxWriter->uiProduced, memory_order_acquire) != uiConsumed)
+	{
+		return 0u;
+	}
+
+	return uiFill;
+}
+
+/* Called by the writer thread only. Waits up to
+ * TRC_CFG_STREAM_PORT_WRITER_FLUSH_MS for a block to be handed over. */
+static traceResult prvTraceStreamPortWriterWait(TraceStreamPortFileWriter_t* pxWriter, uint32_t uiConsumed)
+{
+	struct timespec xTimeout;
+	traceResult xResult = TRC_SUCCESS;
+
+	(void)clock_gettime(CLOCK_REALTIME, &xTimeout);
+	xTimeout.tv_sec += (TRC_CFG_STREAM_PORT_WRITER_FLUSH_MS) / 1000;
+	xTimeout.tv_nsec += ((TRC_CFG_STREAM_PORT_WRITER_FLUSH_MS) % 1000) * 1000000L;
+	if (xTimeout.tv_nsec >= 1000000000L)
+	{
+		xTimeout.tv_sec++;
+		xTimeout.tv_nsec -= 1000000000L;
+	}
+
+	atomic_store_explicit(&pxWriter->uiWaiting, 1u, memory_order_relaxed);
+	atomic_thread_fence(memory_order_seq_cst);
+
+	/* A block handed over before uiWaiting was seen by the recorder isn't waited for */
+	if ((atomic_load_explicit(&pxWriter->uiProduced, memory_order_relaxed) == uiConsumed) &&
+		(atomic_load_explicit(&pxWriter->uiStop, memory_order_relaxed) == 0u))
+	{
+		if ((sem_timedwait(&pxWriter->xWakeup, &xTimeout) != 0) && (errno == ETIMEDOUT))
 		{
-			pxStreamPortFile->pxFile = file;
-			printf("Trace file created.\n");
+			xResult = TRC_FAIL;
 		}
+	}
+
+	atomic_store_explicit(&pxWriter->uiWaiting, 0u, memory_order_relaxed);
+
+	return xResult;
+}
+
+static void* prvTraceStreamPortWriterThread(void* pvArg)
+{
+	TraceStreamPortFileWriter_t* pxWriter = (TraceStreamPortFileWriter_t*)pvArg;
+	uint32_t uiConsumed = atomic_load_explicit(&pxWriter->uiConsumed, memory_order_relaxed);
+	uint32_t uiWritten = 0u;	/* Bytes of the block at uiConsumed written while it was being filled */
+	uint32_t uiBlocksSinceSync = 0u;
+	uint32_t uiIndex;
+	uint32_t uiFill;
+	uint32_t uiWriteFailed = 0u;
+
+	for (;;)
+	{
+		while (uiConsumed != atomic_load_explicit(&pxWriter->uiProduced, memory_order_acquire))
+		{
+			uiIndex = uiConsumed % (TRC_CFG_STREAM_PORT_WRITER_BLOCK_COUNT);
+
+			if ((uiWriteFailed == 0u) && (prvTraceStreamPortWriterWriteBlock(pxWriter, &pxWriter->puiBlocks[uiIndex * (TRC_CFG_STREAM_PORT_WRITER_BLOCK_SIZE) + uiWritten], pxWriter->uiBlockLength[uiIndex] - uiWritten) == TRC_FAIL))
+			{
+				printf("Could not write trace file, error code %d.\n", errno);
+				uiWriteFailed = 1u;
+			}
+
+			uiWritten = 0u;
+			uiConsumed++;
+			atomic_store_explicit(&pxWriter->uiConsumed, uiConsumed, memory_order_release);
+
+#if (TRC_CFG_STREAM_PORT_WRITER_SYNC_INTERVAL > 0)
+			uiBlocksSinceSync++;
+			if (uiBlocksSinceSync >= (TRC_CFG_STREAM_PORT_WRITER_SYNC_INTERVAL))
+			{
+				(void)fdatasync(pxWriter->iFile);
+				uiBlocksSinceSync = 0u;
+			}
 #endif
+		}
+
+		if (atomic_load_explicit(&pxWriter->uiStop, memory_order_acquire) != 0u)
+		{
+			/* Anything published before the stop request has been written */
+			if (uiConsumed == atomic_load_explicit(&pxWriter->uiProduced, memory_order_acquire))
+			{
+				break;
+			}
+
+			continue;
+		}
+
+		if ((prvTraceStreamPortWriterWait(pxWriter, uiConsumed) == TRC_FAIL) && (pxWriter->uiDirect == 0u))
+		{
+			/* Idle, write what has been filled so far without waiting for the block to fill up */
+			uiFill = prvTraceStreamPortWriterGetFill(pxWriter, uiConsumed);
+			if (uiFill > uiWritten)
+			{
+				uiIndex = uiConsumed % (TRC_CFG_STREAM_PORT_WRITER_BLOCK_COUNT);
+
+				if ((uiWriteFailed == 0u) && (prvTraceStreamPortWriterWriteBlock(pxWriter, &pxWriter->puiBlocks[uiIndex * (TRC_CFG_STREAM_PORT_WRITER_BLOCK_SIZE) + uiWritten], uiFill - uiWritten) == TRC_FAIL))
+				{
+					printf("Could not write trace file, error code %d.\n", errno);
+					uiWriteFailed = 1u;
+				}
+
+				uiWritten = uiFill;
+			}
+		}
 	}
-	
-	return TRC_SUCCESS;
+
+	(void)uiBlocksSinceSync;
+
+	return (void*)0;
 }
 
-traceResult xTraceStreamPortOnTraceEnd(void)
+static traceResult prvTraceStreamPortWriterOpen(void)
 {
-	if (pxStreamPortFile == 0)
+	TraceStreamPortFileWriter_t* pxWriter = &pxStreamPortFile->xWriter;
+	void* pvBlocks = (void*)0;
+	int iError;
+
+	pxWriter->uiDirect = 0u;
+	pxWriter->iFile = -1;
+
+#if (TRC_CFG_STREAM_PORT_WRITER_USE_O_DIRECT == 1)
+	pxWriter->iFile = open(TRC_CFG_STREAM_PORT_TRACE_FILE, O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+	if (pxWriter->iFile >= 0)
+	{
+		pxWriter->uiDirect = (O_DIRECT != 0) ? 1u : 0u;
+	}
+#endif
+
+	if (pxWriter->iFile < 0)
 	{
+		pxWriter->iFile = open(TRC_CFG_STREAM_PORT_TRACE_FILE, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	}
+
+	if (pxWriter->iFile < 0)
+	{
+		printf("Could not open trace file, error code %d.\n", errno);
+
 		return TRC_FAIL;
 	}
-	
-	if (pxStreamPortFile->pxFile != 0)
+
+	iError = posix_memalign(&pvBlocks, TRC_STREAM_PORT_WRITER_ALIGNMENT, (size_t)(TRC_CFG_STREAM_PORT_WRITER_BLOCK_SIZE) * (TRC_CFG_STREAM_PORT_WRITER_BLOCK_COUNT));
+	if (iError != 0)
 	{
-		fclose(pxStreamPortFile->pxFile);
-		pxStreamPortFile->pxFile = 0;
-		printf("Trace file closed.\n");
+		printf("Could not allocate trace file blocks, error code %d.\n", iError);
+		(void)close(pxWriter->iFile);
+		pxWriter->iFile = -1;
+
+		return TRC_FAIL;
 	}
-	
+
+	atomic_init(&pxWriter->uiProduced, 0u);
+	atomic_init(&pxWriter->uiFill, 0u);
+	atomic_init(&pxWriter->uiConsumed, 0u);
+	atomic_init(&pxWriter->uiWaiting, 0u);
+	atomic_init(&pxWriter->uiStop, 0u);
+	pxWriter->uiDroppedEvents = 0u;
+
+	(void)sem_init(&pxWriter->xWakeup, 0, 0u);
+
+	pxWriter->puiBlocks = (uint8_t*)pvBlocks;
+
+	iError = pthread_create(&pxWriter->xThread, (const pthread_attr_t*)0, prvTraceStreamPortWriterThread, pxWriter);
+	if (iError != 0)
+	{
+		printf("Could not create trace writer thread, error code %d.\n", iError);
+		(void)sem_destroy(&pxWriter->xWakeup);
+		pxWriter->puiBlocks = 0;
+		free(pvBlocks);
+		(void)close(pxWriter->iFile);
+		pxWriter->iFile = -1;
+
+		return TRC_FAIL;
+	}
+
+	printf("Trace file created.\n");
+
 	return TRC_SUCCESS;
 }
 
+static void prvTraceStreamPortWriterClose(void)
+{
+	TraceStreamPortFileWriter_t* pxWriter = &pxStreamPortFile->xWriter;
+
+	if (atomic_load_explicit(&pxWriter->uiFill, memory_order_relaxed) > 0u)
+	{
+		/* There is always room for the block being filled */
+		prvTraceStreamPortWriterPublish(pxWriter, atomic_load_explicit(&pxWriter->uiFill, memory_order_relaxed));
+	}
+
+	atomic_store_explicit(&pxWriter->uiStop, 1u, memory_order_release);
+	(void)sem_post(&pxWriter->xWakeup);
+	(void)pthread_join(pxWriter->xThread, (void**)0);
+
+	(void)fdatasync(pxWriter->iFile);
+	(void)close(pxWriter->iFile);
+	pxWriter->iFile = -1;
+
+	(void)sem_destroy(&pxWriter->xWakeup);
+	free(pxWriter->puiBlocks);
+	pxWriter->puiBlocks = 0;
+
+	if (pxWriter->uiDroppedEvents > 0u)
+	{
+		printf("Trace file closed, %u events dropped.\n", (unsigned int)pxWriter->uiDroppedEvents);
+	}
+	else
+	{
+		printf("Trace file closed.\n");
+	}
+}
+
+#endif /* (TRC_STREAM_PORT_USE_WRITER_THREAD == 1) */
+
 #endif /*(TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)*/
 
 #endif /*(TRC_USE_TRACEALYZER_RECORDER == 1)*/
@@ -73,6 +73,32 @@ extern "C" {
  */
 #define TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT 5
 
+/**
+ * @def TRC_CFG_STREAM_PORT_WRITE_COMBINE_SIZE
+ *
+ * @brief Only used when the internal buffer isn't. If larger than 0, the
+ * events are combined in a buffer of this size per core, which is written when
+ * it is full, when an event is stored
+ * TRC_CFG_STREAM_PORT_WRITE_COMBINE_FLUSH_PERIOD or more after the oldest one
+ * in it, and by TzCtrl. Each write to the RTT buffer takes the RTT lock and
+ * updates its write offset, so writing a few hundred bytes at a time costs
+ * less than writing every event. Set to 0 to write each event as it is stored.
+ *
+ * Default: 0
+ */
+#define TRC_CFG_STREAM_PORT_WRITE_COMBINE_SIZE 0
+
+/**
+ * @def TRC_CFG_STREAM_PORT_WRITE_COMBINE_FLUSH_PERIOD
+ *
+ * @brief The longest time, in microseconds, that an event is held in the write
+ * combine buffer while other events are being stored. When no events are
+ * stored, it is up to TzCtrl to write it.
+ *
+ * Default: 1000
+ */
+#define TRC_CFG_STREAM_PORT_WRITE_COMBINE_FLUSH_PERIOD 1000
+
 
 /**
 * @def TRC_CFG_STREAM_PORT_RTT_UP_BUFFER_SIZE
@@ -162,6 +188,22 @@ extern "C" {
  */
 #define TRC_CFG_STREAM_PORT_RTT_NO_LOCK_WRITE 0
 
+/**
+ * @def TRC_CFG_STREAM_PORT_RTT_ZERO_COPY
+ *
+ * @brief Only used when the internal buffer isn't. If 1, the events are
+ * stored directly in the RTT up buffer and made visible to the host by
+ * updating its write offset, instead of being stored in a static buffer and
+ * copied by SEGGER_RTT_Write(). An event that doesn't fit before the end of
+ * the RTT buffer, or doesn't fit at all, is still written by SEGGER_RTT_Write(),
+ * so TRC_CFG_STREAM_PORT_RTT_MODE applies as before. Requires that nothing else
+ * writes to the TRC_CFG_STREAM_PORT_RTT_UP_BUFFER_INDEX buffer. The write
+ * combine buffer isn't used when this is enabled.
+ *
+ * Default: 0
+ */
+#define TRC_CFG_STREAM_PORT_RTT_ZERO_COPY 0
+
 #ifdef __cplusplus
 }
 #endif
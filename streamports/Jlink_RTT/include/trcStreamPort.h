@@ -44,6 +44,18 @@ extern "C" {
 
 #define TRC_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT (TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT)
 
+#if (defined(TRC_CFG_STREAM_PORT_RTT_ZERO_COPY) && TRC_CFG_STREAM_PORT_RTT_ZERO_COPY == 1 && TRC_USE_INTERNAL_BUFFER == 0)
+#define TRC_STREAM_PORT_RTT_ZERO_COPY 1
+#else
+#define TRC_STREAM_PORT_RTT_ZERO_COPY 0
+#endif
+
+#if (TRC_STREAM_PORT_RTT_ZERO_COPY == 0) && defined(TRC_CFG_STREAM_PORT_WRITE_COMBINE_SIZE)
+#define TRC_WRITE_COMBINE_SIZE (TRC_CFG_STREAM_PORT_WRITE_COMBINE_SIZE)
+
+#define TRC_WRITE_COMBINE_FLUSH_PERIOD (TRC_CFG_STREAM_PORT_WRITE_COMBINE_FLUSH_PERIOD)
+#endif
+
 /* Aligned */
 #define TRC_STREAM_PORT_INTERNAL_BUFFER_SIZE ((((TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_SIZE) + sizeof(TraceUnsignedBaseType_t) - 1) / sizeof(TraceUnsignedBaseType_t)) * sizeof(TraceUnsignedBaseType_t))
 
@@ -79,7 +91,8 @@ typedef struct TraceStreamPortBuffer	/* Aligned */
 traceResult xTraceStreamPortInitialize(TraceStreamPortBuffer_t* pxBuffer);
 
 /**
- * @brief Allocates data from the stream port.
+ * @brief Allocates data from the stream port. With TRC_CFG_STREAM_PORT_RTT_ZERO_COPY
+ * the data is allocated in the RTT up buffer if it fits there without wrapping.
  * 
  * @param[in] uiSize Allocation size
  * @param[out] ppvData Allocation data pointer
@@ -93,6 +106,10 @@ traceResult xTraceStreamPortInitialize(TraceStreamPortBuffer_t* pxBuffer);
 	#else
 		#define xTraceStreamPortAllocate(uiSize, ppvData) ((void)(uiSize), xTraceInternalEventBufferAlloc(uiSize, ppvData))
 	#endif
+#elif (TRC_STREAM_PORT_RTT_ZERO_COPY == 1)
+	traceResult xTraceStreamPortAllocate(uint32_t uiSize, void** ppvData);
+#elif defined(TRC_WRITE_COMBINE_SIZE) && ((TRC_WRITE_COMBINE_SIZE) > 0)
+	#define xTraceStreamPortAllocate xTraceWriteCombineAlloc
 #else
 	#define xTraceStreamPortAllocate(uiSize, ppvData) ((void)(uiSize), xTraceStaticBufferGet(ppvData))
 #endif
@@ -101,6 +118,8 @@ traceResult xTraceStreamPortInitialize(TraceStreamPortBuffer_t* pxBuffer);
  * @brief Commits data to the stream port, depending on the implementation/configuration of the
  * stream port this data might be directly written to the stream port interface, buffered, or
  * something else.
+ * With TRC_CFG_STREAM_PORT_RTT_ZERO_COPY, data allocated in the RTT up buffer
+ * is made visible to the host by updating its write offset.
  * 
  * @param[in] pvData Data to commit
  * @param[in] uiSize Data to commit size
@@ -115,6 +134,10 @@ traceResult xTraceStreamPortInitialize(TraceStreamPortBuffer_t* pxBuffer);
 	#else
 		#define xTraceStreamPortCommit xTraceInternalEventBufferAllocCommit
 	#endif
+#elif (TRC_STREAM_PORT_RTT_ZERO_COPY == 1)
+	traceResult xTraceStreamPortCommit(void* pvData, uint32_t uiSize, int32_t* piBytesCommitted);
+#elif defined(TRC_WRITE_COMBINE_SIZE) && ((TRC_WRITE_COMBINE_SIZE) > 0)
+	#define xTraceStreamPortCommit xTraceWriteCombineCommit
 #else
 	#define xTraceStreamPortCommit xTraceStreamPortWriteData
 #endif
@@ -58,6 +58,73 @@ traceResult xTraceStreamPortOnEnable(uint32_t uiStartOption)
 	return TRC_SUCCESS;
 }
 
+#if (TRC_STREAM_PORT_RTT_ZERO_COPY == 1)
+
+/* Accessed uncached, like SEGGER_RTT.c does, so that the host sees the data */
+#define TRC_STREAM_PORT_RTT_UP_RING() ((volatile SEGGER_RTT_BUFFER_UP*)((uintptr_t)&_SEGGER_RTT.aUp[TRC_CFG_STREAM_PORT_RTT_UP_BUFFER_INDEX] + SEGGER_RTT_UNCACHED_OFF))
+
+/* Called by the recorder within its critical section, the matching commit
+ * follows before the critical section is left */
+traceResult xTraceStreamPortAllocate(uint32_t uiSize, void** ppvData)
+{
+	volatile SEGGER_RTT_BUFFER_UP* pxRing = TRC_STREAM_PORT_RTT_UP_RING();
+	uint32_t uiWrOff = pxRing->WrOff;
+	uint32_t uiRdOff = pxRing->RdOff;	/* May be changed by the host */
+	uint32_t uiContiguous;
+
+	/* One byte is always left free, so that a full buffer isn't mistaken for an empty one */
+	if (uiRdOff > uiWrOff)
+	{
+		uiContiguous = uiRdOff - uiWrOff - 1u;
+	}
+	else if (uiRdOff == 0u)
+	{
+		uiContiguous = pxRing->SizeOfBuffer - uiWrOff - 1u;
+	}
+	else
+	{
+		uiContiguous = pxRing->SizeOfBuffer - uiWrOff;
+	}
+
+	if (uiSize <= uiContiguous)
+	{
+		*ppvData = (void*)((pxRing->pBuffer + uiWrOff) + SEGGER_RTT_UNCACHED_OFF);
+
+		return TRC_SUCCESS;
+	}
+
+	/* It would wrap, or there isn't room for it. SEGGER_RTT_Write() copies it on
+	 * commit, wrapping, skipping or blocking according to the RTT mode. */
+	return xTraceStaticBufferGet(ppvData);
+}
+
+traceResult xTraceStreamPortCommit(void* pvData, uint32_t uiSize, int32_t* piBytesCommitted)
+{
+	volatile SEGGER_RTT_BUFFER_UP* pxRing = TRC_STREAM_PORT_RTT_UP_RING();
+	uint32_t uiWrOff = pxRing->WrOff;
+
+	if (pvData != (void*)((pxRing->pBuffer + uiWrOff) + SEGGER_RTT_UNCACHED_OFF))
+	{
+		/* Allocated from the static buffer */
+		return xTraceStreamPortWriteData(pvData, uiSize, piBytesCommitted);
+	}
+
+	uiWrOff += uiSize;
+	if (uiWrOff == pxRing->SizeOfBuffer)
+	{
+		uiWrOff = 0u;
+	}
+
+	RTT__DMB();		/* The data must be written before the host sees the new WrOff */
+	pxRing->WrOff = uiWrOff;
+
+	*piBytesCommitted = (int32_t)uiSize;
+
+	return TRC_SUCCESS;
+}
+
+#endif
+
 #endif
 
 #endif
@@ -0,0 +1,75 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * The configuration for trace streaming ("stream ports").
+ */
+
+#ifndef TRC_STREAM_PORT_CONFIG_H
+#define TRC_STREAM_PORT_CONFIG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @def TRC_CFG_STREAM_PORT_TRACE_FILE
+ *
+ * @brief Defines the trace file name
+ */
+#ifndef TRC_CFG_STREAM_PORT_TRACE_FILE
+#define TRC_CFG_STREAM_PORT_TRACE_FILE "trace.psf"
+#endif
+
+/**
+ * @def TRC_CFG_STREAM_PORT_MAPPED_FILE_EXTENT_SIZE
+ *
+ * @brief The file is preallocated in extents of this size as the trace grows.
+ * Must be a multiple of the page size.
+ */
+#ifndef TRC_CFG_STREAM_PORT_MAPPED_FILE_EXTENT_SIZE
+#define TRC_CFG_STREAM_PORT_MAPPED_FILE_EXTENT_SIZE (16 * 1024 * 1024)
+#endif
+
+/**
+ * @def TRC_CFG_STREAM_PORT_MAPPED_FILE_WINDOW_SIZE
+ *
+ * @brief The size of the part of the file that is mapped at a time. The window
+ * slides forward when an event doesn't fit. Must be a multiple of the page
+ * size, and larger than the largest event (the entry table) plus one page.
+ */
+#ifndef TRC_CFG_STREAM_PORT_MAPPED_FILE_WINDOW_SIZE
+#define TRC_CFG_STREAM_PORT_MAPPED_FILE_WINDOW_SIZE (64 * 1024 * 1024)
+#endif
+
+/**
+ * @def TRC_CFG_STREAM_PORT_MAPPED_FILE_KEEP_HEADER
+ *
+ * @brief The file begins with a page holding the recovery header, which is
+ * updated on every commit. When the trace ends normally, this page is removed
+ * so that the file is a plain .psf file, if the file system supports it. Set
+ * to 1 to always keep the header.
+ */
+#ifndef TRC_CFG_STREAM_PORT_MAPPED_FILE_KEEP_HEADER
+#define TRC_CFG_STREAM_PORT_MAPPED_FILE_KEEP_HEADER 0
+#endif
+
+/**
+ * @def TRC_CFG_STREAM_PORT_MAPPED_FILE_RETRY_INTERVAL
+ *
+ * @brief After the file couldn't be extended (e.g. the disk is full) or a
+ * window couldn't be mapped, events are dropped and this is tried again after
+ * this many events. The dropped events are counted in the recovery header.
+ */
+#ifndef TRC_CFG_STREAM_PORT_MAPPED_FILE_RETRY_INTERVAL
+#define TRC_CFG_STREAM_PORT_MAPPED_FILE_RETRY_INTERVAL 1000
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRC_STREAM_PORT_CONFIG_H */
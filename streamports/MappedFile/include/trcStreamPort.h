@@ -0,0 +1,171 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * The interface definitions for trace streaming ("stream ports").
+ * This "stream port" sets up the recorder to write the trace straight into a
+ * memory mapped file (POSIX hosts and simulators).
+ */
+
+#ifndef TRC_STREAM_PORT_H
+#define TRC_STREAM_PORT_H
+
+#if (TRC_USE_TRACEALYZER_RECORDER == 1)
+
+#if (TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)
+
+#include <stdint.h>
+#include <trcTypes.h>
+#include <trcStreamPortConfig.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TRC_USE_INTERNAL_BUFFER 0
+
+/* Default file name */
+#ifndef TRC_CFG_STREAM_PORT_TRACE_FILE
+#define TRC_CFG_STREAM_PORT_TRACE_FILE "trace.psf"
+#endif
+
+#ifndef TRC_CFG_STREAM_PORT_MAPPED_FILE_RETRY_INTERVAL
+#define TRC_CFG_STREAM_PORT_MAPPED_FILE_RETRY_INTERVAL 1000
+#endif
+
+/**
+ * @def TRC_STREAM_PORT_MAPPED_FILE_HEADER_SIZE
+ * @brief Size of the recovery header in front of the trace data. One page, so
+ * that the trace data is page aligned in the file.
+ */
+#define TRC_STREAM_PORT_MAPPED_FILE_HEADER_SIZE 4096u
+
+#define TRC_STREAM_PORT_MAPPED_FILE_MAGIC "TRCMMAP"
+
+#define TRC_STREAM_PORT_MAPPED_FILE_VERSION 2u
+
+/**
+ * @brief The recovery header at the start of the file. ulCommitted is updated
+ * on every commit, so if the traced process crashes the trace can be recovered
+ * by taking ulCommitted bytes starting at uiDataOffset, see
+ * extras/MappedFileRecovery. Version 1 had no uiDroppedEvents.
+ */
+typedef struct TraceStreamPortMappedFileHeader
+{
+	char cMagic[8];				/* TRC_STREAM_PORT_MAPPED_FILE_MAGIC */
+	uint32_t uiVersion;			/* TRC_STREAM_PORT_MAPPED_FILE_VERSION */
+	uint32_t uiDataOffset;		/* TRC_STREAM_PORT_MAPPED_FILE_HEADER_SIZE */
+	uint64_t ulCommitted;		/* Bytes of trace data */
+	uint32_t uiClosed;			/* 1 when the trace ended normally */
+	uint32_t uiDroppedEvents;	/* Events dropped because the file couldn't be extended or mapped */
+} TraceStreamPortMappedFileHeader_t;
+
+typedef struct TraceStreamPortMappedFile	/* Aligned */
+{
+	TraceStreamPortMappedFileHeader_t* pxHeader;
+	uint8_t* puiWindow;			/* Mapping of the trace data from ulWindowOffset */
+	uint64_t ulWindowOffset;	/* Offset in the trace data, page aligned */
+	uint64_t ulAllocated;		/* Bytes of trace data preallocated in the file */
+	uint64_t ulCommitted;
+	uint32_t uiDroppedEvents;
+	uint32_t uiFailures;		/* Failed attempts to extend or map the file */
+	uint32_t uiFailing;			/* 1 from a failure until a retry succeeds */
+	uint32_t uiRetryCountdown;	/* Events to drop before trying again */
+	int32_t iLastError;			/* errno of the last failure */
+	int32_t iFile;
+} TraceStreamPortMappedFile_t;
+
+extern TraceStreamPortMappedFile_t* pxStreamPortMappedFile;
+
+#define TRC_STREAM_PORT_BUFFER_SIZE (sizeof(TraceStreamPortMappedFile_t))
+
+typedef struct TraceStreamPortBuffer
+{
+	uint8_t buffer[TRC_STREAM_PORT_BUFFER_SIZE];
+} TraceStreamPortBuffer_t;
+
+/**
+ * @internal Stream port initialize callback.
+ *
+ * This function is called by the recorder as part of its initialization phase.
+ *
+ * @param[in] pxBuffer Buffer
+ *
+ * @retval TRC_FAIL Initialization failed
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortInitialize(TraceStreamPortBuffer_t* pxBuffer);
+
+/**
+ * @brief Allocates data from the stream port. Returns a pointer straight into
+ * the file mapping, the window is moved forward and the file is extended if
+ * needed. If no file is mapped, the static buffer is used and the event is
+ * dropped on commit. After the file couldn't be extended or mapped, this is
+ * tried again every TRC_CFG_STREAM_PORT_MAPPED_FILE_RETRY_INTERVAL events.
+ *
+ * @param[in] uiSize Allocation size
+ * @param[out] ppvData Allocation data pointer
+ *
+ * @retval TRC_FAIL Allocate failed
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortAllocate(uint32_t uiSize, void** ppvData);
+
+/**
+ * @brief Commits data to the stream port. The data is already in the file, so
+ * this only publishes the new end of the trace in the recovery header.
+ *
+ * @param[in] pvData Data to commit
+ * @param[in] uiSize Data to commit size
+ * @param[out] piBytesCommitted Bytes committed
+ *
+ * @retval TRC_FAIL Commit failed
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortCommit(void* pvData, uint32_t uiSize, int32_t* piBytesCommitted);
+
+/**
+ * @brief Writes data through the stream port interface. Not used since there
+ * is no internal buffer.
+ *
+ * @param[in] pvData Data to write
+ * @param[in] uiSize Data to write size
+ * @param[out] piBytesWritten Bytes written
+ *
+ * @retval TRC_FAIL Write failed
+ * @retval TRC_SUCCESS Success
+ */
+#define xTraceStreamPortWriteData(pvData, uiSize, piBytesWritten) ((void)(pvData), (void)(uiSize), *(piBytesWritten) = 0, TRC_SUCCESS)
+
+/**
+ * @brief Reads data through the stream port interface.
+ *
+ * @param[in] pvData Destination data buffer
+ * @param[in] uiSize Destination data buffer size
+ * @param[out] piBytesRead Bytes read
+ *
+ * @retval TRC_FAIL Read failed
+ * @retval TRC_SUCCESS Success
+ */
+#define xTraceStreamPortReadData(pvData, uiSize, piBytesRead) ((void)(pvData), (void)(uiSize), (void)(piBytesRead), TRC_SUCCESS)
+
+#define xTraceStreamPortOnEnable(uiStartOption) ((void)(uiStartOption), TRC_SUCCESS)
+
+#define xTraceStreamPortOnDisable() (TRC_SUCCESS)
+
+traceResult xTraceStreamPortOnTraceBegin(void);
+
+traceResult xTraceStreamPortOnTraceEnd(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*(TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)*/
+
+#endif /*(TRC_USE_TRACEALYZER_RECORDER == 1)*/
+
+#endif /* TRC_STREAM_PORT_H */
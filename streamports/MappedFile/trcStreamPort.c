@@ -0,0 +1,335 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Supporting functions for trace streaming, used by the "stream ports"
+ * for reading and writing data to the interface.
+ * This stream port writes the trace straight into a memory mapped file.
+ */
+
+#include <trcRecorder.h>
+
+#if (TRC_USE_TRACEALYZER_RECORDER == 1)
+
+#if (TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)
+
+#if defined(_WIN32)
+#error "The MappedFile stream port requires a POSIX host."
+#endif
+
+#if (((TRC_CFG_STREAM_PORT_MAPPED_FILE_EXTENT_SIZE) % 4096) != 0) || (((TRC_CFG_STREAM_PORT_MAPPED_FILE_WINDOW_SIZE) % 4096) != 0)
+#error "TRC_CFG_STREAM_PORT_MAPPED_FILE_EXTENT_SIZE and TRC_CFG_STREAM_PORT_MAPPED_FILE_WINDOW_SIZE must be multiples of the page size."
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define TRC_STREAM_PORT_MAPPED_FILE_PAGE_MASK ((uint64_t)(TRC_STREAM_PORT_MAPPED_FILE_HEADER_SIZE) - 1u)
+
+TraceStreamPortMappedFile_t* pxStreamPortMappedFile TRC_CFG_RECORDER_DATA_ATTRIBUTE;
+
+static traceResult prvTraceStreamPortMappedFileMoveWindow(uint32_t uiSize);
+static void prvTraceStreamPortMappedFileUnmap(void);
+static void prvTraceStreamPortMappedFileFailed(const char* szWhat, int iError);
+
+traceResult xTraceStreamPortInitialize(TraceStreamPortBuffer_t* pxBuffer)
+{
+	TRC_ASSERT_EQUAL_SIZE(TraceStreamPortBuffer_t, TraceStreamPortMappedFile_t);
+
+	TRC_ASSERT(pxBuffer != 0);
+
+	pxStreamPortMappedFile = (TraceStreamPortMappedFile_t*)pxBuffer; /*cstat !MISRAC2004-11.4 !MISRAC2012-Rule-11.3 Suppress conversion between pointer types checks*/
+	pxStreamPortMappedFile->pxHeader = 0;
+	pxStreamPortMappedFile->puiWindow = 0;
+	pxStreamPortMappedFile->iFile = -1;
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceStreamPortAllocate(uint32_t uiSize, void** ppvData)
+{
+	TraceStreamPortMappedFile_t* pxFile = pxStreamPortMappedFile;
+
+	if ((pxFile->puiWindow != 0) && (pxFile->ulCommitted + uiSize > pxFile->ulWindowOffset + (TRC_CFG_STREAM_PORT_MAPPED_FILE_WINDOW_SIZE) || pxFile->ulCommitted + uiSize > pxFile->ulAllocated))
+	{
+		(void)prvTraceStreamPortMappedFileMoveWindow(uiSize);
+	}
+
+	if ((pxFile->puiWindow == 0) && (pxFile->pxHeader != 0))
+	{
+		/* The file couldn't be extended or mapped, try again now and then */
+		if (pxFile->uiRetryCountdown == 0u)
+		{
+			(void)prvTraceStreamPortMappedFileMoveWindow(uiSize);
+		}
+		else
+		{
+			pxFile->uiRetryCountdown--;
+		}
+	}
+
+	if (pxFile->puiWindow == 0)
+	{
+		/* No file, or it couldn't be extended. The event is dropped on commit. */
+		TRC_ASSERT(uiSize <= TRC_MAX_BLOB_SIZE);
+
+		return xTraceStaticBufferGet(ppvData);
+	}
+
+	*ppvData = (void*)&pxFile->puiWindow[pxFile->ulCommitted - pxFile->ulWindowOffset];
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceStreamPortCommit(void* pvData, uint32_t uiSize, int32_t* piBytesCommitted)
+{
+	TraceStreamPortMappedFile_t* pxFile = pxStreamPortMappedFile;
+
+	if ((pxFile->puiWindow == 0) || ((uint8_t*)pvData != &pxFile->puiWindow[pxFile->ulCommitted - pxFile->ulWindowOffset]))
+	{
+		pxFile->uiDroppedEvents++;
+		if (pxFile->pxHeader != 0)
+		{
+			pxFile->pxHeader->uiDroppedEvents = pxFile->uiDroppedEvents;
+		}
+		*piBytesCommitted = 0;
+
+		return TRC_SUCCESS;
+	}
+
+	pxFile->ulCommitted += uiSize;
+
+	/* The event data is written before the new end is visible to a reader of the file */
+	__atomic_store_n(&pxFile->pxHeader->ulCommitted, pxFile->ulCommitted, __ATOMIC_RELEASE);
+
+	*piBytesCommitted = (int32_t)uiSize;
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceStreamPortOnTraceBegin(void)
+{
+	TraceStreamPortMappedFile_t* pxFile = pxStreamPortMappedFile;
+	void* pvMapping;
+	int iError;
+
+	if (pxFile == 0)
+	{
+		return TRC_FAIL;
+	}
+
+	if (pxFile->iFile >= 0)
+	{
+		return TRC_SUCCESS;
+	}
+
+	pxFile->iFile = open(TRC_CFG_STREAM_PORT_TRACE_FILE, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (pxFile->iFile < 0)
+	{
+		printf("Could not open trace file, error code %d.\n", errno);
+
+		return TRC_FAIL;
+	}
+
+	iError = posix_fallocate(pxFile->iFile, 0, (off_t)(TRC_STREAM_PORT_MAPPED_FILE_HEADER_SIZE));
+	if (iError == 0)
+	{
+		pvMapping = mmap((void*)0, TRC_STREAM_PORT_MAPPED_FILE_HEADER_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, pxFile->iFile, 0);
+		iError = (pvMapping == MAP_FAILED) ? errno : 0;
+	}
+
+	if (iError != 0)
+	{
+		printf("Could not map trace file, error code %d.\n", iError);
+		(void)close(pxFile->iFile);
+		pxFile->iFile = -1;
+
+		return TRC_FAIL;
+	}
+
+	pxFile->pxHeader = (TraceStreamPortMappedFileHeader_t*)pvMapping;
+	(void)memcpy(pxFile->pxHeader->cMagic, TRC_STREAM_PORT_MAPPED_FILE_MAGIC, sizeof(TRC_STREAM_PORT_MAPPED_FILE_MAGIC));
+	pxFile->pxHeader->uiVersion = TRC_STREAM_PORT_MAPPED_FILE_VERSION;
+	pxFile->pxHeader->uiDataOffset = TRC_STREAM_PORT_MAPPED_FILE_HEADER_SIZE;
+	pxFile->pxHeader->ulCommitted = 0u;
+	pxFile->pxHeader->uiClosed = 0u;
+	pxFile->pxHeader->uiDroppedEvents = 0u;
+
+	pxFile->puiWindow = 0;
+	pxFile->ulWindowOffset = 0u;
+	pxFile->ulAllocated = 0u;
+	pxFile->ulCommitted = 0u;
+	pxFile->uiDroppedEvents = 0u;
+	pxFile->uiFailures = 0u;
+	pxFile->uiFailing = 0u;
+	pxFile->uiRetryCountdown = 0u;
+	pxFile->iLastError = 0;
+
+	if (prvTraceStreamPortMappedFileMoveWindow(0u) == TRC_FAIL)
+	{
+		(void)munmap((void*)pxFile->pxHeader, TRC_STREAM_PORT_MAPPED_FILE_HEADER_SIZE);
+		pxFile->pxHeader = 0;
+		(void)close(pxFile->iFile);
+		pxFile->iFile = -1;
+
+		return TRC_FAIL;
+	}
+
+	printf("Trace file created.\n");
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceStreamPortOnTraceEnd(void)
+{
+	TraceStreamPortMappedFile_t* pxFile = pxStreamPortMappedFile;
+	uint32_t uiHeaderRemoved = 0u;
+
+	if (pxFile == 0)
+	{
+		return TRC_FAIL;
+	}
+
+	if (pxFile->iFile < 0)
+	{
+		return TRC_SUCCESS;
+	}
+
+	prvTraceStreamPortMappedFileUnmap();
+
+	pxFile->pxHeader->uiClosed = 1u;
+	(void)munmap((void*)pxFile->pxHeader, TRC_STREAM_PORT_MAPPED_FILE_HEADER_SIZE);
+	pxFile->pxHeader = 0;
+
+	/* Drop the preallocated space that wasn't used */
+	(void)ftruncate(pxFile->iFile, (off_t)(TRC_STREAM_PORT_MAPPED_FILE_HEADER_SIZE + pxFile->ulCommitted));
+
+#if (TRC_CFG_STREAM_PORT_MAPPED_FILE_KEEP_HEADER == 0) && defined(FALLOC_FL_COLLAPSE_RANGE)
+	/* Turn the file into a plain .psf file without moving any data */
+	if ((pxFile->ulCommitted > 0u) && (fallocate(pxFile->iFile, FALLOC_FL_COLLAPSE_RANGE, 0, (off_t)(TRC_STREAM_PORT_MAPPED_FILE_HEADER_SIZE)) == 0))
+	{
+		uiHeaderRemoved = 1u;
+	}
+#endif
+
+	(void)close(pxFile->iFile);
+	pxFile->iFile = -1;
+
+	if (uiHeaderRemoved == 0u)
+	{
+		printf("Trace file closed, the trace data starts at offset %u.\n", (unsigned int)(TRC_STREAM_PORT_MAPPED_FILE_HEADER_SIZE));
+	}
+	else
+	{
+		printf("Trace file closed.\n");
+	}
+
+	if (pxFile->uiDroppedEvents > 0u)
+	{
+		printf("%u events were dropped, the file couldn't be extended or mapped %u times, last error code %d.\n",
+			(unsigned int)pxFile->uiDroppedEvents, (unsigned int)pxFile->uiFailures, (int)pxFile->iLastError);
+	}
+
+	return TRC_SUCCESS;
+}
+
+/* Maps a new window starting at the page holding the end of the trace, extending the file if needed */
+static traceResult prvTraceStreamPortMappedFileMoveWindow(uint32_t uiSize)
+{
+	TraceStreamPortMappedFile_t* pxFile = pxStreamPortMappedFile;
+	uint64_t ulWindowOffset = pxFile->ulCommitted & ~TRC_STREAM_PORT_MAPPED_FILE_PAGE_MASK;
+	uint64_t ulAllocated = pxFile->ulAllocated;
+	void* pvMapping;
+	int iError = 0;
+
+	TRC_ASSERT(pxFile->ulCommitted + uiSize <= ulWindowOffset + (TRC_CFG_STREAM_PORT_MAPPED_FILE_WINDOW_SIZE));
+
+	while (pxFile->ulCommitted + uiSize > ulAllocated)
+	{
+		ulAllocated += (TRC_CFG_STREAM_PORT_MAPPED_FILE_EXTENT_SIZE);
+	}
+
+	if (ulAllocated != pxFile->ulAllocated)
+	{
+		/* Reserve the disk space now, so running out of space fails here and not as a SIGBUS when writing to the mapping */
+		iError = posix_fallocate(pxFile->iFile, (off_t)(TRC_STREAM_PORT_MAPPED_FILE_HEADER_SIZE + pxFile->ulAllocated), (off_t)(ulAllocated - pxFile->ulAllocated));
+		if (iError != 0)
+		{
+			prvTraceStreamPortMappedFileUnmap();
+			prvTraceStreamPortMappedFileFailed("extend", iError);
+
+			return TRC_FAIL;
+		}
+
+		pxFile->ulAllocated = ulAllocated;
+	}
+
+	if ((pxFile->puiWindow != 0) && (ulWindowOffset == pxFile->ulWindowOffset))
+	{
+		/* Only the file was extended, the mapping already covers it */
+		return TRC_SUCCESS;
+	}
+
+	prvTraceStreamPortMappedFileUnmap();
+
+	/* Pages past the end of the file are mapped, but never written before the file is extended to cover them */
+	pvMapping = mmap((void*)0, TRC_CFG_STREAM_PORT_MAPPED_FILE_WINDOW_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, pxFile->iFile, (off_t)(TRC_STREAM_PORT_MAPPED_FILE_HEADER_SIZE + ulWindowOffset));
+	if (pvMapping == MAP_FAILED)
+	{
+		prvTraceStreamPortMappedFileFailed("map", errno);
+
+		return TRC_FAIL;
+	}
+
+	(void)madvise(pvMapping, TRC_CFG_STREAM_PORT_MAPPED_FILE_WINDOW_SIZE, MADV_SEQUENTIAL);
+
+	pxFile->puiWindow = (uint8_t*)pvMapping;
+	pxFile->ulWindowOffset = ulWindowOffset;
+
+	if (pxFile->uiFailing != 0u)
+	{
+		pxFile->uiFailing = 0u;
+		printf("Trace file writable again, %u events were dropped.\n", (unsigned int)pxFile->uiDroppedEvents);
+	}
+
+	return TRC_SUCCESS;
+}
+
+/* Reports the first of a series of failures, the events are dropped until a retry succeeds */
+static void prvTraceStreamPortMappedFileFailed(const char* szWhat, int iError)
+{
+	TraceStreamPortMappedFile_t* pxFile = pxStreamPortMappedFile;
+
+	if (pxFile->uiFailing == 0u)
+	{
+		printf("Could not %s trace file, error code %d, dropping events.\n", szWhat, iError);
+		pxFile->uiFailing = 1u;
+	}
+
+	pxFile->uiFailures++;
+	pxFile->iLastError = (int32_t)iError;
+	pxFile->uiRetryCountdown = (TRC_CFG_STREAM_PORT_MAPPED_FILE_RETRY_INTERVAL);
+}
+
+static void prvTraceStreamPortMappedFileUnmap(void)
+{
+	TraceStreamPortMappedFile_t* pxFile = pxStreamPortMappedFile;
+
+	if (pxFile->puiWindow != 0)
+	{
+		/* The kernel writes back the dirty pages, also if the process is killed */
+		(void)munmap((void*)pxFile->puiWindow, TRC_CFG_STREAM_PORT_MAPPED_FILE_WINDOW_SIZE);
+		pxFile->puiWindow = 0;
+	}
+}
+
+#endif /*(TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)*/
+
+#endif /*(TRC_USE_TRACEALYZER_RECORDER == 1)*/
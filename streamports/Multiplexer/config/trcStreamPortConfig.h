@@ -0,0 +1,44 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * The configuration for trace streaming ("stream ports").
+ */
+
+#ifndef TRC_STREAM_PORT_CONFIG_H
+#define TRC_STREAM_PORT_CONFIG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @def TRC_CFG_STREAM_PORT_MUX_BUFFER_SIZE
+ *
+ * @brief The size of the ring buffers that the sinks are written from,
+ * divided evenly between the cores. The primary sink must keep up with the
+ * event rate over the time it takes to fill a core's share, or events are
+ * dropped. Secondary sinks that don't keep up lose the oldest events instead.
+ */
+#ifndef TRC_CFG_STREAM_PORT_MUX_BUFFER_SIZE
+#define TRC_CFG_STREAM_PORT_MUX_BUFFER_SIZE 10240
+#endif
+
+/**
+ * @def TRC_CFG_STREAM_PORT_MUX_SINK_COUNT
+ *
+ * @brief The maximum number of sinks, primary included. Each sink takes a
+ * cursor per core, of about 100 bytes.
+ */
+#ifndef TRC_CFG_STREAM_PORT_MUX_SINK_COUNT
+#define TRC_CFG_STREAM_PORT_MUX_SINK_COUNT 3
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRC_STREAM_PORT_CONFIG_H */
@@ -0,0 +1,259 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * The interface definitions for trace streaming ("stream ports").
+ * This "stream port" fans the trace out to a number of sinks, e.g., live
+ * streaming to the host and a local copy for crash analysis. The events are
+ * written once, to a ring buffer per core, and each sink has its own cursor
+ * into it. The first sink added is the primary, it gets every event that is
+ * recorded. The others are secondary, they are overrun rather than holding up
+ * the recorder or each other when they fall behind.
+ */
+
+#ifndef TRC_STREAM_PORT_H
+#define TRC_STREAM_PORT_H
+
+#if (TRC_USE_TRACEALYZER_RECORDER == 1)
+
+#if (TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)
+
+#include <stdint.h>
+#include <trcTypes.h>
+#include <trcStreamPortConfig.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @def TRC_USE_INTERNAL_BUFFER
+ *
+ * @brief This Stream Port writes the events to its own ring buffers directly.
+ */
+#define TRC_USE_INTERNAL_BUFFER 0
+
+#define TRC_STREAM_PORT_MUX_BUFFER_SIZE (((uint32_t)(TRC_CFG_STREAM_PORT_MUX_BUFFER_SIZE) / sizeof(TraceUnsignedBaseType_t)) * sizeof(TraceUnsignedBaseType_t))	/* aligned */
+
+/* The largest event, a TraceEvent0_t with 15 parameters */
+#define TRC_STREAM_PORT_MUX_MAX_EVENT_SIZE (8u + (15u * sizeof(TraceUnsignedBaseType_t)))
+
+/**
+ * @brief Writes trace data to a sink. Must not block, write what fits now and
+ * report it in piBytesWritten. The rest is offered again on the next call.
+ *
+ * @param[in] pvContext The sink's context
+ * @param[in] pvData Data to write
+ * @param[in] uiSize Data to write size
+ * @param[out] piBytesWritten Bytes written
+ *
+ * @retval TRC_FAIL The sink failed
+ * @retval TRC_SUCCESS Success
+ */
+typedef traceResult (*TraceStreamPortMuxWrite_t)(void* pvContext, void* pvData, uint32_t uiSize, int32_t* piBytesWritten);
+
+/**
+ * @brief Reads a command from the host through a sink. Must not block.
+ *
+ * @param[in] pvContext The sink's context
+ * @param[in] pvData Destination data buffer
+ * @param[in] uiSize Destination data buffer size
+ * @param[out] piBytesRead Bytes read
+ *
+ * @retval TRC_FAIL The sink failed
+ * @retval TRC_SUCCESS Success
+ */
+typedef traceResult (*TraceStreamPortMuxRead_t)(void* pvContext, void* pvData, uint32_t uiSize, int32_t* piBytesRead);
+
+typedef struct TraceStreamPortMuxSink
+{
+	TraceStreamPortMuxWrite_t xWrite;
+	TraceStreamPortMuxRead_t xRead;		/* Can be null */
+	void* pvContext;
+} TraceStreamPortMuxSink_t;
+
+typedef struct TraceStreamPortMuxSinkStatistics
+{
+	uint32_t uiBytesWritten;
+	uint32_t uiLostEvents;			/* Overwritten before the sink got them, secondary sinks only */
+	uint32_t uiFailed;				/* The sink has failed and isn't written to any more */
+	uint32_t uiPartialEventBytes;	/* Written of an event the sink is in the middle of, cut these off when closing it */
+} TraceStreamPortMuxSinkStatistics_t;
+
+/* A sink's position in a core's ring buffer */
+typedef struct TraceStreamPortMuxCursor	/* Aligned */
+{
+	uint32_t uiPosition;			/* Next byte to write to the sink */
+	uint32_t uiEventStart;			/* Start of the event uiPosition is in, once past the preamble */
+	uint32_t uiEventEnd;			/* End of the event uiPosition is in, once past the preamble */
+	uint32_t uiSessionBytes;		/* Written since the trace began, saturates */
+	uint32_t uiClaimed;				/* Being written, it can't be overrun */
+	uint32_t uiCarryLength;
+	uint32_t uiCarryPosition;
+	uint32_t uiCarryStart;			/* Written of the carried event before it was carried */
+	uint8_t uiCarry[TRC_STREAM_PORT_MUX_MAX_EVENT_SIZE];	/* The rest of an event the sink was in when it was overrun */
+} TraceStreamPortMuxCursor_t;
+
+typedef struct TraceStreamPortMuxRing	/* Aligned */
+{
+	uint32_t uiHead;
+	uint32_t uiNextHead;
+	uint32_t uiSize;
+	uint32_t uiSlack;
+	uint32_t uiPreambleSize;		/* Header, timestamp info and entry table, stored when the trace began */
+	uint32_t uiSession;				/* Changes when the ring is cleared */
+	uint32_t uiDroppedEvents;
+	uint32_t uiReserved;
+	TraceStreamPortMuxCursor_t xCursors[TRC_CFG_STREAM_PORT_MUX_SINK_COUNT];
+	uint8_t* puiBuffer;
+} TraceStreamPortMuxRing_t;
+
+typedef struct TraceStreamPortMuxSinkState	/* Aligned */
+{
+	TraceStreamPortMuxSink_t xSink;
+	TraceStreamPortMuxSinkStatistics_t xStatistics;
+	uint32_t uiCore;				/* The ring being written, the sink stays on it until it is between events */
+} TraceStreamPortMuxSinkState_t;
+
+typedef struct TraceStreamPortMux	/* Aligned */
+{
+	TraceStreamPortMuxSinkState_t xSinks[TRC_CFG_STREAM_PORT_MUX_SINK_COUNT];
+	TraceUnsignedBaseType_t uxSinkCount;
+	TraceUnsignedBaseType_t uxPreambleCore;
+	TraceStreamPortMuxRing_t xRings[TRC_CFG_CORE_COUNT];
+	uint8_t uiBuffer[TRC_STREAM_PORT_MUX_BUFFER_SIZE];
+} TraceStreamPortMux_t;
+
+extern TraceStreamPortMux_t* pxStreamPortMux;
+
+#define TRC_STREAM_PORT_BUFFER_SIZE (sizeof(TraceStreamPortMux_t))
+
+typedef struct TraceStreamPortBuffer
+{
+	uint8_t buffer[TRC_STREAM_PORT_BUFFER_SIZE];
+} TraceStreamPortBuffer_t;
+
+/**
+ * @internal Stream port initialize callback.
+ *
+ * This function is called by the recorder as part of its initialization phase.
+ * Divides the buffer between the cores. No sinks are added.
+ *
+ * @param[in] pxBuffer Buffer
+ *
+ * @retval TRC_FAIL Initialization failed
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortInitialize(TraceStreamPortBuffer_t* pxBuffer);
+
+/**
+ * @brief Adds a sink. Call it after xTraceInitialize() and before
+ * xTraceEnable(). The first sink added is the primary, the recorder drops
+ * events rather than overwriting data the primary hasn't got, and the
+ * recorder is disabled if it fails. Later sinks are secondary, the recorder
+ * overwrites the oldest events they haven't got when it needs the space, and
+ * a secondary sink that fails is dropped.
+ *
+ * @param[in] pxSink Sink, copied
+ *
+ * @retval TRC_FAIL Not initialized, or TRC_CFG_STREAM_PORT_MUX_SINK_COUNT sinks already added
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortMuxAddSink(const TraceStreamPortMuxSink_t* pxSink);
+
+/**
+ * @brief Gets a sink's statistics. A sink is only given whole events, but it
+ * can be in the middle of one when it is closed, e.g. when it takes few bytes
+ * at a time. Cut uiPartialEventBytes off the end of its output when closing
+ * it, after the last xTraceTzCtrl() call, to keep the output a valid stream.
+ *
+ * @param[in] uiSink Sink, in the order added
+ * @param[out] pxStatistics Statistics
+ *
+ * @retval TRC_FAIL No such sink
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortMuxGetSinkStatistics(uint32_t uiSink, TraceStreamPortMuxSinkStatistics_t* pxStatistics);
+
+/**
+ * @brief Gets the number of events dropped since the trace began, because the
+ * primary sink hadn't got the data that they would have overwritten.
+ *
+ * @param[out] puiDroppedEvents Dropped events, all cores
+ *
+ * @retval TRC_FAIL Not initialized
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortMuxGetDroppedEvents(uint32_t* puiDroppedEvents);
+
+/**
+ * @brief Allocates data from the stream port, in the current core's ring
+ * buffer. Secondary sinks that haven't got the space yet are moved past it.
+ *
+ * @param[in] uiSize Allocation size
+ * @param[out] ppvData Allocation data pointer
+ *
+ * @retval TRC_FAIL Allocate failed, the primary sink hasn't got the space yet
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortAllocate(uint32_t uiSize, void** ppvData);
+
+/**
+ * @brief Commits data to the stream port. The data is already in the ring
+ * buffer, this makes it available to the sinks.
+ *
+ * @param[in] pvData Data to commit
+ * @param[in] uiSize Data to commit size
+ * @param[out] piBytesCommitted Bytes committed
+ *
+ * @retval TRC_FAIL Commit failed
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortCommit(void* pvData, uint32_t uiSize, int32_t* piBytesCommitted);
+
+/**
+ * @brief Writes data through the stream port interface. Not used since there
+ * is no internal buffer.
+ *
+ * @param[in] pvData Data to write
+ * @param[in] uiSize Data to write size
+ * @param[out] piBytesWritten Bytes written
+ *
+ * @retval TRC_FAIL Write failed
+ * @retval TRC_SUCCESS Success
+ */
+#define xTraceStreamPortWriteData(pvData, uiSize, piBytesWritten) ((void)(pvData), (void)(uiSize), *(piBytesWritten) = 0, TRC_SUCCESS)
+
+/**
+ * @brief Called periodically by the TzCtrl task. Writes what each sink
+ * hasn't got to it, then reads a command from the first sink that has one.
+ *
+ * @param[in] pvData Destination data buffer
+ * @param[in] uiSize Destination data buffer size
+ * @param[out] piBytesRead Bytes read
+ *
+ * @retval TRC_FAIL The primary sink failed
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortReadData(void* pvData, uint32_t uiSize, int32_t* piBytesRead);
+
+#define xTraceStreamPortOnEnable(uiStartOption) ((void)(uiStartOption), TRC_SUCCESS)
+
+#define xTraceStreamPortOnDisable() (TRC_SUCCESS)
+
+traceResult xTraceStreamPortOnTraceBegin(void);
+
+#define xTraceStreamPortOnTraceEnd() (TRC_SUCCESS)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*(TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)*/
+
+#endif /*(TRC_USE_TRACEALYZER_RECORDER == 1)*/
+
+#endif /* TRC_STREAM_PORT_H */
@@ -0,0 +1,562 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Supporting functions for trace streaming, used by the "stream ports"
+ * for reading and writing data to the interface.
+ * This stream port writes the events once, to a ring buffer per core, and
+ * writes them from there to each sink, from the sink's own cursor.
+ */
+
+#include <trcRecorder.h>
+
+#if (TRC_USE_TRACEALYZER_RECORDER == 1)
+
+#if (TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)
+
+#include <string.h>
+
+#if ((TRC_CFG_STREAM_PORT_MUX_SINK_COUNT) < 1)
+#error "TRC_CFG_STREAM_PORT_MUX_SINK_COUNT must be at least 1."
+#endif
+
+#if (((TRC_CFG_STREAM_PORT_MUX_BUFFER_SIZE) / (TRC_CFG_CORE_COUNT)) < 1024)
+#error "TRC_CFG_STREAM_PORT_MUX_BUFFER_SIZE must give each core at least 1024 bytes."
+#endif
+
+/* The carry, the rest of the buffer and its start */
+#define TRC_STREAM_PORT_MUX_TRANSFER_PASSES 3u
+
+TraceStreamPortMux_t* pxStreamPortMux TRC_CFG_RECORDER_DATA_ATTRIBUTE;
+
+/* A cursor past the head that the last wrap left in the slack is at the start
+ * of the buffer */
+static void prvTraceStreamPortMuxNormalize(const TraceStreamPortMuxRing_t* pxRing, TraceStreamPortMuxCursor_t* pxCursor)
+{
+	if ((pxCursor->uiPosition > pxRing->uiHead) && (pxCursor->uiPosition >= (pxRing->uiSize - pxRing->uiSlack)))
+	{
+		pxCursor->uiPosition = 0u;
+		pxCursor->uiEventStart = 0u;
+		pxCursor->uiEventEnd = 0u;
+	}
+}
+
+/* Whether the next uiSize bytes, at the head or at the start of the buffer,
+ * would overwrite data from uiCursor on that the sink hasn't got */
+static uint32_t prvTraceStreamPortMuxOverlaps(const TraceStreamPortMuxRing_t* pxRing, uint32_t uiCursor, uint32_t uiSize, uint32_t uiWrap)
+{
+	if (uiCursor == pxRing->uiHead)
+	{
+		/* The sink has got everything */
+		return 0u;
+	}
+
+	if (uiWrap == 0u)
+	{
+		return ((uiCursor > pxRing->uiHead) && (uiCursor <= (pxRing->uiHead + uiSize))) ? 1u : 0u;
+	}
+
+	return ((uiCursor > pxRing->uiHead) || (uiCursor <= uiSize)) ? 1u : 0u;
+}
+
+/* The header, timestamp info and entry table aren't events, a sink can't be
+ * moved past parts of them */
+static uint32_t prvTraceStreamPortMuxIsPinned(const TraceStreamPortMuxRing_t* pxRing, const TraceStreamPortMuxCursor_t* pxCursor)
+{
+	return (pxCursor->uiSessionBytes < pxRing->uiPreambleSize) ? 1u : 0u;
+}
+
+/* Moves a secondary sink past the space about to be written. The rest of the
+ * event it is in is copied out first, so that it only loses whole events. */
+static void prvTraceStreamPortMuxOverrun(TraceStreamPortMuxRing_t* pxRing, uint32_t uiSink, uint32_t uiSize, uint32_t uiWrap)
+{
+	TraceStreamPortMuxCursor_t* pxCursor = &pxRing->xCursors[uiSink];
+	uint32_t uiEventSize = 0u;
+
+	if (pxCursor->uiPosition != pxCursor->uiEventEnd)
+	{
+		pxCursor->uiCarryLength = pxCursor->uiEventEnd - pxCursor->uiPosition;
+		pxCursor->uiCarryPosition = 0u;
+		pxCursor->uiCarryStart = pxCursor->uiPosition - pxCursor->uiEventStart;
+		(void)memcpy(pxCursor->uiCarry, &pxRing->puiBuffer[pxCursor->uiPosition], pxCursor->uiCarryLength); /*cstat !MISRAC2004-17.4_b We need to access a specific part of the buffer*/
+		pxCursor->uiPosition = pxCursor->uiEventEnd;
+	}
+
+	while (prvTraceStreamPortMuxOverlaps(pxRing, pxCursor->uiPosition, uiSize, uiWrap) != 0u)
+	{
+		if ((pxCursor->uiPosition > pxRing->uiHead) && (pxCursor->uiPosition >= (pxRing->uiSize - pxRing->uiSlack)))
+		{
+			pxCursor->uiPosition = 0u;
+		}
+		else
+		{
+			(void)xTraceEventGetSize(&pxRing->puiBuffer[pxCursor->uiPosition], &uiEventSize); /*cstat !MISRAC2004-17.4_b We need to access a specific part of the buffer*/
+			pxCursor->uiPosition += uiEventSize;
+			pxStreamPortMux->xSinks[uiSink].xStatistics.uiLostEvents++;
+		}
+	}
+
+	pxCursor->uiEventStart = pxCursor->uiPosition;
+	pxCursor->uiEventEnd = pxCursor->uiPosition;
+}
+
+/* Bytes written to the sink of an event it hasn't got all of. Until the
+ * preamble is written, all of it is partial. */
+static uint32_t prvTraceStreamPortMuxPartialBytes(const TraceStreamPortMuxRing_t* pxRing, const TraceStreamPortMuxCursor_t* pxCursor)
+{
+	if (pxCursor->uiCarryLength != 0u)
+	{
+		return pxCursor->uiCarryStart + pxCursor->uiCarryPosition;
+	}
+
+	if (prvTraceStreamPortMuxIsPinned(pxRing, pxCursor) != 0u)
+	{
+		return pxCursor->uiSessionBytes;
+	}
+
+	if (pxCursor->uiPosition != pxCursor->uiEventEnd)
+	{
+		return pxCursor->uiPosition - pxCursor->uiEventStart;
+	}
+
+	return 0u;
+}
+
+/* A sink can only go on to another core's ring between events */
+static uint32_t prvTraceStreamPortMuxIsBetweenEvents(const TraceStreamPortMuxRing_t* pxRing, const TraceStreamPortMuxCursor_t* pxCursor)
+{
+	return ((pxCursor->uiCarryLength == 0u) &&
+		(prvTraceStreamPortMuxIsPinned(pxRing, pxCursor) == 0u) &&
+		(pxCursor->uiPosition == pxCursor->uiEventEnd)) ? 1u : 0u;
+}
+
+/* Writes what the sink hasn't got from one core's ring, until the sink takes
+ * less than it is given */
+static traceResult prvTraceStreamPortMuxTransfer(uint32_t uiCore, uint32_t uiSink)
+{
+	TraceStreamPortMuxSinkState_t* pxSinkState = &pxStreamPortMux->xSinks[uiSink];
+	TraceStreamPortMuxRing_t* pxRing = &pxStreamPortMux->xRings[uiCore];
+	TraceStreamPortMuxCursor_t* pxCursor = &pxRing->xCursors[uiSink];
+	uint8_t* puiData;
+	uint32_t uiPass;
+	uint32_t uiCarry;
+	uint32_t uiPosition;
+	uint32_t uiLength;
+	uint32_t uiEventStart;
+	uint32_t uiEventEnd;
+	uint32_t uiEventSize = 0u;
+	uint32_t uiSessionBytes;
+	uint32_t uiPreambleSize;
+	uint32_t uiSession;
+	uint32_t uiWritten;
+	int32_t iBytesWritten;
+	traceResult xResult;
+
+	TRACE_ALLOC_CRITICAL_SECTION();
+
+	for (uiPass = 0u; uiPass < TRC_STREAM_PORT_MUX_TRANSFER_PASSES; uiPass++)
+	{
+		TRACE_ENTER_CRITICAL_SECTION();
+
+		uiCarry = (pxCursor->uiCarryPosition < pxCursor->uiCarryLength) ? 1u : 0u;
+		if (uiCarry != 0u)
+		{
+			uiPosition = pxCursor->uiCarryPosition;
+			uiLength = pxCursor->uiCarryLength - uiPosition;
+			puiData = &pxCursor->uiCarry[uiPosition];
+		}
+		else
+		{
+			prvTraceStreamPortMuxNormalize(pxRing, pxCursor);
+
+			uiPosition = pxCursor->uiPosition;
+			uiLength = ((uiPosition <= pxRing->uiHead) ? pxRing->uiHead : (pxRing->uiSize - pxRing->uiSlack)) - uiPosition;
+			puiData = &pxRing->puiBuffer[uiPosition]; /*cstat !MISRAC2004-17.4_b We need to access a specific part of the buffer*/
+
+			/* The writer drops events rather than overwrite this while it is written */
+			pxCursor->uiClaimed = (uiLength != 0u) ? 1u : 0u;
+		}
+
+		uiEventStart = pxCursor->uiEventStart;
+		uiEventEnd = pxCursor->uiEventEnd;
+		uiSessionBytes = pxCursor->uiSessionBytes;
+		uiPreambleSize = pxRing->uiPreambleSize;
+		uiSession = pxRing->uiSession;
+
+		TRACE_EXIT_CRITICAL_SECTION();
+
+		if (uiLength == 0u)
+		{
+			return TRC_SUCCESS;
+		}
+
+		iBytesWritten = 0;
+		xResult = pxSinkState->xSink.xWrite(pxSinkState->xSink.pvContext, puiData, uiLength, &iBytesWritten);
+
+		uiWritten = 0u;
+		if ((xResult == TRC_SUCCESS) && (iBytesWritten > 0))
+		{
+			uiWritten = ((uint32_t)iBytesWritten < uiLength) ? (uint32_t)iBytesWritten : uiLength;
+		}
+
+		/* Find the end of the event the sink is now in, the data is still
+		 * claimed. Nothing is walked before the preamble ends. */
+		if ((uiCarry == 0u) && ((uiSessionBytes >= uiPreambleSize) || ((uiPreambleSize - uiSessionBytes) <= uiWritten)))
+		{
+			if (uiSessionBytes < uiPreambleSize)
+			{
+				uiEventEnd = uiPreambleSize;
+			}
+
+			while (uiEventEnd < (uiPosition + uiWritten))
+			{
+				uiEventStart = uiEventEnd;
+				(void)xTraceEventGetSize(&pxRing->puiBuffer[uiEventEnd], &uiEventSize); /*cstat !MISRAC2004-17.4_b We need to access a specific part of the buffer*/
+				uiEventEnd += uiEventSize;
+			}
+		}
+
+		TRACE_ENTER_CRITICAL_SECTION();
+
+		/* The ring was cleared while it was written if the trace began again */
+		if (uiSession == pxRing->uiSession)
+		{
+			if (uiCarry != 0u)
+			{
+				pxCursor->uiCarryPosition += uiWritten;
+				if (pxCursor->uiCarryPosition == pxCursor->uiCarryLength)
+				{
+					pxCursor->uiCarryLength = 0u;
+					pxCursor->uiCarryPosition = 0u;
+				}
+			}
+			else
+			{
+				pxCursor->uiPosition = uiPosition + uiWritten;
+				pxCursor->uiEventStart = uiEventStart;
+				pxCursor->uiEventEnd = uiEventEnd;
+				pxCursor->uiClaimed = 0u;
+
+				pxCursor->uiSessionBytes += uiWritten;
+				if (pxCursor->uiSessionBytes < uiSessionBytes)
+				{
+					pxCursor->uiSessionBytes = 0xFFFFFFFFu;
+				}
+			}
+
+			pxSinkState->xStatistics.uiBytesWritten += uiWritten;
+		}
+
+		TRACE_EXIT_CRITICAL_SECTION();
+
+		if (xResult == TRC_FAIL)
+		{
+			return TRC_FAIL;
+		}
+
+		if (uiWritten < uiLength)
+		{
+			/* The sink is busy */
+			break;
+		}
+	}
+
+	return TRC_SUCCESS;
+}
+
+/* Writes the rings to a sink in turn, staying on one that the sink is in the
+ * middle of an event in */
+static traceResult prvTraceStreamPortMuxTransferSink(uint32_t uiSink)
+{
+	TraceStreamPortMuxSinkState_t* pxSinkState = &pxStreamPortMux->xSinks[uiSink];
+	TraceStreamPortMuxRing_t* pxRing;
+	uint32_t uiCore;
+	uint32_t i;
+
+	for (i = 0u; i < (uint32_t)(TRC_CFG_CORE_COUNT); i++)
+	{
+		uiCore = (pxSinkState->uiCore + i) % (uint32_t)(TRC_CFG_CORE_COUNT);
+		pxRing = &pxStreamPortMux->xRings[uiCore];
+
+		if (prvTraceStreamPortMuxTransfer(uiCore, uiSink) == TRC_FAIL)
+		{
+			return TRC_FAIL;
+		}
+
+		if (prvTraceStreamPortMuxIsBetweenEvents(pxRing, &pxRing->xCursors[uiSink]) == 0u)
+		{
+			pxSinkState->uiCore = uiCore;
+
+			break;
+		}
+	}
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceStreamPortInitialize(TraceStreamPortBuffer_t* pxBuffer)
+{
+	uint32_t uiRingSize = ((TRC_STREAM_PORT_MUX_BUFFER_SIZE / (uint32_t)(TRC_CFG_CORE_COUNT)) / sizeof(TraceUnsignedBaseType_t)) * sizeof(TraceUnsignedBaseType_t);
+	uint32_t i;
+
+	TRC_ASSERT_EQUAL_SIZE(TraceStreamPortBuffer_t, TraceStreamPortMux_t);
+
+	if (pxBuffer == 0)
+	{
+		return TRC_FAIL;
+	}
+
+	pxStreamPortMux = (TraceStreamPortMux_t*)pxBuffer; /*cstat !MISRAC2004-11.4 !MISRAC2012-Rule-11.3 Suppress conversion between pointer types checks*/
+
+	(void)memset(pxStreamPortMux, 0, sizeof(TraceStreamPortMux_t));
+
+	for (i = 0u; i < (uint32_t)(TRC_CFG_CORE_COUNT); i++)
+	{
+		pxStreamPortMux->xRings[i].uiSize = uiRingSize;
+		pxStreamPortMux->xRings[i].puiBuffer = &pxStreamPortMux->uiBuffer[i * uiRingSize];
+	}
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceStreamPortMuxAddSink(const TraceStreamPortMuxSink_t* pxSink)
+{
+	traceResult xResult = TRC_FAIL;
+
+	TRACE_ALLOC_CRITICAL_SECTION();
+
+	TRC_ASSERT(pxSink != 0);
+	TRC_ASSERT(pxSink->xWrite != 0);
+
+	if (pxStreamPortMux == 0)
+	{
+		return TRC_FAIL;
+	}
+
+	TRACE_ENTER_CRITICAL_SECTION();
+
+	if (pxStreamPortMux->uxSinkCount < (TraceUnsignedBaseType_t)(TRC_CFG_STREAM_PORT_MUX_SINK_COUNT))
+	{
+		pxStreamPortMux->xSinks[pxStreamPortMux->uxSinkCount].xSink = *pxSink;
+		pxStreamPortMux->xSinks[pxStreamPortMux->uxSinkCount].uiCore = (uint32_t)pxStreamPortMux->uxPreambleCore;
+		pxStreamPortMux->uxSinkCount++;
+
+		xResult = TRC_SUCCESS;
+	}
+
+	TRACE_EXIT_CRITICAL_SECTION();
+
+	return xResult;
+}
+
+traceResult xTraceStreamPortMuxGetSinkStatistics(uint32_t uiSink, TraceStreamPortMuxSinkStatistics_t* pxStatistics)
+{
+	const TraceStreamPortMuxSinkState_t* pxSinkState;
+	const TraceStreamPortMuxRing_t* pxRing;
+
+	TRACE_ALLOC_CRITICAL_SECTION();
+
+	TRC_ASSERT(pxStatistics != 0);
+
+	if ((pxStreamPortMux == 0) || (uiSink >= (uint32_t)pxStreamPortMux->uxSinkCount))
+	{
+		return TRC_FAIL;
+	}
+
+	TRACE_ENTER_CRITICAL_SECTION();
+
+	pxSinkState = &pxStreamPortMux->xSinks[uiSink];
+	pxRing = &pxStreamPortMux->xRings[pxSinkState->uiCore];
+
+	*pxStatistics = pxSinkState->xStatistics;
+	pxStatistics->uiPartialEventBytes = prvTraceStreamPortMuxPartialBytes(pxRing, &pxRing->xCursors[uiSink]);
+
+	TRACE_EXIT_CRITICAL_SECTION();
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceStreamPortMuxGetDroppedEvents(uint32_t* puiDroppedEvents)
+{
+	uint32_t i;
+
+	TRACE_ALLOC_CRITICAL_SECTION();
+
+	TRC_ASSERT(puiDroppedEvents != 0);
+
+	if (pxStreamPortMux == 0)
+	{
+		return TRC_FAIL;
+	}
+
+	*puiDroppedEvents = 0u;
+
+	TRACE_ENTER_CRITICAL_SECTION();
+
+	for (i = 0u; i < (uint32_t)(TRC_CFG_CORE_COUNT); i++)
+	{
+		*puiDroppedEvents += pxStreamPortMux->xRings[i].uiDroppedEvents;
+	}
+
+	TRACE_EXIT_CRITICAL_SECTION();
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceStreamPortAllocate(uint32_t uiSize, void** ppvData)
+{
+	TraceStreamPortMuxRing_t* pxRing = &pxStreamPortMux->xRings[TRC_CFG_GET_CURRENT_CORE()];
+	TraceStreamPortMuxCursor_t* pxCursor;
+	uint32_t uiSinkCount = (uint32_t)pxStreamPortMux->uxSinkCount;
+	uint32_t uiWrap;
+	uint32_t i;
+
+	/* An event is never split at the end of the buffer, the rest becomes slack */
+	uiWrap = ((pxRing->uiSize - pxRing->uiHead) <= uiSize) ? 1u : 0u;
+
+	/* Nothing is overrun for an event that is dropped */
+	for (i = 0u; i < uiSinkCount; i++)
+	{
+		pxCursor = &pxRing->xCursors[i];
+
+		if (pxStreamPortMux->xSinks[i].xStatistics.uiFailed != 0u)
+		{
+			continue;
+		}
+
+		prvTraceStreamPortMuxNormalize(pxRing, pxCursor);
+
+		if ((prvTraceStreamPortMuxOverlaps(pxRing, pxCursor->uiPosition, uiSize, uiWrap) != 0u) &&
+			((i == 0u) || (pxCursor->uiClaimed != 0u) || (prvTraceStreamPortMuxIsPinned(pxRing, pxCursor) != 0u)))
+		{
+			pxRing->uiDroppedEvents++;
+
+			return TRC_FAIL;
+		}
+	}
+
+	for (i = 1u; i < uiSinkCount; i++)
+	{
+		if ((pxStreamPortMux->xSinks[i].xStatistics.uiFailed == 0u) &&
+			(prvTraceStreamPortMuxOverlaps(pxRing, pxRing->xCursors[i].uiPosition, uiSize, uiWrap) != 0u))
+		{
+			prvTraceStreamPortMuxOverrun(pxRing, i, uiSize, uiWrap);
+		}
+	}
+
+	if (uiWrap != 0u)
+	{
+		pxRing->uiSlack = pxRing->uiSize - pxRing->uiHead;
+		pxRing->uiNextHead = uiSize;
+		*ppvData = &pxRing->puiBuffer[0];
+	}
+	else
+	{
+		pxRing->uiNextHead = pxRing->uiHead + uiSize;
+		*ppvData = &pxRing->puiBuffer[pxRing->uiHead]; /*cstat !MISRAC2004-17.4_b We need to access a specific part of the buffer*/
+	}
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceStreamPortCommit(void* pvData, uint32_t uiSize, int32_t* piBytesCommitted)
+{
+	TraceStreamPortMuxRing_t* pxRing = &pxStreamPortMux->xRings[TRC_CFG_GET_CURRENT_CORE()];
+
+	(void)pvData;
+
+	pxRing->uiHead = pxRing->uiNextHead;
+
+	/* The recorder is enabled once the header, timestamp info and entry table
+	 * are stored */
+	if (xTraceIsRecorderEnabled() == 0u)
+	{
+		pxRing->uiPreambleSize = pxRing->uiHead;
+	}
+
+	*piBytesCommitted = (int32_t)uiSize;
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceStreamPortReadData(void* pvData, uint32_t uiSize, int32_t* piBytesRead)
+{
+	TraceStreamPortMuxSinkState_t* pxSinkState;
+	uint32_t uiSinkCount = (uint32_t)pxStreamPortMux->uxSinkCount;
+	traceResult xResult;
+	uint32_t i;
+
+	*piBytesRead = 0;
+
+	for (i = 0u; i < uiSinkCount; i++)
+	{
+		pxSinkState = &pxStreamPortMux->xSinks[i];
+
+		if (pxSinkState->xStatistics.uiFailed != 0u)
+		{
+			continue;
+		}
+
+		xResult = prvTraceStreamPortMuxTransferSink(i);
+
+		if ((xResult == TRC_SUCCESS) && (*piBytesRead == 0) && (pxSinkState->xSink.xRead != 0))
+		{
+			xResult = pxSinkState->xSink.xRead(pxSinkState->xSink.pvContext, pvData, uiSize, piBytesRead);
+		}
+
+		if (xResult == TRC_FAIL)
+		{
+			pxSinkState->xStatistics.uiFailed = 1u;
+			*piBytesRead = 0;
+
+			if (i == 0u)
+			{
+				return TRC_FAIL;
+			}
+		}
+	}
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceStreamPortOnTraceBegin(void)
+{
+	TraceStreamPortMuxRing_t* pxRing;
+	uint32_t i;
+	uint32_t j;
+
+	/* Called when the recorder is enabled, before the header is stored. The
+	 * sinks get the new trace from its start. */
+	for (i = 0u; i < (uint32_t)(TRC_CFG_CORE_COUNT); i++)
+	{
+		pxRing = &pxStreamPortMux->xRings[i];
+
+		pxRing->uiHead = 0u;
+		pxRing->uiNextHead = 0u;
+		pxRing->uiSlack = 0u;
+		pxRing->uiPreambleSize = 0u;
+		pxRing->uiDroppedEvents = 0u;
+		pxRing->uiSession++;
+
+		for (j = 0u; j < (uint32_t)(TRC_CFG_STREAM_PORT_MUX_SINK_COUNT); j++)
+		{
+			(void)memset(&pxRing->xCursors[j], 0, sizeof(TraceStreamPortMuxCursor_t));
+		}
+	}
+
+	pxStreamPortMux->uxPreambleCore = (TraceUnsignedBaseType_t)TRC_CFG_GET_CURRENT_CORE();
+
+	for (j = 0u; j < (uint32_t)pxStreamPortMux->uxSinkCount; j++)
+	{
+		pxStreamPortMux->xSinks[j].uiCore = (uint32_t)pxStreamPortMux->uxPreambleCore;
+	}
+
+	return TRC_SUCCESS;
+}
+
+#endif /*(TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)*/
+
+#endif /*(TRC_USE_TRACEALYZER_RECORDER == 1)*/
@@ -0,0 +1,47 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * The configuration for trace streaming ("stream ports").
+ */
+
+#ifndef TRC_STREAM_PORT_CONFIG_H
+#define TRC_STREAM_PORT_CONFIG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @def TRC_CFG_STREAM_PORT_SHM_NAME
+ *
+ * @brief The name of the POSIX shared memory segment, as given to shm_open().
+ * On Linux the segment is found in /dev/shm.
+ */
+#define TRC_CFG_STREAM_PORT_SHM_NAME "/trc-trace"
+
+/**
+ * @def TRC_CFG_STREAM_PORT_SHM_BUFFER_SIZE
+ *
+ * @brief The size of the event buffers in the segment, divided evenly between
+ * the cores. The segment is one page larger, for the layout descriptor.
+ */
+#define TRC_CFG_STREAM_PORT_SHM_BUFFER_SIZE (8 * 1024 * 1024)
+
+/**
+ * @def TRC_CFG_STREAM_PORT_SHM_WATERMARK
+ *
+ * @brief A blocked reader is woken when a core's buffer holds this many bytes.
+ * Below this, the reader picks up the data when its wait times out. A lower
+ * value gives lower latency but more wake-ups (syscalls) in the recorder.
+ */
+#define TRC_CFG_STREAM_PORT_SHM_WATERMARK (64 * 1024)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRC_STREAM_PORT_CONFIG_H */
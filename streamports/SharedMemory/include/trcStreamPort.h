@@ -0,0 +1,138 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * The interface definitions for trace streaming ("stream ports").
+ * This "stream port" sets up the recorder to write the trace into a POSIX
+ * shared memory segment, read by another process (Linux hosts and simulators).
+ */
+
+#ifndef TRC_STREAM_PORT_H
+#define TRC_STREAM_PORT_H
+
+#if (TRC_USE_TRACEALYZER_RECORDER == 1)
+
+#if (TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)
+
+#include <stdint.h>
+#include <trcTypes.h>
+#include <trcStreamPortConfig.h>
+#include <trcStreamPortShmLayout.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @def TRC_USE_INTERNAL_BUFFER
+ *
+ * @brief This Stream Port uses the Multi Core Buffer in the segment directly.
+ */
+#define TRC_USE_INTERNAL_BUFFER 0
+
+#define TRC_STREAM_PORT_SHM_BUFFER_SIZE (((uint32_t)(TRC_CFG_STREAM_PORT_SHM_BUFFER_SIZE) / sizeof(TraceUnsignedBaseType_t)) * sizeof(TraceUnsignedBaseType_t))	/* aligned */
+
+#define TRC_STREAM_PORT_SHM_SEGMENT_SIZE ((TRC_STREAM_PORT_SHM_DESCRIPTOR_SIZE) + (TRC_STREAM_PORT_SHM_BUFFER_SIZE))
+
+typedef struct TraceStreamPortShm	/* Aligned */
+{
+	TraceMultiCoreEventBuffer_t xMultiCoreEventBuffer;	/* Points into the segment */
+	TraceStreamPortShmDescriptor_t* pxDescriptor;		/* Start of the segment */
+} TraceStreamPortShm_t;
+
+extern TraceStreamPortShm_t* pxStreamPortShm;
+
+#define TRC_STREAM_PORT_BUFFER_SIZE (sizeof(TraceStreamPortShm_t))
+
+typedef struct TraceStreamPortBuffer
+{
+	uint8_t buffer[TRC_STREAM_PORT_BUFFER_SIZE];
+} TraceStreamPortBuffer_t;
+
+/**
+ * @internal Stream port initialize callback.
+ *
+ * This function is called by the recorder as part of its initialization phase.
+ * Creates and maps the shared memory segment and publishes the layout
+ * descriptor.
+ *
+ * @param[in] pxBuffer Buffer
+ *
+ * @retval TRC_FAIL Initialization failed
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortInitialize(TraceStreamPortBuffer_t* pxBuffer);
+
+/**
+ * @brief Allocates data from the stream port. Returns a pointer into the
+ * current core's buffer in the segment. Fails if the reader hasn't made room,
+ * and the event is dropped.
+ *
+ * @param[in] uiSize Allocation size
+ * @param[out] ppvData Allocation data pointer
+ *
+ * @retval TRC_FAIL Allocate failed
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortAllocate(uint32_t uiSize, void** ppvData);
+
+/**
+ * @brief Commits data to the stream port. The data is already in the segment,
+ * so this publishes the new head to the reader and wakes the reader if it is
+ * blocked and the buffer has reached the watermark. That is the only case
+ * that makes a syscall.
+ *
+ * @param[in] pvData Data to commit
+ * @param[in] uiSize Data to commit size
+ * @param[out] piBytesCommitted Bytes committed
+ *
+ * @retval TRC_FAIL Commit failed
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortCommit(void* pvData, uint32_t uiSize, int32_t* piBytesCommitted);
+
+/**
+ * @brief Writes data through the stream port interface. Not used since there
+ * is no internal buffer.
+ *
+ * @param[in] pvData Data to write
+ * @param[in] uiSize Data to write size
+ * @param[out] piBytesWritten Bytes written
+ *
+ * @retval TRC_FAIL Write failed
+ * @retval TRC_SUCCESS Success
+ */
+#define xTraceStreamPortWriteData(pvData, uiSize, piBytesWritten) ((void)(pvData), (void)(uiSize), *(piBytesWritten) = 0, TRC_SUCCESS)
+
+/**
+ * @brief Reads a command that the reader has placed in the descriptor.
+ *
+ * @param[in] pvData Destination data buffer
+ * @param[in] uiSize Destination data buffer size
+ * @param[out] piBytesRead Bytes read
+ *
+ * @retval TRC_FAIL Read failed
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortReadData(void* pvData, uint32_t uiSize, int32_t* piBytesRead);
+
+#define xTraceStreamPortOnEnable(uiStartOption) ((void)(uiStartOption), TRC_SUCCESS)
+
+#define xTraceStreamPortOnDisable() (TRC_SUCCESS)
+
+traceResult xTraceStreamPortOnTraceBegin(void);
+
+traceResult xTraceStreamPortOnTraceEnd(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*(TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)*/
+
+#endif /*(TRC_USE_TRACEALYZER_RECORDER == 1)*/
+
+#endif /* TRC_STREAM_PORT_H */
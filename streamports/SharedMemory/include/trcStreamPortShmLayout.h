@@ -0,0 +1,105 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * The layout of the shared memory segment written by the SharedMemory stream
+ * port. This file only depends on stdint.h, so that a reader in another
+ * process (see extras/SharedMemoryReader) can include it without the recorder
+ * configuration.
+ */
+
+#ifndef TRC_STREAM_PORT_SHM_LAYOUT_H
+#define TRC_STREAM_PORT_SHM_LAYOUT_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TRC_STREAM_PORT_SHM_MAGIC "TRCSHM"
+
+#define TRC_STREAM_PORT_SHM_VERSION 1u
+
+/**
+ * @def TRC_STREAM_PORT_SHM_DESCRIPTOR_SIZE
+ * @brief The descriptor occupies the first page of the segment, the per-core
+ * event buffers follow.
+ */
+#define TRC_STREAM_PORT_SHM_DESCRIPTOR_SIZE 4096u
+
+/**
+ * @def TRC_STREAM_PORT_SHM_MAX_CORES
+ * @brief The core id is stored in 4 bits of the event count, so there can't be
+ * more than 16 cores.
+ */
+#define TRC_STREAM_PORT_SHM_MAX_CORES 16u
+
+/**
+ * @brief Where one core's event buffer is in the segment. The offsets are from
+ * the start of the segment, since the segment is mapped at different addresses
+ * in the two processes.
+ */
+typedef struct TraceStreamPortShmCore
+{
+	uint32_t uiBufferOffset;	/* The core's TraceEventBuffer_t */
+	uint32_t uiDataOffset;		/* The core's event data */
+	uint32_t uiDataSize;		/* Size of the event data */
+	uint32_t uiSessionHead;		/* uiHead when the current session began */
+} TraceStreamPortShmCore_t;
+
+/**
+ * @brief The descriptor at the start of the segment.
+ *
+ * The reader follows uiHead and owns uiTail of each core's TraceEventBuffer_t,
+ * found at uiBufferOffset + uiHeadOffset/uiTailOffset/uiSlackOffset. The
+ * recorder stores uiHead with release semantics after the event data is
+ * written, and the reader stores uiTail with release semantics after the data
+ * is consumed.
+ *
+ * The reader blocks on uiWakeCounter (a futex word on Linux) after setting
+ * uiReaderWaiting. The recorder clears uiReaderWaiting, increments
+ * uiWakeCounter and wakes the reader when a core's buffer reaches
+ * uiWatermark bytes, and when a session begins or ends.
+ *
+ * Each xTraceEnable() that starts the recorder begins a new session. The
+ * recorder records where the session begins in each buffer (uiSessionHead)
+ * before incrementing uiSession, so the reader can split the sessions.
+ *
+ * Commands (TraceCommand_t, 8 bytes) are passed to the recorder through
+ * uiCommand. The reader writes the command and increments uiCommandWrite, the
+ * recorder reads it in xTraceTzCtrl() and sets uiCommandRead to uiCommandWrite.
+ */
+typedef struct TraceStreamPortShmDescriptor
+{
+	char cMagic[8];				/* TRC_STREAM_PORT_SHM_MAGIC */
+	uint32_t uiVersion;			/* TRC_STREAM_PORT_SHM_VERSION */
+	uint32_t uiDescriptorSize;	/* TRC_STREAM_PORT_SHM_DESCRIPTOR_SIZE */
+	uint32_t uiSegmentSize;		/* Size of the whole segment */
+	uint32_t uiCoreCount;
+	uint32_t uiHeadOffset;		/* offsetof(TraceEventBuffer_t, uiHead) */
+	uint32_t uiTailOffset;		/* offsetof(TraceEventBuffer_t, uiTail) */
+	uint32_t uiSlackOffset;		/* offsetof(TraceEventBuffer_t, uiSlack) */
+	uint32_t uiWatermark;		/* Bytes in a buffer that wake the reader */
+	int32_t iWriterPid;
+	int32_t iReaderPid;			/* 0 if no reader is attached */
+	uint32_t uiSession;			/* Incremented when a session begins */
+	uint32_t uiEnabled;			/* 1 while a session is recording */
+	uint32_t uiDroppedEvents;	/* Events that didn't fit, all sessions */
+	uint32_t uiWakeCounter;		/* Futex word */
+	uint32_t uiReaderWaiting;	/* 1 while the reader is blocked */
+	uint32_t uiCommandWrite;
+	uint32_t uiCommandRead;
+	uint8_t uiCommand[8];
+	uint32_t uiReserved;
+	TraceStreamPortShmCore_t xCores[TRC_STREAM_PORT_SHM_MAX_CORES];
+} TraceStreamPortShmDescriptor_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRC_STREAM_PORT_SHM_LAYOUT_H */
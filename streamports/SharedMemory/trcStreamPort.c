@@ -0,0 +1,279 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Supporting functions for trace streaming, used by the "stream ports"
+ * for reading and writing data to the interface.
+ * This stream port writes the trace into per-core event buffers in a POSIX
+ * shared memory segment, which another process reads.
+ */
+
+#include <trcRecorder.h>
+
+#if (TRC_USE_TRACEALYZER_RECORDER == 1)
+
+#if (TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)
+
+#if defined(_WIN32)
+#error "The SharedMemory stream port requires a POSIX host."
+#endif
+
+#if ((TRC_CFG_CORE_COUNT) > (TRC_STREAM_PORT_SHM_MAX_CORES))
+#error "The SharedMemory stream port supports at most 16 cores."
+#endif
+
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+TraceStreamPortShm_t* pxStreamPortShm TRC_CFG_RECORDER_DATA_ATTRIBUTE;
+
+static void prvTraceStreamPortShmWake(void);
+
+traceResult xTraceStreamPortInitialize(TraceStreamPortBuffer_t* pxBuffer)
+{
+	TraceStreamPortShmDescriptor_t* pxDescriptor;
+	uint8_t* puiSegment;
+	void* pvMapping;
+	uint32_t i;
+	int iFile;
+
+	TRC_ASSERT_EQUAL_SIZE(TraceStreamPortBuffer_t, TraceStreamPortShm_t);
+
+	TRC_ASSERT(pxBuffer != 0);
+
+	pxStreamPortShm = (TraceStreamPortShm_t*)pxBuffer; /*cstat !MISRAC2004-11.4 !MISRAC2012-Rule-11.3 Suppress conversion between pointer types checks*/
+	pxStreamPortShm->pxDescriptor = 0;
+
+	iFile = shm_open(TRC_CFG_STREAM_PORT_SHM_NAME, O_RDWR | O_CREAT, 0600);
+	if (iFile < 0)
+	{
+		printf("Could not open shared memory segment, error code %d.\n", errno);
+
+		return TRC_FAIL;
+	}
+
+	pvMapping = MAP_FAILED;
+	if (ftruncate(iFile, (off_t)(TRC_STREAM_PORT_SHM_SEGMENT_SIZE)) == 0)
+	{
+		pvMapping = mmap((void*)0, TRC_STREAM_PORT_SHM_SEGMENT_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, iFile, 0);
+	}
+
+	if (pvMapping == MAP_FAILED)
+	{
+		printf("Could not map shared memory segment, error code %d.\n", errno);
+		(void)close(iFile);
+
+		return TRC_FAIL;
+	}
+
+	/* The mapping stays valid without the descriptor */
+	(void)close(iFile);
+
+	puiSegment = (uint8_t*)pvMapping;
+	pxDescriptor = (TraceStreamPortShmDescriptor_t*)pvMapping; /*cstat !MISRAC2004-11.4 !MISRAC2012-Rule-11.3 Suppress conversion between pointer types checks*/
+
+	/* A reader of an earlier run sees the magic disappear and attaches again */
+	(void)memset(pvMapping, 0, TRC_STREAM_PORT_SHM_DESCRIPTOR_SIZE);
+
+	if (xTraceMultiCoreEventBufferInitialize(&pxStreamPortShm->xMultiCoreEventBuffer, TRC_EVENT_BUFFER_OPTION_SKIP,
+		&puiSegment[TRC_STREAM_PORT_SHM_DESCRIPTOR_SIZE], TRC_STREAM_PORT_SHM_BUFFER_SIZE) == TRC_FAIL)
+	{
+		(void)munmap(pvMapping, TRC_STREAM_PORT_SHM_SEGMENT_SIZE);
+
+		return TRC_FAIL;
+	}
+
+	pxDescriptor->uiVersion = TRC_STREAM_PORT_SHM_VERSION;
+	pxDescriptor->uiDescriptorSize = TRC_STREAM_PORT_SHM_DESCRIPTOR_SIZE;
+	pxDescriptor->uiSegmentSize = TRC_STREAM_PORT_SHM_SEGMENT_SIZE;
+	pxDescriptor->uiCoreCount = TRC_CFG_CORE_COUNT;
+	pxDescriptor->uiHeadOffset = (uint32_t)offsetof(TraceEventBuffer_t, uiHead);
+	pxDescriptor->uiTailOffset = (uint32_t)offsetof(TraceEventBuffer_t, uiTail);
+	pxDescriptor->uiSlackOffset = (uint32_t)offsetof(TraceEventBuffer_t, uiSlack);
+	pxDescriptor->uiWatermark = TRC_CFG_STREAM_PORT_SHM_WATERMARK;
+	pxDescriptor->iWriterPid = (int32_t)getpid();
+
+	for (i = 0u; i < (uint32_t)(TRC_CFG_CORE_COUNT); i++)
+	{
+		TraceEventBuffer_t* pxEventBuffer = pxStreamPortShm->xMultiCoreEventBuffer.xEventBuffer[i];
+
+		pxDescriptor->xCores[i].uiBufferOffset = (uint32_t)((uint8_t*)pxEventBuffer - puiSegment);
+		pxDescriptor->xCores[i].uiDataOffset = (uint32_t)(pxEventBuffer->puiBuffer - puiSegment);
+		pxDescriptor->xCores[i].uiDataSize = pxEventBuffer->uiSize;
+	}
+
+	/* The magic is written last, a reader only uses a segment that has it */
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	(void)memcpy(pxDescriptor->cMagic, TRC_STREAM_PORT_SHM_MAGIC, sizeof(TRC_STREAM_PORT_SHM_MAGIC));
+
+	pxStreamPortShm->pxDescriptor = pxDescriptor;
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceStreamPortAllocate(uint32_t uiSize, void** ppvData)
+{
+	traceResult xResult = xTraceMultiCoreEventBufferAlloc(&pxStreamPortShm->xMultiCoreEventBuffer, uiSize, ppvData);
+
+	if (xResult == TRC_FAIL)
+	{
+		/* The reader hasn't kept up */
+		(void)__atomic_fetch_add(&pxStreamPortShm->pxDescriptor->uiDroppedEvents, 1u, __ATOMIC_RELAXED);
+
+		return TRC_FAIL;
+	}
+
+	/* uiTail was read by the allocation, the reader is done with the space before it is written */
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceStreamPortCommit(void* pvData, uint32_t uiSize, int32_t* piBytesCommitted)
+{
+	TraceEventBuffer_t* pxEventBuffer = pxStreamPortShm->xMultiCoreEventBuffer.xEventBuffer[TRC_CFG_GET_CURRENT_CORE()];
+	uint32_t uiHead;
+	uint32_t uiTail;
+	uint32_t uiFill;
+
+	/* The event data is written before the new head is visible to the reader */
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	(void)xTraceMultiCoreEventBufferAllocCommit(&pxStreamPortShm->xMultiCoreEventBuffer, pvData, uiSize, piBytesCommitted);
+
+	/* A plain load while the reader is running. If the reader starts waiting
+	 * right after this, it is woken by the next commit or its own timeout. */
+	if (__atomic_load_n(&pxStreamPortShm->pxDescriptor->uiReaderWaiting, __ATOMIC_RELAXED) != 0u)
+	{
+		uiHead = pxEventBuffer->uiHead;
+		uiTail = __atomic_load_n(&pxEventBuffer->uiTail, __ATOMIC_RELAXED);
+		uiFill = (uiHead >= uiTail) ? (uiHead - uiTail) : (pxEventBuffer->uiSize - pxEventBuffer->uiSlack - uiTail + uiHead);
+
+		if (uiFill >= (uint32_t)(TRC_CFG_STREAM_PORT_SHM_WATERMARK))
+		{
+			prvTraceStreamPortShmWake();
+		}
+	}
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceStreamPortReadData(void* pvData, uint32_t uiSize, int32_t* piBytesRead)
+{
+	TraceStreamPortShmDescriptor_t* pxDescriptor = pxStreamPortShm->pxDescriptor;
+	uint32_t uiCommandWrite;
+
+	*piBytesRead = 0;
+
+	if (pxDescriptor == 0)
+	{
+		return TRC_FAIL;
+	}
+
+	uiCommandWrite = __atomic_load_n(&pxDescriptor->uiCommandWrite, __ATOMIC_ACQUIRE);
+	if ((uiCommandWrite != pxDescriptor->uiCommandRead) && (uiSize >= sizeof(pxDescriptor->uiCommand)))
+	{
+		(void)memcpy(pvData, pxDescriptor->uiCommand, sizeof(pxDescriptor->uiCommand));
+		__atomic_store_n(&pxDescriptor->uiCommandRead, uiCommandWrite, __ATOMIC_RELEASE);
+
+		*piBytesRead = (int32_t)sizeof(pxDescriptor->uiCommand);
+	}
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceStreamPortOnTraceBegin(void)
+{
+	TraceStreamPortShmDescriptor_t* pxDescriptor = pxStreamPortShm->pxDescriptor;
+	int32_t iReaderPid;
+	uint32_t i;
+
+	if (pxDescriptor == 0)
+	{
+		return TRC_FAIL;
+	}
+
+	iReaderPid = __atomic_load_n(&pxDescriptor->iReaderPid, __ATOMIC_ACQUIRE);
+	if ((iReaderPid != 0) && (kill((pid_t)iReaderPid, 0) != 0) && (errno == ESRCH))
+	{
+		/* The reader died without detaching */
+		__atomic_store_n(&pxDescriptor->iReaderPid, 0, __ATOMIC_RELAXED);
+		iReaderPid = 0;
+	}
+
+	if (iReaderPid == 0)
+	{
+		/* Nobody will read what is left of the previous session, so start with empty buffers */
+		(void)xTraceMultiCoreEventBufferClear(&pxStreamPortShm->xMultiCoreEventBuffer);
+	}
+
+	for (i = 0u; i < (uint32_t)(TRC_CFG_CORE_COUNT); i++)
+	{
+		pxDescriptor->xCores[i].uiSessionHead = pxStreamPortShm->xMultiCoreEventBuffer.xEventBuffer[i]->uiHead;
+	}
+
+	__atomic_store_n(&pxDescriptor->uiEnabled, 1u, __ATOMIC_RELAXED);
+	(void)__atomic_fetch_add(&pxDescriptor->uiSession, 1u, __ATOMIC_RELEASE);
+
+	prvTraceStreamPortShmWake();
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceStreamPortOnTraceEnd(void)
+{
+	TraceStreamPortShmDescriptor_t* pxDescriptor = pxStreamPortShm->pxDescriptor;
+	uint32_t uiDroppedEvents;
+
+	if (pxDescriptor == 0)
+	{
+		return TRC_FAIL;
+	}
+
+	__atomic_store_n(&pxDescriptor->uiEnabled, 0u, __ATOMIC_RELEASE);
+
+	prvTraceStreamPortShmWake();
+
+	uiDroppedEvents = __atomic_load_n(&pxDescriptor->uiDroppedEvents, __ATOMIC_RELAXED);
+	if (uiDroppedEvents > 0u)
+	{
+		printf("%u events were dropped, the shared memory reader didn't keep up.\n", (unsigned int)uiDroppedEvents);
+	}
+
+	return TRC_SUCCESS;
+}
+
+/* Wakes the reader if it is blocked. Only the first caller after the reader started waiting makes the syscall. */
+static void prvTraceStreamPortShmWake(void)
+{
+	TraceStreamPortShmDescriptor_t* pxDescriptor = pxStreamPortShm->pxDescriptor;
+
+	if (__atomic_exchange_n(&pxDescriptor->uiReaderWaiting, 0u, __ATOMIC_ACQ_REL) == 0u)
+	{
+		return;
+	}
+
+	(void)__atomic_fetch_add(&pxDescriptor->uiWakeCounter, 1u, __ATOMIC_RELEASE);
+
+#if defined(__linux__)
+	/* Not FUTEX_PRIVATE_FLAG, the reader is in another process */
+	(void)syscall(SYS_futex, &pxDescriptor->uiWakeCounter, FUTEX_WAKE, 1, (void*)0, (void*)0, 0);
+#endif
+}
+
+#endif /*(TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)*/
+
+#endif /*(TRC_USE_TRACEALYZER_RECORDER == 1)*/
@@ -80,6 +80,32 @@ extern "C" {
  */
 #define TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT 5
 
+/**
+ * @def TRC_CFG_STREAM_PORT_WRITE_COMBINE_SIZE
+ *
+ * @brief Only used when the internal buffer isn't. If larger than 0, the
+ * events are combined in a buffer of this size per core, which is written when
+ * it is full, when an event is stored
+ * TRC_CFG_STREAM_PORT_WRITE_COMBINE_FLUSH_PERIOD or more after the oldest one
+ * in it, and by TzCtrl. Each event would otherwise be a separate send() call,
+ * with a system call or network stack call and possibly a small packet per
+ * event. Set to 0 to write each event as it is stored.
+ *
+ * Default: 0
+ */
+#define TRC_CFG_STREAM_PORT_WRITE_COMBINE_SIZE 0
+
+/**
+ * @def TRC_CFG_STREAM_PORT_WRITE_COMBINE_FLUSH_PERIOD
+ *
+ * @brief The longest time, in microseconds, that an event is held in the write
+ * combine buffer while other events are being stored. When no events are
+ * stored, it is up to TzCtrl to write it.
+ *
+ * Default: 1000
+ */
+#define TRC_CFG_STREAM_PORT_WRITE_COMBINE_FLUSH_PERIOD 1000
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,111 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * The configuration for trace streaming ("stream ports").
+ */
+
+#ifndef TRC_STREAM_PORT_CONFIG_H
+#define TRC_STREAM_PORT_CONFIG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @def TRC_CFG_STREAM_PORT_TCPIP_PORT
+ *
+ * @brief Specifies the TCP/IP port.
+ */
+#define TRC_CFG_STREAM_PORT_TCPIP_PORT 8888
+
+/**
+ * @def TRC_CFG_STREAM_PORT_TCPIP_RING_SIZE
+ *
+ * @brief The size of the send ring, where data is collected into batches
+ * before it is sent. When the ring is full, the stream port only accepts part
+ * of the data, so the internal buffer keeps the rest for the next transfer.
+ * Must be a power of two.
+ */
+#define TRC_CFG_STREAM_PORT_TCPIP_RING_SIZE 65536
+
+/**
+ * @def TRC_CFG_STREAM_PORT_TCPIP_BATCH_SIZE
+ *
+ * @brief Data is sent in multiples of this many bytes, the rest waits for the
+ * next xTraceTzCtrl() call. Set to 0 to use the MSS of the connection, or to 1
+ * to send all data right away.
+ */
+#define TRC_CFG_STREAM_PORT_TCPIP_BATCH_SIZE 0
+
+/**
+ * @def TRC_CFG_STREAM_PORT_USE_INTERNAL_BUFFER
+ *
+ * @brief This define will determine whether to use the internal buffer or not.
+ * If file writing creates additional trace events (i.e. it uses semaphores or mutexes),
+ * then the internal buffer must be enabled to avoid infinite recursion.
+ *
+ * Without the internal buffer, each full batch is sent with sendmsg() from
+ * within the recorder's critical section, so every traced thread waits for
+ * that system call and events that don't fit in the send ring are dropped.
+ * Only use this with a low event rate, e.g. a single traced thread.
+ */
+#define TRC_CFG_STREAM_PORT_USE_INTERNAL_BUFFER 1
+
+/**
+ * @def TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_SIZE
+ *
+ * @brief Configures the size of the internal buffer if used.
+ */
+#define TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_SIZE 1048576
+
+/**
+ * @def TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_WRITE_MODE
+ *
+ * @brief This should be set to TRC_INTERNAL_EVENT_BUFFER_OPTION_WRITE_MODE_DIRECT for best performance.
+ */
+#define TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_WRITE_MODE TRC_INTERNAL_EVENT_BUFFER_OPTION_WRITE_MODE_DIRECT
+
+/**
+ * @def TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_TRANSFER_MODE
+ *
+ * @brief Defines if the internal buffer will attempt to transfer all data each time or limit it to a chunk size.
+ */
+#define TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_TRANSFER_MODE TRC_INTERNAL_EVENT_BUFFER_OPTION_TRANSFER_MODE_ALL
+
+/**
+ * @def TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_SIZE
+ *
+ * @brief Defines the maximum chunk size when transferring
+ * internal buffer events in chunks.
+ */
+#define TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_SIZE 65536
+
+/**
+ * @def TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_SIZE_LIMIT
+ *
+ * @brief Defines the number of transferred bytes needed to trigger another transfer.
+ * It also depends on TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT to set a maximum number
+ * of additional transfers this loop.
+ * This will increase throughput by immediately doing a transfer and not wait for another xTraceTzCtrl() loop.
+ */
+#define TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_SIZE_LIMIT 16384
+
+/**
+ * @def TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT
+ *
+ * @brief Defines the maximum number of times to trigger another transfer before returning to xTraceTzCtrl().
+ * It also depends on TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_SIZE_LIMIT to see if a meaningful amount of data was
+ * transferred in the last loop.
+ * This will increase throughput by immediately doing a transfer and not wait for another xTraceTzCtrl() loop.
+ */
+#define TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT 5
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRC_STREAM_PORT_CONFIG_H */
@@ -0,0 +1,218 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * The interface definitions for trace streaming ("stream ports").
+ * This "stream port" sets up the recorder to use TCP/IP as streaming channel,
+ * using POSIX sockets (Linux and other POSIX hosts and simulators).
+ */
+
+#ifndef TRC_STREAM_PORT_H
+#define TRC_STREAM_PORT_H
+
+#include <stdint.h>
+#include <trcTypes.h>
+#include <trcStreamPortConfig.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TRC_ALIGNED_STREAM_PORT_BUFFER_SIZE ((((TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_SIZE) + sizeof(TraceUnsignedBaseType_t) - 1) / sizeof(TraceUnsignedBaseType_t)) * sizeof(TraceUnsignedBaseType_t))
+
+#define TRC_USE_INTERNAL_BUFFER (TRC_CFG_STREAM_PORT_USE_INTERNAL_BUFFER)
+
+#define TRC_INTERNAL_EVENT_BUFFER_WRITE_MODE (TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_WRITE_MODE)
+
+#define TRC_INTERNAL_EVENT_BUFFER_TRANSFER_MODE (TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_TRANSFER_MODE)
+
+#define TRC_INTERNAL_BUFFER_CHUNK_SIZE (TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_SIZE)
+
+#define TRC_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_SIZE_LIMIT (TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_SIZE_LIMIT)
+
+#define TRC_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT (TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT)
+
+#define TRC_STREAM_PORT_TCPIP_RING_SIZE (TRC_CFG_STREAM_PORT_TCPIP_RING_SIZE)
+
+/**
+ * @brief Statistics for the connection, see xTraceStreamPortGetStatistics().
+ */
+typedef struct TraceStreamPortTCPIPStatistics
+{
+	uint64_t ulBytesSent;			/* Bytes handed to the socket */
+	uint32_t uiSendCalls;			/* Calls to sendmsg() */
+	uint32_t uiBackpressure;		/* Times less data was accepted than offered */
+	uint32_t uiDroppedEvents;		/* Events dropped without the internal buffer */
+	uint32_t uiBufferFullEvents;	/* Events not stored since the internal buffer was full */
+	uint32_t reserved0;				/* alignment */
+} TraceStreamPortTCPIPStatistics_t;
+
+typedef struct TraceStreamPortTCPIP	/* Aligned */
+{
+#if (TRC_USE_INTERNAL_BUFFER)
+	uint8_t buffer[(TRC_ALIGNED_STREAM_PORT_BUFFER_SIZE)];
+#endif
+	uint8_t uiRing[TRC_STREAM_PORT_TCPIP_RING_SIZE];
+	uint32_t uiRingHead;	/* Bytes added to the ring, wraps */
+	uint32_t uiRingTail;	/* Bytes sent from the ring, wraps */
+	uint32_t uiBatchSize;
+	int32_t iListenSocket;
+	int32_t iSocket;
+	uint32_t reserved0;		/* alignment */
+	TraceStreamPortTCPIPStatistics_t xStatistics;
+} TraceStreamPortTCPIP_t;
+
+typedef struct TraceStreamPortBuffer	/* Aligned */
+{
+	uint8_t buffer[sizeof(TraceStreamPortTCPIP_t)];
+} TraceStreamPortBuffer_t;
+
+/**
+ * @internal Stream port initialize callback.
+ *
+ * This function is called by the recorder as part of its initialization phase.
+ *
+ * @param[in] pxBuffer Buffer
+ *
+ * @retval TRC_FAIL Initialization failed
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortInitialize(TraceStreamPortBuffer_t* pxBuffer);
+
+/**
+ * @brief Allocates data from the stream port.
+ *
+ * @param[in] uiSize Allocation size
+ * @param[out] ppvData Allocation data pointer
+ *
+ * @retval TRC_FAIL Allocate failed
+ * @retval TRC_SUCCESS Success
+ */
+#if (TRC_USE_INTERNAL_BUFFER == 1)
+	#if (TRC_INTERNAL_EVENT_BUFFER_WRITE_MODE == TRC_INTERNAL_EVENT_BUFFER_OPTION_WRITE_MODE_COPY)
+		#define xTraceStreamPortAllocate(uiSize, ppvData) ((void)(uiSize), xTraceStaticBufferGet(ppvData))
+	#else
+		#define xTraceStreamPortAllocate xTraceStreamPortTCPIPAllocate
+	#endif
+#else
+	#define xTraceStreamPortAllocate(uiSize, ppvData) ((void)(uiSize), xTraceStaticBufferGet(ppvData))
+#endif
+
+/**
+ * @brief Commits data to the stream port, depending on the implementation/configuration of the
+ * stream port this data might be directly written to the stream port interface, buffered, or
+ * something else.
+ *
+ * @param[in] pvData Data to commit
+ * @param[in] uiSize Data to commit size
+ * @param[out] piBytesCommitted Bytes committed
+ *
+ * @retval TRC_FAIL Commit failed
+ * @retval TRC_SUCCESS Success
+ */
+#if (TRC_USE_INTERNAL_BUFFER == 1)
+	#if (TRC_INTERNAL_EVENT_BUFFER_WRITE_MODE == TRC_INTERNAL_EVENT_BUFFER_OPTION_WRITE_MODE_COPY)
+		#define xTraceStreamPortCommit xTraceStreamPortTCPIPPush
+	#else
+		#define xTraceStreamPortCommit xTraceInternalEventBufferAllocCommit
+	#endif
+#else
+	#define xTraceStreamPortCommit xTraceStreamPortTCPIPCommit
+#endif
+
+/**
+ * @internal Allocates an event in the internal buffer, counting the events
+ * that don't fit in uiBufferFullEvents. Called within the recorder's
+ * critical section.
+ *
+ * @param[in] uiSize Event size
+ * @param[out] ppvData Event data pointer
+ *
+ * @retval TRC_FAIL The internal buffer is full
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortTCPIPAllocate(uint32_t uiSize, void** ppvData);
+
+/**
+ * @internal Copies an event to the internal buffer, counting the events
+ * that don't fit in uiBufferFullEvents. Called within the recorder's
+ * critical section.
+ *
+ * @param[in] pvData Event data
+ * @param[in] uiSize Event size
+ * @param[out] piBytesCommitted Bytes committed, 0 if the buffer was full
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortTCPIPPush(void* pvData, uint32_t uiSize, int32_t* piBytesCommitted);
+
+/**
+ * @internal Commits a whole event to the send ring, without the internal
+ * buffer. The event is either accepted as a whole or dropped. This is called
+ * within the recorder's critical section, and each full batch is sent from
+ * here, so every traced thread waits for that sendmsg() call.
+ *
+ * @param[in] pvData Event data
+ * @param[in] uiSize Event size
+ * @param[out] piBytesCommitted Bytes committed, 0 if dropped
+ *
+ * @retval TRC_FAIL No room, the event was dropped
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortTCPIPCommit(void* pvData, uint32_t uiSize, int32_t* piBytesCommitted);
+
+/**
+ * @brief Writes data through the stream port interface. The data is added to
+ * the send ring and sent in batches. If the ring is full, fewer bytes than
+ * uiSize are written and the caller keeps the rest.
+ *
+ * @param[in] pvData Data to write
+ * @param[in] uiSize Data to write size
+ * @param[out] piBytesWritten Bytes written
+ *
+ * @retval TRC_FAIL Write failed
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortWriteData(void* pvData, uint32_t uiSize, int32_t* piBytesWritten);
+
+/**
+ * @brief Reads data through the stream port interface. Also sends the data
+ * that is waiting for a full batch, so nothing waits longer than one
+ * xTraceTzCtrl() period.
+ *
+ * @param[in] pvData Destination data buffer
+ * @param[in] uiSize Destination data buffer size
+ * @param[out] piBytesRead Bytes read
+ *
+ * @retval TRC_FAIL Read failed, the connection is closed
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortReadData(void* pvData, uint32_t uiSize, int32_t* piBytesRead);
+
+#define xTraceStreamPortOnEnable(uiStartOption) ((void)(uiStartOption), TRC_SUCCESS)
+
+#define xTraceStreamPortOnDisable() (TRC_SUCCESS)
+
+traceResult xTraceStreamPortOnTraceBegin(void);
+
+traceResult xTraceStreamPortOnTraceEnd(void);
+
+/**
+ * @brief Gets the connection statistics.
+ *
+ * @param[out] pxStatistics Statistics
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStreamPortGetStatistics(TraceStreamPortTCPIPStatistics_t* pxStatistics);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRC_STREAM_PORT_H */
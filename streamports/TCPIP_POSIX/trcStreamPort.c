@@ -0,0 +1,478 @@
+/*
+ * Trace Recorder for Tracealyzer v4.10.3
+ * Copyright 2023 Percepio AB
+ * www.percepio.com
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Supporting functions for trace streaming, used by the "stream ports"
+ * for reading and writing data to the interface.
+ * This stream port uses POSIX sockets. Data is collected in a send ring and
+ * sent in batches, and when the ring is full only part of the data is
+ * accepted, so the internal buffer keeps the rest instead of losing it.
+ */
+
+#include <trcRecorder.h>
+
+#if (TRC_USE_TRACEALYZER_RECORDER == 1)
+
+#if (TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)
+
+#if (((TRC_STREAM_PORT_TCPIP_RING_SIZE) & ((TRC_STREAM_PORT_TCPIP_RING_SIZE) - 1)) != 0)
+#error "TRC_CFG_STREAM_PORT_TCPIP_RING_SIZE must be a power of two."
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#if defined(MSG_NOSIGNAL)
+#define TRC_STREAM_PORT_TCPIP_SEND_FLAGS (MSG_NOSIGNAL | MSG_DONTWAIT)
+#else
+#define TRC_STREAM_PORT_TCPIP_SEND_FLAGS (MSG_DONTWAIT)
+#endif
+
+/* Used if TCP_MAXSEG can't be read */
+#define TRC_STREAM_PORT_TCPIP_DEFAULT_MSS 1460u
+
+/* How long xTraceStreamPortOnTraceEnd waits for the remaining data to be sent */
+#define TRC_STREAM_PORT_TCPIP_FLUSH_TIMEOUT_MS 1000
+
+#if (TRC_USE_INTERNAL_BUFFER == 1)
+/* The ring is only used from TzCtrl */
+#define TRC_STREAM_PORT_TCPIP_ALLOC_CRITICAL_SECTION()
+#define TRC_STREAM_PORT_TCPIP_ENTER_CRITICAL_SECTION()
+#define TRC_STREAM_PORT_TCPIP_EXIT_CRITICAL_SECTION()
+#else
+/* Events are committed from within the recorder's critical section */
+#define TRC_STREAM_PORT_TCPIP_ALLOC_CRITICAL_SECTION() TRACE_ALLOC_CRITICAL_SECTION()
+#define TRC_STREAM_PORT_TCPIP_ENTER_CRITICAL_SECTION() TRACE_ENTER_CRITICAL_SECTION()
+#define TRC_STREAM_PORT_TCPIP_EXIT_CRITICAL_SECTION() TRACE_EXIT_CRITICAL_SECTION()
+#endif
+
+static TraceStreamPortTCPIP_t* pxStreamPortTCPIP TRC_CFG_RECORDER_DATA_ATTRIBUTE;
+
+static traceResult prvTraceTcpConnect(void);
+static void prvTraceTcpClose(void);
+static uint32_t prvTraceTcpCopy(const uint8_t* puiData, uint32_t uiSize);
+static traceResult prvTraceTcpSend(uint32_t uiFlush);
+
+traceResult xTraceStreamPortInitialize(TraceStreamPortBuffer_t* pxBuffer)
+{
+	TRC_ASSERT_EQUAL_SIZE(TraceStreamPortBuffer_t, TraceStreamPortTCPIP_t);
+
+	if (pxBuffer == 0)
+	{
+		return TRC_FAIL;
+	}
+
+	pxStreamPortTCPIP = (TraceStreamPortTCPIP_t*)pxBuffer; /*cstat !MISRAC2004-11.4 !MISRAC2012-Rule-11.3 Suppress conversion between pointer types checks*/
+	pxStreamPortTCPIP->uiRingHead = 0u;
+	pxStreamPortTCPIP->uiRingTail = 0u;
+	pxStreamPortTCPIP->uiBatchSize = 1u;
+	pxStreamPortTCPIP->iListenSocket = -1;
+	pxStreamPortTCPIP->iSocket = -1;
+	(void)memset(&pxStreamPortTCPIP->xStatistics, 0, sizeof(pxStreamPortTCPIP->xStatistics));
+
+#if (TRC_USE_INTERNAL_BUFFER == 1)
+	return xTraceInternalEventBufferInitialize(pxStreamPortTCPIP->buffer, sizeof(pxStreamPortTCPIP->buffer));
+#else
+	return TRC_SUCCESS;
+#endif
+}
+
+#if (TRC_USE_INTERNAL_BUFFER == 1)
+
+traceResult xTraceStreamPortTCPIPAllocate(uint32_t uiSize, void** ppvData)
+{
+	if (xTraceInternalEventBufferAlloc(uiSize, ppvData) == TRC_FAIL)
+	{
+		/* TzCtrl doesn't keep up, the event isn't stored */
+		pxStreamPortTCPIP->xStatistics.uiBufferFullEvents++;
+
+		return TRC_FAIL;
+	}
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceStreamPortTCPIPPush(void* pvData, uint32_t uiSize, int32_t* piBytesCommitted)
+{
+	traceResult xResult = xTraceInternalEventBufferPush(pvData, uiSize, piBytesCommitted);
+
+	if ((xResult == TRC_FAIL) || (*piBytesCommitted == 0))
+	{
+		pxStreamPortTCPIP->xStatistics.uiBufferFullEvents++;
+	}
+
+	return xResult;
+}
+
+#endif
+
+traceResult xTraceStreamPortTCPIPCommit(void* pvData, uint32_t uiSize, int32_t* piBytesCommitted)
+{
+	*piBytesCommitted = 0;
+
+	/* Connections are only accepted from TzCtrl, so there are no extra system calls per event */
+	if (pxStreamPortTCPIP->iSocket < 0)
+	{
+		pxStreamPortTCPIP->xStatistics.uiDroppedEvents++;
+
+		return TRC_SUCCESS;
+	}
+
+	if ((TRC_STREAM_PORT_TCPIP_RING_SIZE) - (pxStreamPortTCPIP->uiRingHead - pxStreamPortTCPIP->uiRingTail) < uiSize)
+	{
+		/* Make room by sending what we have, also a partial batch */
+		(void)prvTraceTcpSend(1u);
+
+		if ((TRC_STREAM_PORT_TCPIP_RING_SIZE) - (pxStreamPortTCPIP->uiRingHead - pxStreamPortTCPIP->uiRingTail) < uiSize)
+		{
+			/* An event is never split, that would corrupt the stream */
+			pxStreamPortTCPIP->xStatistics.uiDroppedEvents++;
+			pxStreamPortTCPIP->xStatistics.uiBackpressure++;
+
+			return TRC_FAIL;
+		}
+	}
+
+	*piBytesCommitted = (int32_t)prvTraceTcpCopy((const uint8_t*)pvData, uiSize);
+
+	/* Only makes a system call when there is a whole batch */
+	(void)prvTraceTcpSend(0u);
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceStreamPortWriteData(void* pvData, uint32_t uiSize, int32_t* piBytesWritten)
+{
+	uint32_t uiWritten = 0u;
+	uint32_t uiCopied;
+
+	*piBytesWritten = 0;
+
+	if (prvTraceTcpConnect() == TRC_FAIL)
+	{
+		return TRC_FAIL;
+	}
+
+	if (pxStreamPortTCPIP->iSocket < 0)
+	{
+		/* No host yet, the caller keeps the data */
+		return TRC_SUCCESS;
+	}
+
+	do
+	{
+		uiCopied = prvTraceTcpCopy(&((const uint8_t*)pvData)[uiWritten], uiSize - uiWritten);
+		uiWritten += uiCopied;
+
+		if (prvTraceTcpSend(0u) == TRC_FAIL)
+		{
+			/* The connection is closed, the data can't be sent anyway */
+			*piBytesWritten = (int32_t)uiSize;
+
+			return TRC_FAIL;
+		}
+	} while ((uiWritten < uiSize) && (uiCopied > 0u));
+
+	if (uiWritten < uiSize)
+	{
+		/* The socket can't keep up, the rest stays in the internal buffer */
+		pxStreamPortTCPIP->xStatistics.uiBackpressure++;
+	}
+
+	*piBytesWritten = (int32_t)uiWritten;
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceStreamPortReadData(void* pvData, uint32_t uiSize, int32_t* piBytesRead)
+{
+	traceResult xResult;
+	ssize_t iRead;
+
+	TRC_STREAM_PORT_TCPIP_ALLOC_CRITICAL_SECTION();
+
+	*piBytesRead = 0;
+
+	if (prvTraceTcpConnect() == TRC_FAIL)
+	{
+		return TRC_FAIL;
+	}
+
+	if (pxStreamPortTCPIP->iSocket < 0)
+	{
+		return TRC_SUCCESS;
+	}
+
+	/* Called once per xTraceTzCtrl(), send what is left of the previous batch */
+	TRC_STREAM_PORT_TCPIP_ENTER_CRITICAL_SECTION();
+	xResult = prvTraceTcpSend(1u);
+	TRC_STREAM_PORT_TCPIP_EXIT_CRITICAL_SECTION();
+
+	if (xResult == TRC_FAIL)
+	{
+		return TRC_FAIL;
+	}
+
+	iRead = recv(pxStreamPortTCPIP->iSocket, pvData, (size_t)uiSize, MSG_DONTWAIT);
+	if (iRead > 0)
+	{
+		*piBytesRead = (int32_t)iRead;
+	}
+	else if ((iRead == 0) || ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR)))
+	{
+		/* The host closed the connection */
+		TRC_STREAM_PORT_TCPIP_ENTER_CRITICAL_SECTION();
+		prvTraceTcpClose();
+		TRC_STREAM_PORT_TCPIP_EXIT_CRITICAL_SECTION();
+
+		return TRC_FAIL;
+	}
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceStreamPortOnTraceBegin(void)
+{
+	/* A new session, anything left from the previous one is not valid anymore */
+	pxStreamPortTCPIP->uiRingHead = 0u;
+	pxStreamPortTCPIP->uiRingTail = 0u;
+
+	return prvTraceTcpConnect();
+}
+
+traceResult xTraceStreamPortOnTraceEnd(void)
+{
+	struct pollfd xPoll;
+	uint32_t uiWaited = 0u;
+
+	while ((pxStreamPortTCPIP->iSocket >= 0) && (pxStreamPortTCPIP->uiRingHead != pxStreamPortTCPIP->uiRingTail) && (uiWaited < (TRC_STREAM_PORT_TCPIP_FLUSH_TIMEOUT_MS)))
+	{
+		if (prvTraceTcpSend(1u) == TRC_FAIL)
+		{
+			break;
+		}
+
+		if (pxStreamPortTCPIP->uiRingHead != pxStreamPortTCPIP->uiRingTail)
+		{
+			xPoll.fd = pxStreamPortTCPIP->iSocket;
+			xPoll.events = POLLOUT;
+			(void)poll(&xPoll, 1, 10);
+			uiWaited += 10u;
+		}
+	}
+
+	prvTraceTcpClose();
+
+	if (pxStreamPortTCPIP->iListenSocket >= 0)
+	{
+		(void)close(pxStreamPortTCPIP->iListenSocket);
+		pxStreamPortTCPIP->iListenSocket = -1;
+	}
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceStreamPortGetStatistics(TraceStreamPortTCPIPStatistics_t* pxStatistics)
+{
+	TRC_ASSERT(pxStatistics != (void*)0);
+
+	*pxStatistics = pxStreamPortTCPIP->xStatistics;
+
+	return TRC_SUCCESS;
+}
+
+/* Creates the listening socket if needed, and accepts a host connection without blocking */
+static traceResult prvTraceTcpConnect(void)
+{
+	struct sockaddr_in xAddress;
+	int iSocket;
+	int iValue = 1;
+	socklen_t xLength;
+
+	if (pxStreamPortTCPIP->iListenSocket < 0)
+	{
+		iSocket = socket(AF_INET, SOCK_STREAM, 0);
+		if (iSocket < 0)
+		{
+			return TRC_FAIL;
+		}
+
+		(void)setsockopt(iSocket, SOL_SOCKET, SO_REUSEADDR, &iValue, sizeof(iValue));
+
+		(void)memset(&xAddress, 0, sizeof(xAddress));
+		xAddress.sin_family = AF_INET;
+		xAddress.sin_port = htons(TRC_CFG_STREAM_PORT_TCPIP_PORT);
+		xAddress.sin_addr.s_addr = htonl(INADDR_ANY);
+
+		if ((bind(iSocket, (struct sockaddr*)&xAddress, sizeof(xAddress)) < 0) ||
+			(listen(iSocket, 1) < 0) ||
+			(fcntl(iSocket, F_SETFL, fcntl(iSocket, F_GETFL, 0) | O_NONBLOCK) < 0))
+		{
+			(void)close(iSocket);
+
+			return TRC_FAIL;
+		}
+
+		pxStreamPortTCPIP->iListenSocket = iSocket;
+	}
+
+	if (pxStreamPortTCPIP->iSocket >= 0)
+	{
+		return TRC_SUCCESS;
+	}
+
+	iSocket = accept(pxStreamPortTCPIP->iListenSocket, (struct sockaddr*)0, (socklen_t*)0);
+	if (iSocket < 0)
+	{
+		/* No host connected yet */
+		return TRC_SUCCESS;
+	}
+
+	(void)fcntl(iSocket, F_SETFL, fcntl(iSocket, F_GETFL, 0) | O_NONBLOCK);
+
+	/* Batching is done here, so segments should go out as soon as they are full */
+	(void)setsockopt(iSocket, IPPROTO_TCP, TCP_NODELAY, &iValue, sizeof(iValue));
+
+#if defined(SO_NOSIGPIPE)
+	(void)setsockopt(iSocket, SOL_SOCKET, SO_NOSIGPIPE, &iValue, sizeof(iValue));
+#endif
+
+#if ((TRC_CFG_STREAM_PORT_TCPIP_BATCH_SIZE) > 0)
+	pxStreamPortTCPIP->uiBatchSize = (TRC_CFG_STREAM_PORT_TCPIP_BATCH_SIZE);
+#else
+	iValue = 0;
+	xLength = (socklen_t)sizeof(iValue);
+	if ((getsockopt(iSocket, IPPROTO_TCP, TCP_MAXSEG, &iValue, &xLength) < 0) || (iValue <= 0))
+	{
+		iValue = (int)(TRC_STREAM_PORT_TCPIP_DEFAULT_MSS);
+	}
+	pxStreamPortTCPIP->uiBatchSize = (uint32_t)iValue;
+#endif
+	(void)xLength;
+
+	pxStreamPortTCPIP->iSocket = iSocket;
+
+	return TRC_SUCCESS;
+}
+
+static void prvTraceTcpClose(void)
+{
+	if (pxStreamPortTCPIP->iSocket >= 0)
+	{
+		(void)close(pxStreamPortTCPIP->iSocket);
+		pxStreamPortTCPIP->iSocket = -1;
+	}
+
+	/* Nothing left to send it to */
+	pxStreamPortTCPIP->uiRingTail = pxStreamPortTCPIP->uiRingHead;
+}
+
+/* Copies as much as fits into the send ring */
+static uint32_t prvTraceTcpCopy(const uint8_t* puiData, uint32_t uiSize)
+{
+	uint32_t uiFree = (TRC_STREAM_PORT_TCPIP_RING_SIZE) - (pxStreamPortTCPIP->uiRingHead - pxStreamPortTCPIP->uiRingTail);
+	uint32_t uiHead = pxStreamPortTCPIP->uiRingHead & ((TRC_STREAM_PORT_TCPIP_RING_SIZE) - 1u);
+	uint32_t uiFirst;
+
+	if (uiSize > uiFree)
+	{
+		uiSize = uiFree;
+	}
+
+	uiFirst = (TRC_STREAM_PORT_TCPIP_RING_SIZE) - uiHead;
+	if (uiFirst > uiSize)
+	{
+		uiFirst = uiSize;
+	}
+
+	(void)memcpy(&pxStreamPortTCPIP->uiRing[uiHead], puiData, uiFirst);
+	(void)memcpy(&pxStreamPortTCPIP->uiRing[0], &puiData[uiFirst], uiSize - uiFirst);
+
+	pxStreamPortTCPIP->uiRingHead += uiSize;
+
+	return uiSize;
+}
+
+/* Sends whole batches from the ring, or everything if uiFlush is set. Stops when the socket buffer is full. */
+static traceResult prvTraceTcpSend(uint32_t uiFlush)
+{
+	struct iovec xVectors[2];
+	struct msghdr xMessage;
+	uint32_t uiUsed;
+	uint32_t uiLength;
+	uint32_t uiTail;
+	uint32_t uiFirst;
+	ssize_t iSent;
+
+	while (pxStreamPortTCPIP->iSocket >= 0)
+	{
+		uiUsed = pxStreamPortTCPIP->uiRingHead - pxStreamPortTCPIP->uiRingTail;
+		uiLength = (uiFlush != 0u) ? uiUsed : (uiUsed - (uiUsed % pxStreamPortTCPIP->uiBatchSize));
+		if (uiLength == 0u)
+		{
+			break;
+		}
+
+		uiTail = pxStreamPortTCPIP->uiRingTail & ((TRC_STREAM_PORT_TCPIP_RING_SIZE) - 1u);
+		uiFirst = (TRC_STREAM_PORT_TCPIP_RING_SIZE) - uiTail;
+		if (uiFirst > uiLength)
+		{
+			uiFirst = uiLength;
+		}
+
+		/* A wrapped region goes out in one call */
+		xVectors[0].iov_base = &pxStreamPortTCPIP->uiRing[uiTail];
+		xVectors[0].iov_len = uiFirst;
+		xVectors[1].iov_base = &pxStreamPortTCPIP->uiRing[0];
+		xVectors[1].iov_len = uiLength - uiFirst;
+
+		(void)memset(&xMessage, 0, sizeof(xMessage));
+		xMessage.msg_iov = xVectors;
+		xMessage.msg_iovlen = (uiLength > uiFirst) ? 2 : 1;
+
+		pxStreamPortTCPIP->xStatistics.uiSendCalls++;
+		iSent = sendmsg(pxStreamPortTCPIP->iSocket, &xMessage, TRC_STREAM_PORT_TCPIP_SEND_FLAGS);
+		if (iSent < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			if ((errno == EAGAIN) || (errno == EWOULDBLOCK))
+			{
+				/* The socket buffer is full, the data stays in the ring */
+				break;
+			}
+
+			prvTraceTcpClose();
+
+			return TRC_FAIL;
+		}
+
+		pxStreamPortTCPIP->uiRingTail += (uint32_t)iSent;
+		pxStreamPortTCPIP->xStatistics.ulBytesSent += (uint64_t)iSent;
+
+		if ((uint32_t)iSent < uiLength)
+		{
+			/* Partial send, the socket buffer is full */
+			break;
+		}
+	}
+
+	return TRC_SUCCESS;
+}
+
+#endif /*(TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)*/
+
+#endif /*(TRC_USE_TRACEALYZER_RECORDER == 1)*/
@@ -39,6 +39,12 @@ extern "C" {
 
 #define TRC_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT (TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT)
 
+#ifdef TRC_CFG_STREAM_PORT_WRITE_COMBINE_SIZE
+#define TRC_WRITE_COMBINE_SIZE (TRC_CFG_STREAM_PORT_WRITE_COMBINE_SIZE)
+
+#define TRC_WRITE_COMBINE_FLUSH_PERIOD (TRC_CFG_STREAM_PORT_WRITE_COMBINE_FLUSH_PERIOD)
+#endif
+
 typedef struct TraceStreamPortBuffer	/* Aligned */
 {
 #if (TRC_USE_INTERNAL_BUFFER)
@@ -68,6 +74,8 @@ traceResult xTraceStreamPortInitialize(TraceStreamPortBuffer_t* pxBuffer);
 	#else
 		#define xTraceStreamPortAllocate(uiSize, ppvData) ((void)(uiSize), xTraceInternalEventBufferAlloc(uiSize, ppvData))
 	#endif
+#elif defined(TRC_WRITE_COMBINE_SIZE) && ((TRC_WRITE_COMBINE_SIZE) > 0)
+	#define xTraceStreamPortAllocate xTraceWriteCombineAlloc
 #else
 	#define xTraceStreamPortAllocate(uiSize, ppvData) ((void)(uiSize), xTraceStaticBufferGet(ppvData))
 #endif
@@ -90,6 +98,8 @@ traceResult xTraceStreamPortInitialize(TraceStreamPortBuffer_t* pxBuffer);
 	#else
 		#define xTraceStreamPortCommit xTraceInternalEventBufferAllocCommit
 	#endif
+#elif defined(TRC_WRITE_COMBINE_SIZE) && ((TRC_WRITE_COMBINE_SIZE) > 0)
+	#define xTraceStreamPortCommit xTraceWriteCombineCommit
 #else
 	#define xTraceStreamPortCommit xTraceStreamPortWriteData
 #endif
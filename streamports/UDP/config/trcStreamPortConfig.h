@@ -18,7 +18,8 @@ extern "C" {
 /**
  * @def TRC_CFG_STREAM_PORT_UDP_ADDRESS
  *
- * @brief Specifies the UDP address.
+ * @brief Specifies the UDP address. The trace is sent here until a command is
+ * received from the host, after that it is sent to the sender of the command.
  */
 #define TRC_CFG_STREAM_PORT_UDP_ADDRESS "192.168.1.100"
 
@@ -30,62 +31,35 @@ extern "C" {
 #define TRC_CFG_STREAM_PORT_UDP_PORT 8888
 
 /**
- * @def TRC_CFG_STREAM_PORT_USE_INTERNAL_BUFFER
+ * @def TRC_CFG_STREAM_PORT_UDP_PACKET_SIZE
  *
- * @brief This define will determine whether to use the internal buffer or not.
- * If file writing creates additional trace events (i.e. it uses semaphores or mutexes),
- * then the internal buffer must be enabled to avoid infinite recursion.
+ * @brief The size of each datagram, including the frame header if framing is
+ * enabled. 1472 fills an Ethernet frame (MTU 1500) without IP fragmentation.
+ * Max 65507.
  */
-#define TRC_CFG_STREAM_PORT_USE_INTERNAL_BUFFER 1
+#define TRC_CFG_STREAM_PORT_UDP_PACKET_SIZE 1472
 
 /**
- * @def TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_SIZE
+ * @def TRC_CFG_STREAM_PORT_UDP_PACKET_COUNT
  *
- * @brief Configures the size of the internal buffer if used.
+ * @brief The number of datagrams in the packet ring. Events are collected in
+ * the ring and sent from xTraceTzCtrl(), if the ring is full the event is
+ * dropped. The ring takes the place of the internal buffer, so this should be
+ * large enough to hold the trace data produced between two xTraceTzCtrl()
+ * calls. Minimum 2.
  */
-#define TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_SIZE 10240
+#define TRC_CFG_STREAM_PORT_UDP_PACKET_COUNT 8
 
 /**
- * @def TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_WRITE_MODE
+ * @def TRC_CFG_STREAM_PORT_UDP_FRAMING
  *
- * @brief This should be set to TRC_INTERNAL_EVENT_BUFFER_OPTION_WRITE_MODE_DIRECT for best performance.
+ * @brief Set to 1 to start each datagram with a frame header holding a
+ * sequence number and the offset of the first whole event, so that a lost
+ * datagram only loses the events in it. The framed stream is received by
+ * extras/UDPReceiver, which reports the gaps and writes the trace. Set to 0
+ * to send the trace data as is, which Tracealyzer can receive directly.
  */
-#define TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_WRITE_MODE TRC_INTERNAL_EVENT_BUFFER_OPTION_WRITE_MODE_DIRECT
-
-/**
- * @def TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_TRANSFER_MODE
- *
- * @brief Defines if the internal buffer will attempt to transfer all data each time or limit it to a chunk size.
- */
-#define TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_TRANSFER_MODE TRC_INTERNAL_EVENT_BUFFER_OPTION_TRANSFER_MODE_ALL
-
-/**
- * @def TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_SIZE
- *
- * @brief Defines the maximum chunk size when transferring
- * internal buffer events in chunks.
- */
-#define TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_SIZE 1024
-
-/**
- * @def TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_SIZE_LIMIT
- *
- * @brief Defines the number of transferred bytes needed to trigger another transfer.
- * It also depends on TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT to set a maximum number
- * of additional transfers this loop.
- * This will increase throughput by immediately doing a transfer and not wait for another xTraceTzCtrl() loop.
- */
-#define TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_SIZE_LIMIT 256
-
-/**
- * @def TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT
- *
- * @brief Defines the maximum number of times to trigger another transfer before returning to xTraceTzCtrl().
- * It also depends on TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_SIZE_LIMIT to see if a meaningful amount of data was
- * transferred in the last loop.
- * This will increase throughput by immediately doing a transfer and not wait for another xTraceTzCtrl() loop.
- */
-#define TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT 5
+#define TRC_CFG_STREAM_PORT_UDP_FRAMING 0
 
 #ifdef __cplusplus
 }
@@ -7,7 +7,8 @@
  *
  * The interface definitions for trace streaming ("stream ports").
  * This "stream port" sets up the recorder to use UDP as streaming channel.
- * The example is for lwIP.
+ * The example is for lwIP, with the POSIX hardware port the host's sockets
+ * are used instead.
  */
 
 #ifndef TRC_STREAM_PORT_H
@@ -21,27 +22,67 @@
 extern "C" {
 #endif
 
-#define TRC_ALIGNED_STREAM_PORT_BUFFER_SIZE ((((TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_SIZE) + sizeof(TraceUnsignedBaseType_t) - 1) / sizeof(TraceUnsignedBaseType_t)) * sizeof(TraceUnsignedBaseType_t))
+/* Events are collected into datagrams in the packet ring, which takes the place of the internal buffer */
+#define TRC_USE_INTERNAL_BUFFER 0
 
-#define TRC_USE_INTERNAL_BUFFER (TRC_CFG_STREAM_PORT_USE_INTERNAL_BUFFER)
+#define TRC_STREAM_PORT_UDP_FRAME_MAGIC 0x5446u
 
-#define TRC_INTERNAL_EVENT_BUFFER_WRITE_MODE (TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_WRITE_MODE)
+#define TRC_STREAM_PORT_UDP_FRAME_VERSION 1u
 
-#define TRC_INTERNAL_EVENT_BUFFER_TRANSFER_MODE (TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_TRANSFER_MODE)
+/* Set on the first datagram of a session, its payload starts with the trace header */
+#define TRC_STREAM_PORT_UDP_FRAME_FLAG_SESSION_START 0x01u
 
-#define TRC_INTERNAL_BUFFER_CHUNK_SIZE (TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_SIZE)
+/* Set on the last datagram of a session */
+#define TRC_STREAM_PORT_UDP_FRAME_FLAG_SESSION_END 0x02u
 
-#define TRC_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_SIZE_LIMIT (TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_SIZE_LIMIT)
+/* uiFirstEvent when no event starts in the datagram, an event continues through all of it */
+#define TRC_STREAM_PORT_UDP_FRAME_NO_EVENT 0xFFFFu
 
-#define TRC_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT (TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT)
-
-typedef struct TraceStreamPortBuffer	/* Aligned */
+/**
+ * @brief The frame header at the start of each datagram if
+ * TRC_CFG_STREAM_PORT_UDP_FRAMING is 1. It is in the byte order of the
+ * target, the receiver can tell from uiMagic. The payload bytes from
+ * uiFirstEvent to uiEventsEnd are whole events, the bytes before belong to an
+ * event from the previous datagram and the bytes after to an event that
+ * continues in the next. If a datagram is lost, the receiver drops the partial
+ * events on both sides of the gap and continues at uiFirstEvent.
+ */
+typedef struct TraceStreamPortUDPFrame
 {
-#if (TRC_USE_INTERNAL_BUFFER)
-	uint8_t buffer[(TRC_ALIGNED_STREAM_PORT_BUFFER_SIZE)];
+	uint16_t uiMagic;			/* TRC_STREAM_PORT_UDP_FRAME_MAGIC */
+	uint8_t uiVersion;			/* TRC_STREAM_PORT_UDP_FRAME_VERSION */
+	uint8_t uiFlags;			/* TRC_STREAM_PORT_UDP_FRAME_FLAG_* */
+	uint32_t uiSequence;		/* Datagram number, from 0 at the start of each session */
+	uint16_t uiFirstEvent;		/* Payload offset of the first event that starts in this datagram */
+	uint16_t uiEventsEnd;		/* Payload offset where the whole events end, the rest continues in the next datagram */
+	uint32_t uiDroppedEvents;	/* Events dropped by the target in this session so far */
+} TraceStreamPortUDPFrame_t;
+
+#if (TRC_CFG_STREAM_PORT_UDP_FRAMING == 1)
+#define TRC_STREAM_PORT_UDP_FRAME_SIZE (sizeof(TraceStreamPortUDPFrame_t))
 #else
-	TraceUnsignedBaseType_t buffer[1];
+#define TRC_STREAM_PORT_UDP_FRAME_SIZE 0u
 #endif
+
+#define TRC_STREAM_PORT_UDP_ALIGNED_PACKET_SIZE ((((TRC_CFG_STREAM_PORT_UDP_PACKET_SIZE) + sizeof(TraceUnsignedBaseType_t) - 1) / sizeof(TraceUnsignedBaseType_t)) * sizeof(TraceUnsignedBaseType_t))
+
+typedef struct TraceStreamPortUDP	/* Aligned */
+{
+	uint8_t uiPackets[TRC_CFG_STREAM_PORT_UDP_PACKET_COUNT][TRC_STREAM_PORT_UDP_ALIGNED_PACKET_SIZE];
+	uint16_t uiPacketSize[TRC_CFG_STREAM_PORT_UDP_PACKET_COUNT];	/* Datagram size of completed packets */
+	uint32_t uiFill;			/* Packet being filled */
+	uint32_t uiFillSize;		/* Bytes in the packet being filled, including the frame header */
+	uint32_t uiFillFirstEvent;	/* Payload offset of the first event in the packet being filled */
+	uint32_t uiFillFlags;
+	uint32_t uiSend;			/* Oldest completed packet */
+	uint32_t uiCompleted;		/* Completed packets waiting to be sent */
+	uint32_t uiSequence;		/* Sequence number of the next completed packet */
+	uint32_t uiDroppedEvents;
+} TraceStreamPortUDP_t;
+
+typedef struct TraceStreamPortBuffer	/* Aligned */
+{
+	uint8_t buffer[sizeof(TraceStreamPortUDP_t)];
 } TraceStreamPortBuffer_t;
 
 int32_t prvTraceUdpWrite(void* pvData, uint32_t uiSize, int32_t* piBytesWritten);
@@ -59,20 +100,13 @@ traceResult xTraceStreamPortInitialize(TraceStreamPortBuffer_t* pxBuffer);
  * @retval TRC_FAIL Allocate failed
  * @retval TRC_SUCCESS Success
  */
-#if (TRC_USE_INTERNAL_BUFFER == 1)
-	#if (TRC_INTERNAL_EVENT_BUFFER_WRITE_MODE == TRC_INTERNAL_EVENT_BUFFER_OPTION_WRITE_MODE_COPY)
-		#define xTraceStreamPortAllocate(uiSize, ppvData) ((void)(uiSize), xTraceStaticBufferGet(ppvData))
-	#else
-		#define xTraceStreamPortAllocate(uiSize, ppvData) ((void)(uiSize), xTraceInternalEventBufferAlloc(uiSize, ppvData))
-	#endif
-#else
-	#define xTraceStreamPortAllocate(uiSize, ppvData) ((void)(uiSize), xTraceStaticBufferGet(ppvData))
-#endif
+#define xTraceStreamPortAllocate(uiSize, ppvData) ((void)(uiSize), xTraceStaticBufferGet(ppvData))
 
 /**
- * @brief Commits data to the stream port, depending on the implementation/configuration of the
- * stream port this data might be directly written to the stream port interface, buffered, or
- * something else.
+ * @brief Commits data to the stream port. The event is copied into the packet
+ * ring, where it may continue into the next datagram. If the ring doesn't have
+ * room for the whole event it is dropped and counted, nothing is sent from
+ * here.
  * 
  * @param[in] pvData Data to commit
  * @param[in] uiSize Data to commit size
@@ -81,25 +115,30 @@ traceResult xTraceStreamPortInitialize(TraceStreamPortBuffer_t* pxBuffer);
  * @retval TRC_FAIL Commit failed
  * @retval TRC_SUCCESS Success
  */
-#if (TRC_USE_INTERNAL_BUFFER == 1)
-	#if (TRC_INTERNAL_EVENT_BUFFER_WRITE_MODE == TRC_INTERNAL_EVENT_BUFFER_OPTION_WRITE_MODE_COPY)
-		#define xTraceStreamPortCommit xTraceInternalEventBufferPush
-	#else
-		#define xTraceStreamPortCommit xTraceInternalEventBufferAllocCommit
-	#endif
-#else
-	#define xTraceStreamPortCommit xTraceStreamPortWriteData
-#endif
+#define xTraceStreamPortCommit(pvData, uiSize, piBytesCommitted) (prvTraceUdpWrite(pvData, uiSize, piBytesCommitted) == 0 ? TRC_SUCCESS : TRC_FAIL)
 
 #define xTraceStreamPortWriteData(pvData, uiSize, piBytesWritten) (prvTraceUdpWrite(pvData, uiSize, piBytesWritten) == 0 ? TRC_SUCCESS : TRC_FAIL)
 
+/**
+ * @brief Reads data through the stream port interface. Called from
+ * xTraceTzCtrl(), this is also where the completed datagrams are sent, and
+ * the packet being filled, so no data waits longer than one xTraceTzCtrl()
+ * period.
+ *
+ * @param[in] pvData Destination data buffer
+ * @param[in] uiSize Destination data buffer size
+ * @param[out] piBytesRead Bytes read
+ *
+ * @retval TRC_FAIL Read failed
+ * @retval TRC_SUCCESS Success
+ */
 #define xTraceStreamPortReadData(pvData, uiSize, piBytesRead) (prvTraceUdpRead(pvData, uiSize, piBytesRead) == 0 ? TRC_SUCCESS : TRC_FAIL)
 
 #define xTraceStreamPortOnEnable(uiStartOption) ((void)(uiStartOption), TRC_SUCCESS)
 
 #define xTraceStreamPortOnDisable() (TRC_SUCCESS)
 
-#define xTraceStreamPortOnTraceBegin() (TRC_SUCCESS)
+traceResult xTraceStreamPortOnTraceBegin(void);
 
 traceResult xTraceStreamPortOnTraceEnd(void);
 
@@ -108,4 +147,3 @@ traceResult xTraceStreamPortOnTraceEnd(void);
 #endif
 
 #endif /* TRC_STREAM_PORT_H */
-
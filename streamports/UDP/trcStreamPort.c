@@ -9,6 +9,11 @@
  * for reading and writing data to the interface.
  * Existing ports can easily be modified to fit another setup, e.g., a 
  * different UDP stack, or to define your own stream port.
+ *
+ * Events are collected into datagrams in a packet ring from within the
+ * recorder's critical section, and the completed datagrams are sent from
+ * xTraceTzCtrl(). With TRC_CFG_STREAM_PORT_UDP_FRAMING each datagram starts
+ * with a TraceStreamPortUDPFrame_t.
  */
 
 #include <trcRecorder.h>
@@ -17,28 +22,39 @@
 
 #if (TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)
 
+#if ((TRC_CFG_STREAM_PORT_UDP_PACKET_COUNT) < 2)
+#error "TRC_CFG_STREAM_PORT_UDP_PACKET_COUNT must be at least 2."
+#endif
+
+#if ((TRC_CFG_STREAM_PORT_UDP_PACKET_SIZE) > 65507)
+#error "TRC_CFG_STREAM_PORT_UDP_PACKET_SIZE can't be larger than 65507."
+#endif
+
+#if (TRC_CFG_HARDWARE_PORT == TRC_HARDWARE_PORT_POSIX)
+/* udp includes - the host's sockets */
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#else
 /* udp includes - for lwIP in this case */
 #include <lwip/sockets.h>
 #include <lwip/errno.h>
+#endif
 
 int sock = -1;
-int remoteSize;
 struct sockaddr_in address_out;
 
-typedef struct TraceStreamPortUDP
-{
-#if (TRC_USE_INTERNAL_BUFFER)
-	uint8_t buffer[(TRC_ALIGNED_STREAM_PORT_BUFFER_SIZE)];
-#else
-	TraceUnsignedBaseType_t buffer[1];
-#endif
-} TraceStreamPortUDP_t;
-
 static TraceStreamPortUDP_t* pxStreamPortUDP TRC_CFG_RECORDER_DATA_ATTRIBUTE;
 
 static int32_t prvSocketSend(void* pvData, uint32_t uiSize, int32_t* piBytesWritten);
 static int32_t prvSocketReceive(void* pvData, uint32_t uiSize, int32_t* piBytesRead);
 static int32_t prvSocketInitialize(void);
+static void prvTraceUdpComplete(uint32_t uiEventsEnd);
+static void prvTraceUdpFlush(void);
 
 static int32_t prvSocketSend( void* pvData, uint32_t uiSize, int32_t* piBytesWritten )
 {
@@ -59,7 +75,7 @@ static int32_t prvSocketSend( void* pvData, uint32_t uiSize, int32_t* piBytesWri
 		*piBytesWritten = 0;
 		
 		/* EWOULDBLOCK may be expected when buffers are full */
-		if (errno != EWOULDBLOCK)
+		if ((errno != EWOULDBLOCK) && (errno != ENOBUFS))
 		{
 			close(sock);
 			sock = -1;
@@ -72,13 +88,16 @@ static int32_t prvSocketSend( void* pvData, uint32_t uiSize, int32_t* piBytesWri
 
 static int32_t prvSocketReceive( void* pvData, uint32_t uiSize, int32_t* piBytesRead )
 {
+	struct sockaddr_in address_in;
+	socklen_t address_size = sizeof(address_in);
+
 	if (sock < 0)
 		return -1;
 	
 	if (piBytesRead == (void*)0)
 		return -1;
 
-	*piBytesRead = recv( sock, pvData, uiSize, 0 );
+	*piBytesRead = recvfrom( sock, pvData, uiSize, 0, (struct sockaddr*)&address_in, &address_size );
 	
 	if (*piBytesRead < 0)
 	{
@@ -92,6 +111,11 @@ static int32_t prvSocketReceive( void* pvData, uint32_t uiSize, int32_t* piBytes
 		return -1;
 		}
 	}
+	else if (address_size == sizeof(address_in))
+	{
+		/* Send the trace to the host that sent the command */
+		address_out = address_in;
+	}
 
 	return 0;
 }
@@ -127,27 +151,121 @@ static int32_t prvSocketInitialize(void)
 	flags = fcntl( sock, F_GETFL, 0 );
 	fcntl( sock, F_SETFL, flags | O_NONBLOCK );
 
-	address_out.sin_family = AF_INET;
-	address_out.sin_port = htons(TRC_CFG_STREAM_PORT_UDP_PORT);
-	address_out.sin_addr.s_addr = inet_addr(TRC_CFG_STREAM_PORT_UDP_ADDRESS);
+	if (address_out.sin_family != AF_INET)
+	{
+		address_out.sin_family = AF_INET;
+		address_out.sin_port = htons(TRC_CFG_STREAM_PORT_UDP_PORT);
+		address_out.sin_addr.s_addr = inet_addr(TRC_CFG_STREAM_PORT_UDP_ADDRESS);
+	}
 
 	return 0;
 }
 
 /************** MODIFY THE ABOVE PART TO USE YOUR UDP STACK ****************/
 
+/* Called from within the recorder's critical section. The event is copied as a whole or dropped, never in part. */
 int32_t prvTraceUdpWrite(void* pvData, uint32_t uiSize, int32_t *piBytesWritten)
 {
-	prvSocketInitialize();
-	
-	return prvSocketSend(pvData, uiSize, piBytesWritten);
+	const uint8_t* puiData = (const uint8_t*)pvData;
+	uint32_t uiFree;
+	uint32_t uiCopy;
+	uint32_t uiEventStart;
+
+	*piBytesWritten = 0;
+
+	if ((pxStreamPortUDP->uiFillSize == (TRC_CFG_STREAM_PORT_UDP_PACKET_SIZE)) && (pxStreamPortUDP->uiCompleted < ((TRC_CFG_STREAM_PORT_UDP_PACKET_COUNT) - 1u)))
+	{
+		prvTraceUdpComplete((TRC_CFG_STREAM_PORT_UDP_PACKET_SIZE) - (TRC_STREAM_PORT_UDP_FRAME_SIZE));
+	}
+
+	uiFree = ((TRC_CFG_STREAM_PORT_UDP_PACKET_SIZE) - pxStreamPortUDP->uiFillSize) +
+		((TRC_CFG_STREAM_PORT_UDP_PACKET_COUNT) - 1u - pxStreamPortUDP->uiCompleted) * ((TRC_CFG_STREAM_PORT_UDP_PACKET_SIZE) - (TRC_STREAM_PORT_UDP_FRAME_SIZE));
+
+	if (uiSize > uiFree)
+	{
+		/* Sending from here could recurse into the recorder, so the event is dropped until xTraceTzCtrl() catches up */
+		pxStreamPortUDP->uiDroppedEvents++;
+
+		/* Not a failure, the event is gone and retrying would never succeed inside the critical section */
+		return 0;
+	}
+
+	uiEventStart = pxStreamPortUDP->uiFillSize - (TRC_STREAM_PORT_UDP_FRAME_SIZE);
+
+	if (pxStreamPortUDP->uiFillFirstEvent == TRC_STREAM_PORT_UDP_FRAME_NO_EVENT)
+	{
+		pxStreamPortUDP->uiFillFirstEvent = uiEventStart;
+	}
+
+	while (uiSize > 0u)
+	{
+		uiCopy = (TRC_CFG_STREAM_PORT_UDP_PACKET_SIZE) - pxStreamPortUDP->uiFillSize;
+		if (uiCopy > uiSize)
+		{
+			uiCopy = uiSize;
+		}
+
+		(void)memcpy(&pxStreamPortUDP->uiPackets[pxStreamPortUDP->uiFill][pxStreamPortUDP->uiFillSize], puiData, uiCopy);
+		pxStreamPortUDP->uiFillSize += uiCopy;
+		puiData = &puiData[uiCopy];
+		uiSize -= uiCopy;
+		*piBytesWritten += (int32_t)uiCopy;
+
+		/* The room check above guarantees that there is a free packet if anything is left */
+		if ((pxStreamPortUDP->uiFillSize == (TRC_CFG_STREAM_PORT_UDP_PACKET_SIZE)) && (pxStreamPortUDP->uiCompleted < ((TRC_CFG_STREAM_PORT_UDP_PACKET_COUNT) - 1u)))
+		{
+			/* If the event continues in the next packet, the whole events end where it started, or at 0 if it started in an earlier packet */
+			prvTraceUdpComplete((uiSize > 0u) ? uiEventStart : ((TRC_CFG_STREAM_PORT_UDP_PACKET_SIZE) - (TRC_STREAM_PORT_UDP_FRAME_SIZE)));
+			uiEventStart = 0u;
+		}
+	}
+
+	return 0;
 }
 
 int32_t prvTraceUdpRead(void* pvData, uint32_t uiSize, int32_t *piBytesRead)
 {
-	prvSocketInitialize();
-			
-	return prvSocketReceive(pvData, uiSize, piBytesRead);
+	uint32_t uiSend;
+	uint32_t uiCompleted;
+	uint32_t uiSent = 0u;
+	int32_t iResult;
+	int32_t iBytesWritten = 0;
+
+	TRACE_ALLOC_CRITICAL_SECTION();
+
+	if (prvSocketInitialize() != 0)
+	{
+		return -1;
+	}
+
+	iResult = prvSocketReceive(pvData, uiSize, piBytesRead);
+
+	TRACE_ENTER_CRITICAL_SECTION();
+	prvTraceUdpFlush();
+	uiSend = pxStreamPortUDP->uiSend;
+	uiCompleted = pxStreamPortUDP->uiCompleted;
+	TRACE_EXIT_CRITICAL_SECTION();
+
+	/* Completed packets are not touched by the recorder until they are released below, so they are sent outside of the critical section */
+	while ((iResult == 0) && (uiSent < uiCompleted))
+	{
+		iResult = prvSocketSend(pxStreamPortUDP->uiPackets[uiSend], pxStreamPortUDP->uiPacketSize[uiSend], &iBytesWritten);
+		if (iBytesWritten == 0)
+		{
+			/* The socket buffer is full, try again next time */
+			break;
+		}
+
+		uiSend = (uiSend + 1u) % (TRC_CFG_STREAM_PORT_UDP_PACKET_COUNT);
+		uiSent++;
+	}
+
+	TRACE_ENTER_CRITICAL_SECTION();
+	pxStreamPortUDP->uiSend = uiSend;
+	pxStreamPortUDP->uiCompleted -= uiSent;
+	TRACE_EXIT_CRITICAL_SECTION();
+
+	return iResult;
 }
 
 traceResult xTraceStreamPortInitialize(TraceStreamPortBuffer_t* pxBuffer)
@@ -159,25 +277,90 @@ traceResult xTraceStreamPortInitialize(TraceStreamPortBuffer_t* pxBuffer)
 		return TRC_FAIL;
 	}
 
-	pxStreamPortUDP = (TraceStreamPortUDP_t*)pxBuffer;
+	pxStreamPortUDP = (TraceStreamPortUDP_t*)pxBuffer; /*cstat !MISRAC2004-11.4 !MISRAC2012-Rule-11.3 Suppress conversion between pointer types checks*/
+	pxStreamPortUDP->uiFill = 0u;
+	pxStreamPortUDP->uiFillSize = TRC_STREAM_PORT_UDP_FRAME_SIZE;
+	pxStreamPortUDP->uiFillFirstEvent = TRC_STREAM_PORT_UDP_FRAME_NO_EVENT;
+	pxStreamPortUDP->uiFillFlags = 0u;
+	pxStreamPortUDP->uiSend = 0u;
+	pxStreamPortUDP->uiCompleted = 0u;
+	pxStreamPortUDP->uiSequence = 0u;
+	pxStreamPortUDP->uiDroppedEvents = 0u;
 
-#if (TRC_USE_INTERNAL_BUFFER == 1)
-	return xTraceInternalEventBufferInitialize(pxStreamPortUDP->buffer, sizeof(pxStreamPortUDP->buffer));
-#else
 	return TRC_SUCCESS;
-#endif
 }
 
-traceResult xTraceStreamPortOnTraceEnd(void)
+traceResult xTraceStreamPortOnTraceBegin(void)
 {
-	if (sock >= 0)
+	/* Send what is left of a previous session first */
+	prvTraceUdpFlush();
+
+	if (pxStreamPortUDP->uiFillSize > (TRC_STREAM_PORT_UDP_FRAME_SIZE))
 	{
-		close(sock);
+		/* No room to complete it, start over in the same packet */
+		pxStreamPortUDP->uiFillSize = TRC_STREAM_PORT_UDP_FRAME_SIZE;
+		pxStreamPortUDP->uiFillFirstEvent = TRC_STREAM_PORT_UDP_FRAME_NO_EVENT;
 	}
 
+	pxStreamPortUDP->uiFillFlags = TRC_STREAM_PORT_UDP_FRAME_FLAG_SESSION_START;
+	pxStreamPortUDP->uiSequence = 0u;
+	pxStreamPortUDP->uiDroppedEvents = 0u;
+
 	return TRC_SUCCESS;
 }
 
+traceResult xTraceStreamPortOnTraceEnd(void)
+{
+	/* The last packet is sent by the next xTraceTzCtrl() */
+	pxStreamPortUDP->uiFillFlags |= TRC_STREAM_PORT_UDP_FRAME_FLAG_SESSION_END;
+	prvTraceUdpFlush();
+
+	return TRC_SUCCESS;
+}
+
+/* Completes the packet being filled and moves on to the next one, which must be free */
+static void prvTraceUdpComplete(uint32_t uiEventsEnd)
+{
+	uint32_t uiFill = pxStreamPortUDP->uiFill;
+#if (TRC_CFG_STREAM_PORT_UDP_FRAMING == 1)
+	TraceStreamPortUDPFrame_t* pxFrame = (TraceStreamPortUDPFrame_t*)pxStreamPortUDP->uiPackets[uiFill]; /*cstat !MISRAC2004-11.4 !MISRAC2012-Rule-11.3 The packets are aligned*/
+
+	pxFrame->uiMagic = TRC_STREAM_PORT_UDP_FRAME_MAGIC;
+	pxFrame->uiVersion = TRC_STREAM_PORT_UDP_FRAME_VERSION;
+	pxFrame->uiFlags = (uint8_t)pxStreamPortUDP->uiFillFlags;
+	pxFrame->uiSequence = pxStreamPortUDP->uiSequence;
+	pxFrame->uiFirstEvent = (uint16_t)pxStreamPortUDP->uiFillFirstEvent;
+	pxFrame->uiEventsEnd = (uint16_t)uiEventsEnd;
+	pxFrame->uiDroppedEvents = pxStreamPortUDP->uiDroppedEvents;
+#else
+	(void)uiEventsEnd;
+#endif
+
+	pxStreamPortUDP->uiPacketSize[uiFill] = (uint16_t)pxStreamPortUDP->uiFillSize;
+	pxStreamPortUDP->uiSequence++;
+	pxStreamPortUDP->uiCompleted++;
+
+	pxStreamPortUDP->uiFill = (uiFill + 1u) % (TRC_CFG_STREAM_PORT_UDP_PACKET_COUNT);
+	pxStreamPortUDP->uiFillSize = TRC_STREAM_PORT_UDP_FRAME_SIZE;
+	pxStreamPortUDP->uiFillFirstEvent = TRC_STREAM_PORT_UDP_FRAME_NO_EVENT;
+	pxStreamPortUDP->uiFillFlags = 0u;
+}
+
+/* Completes the packet being filled if it has data, or a session end to report, and there is room */
+static void prvTraceUdpFlush(void)
+{
+	if (pxStreamPortUDP->uiCompleted >= ((TRC_CFG_STREAM_PORT_UDP_PACKET_COUNT) - 1u))
+	{
+		return;
+	}
+
+	if ((pxStreamPortUDP->uiFillSize > (TRC_STREAM_PORT_UDP_FRAME_SIZE)) ||
+		(((TRC_STREAM_PORT_UDP_FRAME_SIZE) > 0u) && ((pxStreamPortUDP->uiFillFlags & (TRC_STREAM_PORT_UDP_FRAME_FLAG_SESSION_END)) != 0u)))
+	{
+		prvTraceUdpComplete(pxStreamPortUDP->uiFillSize - (TRC_STREAM_PORT_UDP_FRAME_SIZE));
+	}
+}
+
 #endif /*(TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)*/
 
 #endif /*(TRC_USE_TRACEALYZER_RECORDER == 1)*/
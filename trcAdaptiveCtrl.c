@@ -0,0 +1,175 @@
+/*
+* Percepio Trace Recorder for Tracealyzer v4.10.3
+* Copyright 2023 Percepio AB
+* www.percepio.com
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* The implementation of the adaptive TzCtrl control.
+*/
+
+#include <trcRecorder.h>
+
+#if (TRC_USE_TRACEALYZER_RECORDER == 1) && (TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)
+
+#if ((TRC_USE_INTERNAL_BUFFER) == 1) && ((TRC_CFG_CTRL_ADAPTIVE) == 1)
+
+static TraceAdaptiveCtrlData_t* pxAdaptiveCtrl TRC_CFG_RECORDER_DATA_ATTRIBUTE;
+
+traceResult xTraceAdaptiveCtrlInitialize(TraceAdaptiveCtrlData_t* pxBuffer)
+{
+	/* This should never fail */
+	TRC_ASSERT(pxBuffer != (void*)0);
+
+	pxAdaptiveCtrl = pxBuffer;
+
+	pxAdaptiveCtrl->uiDelay = (uint32_t)(TRC_CFG_CTRL_TASK_DELAY);
+	pxAdaptiveCtrl->uiChunkBudget = (uint32_t)(TRC_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT);
+	pxAdaptiveCtrl->uiFillRate = 0u;
+	pxAdaptiveCtrl->uiUsedBefore = 0u;
+	pxAdaptiveCtrl->uiUsedAfter = 0u;
+	pxAdaptiveCtrl->uiReserved = 0u;
+
+	(void)xTraceSetComponentInitialized(TRC_RECORDER_COMPONENT_ADAPTIVE_CTRL);
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceAdaptiveCtrlMeasure(void)
+{
+	uint32_t uiUsed = 0u;
+	uint32_t uiSize = 0u;
+	uint32_t uiFill = 0u;
+	uint32_t uiRate;
+	uint32_t uiChunks;
+
+	/* This should never fail */
+	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_ADAPTIVE_CTRL));
+
+	(void)xTraceInternalEventBufferGetUsed(&uiUsed, &uiSize);
+	pxAdaptiveCtrl->uiUsedBefore = uiUsed;
+
+	/* What was stored while TzCtrl slept. Less if the buffer was cleared since. */
+	if (uiUsed > pxAdaptiveCtrl->uiUsedAfter)
+	{
+		uiFill = uiUsed - pxAdaptiveCtrl->uiUsedAfter;
+	}
+	uiRate = (uiFill << TRC_ADAPTIVE_CTRL_RATE_SHIFT) / pxAdaptiveCtrl->uiDelay;
+
+	/* Follow a burst at once, so that it is drained before the buffer is full,
+	 * but let the rate fall off slowly after it */
+	if (uiRate >= pxAdaptiveCtrl->uiFillRate)
+	{
+		pxAdaptiveCtrl->uiFillRate = uiRate;
+	}
+	else
+	{
+		pxAdaptiveCtrl->uiFillRate -= (pxAdaptiveCtrl->uiFillRate - uiRate) >> 2;
+	}
+
+	/* Enough chunks to transfer what is there now */
+	uiChunks = (uiUsed + (uint32_t)(TRC_INTERNAL_BUFFER_CHUNK_SIZE) - 1u) / (uint32_t)(TRC_INTERNAL_BUFFER_CHUNK_SIZE);
+	if (uiChunks < 1u)
+	{
+		uiChunks = 1u;
+	}
+	else if (uiChunks > (uint32_t)(TRC_CFG_CTRL_CHUNK_BUDGET_MAX))
+	{
+		uiChunks = (uint32_t)(TRC_CFG_CTRL_CHUNK_BUDGET_MAX);
+	}
+	pxAdaptiveCtrl->uiChunkBudget = uiChunks;
+
+	if (uiSize > 0u)
+	{
+		(void)xTraceDiagnosticsSetIfHigher(TRC_DIAGNOSTICS_CTRL_OCCUPANCY_HIGHEST, (TraceBaseType_t)(((uint64_t)uiUsed * 100u) / uiSize));
+	}
+	(void)xTraceDiagnosticsSet(TRC_DIAGNOSTICS_CTRL_FILL_RATE, (TraceBaseType_t)(pxAdaptiveCtrl->uiFillRate >> TRC_ADAPTIVE_CTRL_RATE_SHIFT));
+	(void)xTraceDiagnosticsSet(TRC_DIAGNOSTICS_CTRL_CHUNK_BUDGET, (TraceBaseType_t)uiChunks);
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceAdaptiveCtrlSchedule(void)
+{
+	uint32_t uiUsed = 0u;
+	uint32_t uiSize = 0u;
+	uint32_t uiTarget;
+	uint32_t uiDelay;
+
+	/* This should never fail */
+	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_ADAPTIVE_CTRL));
+
+	(void)xTraceInternalEventBufferGetUsed(&uiUsed, &uiSize);
+	pxAdaptiveCtrl->uiUsedAfter = uiUsed;
+
+	uiTarget = (uiSize / 100u) * (uint32_t)(TRC_CFG_CTRL_TARGET_OCCUPANCY);
+
+	if ((uiUsed >= uiTarget) || (pxAdaptiveCtrl->uiUsedBefore >= uiTarget))
+	{
+		/* Behind, or was. If the buffer was full, events were dropped and the
+		 * real fill rate is higher than measured, so measure again soon. */
+		uiDelay = (uint32_t)(TRC_CFG_CTRL_TASK_DELAY_MIN);
+	}
+	else if (pxAdaptiveCtrl->uiFillRate == 0u)
+	{
+		/* Idle */
+		uiDelay = (uint32_t)(TRC_CFG_CTRL_TASK_DELAY_MAX);
+	}
+	else
+	{
+		/* The time until the target occupancy is reached at the current rate */
+		uiDelay = (uint32_t)((((uint64_t)(uiTarget - uiUsed)) << TRC_ADAPTIVE_CTRL_RATE_SHIFT) / pxAdaptiveCtrl->uiFillRate);
+		if (uiDelay < (uint32_t)(TRC_CFG_CTRL_TASK_DELAY_MIN))
+		{
+			uiDelay = (uint32_t)(TRC_CFG_CTRL_TASK_DELAY_MIN);
+		}
+		else if (uiDelay > (uint32_t)(TRC_CFG_CTRL_TASK_DELAY_MAX))
+		{
+			uiDelay = (uint32_t)(TRC_CFG_CTRL_TASK_DELAY_MAX);
+		}
+	}
+	pxAdaptiveCtrl->uiDelay = uiDelay;
+
+	(void)xTraceDiagnosticsSet(TRC_DIAGNOSTICS_CTRL_TASK_DELAY, (TraceBaseType_t)uiDelay);
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceAdaptiveCtrlGetDelay(TraceUnsignedBaseType_t* puxDelay)
+{
+	/* This should never fail */
+	TRC_ASSERT(puxDelay != (void*)0);
+
+	/* Commands are only checked this often while waiting to be started */
+	if ((xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_ADAPTIVE_CTRL) == 0U) || (xTraceIsRecorderEnabled() == 0))
+	{
+		*puxDelay = (TraceUnsignedBaseType_t)(TRC_CFG_CTRL_TASK_DELAY);
+
+		return TRC_SUCCESS;
+	}
+
+	*puxDelay = (TraceUnsignedBaseType_t)pxAdaptiveCtrl->uiDelay;
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceAdaptiveCtrlGetChunkBudget(uint32_t* puiChunkBudget)
+{
+	/* This should never fail */
+	TRC_ASSERT(puiChunkBudget != (void*)0);
+
+	if (xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_ADAPTIVE_CTRL) == 0U)
+	{
+		*puiChunkBudget = (uint32_t)(TRC_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT);
+
+		return TRC_SUCCESS;
+	}
+
+	*puiChunkBudget = pxAdaptiveCtrl->uiChunkBudget;
+
+	return TRC_SUCCESS;
+}
+
+#endif
+
+#endif
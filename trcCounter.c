@@ -86,6 +86,8 @@ traceResult xTraceCounterSet(TraceCounterHandle_t xCounterHandle, TraceBaseType_
 	{
 		(void)xTraceEventCreate1(PSF_EVENT_COUNTER_LIMIT_EXCEEDED, (TraceUnsignedBaseType_t)xCounterHandle); /*cstat !MISRAC2004-11.3 !MISRAC2012-Rule-11.4 Suppress conversion from pointer to integer check*/
 
+		(void)xTraceFlightRecorderOnTrigger(TRC_FLIGHT_RECORDER_TRIGGER_COUNTER_LIMIT);
+
 		if (pxCounterData->xCallbackFunction != 0)
 		{
 			pxCounterData->xCallbackFunction(xCounterHandle);
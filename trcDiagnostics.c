@@ -17,6 +17,7 @@ static TraceDiagnosticsData_t *pxDiagnostics TRC_CFG_RECORDER_DATA_ATTRIBUTE;
 traceResult xTraceDiagnosticsInitialize(TraceDiagnosticsData_t *pxBuffer)
 {
 	uint32_t i;
+	uint32_t j;
 	
 	/* This should never fail */
 	TRC_ASSERT(pxBuffer != (void*)0);
@@ -28,6 +29,17 @@ traceResult xTraceDiagnosticsInitialize(TraceDiagnosticsData_t *pxBuffer)
 		pxDiagnostics->metrics[i] = 0;
 	}
 
+	for (i = 0u; i < (uint32_t)(TRC_CFG_CORE_COUNT); i++)
+	{
+		for (j = 0u; j < (TRC_DIAGNOSTICS_CORE_COUNT); j++)
+		{
+			pxDiagnostics->coreMetrics[i][j] = 0;
+		}
+	}
+
+	pxDiagnostics->uxReportCountdown = (TraceUnsignedBaseType_t)(TRC_CFG_DIAGNOSTICS_REPORT_INTERVAL);
+	pxDiagnostics->xReportChannel = 0;
+
 	(void)xTraceSetComponentInitialized(TRC_RECORDER_COMPONENT_DIAGNOSTICS);
 
 	return TRC_SUCCESS;
@@ -117,6 +129,157 @@ traceResult xTraceDiagnosticsSetIfLower(TraceDiagnosticsType_t xType, TraceBaseT
 	return TRC_SUCCESS;
 }
 
+traceResult xTraceDiagnosticsCoreGet(uint32_t uiCoreId, TraceDiagnosticsCoreType_t xType, TraceBaseType_t* pxValue)
+{
+	/* This should never fail */
+	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_DIAGNOSTICS));
+
+	/* This should never fail */
+	TRC_ASSERT(uiCoreId < (uint32_t)(TRC_CFG_CORE_COUNT));
+
+	/* This should never fail */
+	TRC_ASSERT((TraceUnsignedBaseType_t)xType < TRC_DIAGNOSTICS_CORE_COUNT);
+
+	/* This should never fail */
+	TRC_ASSERT(pxValue != (void*)0);
+
+	*pxValue = pxDiagnostics->coreMetrics[uiCoreId][(TraceUnsignedBaseType_t)xType];
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceDiagnosticsCoreAdd(uint32_t uiCoreId, TraceDiagnosticsCoreType_t xType, TraceBaseType_t xValue)
+{
+	/* This should never fail */
+	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_DIAGNOSTICS));
+
+	/* This should never fail */
+	TRC_ASSERT(uiCoreId < (uint32_t)(TRC_CFG_CORE_COUNT));
+
+	/* This should never fail */
+	TRC_ASSERT((TraceUnsignedBaseType_t)xType < TRC_DIAGNOSTICS_CORE_COUNT);
+
+	pxDiagnostics->coreMetrics[uiCoreId][(TraceUnsignedBaseType_t)xType] += xValue;
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceDiagnosticsCoreSetIfHigher(uint32_t uiCoreId, TraceDiagnosticsCoreType_t xType, TraceBaseType_t xValue)
+{
+	/* This should never fail */
+	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_DIAGNOSTICS));
+
+	/* This should never fail */
+	TRC_ASSERT(uiCoreId < (uint32_t)(TRC_CFG_CORE_COUNT));
+
+	/* This should never fail */
+	TRC_ASSERT((TraceUnsignedBaseType_t)xType < TRC_DIAGNOSTICS_CORE_COUNT);
+
+	if (xValue > pxDiagnostics->coreMetrics[uiCoreId][(TraceUnsignedBaseType_t)xType])
+	{
+		pxDiagnostics->coreMetrics[uiCoreId][(TraceUnsignedBaseType_t)xType] = xValue;
+	}
+
+	return TRC_SUCCESS;
+}
+
+#if ((TRC_CFG_DIAGNOSTICS_EXTENDED) == 1)
+
+traceResult xTraceDiagnosticsOnTransfer(void)
+{
+#if ((TRC_USE_INTERNAL_BUFFER) == 1)
+	uint32_t uiCoreId;
+	uint32_t uiUsed;
+#endif
+
+	/* This should never fail */
+	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_DIAGNOSTICS));
+
+	pxDiagnostics->metrics[TRC_DIAGNOSTICS_TRANSFER_CALLS]++;
+
+#if ((TRC_USE_INTERNAL_BUFFER) == 1)
+	for (uiCoreId = 0u; uiCoreId < (uint32_t)(TRC_CFG_CORE_COUNT); uiCoreId++)
+	{
+		uiUsed = 0u;
+		(void)xTraceInternalEventBufferGetCoreUsed(uiCoreId, &uiUsed);
+		(void)xTraceDiagnosticsCoreSetIfHigher(uiCoreId, TRC_DIAGNOSTICS_CORE_BUFFER_USED_HIGHEST, (TraceBaseType_t)uiUsed);
+	}
+#endif
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceDiagnosticsOnWrite(traceResult xResult, uint32_t uiSize, const int32_t* piBytesWritten)
+{
+	/* This should never fail */
+	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_DIAGNOSTICS));
+
+	/* This should never fail */
+	TRC_ASSERT(piBytesWritten != (void*)0);
+
+	if (xResult == TRC_FAIL)
+	{
+		pxDiagnostics->metrics[TRC_DIAGNOSTICS_STREAM_PORT_WRITE_FAILURES]++;
+	}
+	else if ((*piBytesWritten < 0) || ((uint32_t)*piBytesWritten < uiSize))
+	{
+		pxDiagnostics->metrics[TRC_DIAGNOSTICS_STREAM_PORT_SHORT_WRITES]++;
+	}
+	else
+	{
+		/* All written */
+	}
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceDiagnosticsOnCriticalSectionExit(uint32_t uiStart)
+{
+	const uint32_t uiStop = (uint32_t)(TRC_HWTC_COUNT);
+
+	return xTraceDiagnosticsSetIfHigher(TRC_DIAGNOSTICS_CRITICAL_SECTION_LONGEST, (TraceBaseType_t)TRC_HWTC_TICKS_BETWEEN(uiStart, uiStop));
+}
+
+static traceResult prvTraceDiagnosticsReport(void)
+{
+	uint32_t uiCoreId;
+	uint32_t uiUsed = 0u;
+	uint32_t uiSize = 0u;
+
+	if (pxDiagnostics->xReportChannel == 0)
+	{
+		if (xTraceStringRegister("#Diagnostics", &pxDiagnostics->xReportChannel) == TRC_FAIL)
+		{
+			return TRC_FAIL;
+		}
+	}
+
+#if ((TRC_USE_INTERNAL_BUFFER) == 1)
+	/* The size of one core's buffer */
+	(void)xTraceInternalEventBufferGetUsed(&uiUsed, &uiSize);
+#endif
+
+	(void)xTracePrintF(pxDiagnostics->xReportChannel, "%d transfers, %d write failures, %d short writes, longest critical section %d",
+		(TraceUnsignedBaseType_t)pxDiagnostics->metrics[TRC_DIAGNOSTICS_TRANSFER_CALLS],
+		(TraceUnsignedBaseType_t)pxDiagnostics->metrics[TRC_DIAGNOSTICS_STREAM_PORT_WRITE_FAILURES],
+		(TraceUnsignedBaseType_t)pxDiagnostics->metrics[TRC_DIAGNOSTICS_STREAM_PORT_SHORT_WRITES],
+		(TraceUnsignedBaseType_t)pxDiagnostics->metrics[TRC_DIAGNOSTICS_CRITICAL_SECTION_LONGEST]);
+
+	for (uiCoreId = 0u; uiCoreId < (uint32_t)(TRC_CFG_CORE_COUNT); uiCoreId++)
+	{
+		(void)xTracePrintF(pxDiagnostics->xReportChannel, "Core %d: buffer highest %d of %d, committed %d, transferred %d",
+			(TraceUnsignedBaseType_t)uiCoreId,
+			(TraceUnsignedBaseType_t)pxDiagnostics->coreMetrics[uiCoreId][TRC_DIAGNOSTICS_CORE_BUFFER_USED_HIGHEST],
+			(TraceUnsignedBaseType_t)uiSize,
+			(TraceUnsignedBaseType_t)pxDiagnostics->coreMetrics[uiCoreId][TRC_DIAGNOSTICS_CORE_BYTES_COMMITTED],
+			(TraceUnsignedBaseType_t)pxDiagnostics->coreMetrics[uiCoreId][TRC_DIAGNOSTICS_CORE_BYTES_TRANSFERRED]);
+	}
+
+	return TRC_SUCCESS;
+}
+
+#endif
+
 traceResult xTraceDiagnosticsCheckStatus(void)
 {
 	/* It is probably good if we always check this */
@@ -149,6 +312,22 @@ traceResult xTraceDiagnosticsCheckStatus(void)
 		pxDiagnostics->metrics[TRC_DIAGNOSTICS_STACK_MONITOR_NO_SLOTS] = 0;
 	}
 
+#if ((TRC_CFG_DIAGNOSTICS_EXTENDED) == 1)
+	/* Kept, so that the reports show how many there have been */
+	if (pxDiagnostics->metrics[TRC_DIAGNOSTICS_STREAM_PORT_WRITE_FAILURES] > 0)
+	{
+		(void)xTraceWarning(TRC_WARNING_STREAM_PORT_WRITE);
+	}
+
+	pxDiagnostics->uxReportCountdown--;
+	if (pxDiagnostics->uxReportCountdown == 0u)
+	{
+		pxDiagnostics->uxReportCountdown = (TraceUnsignedBaseType_t)(TRC_CFG_DIAGNOSTICS_REPORT_INTERVAL);
+
+		(void)prvTraceDiagnosticsReport();
+	}
+#endif
+
 	return TRC_SUCCESS;
 }
 
@@ -167,6 +167,8 @@ traceResult xTraceEntryFind(const void* const pvAddress, TraceEntryHandle_t* pxE
 {
 	uint32_t i;
 	TraceEntry_t* pxEntry;
+	TRC_PROFILING_ALLOC(uiProfilingStart)
+	TRC_PROFILING_ALLOC(uiProfilingStop)
 
 	/* This should never fail */
 	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_ENTRY));
@@ -177,6 +179,8 @@ traceResult xTraceEntryFind(const void* const pvAddress, TraceEntryHandle_t* pxE
 	/* This should never fail */
 	TRC_ASSERT(pvAddress != (void*)0);
 
+	TRC_PROFILING_TIMESTAMP(uiProfilingStart)
+
 	for (i = 0u; i < (uint32_t)(TRC_ENTRY_TABLE_SLOTS); i++)
 	{
 		pxEntry = &pxEntryTable->axEntries[i];
@@ -184,10 +188,16 @@ traceResult xTraceEntryFind(const void* const pvAddress, TraceEntryHandle_t* pxE
 		{
 			*pxEntryHandle = (TraceEntryHandle_t)pxEntry;
 
+			TRC_PROFILING_TIMESTAMP(uiProfilingStop)
+			TRC_PROFILING_RECORD(TRC_PROFILING_ENTRY_FIND, uiProfilingStart, uiProfilingStop)
+
 			return TRC_SUCCESS;
 		}
 	}
 
+	TRC_PROFILING_TIMESTAMP(uiProfilingStop)
+	TRC_PROFILING_RECORD(TRC_PROFILING_ENTRY_FIND, uiProfilingStart, uiProfilingStop)
+
 	return TRC_FAIL;
 }
 
@@ -79,7 +79,12 @@ traceResult xTraceError(uint32_t uiErrorCode)
 		}
 		
 		(void)xTracePrint(pxErrorInfo->xWarningChannel, "Recorder stopped in xTraceError(...)!");
-		(void)xTraceDisable();
+
+		/* With TRC_CFG_FLIGHT_RECORDER, stopped once the capture is transferred */
+		if (xTraceFlightRecorderOnError(uiErrorCode) == TRC_FAIL)
+		{
+			(void)xTraceDisable();
+		}
 	}
 
 	return TRC_SUCCESS;
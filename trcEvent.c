@@ -45,27 +45,59 @@
 		(void)xTraceTimestampGet(&(pxEvent)->TS) \
 	)
 
+/**
+ * @internal Declares the tick counts used by TRC_CFG_SELF_PROFILING and
+ * TRC_CFG_DIAGNOSTICS_EXTENDED in the functions that use
+ * TRACE_EVENT_BEGIN_OFFLINE and TRACE_EVENT_END.
+ */
+#define TRACE_EVENT_ALLOC_MEASUREMENTS() 												\
+	TRC_DIAGNOSTICS_ALLOC(uiCriticalSectionStart) 										\
+	TRC_PROFILING_ALLOC(uiProfilingStart) 												\
+	TRC_PROFILING_ALLOC(uiProfilingAllocate) 											\
+	TRC_PROFILING_ALLOC(uiProfilingAllocated) 											\
+	TRC_PROFILING_ALLOC(uiProfilingCommit) 												\
+	TRC_PROFILING_ALLOC(uiProfilingStop)
+
 #define TRACE_EVENT_BEGIN_OFFLINE(size) 														\
 	TRACE_ENTER_CRITICAL_SECTION();              										\
+	TRC_DIAGNOSTICS_TIMESTAMP(uiCriticalSectionStart) 									\
+	TRC_PROFILING_TIMESTAMP(uiProfilingStart) 											\
 	pxTraceEventDataTable->coreEventData[TRC_CFG_GET_CURRENT_CORE()].eventCounter++; 	\
+	(void)xTraceInternalEventBufferSelectLane(uiEventCode); 							\
+	TRC_PROFILING_TIMESTAMP(uiProfilingAllocate) 										\
 	if (xTraceStreamPortAllocate((uint32_t)(size), (void**)&pxEventData) == TRC_FAIL) /*cstat !MISRAC2004-11.4 !MISRAC2012-Rule-11.3 Suppress pointer checks*/ \
 	{                                            										\
 		TRACE_EXIT_CRITICAL_SECTION();              									\
 		return TRC_FAIL; 																\
 	} 																					\
+	TRC_PROFILING_TIMESTAMP(uiProfilingAllocated) 										\
 	SET_BASE_EVENT_DATA(pxEventData, uiEventCode, ((size) - sizeof(TraceEvent0_t)) / sizeof(TraceUnsignedBaseType_t), pxTraceEventDataTable->coreEventData[TRC_CFG_GET_CURRENT_CORE()].eventCounter); /*cstat !MISRAC2012-Rule-11.5 Suppress pointer checks*/
 
-#define TRACE_EVENT_BEGIN(size) 														\
+#define TRACE_EVENT_BEGIN(size, p1, p2, p3, p4) 										\
 	/* We need to check this */                  										\
 	if (!xTraceIsRecorderEnabled())              										\
 	{ 																					\
 		return TRC_FAIL;                            									\
 	} 																					\
+	/* With TRC_CFG_TRIGGER_RULES, not stored while stopped by the rules. Only the		\
+	 * first TRC_TRIGGER_PARAMETERS parameters are checked. */							\
+	if (xTraceTriggerCheck(uiEventCode, (p1), (p2), (p3), (p4)) == TRC_FAIL)			\
+	{ 																					\
+		return TRC_FAIL;                            									\
+	} 																					\
 	TRACE_EVENT_BEGIN_OFFLINE(size)
 
 
 #define TRACE_EVENT_END(size) 															\
+	TRC_PROFILING_TIMESTAMP(uiProfilingCommit) 											\
 	(void)xTraceStreamPortCommit(pxEventData, (uint32_t)(size), &iBytesCommitted); 		\
+	TRC_PROFILING_TIMESTAMP(uiProfilingStop) 											\
+	/* Recorded last, so that recording isn't part of the cost */ 						\
+	TRC_PROFILING_RECORD(TRC_PROFILING_ALLOCATE, uiProfilingAllocate, uiProfilingAllocated) \
+	TRC_PROFILING_RECORD(TRC_PROFILING_COMMIT, uiProfilingCommit, uiProfilingStop) 	\
+	TRC_PROFILING_RECORD(TRC_PROFILING_EVENT_CREATE, uiProfilingStart, uiProfilingStop) \
+	TRC_DIAGNOSTICS_COMMITTED(iBytesCommitted) 											\
+	TRC_DIAGNOSTICS_CRITICAL_SECTION_EXIT(uiCriticalSectionStart) 						\
 	TRACE_EXIT_CRITICAL_SECTION(); 														\
 	/* We need to use iBytesCommitted for the above call but do not use the value */	\
 	/* Remove potential warnings */ 													\
@@ -148,8 +180,9 @@ traceResult xTraceEventCreate0(uint32_t uiEventCode)
 	int32_t iBytesCommitted = 0;
 
 	TRACE_ALLOC_CRITICAL_SECTION();
+	TRACE_EVENT_ALLOC_MEASUREMENTS()
 
-	TRACE_EVENT_BEGIN(sizeof(TraceEvent0_t));
+	TRACE_EVENT_BEGIN(sizeof(TraceEvent0_t), 0u, 0u, 0u, 0u);
 	TRACE_EVENT_END(sizeof(TraceEvent0_t));
 
 	return TRC_SUCCESS;
@@ -161,8 +194,9 @@ traceResult xTraceEventCreate1(uint32_t uiEventCode, TraceUnsignedBaseType_t uxP
 	int32_t iBytesCommitted = 0;
 
 	TRACE_ALLOC_CRITICAL_SECTION();
+	TRACE_EVENT_ALLOC_MEASUREMENTS()
 
-	TRACE_EVENT_BEGIN(sizeof(TraceEvent1_t));
+	TRACE_EVENT_BEGIN(sizeof(TraceEvent1_t), uxParam1, 0u, 0u, 0u);
 
 	TRACE_EVENT_ADD_1(uxParam1);
 
@@ -177,8 +211,9 @@ traceResult xTraceEventCreate2(uint32_t uiEventCode, TraceUnsignedBaseType_t uxP
 	int32_t iBytesCommitted = 0;
 
 	TRACE_ALLOC_CRITICAL_SECTION();
+	TRACE_EVENT_ALLOC_MEASUREMENTS()
 
-	TRACE_EVENT_BEGIN(sizeof(TraceEvent2_t));
+	TRACE_EVENT_BEGIN(sizeof(TraceEvent2_t), uxParam1, uxParam2, 0u, 0u);
 
 	TRACE_EVENT_ADD_2(uxParam1, uxParam2);
 
@@ -193,8 +228,9 @@ traceResult xTraceEventCreate3(uint32_t uiEventCode, TraceUnsignedBaseType_t uxP
 	int32_t iBytesCommitted = 0;
 
 	TRACE_ALLOC_CRITICAL_SECTION();
+	TRACE_EVENT_ALLOC_MEASUREMENTS()
 
-	TRACE_EVENT_BEGIN(sizeof(TraceEvent3_t));
+	TRACE_EVENT_BEGIN(sizeof(TraceEvent3_t), uxParam1, uxParam2, uxParam3, 0u);
 
 	TRACE_EVENT_ADD_3(uxParam1, uxParam2, uxParam3);
 
@@ -209,8 +245,9 @@ traceResult xTraceEventCreate4(uint32_t uiEventCode, TraceUnsignedBaseType_t uxP
 	int32_t iBytesCommitted = 0;
 
 	TRACE_ALLOC_CRITICAL_SECTION();
+	TRACE_EVENT_ALLOC_MEASUREMENTS()
 
-	TRACE_EVENT_BEGIN(sizeof(TraceEvent4_t));
+	TRACE_EVENT_BEGIN(sizeof(TraceEvent4_t), uxParam1, uxParam2, uxParam3, uxParam4);
 
 	TRACE_EVENT_ADD_4(uxParam1, uxParam2, uxParam3, uxParam4);
 
@@ -225,8 +262,9 @@ traceResult xTraceEventCreate5(uint32_t uiEventCode, TraceUnsignedBaseType_t uxP
 	int32_t iBytesCommitted = 0;
 
 	TRACE_ALLOC_CRITICAL_SECTION();
+	TRACE_EVENT_ALLOC_MEASUREMENTS()
 
-	TRACE_EVENT_BEGIN(sizeof(TraceEvent5_t));
+	TRACE_EVENT_BEGIN(sizeof(TraceEvent5_t), uxParam1, uxParam2, uxParam3, uxParam4);
 
 	TRACE_EVENT_ADD_5(uxParam1, uxParam2, uxParam3, uxParam4, uxParam5);
 
@@ -241,8 +279,9 @@ traceResult xTraceEventCreate6(uint32_t uiEventCode, TraceUnsignedBaseType_t uxP
 	int32_t iBytesCommitted = 0;
 
 	TRACE_ALLOC_CRITICAL_SECTION();
+	TRACE_EVENT_ALLOC_MEASUREMENTS()
 
-	TRACE_EVENT_BEGIN(sizeof(TraceEvent6_t));
+	TRACE_EVENT_BEGIN(sizeof(TraceEvent6_t), uxParam1, uxParam2, uxParam3, uxParam4);
 
 	TRACE_EVENT_ADD_6(uxParam1, uxParam2, uxParam3, uxParam4, uxParam5, uxParam6);
 
@@ -280,6 +319,7 @@ traceResult xTraceEventCreateDataOffline0(uint32_t uiEventCode, const TraceUnsig
 	int32_t iBytesCommitted = 0;
 
 	TRACE_ALLOC_CRITICAL_SECTION();
+	TRACE_EVENT_ALLOC_MEASUREMENTS()
 
 	/* Align payload size and truncate in case it is too big */
 	uxSize = TRC_ALIGN_CEIL(uxSize, sizeof(TraceUnsignedBaseType_t));
@@ -303,6 +343,7 @@ traceResult xTraceEventCreateData0(uint32_t uiEventCode, const TraceUnsignedBase
 	int32_t iBytesCommitted = 0;
 
 	TRACE_ALLOC_CRITICAL_SECTION();
+	TRACE_EVENT_ALLOC_MEASUREMENTS()
 
 	/* Align payload size and truncate in case it is too big */
 	uxSize = TRC_ALIGN_CEIL(uxSize, sizeof(TraceUnsignedBaseType_t));
@@ -311,7 +352,7 @@ traceResult xTraceEventCreateData0(uint32_t uiEventCode, const TraceUnsignedBase
 		uxSize = TRC_MAX_BLOB_SIZE - sizeof(TraceEvent0_t);
 	}
 
-	TRACE_EVENT_BEGIN(sizeof(TraceEvent0_t) + uxSize);
+	TRACE_EVENT_BEGIN(sizeof(TraceEvent0_t) + uxSize, 0u, 0u, 0u, 0u);
 
 	TRACE_EVENT_ADD_0_DATA(puxData, uxSize);
 
@@ -331,6 +372,7 @@ traceResult xTraceEventCreateData1(
 	int32_t iBytesCommitted = 0;
 
 	TRACE_ALLOC_CRITICAL_SECTION();
+	TRACE_EVENT_ALLOC_MEASUREMENTS()
 
 	/* Align payload size and truncate in case it is too big */
 	uxSize = TRC_ALIGN_CEIL(uxSize, sizeof(TraceUnsignedBaseType_t));
@@ -339,7 +381,7 @@ traceResult xTraceEventCreateData1(
 		uxSize = TRC_MAX_BLOB_SIZE - sizeof(TraceEvent1_t);
 	}
 
-	TRACE_EVENT_BEGIN(sizeof(TraceEvent1_t) + uxSize);
+	TRACE_EVENT_BEGIN(sizeof(TraceEvent1_t) + uxSize, uxParam1, 0u, 0u, 0u);
 
 	TRACE_EVENT_ADD_1_DATA(uxParam1, puxData, uxSize);
 
@@ -360,6 +402,7 @@ traceResult xTraceEventCreateData2(
 	int32_t iBytesCommitted = 0;
 
 	TRACE_ALLOC_CRITICAL_SECTION();
+	TRACE_EVENT_ALLOC_MEASUREMENTS()
 
 	/* Align payload size and truncate in case it is too big */
 	uxSize = TRC_ALIGN_CEIL(uxSize, sizeof(TraceUnsignedBaseType_t));
@@ -368,7 +411,7 @@ traceResult xTraceEventCreateData2(
 		uxSize = TRC_MAX_BLOB_SIZE - sizeof(TraceEvent2_t);
 	}
 
-	TRACE_EVENT_BEGIN(sizeof(TraceEvent2_t) + uxSize);
+	TRACE_EVENT_BEGIN(sizeof(TraceEvent2_t) + uxSize, uxParam1, uxParam2, 0u, 0u);
 
 	TRACE_EVENT_ADD_2_DATA(uxParam1, uxParam2, puxData, uxSize);
 
@@ -390,6 +433,7 @@ traceResult xTraceEventCreateData3(
 	int32_t iBytesCommitted = 0;
 
 	TRACE_ALLOC_CRITICAL_SECTION();
+	TRACE_EVENT_ALLOC_MEASUREMENTS()
 
 	/* Align payload size and truncate in case it is too big */
 	uxSize = TRC_ALIGN_CEIL(uxSize, sizeof(TraceUnsignedBaseType_t));
@@ -398,7 +442,7 @@ traceResult xTraceEventCreateData3(
 		uxSize = TRC_MAX_BLOB_SIZE - sizeof(TraceEvent3_t);
 	}
 
-	TRACE_EVENT_BEGIN(sizeof(TraceEvent3_t) + uxSize);
+	TRACE_EVENT_BEGIN(sizeof(TraceEvent3_t) + uxSize, uxParam1, uxParam2, uxParam3, 0u);
 
 	TRACE_EVENT_ADD_3_DATA(uxParam1, uxParam2, uxParam3, puxData, uxSize);
 
@@ -421,6 +465,7 @@ traceResult xTraceEventCreateData4(
 	int32_t iBytesCommitted = 0;
 
 	TRACE_ALLOC_CRITICAL_SECTION();
+	TRACE_EVENT_ALLOC_MEASUREMENTS()
 
 	/* Align payload size and truncate in case it is too big */
 	uxSize = TRC_ALIGN_CEIL(uxSize, sizeof(TraceUnsignedBaseType_t));
@@ -429,7 +474,7 @@ traceResult xTraceEventCreateData4(
 		uxSize = TRC_MAX_BLOB_SIZE - sizeof(TraceEvent4_t);
 	}
 
-	TRACE_EVENT_BEGIN(sizeof(TraceEvent4_t) + uxSize);
+	TRACE_EVENT_BEGIN(sizeof(TraceEvent4_t) + uxSize, uxParam1, uxParam2, uxParam3, uxParam4);
 
 	TRACE_EVENT_ADD_4_DATA(uxParam1, uxParam2, uxParam3, uxParam4, puxData, uxSize);
 
@@ -453,6 +498,7 @@ traceResult xTraceEventCreateData5(
 	int32_t iBytesCommitted = 0;
 
 	TRACE_ALLOC_CRITICAL_SECTION();
+	TRACE_EVENT_ALLOC_MEASUREMENTS()
 
 	/* Align payload size and truncate in case it is too big */
 	uxSize = TRC_ALIGN_CEIL(uxSize, sizeof(TraceUnsignedBaseType_t));
@@ -461,7 +507,7 @@ traceResult xTraceEventCreateData5(
 		uxSize = TRC_MAX_BLOB_SIZE - sizeof(TraceEvent5_t);
 	}
 
-	TRACE_EVENT_BEGIN(sizeof(TraceEvent5_t) + uxSize);
+	TRACE_EVENT_BEGIN(sizeof(TraceEvent5_t) + uxSize, uxParam1, uxParam2, uxParam3, uxParam4);
 
 	TRACE_EVENT_ADD_5_DATA(uxParam1, uxParam2, uxParam3, uxParam4, uxParam5, puxData, uxSize);
 
@@ -486,6 +532,7 @@ traceResult xTraceEventCreateData6(
 	int32_t iBytesCommitted = 0;
 
 	TRACE_ALLOC_CRITICAL_SECTION();
+	TRACE_EVENT_ALLOC_MEASUREMENTS()
 
 	/* Align payload size and truncate in case it is too big */
 	uxSize = TRC_ALIGN_CEIL(uxSize, sizeof(TraceUnsignedBaseType_t));
@@ -494,7 +541,7 @@ traceResult xTraceEventCreateData6(
 		uxSize = TRC_MAX_BLOB_SIZE - sizeof(TraceEvent6_t);
 	}
 
-	TRACE_EVENT_BEGIN(sizeof(TraceEvent6_t) + uxSize);
+	TRACE_EVENT_BEGIN(sizeof(TraceEvent6_t) + uxSize, uxParam1, uxParam2, uxParam3, uxParam4);
 
 	TRACE_EVENT_ADD_6_DATA(uxParam1, uxParam2, uxParam3, uxParam4, uxParam5, uxParam6, puxData, uxSize);
 
@@ -29,6 +29,11 @@ traceResult xTraceEventBufferInitialize(TraceEventBuffer_t* pxTraceEventBuffer,
 	pxTraceEventBuffer->uiTail = 0u;
 	pxTraceEventBuffer->uiSize = uiSize;
 	pxTraceEventBuffer->uiFree = uiSize;
+	if (uiOptions == TRC_EVENT_BUFFER_OPTION_OVERWRITE)
+	{
+		/* Leave a word unused, see xTraceEventBufferSetOptions() */
+		pxTraceEventBuffer->uiFree = uiSize - sizeof(uint32_t);
+	}
 	pxTraceEventBuffer->puiBuffer = puiBuffer;
 	pxTraceEventBuffer->uiSlack = 0u;
 	pxTraceEventBuffer->uiNextHead = 0u;
@@ -154,8 +159,9 @@ traceResult xTraceEventBufferAlloc(TraceEventBuffer_t *pxTraceEventBuffer, uint3
 			/* Check if we have to free space */
 			if (uiFreeSpace < uiSize)
 			{
-				/* Check if this is a wrapping alloc */
-				if ((pxTraceEventBuffer->uiSize - pxTraceEventBuffer->uiHead) < uiSize)
+				/* Check if this is a wrapping alloc. An exact fit wraps too, as
+				 * above, since the head must stay inside the buffer. */
+				if ((pxTraceEventBuffer->uiSize - pxTraceEventBuffer->uiHead) <= uiSize)
 				{
 					/* To avoid uiHead and uiTail from becoming the same we want to
 					 * pop any events that would make uiTail equal uiHead before
@@ -217,7 +223,8 @@ traceResult xTraceEventBufferAlloc(TraceEventBuffer_t *pxTraceEventBuffer, uint3
 			{
 				uiFreeSpace = uiTail;
 
-				if (uiFreeSpace < uiSize)
+				/* Filling up to uiTail would make uiHead equal uiTail, which reads as empty */
+				if (uiFreeSpace <= uiSize)
 				{
 					*ppvData = 0;
 
@@ -234,7 +241,9 @@ traceResult xTraceEventBufferAlloc(TraceEventBuffer_t *pxTraceEventBuffer, uint3
 		}
 		else
 		{
-			uiFreeSpace = uiTail - uiHead - sizeof(uint32_t);
+			/* The transfer moves the tail by as much as the stream port wrote, so
+			 * it may be less than a word ahead of the head */
+			uiFreeSpace = ((uiTail - uiHead) > sizeof(uint32_t)) ? (uiTail - uiHead - sizeof(uint32_t)) : 0u;
 
 			if (uiFreeSpace < uiSize)
 			{
@@ -368,7 +377,8 @@ traceResult xTraceEventBufferPush(TraceEventBuffer_t *pxTraceEventBuffer, void *
 			}
 			else
 			{
-				uiFreeSpace = uiTail - uiHead - sizeof(uint32_t);
+				/* The tail may be less than a word ahead of the head, see xTraceEventBufferAlloc() */
+				uiFreeSpace = ((uiTail - uiHead) > sizeof(uint32_t)) ? (uiTail - uiHead - sizeof(uint32_t)) : 0u;
 
 				if (uiFreeSpace < uiSize)
 				{
@@ -423,14 +433,14 @@ traceResult xTraceEventBufferTransferAll(TraceEventBuffer_t* pxTraceEventBuffer,
 	if (uiHead > uiTail)
 	{
 		/* No wrapping */
-		(void)xTraceStreamPortWriteData(&pxTraceEventBuffer->puiBuffer[uiTail], (uiHead - uiTail), &iBytesWritten); /*cstat !MISRAC2004-17.4_b We need to access a specific part of the buffer*/
+		TRC_DIAGNOSTICS_WRITE(xTraceStreamPortWriteData(&pxTraceEventBuffer->puiBuffer[uiTail], (uiHead - uiTail), &iBytesWritten), (uiHead - uiTail), &iBytesWritten) /*cstat !MISRAC2004-17.4_b We need to access a specific part of the buffer*/
 	}
 	else
 	{
 		/* Wrapping */
 
 		/* Try to write: tail -> end of buffer */
-		(void)xTraceStreamPortWriteData(&pxTraceEventBuffer->puiBuffer[uiTail], (pxTraceEventBuffer->uiSize - uiTail - uiSlack), &iBytesWritten); /*cstat !MISRAC2004-17.4_b We need to access a specific part of the buffer*/
+		TRC_DIAGNOSTICS_WRITE(xTraceStreamPortWriteData(&pxTraceEventBuffer->puiBuffer[uiTail], (pxTraceEventBuffer->uiSize - uiTail - uiSlack), &iBytesWritten), (pxTraceEventBuffer->uiSize - uiTail - uiSlack), &iBytesWritten) /*cstat !MISRAC2004-17.4_b We need to access a specific part of the buffer*/
 
 		/* Did we manage to write all bytes? */
 		if ((uint32_t)iBytesWritten == (pxTraceEventBuffer->uiSize - uiTail - uiSlack))
@@ -446,7 +456,7 @@ traceResult xTraceEventBufferTransferAll(TraceEventBuffer_t* pxTraceEventBuffer,
 			iBytesWritten = 0;
 
 			/* Try to write: start of buffer -> head */
-			(void)xTraceStreamPortWriteData(&pxTraceEventBuffer->puiBuffer[0], uiHead, &iBytesWritten); /*cstat !MISRAC2004-17.4_b We need to access a specific part of the buffer*/
+			TRC_DIAGNOSTICS_WRITE(xTraceStreamPortWriteData(&pxTraceEventBuffer->puiBuffer[0], uiHead, &iBytesWritten), uiHead, &iBytesWritten) /*cstat !MISRAC2004-17.4_b We need to access a specific part of the buffer*/
 		}
 	}
 	
@@ -496,7 +506,7 @@ traceResult xTraceEventBufferTransferChunk(TraceEventBuffer_t* pxTraceEventBuffe
 			uiBytesToWrite = uiChunkSize;
 		}
 
-		(void)xTraceStreamPortWriteData(&pxTraceEventBuffer->puiBuffer[uiTail], uiBytesToWrite, &iBytesWritten); /*cstat !MISRAC2004-17.4_b We need to access a specific part of the buffer*/
+		TRC_DIAGNOSTICS_WRITE(xTraceStreamPortWriteData(&pxTraceEventBuffer->puiBuffer[uiTail], uiBytesToWrite, &iBytesWritten), uiBytesToWrite, &iBytesWritten) /*cstat !MISRAC2004-17.4_b We need to access a specific part of the buffer*/
 
 		pxTraceEventBuffer->uiTail += (uint32_t)iBytesWritten;
 	}
@@ -508,7 +518,7 @@ traceResult xTraceEventBufferTransferChunk(TraceEventBuffer_t* pxTraceEventBuffe
 			uiBytesToWrite = uiChunkSize;
 		}
 
-		(void)xTraceStreamPortWriteData(&pxTraceEventBuffer->puiBuffer[uiTail], uiBytesToWrite, &iBytesWritten); /*cstat !MISRAC2004-17.4_b We need to access a specific part of the buffer*/
+		TRC_DIAGNOSTICS_WRITE(xTraceStreamPortWriteData(&pxTraceEventBuffer->puiBuffer[uiTail], uiBytesToWrite, &iBytesWritten), uiBytesToWrite, &iBytesWritten) /*cstat !MISRAC2004-17.4_b We need to access a specific part of the buffer*/
 
 		/* Check if we managed to write until the end or not, if we didn't we
 		 * add the number of bytes written. If we managed to write the last
@@ -536,10 +546,68 @@ traceResult xTraceEventBufferClear(TraceEventBuffer_t* pxTraceEventBuffer)
 	pxTraceEventBuffer->uiHead = 0u;
 	pxTraceEventBuffer->uiTail = 0u;
 	pxTraceEventBuffer->uiFree = pxTraceEventBuffer->uiSize;
+	if (pxTraceEventBuffer->uiOptions == TRC_EVENT_BUFFER_OPTION_OVERWRITE)
+	{
+		/* Leave a word unused, see xTraceEventBufferSetOptions() */
+		pxTraceEventBuffer->uiFree = pxTraceEventBuffer->uiSize - sizeof(uint32_t);
+	}
 	pxTraceEventBuffer->uiSlack = 0u;
 	pxTraceEventBuffer->uiNextHead = 0u;
 
 	return TRC_SUCCESS;
 }
 
+traceResult xTraceEventBufferGetUsed(const TraceEventBuffer_t* pxTraceEventBuffer, uint32_t* puiUsed)
+{
+	uint32_t uiHead;
+	uint32_t uiTail;
+
+	/* This should never fail */
+	TRC_ASSERT(pxTraceEventBuffer != (void*)0);
+
+	/* This should never fail */
+	TRC_ASSERT(puiUsed != (void*)0);
+
+	/* Only the transfer moves the tail, the head may be moved by events while this runs */
+	uiHead = pxTraceEventBuffer->uiHead;
+	uiTail = pxTraceEventBuffer->uiTail;
+
+	if (uiHead >= uiTail)
+	{
+		*puiUsed = uiHead - uiTail;
+	}
+	else
+	{
+		/* Wrapped, the slack at the end of the buffer holds no data */
+		*puiUsed = (pxTraceEventBuffer->uiSize - uiTail - pxTraceEventBuffer->uiSlack) + uiHead;
+	}
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceEventBufferSetOptions(TraceEventBuffer_t* pxTraceEventBuffer, uint32_t uiOptions)
+{
+	uint32_t uiUsed = 0u;
+
+	/* This should never fail */
+	TRC_ASSERT(pxTraceEventBuffer != (void*)0);
+
+	/* This should never fail */
+	TRC_ASSERT((uiOptions == TRC_EVENT_BUFFER_OPTION_SKIP) || (uiOptions == TRC_EVENT_BUFFER_OPTION_OVERWRITE));
+
+	if (uiOptions == TRC_EVENT_BUFFER_OPTION_OVERWRITE)
+	{
+		/* Only overwrite pushes keep uiFree up to date. Leave a word unused, so
+		 * that a full buffer doesn't get head equal to tail, which reads as empty. */
+		/* This should never fail */
+		TRC_ASSERT_ALWAYS_EVALUATE(xTraceEventBufferGetUsed(pxTraceEventBuffer, &uiUsed) == TRC_SUCCESS);
+
+		pxTraceEventBuffer->uiFree = pxTraceEventBuffer->uiSize - uiUsed - sizeof(uint32_t);
+	}
+
+	pxTraceEventBuffer->uiOptions = uiOptions;
+
+	return TRC_SUCCESS;
+}
+
 #endif
@@ -0,0 +1,360 @@
+/*
+* Percepio Trace Recorder for Tracealyzer v4.10.3
+* Copyright 2023 Percepio AB
+* www.percepio.com
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* The implementation of the flight recorder capture mode.
+*/
+
+#include <trcRecorder.h>
+
+#if (TRC_USE_TRACEALYZER_RECORDER == 1) && (TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)
+
+#if ((TRC_USE_INTERNAL_BUFFER) == 1) && ((TRC_CFG_FLIGHT_RECORDER) == 1)
+
+static TraceFlightRecorderData_t* pxFlightRecorder TRC_CFG_RECORDER_DATA_ATTRIBUTE;
+
+/* Must be called with the critical section held */
+static void prvTraceFlightRecorderFreeze(void)
+{
+	uint32_t uiCoreId;
+
+	/* What is stored from now on must not overwrite the capture */
+	(void)xTraceInternalEventBufferSetOptions(TRC_EVENT_BUFFER_OPTION_SKIP);
+
+	for (uiCoreId = 0u; uiCoreId < (uint32_t)(TRC_CFG_CORE_COUNT); uiCoreId++)
+	{
+		(void)xTraceInternalEventBufferGetCoreUsed(uiCoreId, &pxFlightRecorder->uiFrozen[uiCoreId]);
+	}
+
+	pxFlightRecorder->uiState = TRC_FLIGHT_RECORDER_STATE_DRAINING;
+}
+
+traceResult xTraceFlightRecorderInitialize(TraceFlightRecorderData_t* pxBuffer)
+{
+	uint32_t uiUsed = 0u;
+	uint32_t uiSize = 0u;
+	uint32_t uiCoreId;
+
+	/* This should never fail */
+	TRC_ASSERT(pxBuffer != (void*)0);
+
+	pxFlightRecorder = pxBuffer;
+
+	/* Armed once the trace header has been transferred */
+	pxFlightRecorder->uiState = TRC_FLIGHT_RECORDER_STATE_DRAINING;
+	pxFlightRecorder->uiPostRemaining = 0u;
+	pxFlightRecorder->uiStopPending = 0u;
+	pxFlightRecorder->uiStalledTransfers = 0u;
+	for (uiCoreId = 0u; uiCoreId < (uint32_t)(TRC_CFG_CORE_COUNT); uiCoreId++)
+	{
+		pxFlightRecorder->uiFrozen[uiCoreId] = 0u;
+	}
+
+	/* The size of one core's buffer */
+	(void)xTraceInternalEventBufferGetUsed(&uiUsed, &uiSize);
+	pxFlightRecorder->uiPostSize = (uiSize / 100u) * (uint32_t)(TRC_CFG_FLIGHT_RECORDER_POST_TRIGGER);
+
+	(void)xTraceSetComponentInitialized(TRC_RECORDER_COMPONENT_FLIGHT_RECORDER);
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceFlightRecorderTrigger(void)
+{
+	TRACE_ALLOC_CRITICAL_SECTION();
+
+	/* This should never fail */
+	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_FLIGHT_RECORDER));
+
+	TRACE_ENTER_CRITICAL_SECTION();
+
+	if ((xTraceIsRecorderEnabled() == 0) || (pxFlightRecorder->uiState != TRC_FLIGHT_RECORDER_STATE_ARMED))
+	{
+		TRACE_EXIT_CRITICAL_SECTION();
+
+		(void)xTraceDiagnosticsIncrease(TRC_DIAGNOSTICS_FLIGHT_RECORDER_TRIGGERS_IGNORED);
+
+		return TRC_FAIL;
+	}
+
+	pxFlightRecorder->uiPostRemaining = pxFlightRecorder->uiPostSize;
+	if (pxFlightRecorder->uiPostRemaining == 0u)
+	{
+		prvTraceFlightRecorderFreeze();
+	}
+	else
+	{
+		pxFlightRecorder->uiState = TRC_FLIGHT_RECORDER_STATE_TRIGGERED;
+	}
+
+	TRACE_EXIT_CRITICAL_SECTION();
+
+	(void)xTraceDiagnosticsIncrease(TRC_DIAGNOSTICS_FLIGHT_RECORDER_CAPTURES);
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceFlightRecorderGetState(uint32_t* puiState)
+{
+	/* This should never fail */
+	TRC_ASSERT(puiState != (void*)0);
+
+	/* This should never fail */
+	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_FLIGHT_RECORDER));
+
+	*puiState = pxFlightRecorder->uiState;
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceFlightRecorderOnTrigger(uint32_t uiTrigger)
+{
+	if (((uint32_t)(TRC_CFG_FLIGHT_RECORDER_TRIGGERS) & uiTrigger) == 0u)
+	{
+		return TRC_FAIL;
+	}
+
+	return xTraceFlightRecorderTrigger();
+}
+
+traceResult xTraceFlightRecorderOnError(uint32_t uiErrorCode)
+{
+	uint32_t uiTrigger = (uiErrorCode == TRC_ERROR_ASSERT) ? TRC_FLIGHT_RECORDER_TRIGGER_ASSERT : TRC_FLIGHT_RECORDER_TRIGGER_ERROR;
+	TRACE_ALLOC_CRITICAL_SECTION();
+
+	if ((((uint32_t)(TRC_CFG_FLIGHT_RECORDER_TRIGGERS) & uiTrigger) == 0u) ||
+		(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_FLIGHT_RECORDER) == 0U) ||
+		(xTraceIsRecorderEnabled() == 0))
+	{
+		return TRC_FAIL;
+	}
+
+	TRACE_ENTER_CRITICAL_SECTION();
+
+	/* No post-trigger events, the recorder may not be in a state to store them.
+	 * A capture that is being transferred already ends before the error. */
+	if (pxFlightRecorder->uiState != TRC_FLIGHT_RECORDER_STATE_DRAINING)
+	{
+		prvTraceFlightRecorderFreeze();
+	}
+	pxFlightRecorder->uiStopPending = 1u;
+	pxFlightRecorder->uiStalledTransfers = 0u;
+
+	TRACE_EXIT_CRITICAL_SECTION();
+
+	(void)xTraceDiagnosticsIncrease(TRC_DIAGNOSTICS_FLIGHT_RECORDER_CAPTURES);
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceFlightRecorderOnStore(uint32_t uiSize)
+{
+	if ((xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_FLIGHT_RECORDER) == 0U) ||
+		(pxFlightRecorder->uiState != TRC_FLIGHT_RECORDER_STATE_TRIGGERED))
+	{
+		return TRC_SUCCESS;
+	}
+
+	if (uiSize < pxFlightRecorder->uiPostRemaining)
+	{
+		pxFlightRecorder->uiPostRemaining -= uiSize;
+	}
+	else
+	{
+		/* Frozen with this event stored, so the capture ends on a whole event */
+		pxFlightRecorder->uiPostRemaining = 0u;
+		prvTraceFlightRecorderFreeze();
+	}
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceFlightRecorderOnTraceBegin(void)
+{
+	/* This should never fail */
+	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_FLIGHT_RECORDER));
+
+	pxFlightRecorder->uiStopPending = 0u;
+	pxFlightRecorder->uiStalledTransfers = 0u;
+
+	prvTraceFlightRecorderFreeze();
+
+	return TRC_SUCCESS;
+}
+
+/* Transfers up to TRC_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT chunks
+ * of the capture from each core, returns 1 if anything was transferred */
+static uint32_t prvTraceFlightRecorderTransferPass(uint32_t* puiRemaining)
+{
+	uint32_t uiCoreId;
+	uint32_t uiChunkSize;
+	uint32_t uiChunks;
+	uint32_t uiProgress = 0u;
+	int32_t iBytesWritten;
+
+	*puiRemaining = 0u;
+
+	/* Only the capture is transferred, what has been stored after it stays
+	 * in the buffer as the start of the next one */
+	for (uiCoreId = 0u; uiCoreId < (uint32_t)(TRC_CFG_CORE_COUNT); uiCoreId++)
+	{
+		for (uiChunks = 0u; (pxFlightRecorder->uiFrozen[uiCoreId] > 0u) && (uiChunks < (uint32_t)(TRC_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT)); uiChunks++)
+		{
+			uiChunkSize = pxFlightRecorder->uiFrozen[uiCoreId];
+			if (uiChunkSize > (uint32_t)(TRC_INTERNAL_BUFFER_CHUNK_SIZE))
+			{
+				uiChunkSize = (uint32_t)(TRC_INTERNAL_BUFFER_CHUNK_SIZE);
+			}
+
+			iBytesWritten = 0;
+			if ((xTraceInternalEventBufferTransferCoreChunk(uiCoreId, uiChunkSize, &iBytesWritten) == TRC_FAIL) || (iBytesWritten <= 0))
+			{
+				break;
+			}
+
+			pxFlightRecorder->uiFrozen[uiCoreId] -= (uint32_t)iBytesWritten;
+			uiProgress = 1u;
+		}
+
+		*puiRemaining += pxFlightRecorder->uiFrozen[uiCoreId];
+	}
+
+	return uiProgress;
+}
+
+/* Gives up the rest of the capture */
+static void prvTraceFlightRecorderAbandon(void)
+{
+	uint32_t uiCoreId;
+
+	for (uiCoreId = 0u; uiCoreId < (uint32_t)(TRC_CFG_CORE_COUNT); uiCoreId++)
+	{
+		pxFlightRecorder->uiFrozen[uiCoreId] = 0u;
+	}
+}
+
+traceResult xTraceFlightRecorderOnTraceEnd(void)
+{
+	uint32_t uiRemaining = 0u;
+	uint32_t uiAttempts = 0u;
+	TRACE_ALLOC_CRITICAL_SECTION();
+
+	if (xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_FLIGHT_RECORDER) == 0U)
+	{
+		return TRC_SUCCESS;
+	}
+
+	TRACE_ENTER_CRITICAL_SECTION();
+
+	/* Without a capture in progress, the buffer is the capture */
+	if (pxFlightRecorder->uiState != TRC_FLIGHT_RECORDER_STATE_DRAINING)
+	{
+		prvTraceFlightRecorderFreeze();
+	}
+	pxFlightRecorder->uiStopPending = 0u;
+
+	TRACE_EXIT_CRITICAL_SECTION();
+
+	while (uiAttempts < (uint32_t)(TRC_CFG_FLIGHT_RECORDER_STOP_ATTEMPTS))
+	{
+		if (prvTraceFlightRecorderTransferPass(&uiRemaining) != 0u)
+		{
+			uiAttempts = 0u;
+		}
+		else
+		{
+			uiAttempts++;
+		}
+
+		if (uiRemaining == 0u)
+		{
+			return TRC_SUCCESS;
+		}
+	}
+
+	prvTraceFlightRecorderAbandon();
+
+	return TRC_FAIL;
+}
+
+traceResult xTraceFlightRecorderTransfer(void)
+{
+	uint32_t uiRemaining = 0u;
+	uint32_t uiState;
+	TRACE_ALLOC_CRITICAL_SECTION();
+
+	/* This should never fail */
+	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_FLIGHT_RECORDER));
+
+	TRACE_ENTER_CRITICAL_SECTION();
+
+	/* The post-trigger bytes may all be stored with nothing stored since */
+	if ((pxFlightRecorder->uiState == TRC_FLIGHT_RECORDER_STATE_TRIGGERED) && (pxFlightRecorder->uiPostRemaining == 0u))
+	{
+		prvTraceFlightRecorderFreeze();
+	}
+
+	uiState = pxFlightRecorder->uiState;
+
+	TRACE_EXIT_CRITICAL_SECTION();
+
+	if (uiState != TRC_FLIGHT_RECORDER_STATE_DRAINING)
+	{
+		/* Nothing is transferred while overwriting */
+		return TRC_SUCCESS;
+	}
+
+	if (prvTraceFlightRecorderTransferPass(&uiRemaining) != 0u)
+	{
+		pxFlightRecorder->uiStalledTransfers = 0u;
+	}
+	else if (uiRemaining > 0u)
+	{
+		pxFlightRecorder->uiStalledTransfers++;
+	}
+	else
+	{
+		/* Nothing left */
+	}
+
+	if (pxFlightRecorder->uiStopPending != 0u)
+	{
+		/* Stopped by xTraceError(), once the capture is out or hasn't moved
+		 * for TRC_CFG_FLIGHT_RECORDER_STOP_ATTEMPTS calls in a row */
+		if (pxFlightRecorder->uiStalledTransfers >= (uint32_t)(TRC_CFG_FLIGHT_RECORDER_STOP_ATTEMPTS))
+		{
+			prvTraceFlightRecorderAbandon();
+			(void)xTraceDisable();
+		}
+		else if (uiRemaining == 0u)
+		{
+			(void)xTraceDisable();
+		}
+		else
+		{
+			/* Try again on the next call */
+		}
+
+		return TRC_SUCCESS;
+	}
+
+	if (uiRemaining == 0u)
+	{
+		TRACE_ENTER_CRITICAL_SECTION();
+
+		/* The tail is at the start of an event again, old events may be overwritten */
+		(void)xTraceInternalEventBufferSetOptions(TRC_EVENT_BUFFER_OPTION_OVERWRITE);
+		pxFlightRecorder->uiState = TRC_FLIGHT_RECORDER_STATE_ARMED;
+
+		TRACE_EXIT_CRITICAL_SECTION();
+	}
+
+	return TRC_SUCCESS;
+}
+
+#endif
+
+#endif
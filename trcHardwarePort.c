@@ -151,4 +151,151 @@ void cortex_a9_r5_exit_critical(uint32_t cs_type)
 }
 #endif /* ((TRC_CFG_HARDWARE_PORT == TRC_HARDWARE_PORT_ARM_CORTEX_A9) || (TRC_CFG_HARDWARE_PORT == TRC_HARDWARE_PORT_XILINX_ZyncUltraScaleR5)) */
 
+#if (TRC_CFG_HARDWARE_PORT == TRC_HARDWARE_PORT_POSIX)
+
+#include <pthread.h>
+#include <time.h>
+#if (defined(__linux__) && defined(_GNU_SOURCE))
+#include <sched.h>
+#endif
+
+#ifndef TRC_CFG_POSIX_USE_CYCLE_COUNTER
+#define TRC_CFG_POSIX_USE_CYCLE_COUNTER 0
+#endif
+
+#if (TRC_CFG_POSIX_USE_CYCLE_COUNTER == 1) && defined(__x86_64__)
+#define TRC_POSIX_COUNTER_RDTSC 1
+#elif (TRC_CFG_POSIX_USE_CYCLE_COUNTER == 1) && defined(__aarch64__)
+#define TRC_POSIX_COUNTER_CNTVCT 1
+#endif
+
+/* Time used to calibrate the frequency of rdtsc against the monotonic clock */
+#define TRC_POSIX_CALIBRATION_NS 10000000ULL
+
+static pthread_mutex_t xTracePosixMutex;
+static pthread_once_t xTracePosixMutexOnce = PTHREAD_ONCE_INIT;
+static __thread uint32_t uiTracePosixNesting = 0u;
+
+#if (TRC_CFG_CORE_COUNT > 1)
+static __thread uint32_t uiTracePosixCore = 0u;
+#endif
+
+static uint32_t uiTracePosixFrequency = 1000000000UL;
+static uint32_t uiTracePosixShift = 0u;
+
+static uint64_t prvTracePosixMonotonicNs(void)
+{
+	struct timespec xTime;
+
+	(void)clock_gettime(CLOCK_MONOTONIC_RAW, &xTime);
+
+	return ((uint64_t)xTime.tv_sec * 1000000000ULL) + (uint64_t)xTime.tv_nsec;
+}
+
+static uint64_t prvTracePosixReadCounter(void)
+{
+#if defined(TRC_POSIX_COUNTER_RDTSC)
+	uint32_t uiLow, uiHigh;
+
+	__asm__ volatile ("rdtsc" : "=a" (uiLow), "=d" (uiHigh));
+
+	return ((uint64_t)uiHigh << 32) | uiLow;
+#elif defined(TRC_POSIX_COUNTER_CNTVCT)
+	uint64_t uxValue;
+
+	__asm__ volatile ("mrs %0, cntvct_el0" : "=r" (uxValue));
+
+	return uxValue;
+#else
+	return prvTracePosixMonotonicNs();
+#endif
+}
+
+void vTraceTimerReset(void)
+{
+	uint64_t uxFrequency = 1000000000ULL;
+
+#if defined(TRC_POSIX_COUNTER_RDTSC)
+	uint64_t uxStartNs, uxEndNs, uxStartCount, uxEndCount;
+
+	uxStartNs = prvTracePosixMonotonicNs();
+	uxStartCount = prvTracePosixReadCounter();
+	do
+	{
+		uxEndNs = prvTracePosixMonotonicNs();
+	} while ((uxEndNs - uxStartNs) < TRC_POSIX_CALIBRATION_NS);
+	uxEndCount = prvTracePosixReadCounter();
+
+	uxFrequency = ((uxEndCount - uxStartCount) * 1000000000ULL) / (uxEndNs - uxStartNs);
+#elif defined(TRC_POSIX_COUNTER_CNTVCT)
+	__asm__ volatile ("mrs %0, cntfrq_el0" : "=r" (uxFrequency));
+#endif
+
+	/* The counter is scaled down until the frequency fits in 32 bits */
+	uiTracePosixShift = 0u;
+	while ((uxFrequency >> uiTracePosixShift) > 0xFFFFFFFFULL)
+	{
+		uiTracePosixShift++;
+	}
+
+	uiTracePosixFrequency = (uint32_t)(uxFrequency >> uiTracePosixShift);
+}
+
+uint32_t uiTraceTimerGetFrequency(void)
+{
+	return uiTracePosixFrequency;
+}
+
+uint32_t uiTraceTimerGetValue(void)
+{
+	return (uint32_t)(prvTracePosixReadCounter() >> uiTracePosixShift);
+}
+
+static void prvTracePosixInitMutex(void)
+{
+	pthread_mutexattr_t xAttr;
+
+	(void)pthread_mutexattr_init(&xAttr);
+	(void)pthread_mutexattr_settype(&xAttr, PTHREAD_MUTEX_RECURSIVE);
+	(void)pthread_mutex_init(&xTracePosixMutex, &xAttr);
+	(void)pthread_mutexattr_destroy(&xAttr);
+}
+
+uint32_t uiTracePosixEnterCritical(void)
+{
+	(void)pthread_once(&xTracePosixMutexOnce, prvTracePosixInitMutex);
+	(void)pthread_mutex_lock(&xTracePosixMutex);
+
+	uiTracePosixNesting++;
+
+#if (TRC_CFG_CORE_COUNT > 1) && (defined(__linux__) && defined(_GNU_SOURCE))
+	if (uiTracePosixNesting == 1u)
+	{
+		int iCpu = sched_getcpu();
+
+		uiTracePosixCore = (iCpu < 0) ? 0u : ((uint32_t)iCpu % (TRC_CFG_CORE_COUNT));
+	}
+#endif
+
+	return uiTracePosixNesting;
+}
+
+void vTracePosixExitCritical(uint32_t uiNesting)
+{
+	(void)uiNesting;
+
+	uiTracePosixNesting--;
+
+	(void)pthread_mutex_unlock(&xTracePosixMutex);
+}
+
+#if (TRC_CFG_CORE_COUNT > 1)
+uint32_t uiTracePosixGetCurrentCore(void)
+{
+	return uiTracePosixCore;
+}
+#endif
+
+#endif /* (TRC_CFG_HARDWARE_PORT == TRC_HARDWARE_PORT_POSIX) */
+
 #endif /* (TRC_USE_TRACEALYZER_RECORDER == 1) */
@@ -18,6 +18,105 @@
 
 static TraceMultiCoreEventBuffer_t *pxInternalEventBuffer TRC_CFG_RECORDER_DATA_ATTRIBUTE;
 
+#if ((TRC_CFG_EVENT_LANES) == 1)
+
+typedef struct TraceInternalEventBufferLanes	/* Aligned */
+{
+	uint32_t uiLane[TRC_CFG_CORE_COUNT];		/* The lane of the next event on each core */
+	uint32_t uiReserve[TRC_EVENT_LANE_COUNT];	/* Bytes a lane must leave free in the core's buffer */
+} TraceInternalEventBufferLanes_t;
+
+static TraceInternalEventBufferLanes_t xEventLanes TRC_CFG_RECORDER_DATA_ATTRIBUTE;
+
+static const TraceDiagnosticsType_t xEventLaneDropped[TRC_EVENT_LANE_COUNT] = {
+	TRC_DIAGNOSTICS_LANE_SCHEDULING_DROPPED,
+	TRC_DIAGNOSTICS_LANE_OBJECT_DROPPED,
+	TRC_DIAGNOSTICS_LANE_USER_DROPPED
+};
+
+/**
+ * @internal Takes the lane selected for this event and checks that storing
+ * uiSize bytes would leave the reserves of the higher lanes free.
+ *
+ * @param[in] uiSize Event size
+ * @param[out] puiLane The lane of the event
+ *
+ * @retval TRC_FAIL The event must be shed
+ * @retval TRC_SUCCESS There is room
+ */
+static traceResult prvTraceInternalEventBufferCheckLane(uint32_t uiSize, uint32_t* puiLane)
+{
+	const uint32_t uiCoreId = TRC_CFG_GET_CURRENT_CORE();
+	const TraceEventBuffer_t* pxEventBuffer;
+	uint32_t uiUsed = 0u;
+
+	TRC_ASSERT(uiCoreId < (TRC_CFG_CORE_COUNT));
+
+	*puiLane = xEventLanes.uiLane[uiCoreId];
+	xEventLanes.uiLane[uiCoreId] = TRC_EVENT_LANE_SCHEDULING;
+
+	if (xEventLanes.uiReserve[*puiLane] == 0u)
+	{
+		return TRC_SUCCESS;
+	}
+
+	pxEventBuffer = pxInternalEventBuffer->xEventBuffer[uiCoreId];
+
+	/* While overwriting, nothing is dropped for want of room */
+	if (pxEventBuffer->uiOptions == TRC_EVENT_BUFFER_OPTION_OVERWRITE)
+	{
+		return TRC_SUCCESS;
+	}
+
+	/* This should never fail */
+	TRC_ASSERT_ALWAYS_EVALUATE(xTraceEventBufferGetUsed(pxEventBuffer, &uiUsed) == TRC_SUCCESS);
+
+	if ((uiUsed + uiSize + xEventLanes.uiReserve[*puiLane]) > pxEventBuffer->uiSize)
+	{
+		return TRC_FAIL;
+	}
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceInternalEventBufferSelectLane(uint32_t uiEventCode)
+{
+	const uint32_t uiCoreId = TRC_CFG_GET_CURRENT_CORE();
+	const uint32_t uiEventId = uiEventCode & 0xFFFUL;
+	uint32_t uiLane;
+
+	TRC_ASSERT(uiCoreId < (TRC_CFG_CORE_COUNT));
+
+	if ((uiEventId == (uint32_t)(PSF_EVENT_TASK_ACTIVATE)) ||
+		(uiEventId == (uint32_t)(PSF_EVENT_TASK_READY)) ||
+		(uiEventId == (uint32_t)(PSF_EVENT_ISR_BEGIN)) ||
+		(uiEventId == (uint32_t)(PSF_EVENT_ISR_RESUME)) ||
+		(uiEventId == (uint32_t)(PSF_EVENT_TRACE_START)) ||
+		(uiEventId == (uint32_t)(PSF_EVENT_TS_CONFIG)))
+	{
+		uiLane = TRC_EVENT_LANE_SCHEDULING;
+	}
+	else if (((uiEventId >= (uint32_t)(PSF_EVENT_USER_EVENT)) && (uiEventId < ((uint32_t)(PSF_EVENT_USER_EVENT_FIXED) + 8UL))) ||
+		(uiEventId == (uint32_t)(PSF_EVENT_COUNTER_CHANGE)) ||
+		(uiEventId == (uint32_t)(PSF_EVENT_COUNTER_LIMIT_EXCEEDED)) ||
+		(uiEventId == (uint32_t)(PSF_EVENT_INTERVAL_START)) ||
+		(uiEventId == (uint32_t)(PSF_EVENT_INTERVAL_STOP)) ||
+		(uiEventId == (uint32_t)(PSF_EVENT_STATEMACHINE_STATECHANGE)))
+	{
+		uiLane = TRC_EVENT_LANE_USER;
+	}
+	else
+	{
+		uiLane = TRC_EVENT_LANE_OBJECT;
+	}
+
+	xEventLanes.uiLane[uiCoreId] = uiLane;
+
+	return TRC_SUCCESS;
+}
+
+#endif
+
 traceResult xTraceInternalEventBufferInitialize(uint8_t* puiBuffer, uint32_t uiSize)
 {
 	/* uiSize must be larger than sizeof(TraceMultiCoreEventBuffer_t) or there will be no room for any data */
@@ -35,6 +134,24 @@ traceResult xTraceInternalEventBufferInitialize(uint8_t* puiBuffer, uint32_t uiS
 		return TRC_FAIL;
 	}
 
+#if ((TRC_CFG_EVENT_LANES) == 1)
+	{
+		/* The core buffers are the same size */
+		const uint32_t uiCoreSize = pxInternalEventBuffer->xEventBuffer[0]->uiSize;
+		uint32_t i;
+
+		for (i = 0u; i < (uint32_t)(TRC_CFG_CORE_COUNT); i++)
+		{
+			xEventLanes.uiLane[i] = TRC_EVENT_LANE_SCHEDULING;
+		}
+
+		/* Each lane leaves the reserves of the lanes above it free */
+		xEventLanes.uiReserve[TRC_EVENT_LANE_SCHEDULING] = 0u;
+		xEventLanes.uiReserve[TRC_EVENT_LANE_OBJECT] = (uiCoreSize / 100u) * (uint32_t)(TRC_CFG_EVENT_LANE_RESERVE_SCHEDULING);
+		xEventLanes.uiReserve[TRC_EVENT_LANE_USER] = (uiCoreSize / 100u) * ((uint32_t)(TRC_CFG_EVENT_LANE_RESERVE_SCHEDULING) + (uint32_t)(TRC_CFG_EVENT_LANE_RESERVE_OBJECT));
+	}
+#endif
+
 	(void)xTraceSetComponentInitialized(TRC_RECORDER_COMPONENT_INTERNAL_EVENT_BUFFER);
 
 	return TRC_SUCCESS;
@@ -42,10 +159,26 @@ traceResult xTraceInternalEventBufferInitialize(uint8_t* puiBuffer, uint32_t uiS
 
 traceResult xTraceInternalEventBufferAlloc(uint32_t uiSize, void **ppvData)
 {
+#if ((TRC_CFG_EVENT_LANES) == 1)
+	uint32_t uiLane = TRC_EVENT_LANE_SCHEDULING;
+#endif
+
 	/* This should never fail */
 	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_INTERNAL_EVENT_BUFFER));
 
+#if ((TRC_CFG_EVENT_LANES) == 1)
+	if ((prvTraceInternalEventBufferCheckLane(uiSize, &uiLane) == TRC_FAIL) ||
+		(xTraceMultiCoreEventBufferAlloc(pxInternalEventBuffer, uiSize, ppvData) == TRC_FAIL))
+	{
+		(void)xTraceDiagnosticsIncrease(xEventLaneDropped[uiLane]);
+
+		return TRC_FAIL;
+	}
+
+	return TRC_SUCCESS;
+#else
 	return xTraceMultiCoreEventBufferAlloc(pxInternalEventBuffer, uiSize, ppvData);
+#endif
 }
 
 traceResult xTraceInternalEventBufferAllocCommit(void *pvData, uint32_t uiSize, int32_t *piBytesWritten)
@@ -55,15 +188,62 @@ traceResult xTraceInternalEventBufferAllocCommit(void *pvData, uint32_t uiSize,
 	/* This should never fail */
 	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_INTERNAL_EVENT_BUFFER));
 
-	return xTraceMultiCoreEventBufferAllocCommit(pxInternalEventBuffer, pvData, uiSize, piBytesWritten);
+	if (xTraceMultiCoreEventBufferAllocCommit(pxInternalEventBuffer, pvData, uiSize, piBytesWritten) == TRC_FAIL)
+	{
+		return TRC_FAIL;
+	}
+
+	/* With TRC_CFG_FLIGHT_RECORDER, counts the bytes stored after a trigger */
+	(void)xTraceFlightRecorderOnStore(uiSize);
+
+	return TRC_SUCCESS;
 }
 
 traceResult xTraceInternalEventBufferPush(void *pvData, uint32_t uiSize, int32_t *piBytesWritten)
 {
+#if ((TRC_CFG_EVENT_LANES) == 1)
+	uint32_t uiLane = TRC_EVENT_LANE_SCHEDULING;
+#endif
+
 	/* This should never fail */
 	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_INTERNAL_EVENT_BUFFER));
-	
-	return xTraceMultiCoreEventBufferPush(pxInternalEventBuffer, pvData, uiSize, piBytesWritten);
+
+	/* This should never fail */
+	TRC_ASSERT(piBytesWritten != (void*)0);
+
+#if ((TRC_CFG_EVENT_LANES) == 1)
+	/* A full buffer skips the event, like the push does */
+	if (prvTraceInternalEventBufferCheckLane(uiSize, &uiLane) == TRC_FAIL)
+	{
+		*piBytesWritten = 0;
+	}
+	else if (xTraceMultiCoreEventBufferPush(pxInternalEventBuffer, pvData, uiSize, piBytesWritten) == TRC_FAIL)
+	{
+		return TRC_FAIL;
+	}
+	else
+	{
+		/* Stored */
+	}
+
+	if (*piBytesWritten == 0)
+	{
+		(void)xTraceDiagnosticsIncrease(xEventLaneDropped[uiLane]);
+	}
+#else
+	if (xTraceMultiCoreEventBufferPush(pxInternalEventBuffer, pvData, uiSize, piBytesWritten) == TRC_FAIL)
+	{
+		return TRC_FAIL;
+	}
+#endif
+
+	/* With TRC_CFG_FLIGHT_RECORDER, counts the bytes stored after a trigger */
+	if (*piBytesWritten > 0)
+	{
+		(void)xTraceFlightRecorderOnStore((uint32_t)*piBytesWritten);
+	}
+
+	return TRC_SUCCESS;
 }
 
 traceResult xTraceInternalEventBufferTransferAll(void)
@@ -80,10 +260,13 @@ traceResult xTraceInternalEventBufferTransferChunk(void)
 {
 	int32_t iBytesWritten = 0;
 	int32_t iCounter = 0;
+	uint32_t uiChunkBudget = 0u;
 
 	/* This should never fail */
 	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_INTERNAL_EVENT_BUFFER));
 
+	(void)xTraceAdaptiveCtrlGetChunkBudget(&uiChunkBudget);
+
 	do
 	{
 		if (xTraceMultiCoreEventBufferTransferChunk(pxInternalEventBuffer, TRC_INTERNAL_BUFFER_CHUNK_SIZE, &iBytesWritten) == TRC_FAIL)
@@ -92,8 +275,8 @@ traceResult xTraceInternalEventBufferTransferChunk(void)
 		}
 
 		iCounter++;
-		/* This will do another loop if TRC_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_SIZE_LIMIT of data was transferred and we haven't already looped TRC_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT number of times */
-	} while (iBytesWritten >= (int32_t)(TRC_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_SIZE_LIMIT) && iCounter < (int32_t)(TRC_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT));
+		/* This will do another loop if TRC_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_SIZE_LIMIT of data was transferred and we haven't already looped uiChunkBudget number of times */
+	} while (iBytesWritten >= (int32_t)(TRC_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_SIZE_LIMIT) && iCounter < (int32_t)uiChunkBudget);
 
 	return TRC_SUCCESS;
 }
@@ -102,8 +285,43 @@ traceResult xTraceInternalEventBufferClear()
 {
 	/* This should never fail */
 	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_INTERNAL_EVENT_BUFFER));
+
+	/* The flight recorder may have left it overwriting */
+	(void)xTraceMultiCoreEventBufferSetOptions(pxInternalEventBuffer, TRC_EVENT_BUFFER_OPTION_SKIP);
 	
 	return xTraceMultiCoreEventBufferClear(pxInternalEventBuffer);
 }
 
+traceResult xTraceInternalEventBufferGetUsed(uint32_t* puiUsed, uint32_t* puiSize)
+{
+	/* This should never fail */
+	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_INTERNAL_EVENT_BUFFER));
+
+	return xTraceMultiCoreEventBufferGetUsed(pxInternalEventBuffer, puiUsed, puiSize);
+}
+
+traceResult xTraceInternalEventBufferGetCoreUsed(uint32_t uiCoreId, uint32_t* puiUsed)
+{
+	/* This should never fail */
+	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_INTERNAL_EVENT_BUFFER));
+
+	return xTraceMultiCoreEventBufferGetCoreUsed(pxInternalEventBuffer, uiCoreId, puiUsed);
+}
+
+traceResult xTraceInternalEventBufferTransferCoreChunk(uint32_t uiCoreId, uint32_t uiChunkSize, int32_t* piBytesWritten)
+{
+	/* This should never fail */
+	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_INTERNAL_EVENT_BUFFER));
+
+	return xTraceMultiCoreEventBufferTransferCoreChunk(pxInternalEventBuffer, uiCoreId, uiChunkSize, piBytesWritten);
+}
+
+traceResult xTraceInternalEventBufferSetOptions(uint32_t uiOptions)
+{
+	/* This should never fail */
+	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_INTERNAL_EVENT_BUFFER));
+
+	return xTraceMultiCoreEventBufferSetOptions(pxInternalEventBuffer, uiOptions);
+}
+
 #endif
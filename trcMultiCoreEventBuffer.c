@@ -108,6 +108,8 @@ traceResult xTraceMultiCoreEventBufferTransferAll(const TraceMultiCoreEventBuffe
 		}
 
 		*piBytesWritten += iBytesWritten;
+
+		TRC_DIAGNOSTICS_TRANSFERRED(uiCoreId, iBytesWritten)
 	}
 
 	return TRC_SUCCESS;
@@ -136,6 +138,8 @@ traceResult xTraceMultiCoreEventBufferTransferChunk(const TraceMultiCoreEventBuf
 		}
 
 		*piBytesWritten += iBytesWritten;
+
+		TRC_DIAGNOSTICS_TRANSFERRED(uiCoreId, iBytesWritten)
 	}
 
 	return TRC_SUCCESS;
@@ -157,4 +161,83 @@ traceResult xTraceMultiCoreEventBufferClear(const TraceMultiCoreEventBuffer_t* c
 	return TRC_SUCCESS;
 }
 
+traceResult xTraceMultiCoreEventBufferGetUsed(const TraceMultiCoreEventBuffer_t* const pxTraceMultiCoreEventBuffer, uint32_t* puiUsed, uint32_t* puiSize)
+{
+	uint32_t uiUsed = 0u;
+	uint32_t uiCoreId;
+
+	/* This should never fail */
+	TRC_ASSERT(pxTraceMultiCoreEventBuffer != (void*)0);
+
+	/* This should never fail */
+	TRC_ASSERT(puiUsed != (void*)0);
+
+	/* This should never fail */
+	TRC_ASSERT(puiSize != (void*)0);
+
+	*puiUsed = 0u;
+	*puiSize = pxTraceMultiCoreEventBuffer->xEventBuffer[0]->uiSize;
+
+	for (uiCoreId = 0u; uiCoreId < (uint32_t)(TRC_CFG_CORE_COUNT); uiCoreId++)
+	{
+		/* This should never fail */
+		TRC_ASSERT_ALWAYS_EVALUATE(xTraceEventBufferGetUsed(pxTraceMultiCoreEventBuffer->xEventBuffer[uiCoreId], &uiUsed) == TRC_SUCCESS);
+
+		/* The core buffers are the same size, the fullest one is the one that would overflow first */
+		if (uiUsed > *puiUsed)
+		{
+			*puiUsed = uiUsed;
+			*puiSize = pxTraceMultiCoreEventBuffer->xEventBuffer[uiCoreId]->uiSize;
+		}
+	}
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceMultiCoreEventBufferGetCoreUsed(const TraceMultiCoreEventBuffer_t* const pxTraceMultiCoreEventBuffer, uint32_t uiCoreId, uint32_t* puiUsed)
+{
+	/* This should never fail */
+	TRC_ASSERT(pxTraceMultiCoreEventBuffer != (void*)0);
+
+	/* This should never fail */
+	TRC_ASSERT(uiCoreId < (uint32_t)(TRC_CFG_CORE_COUNT));
+
+	return xTraceEventBufferGetUsed(pxTraceMultiCoreEventBuffer->xEventBuffer[uiCoreId], puiUsed);
+}
+
+/*cstat !MISRAC2012-Rule-5.1 Yes, these are long names*/
+traceResult xTraceMultiCoreEventBufferTransferCoreChunk(const TraceMultiCoreEventBuffer_t* const pxTraceMultiCoreEventBuffer, uint32_t uiCoreId, uint32_t uiChunkSize, int32_t* piBytesWritten)
+{
+	/* This should never fail */
+	TRC_ASSERT(pxTraceMultiCoreEventBuffer != (void*)0);
+
+	/* This should never fail */
+	TRC_ASSERT(uiCoreId < (uint32_t)(TRC_CFG_CORE_COUNT));
+
+	if (xTraceEventBufferTransferChunk(pxTraceMultiCoreEventBuffer->xEventBuffer[uiCoreId], uiChunkSize, piBytesWritten) == TRC_FAIL)
+	{
+		return TRC_FAIL;
+	}
+
+	TRC_DIAGNOSTICS_TRANSFERRED(uiCoreId, *piBytesWritten)
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceMultiCoreEventBufferSetOptions(const TraceMultiCoreEventBuffer_t* const pxTraceMultiCoreEventBuffer, uint32_t uiOptions)
+{
+	uint32_t uiCoreId;
+
+	/* This should never fail */
+	TRC_ASSERT(pxTraceMultiCoreEventBuffer != (void*)0);
+
+	for (uiCoreId = 0u; uiCoreId < (uint32_t)(TRC_CFG_CORE_COUNT); uiCoreId++)
+	{
+		/* This should never fail */
+		TRC_ASSERT_ALWAYS_EVALUATE(xTraceEventBufferSetOptions(pxTraceMultiCoreEventBuffer->xEventBuffer[uiCoreId], uiOptions) == TRC_SUCCESS);
+	}
+
+	return TRC_SUCCESS;
+}
+
 #endif
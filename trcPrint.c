@@ -225,6 +225,31 @@ traceResult xTraceVPrintF(TraceStringHandle_t xChannel, const char* szFormat, va
 	return prvTraceVPrintF(xChannel, szFormat, uiLength, uiArgs, pxVariableList);
 }
 
+traceResult xTracePrintGetDefaultChannel(TraceStringHandle_t* pxChannel)
+{
+	/* This should never fail */
+	TRC_ASSERT(pxChannel != (void*)0);
+
+	/* We need to check this */
+	if (xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_PRINT) == 0U)
+	{
+		return TRC_FAIL;
+	}
+
+	if (pxPrintData->defaultChannel == 0)
+	{
+		/* Channel is not present */
+		if (xTraceStringRegister("Default", &pxPrintData->defaultChannel) == TRC_FAIL)
+		{
+			return TRC_FAIL;
+		}
+	}
+
+	*pxChannel = pxPrintData->defaultChannel;
+
+	return TRC_SUCCESS;
+}
+
 /*cstat !MISRAC2004-6.3 !MISRAC2012-Dir-4.6_a Suppress basic char type usage*/ /*cstat !MISRAC2012-Rule-17.1 Suppress stdarg usage check*/
 static traceResult prvTraceVPrintF(TraceStringHandle_t xChannel, const char* szFormat, uint32_t uiLength, uint32_t uiArgs, va_list* pxVariableList)
 {
@@ -238,16 +263,10 @@ static traceResult prvTraceVPrintF(TraceStringHandle_t xChannel, const char* szF
 
 	if (xChannel == 0)
 	{
-		if (pxPrintData->defaultChannel == 0)
+		if (xTracePrintGetDefaultChannel(&xChannel) == TRC_FAIL) /*cstat !MISRAC2012-Rule-17.8 Suppress modified function parameter check*/
 		{
-			/* Channel is not present */
-			if (xTraceStringRegister("Default", &pxPrintData->defaultChannel) == TRC_FAIL)
-			{
-				return TRC_FAIL;
-			}
+			return TRC_FAIL;
 		}
-
-		xChannel = pxPrintData->defaultChannel; /*cstat !MISRAC2012-Rule-17.8 Suppress modified function parameter check*/
 	}
 
 	switch (uiArgs)
@@ -0,0 +1,216 @@
+/*
+* Percepio Trace Recorder for Tracealyzer v4.10.3
+* Copyright 2023 Percepio AB
+* www.percepio.com
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* The implementation of the recorder self-profiling.
+*/
+
+#include <trcRecorder.h>
+
+#if (TRC_USE_TRACEALYZER_RECORDER == 1) && (TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)
+
+#if ((TRC_CFG_SELF_PROFILING) == 1)
+
+static TraceProfilingData_t* pxProfiling TRC_CFG_RECORDER_DATA_ATTRIBUTE;
+
+/*cstat !MISRAC2004-6.3 !MISRAC2012-Dir-4.6_a Suppress basic char type usage*/
+static const char* const aszProfilingChannels[TRC_PROFILING_PROBE_COUNT] = {
+	"#Cost EventCreate",
+	"#Cost Allocate",
+	"#Cost Commit",
+	"#Cost Transfer",
+	"#Cost EntryFind"
+};
+
+static void prvTraceProfilingClear(void)
+{
+	uint32_t uiCoreId;
+	uint32_t uiProbe;
+	uint32_t i;
+	TraceProfilingStats_t* pxStats;
+
+	for (uiCoreId = 0u; uiCoreId < (uint32_t)(TRC_CFG_CORE_COUNT); uiCoreId++)
+	{
+		for (uiProbe = 0u; uiProbe < TRC_PROFILING_PROBE_COUNT; uiProbe++)
+		{
+			pxStats = &pxProfiling->xStats[uiCoreId][uiProbe];
+
+			pxStats->uiCount = 0u;
+			pxStats->uiMin = 0xFFFFFFFFUL;
+			pxStats->uiMax = 0u;
+			pxStats->uiReserved = 0u;
+			pxStats->ullSum = 0u;
+			for (i = 0u; i < TRC_PROFILING_BUCKETS; i++)
+			{
+				pxStats->auiHistogram[i] = 0u;
+			}
+		}
+	}
+}
+
+traceResult xTraceProfilingInitialize(TraceProfilingData_t* pxBuffer)
+{
+	uint32_t i;
+
+	/* This should never fail */
+	TRC_ASSERT(pxBuffer != (void*)0);
+
+	pxProfiling = pxBuffer;
+
+	prvTraceProfilingClear();
+
+	pxProfiling->uiReportCountdown = (uint32_t)(TRC_CFG_SELF_PROFILING_REPORT_INTERVAL);
+	pxProfiling->uiReserved = 0u;
+	for (i = 0u; i < TRC_PROFILING_PROBE_COUNT; i++)
+	{
+		pxProfiling->xChannels[i] = 0;
+	}
+
+	(void)xTraceSetComponentInitialized(TRC_RECORDER_COMPONENT_PROFILING);
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceProfilingRecord(TraceProfilingProbe_t xProbe, uint32_t uiStart, uint32_t uiStop)
+{
+	TraceProfilingStats_t* pxStats;
+	uint32_t uiTicks;
+	uint32_t uiBucket;
+	TRACE_ALLOC_CRITICAL_SECTION();
+
+	/* Entries may be looked up before the recorder is initialized */
+	if (xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_PROFILING) == 0U)
+	{
+		return TRC_FAIL;
+	}
+
+	/* This should never fail */
+	TRC_ASSERT((uint32_t)xProbe < TRC_PROFILING_PROBE_COUNT);
+
+	uiTicks = TRC_HWTC_TICKS_BETWEEN(uiStart, uiStop);
+
+	/* The highest bit set */
+	uiBucket = 0u;
+	while (((uiTicks >> 1) >> uiBucket) != 0u)
+	{
+		uiBucket++;
+	}
+	if (uiBucket >= TRC_PROFILING_BUCKETS)
+	{
+		uiBucket = TRC_PROFILING_BUCKETS - 1u;
+	}
+
+	TRACE_ENTER_CRITICAL_SECTION();
+
+	pxStats = &pxProfiling->xStats[TRC_CFG_GET_CURRENT_CORE()][xProbe];
+
+	pxStats->uiCount++;
+	pxStats->ullSum += uiTicks;
+	if (uiTicks < pxStats->uiMin)
+	{
+		pxStats->uiMin = uiTicks;
+	}
+	if (uiTicks > pxStats->uiMax)
+	{
+		pxStats->uiMax = uiTicks;
+	}
+	pxStats->auiHistogram[uiBucket]++;
+
+	TRACE_EXIT_CRITICAL_SECTION();
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceProfilingGet(TraceProfilingProbe_t xProbe, uint32_t uiCoreId, TraceProfilingStats_t* pxStats)
+{
+	TRACE_ALLOC_CRITICAL_SECTION();
+
+	/* This should never fail */
+	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_PROFILING));
+
+	/* This should never fail */
+	TRC_ASSERT((uint32_t)xProbe < TRC_PROFILING_PROBE_COUNT);
+
+	/* This should never fail */
+	TRC_ASSERT(uiCoreId < (uint32_t)(TRC_CFG_CORE_COUNT));
+
+	/* This should never fail */
+	TRC_ASSERT(pxStats != (void*)0);
+
+	TRACE_ENTER_CRITICAL_SECTION();
+
+	*pxStats = pxProfiling->xStats[uiCoreId][xProbe];
+
+	TRACE_EXIT_CRITICAL_SECTION();
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceProfilingReset(void)
+{
+	TRACE_ALLOC_CRITICAL_SECTION();
+
+	/* This should never fail */
+	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_PROFILING));
+
+	TRACE_ENTER_CRITICAL_SECTION();
+
+	prvTraceProfilingClear();
+
+	TRACE_EXIT_CRITICAL_SECTION();
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceProfilingReport(void)
+{
+	TraceProfilingStats_t xStats;
+	uint32_t uiCoreId;
+	uint32_t uiProbe;
+
+	/* This should never fail */
+	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_PROFILING));
+
+	pxProfiling->uiReportCountdown--;
+	if (pxProfiling->uiReportCountdown > 0u)
+	{
+		return TRC_SUCCESS;
+	}
+	pxProfiling->uiReportCountdown = (uint32_t)(TRC_CFG_SELF_PROFILING_REPORT_INTERVAL);
+
+	for (uiProbe = 0u; uiProbe < TRC_PROFILING_PROBE_COUNT; uiProbe++)
+	{
+		for (uiCoreId = 0u; uiCoreId < (uint32_t)(TRC_CFG_CORE_COUNT); uiCoreId++)
+		{
+			(void)xTraceProfilingGet((TraceProfilingProbe_t)uiProbe, uiCoreId, &xStats);
+			if (xStats.uiCount == 0u)
+			{
+				continue;
+			}
+
+			if (pxProfiling->xChannels[uiProbe] == 0)
+			{
+				if (xTraceStringRegister(aszProfilingChannels[uiProbe], &pxProfiling->xChannels[uiProbe]) == TRC_FAIL)
+				{
+					return TRC_FAIL;
+				}
+			}
+
+			(void)xTracePrintF(pxProfiling->xChannels[uiProbe], "Core %d: %d calls, min %d, mean %d, max %d",
+				(TraceUnsignedBaseType_t)uiCoreId,
+				(TraceUnsignedBaseType_t)xStats.uiCount,
+				(TraceUnsignedBaseType_t)xStats.uiMin,
+				(TraceUnsignedBaseType_t)(xStats.ullSum / xStats.uiCount),
+				(TraceUnsignedBaseType_t)xStats.uiMax);
+		}
+	}
+
+	return TRC_SUCCESS;
+}
+
+#endif
+
+#endif
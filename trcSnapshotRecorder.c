@@ -17,6 +17,7 @@
 #include <string.h>
 #include <stdarg.h>
 #include <stdint.h>
+#include <stddef.h>
 
 #ifndef TRC_CFG_RECORDER_DATA_INIT
 #define TRC_CFG_RECORDER_DATA_INIT 1
@@ -27,7 +28,16 @@
 #endif
 
 /* DO NOT CHANGE */
+#if ((TRC_SNAPSHOT_CORE_COUNT) > 1)
+/* Has the event buffers of core 1 and up, and the symbol table always has
+the hashBits field */
+#define TRACE_MINOR_VERSION 9
+#elif ((TRC_CFG_SYMBOL_TABLE_HASH_BITS) == 6)
 #define TRACE_MINOR_VERSION 7
+#else
+/* Symbol table has the hashBits field and a wider list head array */
+#define TRACE_MINOR_VERSION 8
+#endif
 
 /* Keeps track of the task's stack low mark */
 typedef struct {
@@ -37,23 +47,118 @@ typedef struct {
 
 TraceKernelPortDataBuffer_t xKernelPortDataBuffer;
 
-#if (TRC_CFG_INCLUDE_ISR_TRACING == 1)
 /*******************************************************************************
-* isrstack
+* TraceSnapshotCoreData_t
 *
-* Keeps track of nested interrupts.
+* Recorder state that belongs to one core. Every core writes events to its own
+* event buffer, with its own timestamp and DTS state, so cores never need to
+* lock each other out to store an event.
 ******************************************************************************/
-static traceHandle isrstack[TRC_CFG_MAX_ISR_NESTING];
+typedef struct TraceSnapshotCoreData
+{
+	/* The counters and event data of this core's event buffer */
+	EventLogCounters* pxLog;
+	uint8_t* eventData;
+
+	/* The task currently running on this core */
+	traceHandle handle_of_last_logged_task;
+
+	/* The number of currently active (including preempted) ISRs */
+	int8_t nISRactive;
+
+#if (TRC_CFG_INCLUDE_ISR_TRACING == 1)
+	/* Keeps track of nested interrupts */
+	traceHandle isrstack[TRC_CFG_MAX_ISR_NESTING];
+
+	/* If there is a pending context switch the recorder will not create an
+	event when returning from the ISR */
+	int32_t isPendingContextSwitch;
+#endif /* (TRC_CFG_INCLUDE_ISR_TRACING == 1) */
+
+	/* The timestamp of the previous event, used by prvTraceGetDTS */
+	uint32_t old_timestamp;
+
+	/* TRC_RECIPROCAL of pxLog->frequency, set when the frequency of this
+	core is normalized. Used by prvTraceGetDTS to split time into seconds
+	without division. */
+	uint32_t frequencyReciprocal;
+
+	/* The most recent timestamp and the timer state behind it, used by
+	prvTracePortGetTimeStamp */
+	uint32_t last_timestamp;
+	uint32_t last_hwtc_count;
+#if TRC_HWTC_TYPE == TRC_OS_TIMER_INCR || TRC_HWTC_TYPE == TRC_OS_TIMER_DECR
+	uint32_t last_traceTickCount;
+#else
+	uint32_t last_hwtc_rest;
+#endif
+
+#if (TRC_CFG_INCLUDE_SNAPSHOT_EXPORT == 1)
+	/* The number of event slots written since vTraceClear, including the
+	padding at the end of the buffer, modulo TRC_EXPORT_POSITION_LIMIT. Kept
+	in a single variable so that xTraceSnapshotExport can read the write
+	position of another core without locking. */
+	volatile uint32_t slotsWritten;
+
+	/* Incremented each time the core has cleared its event buffer, after
+	slotsWritten has been reset */
+	volatile uint32_t clearCount;
+
+#if (TRC_CFG_SNAPSHOT_MODE == TRC_SNAPSHOT_MODE_RING_BUFFER)
+	/* The position, in slotsWritten terms, up to which the slots after the
+	write position have been cleared by
+	prvCheckDataToBeOverwrittenForMultiEntryEvents */
+	volatile uint32_t slotsCleared;
+#endif
+#endif
+
+	/* Set by vTraceClear. The event buffer of a core is only written by the
+	core itself, within its core critical section, so the core clears it
+	before it stores its next event. */
+	volatile uint32_t clearPending;
+} TraceSnapshotCoreData_t;
+
+static TraceSnapshotCoreData_t xCoreData[TRC_SNAPSHOT_CORE_COUNT];
+
+/* Core 0 uses the counters in RecorderDataType as an EventLogCounters, so
+they must have the same layout */
+typedef char EventLogCountersMatchRecorderData_t[
+	((offsetof(RecorderDataType, absTimeLastEventSecond) - offsetof(RecorderDataType, numEvents)) == offsetof(EventLogCounters, absTimeLastEventSecond)) &&
+	((offsetof(RecorderDataType, frequency) - offsetof(RecorderDataType, numEvents)) == offsetof(EventLogCounters, frequency)) &&
+	(sizeof(EventLogCounters) == 7 * sizeof(uint32_t)) ? 1 : -1];
+
+static void prvTraceClearCoreEventBuffer(TraceSnapshotCoreData_t* pxCoreData);
+
+#if (TRC_CFG_INCLUDE_SNAPSHOT_EXPORT == 1)
+/* A multiple of the event buffer size, so that slotsWritten modulo the buffer
+size always equals nextFreeIndex */
+#define TRC_EXPORT_POSITION_LIMIT ((0xFFFFFFFFUL / (TRC_CFG_EVENT_BUFFER_SIZE)) * (TRC_CFG_EVENT_BUFFER_SIZE))
+
+#define TRC_EXPORT_OBJECT_BLOCK_SIZE TRC_SNAPSHOT_EXPORT_OBJECT_BLOCK_SIZE
+#define TRC_EXPORT_OBJECT_BLOCKS TRC_SNAPSHOT_EXPORT_OBJECT_BLOCKS
 
 /*******************************************************************************
-* isPendingContextSwitch
+* objectBlockVersion
 *
-* Used to indicate if there is a pending context switch.
-* If there is a pending context switch the recorder will not create an event
-* when returning from the ISR.
+* One version per 32 bytes of the object property table, incremented when the
+* block is modified. Each export cursor holds the versions it has sent.
 ******************************************************************************/
-int32_t isPendingContextSwitch = 0;
-#endif /* (TRC_CFG_INCLUDE_ISR_TRACING == 1) */
+static volatile uint16_t objectBlockVersion[TRC_EXPORT_OBJECT_BLOCKS];
+
+static void prvTraceExportSlotsWritten(TraceSnapshotCoreData_t* pxCoreData, uint32_t uiSlots);
+static void prvTraceExportObjectChanged(uint16_t uiIndex, uint16_t uiLength);
+#if (TRC_CFG_SNAPSHOT_MODE == TRC_SNAPSHOT_MODE_RING_BUFFER)
+static void prvTraceExportSlotsCleared(TraceSnapshotCoreData_t* pxCoreData, uint32_t uiAhead);
+#endif
+
+#define trcEXPORT_SLOTS_WRITTEN(pxCoreData, slots) prvTraceExportSlotsWritten(pxCoreData, slots)
+#define trcEXPORT_OBJECT_CHANGED(index, length) prvTraceExportObjectChanged(index, length)
+#define trcEXPORT_SLOTS_CLEARED(pxCoreData, ahead) prvTraceExportSlotsCleared(pxCoreData, ahead)
+#else
+#define trcEXPORT_SLOTS_WRITTEN(pxCoreData, slots)
+#define trcEXPORT_OBJECT_CHANGED(index, length)
+#define trcEXPORT_SLOTS_CLEARED(pxCoreData, ahead)
+#endif /* (TRC_CFG_INCLUDE_SNAPSHOT_EXPORT == 1) */
 
 /*******************************************************************************
 * readyEventsEnabled
@@ -82,13 +187,6 @@ uint32_t uiTraceTickCount = 0;
 ******************************************************************************/
 uint32_t trace_disable_timestamp = 0;
 
-/*******************************************************************************
-* last_timestamp
-*
-* The most recent timestamp.
-******************************************************************************/
-static uint32_t last_timestamp = 0;
-
 /*******************************************************************************
 * uiTraceSystemState
 *
@@ -99,9 +197,9 @@ volatile uint32_t uiTraceSystemState = TRC_STATE_IN_STARTUP;
 /*******************************************************************************
 * recorder_busy
 *
-* Flag that shows if inside a critical section of the recorder.
+* Flags that show if a core is inside a critical section of the recorder.
 ******************************************************************************/
-volatile int recorder_busy = 0;
+volatile int recorder_busy[TRC_SNAPSHOT_CORE_COUNT];
 
 /*******************************************************************************
 * timestampFrequency
@@ -110,20 +208,6 @@ volatile int recorder_busy = 0;
 ******************************************************************************/
 uint32_t timestampFrequency = 0;
 
-/*******************************************************************************
-* nISRactive
-*
-* The number of currently active (including preempted) ISRs.
-******************************************************************************/
-int8_t nISRactive = 0;
-
-/*******************************************************************************
-* handle_of_last_logged_task
-*
-* The current task.
-******************************************************************************/
-traceHandle handle_of_last_logged_task = 0;
-
 /*******************************************************************************
 * vTraceStopHookPtr
 *
@@ -212,7 +296,7 @@ uint32_t RecorderInitialized TRC_CFG_RECORDER_DATA_ATTRIBUTE;
 /*************** Private Functions *******************************************/
 static void prvStrncpy(char* dst, const char* src, uint32_t maxLength);
 static uint8_t prvTraceGetObjectState(uint8_t objectclass, traceHandle id); 
-static void prvTraceGetChecksum(const char *pname, uint8_t* pcrc, uint8_t* plength); 
+static void prvTraceGetChecksum(const char *pname, uint16_t* pcrc, uint8_t* plength); 
 static void* prvTraceNextFreeEventBufferSlot(void); 
 static uint16_t prvTraceGetDTS(uint16_t param_maxDTS);
 static TraceStringHandle_t prvTraceOpenSymbol(const char* name, TraceStringHandle_t userEventChannel);
@@ -225,12 +309,12 @@ static void prvCheckDataToBeOverwrittenForMultiEntryEvents(uint8_t nEntries);
 #endif
 
 static TraceStringHandle_t prvTraceCreateSymbolTableEntry(const char* name,
-										uint8_t crc6,
+										uint16_t hash,
 										uint8_t len,
 										TraceStringHandle_t channel);
 
 static TraceStringHandle_t prvTraceLookupSymbolTableEntry(const char* name,
-										uint8_t crc6,
+										uint16_t hash,
 										uint8_t len,
 										TraceStringHandle_t channel);
 
@@ -375,20 +459,52 @@ void vTraceSetStopHook(TRACE_STOP_HOOK stopHookFunction)
 
 void vTraceClear(void)
 {
+	uint32_t core;
 	TRACE_ALLOC_CRITICAL_SECTION();
+
+	/* Each core clears its own event buffer under its own core critical
+	section, the other cores when they store their next event */
+	for (core = 0; core < (TRC_SNAPSHOT_CORE_COUNT); core++)
+	{
+		xCoreData[core].clearPending = 1;
+	}
+
+	trcCORE_CRITICAL_SECTION_BEGIN();
+	prvTraceClearCoreEventBuffer(&xCoreData[TRC_SNAPSHOT_GET_CURRENT_CORE()]);
+	xCoreData[TRC_SNAPSHOT_GET_CURRENT_CORE()].handle_of_last_logged_task = 0;
+	trcCORE_CRITICAL_SECTION_END();
+
 	trcCRITICAL_SECTION_BEGIN();
-	RecorderDataPtr->absTimeLastEventSecond = 0;
-	RecorderDataPtr->absTimeLastEvent = 0;
-	RecorderDataPtr->nextFreeIndex = 0;
-	RecorderDataPtr->numEvents = 0;
-	RecorderDataPtr->bufferIsFull = 0;
 	traceErrorMessage = (void*)0;
 	RecorderDataPtr->internalErrorOccured = 0;
-	(void)memset(RecorderDataPtr->eventData, 0, RecorderDataPtr->maxEvents * 4);
-	handle_of_last_logged_task = 0;
 	trcCRITICAL_SECTION_END();
 }
 
+/*******************************************************************************
+ * prvTraceClearCoreEventBuffer
+ *
+ * Clears the event buffer of a core after vTraceClear. Must be called by that
+ * core, within its core critical section.
+ ******************************************************************************/
+static void prvTraceClearCoreEventBuffer(TraceSnapshotCoreData_t* pxCoreData)
+{
+	pxCoreData->pxLog->absTimeLastEventSecond = 0;
+	pxCoreData->pxLog->absTimeLastEvent = 0;
+	pxCoreData->pxLog->nextFreeIndex = 0;
+	pxCoreData->pxLog->numEvents = 0;
+	pxCoreData->pxLog->bufferIsFull = 0;
+	(void)memset(pxCoreData->eventData, 0, pxCoreData->pxLog->maxEvents * 4);
+#if (TRC_CFG_INCLUDE_SNAPSHOT_EXPORT == 1)
+	pxCoreData->slotsWritten = 0;
+#if (TRC_CFG_SNAPSHOT_MODE == TRC_SNAPSHOT_MODE_RING_BUFFER)
+	pxCoreData->slotsCleared = 0;
+#endif
+	TRACE_MEMORY_BARRIER();
+	pxCoreData->clearCount++;
+#endif
+	pxCoreData->clearPending = 0;
+}
+
 static void prvTraceStart(void)
 {
 	traceHandle handle;
@@ -437,7 +553,9 @@ static void prvTraceStop(void)
 {
 	if (RecorderDataPtr != (void*)0)
 	{
+		trcSHARED_SECTION_BEGIN();
 		RecorderDataPtr->recorderActive = 0;
+		trcSHARED_SECTION_END();
 	}
 
 	if (vTraceStopHookPtr != (TRACE_STOP_HOOK)0)
@@ -525,6 +643,669 @@ uint32_t uiTraceGetTraceBufferSize(void)
 	return sizeof(RecorderDataType);
 }
 
+#if (TRC_CFG_INCLUDE_SNAPSHOT_EXPORT == 1)
+
+/* Byte offset of a field in the recorder data */
+#define TRC_EXPORT_OFFSET(field) ((uint32_t)((uint8_t*)&(field) - (uint8_t*)RecorderDataPtr))
+
+/* Event slots right after the write position, i.e., the oldest ones in the
+ring buffer, may be cleared at any time by
+prvCheckDataToBeOverwrittenForMultiEntryEvents. They are not exported. */
+#if (TRC_CFG_SNAPSHOT_MODE == TRC_SNAPSHOT_MODE_RING_BUFFER)
+#define TRC_EXPORT_EVENT_MARGIN 32
+#else
+#define TRC_EXPORT_EVENT_MARGIN 0
+#endif
+
+#if ((TRC_CFG_EVENT_BUFFER_SIZE) <= 2 * TRC_EXPORT_EVENT_MARGIN)
+#error "TRC_CFG_INCLUDE_SNAPSHOT_EXPORT requires TRC_CFG_EVENT_BUFFER_SIZE above 64 in ring buffer mode!"
+#endif
+
+/* The output buffer of one xTraceSnapshotExport call */
+typedef struct TraceSnapshotExportOutput
+{
+	uint8_t* pucBuffer;
+	uint32_t uiSize;
+	uint32_t uiUsed;
+} TraceSnapshotExportOutput_t;
+
+/*******************************************************************************
+ * prvTraceExportSlotsWritten
+ *
+ * Advances slotsWritten of a core after its event buffer has been written.
+ ******************************************************************************/
+static void prvTraceExportSlotsWritten(TraceSnapshotCoreData_t* pxCoreData, uint32_t uiSlots)
+{
+	uint32_t uiWritten = pxCoreData->slotsWritten;
+
+	/* The events must be visible to an export on another core first */
+	TRACE_MEMORY_BARRIER();
+
+	if (uiWritten < TRC_EXPORT_POSITION_LIMIT - uiSlots)
+	{
+		pxCoreData->slotsWritten = uiWritten + uiSlots;
+	}
+	else
+	{
+		pxCoreData->slotsWritten = uiWritten - (TRC_EXPORT_POSITION_LIMIT - uiSlots);
+	}
+}
+
+/*******************************************************************************
+ * prvTraceExportObjectChanged
+ *
+ * Flags the object property table blocks covering the given bytes as changed.
+ ******************************************************************************/
+static void prvTraceExportObjectChanged(uint16_t uiIndex, uint16_t uiLength)
+{
+	uint32_t uiBlock;
+
+	TRACE_MEMORY_BARRIER();
+
+	for (uiBlock = uiIndex / TRC_EXPORT_OBJECT_BLOCK_SIZE; uiBlock <= (uint32_t)(uiIndex + uiLength - 1) / TRC_EXPORT_OBJECT_BLOCK_SIZE; uiBlock++)
+	{
+		objectBlockVersion[uiBlock]++;
+	}
+}
+
+/*******************************************************************************
+ * prvTraceExportRetreat
+ *
+ * Returns the event position uiSlots before uiPosition.
+ ******************************************************************************/
+static uint32_t prvTraceExportRetreat(uint32_t uiPosition, uint32_t uiSlots)
+{
+	if (uiPosition >= uiSlots)
+	{
+		return uiPosition - uiSlots;
+	}
+
+	return uiPosition + (TRC_EXPORT_POSITION_LIMIT - uiSlots);
+}
+
+/*******************************************************************************
+ * prvTraceExportDistance
+ *
+ * Returns the number of event slots from uiFrom to uiTo.
+ ******************************************************************************/
+static uint32_t prvTraceExportDistance(uint32_t uiFrom, uint32_t uiTo)
+{
+	if (uiTo >= uiFrom)
+	{
+		return uiTo - uiFrom;
+	}
+
+	return uiTo + (TRC_EXPORT_POSITION_LIMIT - uiFrom);
+}
+
+#if (TRC_CFG_SNAPSHOT_MODE == TRC_SNAPSHOT_MODE_RING_BUFFER)
+/*******************************************************************************
+ * prvTraceExportSlotsCleared
+ *
+ * Records that the slots up to uiAhead slots after the write position of a
+ * core have been cleared.
+ ******************************************************************************/
+static void prvTraceExportSlotsCleared(TraceSnapshotCoreData_t* pxCoreData, uint32_t uiAhead)
+{
+	uint32_t uiWritten = pxCoreData->slotsWritten;
+	uint32_t uiCleared = prvTraceExportDistance(uiWritten, pxCoreData->slotsCleared);
+
+	/* A position behind the write position is from an earlier lap */
+	if ((uiCleared > TRC_EXPORT_EVENT_MARGIN) || (uiCleared < uiAhead))
+	{
+		TRACE_MEMORY_BARRIER();
+		pxCoreData->slotsCleared = (uiWritten < TRC_EXPORT_POSITION_LIMIT - uiAhead) ? uiWritten + uiAhead : uiWritten - (TRC_EXPORT_POSITION_LIMIT - uiAhead);
+	}
+}
+#endif
+
+/*******************************************************************************
+ * prvTraceExportRoom
+ *
+ * Returns how many data bytes fit in the next record, a multiple of 4.
+ ******************************************************************************/
+static uint32_t prvTraceExportRoom(const TraceSnapshotExportOutput_t* pxOut)
+{
+	uint32_t uiFree = pxOut->uiSize - pxOut->uiUsed;
+
+	if (uiFree < sizeof(TraceSnapshotExportRecord_t) + 4)
+	{
+		return 0;
+	}
+
+	return TRC_ALIGN_FLOOR(uiFree - sizeof(TraceSnapshotExportRecord_t), 4);
+}
+
+/*******************************************************************************
+ * prvTraceExportRecord
+ *
+ * Writes one record. The caller has checked that it fits.
+ ******************************************************************************/
+static void prvTraceExportRecord(TraceSnapshotExportOutput_t* pxOut, uint32_t uiOffset, const void* pvData, uint32_t uiLength)
+{
+	TraceSnapshotExportRecord_t xRecord;
+	uint32_t uiPadding = TRC_ALIGN_CEIL(uiLength, 4) - uiLength;
+
+	xRecord.uiOffset = uiOffset;
+	xRecord.uiLength = uiLength;
+	(void)memcpy(&pxOut->pucBuffer[pxOut->uiUsed], &xRecord, sizeof(xRecord));
+	pxOut->uiUsed += sizeof(xRecord);
+	(void)memcpy(&pxOut->pucBuffer[pxOut->uiUsed], pvData, uiLength);
+	pxOut->uiUsed += uiLength;
+	(void)memset(&pxOut->pucBuffer[pxOut->uiUsed], 0, uiPadding);
+	pxOut->uiUsed += uiPadding;
+}
+
+/*******************************************************************************
+ * prvTraceExportStatic
+ *
+ * Exports everything not handled by the incremental parts, i.e., the headers,
+ * the system info and the end markers. Only done once per cursor.
+ ******************************************************************************/
+static void prvTraceExportStatic(TraceSnapshotExportCursor_t* pxCursor, TraceSnapshotExportOutput_t* pxOut)
+{
+	/* Start and length of the incremental parts, in increasing order */
+	uint32_t uiSkip[4 + (TRC_SNAPSHOT_CORE_COUNT)][2];
+	uint32_t uiSkipCount = 0;
+	uint32_t uiOffset, uiChunkEnd, uiLength, i;
+
+	uiSkip[uiSkipCount][0] = TRC_EXPORT_OFFSET(RecorderDataPtr->ObjectPropertyTable.objbytes);
+	uiSkip[uiSkipCount][1] = sizeof(RecorderDataPtr->ObjectPropertyTable.objbytes);
+	uiSkipCount++;
+	uiSkip[uiSkipCount][0] = TRC_EXPORT_OFFSET(RecorderDataPtr->SymbolTable.symbytes);
+	uiSkip[uiSkipCount][1] = sizeof(RecorderDataPtr->SymbolTable.symbytes);
+	uiSkipCount++;
+	uiSkip[uiSkipCount][0] = TRC_EXPORT_OFFSET(RecorderDataPtr->eventData);
+	uiSkip[uiSkipCount][1] = sizeof(RecorderDataPtr->eventData);
+	uiSkipCount++;
+#if ((TRC_CFG_INCLUDE_USER_EVENTS == 1) && (TRC_CFG_USE_SEPARATE_USER_EVENT_BUFFER == 1))
+	uiSkip[uiSkipCount][0] = TRC_EXPORT_OFFSET(RecorderDataPtr->userEventBuffer);
+	uiSkip[uiSkipCount][1] = sizeof(RecorderDataPtr->userEventBuffer);
+	uiSkipCount++;
+#endif
+#if (TRC_SNAPSHOT_CORE_COUNT > 1)
+	for (i = 0; i < (TRC_SNAPSHOT_CORE_COUNT) - 1; i++)
+	{
+		uiSkip[uiSkipCount][0] = TRC_EXPORT_OFFSET(RecorderDataPtr->coreEventBuffers[i].eventData);
+		uiSkip[uiSkipCount][1] = sizeof(RecorderDataPtr->coreEventBuffers[i].eventData);
+		uiSkipCount++;
+	}
+#endif
+
+	uiOffset = pxCursor->uiStaticOffset;
+	while (uiOffset < sizeof(RecorderDataType))
+	{
+		uiChunkEnd = sizeof(RecorderDataType);
+		for (i = 0; i < uiSkipCount; i++)
+		{
+			if (uiOffset < uiSkip[i][0])
+			{
+				uiChunkEnd = uiSkip[i][0];
+				break;
+			}
+
+			if (uiOffset < uiSkip[i][0] + uiSkip[i][1])
+			{
+				uiOffset = uiSkip[i][0] + uiSkip[i][1];
+			}
+		}
+
+		if (uiOffset >= uiChunkEnd)
+		{
+			continue;
+		}
+
+		uiLength = prvTraceExportRoom(pxOut);
+		if (uiLength == 0)
+		{
+			break;
+		}
+
+		if (uiLength > uiChunkEnd - uiOffset)
+		{
+			uiLength = uiChunkEnd - uiOffset;
+		}
+
+		prvTraceExportRecord(pxOut, uiOffset, (uint8_t*)RecorderDataPtr + uiOffset, uiLength);
+		uiOffset += uiLength;
+	}
+
+	pxCursor->uiStaticOffset = uiOffset;
+}
+
+/*******************************************************************************
+ * prvTraceExportObjects
+ *
+ * Exports the blocks of the object property table changed since the cursor
+ * last sent them.
+ ******************************************************************************/
+static void prvTraceExportObjects(TraceSnapshotExportCursor_t* pxCursor, TraceSnapshotExportOutput_t* pxOut)
+{
+	uint32_t uiBlock, uiOffset, uiLength;
+	uint16_t uiVersion;
+
+	for (uiBlock = 0; uiBlock < TRC_EXPORT_OBJECT_BLOCKS; uiBlock++)
+	{
+		uiVersion = objectBlockVersion[uiBlock];
+		if (uiVersion != pxCursor->uiObjectBlockVersion[uiBlock])
+		{
+			uiOffset = uiBlock * TRC_EXPORT_OBJECT_BLOCK_SIZE;
+			uiLength = sizeof(RecorderDataPtr->ObjectPropertyTable.objbytes) - uiOffset;
+			if (uiLength > TRC_EXPORT_OBJECT_BLOCK_SIZE)
+			{
+				uiLength = TRC_EXPORT_OBJECT_BLOCK_SIZE;
+			}
+
+			if (prvTraceExportRoom(pxOut) < uiLength)
+			{
+				return;
+			}
+
+			/* The version is read before copying, so a change made meanwhile
+			is sent again */
+			TRACE_MEMORY_BARRIER();
+			pxCursor->uiObjectBlockVersion[uiBlock] = uiVersion;
+			prvTraceExportRecord(pxOut,
+				TRC_EXPORT_OFFSET(RecorderDataPtr->ObjectPropertyTable.objbytes[uiOffset]),
+				&RecorderDataPtr->ObjectPropertyTable.objbytes[uiOffset],
+				uiLength);
+		}
+	}
+}
+
+/*******************************************************************************
+ * prvTraceExportSymbols
+ *
+ * Exports new symbol table entries, followed by nextFreeSymbolIndex. The list
+ * heads in latestEntryOfChecksum are only used for lookups on the target and
+ * are not exported after the first time.
+ ******************************************************************************/
+static void prvTraceExportSymbols(TraceSnapshotExportCursor_t* pxCursor, TraceSnapshotExportOutput_t* pxOut)
+{
+	uint32_t uiNextFree = RecorderDataPtr->SymbolTable.nextFreeSymbolIndex;
+	uint32_t uiLength;
+
+	while (pxCursor->uiSymbolIndex < uiNextFree)
+	{
+		uiLength = prvTraceExportRoom(pxOut);
+		if (uiLength < sizeof(TraceSnapshotExportRecord_t) + 8)
+		{
+			return;
+		}
+
+		/* Leave room for nextFreeSymbolIndex */
+		uiLength -= sizeof(TraceSnapshotExportRecord_t) + 4;
+		if (uiLength > uiNextFree - pxCursor->uiSymbolIndex)
+		{
+			uiLength = uiNextFree - pxCursor->uiSymbolIndex;
+		}
+
+		prvTraceExportRecord(pxOut,
+			TRC_EXPORT_OFFSET(RecorderDataPtr->SymbolTable.symbytes[pxCursor->uiSymbolIndex]),
+			&RecorderDataPtr->SymbolTable.symbytes[pxCursor->uiSymbolIndex],
+			uiLength);
+		pxCursor->uiSymbolIndex += uiLength;
+
+		prvTraceExportRecord(pxOut,
+			TRC_EXPORT_OFFSET(RecorderDataPtr->SymbolTable.nextFreeSymbolIndex),
+			&pxCursor->uiSymbolIndex,
+			sizeof(pxCursor->uiSymbolIndex));
+	}
+}
+
+/*******************************************************************************
+ * prvTraceExportZero
+ *
+ * Writes zero fill records for uiCount event slots of a core, starting at
+ * uiIndex and wrapping at the end of the buffer.
+ ******************************************************************************/
+static void prvTraceExportZero(TraceSnapshotExportOutput_t* pxOut, const TraceSnapshotCoreData_t* pxCoreData, uint32_t uiIndex, uint32_t uiCount)
+{
+	TraceSnapshotExportRecord_t xRecord;
+	uint32_t uiChunk;
+
+	while (uiCount > 0)
+	{
+		uiChunk = (TRC_CFG_EVENT_BUFFER_SIZE) - uiIndex;
+		if (uiChunk > uiCount)
+		{
+			uiChunk = uiCount;
+		}
+
+		xRecord.uiOffset = (uint32_t)(&pxCoreData->eventData[uiIndex * 4] - (uint8_t*)RecorderDataPtr);
+		xRecord.uiLength = (uiChunk * 4) | TRC_SNAPSHOT_EXPORT_ZERO_FILL;
+		(void)memcpy(&pxOut->pucBuffer[pxOut->uiUsed], &xRecord, sizeof(xRecord));
+		pxOut->uiUsed += sizeof(xRecord);
+
+		uiCount -= uiChunk;
+		uiIndex = 0;
+	}
+}
+
+/*******************************************************************************
+ * prvTraceExportEvents
+ *
+ * Exports the events a core has stored since the previous export, followed by
+ * the counters of its event buffer. The counters describe the exported events,
+ * so the result is consistent even if more events were stored meanwhile.
+ * Slots the target has cleared or that were lost are zero filled, so that no
+ * stale parts of older events remain. If the core has cleared its event buffer
+ * since the previous export, the whole buffer is zero filled first.
+ ******************************************************************************/
+static void prvTraceExportEvents(TraceSnapshotExportCursor_t* pxCursor, TraceSnapshotExportOutput_t* pxOut, uint32_t uiCore)
+{
+	TraceSnapshotCoreData_t* pxCoreData = &xCoreData[uiCore];
+	uint32_t uiCounters[sizeof(EventLogCounters) / 4 + 4];
+	uint32_t uiCountersOffset, uiReserved;
+	uint32_t uiWritten, uiPending, uiIndex, uiSlots, uiChunk, uiRoom, uiUsedBefore, uiAttempt, uiUnexported;
+	uint32_t uiPosition, uiClearCount, uiDropped;
+#if (TRC_CFG_SNAPSHOT_MODE == TRC_SNAPSHOT_MODE_RING_BUFFER)
+	uint32_t uiZero;
+#endif
+	EventLogCounters xCounters;
+
+	if (uiCore == 0)
+	{
+		/* Also covers recorderActive to heapMemUsage */
+		uiCountersOffset = TRC_EXPORT_OFFSET(RecorderDataPtr->numEvents);
+		uiReserved = TRC_EXPORT_OFFSET(RecorderDataPtr->debugMarker0) - uiCountersOffset;
+	}
+	else
+	{
+		uiCountersOffset = (uint32_t)((uint8_t*)pxCoreData->pxLog - (uint8_t*)RecorderDataPtr);
+		uiReserved = sizeof(EventLogCounters);
+	}
+
+	/* Counters record and up to two zero fill records after the events */
+	uiReserved += 3 * sizeof(TraceSnapshotExportRecord_t);
+
+	for (uiAttempt = 0; uiAttempt < 2; uiAttempt++)
+	{
+		uiUsedBefore = pxOut->uiUsed;
+		uiPosition = pxCursor->uiEventPosition[uiCore];
+		uiDropped = 0;
+
+		/* The slots before slotsWritten hold complete events, see
+		prvTraceExportSlotsWritten */
+		uiClearCount = pxCoreData->clearCount;
+		TRACE_MEMORY_BARRIER();
+		uiWritten = pxCoreData->slotsWritten;
+		TRACE_MEMORY_BARRIER();
+
+		if (uiClearCount != pxCursor->uiClearCount[uiCore])
+		{
+			/* The core has cleared its event buffer, start over */
+			if (prvTraceExportRoom(pxOut) < uiReserved + 4)
+			{
+				return;
+			}
+
+			prvTraceExportZero(pxOut, pxCoreData, 0, (TRC_CFG_EVENT_BUFFER_SIZE));
+			uiPosition = 0;
+		}
+		else if (uiWritten == uiPosition)
+		{
+			return;
+		}
+
+		uiPending = prvTraceExportDistance(uiPosition, uiWritten);
+		if (uiPending > (TRC_CFG_EVENT_BUFFER_SIZE) - TRC_EXPORT_EVENT_MARGIN)
+		{
+			/* The oldest unexported events have been overwritten */
+			uiDropped = uiPending - ((TRC_CFG_EVENT_BUFFER_SIZE) - TRC_EXPORT_EVENT_MARGIN);
+			uiPending = (TRC_CFG_EVENT_BUFFER_SIZE) - TRC_EXPORT_EVENT_MARGIN;
+			uiPosition = prvTraceExportRetreat(uiWritten, uiPending);
+		}
+
+		uiIndex = uiPosition % (TRC_CFG_EVENT_BUFFER_SIZE);
+		uiSlots = 0;
+		while (uiSlots < uiPending)
+		{
+			uiRoom = prvTraceExportRoom(pxOut);
+			if (uiRoom < uiReserved + 4)
+			{
+				break;
+			}
+
+			uiChunk = (uiRoom - uiReserved) / 4;
+			if (uiChunk > uiPending - uiSlots)
+			{
+				uiChunk = uiPending - uiSlots;
+			}
+
+			if (uiChunk > (TRC_CFG_EVENT_BUFFER_SIZE) - uiIndex)
+			{
+				uiChunk = (TRC_CFG_EVENT_BUFFER_SIZE) - uiIndex;
+			}
+
+			prvTraceExportRecord(pxOut,
+				(uint32_t)(&pxCoreData->eventData[uiIndex * 4] - (uint8_t*)RecorderDataPtr),
+				&pxCoreData->eventData[uiIndex * 4],
+				uiChunk * 4);
+
+			uiSlots += uiChunk;
+			uiIndex += uiChunk;
+			if (uiIndex == (TRC_CFG_EVENT_BUFFER_SIZE))
+			{
+				uiIndex = 0;
+			}
+
+			/* Two chunks at most, so the zero fill records still fit */
+			if (uiIndex != 0)
+			{
+				break;
+			}
+		}
+
+		if ((uiSlots == 0) && (uiPending != 0))
+		{
+			/* No room left, the cursor is unchanged */
+			pxOut->uiUsed = uiUsedBefore;
+			return;
+		}
+
+		/* If the events were overwritten, or the event buffer cleared, while
+		being copied, discard them and try again */
+		TRACE_MEMORY_BARRIER();
+		uiWritten = pxCoreData->slotsWritten;
+		TRACE_MEMORY_BARRIER();
+		if ((pxCoreData->clearCount != uiClearCount) ||
+			(prvTraceExportDistance(uiPosition, uiWritten) > (TRC_CFG_EVENT_BUFFER_SIZE) - TRC_EXPORT_EVENT_MARGIN))
+		{
+			pxOut->uiUsed = uiUsedBefore;
+			continue;
+		}
+
+		uiUnexported = prvTraceExportDistance(uiPosition, uiWritten) - uiSlots;
+		uiPosition = prvTraceExportRetreat(uiWritten, uiUnexported);
+
+		if (uiDropped != 0)
+		{
+			/* Only the exported events are valid, clear the rest */
+			prvTraceExportZero(pxOut, pxCoreData, uiIndex, (TRC_CFG_EVENT_BUFFER_SIZE) - uiSlots);
+		}
+#if (TRC_CFG_SNAPSHOT_MODE == TRC_SNAPSHOT_MODE_RING_BUFFER)
+		else if ((uiUnexported == 0) && (pxCoreData->pxLog->bufferIsFull != 0))
+		{
+			/* The slots after the last event that
+			prvCheckDataToBeOverwrittenForMultiEntryEvents has cleared */
+			uiZero = prvTraceExportDistance(uiWritten, pxCoreData->slotsCleared);
+			if (uiZero <= TRC_EXPORT_EVENT_MARGIN)
+			{
+				prvTraceExportZero(pxOut, pxCoreData, uiIndex, uiZero);
+			}
+		}
+#endif
+
+		xCounters = *pxCoreData->pxLog;
+		xCounters.numEvents = (xCounters.numEvents > uiUnexported) ? xCounters.numEvents - uiUnexported : 0;
+		xCounters.nextFreeIndex = uiIndex;
+		(void)memcpy(uiCounters, &xCounters, sizeof(xCounters));
+		if (uiCore == 0)
+		{
+			(void)memcpy(&uiCounters[sizeof(EventLogCounters) / 4], &RecorderDataPtr->recorderActive, TRC_EXPORT_OFFSET(RecorderDataPtr->debugMarker0) - TRC_EXPORT_OFFSET(RecorderDataPtr->recorderActive));
+		}
+
+		prvTraceExportRecord(pxOut, uiCountersOffset, uiCounters, uiReserved - 3 * sizeof(TraceSnapshotExportRecord_t));
+		pxCursor->uiEventPosition[uiCore] = uiPosition;
+		pxCursor->uiClearCount[uiCore] = uiClearCount;
+		pxCursor->uiDroppedEvents += uiDropped;
+		return;
+	}
+}
+
+#if ((TRC_CFG_INCLUDE_USER_EVENTS == 1) && (TRC_CFG_USE_SEPARATE_USER_EVENT_BUFFER == 1))
+/*******************************************************************************
+ * prvTraceExportUserEventBuffer
+ *
+ * Exports the whole separate user event buffer each time it has changed.
+ ******************************************************************************/
+static void prvTraceExportUserEventBuffer(TraceSnapshotExportCursor_t* pxCursor, TraceSnapshotExportOutput_t* pxOut)
+{
+	UserEventBuffer* pxBuffer = &RecorderDataPtr->userEventBuffer;
+	uint32_t uiState, uiLength;
+
+	if (pxCursor->uiUserEventBufferOffset == 0)
+	{
+		uiState = pxBuffer->wraparoundCounter * (TRC_CFG_SEPARATE_USER_EVENT_BUFFER_SIZE) +
+			pxBuffer->nextSlotToWrite + ((uint32_t)pxBuffer->numberOfChannels << 24);
+		if (uiState == pxCursor->uiUserEventBufferState)
+		{
+			return;
+		}
+
+		pxCursor->uiUserEventBufferState = uiState;
+	}
+
+	while (pxCursor->uiUserEventBufferOffset < sizeof(UserEventBuffer))
+	{
+		uiLength = prvTraceExportRoom(pxOut);
+		if (uiLength == 0)
+		{
+			return;
+		}
+
+		if (uiLength > sizeof(UserEventBuffer) - pxCursor->uiUserEventBufferOffset)
+		{
+			uiLength = sizeof(UserEventBuffer) - pxCursor->uiUserEventBufferOffset;
+		}
+
+		prvTraceExportRecord(pxOut,
+			TRC_EXPORT_OFFSET(*pxBuffer) + pxCursor->uiUserEventBufferOffset,
+			(uint8_t*)pxBuffer + pxCursor->uiUserEventBufferOffset,
+			uiLength);
+		pxCursor->uiUserEventBufferOffset += uiLength;
+	}
+
+	pxCursor->uiUserEventBufferOffset = 0;
+}
+#endif
+
+/*******************************************************************************
+ * prvTraceExportError
+ *
+ * Exports internalErrorOccured and the error message in systemInfo when the
+ * error state has changed.
+ ******************************************************************************/
+static void prvTraceExportError(TraceSnapshotExportCursor_t* pxCursor, TraceSnapshotExportOutput_t* pxOut)
+{
+	uint32_t uiOffset = TRC_EXPORT_OFFSET(RecorderDataPtr->internalErrorOccured);
+	uint32_t uiLength = TRC_EXPORT_OFFSET(RecorderDataPtr->debugMarker3) - uiOffset;
+	uint32_t uiError = RecorderDataPtr->internalErrorOccured;
+
+	if ((uiError != pxCursor->uiInternalErrorOccured) && (prvTraceExportRoom(pxOut) >= uiLength))
+	{
+		prvTraceExportRecord(pxOut, uiOffset, &RecorderDataPtr->internalErrorOccured, uiLength);
+		pxCursor->uiInternalErrorOccured = uiError;
+	}
+}
+
+traceResult xTraceSnapshotExportInit(TraceSnapshotExportCursor_t* pxCursor)
+{
+	uint32_t i, uiWritten;
+
+	TRACE_ASSERT(pxCursor != (void*)0, "xTraceSnapshotExportInit: pxCursor == NULL", TRC_FAIL);
+
+	if (RecorderDataPtr == (void*)0)
+	{
+		return TRC_FAIL;
+	}
+
+	pxCursor->uiStaticOffset = 0;
+	pxCursor->uiSymbolIndex = 0;
+	pxCursor->uiDroppedEvents = 0;
+	pxCursor->uiInternalErrorOccured = 0;
+	pxCursor->uiUserEventBufferOffset = 0;
+	pxCursor->uiUserEventBufferState = 0xFFFFFFFF;
+
+	for (i = 0; i < (TRC_SNAPSHOT_CORE_COUNT); i++)
+	{
+		/* Start from the oldest event still in the buffer */
+		pxCursor->uiClearCount[i] = xCoreData[i].clearCount;
+		TRACE_MEMORY_BARRIER();
+		uiWritten = xCoreData[i].slotsWritten;
+		if (xCoreData[i].pxLog->bufferIsFull)
+		{
+			pxCursor->uiEventPosition[i] = prvTraceExportRetreat(uiWritten, (TRC_CFG_EVENT_BUFFER_SIZE) - TRC_EXPORT_EVENT_MARGIN);
+		}
+		else
+		{
+			pxCursor->uiEventPosition[i] = 0;
+		}
+	}
+
+	/* The object property table is not part of the first records, so every
+	block is sent as changed */
+	for (i = 0; i < TRC_EXPORT_OBJECT_BLOCKS; i++)
+	{
+		pxCursor->uiObjectBlockVersion[i] = (uint16_t)(objectBlockVersion[i] - 1);
+	}
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceSnapshotExport(TraceSnapshotExportCursor_t* pxCursor, void* pvBuffer, uint32_t uiBufferSize, uint32_t* puiBytesWritten)
+{
+	TraceSnapshotExportOutput_t xOut;
+	uint32_t uiCore;
+
+	TRACE_ASSERT(pxCursor != (void*)0, "xTraceSnapshotExport: pxCursor == NULL", TRC_FAIL);
+	TRACE_ASSERT(pvBuffer != (void*)0, "xTraceSnapshotExport: pvBuffer == NULL", TRC_FAIL);
+	TRACE_ASSERT(uiBufferSize >= 128, "xTraceSnapshotExport: uiBufferSize < 128", TRC_FAIL);
+	TRACE_ASSERT(puiBytesWritten != (void*)0, "xTraceSnapshotExport: puiBytesWritten == NULL", TRC_FAIL);
+
+	if (RecorderDataPtr == (void*)0)
+	{
+		return TRC_FAIL;
+	}
+
+	xOut.pucBuffer = (uint8_t*)pvBuffer;
+	xOut.uiSize = uiBufferSize;
+	xOut.uiUsed = 0;
+
+	prvTraceExportStatic(pxCursor, &xOut);
+
+	if (pxCursor->uiStaticOffset == sizeof(RecorderDataType))
+	{
+		prvTraceExportObjects(pxCursor, &xOut);
+		prvTraceExportSymbols(pxCursor, &xOut);
+		for (uiCore = 0; uiCore < (TRC_SNAPSHOT_CORE_COUNT); uiCore++)
+		{
+			prvTraceExportEvents(pxCursor, &xOut, uiCore);
+		}
+#if ((TRC_CFG_INCLUDE_USER_EVENTS == 1) && (TRC_CFG_USE_SEPARATE_USER_EVENT_BUFFER == 1))
+		prvTraceExportUserEventBuffer(pxCursor, &xOut);
+#endif
+		prvTraceExportError(pxCursor, &xOut);
+	}
+
+	*puiBytesWritten = xOut.uiUsed;
+
+	return TRC_SUCCESS;
+}
+
+#endif /* (TRC_CFG_INCLUDE_SNAPSHOT_EXPORT == 1) */
+
 /*******************************************************************************
 * prvTraceInitTimestamps
 *
@@ -550,8 +1331,8 @@ static void prvTraceTaskInstanceFinish(int8_t direct)
 
 	TRACE_ALLOC_CRITICAL_SECTION();
 
-	trcCRITICAL_SECTION_BEGIN();
-	if (RecorderDataPtr->recorderActive && handle_of_last_logged_task)
+	trcCORE_CRITICAL_SECTION_BEGIN();
+	if (RecorderDataPtr->recorderActive && xCoreData[TRC_SNAPSHOT_GET_CURRENT_CORE()].handle_of_last_logged_task)
 	{
 		dts45 = (uint8_t)prvTraceGetDTS(0xFF);
 		tis = (TaskInstanceStatusEvent*) prvTraceNextFreeEventBufferSlot();
@@ -566,7 +1347,7 @@ static void prvTraceTaskInstanceFinish(int8_t direct)
 			prvTraceUpdateCounters();
 		}
 	}
-	trcCRITICAL_SECTION_END();
+	trcCORE_CRITICAL_SECTION_END();
 }
 
 /******************************************************************************
@@ -664,9 +1445,10 @@ traceResult xTraceISRRegister(const char* szName, uint32_t uiPriority, TraceISRH
 
 traceResult xTraceISRBegin(TraceISRHandle_t handle)
 {
+	TraceSnapshotCoreData_t* pxCoreData = &xCoreData[TRC_SNAPSHOT_GET_CURRENT_CORE()];
 	TRACE_ALLOC_CRITICAL_SECTION();
 
-	if (recorder_busy)
+	if (recorder_busy[TRC_SNAPSHOT_GET_CURRENT_CORE()])
 	{
 		/*************************************************************************
 		* This occurs if an ISR calls a trace function, preempting a previous
@@ -682,9 +1464,9 @@ traceResult xTraceISRBegin(TraceISRHandle_t handle)
 		return TRC_FAIL;
 	}
 
-	trcCRITICAL_SECTION_BEGIN();
+	trcCORE_CRITICAL_SECTION_BEGIN();
 	
-	if (RecorderDataPtr->recorderActive && handle_of_last_logged_task)
+	if (RecorderDataPtr->recorderActive && pxCoreData->handle_of_last_logged_task)
 	{
 		uint16_t dts4;
 		
@@ -695,12 +1477,12 @@ traceResult xTraceISRBegin(TraceISRHandle_t handle)
 
 		if (RecorderDataPtr->recorderActive) /* Need to repeat this check! */
 		{
-			if (nISRactive < TRC_CFG_MAX_ISR_NESTING)
+			if (pxCoreData->nISRactive < TRC_CFG_MAX_ISR_NESTING)
 			{
 				TSEvent* ts;
 				uint8_t hnd8 = prvTraceGet8BitHandle(handle);
-				isrstack[nISRactive] = handle;
-				nISRactive++;
+				pxCoreData->isrstack[pxCoreData->nISRactive] = handle;
+				pxCoreData->nISRactive++;
 				ts = (TSEvent*)prvTraceNextFreeEventBufferSlot();
 				if (ts != (void*)0)
 				{
@@ -718,7 +1500,7 @@ traceResult xTraceISRBegin(TraceISRHandle_t handle)
 		}
 	}
 
-	trcCRITICAL_SECTION_END();
+	trcCORE_CRITICAL_SECTION_END();
 
 	return TRC_SUCCESS;
 }
@@ -728,15 +1510,16 @@ traceResult xTraceISREnd(int pendingISR)
 	TSEvent* ts;
 	uint16_t dts5;
 	uint8_t hnd8 = 0, type = 0;
+	TraceSnapshotCoreData_t* pxCoreData = &xCoreData[TRC_SNAPSHOT_GET_CURRENT_CORE()];
 	
 	TRACE_ALLOC_CRITICAL_SECTION();
 
-	if (! RecorderDataPtr->recorderActive ||  ! handle_of_last_logged_task)
+	if (! RecorderDataPtr->recorderActive ||  ! pxCoreData->handle_of_last_logged_task)
 	{
 		return TRC_SUCCESS;
 	}
 
-	if (recorder_busy)
+	if (recorder_busy[TRC_SNAPSHOT_GET_CURRENT_CORE()])
 	{
 		/*************************************************************************
 		* This occurs if an ISR calls a trace function, preempting a previous
@@ -752,27 +1535,27 @@ traceResult xTraceISREnd(int pendingISR)
 		return TRC_FAIL;
 	}
 	
-	if (nISRactive == 0)
+	if (pxCoreData->nISRactive == 0)
 	{
 		prvTraceError("Unmatched call to vTraceStoreISREnd (nISRactive == 0, expected > 0)");
 		return TRC_FAIL;
 	}
 
-	trcCRITICAL_SECTION_BEGIN();
+	trcCORE_CRITICAL_SECTION_BEGIN();
 
-	isPendingContextSwitch |= pendingISR;	/* Is there a pending context switch right now? If so, we will not create an event since we will get an event when that context switch is executed. */
-	nISRactive--;
-	if (nISRactive > 0)
+	pxCoreData->isPendingContextSwitch |= pendingISR;	/* Is there a pending context switch right now? If so, we will not create an event since we will get an event when that context switch is executed. */
+	pxCoreData->nISRactive--;
+	if (pxCoreData->nISRactive > 0)
 	{
 		/* Return to another ISR */
 		type = TS_ISR_RESUME;
-		hnd8 = prvTraceGet8BitHandle(isrstack[nISRactive - 1]); /* isrstack[nISRactive] is the handle of the ISR we're currently exiting. isrstack[nISRactive - 1] is the handle of the ISR that was executing previously. */
+		hnd8 = prvTraceGet8BitHandle(pxCoreData->isrstack[pxCoreData->nISRactive - 1]); /* isrstack[nISRactive] is the handle of the ISR we're currently exiting. isrstack[nISRactive - 1] is the handle of the ISR that was executing previously. */
 	}
-	else if ((isPendingContextSwitch == 0) || (xTraceKernelPortIsSchedulerSuspended()))	
+	else if ((pxCoreData->isPendingContextSwitch == 0) || (xTraceKernelPortIsSchedulerSuspended()))	
 	{
 		/* Return to interrupted task, if no context switch will occur in between. */
 		type = TS_TASK_RESUME;
-		hnd8 = prvTraceGet8BitHandle(handle_of_last_logged_task);
+		hnd8 = prvTraceGet8BitHandle(pxCoreData->handle_of_last_logged_task);
 	}
 
 	if (type != 0)
@@ -788,7 +1571,7 @@ traceResult xTraceISREnd(int pendingISR)
 		}
 	}
 
-	trcCRITICAL_SECTION_END();
+	trcCORE_CRITICAL_SECTION_END();
 
 	return TRC_SUCCESS;
 }
@@ -798,14 +1581,18 @@ traceResult xTraceISREnd(int pendingISR)
 /* ISR tracing is turned off */
 void prvTraceIncreaseISRActive(void)
 {
-	if (RecorderDataPtr->recorderActive && handle_of_last_logged_task)
-		nISRactive++;
+	TraceSnapshotCoreData_t* pxCoreData = &xCoreData[TRC_SNAPSHOT_GET_CURRENT_CORE()];
+
+	if (RecorderDataPtr->recorderActive && pxCoreData->handle_of_last_logged_task)
+		pxCoreData->nISRactive++;
 }
 
 void prvTraceDecreaseISRActive(void)
 {
-	if (RecorderDataPtr->recorderActive && handle_of_last_logged_task)
-		nISRactive--;
+	TraceSnapshotCoreData_t* pxCoreData = &xCoreData[TRC_SNAPSHOT_GET_CURRENT_CORE()];
+
+	if (RecorderDataPtr->recorderActive && pxCoreData->handle_of_last_logged_task)
+		pxCoreData->nISRactive--;
 }
 #endif /* (TRC_CFG_INCLUDE_ISR_TRACING == 1)*/
 
@@ -1429,13 +2216,16 @@ traceResult xTraceVPrintF(TraceStringHandle_t eventLabel, const char* formatStr,
 	uint32_t noOfSlots;
 	UserEvent* ue1;
 	uint32_t tempDataBuffer[(3 + MAX_ARG_SIZE) / 4];
+	TraceSnapshotCoreData_t* pxCoreData;
 	TRACE_ALLOC_CRITICAL_SECTION();
 
 	TRACE_ASSERT(formatStr != (void*)0, "vTraceVPrintF: formatStr == NULL", TRC_FAIL);
 
-	trcCRITICAL_SECTION_BEGIN();
+	trcCORE_CRITICAL_SECTION_BEGIN();
+
+	pxCoreData = &xCoreData[TRC_SNAPSHOT_GET_CURRENT_CORE()];
 
-	if (RecorderDataPtr->recorderActive && handle_of_last_logged_task)
+	if (RecorderDataPtr->recorderActive && pxCoreData->handle_of_last_logged_task)
 	{
 		/* First, write the "primary" user event entry in the local buffer, but
 		let the event type be "EVENT_BEING_WRITTEN" for now...*/
@@ -1457,14 +2247,15 @@ traceResult xTraceVPrintF(TraceStringHandle_t eventLabel, const char* formatStr,
 
 			/* If the data does not fit in the remaining main buffer, wrap around to
 			0 if allowed, otherwise stop the recorder and quit). */
-			if (RecorderDataPtr->nextFreeIndex + noOfSlots > RecorderDataPtr->maxEvents)
+			if (pxCoreData->pxLog->nextFreeIndex + noOfSlots > pxCoreData->pxLog->maxEvents)
 			{
 				#if (TRC_CFG_SNAPSHOT_MODE == TRC_SNAPSHOT_MODE_RING_BUFFER)
-				(void)memset(& RecorderDataPtr->eventData[RecorderDataPtr->nextFreeIndex * 4],
+				(void)memset(& pxCoreData->eventData[pxCoreData->pxLog->nextFreeIndex * 4],
 						0,
-						(RecorderDataPtr->maxEvents - RecorderDataPtr->nextFreeIndex)*4);
-				RecorderDataPtr->nextFreeIndex = 0;
-				RecorderDataPtr->bufferIsFull = 1;
+						(pxCoreData->pxLog->maxEvents - pxCoreData->pxLog->nextFreeIndex)*4);
+				trcEXPORT_SLOTS_WRITTEN(pxCoreData, pxCoreData->pxLog->maxEvents - pxCoreData->pxLog->nextFreeIndex);
+				pxCoreData->pxLog->nextFreeIndex = 0;
+				pxCoreData->pxLog->bufferIsFull = 1;
 				#else
 
 				/* Stop recorder, since the event data will not fit in the
@@ -1484,28 +2275,29 @@ traceResult xTraceVPrintF(TraceStringHandle_t eventLabel, const char* formatStr,
 				prvCheckDataToBeOverwrittenForMultiEntryEvents((uint8_t)noOfSlots);
 				#endif
 				/* Copy the local buffer to the main buffer */
-				(void)memcpy(& RecorderDataPtr->eventData[RecorderDataPtr->nextFreeIndex * 4],
+				(void)memcpy(& pxCoreData->eventData[pxCoreData->pxLog->nextFreeIndex * 4],
 						tempDataBuffer,
 						noOfSlots * 4);
 
 				/* Update the event type, i.e., number of data entries following the
 				main USER_EVENT entry (Note: important that this is after the memcpy,
 				but within the critical section!)*/
-				RecorderDataPtr->eventData[RecorderDataPtr->nextFreeIndex * 4] =
+				pxCoreData->eventData[pxCoreData->pxLog->nextFreeIndex * 4] =
 				 (uint8_t) ( USER_EVENT + noOfSlots - 1 );
 
 				/* Update the main buffer event index (already checked that it fits in
 				the buffer, so no need to check for wrapping)*/
 
-				RecorderDataPtr->nextFreeIndex += noOfSlots;
-				RecorderDataPtr->numEvents += noOfSlots;
+				pxCoreData->pxLog->nextFreeIndex += noOfSlots;
+				pxCoreData->pxLog->numEvents += noOfSlots;
+				trcEXPORT_SLOTS_WRITTEN(pxCoreData, noOfSlots);
 
-				if (RecorderDataPtr->nextFreeIndex >= (TRC_CFG_EVENT_BUFFER_SIZE))
+				if (pxCoreData->pxLog->nextFreeIndex >= (TRC_CFG_EVENT_BUFFER_SIZE))
 				{
 					#if (TRC_CFG_SNAPSHOT_MODE == TRC_SNAPSHOT_MODE_RING_BUFFER)
 					/* We have reached the end, but this is a ring buffer. Start from the beginning again. */
-					RecorderDataPtr->bufferIsFull = 1;
-					RecorderDataPtr->nextFreeIndex = 0;
+					pxCoreData->pxLog->bufferIsFull = 1;
+					pxCoreData->pxLog->nextFreeIndex = 0;
 					#else
 					/* We have reached the end so we stop. */
 					vTraceStop();
@@ -1520,14 +2312,14 @@ traceResult xTraceVPrintF(TraceStringHandle_t eventLabel, const char* formatStr,
 
 		}
 	}
-	trcCRITICAL_SECTION_END();
+	trcCORE_CRITICAL_SECTION_END();
 
 #elif (TRC_CFG_USE_SEPARATE_USER_EVENT_BUFFER == 1)
 	/* Use the separate user event buffer */
 	TraceStringHandle_t formatLabel;
 	traceUBChannel channel;
 
-	if (RecorderDataPtr->recorderActive && handle_of_last_logged_task)
+	if (RecorderDataPtr->recorderActive && xCoreData[TRC_SNAPSHOT_GET_CURRENT_CORE()].handle_of_last_logged_task)
 	{
 		xTraceStringRegister(formatStr, &formatLabel);
 
@@ -1557,8 +2349,8 @@ traceResult xTracePrint(TraceStringHandle_t chn, const char* str)
 	uint8_t dts1;
 	TRACE_ALLOC_CRITICAL_SECTION();
 
-	trcCRITICAL_SECTION_BEGIN();
-	if (RecorderDataPtr->recorderActive && handle_of_last_logged_task)
+	trcCORE_CRITICAL_SECTION_BEGIN();
+	if (RecorderDataPtr->recorderActive && xCoreData[TRC_SNAPSHOT_GET_CURRENT_CORE()].handle_of_last_logged_task)
 	{
 		dts1 = (uint8_t)prvTraceGetDTS(0xFF);
 		ue = (UserEvent*) prvTraceNextFreeEventBufferSlot();
@@ -1570,13 +2362,13 @@ traceResult xTracePrint(TraceStringHandle_t chn, const char* str)
 			prvTraceUpdateCounters();
 		}
 	}
-	trcCRITICAL_SECTION_END();
+	trcCORE_CRITICAL_SECTION_END();
 
 #elif (TRC_CFG_USE_SEPARATE_USER_EVENT_BUFFER == 1)
 	traceUBChannel channel;
 	uint32_t noOfSlots = 1;
 	uint32_t tempDataBuffer[(3 + MAX_ARG_SIZE) / 4];
-	if (RecorderDataPtr->recorderActive && handle_of_last_logged_task)
+	if (RecorderDataPtr->recorderActive && xCoreData[TRC_SNAPSHOT_GET_CURRENT_CORE()].handle_of_last_logged_task)
 	{
 		TraceStringHandle_t trcStr = prvTraceOpenSymbol(str, chn);
 		channel = xTraceRegisterUBChannel(chn, trcStr);
@@ -1633,6 +2425,9 @@ traceResult xTraceInitialize(void)
 #if defined(TRC_CFG_ENABLE_STACK_MONITOR) && (TRC_CFG_ENABLE_STACK_MONITOR == 1) && (TRC_CFG_SCHEDULING_ONLY == 0)
 	uint32_t i;
 #endif /* defined(TRC_CFG_ENABLE_STACK_MONITOR) && (TRC_CFG_ENABLE_STACK_MONITOR == 1) && (TRC_CFG_SCHEDULING_ONLY == 0) */
+#if (TRC_SNAPSHOT_CORE_COUNT > 1)
+	uint32_t core;
+#endif /* (TRC_SNAPSHOT_CORE_COUNT > 1) */
 
 	if (RecorderInitialized != 0)
 	{
@@ -1699,6 +2494,9 @@ traceResult xTraceInitialize(void)
 	RecorderDataPtr->debugMarker1 = (int32_t)0xF1F1F1F1;
 	RecorderDataPtr->SymbolTable.symTableSize = (TRC_CFG_SYMBOL_TABLE_SIZE);
 	RecorderDataPtr->SymbolTable.nextFreeSymbolIndex = 1;
+#if ((TRC_CFG_SYMBOL_TABLE_HASH_BITS) != 6) || ((TRC_SNAPSHOT_CORE_COUNT) > 1)
+	RecorderDataPtr->SymbolTable.hashBits = (TRC_CFG_SYMBOL_TABLE_HASH_BITS);
+#endif
 #if (TRC_CFG_INCLUDE_FLOAT_SUPPORT == 1)
 	RecorderDataPtr->exampleFloatEncoding = 1.0f; /* otherwise already zero */
 #endif
@@ -1725,6 +2523,23 @@ traceResult xTraceInitialize(void)
 	RecorderDataPtr->userEventBuffer.numberOfChannels = (TRC_CFG_UB_CHANNELS)+1;
 #endif
 
+	/* Core 0 logs to the main event buffer, the other cores to their own secondary blocks */
+	xCoreData[0].pxLog = (EventLogCounters*)&RecorderDataPtr->numEvents;
+	xCoreData[0].eventData = RecorderDataPtr->eventData;
+#if (TRC_SNAPSHOT_CORE_COUNT > 1)
+	for (core = 1; core < (TRC_SNAPSHOT_CORE_COUNT); core++)
+	{
+		CoreEventBuffer* pxCoreBuffer = &RecorderDataPtr->coreEventBuffers[core - 1];
+
+		pxCoreBuffer->bufferID = 2;
+		pxCoreBuffer->version = 0;
+		pxCoreBuffer->coreID = core;
+		pxCoreBuffer->counters.maxEvents = (TRC_CFG_EVENT_BUFFER_SIZE);
+		xCoreData[core].pxLog = &pxCoreBuffer->counters;
+		xCoreData[core].eventData = pxCoreBuffer->eventData;
+	}
+#endif /* (TRC_SNAPSHOT_CORE_COUNT > 1) */
+
 	/* Kernel specific initialization of the objectHandleStacks variable */
 	xTraceKernelPortInitObjectHandleStack();
 
@@ -1809,7 +2624,7 @@ void prvTraceStoreTaskReady(traceHandle handle)
 
 	TRACE_ASSERT(handle <= (TRC_CFG_NTASK), "prvTraceStoreTaskReady: Invalid value for handle", TRC_UNUSED);
 
-	if (recorder_busy)
+	if (recorder_busy[TRC_SNAPSHOT_GET_CURRENT_CORE()])
 	{
 		/*************************************************************************
 		* This occurs if an ISR calls a trace function, preempting a previous
@@ -1825,7 +2640,7 @@ void prvTraceStoreTaskReady(traceHandle handle)
 		return;
 	}
 
-	trcCRITICAL_SECTION_BEGIN();
+	trcCORE_CRITICAL_SECTION_BEGIN();
 	if (RecorderDataPtr->recorderActive) /* Need to repeat this check! */
 	{
 		dts3 = (uint16_t)prvTraceGetDTS(0xFFFF);
@@ -1839,7 +2654,7 @@ void prvTraceStoreTaskReady(traceHandle handle)
 			prvTraceUpdateCounters();
 		}
 	}
-	trcCRITICAL_SECTION_END();
+	trcCORE_CRITICAL_SECTION_END();
 }
 #endif
 
@@ -1856,7 +2671,7 @@ void prvTraceStoreLowPower(uint32_t flag)
 
 	TRACE_ASSERT(flag <= 1, "prvTraceStoreLowPower: Invalid flag value", TRC_UNUSED);
 
-	if (recorder_busy)
+	if (recorder_busy[TRC_SNAPSHOT_GET_CURRENT_CORE()])
 	{
 		/*************************************************************************
 		* This occurs if an ISR calls a trace function, preempting a previous
@@ -1872,7 +2687,7 @@ void prvTraceStoreLowPower(uint32_t flag)
 		return;
 	}
 
-	trcCRITICAL_SECTION_BEGIN();
+	trcCORE_CRITICAL_SECTION_BEGIN();
 	if (RecorderDataPtr->recorderActive)
 	{
 		dts = (uint16_t)prvTraceGetDTS(0xFFFF);
@@ -1884,7 +2699,7 @@ void prvTraceStoreLowPower(uint32_t flag)
 			prvTraceUpdateCounters();
 		}
 	}
-	trcCRITICAL_SECTION_END();
+	trcCORE_CRITICAL_SECTION_END();
 }
 
 /*******************************************************************************
@@ -1997,7 +2812,7 @@ void prvTraceStoreKernelCall(uint32_t ecode, traceObjectClass objectClass, uint3
 	TRACE_ASSERT(objectClass < TRACE_NCLASSES, "prvTraceStoreKernelCall: objectClass >= TRACE_NCLASSES", TRC_UNUSED);
 	TRACE_ASSERT(objectNumber <= RecorderDataPtr->ObjectPropertyTable.NumberOfObjectsPerClass[objectClass], "prvTraceStoreKernelCall: Invalid value for objectNumber", TRC_UNUSED);
 
-	if (recorder_busy)
+	if (recorder_busy[TRC_SNAPSHOT_GET_CURRENT_CORE()])
 	{
 		/*************************************************************************
 		* This occurs if an ISR calls a trace function, preempting a previous
@@ -2013,12 +2828,12 @@ void prvTraceStoreKernelCall(uint32_t ecode, traceObjectClass objectClass, uint3
 		return;
 	}
 
-	if (handle_of_last_logged_task == 0)
+	if (xCoreData[TRC_SNAPSHOT_GET_CURRENT_CORE()].handle_of_last_logged_task == 0)
 	{
 		return;
 	}
 
-	trcCRITICAL_SECTION_BEGIN();
+	trcCORE_CRITICAL_SECTION_BEGIN();
 	if (RecorderDataPtr->recorderActive)
 	{
 		dts1 = (uint16_t)prvTraceGetDTS(0xFFFF);
@@ -2032,7 +2847,7 @@ void prvTraceStoreKernelCall(uint32_t ecode, traceObjectClass objectClass, uint3
 			prvTraceUpdateCounters();
 		}
 	}
-	trcCRITICAL_SECTION_END();
+	trcCORE_CRITICAL_SECTION_END();
 }
 #endif /* TRC_CFG_SCHEDULING_ONLY */
 
@@ -2062,7 +2877,7 @@ void prvTraceStoreKernelCallWithParam(uint32_t evtcode,
 	TRACE_ASSERT(objectClass < TRACE_NCLASSES, "prvTraceStoreKernelCallWithParam: objectClass >= TRACE_NCLASSES", TRC_UNUSED);
 	TRACE_ASSERT(objectNumber <= RecorderDataPtr->ObjectPropertyTable.NumberOfObjectsPerClass[objectClass], "prvTraceStoreKernelCallWithParam: Invalid value for objectNumber", TRC_UNUSED);
 
-	if (recorder_busy)
+	if (recorder_busy[TRC_SNAPSHOT_GET_CURRENT_CORE()])
 	{
 		/*************************************************************************
 		* This occurs if an ISR calls a trace function, preempting a previous
@@ -2078,8 +2893,8 @@ void prvTraceStoreKernelCallWithParam(uint32_t evtcode,
 		return;
 	}
 
-	trcCRITICAL_SECTION_BEGIN();
-	if (RecorderDataPtr->recorderActive && handle_of_last_logged_task)
+	trcCORE_CRITICAL_SECTION_BEGIN();
+	if (RecorderDataPtr->recorderActive && xCoreData[TRC_SNAPSHOT_GET_CURRENT_CORE()].handle_of_last_logged_task)
 	{
 		dts2 = (uint8_t)prvTraceGetDTS(0xFF);
 		p8 = (uint8_t) prvTraceGetParam(0xFF, param);
@@ -2094,7 +2909,7 @@ void prvTraceStoreKernelCallWithParam(uint32_t evtcode,
 			prvTraceUpdateCounters();
 		}
 	}
-	trcCRITICAL_SECTION_END();
+	trcCORE_CRITICAL_SECTION_END();
 }
 #endif /* TRC_CFG_SCHEDULING_ONLY */
 
@@ -2152,7 +2967,7 @@ void prvTraceStoreKernelCallWithNumericParamOnly(uint32_t evtcode, uint32_t para
 
 	TRACE_ASSERT(evtcode < 0xFF, "prvTraceStoreKernelCallWithNumericParamOnly: Invalid value for evtcode", TRC_UNUSED);
 
-	if (recorder_busy)
+	if (recorder_busy[TRC_SNAPSHOT_GET_CURRENT_CORE()])
 	{
 		/*************************************************************************
 		* This occurs if an ISR calls a trace function, preempting a previous
@@ -2168,8 +2983,8 @@ void prvTraceStoreKernelCallWithNumericParamOnly(uint32_t evtcode, uint32_t para
 		return;
 	}
 
-	trcCRITICAL_SECTION_BEGIN();
-	if (RecorderDataPtr->recorderActive && handle_of_last_logged_task)
+	trcCORE_CRITICAL_SECTION_BEGIN();
+	if (RecorderDataPtr->recorderActive && xCoreData[TRC_SNAPSHOT_GET_CURRENT_CORE()].handle_of_last_logged_task)
 	{
 		dts6 = (uint8_t)prvTraceGetDTS(0xFF);
 		restParam = (uint16_t)prvTraceGetParam(0xFFFF, param);
@@ -2182,7 +2997,7 @@ void prvTraceStoreKernelCallWithNumericParamOnly(uint32_t evtcode, uint32_t para
 			prvTraceUpdateCounters();
 		}
 	}
-	trcCRITICAL_SECTION_END();
+	trcCORE_CRITICAL_SECTION_END();
 }
 #endif /* TRC_CFG_SCHEDULING_ONLY */
 
@@ -2196,9 +3011,7 @@ void prvTraceStoreTaskswitch(traceHandle task_handle)
 	uint16_t dts3;
 	TSEvent* ts;
 	uint8_t hnd8;
-#if (TRC_CFG_INCLUDE_ISR_TRACING == 1)
-	extern int32_t isPendingContextSwitch;
-#endif
+	TraceSnapshotCoreData_t* pxCoreData;
 	trcSR_ALLOC_CRITICAL_SECTION_ON_CORTEX_M_ONLY();
 
 	TRACE_ASSERT(task_handle <= (TRC_CFG_NTASK),
@@ -2206,21 +3019,23 @@ void prvTraceStoreTaskswitch(traceHandle task_handle)
 
 	trcCRITICAL_SECTION_BEGIN_ON_CORTEX_M_ONLY();
 
-	if ((task_handle != handle_of_last_logged_task) && (RecorderDataPtr->recorderActive))
+	pxCoreData = &xCoreData[TRC_SNAPSHOT_GET_CURRENT_CORE()];
+
+	if ((task_handle != pxCoreData->handle_of_last_logged_task) && (RecorderDataPtr->recorderActive))
 	{
 #if (TRC_CFG_INCLUDE_ISR_TRACING == 1)
-		isPendingContextSwitch = 0;
+		pxCoreData->isPendingContextSwitch = 0;
 #endif
 
 		dts3 = (uint16_t)prvTraceGetDTS(0xFFFF);
-		handle_of_last_logged_task = task_handle;
-		hnd8 = prvTraceGet8BitHandle(handle_of_last_logged_task);
+		pxCoreData->handle_of_last_logged_task = task_handle;
+		hnd8 = prvTraceGet8BitHandle(task_handle);
 		ts = (TSEvent*)prvTraceNextFreeEventBufferSlot();
 
 		if (ts != (void*)0)
 		{
 			if (prvTraceGetObjectState(TRACE_CLASS_TASK,
-				handle_of_last_logged_task) == TASK_STATE_INSTANCE_ACTIVE)
+				task_handle) == TASK_STATE_INSTANCE_ACTIVE)
 			{
 				ts->type = TS_TASK_RESUME;
 			}
@@ -2233,7 +3048,7 @@ void prvTraceStoreTaskswitch(traceHandle task_handle)
 			ts->objHandle = hnd8;
 
 			prvTraceSetObjectState(TRACE_CLASS_TASK,
-									handle_of_last_logged_task,
+									task_handle,
 									TASK_STATE_INSTANCE_ACTIVE);
 
 			prvTraceUpdateCounters();
@@ -2318,7 +3133,10 @@ void prvTraceSetPriorityProperty(uint8_t objectclass, traceHandle id, uint8_t va
 	TRACE_ASSERT(id <= RecorderDataPtr->ObjectPropertyTable.NumberOfObjectsPerClass[objectclass],
 		"prvTraceSetPriorityProperty: Invalid value for id", TRC_UNUSED);
 
+	trcSHARED_SECTION_BEGIN();
 	TRACE_PROPERTY_ACTOR_PRIORITY(objectclass, id) = value;
+	trcEXPORT_OBJECT_CHANGED(uiIndexOfObject(id, objectclass), RecorderDataPtr->ObjectPropertyTable.TotalPropertyBytesPerClass[objectclass]);
+	trcSHARED_SECTION_END();
 }
 
 uint8_t prvTraceGetPriorityProperty(uint8_t objectclass, traceHandle id)
@@ -2338,7 +3156,10 @@ void prvTraceSetObjectState(uint8_t objectclass, traceHandle id, uint8_t value)
 	TRACE_ASSERT(id <= RecorderDataPtr->ObjectPropertyTable.NumberOfObjectsPerClass[objectclass],
 		"prvTraceSetObjectState: Invalid value for id", TRC_UNUSED);
 
+	trcSHARED_SECTION_BEGIN();
 	TRACE_PROPERTY_OBJECT_STATE(objectclass, id) = value;
+	trcEXPORT_OBJECT_CHANGED(uiIndexOfObject(id, objectclass), RecorderDataPtr->ObjectPropertyTable.TotalPropertyBytesPerClass[objectclass]);
+	trcSHARED_SECTION_END();
 }
 
 uint8_t prvTraceGetObjectState(uint8_t objectclass, traceHandle id)
@@ -2360,12 +3181,17 @@ void prvTraceSetTaskInstanceFinished(traceHandle handle)
 		"prvTraceSetTaskInstanceFinished: Invalid value for handle", TRC_UNUSED);
 
 #if (TRC_CFG_USE_IMPLICIT_IFE_RULES == 1)
+	trcSHARED_SECTION_BEGIN();
 	TRACE_PROPERTY_OBJECT_STATE(TRACE_CLASS_TASK, handle) = 0;
+	trcEXPORT_OBJECT_CHANGED(uiIndexOfObject(handle, TRACE_CLASS_TASK), RecorderDataPtr->ObjectPropertyTable.TotalPropertyBytesPerClass[TRACE_CLASS_TASK]);
+	trcSHARED_SECTION_END();
 #endif
 }
 
 void* prvTraceNextFreeEventBufferSlot(void)
 {
+	TraceSnapshotCoreData_t* pxCoreData;
+
 	if (! RecorderDataPtr->recorderActive)
 	{
 		/* If an XTS or XPS event prior to the main event has filled the buffer
@@ -2373,12 +3199,19 @@ void* prvTraceNextFreeEventBufferSlot(void)
 		return (void*)0;
 	}
 
-	if (RecorderDataPtr->nextFreeIndex >= (TRC_CFG_EVENT_BUFFER_SIZE))
+	pxCoreData = &xCoreData[TRC_SNAPSHOT_GET_CURRENT_CORE()];
+
+	if (pxCoreData->clearPending != 0)
+	{
+		prvTraceClearCoreEventBuffer(pxCoreData);
+	}
+
+	if (pxCoreData->pxLog->nextFreeIndex >= (TRC_CFG_EVENT_BUFFER_SIZE))
 	{
 		prvTraceError("Attempt to index outside event buffer!");
 		return (void*)0;
 	}
-	return (void*)(&RecorderDataPtr->eventData[RecorderDataPtr->nextFreeIndex*4]);
+	return (void*)(&pxCoreData->eventData[pxCoreData->pxLog->nextFreeIndex*4]);
 }
 
 uint16_t uiIndexOfObject(traceHandle objecthandle, uint8_t objectclass)
@@ -2488,7 +3321,11 @@ void prvTraceFreeObjectHandle(traceObjectClass objectclass, traceHandle handle)
 void prvMarkObjectAsUsed(traceObjectClass objectclass, traceHandle handle)
 {
 	uint16_t idx = uiIndexOfObject(handle, objectclass);
+
+	trcSHARED_SECTION_BEGIN();
 	RecorderDataPtr->ObjectPropertyTable.objbytes[idx] = 1;
+	trcEXPORT_OBJECT_CHANGED(idx, 1);
+	trcSHARED_SECTION_END();
 }
 
 /*******************************************************************************
@@ -2517,7 +3354,7 @@ void prvTraceSetObjectName(traceObjectClass objectclass,
 						 traceHandle handle,
 						 const char* name)
 {
-	static uint16_t idx;
+	uint16_t idx;
 
 	if (name == (void*)0)
 	{
@@ -2547,9 +3384,12 @@ void prvTraceSetObjectName(traceObjectClass objectclass,
 
 		if (traceErrorMessage == (void*)0)
 		{
+			trcSHARED_SECTION_BEGIN();
 			prvStrncpy((char*)&(RecorderDataPtr->ObjectPropertyTable.objbytes[idx]),
 				name,
 				RecorderDataPtr->ObjectPropertyTable.NameLengthPerClass[ objectclass ]);
+			trcEXPORT_OBJECT_CHANGED(idx, RecorderDataPtr->ObjectPropertyTable.NameLengthPerClass[ objectclass ]);
+			trcSHARED_SECTION_END();
 		}
 	}
 }
@@ -2558,7 +3398,7 @@ TraceStringHandle_t prvTraceOpenSymbol(const char* name, TraceStringHandle_t use
 {
 	uint16_t result;
 	uint8_t len;
-	uint8_t crc;
+	uint16_t crc;
 	TRACE_ALLOC_CRITICAL_SECTION();
 	
 	len = 0;
@@ -2623,6 +3463,7 @@ void prvTraceError(const char* msg)
 	}
 
 	/* If first error only... */
+	trcSHARED_SECTION_BEGIN();
 	if (traceErrorMessage == (void*)0)
 	{
 		traceErrorMessage = (char*)(intptr_t) msg;
@@ -2632,6 +3473,7 @@ void prvTraceError(const char* msg)
 			RecorderDataPtr->internalErrorOccured = 1;
 		}
 	}
+	trcSHARED_SECTION_END();
 }
 
 void vTraceSetFilterMask(uint16_t filterMask)
@@ -2665,35 +3507,39 @@ void prvCheckDataToBeOverwrittenForMultiEntryEvents(uint8_t nofEntriesToCheck)
 	/* Generic "int" type is desired - should be 16 bit variable on 16 bit HW */
 	unsigned int i = 0;
 	unsigned int e = 0;
+	TraceSnapshotCoreData_t* pxCoreData = &xCoreData[TRC_SNAPSHOT_GET_CURRENT_CORE()];
+	uint8_t* eventData = pxCoreData->eventData;
 
 	TRACE_ASSERT(nofEntriesToCheck != 0, 
 		"prvCheckDataToBeOverwrittenForMultiEntryEvents: nofEntriesToCheck == 0", TRC_UNUSED);
 
 	while (i < nofEntriesToCheck)
 	{
-		e = RecorderDataPtr->nextFreeIndex + i;
-		if ((RecorderDataPtr->eventData[e*4] > USER_EVENT) &&
-			(RecorderDataPtr->eventData[e*4] < USER_EVENT + 16))
+		e = pxCoreData->pxLog->nextFreeIndex + i;
+		if ((eventData[e*4] > USER_EVENT) &&
+			(eventData[e*4] < USER_EVENT + 16))
 		{
-			uint8_t nDataEvents = (uint8_t)(RecorderDataPtr->eventData[e*4] - USER_EVENT);
-			if ((e + nDataEvents) < RecorderDataPtr->maxEvents)
+			uint8_t nDataEvents = (uint8_t)(eventData[e*4] - USER_EVENT);
+			if ((e + nDataEvents) < pxCoreData->pxLog->maxEvents)
 			{
-				(void)memset(& RecorderDataPtr->eventData[e*4], 0, (size_t) (4 + 4 * nDataEvents));
+				(void)memset(& eventData[e*4], 0, (size_t) (4 + 4 * nDataEvents));
+				trcEXPORT_SLOTS_CLEARED(pxCoreData, i + 1 + nDataEvents);
 			}
 		}
-		else if (RecorderDataPtr->eventData[e*4] == DIV_XPS)
+		else if (eventData[e*4] == DIV_XPS)
 		{
-			if ((e + 1) < RecorderDataPtr->maxEvents)
+			if ((e + 1) < pxCoreData->pxLog->maxEvents)
 			{
 				/* Clear 8 bytes */
-				(void)memset(& RecorderDataPtr->eventData[e*4], 0, 4 + 4);
+				(void)memset(& eventData[e*4], 0, 4 + 4);
 			}
 			else
 			{
 				/* Clear 8 bytes, 4 first and 4 last */
-				(void)memset(& RecorderDataPtr->eventData[0], 0, 4);
-				(void)memset(& RecorderDataPtr->eventData[e*4], 0, 4);
+				(void)memset(& eventData[0], 0, 4);
+				(void)memset(& eventData[e*4], 0, 4);
 			}
+			trcEXPORT_SLOTS_CLEARED(pxCoreData, i + 2);
 		}
 		i++;
 	}
@@ -2707,20 +3553,26 @@ void prvCheckDataToBeOverwrittenForMultiEntryEvents(uint8_t nofEntriesToCheck)
  ******************************************************************************/
 void prvTraceUpdateCounters(void)
 {	
+	EventLogCounters* pxLog;
+
 	if (RecorderDataPtr->recorderActive == 0)
 	{
 		return;
 	}
 	
-	RecorderDataPtr->numEvents++;
+	pxLog = xCoreData[TRC_SNAPSHOT_GET_CURRENT_CORE()].pxLog;
 
-	RecorderDataPtr->nextFreeIndex++;
+	pxLog->numEvents++;
 
-	if (RecorderDataPtr->nextFreeIndex >= (TRC_CFG_EVENT_BUFFER_SIZE))
+	pxLog->nextFreeIndex++;
+
+	trcEXPORT_SLOTS_WRITTEN(&xCoreData[TRC_SNAPSHOT_GET_CURRENT_CORE()], 1);
+
+	if (pxLog->nextFreeIndex >= (TRC_CFG_EVENT_BUFFER_SIZE))
 	{
 #if (TRC_CFG_SNAPSHOT_MODE == TRC_SNAPSHOT_MODE_RING_BUFFER)
-		RecorderDataPtr->bufferIsFull = 1;
-		RecorderDataPtr->nextFreeIndex = 0;
+		pxLog->bufferIsFull = 1;
+		pxLog->nextFreeIndex = 0;
 #else
 		vTraceStop();
 #endif
@@ -2731,6 +3583,42 @@ void prvTraceUpdateCounters(void)
 #endif
 }
 
+/******************************************************************************
+ * prvTraceAddAbsTime
+ *
+ * Adds a differential timestamp to the absolute time of an event buffer,
+ * i.e., to absTimeLastEvent and absTimeLastEventSecond. The frequency must
+ * be non-zero and reciprocal must be TRC_RECIPROCAL of it.
+ *****************************************************************************/
+void prvTraceAddAbsTime(EventLogCounters* pxLog, uint32_t reciprocal, uint32_t dts)
+{
+	uint32_t seconds;
+	uint32_t remainder;
+
+	/* Check if dts > 1 second */
+	if (dts > pxLog->frequency)
+	{
+		/* More than 1 second has passed */
+		TRC_DIVMOD_RECIPROCAL(dts, pxLog->frequency, reciprocal, seconds, remainder);
+		pxLog->absTimeLastEventSecond += seconds;
+		/* The part that is not an entire second is added to absTimeLastEvent */
+		pxLog->absTimeLastEvent += remainder;
+	}
+	else
+	{
+		pxLog->absTimeLastEvent += dts;
+	}
+
+	/* Check if absTimeLastEvent >= 1 second */
+	if (pxLog->absTimeLastEvent >= pxLog->frequency)
+	{
+		/* absTimeLastEvent is more than or equal to 1 second, but always less than 2 seconds */
+		pxLog->absTimeLastEventSecond++;
+		pxLog->absTimeLastEvent -= pxLog->frequency;
+		/* absTimeLastEvent is now less than 1 second */
+	}
+}
+
 /******************************************************************************
  * prvTraceGetDTS
  *
@@ -2743,20 +3631,26 @@ void prvTraceUpdateCounters(void)
  *****************************************************************************/
 uint16_t prvTraceGetDTS(uint16_t param_maxDTS)
 {
-	static uint32_t old_timestamp = 0;
+	TraceSnapshotCoreData_t* pxCoreData = &xCoreData[TRC_SNAPSHOT_GET_CURRENT_CORE()];
+	EventLogCounters* pxLog = pxCoreData->pxLog;
 	XTSEvent* xts = 0;
 	uint32_t dts = 0;
 	uint32_t timestamp = 0;
 
 	TRACE_ASSERT(param_maxDTS == 0xFF || param_maxDTS == 0xFFFF, "prvTraceGetDTS: Invalid value for param_maxDTS", 0);
 
+	if (pxCoreData->clearPending != 0)
+	{
+		prvTraceClearCoreEventBuffer(pxCoreData);
+	}
+
 	
-	if (RecorderDataPtr->frequency == 0)
+	if (pxLog->frequency == 0)
 	{	
 		if (timestampFrequency != 0)
 		{
 			/* If to override default TRC_HWTC_FREQ_HZ value with value set by vTraceSetFrequency */
-			RecorderDataPtr->frequency = timestampFrequency / (TRC_HWTC_DIVISOR);
+			pxLog->frequency = timestampFrequency / (TRC_HWTC_DIVISOR);
 		} 
 		else if (init_hwtc_count != (TRC_HWTC_COUNT))
 		{
@@ -2765,15 +3659,21 @@ uint16_t prvTraceGetDTS(uint16_t param_maxDTS)
 			if the timer has actually not been configured yet, override this 
 			with vTraceSetFrequency.
 			*/
-			RecorderDataPtr->frequency = (TRC_HWTC_FREQ_HZ) / (TRC_HWTC_DIVISOR);		
+			pxLog->frequency = (TRC_HWTC_FREQ_HZ) / (TRC_HWTC_DIVISOR);		
 		}
 		/* If no override (vTraceSetFrequency) and timer inactive -> no action */
+
+		if (pxLog->frequency != 0)
+		{
+			/* Normalize once, so that the per-event code below needs no division */
+			pxCoreData->frequencyReciprocal = TRC_RECIPROCAL(pxLog->frequency);
+		}
 	}
 	
 	/**************************************************************************
 	* The below statements read the timestamp from the timer port module.
-	* If necessary, whole seconds are extracted using division while the rest
-	* comes from the modulo operation.
+	* If necessary, whole seconds and the rest are extracted using the
+	* precomputed reciprocal of the frequency, see TRC_DIVMOD_RECIPROCAL.
 	**************************************************************************/
 	
 	prvTracePortGetTimeStamp(&timestamp);	
@@ -2782,37 +3682,17 @@ uint16_t prvTraceGetDTS(uint16_t param_maxDTS)
 	* Since dts is unsigned the result will be correct even if timestamp has
 	* wrapped around.
 	***************************************************************************/
-	dts = timestamp - old_timestamp;
-	old_timestamp = timestamp;
+	dts = timestamp - pxCoreData->old_timestamp;
+	pxCoreData->old_timestamp = timestamp;
 
-	if (RecorderDataPtr->frequency > 0)
+	if (pxLog->frequency > 0)
 	{
-		/* Check if dts > 1 second */
-		if (dts > RecorderDataPtr->frequency)
-		{
-			/* More than 1 second has passed */
-			RecorderDataPtr->absTimeLastEventSecond += dts / RecorderDataPtr->frequency;
-			/* The part that is not an entire second is added to absTimeLastEvent */
-			RecorderDataPtr->absTimeLastEvent += dts % RecorderDataPtr->frequency;
-		}
-		else
-		{
-			RecorderDataPtr->absTimeLastEvent += dts;
-		}
-
-		/* Check if absTimeLastEvent >= 1 second */
-		if (RecorderDataPtr->absTimeLastEvent >= RecorderDataPtr->frequency)
-		{
-			/* RecorderDataPtr->absTimeLastEvent is more than or equal to 1 second, but always less than 2 seconds */
-			RecorderDataPtr->absTimeLastEventSecond++;
-			RecorderDataPtr->absTimeLastEvent -= RecorderDataPtr->frequency;
-			/* RecorderDataPtr->absTimeLastEvent is now less than 1 second */
-		}
+		prvTraceAddAbsTime(pxLog, pxCoreData->frequencyReciprocal, dts);
 	}
 	else
 	{
 		/* Special case if the recorder has not yet started (frequency may be uninitialized, i.e., zero) */
-		RecorderDataPtr->absTimeLastEvent = timestamp;
+		pxLog->absTimeLastEvent = timestamp;
 	}
 
 	/* If the dts (time since last event) does not fit in event->dts (only 8 or 16 bits) */
@@ -2826,14 +3706,14 @@ uint16_t prvTraceGetDTS(uint16_t param_maxDTS)
 			if (param_maxDTS == 0xFFFF)
 			{
 				xts->type = (uint8_t)XTS16;
-				xts->xts_16 = (uint16_t)((dts / 0x10000) & 0xFFFF);
+				xts->xts_16 = (uint16_t)((dts >> 16) & 0xFFFF);
 				xts->xts_8 = 0;
 			}
 			else if (param_maxDTS == 0xFF)
 			{
 				xts->type = (uint8_t)XTS8;
-				xts->xts_16 = (uint16_t)((dts / 0x100) & 0xFFFF);
-				xts->xts_8 = (uint8_t)((dts / 0x1000000) & 0xFF);
+				xts->xts_16 = (uint16_t)((dts >> 8) & 0xFFFF);
+				xts->xts_8 = (uint8_t)((dts >> 24) & 0xFF);
 			}
 			else
 			{
@@ -2858,29 +3738,35 @@ uint16_t prvTraceGetDTS(uint16_t param_maxDTS)
  * format strings only (the handle of the destination channel).
  * byte 4..(4 + length): the string (object name or user event label), with
  * zero-termination
+ *
+ * All entries in a list share the same hash, so only the length, the first
+ * character and the channel are checked before the full string compare.
  ******************************************************************************/
 TraceStringHandle_t prvTraceLookupSymbolTableEntry(const char* name,
-										 uint8_t crc6,
+										 uint16_t hash,
 										 uint8_t len,
 										 TraceStringHandle_t chn)
 {
-	uint16_t i = RecorderDataPtr->SymbolTable.latestEntryOfChecksum[ crc6 ];
+	uint16_t i = RecorderDataPtr->SymbolTable.latestEntryOfChecksum[ hash ];
 
 	TRACE_ASSERT(name != (void*)0, "prvTraceLookupSymbolTableEntry: name == NULL", (TraceStringHandle_t)0);
 	TRACE_ASSERT(len != 0, "prvTraceLookupSymbolTableEntry: len == 0", (TraceStringHandle_t)0);
 
 	while (i != 0)
 	{
-		if (RecorderDataPtr->SymbolTable.symbytes[i + 2] == (chn & 0x00FF))
+		/* Length precheck, the zero-termination must be at the same offset.
+		 * The last entry may be shorter than len, so the offset is checked
+		 * against the table size before it is read. */
+		if ((((uint32_t)i + 4u + (uint32_t)len) < (uint32_t)sizeof(RecorderDataPtr->SymbolTable.symbytes)) &&
+			(RecorderDataPtr->SymbolTable.symbytes[i + 4 + len] == '\0') &&
+			(RecorderDataPtr->SymbolTable.symbytes[i + 4] == (uint8_t)name[0]))
 		{
-			if (RecorderDataPtr->SymbolTable.symbytes[i + 3] == (chn / 0x100))
+			if ((RecorderDataPtr->SymbolTable.symbytes[i + 2] == (chn & 0x00FF)) &&
+				(RecorderDataPtr->SymbolTable.symbytes[i + 3] == (chn / 0x100)))
 			{
-				if (RecorderDataPtr->SymbolTable.symbytes[i + 4 + len] == '\0')
+				if (strncmp((char*)(& RecorderDataPtr->SymbolTable.symbytes[i + 4]), name, len) == 0)
 				{
-					if (strncmp((char*)(& RecorderDataPtr->SymbolTable.symbytes[i + 4]), name, len) == 0)
-					{
-						break; /* found */
-					}
+					break; /* found */
 				}
 			}
 		}
@@ -2903,7 +3789,7 @@ TraceStringHandle_t prvTraceLookupSymbolTableEntry(const char* name,
  * zero-termination
  ******************************************************************************/
 TraceStringHandle_t prvTraceCreateSymbolTableEntry(const char* name,
-										uint8_t crc6,
+										uint16_t hash,
 										uint8_t len,
 										TraceStringHandle_t channel)
 {
@@ -2922,11 +3808,11 @@ TraceStringHandle_t prvTraceCreateSymbolTableEntry(const char* name,
 
 		RecorderDataPtr->SymbolTable.symbytes
 			[ RecorderDataPtr->SymbolTable.nextFreeSymbolIndex] =
-			(uint8_t)(RecorderDataPtr->SymbolTable.latestEntryOfChecksum[ crc6 ] & 0x00FF);
+			(uint8_t)(RecorderDataPtr->SymbolTable.latestEntryOfChecksum[ hash ] & 0x00FF);
 
 		RecorderDataPtr->SymbolTable.symbytes
 			[ RecorderDataPtr->SymbolTable.nextFreeSymbolIndex + 1] =
-			(uint8_t)(RecorderDataPtr->SymbolTable.latestEntryOfChecksum[ crc6 ] / 0x100);
+			(uint8_t)(RecorderDataPtr->SymbolTable.latestEntryOfChecksum[ hash ] / 0x100);
 
 		RecorderDataPtr->SymbolTable.symbytes
 			[ RecorderDataPtr->SymbolTable.nextFreeSymbolIndex + 2] =
@@ -2944,9 +3830,9 @@ TraceStringHandle_t prvTraceCreateSymbolTableEntry(const char* name,
 		RecorderDataPtr->SymbolTable.symbytes
 			[RecorderDataPtr->SymbolTable.nextFreeSymbolIndex + 4 + len] = '\0';
 
-		/* store index of entry (for return value, and as head of LL[crc6]) */
+		/* store index of entry (for return value, and as head of LL[hash]) */
 		RecorderDataPtr->SymbolTable.latestEntryOfChecksum
-			[ crc6 ] = (uint16_t)RecorderDataPtr->SymbolTable.nextFreeSymbolIndex;
+			[ hash ] = (uint16_t)RecorderDataPtr->SymbolTable.nextFreeSymbolIndex;
 
 		RecorderDataPtr->SymbolTable.nextFreeSymbolIndex += (uint32_t) (len + 5);
 
@@ -2960,14 +3846,16 @@ TraceStringHandle_t prvTraceCreateSymbolTableEntry(const char* name,
 /*******************************************************************************
  * prvTraceGetChecksum
  *
- * Calculates a simple 6-bit checksum from a string, used to index the string
- * for fast symbol table lookup.
+ * Calculates a TRC_CFG_SYMBOL_TABLE_HASH_BITS wide hash from a string, used to
+ * index the string for fast symbol table lookup. With 6 bits this is the
+ * original sum of characters. Wider hashes fold a multiplicative hash, since
+ * character sums of short names cluster in a small range.
  ******************************************************************************/
-void prvTraceGetChecksum(const char *pname, uint8_t* pcrc, uint8_t* plength)
+void prvTraceGetChecksum(const char *pname, uint16_t* pcrc, uint8_t* plength)
 {
 	unsigned char c;
 	int length = 1;		/* Should be 1 to account for '\0' */
-	int crc = 0;
+	uint32_t crc = 0;
 
 	TRACE_ASSERT(pname != (void*)0, "prvTraceGetChecksum: pname == NULL", TRC_UNUSED);
 	TRACE_ASSERT(pcrc != (void*)0, "prvTraceGetChecksum: pcrc == NULL", TRC_UNUSED);
@@ -2977,11 +3865,19 @@ void prvTraceGetChecksum(const char *pname, uint8_t* pcrc, uint8_t* plength)
 	{
 		for (; (c = (unsigned char) *pname++) != '\0';)
 		{
+#if ((TRC_CFG_SYMBOL_TABLE_HASH_BITS) == 6)
 			crc += c;
+#else
+			crc = (crc * 33) ^ c;
+#endif
 			length++;
 		}
 	}
-	*pcrc = (uint8_t)(crc & 0x3F);
+#if ((TRC_CFG_SYMBOL_TABLE_HASH_BITS) != 6)
+	crc ^= crc >> (TRC_CFG_SYMBOL_TABLE_HASH_BITS);
+	crc ^= crc >> (2 * (TRC_CFG_SYMBOL_TABLE_HASH_BITS));
+#endif
+	*pcrc = (uint16_t)(crc & (TRC_SYMBOL_TABLE_HASH_SIZE - 1));
 	*plength = (uint8_t)length;
 }
 
@@ -3102,16 +3998,14 @@ void xTraceHardwarePortInitCortexM(void)
  ******************************************************************************/
 void prvTracePortGetTimeStamp(uint32_t *pTimestamp)
 {
-	static uint32_t last_hwtc_count = 0;
+	TraceSnapshotCoreData_t* pxCoreData = &xCoreData[TRC_SNAPSHOT_GET_CURRENT_CORE()];
 	uint32_t hwtc_count = 0;
 
 #if TRC_HWTC_TYPE == TRC_OS_TIMER_INCR || TRC_HWTC_TYPE == TRC_OS_TIMER_DECR
 	/* systick based timer */
-	static uint32_t last_traceTickCount = 0;
 	uint32_t traceTickCount = 0;
 #else /*TRC_HWTC_TYPE == TRC_OS_TIMER_INCR || TRC_HWTC_TYPE == TRC_OS_TIMER_DECR*/
 	/* Free running timer */
-	static uint32_t last_hwtc_rest = 0;
 	uint32_t diff = 0;
 	uint32_t diff_scaled = 0;
 #endif /*TRC_HWTC_TYPE == TRC_OS_TIMER_INCR || TRC_HWTC_TYPE == TRC_OS_TIMER_DECR*/
@@ -3119,7 +4013,7 @@ void prvTracePortGetTimeStamp(uint32_t *pTimestamp)
 	if (trace_disable_timestamp == 1)
 	{
 		if (pTimestamp)
-			*pTimestamp = last_timestamp;
+			*pTimestamp = pxCoreData->last_timestamp;
 		return;
 	}
 
@@ -3141,20 +4035,20 @@ void prvTracePortGetTimeStamp(uint32_t *pTimestamp)
 	than the previous. In practice, this should "never" roll over since the
 	performance counter is 64 bit wide. */
 
-	if (last_hwtc_count > hwtc_count)
+	if (pxCoreData->last_hwtc_count > hwtc_count)
 	{
-		hwtc_count = last_hwtc_count;
+		hwtc_count = pxCoreData->last_hwtc_count;
 	}
 #endif
 
 #if (TRC_HWTC_TYPE == TRC_OS_TIMER_INCR || TRC_HWTC_TYPE == TRC_OS_TIMER_DECR)
 	/* Timestamping is based on a timer that wraps at TRC_HWTC_PERIOD */
-	if (last_traceTickCount - uiTraceTickCount - 1 < 0x80000000)
+	if (pxCoreData->last_traceTickCount - uiTraceTickCount - 1 < 0x80000000)
 	{
 		/* This means last_traceTickCount is higher than uiTraceTickCount,
 		so we have previously compensated for a missed tick.
 		Therefore we use the last stored value because that is more accurate. */
-		traceTickCount = last_traceTickCount;
+		traceTickCount = pxCoreData->last_traceTickCount;
 	}
 	else
 	{
@@ -3164,7 +4058,7 @@ void prvTracePortGetTimeStamp(uint32_t *pTimestamp)
 
 	/* Check for overflow. May occur if the update of uiTraceTickCount has been
 	delayed due to disabled interrupts. */
-	if (traceTickCount == last_traceTickCount && hwtc_count < last_hwtc_count)
+	if (traceTickCount == pxCoreData->last_traceTickCount && hwtc_count < pxCoreData->last_hwtc_count)
 	{
 		/* A trace tick has occurred but not been executed by the kernel, so we compensate manually. */
 		traceTickCount++;
@@ -3174,12 +4068,12 @@ void prvTracePortGetTimeStamp(uint32_t *pTimestamp)
 	if (pTimestamp)
 	{
 		/* Get timestamp from trace ticks. Scale down the period to avoid unwanted overflows. */
-		last_timestamp = traceTickCount * ((TRC_HWTC_PERIOD) / (TRC_HWTC_DIVISOR));
+		pxCoreData->last_timestamp = traceTickCount * ((TRC_HWTC_PERIOD) / (TRC_HWTC_DIVISOR));
 		/* Increase timestamp by (hwtc_count + "lost hardware ticks from scaling down period") / TRC_HWTC_DIVISOR. */
-		last_timestamp += (hwtc_count + traceTickCount * ((TRC_HWTC_PERIOD) % (TRC_HWTC_DIVISOR))) / (TRC_HWTC_DIVISOR);
+		pxCoreData->last_timestamp += (hwtc_count + traceTickCount * ((TRC_HWTC_PERIOD) % (TRC_HWTC_DIVISOR))) / (TRC_HWTC_DIVISOR);
 	}
 	/* Store the previous value */
-	last_traceTickCount = traceTickCount;
+	pxCoreData->last_traceTickCount = traceTickCount;
 	
 #else /*(TRC_HWTC_TYPE == TRC_OS_TIMER_INCR || TRC_HWTC_TYPE == TRC_OS_TIMER_DECR)*/
 	
@@ -3189,24 +4083,24 @@ void prvTracePortGetTimeStamp(uint32_t *pTimestamp)
 	The scaled timestamp returned from this function is supposed to go from 0 -> 2^32, which in real time would represent (0 -> 2^32 * TRC_HWTC_DIVISOR) ticks. */
 	
 	/* First we see how long time has passed since the last timestamp call, and we also add the ticks that was lost when we scaled down the last time. */
-	diff = (hwtc_count - last_hwtc_count) + last_hwtc_rest;
+	diff = (hwtc_count - pxCoreData->last_hwtc_count) + pxCoreData->last_hwtc_rest;
 	
 	/* Scale down the diff */
 	diff_scaled = diff / (TRC_HWTC_DIVISOR);
 	
 	/* Find out how many ticks were lost when scaling down, so we can add them the next time */
-	last_hwtc_rest = diff % (TRC_HWTC_DIVISOR);
+	pxCoreData->last_hwtc_rest = diff % (TRC_HWTC_DIVISOR);
 
 	/* We increase the scaled timestamp by the scaled amount */
-	last_timestamp += diff_scaled;
+	pxCoreData->last_timestamp += diff_scaled;
 #endif /*(TRC_HWTC_TYPE == TRC_OS_TIMER_INCR || TRC_HWTC_TYPE == TRC_OS_TIMER_DECR)*/
 
 	/* Is anyone interested in the results? */
 	if (pTimestamp)
-		*pTimestamp = last_timestamp;
+		*pTimestamp = pxCoreData->last_timestamp;
 
 	/* Store the previous value */
-	last_hwtc_count = hwtc_count;
+	pxCoreData->last_hwtc_count = hwtc_count;
 }
 
 #if defined(TRC_CFG_ENABLE_STACK_MONITOR) && (TRC_CFG_ENABLE_STACK_MONITOR == 1) && (TRC_CFG_SCHEDULING_ONLY == 0)
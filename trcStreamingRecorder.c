@@ -115,7 +115,7 @@ static void prvTraceStoreStartEvent(void);
 /* Checks if the provided command is a valid command */
 static int32_t prvIsValidCommand(const TraceCommand_t* const cmd);
 
-/* Executed the received command (Start or Stop) */
+/* Executed the received command (Start, Stop or trigger rules) */
 static void prvProcessCommand(const TraceCommand_t* const cmd);
 
 /* Internal function for starting the recorder */
@@ -222,6 +222,30 @@ traceResult xTraceInitialize(void)
 		return TRC_FAIL;
 	}
 
+	/*cstat !MISRAC2004-13.7_b !MISRAC2012-Rule-14.3_b Suppress always false check*/
+	if (xTraceAdaptiveCtrlInitialize(&pxTraceRecorderData->xAdaptiveCtrlBuffer) == TRC_FAIL)
+	{
+		return TRC_FAIL;
+	}
+
+	/*cstat !MISRAC2004-13.7_b !MISRAC2012-Rule-14.3_b Suppress always false check*/
+	if (xTraceFlightRecorderInitialize(&pxTraceRecorderData->xFlightRecorderBuffer) == TRC_FAIL)
+	{
+		return TRC_FAIL;
+	}
+
+	/*cstat !MISRAC2004-13.7_b !MISRAC2012-Rule-14.3_b Suppress always false check*/
+	if (xTraceTriggerInitialize(&pxTraceRecorderData->xTriggerBuffer) == TRC_FAIL)
+	{
+		return TRC_FAIL;
+	}
+
+	/*cstat !MISRAC2004-13.7_b !MISRAC2012-Rule-14.3_b Suppress always false check*/
+	if (xTraceProfilingInitialize(&pxTraceRecorderData->xProfilingBuffer) == TRC_FAIL)
+	{
+		return TRC_FAIL;
+	}
+
 	/*cstat !MISRAC2004-13.7_b Suppress always false check*/
 	if (xTraceExtensionInitialize(&pxTraceRecorderData->xExtensionBuffer) == TRC_FAIL)
 	{
@@ -233,6 +257,12 @@ traceResult xTraceInitialize(void)
 		return TRC_FAIL;
 	}
 
+	/*cstat !MISRAC2004-13.7_b !MISRAC2012-Rule-14.3_b Suppress always false check*/
+	if (xTraceWriteCombineInitialize(&pxTraceRecorderData->xWriteCombineBuffer) == TRC_FAIL)
+	{
+		return TRC_FAIL;
+	}
+
 	if (xTraceEventInitialize(&pxTraceRecorderData->xEventDataBuffer) == TRC_FAIL)
 	{
 		return TRC_FAIL;
@@ -446,6 +476,14 @@ traceResult xTraceTzCtrl(void)
 {
 	TraceCommand_t xCommand = { 0 };
 	int32_t iRxBytes;
+	TRC_PROFILING_ALLOC(uiTransferStart)
+	TRC_PROFILING_ALLOC(uiTransferStop)
+
+	if (xTraceIsRecorderEnabled())
+	{
+		/* With TRC_CFG_CTRL_ADAPTIVE, measures what was stored since the last call */
+		(void)xTraceAdaptiveCtrlMeasure();
+	}
 	
 	do
 	{
@@ -469,7 +507,22 @@ traceResult xTraceTzCtrl(void)
 
 		if (xTraceIsRecorderEnabled())
 		{
-			(void)xTraceInternalEventBufferTransfer();
+			/* With TRC_CFG_DIAGNOSTICS_EXTENDED, counts the transfer and samples the buffer use */
+			(void)xTraceDiagnosticsOnTransfer();
+
+			TRC_PROFILING_TIMESTAMP(uiTransferStart)
+
+			/* With TRC_CFG_FLIGHT_RECORDER, only a frozen capture is transferred */
+			if (xTraceFlightRecorderTransfer() == TRC_FAIL)
+			{
+				(void)xTraceInternalEventBufferTransfer();
+			}
+
+			/* If write combining is used, write what has been combined so far */
+			(void)xTraceWriteCombineFlush();
+
+			TRC_PROFILING_TIMESTAMP(uiTransferStop)
+			TRC_PROFILING_RECORD(TRC_PROFILING_TRANSFER, uiTransferStart, uiTransferStop)
 		}
 
 		/* If there was data sent or received (bytes != 0), loop around and repeat, if there is more data to send or receive.
@@ -479,13 +532,35 @@ traceResult xTraceTzCtrl(void)
 
 	if (xTraceIsRecorderEnabled())
 	{
+		/* With TRC_CFG_CTRL_ADAPTIVE, decides how long to wait until the next call */
+		(void)xTraceAdaptiveCtrlSchedule();
+
 		(void)xTraceDiagnosticsCheckStatus();
 		(void)xTraceStackMonitorReport();
+
+		/* With TRC_CFG_SELF_PROFILING, periodically stores the recorder's own cost */
+		(void)xTraceProfilingReport();
 	}
 
 	return TRC_SUCCESS;
 }
 
+traceResult xTraceStoreSessionInfo(void)
+{
+	TRACE_ALLOC_CRITICAL_SECTION();
+
+	TRACE_ENTER_CRITICAL_SECTION();
+
+	prvTraceStoreHeader();
+	prvTraceStoreTimestampInfo();
+	prvTraceStoreEntryTable();
+	prvTraceStoreStartEvent();
+
+	TRACE_EXIT_CRITICAL_SECTION();
+
+	return TRC_SUCCESS;
+}
+
 void vTraceSetFilterGroup(uint16_t filterGroup)
 {
 	(void)filterGroup;
@@ -536,6 +611,9 @@ static void prvSetRecorderEnabled(void)
 
 	/* If the internal event buffer is used, we must clear it */
 	(void)xTraceInternalEventBufferClear();
+
+	/* If write combining is used, we must clear it */
+	(void)xTraceWriteCombineOnTraceBegin();
 	
 	(void)xTraceStreamPortOnTraceBegin();
 
@@ -544,10 +622,19 @@ static void prvSetRecorderEnabled(void)
 	prvTraceStoreEntryTable();
 	prvTraceStoreStartEvent();
 
+	/* With TRC_CFG_FLIGHT_RECORDER, the header is transferred before anything is overwritten */
+	(void)xTraceFlightRecorderOnTraceBegin();
+
+	/* With TRC_CFG_TRIGGER_RULES, events are stored from the first start rule, if any */
+	(void)xTraceTriggerOnTraceBegin();
+
 	pxTraceRecorderData->uiSessionCounter++;
 
 	pxTraceRecorderData->uiRecorderEnabled = 1u;
 
+	/* If write combining is used, don't hold the header back */
+	(void)xTraceWriteCombineFlush();
+
 	TRACE_EXIT_CRITICAL_SECTION();
 }
 
@@ -560,10 +647,16 @@ static void prvSetRecorderDisabled(void)
 		return;
 	}
 
+	/* With TRC_CFG_FLIGHT_RECORDER, the events before a trigger are transferred before the trace ends */
+	(void)xTraceFlightRecorderOnTraceEnd();
+
 	TRACE_ENTER_CRITICAL_SECTION();
 	
 	pxTraceRecorderData->uiRecorderEnabled = 0u;
 
+	/* If write combining is used, the last events must be written before the trace ends */
+	(void)xTraceWriteCombineFlush();
+
 	(void)xTraceStreamPortOnTraceEnd();
 
 	TRACE_EXIT_CRITICAL_SECTION();
@@ -657,9 +750,11 @@ static int32_t prvIsValidCommand(const TraceCommand_t* const cmd)
 	return 1;
 }
 
-/* Executed the received command (Start or Stop) */
+/* Executed the received command (Start, Stop or trigger rules) */
 static void prvProcessCommand(const TraceCommand_t* const cmd)
 {
+	uint8_t uiParams[5];
+
   	switch(cmd->cmdCode)
 	{
 		case CMD_SET_ACTIVE:
@@ -672,6 +767,16 @@ static void prvProcessCommand(const TraceCommand_t* const cmd)
 				prvSetRecorderDisabled();
 			}
 		  	break;
+		case CMD_TRIGGER_RULE:
+		case CMD_TRIGGER_RULE_VALUE:
+		case CMD_TRIGGER_RULES_SET:
+			uiParams[0] = cmd->param1;
+			uiParams[1] = cmd->param2;
+			uiParams[2] = cmd->param3;
+			uiParams[3] = cmd->param4;
+			uiParams[4] = cmd->param5;
+			(void)xTraceTriggerProcessCommand((uint32_t)cmd->cmdCode, uiParams);
+			break;
 		default:
 		  	break;
 	}
@@ -0,0 +1,364 @@
+/*
+* Percepio Trace Recorder for Tracealyzer v4.10.3
+* Copyright 2023 Percepio AB
+* www.percepio.com
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* The implementation of the trigger rules.
+*/
+
+#include <trcRecorder.h>
+
+#if (TRC_USE_TRACEALYZER_RECORDER == 1) && (TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)
+
+#if ((TRC_CFG_TRIGGER_RULES) > 0)
+
+#define TRC_TRIGGER_CODE_WORD(uiEventCode) (((uint32_t)(uiEventCode) & 0xFFFUL) >> 5)
+#define TRC_TRIGGER_CODE_BIT(uiEventCode) (1UL << ((uint32_t)(uiEventCode) & 0x1FUL))
+
+#define TRC_TRIGGER_GET_PARAMETER(uiFlags) (((uint32_t)(uiFlags) >> 4) & 0x7UL)
+
+#define TRC_TRIGGER_VALUE_HANDLE 0UL
+#define TRC_TRIGGER_VALUE_MIN 1UL
+#define TRC_TRIGGER_VALUE_MAX 2UL
+
+/* A mark, xTracePrintF() with the channel and one argument */
+#define TRC_TRIGGER_MARK_EVENT_CODE ((uint32_t)(PSF_EVENT_USER_EVENT) + 2UL)
+
+static TraceTriggerData_t* pxTriggerData TRC_CFG_RECORDER_DATA_ATTRIBUTE;
+
+static void prvTraceTriggerFire(uint32_t uiRule, uint32_t* puiStore, uint32_t* puiMarks);
+
+/* Must be called with the critical section held. The marks are stored by the
+ * caller once it has left it. */
+static void prvTraceTriggerFire(uint32_t uiRule, uint32_t* puiStore, uint32_t* puiMarks)
+{
+	TraceTriggerRule_t* pxRule = &pxTriggerData->xRules[uiRule];
+
+	switch (pxRule->uiAction)
+	{
+	case TRC_TRIGGER_ACTION_START:
+		pxTriggerData->uiStarted = 1u;
+		*puiStore = 1u;
+		break;
+	case TRC_TRIGGER_ACTION_STOP:
+		/* The event that stops is stored if it would have been */
+		pxTriggerData->uiStarted = 0u;
+		break;
+	case TRC_TRIGGER_ACTION_MARK:
+		*puiMarks |= 1UL << uiRule;
+		break;
+	case TRC_TRIGGER_ACTION_FREEZE:
+		(void)xTraceFlightRecorderTrigger();
+		break;
+	default:
+		break;
+	}
+
+	if ((pxRule->uiFlags & TRC_TRIGGER_FLAG_ONCE) != 0u)
+	{
+		pxRule->uiAction = TRC_TRIGGER_ACTION_NONE;
+	}
+}
+
+traceResult xTraceTriggerInitialize(TraceTriggerData_t* pxBuffer)
+{
+	uint32_t i;
+
+	/* This should never fail */
+	TRC_ASSERT(pxBuffer != (void*)0);
+
+	pxTriggerData = pxBuffer;
+
+	for (i = 0u; i < (uint32_t)(TRC_CFG_TRIGGER_RULES); i++)
+	{
+		pxTriggerData->xRules[i].uiAction = TRC_TRIGGER_ACTION_NONE;
+		pxTriggerData->xUploaded[i].uiAction = TRC_TRIGGER_ACTION_NONE;
+	}
+
+	for (i = 0u; i < (uint32_t)(TRC_CFG_CORE_COUNT); i++)
+	{
+		pxTriggerData->xCores[i].uiDurationRule = 0u;
+		pxTriggerData->xCores[i].uiDurationStart = 0u;
+	}
+
+	for (i = 0u; i < (uint32_t)(TRC_TRIGGER_CODE_WORDS); i++)
+	{
+		pxTriggerData->uiCodeBits[i] = 0u;
+	}
+
+	pxTriggerData->uiRuleCount = 0u;
+	pxTriggerData->uiStarted = 1u;
+	pxTriggerData->uiHasStartRule = 0u;
+	pxTriggerData->uiUploadIndex = 0u;
+	pxTriggerData->xMarkChannel = 0;
+
+	/* Registered now, a mark can't register it while events are checked.
+	 * The event fails while the recorder isn't enabled, the name is sent
+	 * with the entry table. */
+	(void)xTraceStringRegister("#Trigger", &pxTriggerData->xMarkChannel);
+
+	(void)xTraceSetComponentInitialized(TRC_RECORDER_COMPONENT_TRIGGER);
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceTriggerSetRules(const TraceTriggerRule_t* pxRules, uint32_t uiCount)
+{
+	uint32_t i;
+	TRACE_ALLOC_CRITICAL_SECTION();
+
+	/* This should never fail */
+	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_TRIGGER));
+
+	if ((uiCount > (uint32_t)(TRC_CFG_TRIGGER_RULES)) || ((uiCount > 0u) && (pxRules == (void*)0)))
+	{
+		return TRC_FAIL;
+	}
+
+	/* xTraceTriggerCheck() only gets the first parameters */
+	for (i = 0u; i < uiCount; i++)
+	{
+		if (((pxRules[i].uiFlags & TRC_TRIGGER_FLAG_RANGE) != 0u) && (TRC_TRIGGER_GET_PARAMETER(pxRules[i].uiFlags) >= (uint32_t)(TRC_TRIGGER_PARAMETERS)))
+		{
+			return TRC_FAIL;
+		}
+	}
+
+	TRACE_ENTER_CRITICAL_SECTION();
+
+	for (i = 0u; i < (uint32_t)(TRC_TRIGGER_CODE_WORDS); i++)
+	{
+		pxTriggerData->uiCodeBits[i] = 0u;
+	}
+	pxTriggerData->uiHasStartRule = 0u;
+
+	for (i = 0u; i < uiCount; i++)
+	{
+		pxTriggerData->xRules[i] = pxRules[i];
+		pxTriggerData->uiCodeBits[TRC_TRIGGER_CODE_WORD(pxRules[i].uiEventCode)] |= TRC_TRIGGER_CODE_BIT(pxRules[i].uiEventCode);
+
+		if (pxRules[i].uiAction == TRC_TRIGGER_ACTION_START)
+		{
+			pxTriggerData->uiHasStartRule = 1u;
+		}
+	}
+
+	for (i = 0u; i < (uint32_t)(TRC_CFG_CORE_COUNT); i++)
+	{
+		pxTriggerData->xCores[i].uiDurationRule = 0u;
+	}
+
+	pxTriggerData->uiStarted = (pxTriggerData->uiHasStartRule == 0u) ? 1u : 0u;
+	pxTriggerData->uiRuleCount = uiCount;
+
+	TRACE_EXIT_CRITICAL_SECTION();
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceTriggerCheck(uint32_t uiEventCode, TraceUnsignedBaseType_t uxParam1, TraceUnsignedBaseType_t uxParam2, TraceUnsignedBaseType_t uxParam3, TraceUnsignedBaseType_t uxParam4)
+{
+	TraceTriggerCoreData_t* pxCore;
+	const TraceTriggerRule_t* pxRule;
+	TraceUnsignedBaseType_t uxValue;
+	uint32_t uiTimestamp = 0u;
+	uint32_t uiStore;
+	uint32_t uiMarks = 0u;
+	uint32_t i;
+	TRACE_ALLOC_CRITICAL_SECTION();
+
+	/* No rules, the common case */
+	if (pxTriggerData->uiRuleCount == 0u)
+	{
+		return TRC_SUCCESS;
+	}
+
+	/* A mark is stored as it is, the only events on its channel are marks */
+	if ((uiEventCode == TRC_TRIGGER_MARK_EVENT_CODE) && (uxParam1 == (TraceUnsignedBaseType_t)pxTriggerData->xMarkChannel))
+	{
+		return TRC_SUCCESS;
+	}
+
+	TRACE_ENTER_CRITICAL_SECTION();
+
+	pxCore = &pxTriggerData->xCores[TRC_CFG_GET_CURRENT_CORE()];
+
+	uiStore = ((pxTriggerData->uiStarted != 0u) || (uiEventCode < (uint32_t)(TRC_TRIGGER_SYSTEM_EVENT_CODES))) ? 1u : 0u;
+
+	/* A duration being timed ends when the core switches to another ISR or task */
+	if ((pxCore->uiDurationRule != 0u) &&
+		((uiEventCode == (uint32_t)(PSF_EVENT_ISR_BEGIN)) || (uiEventCode == (uint32_t)(PSF_EVENT_ISR_RESUME)) || (uiEventCode == (uint32_t)(PSF_EVENT_TASK_ACTIVATE))))
+	{
+		(void)xTraceTimestampGet(&uiTimestamp);
+		pxRule = &pxTriggerData->xRules[pxCore->uiDurationRule - 1u];
+		uxValue = (TraceUnsignedBaseType_t)(uiTimestamp - pxCore->uiDurationStart);
+		if ((uxValue >= pxRule->uxMin) && (uxValue <= pxRule->uxMax))
+		{
+			prvTraceTriggerFire(pxCore->uiDurationRule - 1u, &uiStore, &uiMarks);
+		}
+		pxCore->uiDurationRule = 0u;
+	}
+
+	/* Most events match no rule's code and skip the rules */
+	if ((pxTriggerData->uiCodeBits[TRC_TRIGGER_CODE_WORD(uiEventCode)] & TRC_TRIGGER_CODE_BIT(uiEventCode)) != 0u)
+	{
+		for (i = 0u; i < pxTriggerData->uiRuleCount; i++)
+		{
+			pxRule = &pxTriggerData->xRules[i];
+
+			if (((uint32_t)pxRule->uiEventCode != uiEventCode) || (pxRule->uiAction == TRC_TRIGGER_ACTION_NONE))
+			{
+				continue;
+			}
+
+			if (((pxRule->uiFlags & TRC_TRIGGER_FLAG_HANDLE) != 0u) && (uxParam1 != pxRule->uxHandle))
+			{
+				continue;
+			}
+
+			if ((pxRule->uiFlags & TRC_TRIGGER_FLAG_DURATION) != 0u)
+			{
+				/* Fires when the duration ends, if it is in range */
+				(void)xTraceTimestampGet(&uiTimestamp);
+				pxCore->uiDurationRule = i + 1u;
+				pxCore->uiDurationStart = uiTimestamp;
+
+				continue;
+			}
+
+			if ((pxRule->uiFlags & TRC_TRIGGER_FLAG_RANGE) != 0u)
+			{
+				switch (TRC_TRIGGER_GET_PARAMETER(pxRule->uiFlags))
+				{
+				case 0:
+					uxValue = uxParam1;
+					break;
+				case 1:
+					uxValue = uxParam2;
+					break;
+				case 2:
+					uxValue = uxParam3;
+					break;
+				default:
+					uxValue = uxParam4;
+					break;
+				}
+
+				if ((uxValue < pxRule->uxMin) || (uxValue > pxRule->uxMax))
+				{
+					continue;
+				}
+			}
+
+			prvTraceTriggerFire(i, &uiStore, &uiMarks);
+		}
+	}
+
+	TRACE_EXIT_CRITICAL_SECTION();
+
+	/* Not checked against the rules, see above */
+	for (i = 0u; uiMarks != 0u; i++)
+	{
+		if ((uiMarks & (1UL << i)) != 0u)
+		{
+			(void)xTracePrintF(pxTriggerData->xMarkChannel, "Rule %d", (TraceUnsignedBaseType_t)i);
+			uiMarks &= ~(1UL << i);
+		}
+	}
+
+	return (uiStore != 0u) ? TRC_SUCCESS : TRC_FAIL;
+}
+
+traceResult xTraceTriggerOnTraceBegin(void)
+{
+	uint32_t i;
+
+	/* This should never fail */
+	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_TRIGGER));
+
+	for (i = 0u; i < (uint32_t)(TRC_CFG_CORE_COUNT); i++)
+	{
+		pxTriggerData->xCores[i].uiDurationRule = 0u;
+	}
+
+	pxTriggerData->uiStarted = (pxTriggerData->uiHasStartRule == 0u) ? 1u : 0u;
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceTriggerProcessCommand(uint32_t uiCommand, const uint8_t* puiParams)
+{
+	TraceTriggerRule_t* pxRule;
+	TraceUnsignedBaseType_t* puxValue;
+	uint32_t uiWord;
+	uint32_t uiValue;
+
+	/* This should never fail */
+	TRC_ASSERT(puiParams != (void*)0);
+
+	/* This should never fail */
+	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_TRIGGER));
+
+	switch (uiCommand)
+	{
+	case CMD_TRIGGER_RULE:
+		if ((uint32_t)puiParams[0] >= (uint32_t)(TRC_CFG_TRIGGER_RULES))
+		{
+			return TRC_FAIL;
+		}
+
+		pxTriggerData->uiUploadIndex = (uint32_t)puiParams[0];
+		pxRule = &pxTriggerData->xUploaded[pxTriggerData->uiUploadIndex];
+		pxRule->uiAction = puiParams[1];
+		pxRule->uiFlags = puiParams[2];
+		pxRule->uiEventCode = (uint16_t)((uint32_t)puiParams[3] | ((uint32_t)puiParams[4] << 8));
+		pxRule->uxHandle = 0u;
+		pxRule->uxMin = 0u;
+		pxRule->uxMax = 0u;
+
+		return TRC_SUCCESS;
+
+	case CMD_TRIGGER_RULE_VALUE:
+		pxRule = &pxTriggerData->xUploaded[pxTriggerData->uiUploadIndex];
+		switch ((uint32_t)puiParams[0] & 0xFUL)
+		{
+		case TRC_TRIGGER_VALUE_HANDLE:
+			puxValue = &pxRule->uxHandle;
+			break;
+		case TRC_TRIGGER_VALUE_MIN:
+			puxValue = &pxRule->uxMin;
+			break;
+		case TRC_TRIGGER_VALUE_MAX:
+			puxValue = &pxRule->uxMax;
+			break;
+		default:
+			return TRC_FAIL;
+		}
+
+		uiWord = ((uint32_t)puiParams[0] >> 4) & 0xFUL;
+		if (uiWord >= (uint32_t)(sizeof(TraceUnsignedBaseType_t) / sizeof(uint32_t)))
+		{
+			return TRC_FAIL;
+		}
+
+		uiValue = (uint32_t)puiParams[1] | ((uint32_t)puiParams[2] << 8) | ((uint32_t)puiParams[3] << 16) | ((uint32_t)puiParams[4] << 24);
+
+		/* Written a 32-bit word at a time, in case TraceUnsignedBaseType_t is 64 bits */
+		*puxValue &= ~(((TraceUnsignedBaseType_t)0xFFFFFFFFUL) << (uiWord * 32u)); /*cstat !MISRAC2012-Rule-12.2 The shift is at most 32 when the type is 64 bits*/
+		*puxValue |= ((TraceUnsignedBaseType_t)uiValue) << (uiWord * 32u); /*cstat !MISRAC2012-Rule-12.2 The shift is at most 32 when the type is 64 bits*/
+
+		return TRC_SUCCESS;
+
+	case CMD_TRIGGER_RULES_SET:
+		return xTraceTriggerSetRules(pxTriggerData->xUploaded, (uint32_t)puiParams[0]);
+
+	default:
+		return TRC_FAIL;
+	}
+}
+
+#endif
+
+#endif
@@ -0,0 +1,246 @@
+/*
+* Percepio Trace Recorder for Tracealyzer v4.10.3
+* Copyright 2023 Percepio AB
+* www.percepio.com
+*
+* SPDX-License-Identifier: Apache-2.0
+*
+* The implementation for the write combine buffers.
+*/
+
+#include <trcRecorder.h>
+
+#if (TRC_USE_TRACEALYZER_RECORDER == 1) && (TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING)
+
+#if ((TRC_USE_INTERNAL_BUFFER) == 0) && ((TRC_WRITE_COMBINE_SIZE) > 0)
+
+#include <string.h>
+
+/* Timer counts since an arbitrary point, wrapping at 32 bits. Taken from the
+ * timestamp of the latest event rather than the timer, which is read once per
+ * event already. With an OS timer only the tick count is used. */
+#if ((TRC_HWTC_TYPE == TRC_FREE_RUNNING_32BIT_INCR) || (TRC_HWTC_TYPE == TRC_CUSTOM_TIMER_INCR))
+#define prvTraceWriteCombineNow() (pxTraceTimestamp->latestTimestamp)
+#elif ((TRC_HWTC_TYPE == TRC_FREE_RUNNING_32BIT_DECR) || (TRC_HWTC_TYPE == TRC_CUSTOM_TIMER_DECR))
+#define prvTraceWriteCombineNow() (0UL - pxTraceTimestamp->latestTimestamp)
+#elif ((TRC_HWTC_TYPE == TRC_OS_TIMER_INCR) || (TRC_HWTC_TYPE == TRC_OS_TIMER_DECR))
+#define prvTraceWriteCombineNow() (pxTraceTimestamp->osTickCount * (uint32_t)(TRC_HWTC_PERIOD))
+#endif
+
+TraceWriteCombineData_t* pxTraceWriteCombineData TRC_CFG_RECORDER_DATA_ATTRIBUTE;
+
+static traceResult prvTraceWriteCombineWrite(uint32_t uiCore);
+static traceResult prvTraceWriteCombineFlushCore(uint32_t uiCore);
+
+traceResult xTraceWriteCombineInitialize(TraceWriteCombineData_t* pxBuffer)
+{
+	uint32_t i;
+
+	/* This should never fail */
+	TRC_ASSERT(pxBuffer != (void*)0);
+
+	pxTraceWriteCombineData = pxBuffer;
+
+	for (i = 0u; i < (uint32_t)(TRC_CFG_CORE_COUNT); i++)
+	{
+		pxTraceWriteCombineData->cores[i].uiUsed = 0u;
+		pxTraceWriteCombineData->cores[i].uiOldest = 0u;
+	}
+	pxTraceWriteCombineData->uiFlushPeriod = 0u;
+	pxTraceWriteCombineData->uiPartialCore = TRC_WRITE_COMBINE_NO_CORE;
+
+	(void)xTraceSetComponentInitialized(TRC_RECORDER_COMPONENT_WRITE_COMBINE);
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceWriteCombineOnTraceBegin(void)
+{
+	TraceUnsignedBaseType_t uxFrequency = 0u;
+	uint64_t ulFlushPeriod;
+	uint32_t i;
+
+	/* This should never fail */
+	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_WRITE_COMBINE));
+
+	(void)xTraceTimestampGetFrequency(&uxFrequency);
+	ulFlushPeriod = ((uint64_t)uxFrequency * (uint64_t)(TRC_WRITE_COMBINE_FLUSH_PERIOD)) / 1000000ULL;
+	if (ulFlushPeriod > 0x7FFFFFFFULL)
+	{
+		/* Keep well inside the 32-bit wraparound of the elapsed time */
+		ulFlushPeriod = 0x7FFFFFFFULL;
+	}
+	pxTraceWriteCombineData->uiFlushPeriod = (uint32_t)ulFlushPeriod;
+
+	/* Anything left over belongs to the previous trace */
+	for (i = 0u; i < (uint32_t)(TRC_CFG_CORE_COUNT); i++)
+	{
+		pxTraceWriteCombineData->cores[i].uiUsed = 0u;
+	}
+	pxTraceWriteCombineData->uiPartialCore = TRC_WRITE_COMBINE_NO_CORE;
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceWriteCombineAlloc(uint32_t uiSize, void** ppvData)
+{
+	TraceWriteCombineCore_t* pxCore;
+	uint32_t uiCore = (uint32_t)TRC_CFG_GET_CURRENT_CORE();
+
+	pxCore = &pxTraceWriteCombineData->cores[uiCore];
+
+	if ((pxCore->uiUsed + uiSize) > (uint32_t)(TRC_WRITE_COMBINE_BUFFER_SIZE))
+	{
+		(void)prvTraceWriteCombineFlushCore(uiCore);
+
+		if ((pxCore->uiUsed + uiSize) > (uint32_t)(TRC_WRITE_COMBINE_BUFFER_SIZE))
+		{
+			if (pxCore->uiUsed != 0u)
+			{
+				/* The stream port hasn't taken what is buffered */
+				return TRC_FAIL;
+			}
+
+			/* Larger than the buffer, it is written directly on commit */
+			return xTraceStaticBufferGet(ppvData);
+		}
+	}
+
+	*ppvData = (void*)&pxCore->uiBuffer[pxCore->uiUsed];
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceWriteCombineCommit(void* pvData, uint32_t uiSize, int32_t* piBytesCommitted)
+{
+	TraceWriteCombineCore_t* pxCore;
+	uint32_t uiNow;
+	uint32_t uiCore = (uint32_t)TRC_CFG_GET_CURRENT_CORE();
+
+	pxCore = &pxTraceWriteCombineData->cores[uiCore];
+
+	if (pvData != (void*)&pxCore->uiBuffer[pxCore->uiUsed])
+	{
+		/* Allocated from the static buffer, written after the rest of any
+		 * event another core has only partly written */
+		(void)prvTraceWriteCombineFlushCore(uiCore);
+
+		if (pxTraceWriteCombineData->uiPartialCore != TRC_WRITE_COMBINE_NO_CORE)
+		{
+			/* Would end up in the middle of another core's event */
+			*piBytesCommitted = 0;
+			(void)xTraceDiagnosticsIncrease(TRC_DIAGNOSTICS_WRITE_COMBINE_DROPPED);
+
+			return TRC_FAIL;
+		}
+
+		return xTraceStreamPortWriteData(pvData, uiSize, piBytesCommitted);
+	}
+
+	uiNow = prvTraceWriteCombineNow();
+	if (pxCore->uiUsed == 0u)
+	{
+		pxCore->uiOldest = uiNow;
+	}
+	pxCore->uiUsed += uiSize;
+	*piBytesCommitted = (int32_t)uiSize;
+
+	if ((uiNow - pxCore->uiOldest) >= pxTraceWriteCombineData->uiFlushPeriod)
+	{
+		(void)prvTraceWriteCombineFlushCore(uiCore);
+	}
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceWriteCombineFlush(void)
+{
+	traceResult xResult = TRC_SUCCESS;
+	uint32_t i;
+	TRACE_ALLOC_CRITICAL_SECTION();
+
+	/* This should never fail */
+	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_WRITE_COMBINE));
+
+	TRACE_ENTER_CRITICAL_SECTION();
+
+	for (i = 0u; i < (uint32_t)(TRC_CFG_CORE_COUNT); i++)
+	{
+		if (prvTraceWriteCombineFlushCore(i) == TRC_FAIL)
+		{
+			xResult = TRC_FAIL;
+		}
+	}
+
+	TRACE_EXIT_CRITICAL_SECTION();
+
+	return xResult;
+}
+
+/* Writes a core's buffered data, after whatever another core has only partly
+ * written, since an event must not be split by another core's data */
+static traceResult prvTraceWriteCombineFlushCore(uint32_t uiCore)
+{
+	uint32_t uiPartialCore = pxTraceWriteCombineData->uiPartialCore;
+
+	if ((uiPartialCore < (uint32_t)(TRC_CFG_CORE_COUNT)) && (uiPartialCore != uiCore))
+	{
+		(void)prvTraceWriteCombineWrite(uiPartialCore);
+
+		if (pxTraceWriteCombineData->uiPartialCore != TRC_WRITE_COMBINE_NO_CORE)
+		{
+			return TRC_FAIL;
+		}
+	}
+
+	return prvTraceWriteCombineWrite(uiCore);
+}
+
+static traceResult prvTraceWriteCombineWrite(uint32_t uiCore)
+{
+	TraceWriteCombineCore_t* pxCore = &pxTraceWriteCombineData->cores[uiCore];
+	int32_t iBytesWritten = 0;
+
+	if (pxCore->uiUsed == 0u)
+	{
+		return TRC_SUCCESS;
+	}
+
+	if (xTraceStreamPortWriteData(pxCore->uiBuffer, pxCore->uiUsed, &iBytesWritten) == TRC_FAIL)
+	{
+		/* The data is lost, as it would have been without write combining */
+		pxCore->uiUsed = 0u;
+		if (pxTraceWriteCombineData->uiPartialCore == uiCore)
+		{
+			pxTraceWriteCombineData->uiPartialCore = TRC_WRITE_COMBINE_NO_CORE;
+		}
+
+		return TRC_FAIL;
+	}
+
+	if ((uint32_t)iBytesWritten >= pxCore->uiUsed)
+	{
+		pxCore->uiUsed = 0u;
+		if (pxTraceWriteCombineData->uiPartialCore == uiCore)
+		{
+			pxTraceWriteCombineData->uiPartialCore = TRC_WRITE_COMBINE_NO_CORE;
+		}
+	}
+	else if (iBytesWritten > 0)
+	{
+		/* Keep the rest, it has to be written before any other core's data */
+		pxCore->uiUsed -= (uint32_t)iBytesWritten;
+		(void)memmove(pxCore->uiBuffer, &pxCore->uiBuffer[iBytesWritten], pxCore->uiUsed);
+		pxTraceWriteCombineData->uiPartialCore = uiCore;
+	}
+	else
+	{
+		/* Nothing was written, try again later */
+	}
+
+	return TRC_SUCCESS;
+}
+
+#endif
+
+#endif